@@ -0,0 +1,141 @@
+#!/usr/bin/env python3
+"""Loopback echo benchmark for Net.TcpListener and the async TcpSocket operations.
+
+Starts benchmark/languages/starbytes/net_echo/echo_server.starb, opens the
+requested number of connections, and keeps one request in flight on every
+connection for the measurement window. Reports requests per second and
+latency percentiles.
+"""
+
+import argparse
+import asyncio
+import json
+import resource
+import subprocess
+import sys
+import time
+from pathlib import Path
+
+
+def repo_root() -> Path:
+    return Path(__file__).resolve().parents[2]
+
+
+def default_starbytes_bin(root: Path) -> str:
+    candidate = root / "build" / "bin" / "starbytes"
+    if candidate.exists():
+        return str(candidate)
+    return "starbytes"
+
+
+def raise_file_limit(connections: int) -> None:
+    soft, hard = resource.getrlimit(resource.RLIMIT_NOFILE)
+    wanted = connections * 2 + 256
+    if hard != resource.RLIM_INFINITY:
+        wanted = min(wanted, hard)
+    if soft == resource.RLIM_INFINITY or soft >= wanted:
+        return
+    resource.setrlimit(resource.RLIMIT_NOFILE, (wanted, hard))
+    if wanted < connections * 2:
+        print(f"warning: open file limit {wanted} may be too low for {connections} connections", file=sys.stderr)
+
+
+def percentile(sorted_values: list, fraction: float) -> float:
+    if not sorted_values:
+        return 0.0
+    rank = max(0, min(len(sorted_values) - 1, int(round(fraction * len(sorted_values) + 0.5)) - 1))
+    return sorted_values[rank]
+
+
+async def open_connections(port: int, count: int, concurrency: int) -> list:
+    gate = asyncio.Semaphore(concurrency)
+
+    async def connect():
+        async with gate:
+            return await asyncio.open_connection("127.0.0.1", port)
+
+    return await asyncio.gather(*(connect() for _ in range(count)))
+
+
+async def run_load(port: int, args: argparse.Namespace) -> dict:
+    connections = await open_connections(port, args.connections, args.connect_concurrency)
+    payload = b"x" * args.payload_bytes
+    latencies = []
+    started = time.perf_counter()
+    warmup_end = started + args.warmup
+    deadline = warmup_end + args.duration
+
+    async def client(reader, writer):
+        while True:
+            sent_at = time.perf_counter()
+            if sent_at >= deadline:
+                break
+            writer.write(payload)
+            await reader.readexactly(len(payload))
+            if sent_at >= warmup_end:
+                latencies.append(time.perf_counter() - sent_at)
+
+    await asyncio.gather(*(client(reader, writer) for reader, writer in connections))
+    for _, writer in connections:
+        writer.close()
+    await asyncio.gather(*(writer.wait_closed() for _, writer in connections), return_exceptions=True)
+
+    latencies.sort()
+    return {
+        "connections": args.connections,
+        "payload_bytes": args.payload_bytes,
+        "duration_seconds": args.duration,
+        "requests": len(latencies),
+        "requests_per_second": len(latencies) / args.duration if args.duration > 0 else 0.0,
+        "p50_ms": percentile(latencies, 0.50) * 1000.0,
+        "p99_ms": percentile(latencies, 0.99) * 1000.0,
+        "max_ms": (latencies[-1] * 1000.0) if latencies else 0.0,
+    }
+
+
+def main() -> int:
+    root = repo_root()
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--starbytes-bin", default=default_starbytes_bin(root))
+    parser.add_argument("--connections", type=int, default=10000)
+    parser.add_argument("--duration", type=float, default=10.0, help="measured seconds")
+    parser.add_argument("--warmup", type=float, default=2.0, help="unmeasured seconds before the window")
+    parser.add_argument("--payload-bytes", type=int, default=64)
+    parser.add_argument("--connect-concurrency", type=int, default=256)
+    parser.add_argument("--json", type=Path, help="also write the report to this file")
+    args = parser.parse_args()
+
+    raise_file_limit(args.connections)
+    server_script = root / "benchmark" / "languages" / "starbytes" / "net_echo" / "echo_server.starb"
+    server = subprocess.Popen(
+        [args.starbytes_bin, "run", str(server_script), "--", str(args.connections)],
+        stdout=subprocess.PIPE,
+        text=True,
+    )
+    try:
+        port_line = server.stdout.readline().strip()
+        if not port_line.isdigit():
+            print(f"echo server did not report a port: {port_line!r}", file=sys.stderr)
+            return 1
+        report = asyncio.run(run_load(int(port_line), args))
+        server_output = server.communicate(timeout=60)[0]
+    finally:
+        if server.poll() is None:
+            server.kill()
+            server.wait()
+
+    if "NET-ECHO-DONE" not in server_output:
+        print("echo server did not finish cleanly", file=sys.stderr)
+        print(server_output, file=sys.stderr)
+        return 1
+
+    print(f"connections={report['connections']} requests={report['requests']}")
+    print(f"requests/s={report['requests_per_second']:.0f}")
+    print(f"p50={report['p50_ms']:.3f}ms p99={report['p99_ms']:.3f}ms max={report['max_ms']:.3f}ms")
+    if args.json:
+        args.json.write_text(json.dumps(report, indent=2) + "\n", encoding="utf-8")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,82 @@
+#ifndef STARBYTES_BASE_DIGEST_H
+#define STARBYTES_BASE_DIGEST_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/// OpenSSL's EVP_MD_CTX. Declared here so the layout of Digest does not depend on whether the
+/// including target was built with OpenSSL.
+struct evp_md_ctx_st;
+
+namespace starbytes {
+
+enum class DigestKind {
+    Md5,
+    Sha1,
+    Sha256,
+    Sha512,
+    Blake2b
+};
+
+constexpr size_t kMaxDigestLength = 64;
+
+/// Accepts "md5", "sha1", "sha256", "sha512" and "blake2b".
+bool digestKindFromName(const std::string &name,DigestKind &outKind);
+size_t digestLength(DigestKind kind);
+size_t digestBlockSize(DigestKind kind);
+
+/// Incremental message digest. OpenSSL is used when starbytesBase is built with it; otherwise the
+/// built-in implementations run, with SHA-256 using the x86 SHA extensions when the CPU has them.
+class Digest {
+public:
+    explicit Digest(DigestKind kind);
+    Digest(const Digest &other);
+    Digest &operator=(const Digest &other) = delete;
+    ~Digest();
+
+    DigestKind kind() const { return digestKind; }
+    bool valid() const { return isValid; }
+    void reset();
+    bool update(const unsigned char *data,size_t length);
+    /// Writes digestLength(kind()) bytes without ending the digest, so updates may continue.
+    bool final(unsigned char *out) const;
+
+private:
+    void finalInPlace(unsigned char *out);
+    void compressBlocks(const unsigned char *blocks,size_t count);
+
+    DigestKind digestKind;
+    bool isValid = true;
+    evp_md_ctx_st *ctx = nullptr;
+    uint32_t state32[8] = {};
+    uint64_t state64[8] = {};
+    uint64_t totalBytes = 0;
+    unsigned char buffer[128] = {};
+    size_t bufferLength = 0;
+};
+
+/// HMAC over any DigestKind (RFC 2104).
+class Hmac {
+public:
+    Hmac(DigestKind kind,const unsigned char *key,size_t keyLength);
+
+    DigestKind kind() const { return inner.kind(); }
+    bool valid() const { return isValid && inner.valid(); }
+    void reset();
+    bool update(const unsigned char *data,size_t length);
+    bool final(unsigned char *out) const;
+
+private:
+    Digest inner;
+    bool isValid = true;
+    unsigned char innerPad[128] = {};
+    unsigned char outerPad[128] = {};
+};
+
+/// Reports which built-in SHA-256 implementation this process uses ("sha-ni" or "portable").
+const char *sha256Implementation();
+
+}
+
+#endif
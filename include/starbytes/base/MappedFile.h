@@ -0,0 +1,34 @@
+#include <cstddef>
+#include <filesystem>
+
+#ifndef STARBYTES_BASE_MAPPEDFILE_H
+#define STARBYTES_BASE_MAPPEDFILE_H
+
+namespace starbytes {
+
+/// Read-only memory mapping of a whole file.
+class MappedFile {
+    const char *mappedData = nullptr;
+    size_t mappedSize = 0;
+#ifdef _WIN32
+    void *fileHandle = nullptr;
+    void *mappingHandle = nullptr;
+#endif
+public:
+    MappedFile() = default;
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+    ~MappedFile();
+
+    /// Returns false when the file is missing, empty, or cannot be mapped.
+    bool open(const std::filesystem::path &path);
+    void close();
+
+    const char *data() const { return mappedData; }
+    size_t size() const { return mappedSize; }
+    bool isOpen() const { return mappedData != nullptr; }
+};
+
+}
+
+#endif
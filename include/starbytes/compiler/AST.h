@@ -2,6 +2,7 @@
 #include "ASTExpr.h"
 #include "Type.h"
 #include <iostream>
+#include <vector>
 
 #ifndef STARBYTES_AST_AST_H
 #define STARBYTES_AST_AST_H
@@ -15,12 +16,23 @@ namespace starbytes {
         struct STableContext;
     }
 
+    namespace Syntax {
+        struct Tok;
+    }
+
     class ASTStreamConsumer {
     public:
         virtual bool acceptsSymbolTableContext() = 0;
         virtual bool acceptsRawStatements(){
             return false;
         }
+        /// Receives the module's token stream once lexing succeeds, before any statement is parsed.
+        virtual bool acceptsTokens(){
+            return false;
+        }
+        virtual void consumeTokens(const std::vector<Syntax::Tok> &tokens){
+            (void)tokens;
+        }
         virtual void consumeSTableContext(Semantics::STableContext *table){
             std::cout << "NOT IMPLEMENTED" << std::endl;
         };
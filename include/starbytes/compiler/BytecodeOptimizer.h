@@ -0,0 +1,49 @@
+#include "RTCode.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#ifndef STARBYTES_GEN_BYTECODEOPTIMIZER_H
+#define STARBYTES_GEN_BYTECODEOPTIMIZER_H
+
+namespace starbytes {
+
+enum class BytecodeOptLevel : uint8_t {
+    O0 = 0,
+    O1 = 1,
+    O2 = 2
+};
+
+struct BytecodeOptimizerPassStats {
+    std::string name;
+    uint64_t ns = 0;
+    uint64_t runs = 0;
+    uint64_t changes = 0;
+};
+
+struct BytecodeOptimizerStats {
+    uint64_t functionsOptimized = 0;
+    uint64_t instructionsBefore = 0;
+    uint64_t instructionsAfter = 0;
+    std::vector<BytecodeOptimizerPassStats> passes;
+};
+
+/// Rewrites lowered Bytecode V2 function images before they are emitted.
+/// Compiler temporaries (`__v2tmp<N>` slots) are defined exactly once by the lowerer and are treated as SSA values;
+/// named locals are only rewritten when no fallback statement, call, or return can observe them.
+class BytecodeOptimizer {
+    BytecodeOptLevel level;
+    BytecodeOptimizerStats statistics;
+public:
+    explicit BytecodeOptimizer(BytecodeOptLevel level);
+
+    BytecodeOptLevel optLevel() const { return level; }
+    void optimize(Runtime::RTV2FunctionImage &image,Runtime::RTFuncTemplate &templ);
+    const BytecodeOptimizerStats &stats() const { return statistics; }
+};
+
+const char *bytecodeOptLevelName(BytecodeOptLevel level);
+
+}
+
+#endif
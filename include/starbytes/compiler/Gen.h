@@ -12,11 +12,15 @@
 #define STARBYTES_GEN_GEN_H
 
 namespace starbytes {
+    class BytecodeOptimizer;
+
     struct ModuleGenContext {
         bool generateInterface = false;
         bool emitModuleHeader = false;
         bool moduleHeaderWritten = false;
         uint16_t bytecodeVersion = Runtime::RTBYTECODE_VERSION_V1;
+        /// Applied to each Bytecode V2 function image before emission; null emits the lowered image as is.
+        BytecodeOptimizer *optimizer = nullptr;
         std::string name;
         std::ostream & out;
         std::filesystem::path outputPath;
@@ -182,6 +182,10 @@ typedef uint8_t RTBuiltinMemberId;
 #define RTBUILTIN_MEMBER_DICT_VALUES 0x26
 #define RTBUILTIN_MEMBER_DICT_CLEAR 0x27
 #define RTBUILTIN_MEMBER_DICT_COPY 0x28
+#define RTBUILTIN_MEMBER_BYTES_TO_ARRAY 0x29
+#define RTBUILTIN_MEMBER_BYTES_TO_HEX 0x2A
+#define RTBUILTIN_MEMBER_BYTES_TO_TEXT 0x2B
+#define RTBUILTIN_MEMBER_STRING_TO_BYTES 0x2C
 
 typedef uint8_t RTV2Opcode;
 #define RTV2_OP_NOP 0x00
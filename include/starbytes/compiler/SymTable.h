@@ -2,6 +2,7 @@
 #include <vector>
 #include <utility>
 #include <unordered_map>
+#include <filesystem>
 #include "AST.h"
 
 #ifndef STARBYTES_PARSER_SYMTABLE_H
@@ -122,7 +123,10 @@ namespace starbytes {
             
             /// IO Methods
             
+            /// Snapshot readers return nullptr when the bytes are truncated, corrupt, or from another format version.
             static std::shared_ptr<SymbolTable> importPublic(std::istream & input);
+            static std::shared_ptr<SymbolTable> importPublic(const char *data,size_t size);
+            static std::shared_ptr<SymbolTable> importPublicFile(const std::filesystem::path & path);
             /// Upon export of the SymbolTable only publically visible symbols will be serialized.
             void serializePublic(std::ostream & out);
             std::shared_ptr<SymbolTable> createImportNamespaceOverlay(string_ref moduleName) const;
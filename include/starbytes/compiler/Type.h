@@ -52,6 +52,7 @@ extern ASTType * FLOAT_TYPE;
 extern ASTType * LONG_TYPE;
 extern ASTType * DOUBLE_TYPE;
 extern ASTType * REGEX_TYPE;
+extern ASTType * BYTES_TYPE;
 extern ASTType * ANY_TYPE;
 extern ASTType * TASK_TYPE;
 extern ASTType * FUNCTION_TYPE;
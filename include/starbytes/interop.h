@@ -36,6 +36,7 @@ StarbytesClassType StarbytesBoolType();
 StarbytesClassType StarbytesFuncRefType();
 StarbytesClassType StarbytesRegexType();
 StarbytesClassType StarbytesTaskType();
+StarbytesClassType StarbytesBytesType();
 
 typedef enum {
     StarbytesRuntimeObjectKindString = 0,
@@ -47,6 +48,7 @@ typedef enum {
     StarbytesRuntimeObjectKindRegex,
     StarbytesRuntimeObjectKindTask,
     StarbytesRuntimeObjectKindCustomClass,
+    StarbytesRuntimeObjectKindBytes,
     StarbytesRuntimeObjectKindCount
 } StarbytesRuntimeObjectKind;
 
@@ -86,6 +88,14 @@ void StarbytesObjectReference(StarbytesObject obj);
 
 void StarbytesObjectRelease(StarbytesObject obj);
 
+/// Attaches native state to an object of a native class, replacing any state attached before.
+/// `finalizer` frees the state when the object is freed. Returns 0 for builtin objects and
+/// script class instances, which keep their own storage.
+int StarbytesObjectSetNativeData(StarbytesObject obj,void *data,void (*finalizer)(void *));
+/// Returns the state attached with `finalizer`, or NULL. The finalizer doubles as a type tag,
+/// so state attached by another module or native class is never returned.
+void *StarbytesObjectGetNativeData(StarbytesObject obj,void (*finalizer)(void *));
+
 void StarbytesRuntimeProfileSetLowLevelCountersEnabled(int enabled);
 void StarbytesRuntimeProfileResetLowLevelCounters();
 void StarbytesRuntimeProfileGetLowLevelCounters(StarbytesRuntimeLowLevelCounters *outCounters);
@@ -104,6 +114,7 @@ typedef StarbytesObject StarbytesBool;
 typedef StarbytesObject StarbytesNum;
 typedef StarbytesObject StarbytesFuncRef;
 typedef StarbytesObject StarbytesTask;
+typedef StarbytesObject StarbytesBytes;
 
 /// @}
 ///
@@ -166,6 +177,12 @@ typedef enum {
 
 int StarbytesArrayTryGetNumeric(StarbytesArray array,unsigned int index,StarbytesNumT outType,long double *valueOut);
 int StarbytesArrayTrySetNumeric(StarbytesArray array,unsigned int index,StarbytesNumT valueType,long double value);
+/// Returns the packed storage of a non-empty Array that holds only numbers and writes its element
+/// type (int, int64_t, float or double) to `typeOut`. Returns NULL for empty or boxed arrays.
+/// The pointer is valid until the array is next modified.
+const void *StarbytesArrayGetNumericData(StarbytesArray array,StarbytesNumT *typeOut);
+/// Creates an Array of `length` numbers of `type` copied from packed `data`, or zero-filled when `data` is NULL.
+StarbytesArray StarbytesArrayNewNumeric(StarbytesNumT type,const void *data,unsigned int length);
 
 StarbytesNum StarbytesNumNew(StarbytesNumT type,...);
 StarbytesNum StarbytesNumCopy(StarbytesNum);
@@ -228,8 +245,38 @@ void StarbytesTaskResolve(StarbytesTask task,StarbytesObject value);
 void StarbytesTaskReject(StarbytesTask task,const char *error);
 StarbytesObject StarbytesTaskGetValue(StarbytesTask task);
 CString StarbytesTaskGetError(StarbytesTask task);
+
+/// Drives native work that settles tasks outside the interpreter (for example network
+/// transfers). `await` runs the registered drivers while the awaited task is pending and no
+/// microtasks are queued. A driver returns nonzero while it still has work in flight and must
+/// not block: between runs `await` waits until a driver is signalled, or at most a few
+/// milliseconds for drivers that can only poll.
+typedef int (*StarbytesTaskDriver)(void);
+void StarbytesRuntimeAddTaskDriver(StarbytesTaskDriver driver);
+int StarbytesRuntimeRunTaskDrivers(void);
+/// Wakes an `await` waiting on the task drivers. Safe to call from any thread; workers call it
+/// once a completion is ready for their driver to settle.
+void StarbytesRuntimeSignalTaskDrivers(void);
+/// Waits up to `timeoutMillis` for a signal. Returns at once if one arrived since the last wait.
+void StarbytesRuntimeWaitForTaskDrivers(int timeoutMillis);
 ///@}
 
+/// @name Starbytes Bytes Methods
+/// @{
+/// Bytes is an immutable, contiguous byte buffer. A slice is a view that shares
+/// the storage of the buffer it was taken from and keeps that buffer alive.
+
+/// Creates a zero-filled buffer that native code may fill through StarbytesBytesGetData before publishing it.
+StarbytesBytes StarbytesBytesNew(size_t length);
+StarbytesBytes StarbytesBytesNewWithData(const void *data,size_t length);
+StarbytesBytes StarbytesBytesSlice(StarbytesBytes bytes,size_t offset,size_t length);
+unsigned char *StarbytesBytesGetData(StarbytesBytes bytes);
+size_t StarbytesBytesGetLength(StarbytesBytes bytes);
+/// Shrinks a freshly created buffer to the number of bytes actually produced.
+void StarbytesBytesTruncate(StarbytesBytes bytes,size_t length);
+int StarbytesBytesCompare(StarbytesBytes lhs,StarbytesBytes rhs);
+/// @}
+
 StarbytesObject StarbytesFuncArgsGetArg(StarbytesFuncArgs args);
 
 /// Runtime command-line context (set by host/driver, read by stdlib modules)
@@ -7,6 +7,7 @@
 #include "Session.h"
 #include "starbytes/base/Diagnostic.h"
 #include "starbytes/compiler/AST.h"
+#include "starbytes/compiler/Lexer.h"
 #include "starbytes/compiler/Parser.h"
 
 namespace starbytes::linguistics {
@@ -45,6 +46,34 @@ OwnedCompilerLintAnalysis buildCompilerLintAnalysis(
     const LinguisticsSession &session,
     const CompilerLintAnalysisRequest &request = CompilerLintAnalysisRequest());
 
+/// One parse of a session's text, shared read-only by the formatter, lint, and suggestion engines.
+struct LinguisticsArtifact {
+    OwnedCompilerLintAnalysis compiler;
+    /// Empty when lexing failed, in which case nothing was parsed.
+    std::vector<Syntax::Tok> tokens;
+    bool lexerHadError = false;
+    /// Top-level statements that passed semantic checks, in source order.
+    std::vector<ASTStmt *> acceptedStatements;
+    /// Set when any diagnostic of any phase is an error.
+    bool hadError = false;
+    /// Set when the text contains `//` or `/*`, which the parser drops.
+    bool containsCommentMarkers = false;
+
+    const LinguisticsSession &session() const {
+        return compiler.session;
+    }
+
+    CompilerLintAnalysis view() const {
+        return compiler.view();
+    }
+};
+
+using SharedLinguisticsArtifact = std::shared_ptr<const LinguisticsArtifact>;
+
+SharedLinguisticsArtifact buildLinguisticsArtifact(
+    const LinguisticsSession &session,
+    const CompilerLintAnalysisRequest &request = CompilerLintAnalysisRequest());
+
 } // namespace starbytes::linguistics
 
 #endif // STARBYTES_LINGUISTICS_ANALYSIS_H
@@ -37,6 +37,9 @@ struct LinguisticsConfig {
     ActionConfig actions;
 
     static LinguisticsConfig defaults();
+
+    /// Canonical text form of every setting; equal configs have equal fingerprints.
+    std::string fingerprint() const;
 };
 
 } // namespace starbytes::linguistics
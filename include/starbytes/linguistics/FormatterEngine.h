@@ -4,6 +4,7 @@
 #include <string>
 #include <vector>
 
+#include "Analysis.h"
 #include "Config.h"
 #include "Session.h"
 
@@ -28,6 +29,11 @@ public:
                         const LinguisticsConfig &config,
                         const FormatRequest &request = FormatRequest()) const;
 
+    /// Formats from an existing parse of the session text instead of parsing it again.
+    FormatResult format(const LinguisticsArtifact &artifact,
+                        const LinguisticsConfig &config,
+                        const FormatRequest &request = FormatRequest()) const;
+
     static std::string normalizePreview(const std::string &source,
                                         const FormattingConfig &config);
 };
@@ -1,6 +1,8 @@
 #ifndef STARBYTES_LINGUISTICS_LINTENGINE_H
 #define STARBYTES_LINGUISTICS_LINTENGINE_H
 
+#include <cstdint>
+#include <string>
 #include <vector>
 
 #include "Analysis.h"
@@ -30,10 +32,20 @@ struct LintRuleDescriptor {
 
 struct LintRequest {
     bool includeSuggestions = true;
+    /// Time each rule's callbacks and report them in `LintResult::ruleTimings`.
+    bool profileRules = false;
+};
+
+struct LintRuleTiming {
+    std::string id;
+    uint64_t elapsedNs = 0;
+    size_t findingCount = 0;
 };
 
 struct LintResult {
     std::vector<LintFinding> findings;
+    /// One entry per enabled rule, in registry order; empty unless `LintRequest::profileRules` is set.
+    std::vector<LintRuleTiming> ruleTimings;
 };
 
 class LintEngine {
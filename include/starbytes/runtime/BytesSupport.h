@@ -0,0 +1,21 @@
+#ifndef STARBYTES_RUNTIME_BYTESSUPPORT_H
+#define STARBYTES_RUNTIME_BYTESSUPPORT_H
+
+#include "starbytes/interop.h"
+
+#include <string>
+
+namespace starbytes::Runtime::bytes {
+
+StarbytesObject at(StarbytesObject bytesObject,int index,std::string &errorOut);
+StarbytesObject slice(StarbytesObject bytesObject,int start,int end);
+StarbytesObject copy(StarbytesObject bytesObject);
+StarbytesObject toArray(StarbytesObject bytesObject);
+StarbytesObject toHex(StarbytesObject bytesObject);
+StarbytesObject toText(StarbytesObject bytesObject,std::string &errorOut);
+StarbytesObject fromString(StarbytesObject stringObject);
+StarbytesObject fromArray(StarbytesObject arrayObject,std::string &errorOut);
+
+}
+
+#endif
@@ -5,8 +5,11 @@
 
 #include <cerrno>
 #include <cstring>
+#include <mutex>
 #include <string>
 #include <system_error>
+#include <utility>
+#include <vector>
 
 namespace starbytes::Runtime::stdlib {
 
@@ -32,6 +35,51 @@ inline StarbytesObject failNativeIfEmpty(StarbytesFuncArgs args,const std::strin
     return nullptr;
 }
 
+/// Read-only view of a byte argument. Bytes and String arguments are borrowed for the
+/// duration of the native call; Int arrays are copied into `storage`.
+struct ByteView {
+    const unsigned char *data = nullptr;
+    size_t length = 0;
+    std::vector<unsigned char> storage;
+};
+
+inline bool readByteView(StarbytesObject arg,ByteView &out) {
+    out.storage.clear();
+    if(!arg) {
+        return false;
+    }
+    if(StarbytesObjectTypecheck(arg,StarbytesBytesType())) {
+        out.data = StarbytesBytesGetData(arg);
+        out.length = StarbytesBytesGetLength(arg);
+        return true;
+    }
+    if(StarbytesObjectTypecheck(arg,StarbytesStrType())) {
+        auto *text = StarbytesStrGetBuffer(arg);
+        out.data = reinterpret_cast<const unsigned char *>(text);
+        out.length = text ? std::strlen(text) : 0;
+        return true;
+    }
+    if(!StarbytesObjectTypecheck(arg,StarbytesArrayType())) {
+        return false;
+    }
+    auto len = StarbytesArrayGetLength(arg);
+    out.storage.reserve(len);
+    for(unsigned i = 0; i < len; ++i) {
+        auto item = StarbytesArrayIndex(arg,i);
+        if(!item || !StarbytesObjectTypecheck(item,StarbytesNumType()) || StarbytesNumGetType(item) != NumTypeInt) {
+            return false;
+        }
+        auto value = StarbytesNumGetIntValue(item);
+        if(value < 0 || value > 255) {
+            return false;
+        }
+        out.storage.push_back(static_cast<unsigned char>(value));
+    }
+    out.data = out.storage.data();
+    out.length = out.storage.size();
+    return true;
+}
+
 inline std::string systemErrorMessage(const std::string &context,const std::error_code &error) {
     if(error) {
         return context + ": " + error.message();
@@ -47,6 +95,54 @@ inline std::string errnoMessage(const std::string &context) {
     return context + ": " + std::strerror(currentErrno);
 }
 
+/// Hands work finished on other threads to the interpreter thread, which settles its tasks from
+/// a task driver. `beginJob`, `abandonJob` and `drive` run on the interpreter thread; `complete`
+/// may run on any thread and wakes an `await` waiting on the drivers.
+template<typename Completion>
+class TaskCompletionQueue {
+public:
+    /// Called on the interpreter thread for every task a completion will settle.
+    void beginJob() {
+        ++inFlight;
+    }
+
+    void abandonJob() {
+        --inFlight;
+    }
+
+    void complete(Completion completion) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            completed.push_back(std::move(completion));
+        }
+        StarbytesRuntimeSignalTaskDrivers();
+    }
+
+    /// Settles the completions that have arrived without waiting for more. Returns nonzero while
+    /// jobs are still running.
+    template<typename Settle>
+    int drive(Settle &&settle) {
+        if(inFlight == 0) {
+            return 0;
+        }
+        std::vector<Completion> batch;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            batch.swap(completed);
+        }
+        for(auto &completion : batch) {
+            settle(completion);
+            --inFlight;
+        }
+        return inFlight > 0 ? 1 : 0;
+    }
+
+private:
+    std::mutex mutex;
+    std::vector<Completion> completed;
+    size_t inFlight = 0;
+};
+
 }
 
 #endif
@@ -0,0 +1,736 @@
+#include "starbytes/base/Digest.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+
+#ifdef STARBYTES_HAS_OPENSSL
+#include <openssl/evp.h>
+#endif
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define STARBYTES_DIGEST_X86_SHA 1
+#include <cpuid.h>
+#include <immintrin.h>
+#endif
+
+namespace starbytes {
+
+namespace {
+
+constexpr uint32_t kMd5Init[4] = {0x67452301u,0xefcdab89u,0x98badcfeu,0x10325476u};
+constexpr uint32_t kSha1Init[5] = {0x67452301u,0xefcdab89u,0x98badcfeu,0x10325476u,0xc3d2e1f0u};
+constexpr uint32_t kSha256Init[8] = {
+    0x6a09e667u,0xbb67ae85u,0x3c6ef372u,0xa54ff53au,0x510e527fu,0x9b05688cu,0x1f83d9abu,0x5be0cd19u
+};
+/// Shared by SHA-512 and BLAKE2b.
+constexpr uint64_t kSha512Init[8] = {
+    0x6a09e667f3bcc908ull,0xbb67ae8584caa73bull,0x3c6ef372fe94f82bull,0xa54ff53a5f1d36f1ull,
+    0x510e527fade682d1ull,0x9b05688c2b3e6c1full,0x1f83d9abfb41bd6bull,0x5be0cd19137e2179ull
+};
+
+constexpr uint32_t kMd5K[64] = {
+    0xd76aa478u,0xe8c7b756u,0x242070dbu,0xc1bdceeeu,0xf57c0fafu,0x4787c62au,0xa8304613u,0xfd469501u,
+    0x698098d8u,0x8b44f7afu,0xffff5bb1u,0x895cd7beu,0x6b901122u,0xfd987193u,0xa679438eu,0x49b40821u,
+    0xf61e2562u,0xc040b340u,0x265e5a51u,0xe9b6c7aau,0xd62f105du,0x02441453u,0xd8a1e681u,0xe7d3fbc8u,
+    0x21e1cde6u,0xc33707d6u,0xf4d50d87u,0x455a14edu,0xa9e3e905u,0xfcefa3f8u,0x676f02d9u,0x8d2a4c8au,
+    0xfffa3942u,0x8771f681u,0x6d9d6122u,0xfde5380cu,0xa4beea44u,0x4bdecfa9u,0xf6bb4b60u,0xbebfbc70u,
+    0x289b7ec6u,0xeaa127fau,0xd4ef3085u,0x04881d05u,0xd9d4d039u,0xe6db99e5u,0x1fa27cf8u,0xc4ac5665u,
+    0xf4292244u,0x432aff97u,0xab9423a7u,0xfc93a039u,0x655b59c3u,0x8f0ccc92u,0xffeff47du,0x85845dd1u,
+    0x6fa87e4fu,0xfe2ce6e0u,0xa3014314u,0x4e0811a1u,0xf7537e82u,0xbd3af235u,0x2ad7d2bbu,0xeb86d391u
+};
+
+constexpr unsigned kMd5Shift[64] = {
+    7,12,17,22,7,12,17,22,7,12,17,22,7,12,17,22,
+    5,9,14,20,5,9,14,20,5,9,14,20,5,9,14,20,
+    4,11,16,23,4,11,16,23,4,11,16,23,4,11,16,23,
+    6,10,15,21,6,10,15,21,6,10,15,21,6,10,15,21
+};
+
+alignas(16) constexpr uint32_t kSha256K[64] = {
+    0x428a2f98u,0x71374491u,0xb5c0fbcfu,0xe9b5dba5u,0x3956c25bu,0x59f111f1u,0x923f82a4u,0xab1c5ed5u,
+    0xd807aa98u,0x12835b01u,0x243185beu,0x550c7dc3u,0x72be5d74u,0x80deb1feu,0x9bdc06a7u,0xc19bf174u,
+    0xe49b69c1u,0xefbe4786u,0x0fc19dc6u,0x240ca1ccu,0x2de92c6fu,0x4a7484aau,0x5cb0a9dcu,0x76f988dau,
+    0x983e5152u,0xa831c66du,0xb00327c8u,0xbf597fc7u,0xc6e00bf3u,0xd5a79147u,0x06ca6351u,0x14292967u,
+    0x27b70a85u,0x2e1b2138u,0x4d2c6dfcu,0x53380d13u,0x650a7354u,0x766a0abbu,0x81c2c92eu,0x92722c85u,
+    0xa2bfe8a1u,0xa81a664bu,0xc24b8b70u,0xc76c51a3u,0xd192e819u,0xd6990624u,0xf40e3585u,0x106aa070u,
+    0x19a4c116u,0x1e376c08u,0x2748774cu,0x34b0bcb5u,0x391c0cb3u,0x4ed8aa4au,0x5b9cca4fu,0x682e6ff3u,
+    0x748f82eeu,0x78a5636fu,0x84c87814u,0x8cc70208u,0x90befffau,0xa4506cebu,0xbef9a3f7u,0xc67178f2u
+};
+
+constexpr uint64_t kSha512K[80] = {
+    0x428a2f98d728ae22ull,0x7137449123ef65cdull,0xb5c0fbcfec4d3b2full,0xe9b5dba58189dbbcull,
+    0x3956c25bf348b538ull,0x59f111f1b605d019ull,0x923f82a4af194f9bull,0xab1c5ed5da6d8118ull,
+    0xd807aa98a3030242ull,0x12835b0145706fbeull,0x243185be4ee4b28cull,0x550c7dc3d5ffb4e2ull,
+    0x72be5d74f27b896full,0x80deb1fe3b1696b1ull,0x9bdc06a725c71235ull,0xc19bf174cf692694ull,
+    0xe49b69c19ef14ad2ull,0xefbe4786384f25e3ull,0x0fc19dc68b8cd5b5ull,0x240ca1cc77ac9c65ull,
+    0x2de92c6f592b0275ull,0x4a7484aa6ea6e483ull,0x5cb0a9dcbd41fbd4ull,0x76f988da831153b5ull,
+    0x983e5152ee66dfabull,0xa831c66d2db43210ull,0xb00327c898fb213full,0xbf597fc7beef0ee4ull,
+    0xc6e00bf33da88fc2ull,0xd5a79147930aa725ull,0x06ca6351e003826full,0x142929670a0e6e70ull,
+    0x27b70a8546d22ffcull,0x2e1b21385c26c926ull,0x4d2c6dfc5ac42aedull,0x53380d139d95b3dfull,
+    0x650a73548baf63deull,0x766a0abb3c77b2a8ull,0x81c2c92e47edaee6ull,0x92722c851482353bull,
+    0xa2bfe8a14cf10364ull,0xa81a664bbc423001ull,0xc24b8b70d0f89791ull,0xc76c51a30654be30ull,
+    0xd192e819d6ef5218ull,0xd69906245565a910ull,0xf40e35855771202aull,0x106aa07032bbd1b8ull,
+    0x19a4c116b8d2d0c8ull,0x1e376c085141ab53ull,0x2748774cdf8eeb99ull,0x34b0bcb5e19b48a8ull,
+    0x391c0cb3c5c95a63ull,0x4ed8aa4ae3418acbull,0x5b9cca4f7763e373ull,0x682e6ff3d6b2b8a3ull,
+    0x748f82ee5defb2fcull,0x78a5636f43172f60ull,0x84c87814a1f0ab72ull,0x8cc702081a6439ecull,
+    0x90befffa23631e28ull,0xa4506cebde82bde9ull,0xbef9a3f7b2c67915ull,0xc67178f2e372532bull,
+    0xca273eceea26619cull,0xd186b8c721c0c207ull,0xeada7dd6cde0eb1eull,0xf57d4f7fee6ed178ull,
+    0x06f067aa72176fbaull,0x0a637dc5a2c898a6ull,0x113f9804bef90daeull,0x1b710b35131c471bull,
+    0x28db77f523047d84ull,0x32caab7b40c72493ull,0x3c9ebe0a15c9bebcull,0x431d67c49c100d4cull,
+    0x4cc5d4becb3e42b6ull,0x597f299cfc657e2aull,0x5fcb6fab3ad6faecull,0x6c44198c4a475817ull
+};
+
+constexpr uint8_t kBlake2bSigma[10][16] = {
+    {0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15},
+    {14,10,4,8,9,15,13,6,1,12,0,2,11,7,5,3},
+    {11,8,12,0,5,2,15,13,10,14,3,6,7,1,9,4},
+    {7,9,3,1,13,12,11,14,2,6,5,10,4,0,15,8},
+    {9,0,5,7,2,4,10,15,14,1,11,12,6,8,3,13},
+    {2,12,6,10,0,11,8,3,4,13,7,5,15,14,1,9},
+    {12,5,1,15,14,13,4,10,0,7,6,3,9,2,8,11},
+    {13,11,7,14,12,1,3,9,5,0,15,4,8,6,2,10},
+    {6,15,14,9,11,3,0,8,12,2,13,7,1,4,10,5},
+    {10,2,8,4,7,6,1,5,15,11,9,14,3,12,13,0}
+};
+
+inline uint32_t rotl32(uint32_t value,unsigned bits) {
+    return (value << bits) | (value >> (32 - bits));
+}
+
+inline uint32_t rotr32(uint32_t value,unsigned bits) {
+    return (value >> bits) | (value << (32 - bits));
+}
+
+inline uint64_t rotr64(uint64_t value,unsigned bits) {
+    return (value >> bits) | (value << (64 - bits));
+}
+
+inline uint32_t loadLe32(const unsigned char *p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+inline uint32_t loadBe32(const unsigned char *p) {
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | (uint32_t)p[3];
+}
+
+inline uint64_t loadLe64(const unsigned char *p) {
+    return (uint64_t)loadLe32(p) | ((uint64_t)loadLe32(p + 4) << 32);
+}
+
+inline uint64_t loadBe64(const unsigned char *p) {
+    return ((uint64_t)loadBe32(p) << 32) | (uint64_t)loadBe32(p + 4);
+}
+
+inline void storeLe32(unsigned char *p,uint32_t value) {
+    for(int i = 0; i < 4; ++i) {
+        p[i] = (unsigned char)(value >> (8 * i));
+    }
+}
+
+inline void storeBe32(unsigned char *p,uint32_t value) {
+    for(int i = 0; i < 4; ++i) {
+        p[i] = (unsigned char)(value >> (24 - 8 * i));
+    }
+}
+
+inline void storeLe64(unsigned char *p,uint64_t value) {
+    for(int i = 0; i < 8; ++i) {
+        p[i] = (unsigned char)(value >> (8 * i));
+    }
+}
+
+inline void storeBe64(unsigned char *p,uint64_t value) {
+    for(int i = 0; i < 8; ++i) {
+        p[i] = (unsigned char)(value >> (56 - 8 * i));
+    }
+}
+
+void md5Compress(uint32_t *state,const unsigned char *blocks,size_t count) {
+    for(; count > 0; --count,blocks += 64) {
+        uint32_t m[16];
+        for(int i = 0; i < 16; ++i) {
+            m[i] = loadLe32(blocks + i * 4);
+        }
+        uint32_t a = state[0],b = state[1],c = state[2],d = state[3];
+        for(unsigned i = 0; i < 64; ++i) {
+            uint32_t f;
+            unsigned g;
+            if(i < 16) {
+                f = (b & c) | (~b & d);
+                g = i;
+            }
+            else if(i < 32) {
+                f = (d & b) | (~d & c);
+                g = (5 * i + 1) % 16;
+            }
+            else if(i < 48) {
+                f = b ^ c ^ d;
+                g = (3 * i + 5) % 16;
+            }
+            else {
+                f = c ^ (b | ~d);
+                g = (7 * i) % 16;
+            }
+            f += a + kMd5K[i] + m[g];
+            a = d;
+            d = c;
+            c = b;
+            b += rotl32(f,kMd5Shift[i]);
+        }
+        state[0] += a;
+        state[1] += b;
+        state[2] += c;
+        state[3] += d;
+    }
+}
+
+void sha1Compress(uint32_t *state,const unsigned char *blocks,size_t count) {
+    for(; count > 0; --count,blocks += 64) {
+        uint32_t w[80];
+        for(int i = 0; i < 16; ++i) {
+            w[i] = loadBe32(blocks + i * 4);
+        }
+        for(int i = 16; i < 80; ++i) {
+            w[i] = rotl32(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16],1);
+        }
+        uint32_t a = state[0],b = state[1],c = state[2],d = state[3],e = state[4];
+        auto round = [&](uint32_t f,uint32_t k,uint32_t word) {
+            uint32_t temp = rotl32(a,5) + f + e + k + word;
+            e = d;
+            d = c;
+            c = rotl32(b,30);
+            b = a;
+            a = temp;
+        };
+        for(int i = 0; i < 20; ++i) {
+            round((b & c) | (~b & d),0x5a827999u,w[i]);
+        }
+        for(int i = 20; i < 40; ++i) {
+            round(b ^ c ^ d,0x6ed9eba1u,w[i]);
+        }
+        for(int i = 40; i < 60; ++i) {
+            round((b & c) | (b & d) | (c & d),0x8f1bbcdcu,w[i]);
+        }
+        for(int i = 60; i < 80; ++i) {
+            round(b ^ c ^ d,0xca62c1d6u,w[i]);
+        }
+        state[0] += a;
+        state[1] += b;
+        state[2] += c;
+        state[3] += d;
+        state[4] += e;
+    }
+}
+
+void sha256CompressPortable(uint32_t *state,const unsigned char *blocks,size_t count) {
+    for(; count > 0; --count,blocks += 64) {
+        uint32_t w[64];
+        for(int i = 0; i < 16; ++i) {
+            w[i] = loadBe32(blocks + i * 4);
+        }
+        for(int i = 16; i < 64; ++i) {
+            uint32_t s0 = rotr32(w[i - 15],7) ^ rotr32(w[i - 15],18) ^ (w[i - 15] >> 3);
+            uint32_t s1 = rotr32(w[i - 2],17) ^ rotr32(w[i - 2],19) ^ (w[i - 2] >> 10);
+            w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+        }
+        uint32_t a = state[0],b = state[1],c = state[2],d = state[3];
+        uint32_t e = state[4],f = state[5],g = state[6],h = state[7];
+        for(int i = 0; i < 64; ++i) {
+            uint32_t s1 = rotr32(e,6) ^ rotr32(e,11) ^ rotr32(e,25);
+            uint32_t ch = (e & f) ^ (~e & g);
+            uint32_t t1 = h + s1 + ch + kSha256K[i] + w[i];
+            uint32_t s0 = rotr32(a,2) ^ rotr32(a,13) ^ rotr32(a,22);
+            uint32_t maj = (a & b) ^ (a & c) ^ (b & c);
+            uint32_t t2 = s0 + maj;
+            h = g;
+            g = f;
+            f = e;
+            e = d + t1;
+            d = c;
+            c = b;
+            b = a;
+            a = t1 + t2;
+        }
+        state[0] += a;
+        state[1] += b;
+        state[2] += c;
+        state[3] += d;
+        state[4] += e;
+        state[5] += f;
+        state[6] += g;
+        state[7] += h;
+    }
+}
+
+#ifdef STARBYTES_DIGEST_X86_SHA
+/// Four SHA-256 rounds. `cur` holds the schedule words for this group; when requested, the
+/// group also finishes the words of the next group and starts those of the group after it.
+__attribute__((target("sha,sse4.1"))) inline void sha256ShaNiQuad(__m128i &state0,
+                                                                  __m128i &state1,
+                                                                  __m128i cur,
+                                                                  __m128i &next,
+                                                                  __m128i &prev,
+                                                                  int group,
+                                                                  bool finishNext,
+                                                                  bool startPrev) {
+    __m128i msg = _mm_add_epi32(cur,_mm_load_si128(reinterpret_cast<const __m128i *>(kSha256K + group * 4)));
+    state1 = _mm_sha256rnds2_epu32(state1,state0,msg);
+    if(finishNext) {
+        next = _mm_add_epi32(next,_mm_alignr_epi8(cur,prev,4));
+        next = _mm_sha256msg2_epu32(next,cur);
+    }
+    msg = _mm_shuffle_epi32(msg,0x0E);
+    state0 = _mm_sha256rnds2_epu32(state0,state1,msg);
+    if(startPrev) {
+        prev = _mm_sha256msg1_epu32(prev,cur);
+    }
+}
+
+__attribute__((target("sha,sse4.1"))) void sha256CompressShaNi(uint32_t *state,const unsigned char *blocks,size_t count) {
+    const __m128i byteSwap = _mm_set_epi64x(0x0c0d0e0f08090a0bll,0x0405060700010203ll);
+
+    // Rearrange a..h into the ABEF/CDGH register layout the instructions expect.
+    __m128i tmp = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(state)),0xB1);
+    __m128i state1 = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(state + 4)),0x1B);
+    __m128i state0 = _mm_alignr_epi8(tmp,state1,8);
+    state1 = _mm_blend_epi16(state1,tmp,0xF0);
+
+    for(; count > 0; --count,blocks += 64) {
+        __m128i savedState0 = state0;
+        __m128i savedState1 = state1;
+        __m128i msg[4];
+        for(int i = 0; i < 4; ++i) {
+            msg[i] = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(blocks + i * 16)),byteSwap);
+        }
+        for(int group = 0; group < 16; ++group) {
+            sha256ShaNiQuad(state0,state1,msg[group & 3],msg[(group + 1) & 3],msg[(group + 3) & 3],group,
+                            group >= 3 && group <= 14,group >= 1 && group <= 12);
+        }
+        state0 = _mm_add_epi32(state0,savedState0);
+        state1 = _mm_add_epi32(state1,savedState1);
+    }
+
+    tmp = _mm_shuffle_epi32(state0,0x1B);
+    state1 = _mm_shuffle_epi32(state1,0xB1);
+    state0 = _mm_blend_epi16(tmp,state1,0xF0);
+    state1 = _mm_alignr_epi8(state1,tmp,8);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(state),state0);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(state + 4),state1);
+}
+
+bool cpuHasShaExtensions() {
+    unsigned eax = 0,ebx = 0,ecx = 0,edx = 0;
+    if(!__get_cpuid(1,&eax,&ebx,&ecx,&edx)) {
+        return false;
+    }
+    bool hasSse41 = (ecx & (1u << 19)) != 0;
+    bool hasSsse3 = (ecx & (1u << 9)) != 0;
+    if(!__get_cpuid_count(7,0,&eax,&ebx,&ecx,&edx)) {
+        return false;
+    }
+    return hasSse41 && hasSsse3 && (ebx & (1u << 29)) != 0;
+}
+#endif
+
+using Sha256CompressFn = void (*)(uint32_t *,const unsigned char *,size_t);
+
+Sha256CompressFn selectSha256Compress() {
+#ifdef STARBYTES_DIGEST_X86_SHA
+    if(cpuHasShaExtensions()) {
+        return sha256CompressShaNi;
+    }
+#endif
+    return sha256CompressPortable;
+}
+
+Sha256CompressFn sha256Compress() {
+    static const Sha256CompressFn selected = selectSha256Compress();
+    return selected;
+}
+
+void sha512Compress(uint64_t *state,const unsigned char *blocks,size_t count) {
+    for(; count > 0; --count,blocks += 128) {
+        uint64_t w[80];
+        for(int i = 0; i < 16; ++i) {
+            w[i] = loadBe64(blocks + i * 8);
+        }
+        for(int i = 16; i < 80; ++i) {
+            uint64_t s0 = rotr64(w[i - 15],1) ^ rotr64(w[i - 15],8) ^ (w[i - 15] >> 7);
+            uint64_t s1 = rotr64(w[i - 2],19) ^ rotr64(w[i - 2],61) ^ (w[i - 2] >> 6);
+            w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+        }
+        uint64_t a = state[0],b = state[1],c = state[2],d = state[3];
+        uint64_t e = state[4],f = state[5],g = state[6],h = state[7];
+        for(int i = 0; i < 80; ++i) {
+            uint64_t s1 = rotr64(e,14) ^ rotr64(e,18) ^ rotr64(e,41);
+            uint64_t ch = (e & f) ^ (~e & g);
+            uint64_t t1 = h + s1 + ch + kSha512K[i] + w[i];
+            uint64_t s0 = rotr64(a,28) ^ rotr64(a,34) ^ rotr64(a,39);
+            uint64_t maj = (a & b) ^ (a & c) ^ (b & c);
+            uint64_t t2 = s0 + maj;
+            h = g;
+            g = f;
+            f = e;
+            e = d + t1;
+            d = c;
+            c = b;
+            b = a;
+            a = t1 + t2;
+        }
+        state[0] += a;
+        state[1] += b;
+        state[2] += c;
+        state[3] += d;
+        state[4] += e;
+        state[5] += f;
+        state[6] += g;
+        state[7] += h;
+    }
+}
+
+inline void blake2bMix(uint64_t *v,int a,int b,int c,int d,uint64_t x,uint64_t y) {
+    v[a] = v[a] + v[b] + x;
+    v[d] = rotr64(v[d] ^ v[a],32);
+    v[c] = v[c] + v[d];
+    v[b] = rotr64(v[b] ^ v[c],24);
+    v[a] = v[a] + v[b] + y;
+    v[d] = rotr64(v[d] ^ v[a],16);
+    v[c] = v[c] + v[d];
+    v[b] = rotr64(v[b] ^ v[c],63);
+}
+
+/// `bytesSoFar` counts every byte up to and including this block (RFC 7693 counter t).
+void blake2bCompress(uint64_t *state,const unsigned char *block,uint64_t bytesSoFar,bool last) {
+    uint64_t m[16];
+    for(int i = 0; i < 16; ++i) {
+        m[i] = loadLe64(block + i * 8);
+    }
+    uint64_t v[16];
+    for(int i = 0; i < 8; ++i) {
+        v[i] = state[i];
+        v[i + 8] = kSha512Init[i];
+    }
+    v[12] ^= bytesSoFar;
+    if(last) {
+        v[14] = ~v[14];
+    }
+    for(int round = 0; round < 12; ++round) {
+        const uint8_t *s = kBlake2bSigma[round % 10];
+        blake2bMix(v,0,4,8,12,m[s[0]],m[s[1]]);
+        blake2bMix(v,1,5,9,13,m[s[2]],m[s[3]]);
+        blake2bMix(v,2,6,10,14,m[s[4]],m[s[5]]);
+        blake2bMix(v,3,7,11,15,m[s[6]],m[s[7]]);
+        blake2bMix(v,0,5,10,15,m[s[8]],m[s[9]]);
+        blake2bMix(v,1,6,11,12,m[s[10]],m[s[11]]);
+        blake2bMix(v,2,7,8,13,m[s[12]],m[s[13]]);
+        blake2bMix(v,3,4,9,14,m[s[14]],m[s[15]]);
+    }
+    for(int i = 0; i < 8; ++i) {
+        state[i] ^= v[i] ^ v[i + 8];
+    }
+}
+
+#ifdef STARBYTES_HAS_OPENSSL
+const EVP_MD *opensslDigest(DigestKind kind) {
+    switch(kind) {
+        case DigestKind::Md5:
+            return EVP_md5();
+        case DigestKind::Sha1:
+            return EVP_sha1();
+        case DigestKind::Sha256:
+            return EVP_sha256();
+        case DigestKind::Sha512:
+            return EVP_sha512();
+        case DigestKind::Blake2b:
+            return EVP_blake2b512();
+    }
+    return nullptr;
+}
+#endif
+
+}
+
+bool digestKindFromName(const std::string &name,DigestKind &outKind) {
+    std::string lowered = name;
+    std::transform(lowered.begin(),lowered.end(),lowered.begin(),[](unsigned char c) {
+        return (char)std::tolower(c);
+    });
+    lowered.erase(std::remove(lowered.begin(),lowered.end(),'-'),lowered.end());
+    if(lowered == "md5") {
+        outKind = DigestKind::Md5;
+    }
+    else if(lowered == "sha1") {
+        outKind = DigestKind::Sha1;
+    }
+    else if(lowered == "sha256") {
+        outKind = DigestKind::Sha256;
+    }
+    else if(lowered == "sha512") {
+        outKind = DigestKind::Sha512;
+    }
+    else if(lowered == "blake2b" || lowered == "blake2b512") {
+        outKind = DigestKind::Blake2b;
+    }
+    else {
+        return false;
+    }
+    return true;
+}
+
+size_t digestLength(DigestKind kind) {
+    switch(kind) {
+        case DigestKind::Md5:
+            return 16;
+        case DigestKind::Sha1:
+            return 20;
+        case DigestKind::Sha256:
+            return 32;
+        case DigestKind::Sha512:
+        case DigestKind::Blake2b:
+            return 64;
+    }
+    return 0;
+}
+
+size_t digestBlockSize(DigestKind kind) {
+    return kind == DigestKind::Sha512 || kind == DigestKind::Blake2b ? 128 : 64;
+}
+
+const char *sha256Implementation() {
+    return sha256Compress() == sha256CompressPortable ? "portable" : "sha-ni";
+}
+
+Digest::Digest(DigestKind kind): digestKind(kind) {
+#ifdef STARBYTES_HAS_OPENSSL
+    ctx = EVP_MD_CTX_new();
+    isValid = ctx != nullptr;
+#endif
+    reset();
+}
+
+Digest::Digest(const Digest &other):
+    digestKind(other.digestKind),
+    isValid(other.isValid),
+    totalBytes(other.totalBytes),
+    bufferLength(other.bufferLength) {
+    std::memcpy(state32,other.state32,sizeof(state32));
+    std::memcpy(state64,other.state64,sizeof(state64));
+    std::memcpy(buffer,other.buffer,sizeof(buffer));
+#ifdef STARBYTES_HAS_OPENSSL
+    ctx = EVP_MD_CTX_new();
+    isValid = isValid && ctx && EVP_MD_CTX_copy_ex(ctx,other.ctx) == 1;
+#endif
+}
+
+Digest::~Digest() {
+#ifdef STARBYTES_HAS_OPENSSL
+    EVP_MD_CTX_free(ctx);
+#endif
+}
+
+void Digest::reset() {
+    totalBytes = 0;
+    bufferLength = 0;
+#ifdef STARBYTES_HAS_OPENSSL
+    if(ctx) {
+        isValid = EVP_DigestInit_ex(ctx,opensslDigest(digestKind),nullptr) == 1;
+    }
+    return;
+#else
+    switch(digestKind) {
+        case DigestKind::Md5:
+            std::memcpy(state32,kMd5Init,sizeof(kMd5Init));
+            break;
+        case DigestKind::Sha1:
+            std::memcpy(state32,kSha1Init,sizeof(kSha1Init));
+            break;
+        case DigestKind::Sha256:
+            std::memcpy(state32,kSha256Init,sizeof(kSha256Init));
+            break;
+        case DigestKind::Sha512:
+            std::memcpy(state64,kSha512Init,sizeof(kSha512Init));
+            break;
+        case DigestKind::Blake2b:
+            std::memcpy(state64,kSha512Init,sizeof(kSha512Init));
+            // Parameter block: 64-byte digest, no key, fanout and depth of 1.
+            state64[0] ^= 0x01010000ull ^ 64ull;
+            break;
+    }
+#endif
+}
+
+void Digest::compressBlocks(const unsigned char *blocks,size_t count) {
+    switch(digestKind) {
+        case DigestKind::Md5:
+            md5Compress(state32,blocks,count);
+            break;
+        case DigestKind::Sha1:
+            sha1Compress(state32,blocks,count);
+            break;
+        case DigestKind::Sha256:
+            sha256Compress()(state32,blocks,count);
+            break;
+        case DigestKind::Sha512:
+            sha512Compress(state64,blocks,count);
+            break;
+        case DigestKind::Blake2b:
+            for(size_t i = 0; i < count; ++i) {
+                blake2bCompress(state64,blocks + i * 128,totalBytes + (i + 1) * 128,false);
+            }
+            break;
+    }
+}
+
+bool Digest::update(const unsigned char *data,size_t length) {
+    if(!isValid) {
+        return false;
+    }
+#ifdef STARBYTES_HAS_OPENSSL
+    return length == 0 || EVP_DigestUpdate(ctx,data,length) == 1;
+#else
+    size_t blockSize = digestBlockSize(digestKind);
+    // BLAKE2b must hold back the final block until it knows it is the last one.
+    bool holdLastBlock = digestKind == DigestKind::Blake2b;
+
+    if(bufferLength > 0) {
+        size_t take = std::min(length,blockSize - bufferLength);
+        std::memcpy(buffer + bufferLength,data,take);
+        bufferLength += take;
+        data += take;
+        length -= take;
+        if(bufferLength < blockSize || (holdLastBlock && length == 0)) {
+            return true;
+        }
+        compressBlocks(buffer,1);
+        totalBytes += blockSize;
+        bufferLength = 0;
+    }
+
+    size_t fullBlocks = length / blockSize;
+    if(holdLastBlock && fullBlocks > 0 && length % blockSize == 0) {
+        --fullBlocks;
+    }
+    if(fullBlocks > 0) {
+        compressBlocks(data,fullBlocks);
+        totalBytes += fullBlocks * blockSize;
+        data += fullBlocks * blockSize;
+        length -= fullBlocks * blockSize;
+    }
+    if(length > 0) {
+        std::memcpy(buffer,data,length);
+        bufferLength = length;
+    }
+    return true;
+#endif
+}
+
+bool Digest::final(unsigned char *out) const {
+    if(!isValid) {
+        return false;
+    }
+    Digest copy(*this);
+    if(!copy.isValid) {
+        return false;
+    }
+#ifdef STARBYTES_HAS_OPENSSL
+    unsigned int outLength = 0;
+    return EVP_DigestFinal_ex(copy.ctx,out,&outLength) == 1;
+#else
+    copy.finalInPlace(out);
+    return true;
+#endif
+}
+
+void Digest::finalInPlace(unsigned char *out) {
+    if(digestKind == DigestKind::Blake2b) {
+        std::memset(buffer + bufferLength,0,128 - bufferLength);
+        blake2bCompress(state64,buffer,totalBytes + bufferLength,true);
+        for(int i = 0; i < 8; ++i) {
+            storeLe64(out + i * 8,state64[i]);
+        }
+        return;
+    }
+
+    size_t blockSize = digestBlockSize(digestKind);
+    size_t lengthFieldSize = blockSize == 128 ? 16 : 8;
+    uint64_t totalLength = totalBytes + bufferLength;
+
+    buffer[bufferLength++] = 0x80;
+    if(bufferLength > blockSize - lengthFieldSize) {
+        std::memset(buffer + bufferLength,0,blockSize - bufferLength);
+        compressBlocks(buffer,1);
+        bufferLength = 0;
+    }
+    std::memset(buffer + bufferLength,0,blockSize - bufferLength);
+    if(digestKind == DigestKind::Md5) {
+        storeLe64(buffer + blockSize - 8,totalLength << 3);
+    }
+    else {
+        storeBe64(buffer + blockSize - 8,totalLength << 3);
+        if(lengthFieldSize == 16) {
+            storeBe64(buffer + blockSize - 16,totalLength >> 61);
+        }
+    }
+    compressBlocks(buffer,1);
+
+    switch(digestKind) {
+        case DigestKind::Md5:
+            for(int i = 0; i < 4; ++i) {
+                storeLe32(out + i * 4,state32[i]);
+            }
+            break;
+        case DigestKind::Sha1:
+        case DigestKind::Sha256:
+            for(size_t i = 0; i < digestLength(digestKind) / 4; ++i) {
+                storeBe32(out + i * 4,state32[i]);
+            }
+            break;
+        case DigestKind::Sha512:
+            for(int i = 0; i < 8; ++i) {
+                storeBe64(out + i * 8,state64[i]);
+            }
+            break;
+        case DigestKind::Blake2b:
+            break;
+    }
+}
+
+Hmac::Hmac(DigestKind kind,const unsigned char *key,size_t keyLength): inner(kind) {
+    size_t blockSize = digestBlockSize(kind);
+    unsigned char keyBlock[128] = {};
+    if(keyLength > blockSize) {
+        Digest keyDigest(kind);
+        isValid = keyDigest.update(key,keyLength) && keyDigest.final(keyBlock);
+    }
+    else if(keyLength > 0) {
+        std::memcpy(keyBlock,key,keyLength);
+    }
+    for(size_t i = 0; i < blockSize; ++i) {
+        innerPad[i] = keyBlock[i] ^ 0x36;
+        outerPad[i] = keyBlock[i] ^ 0x5c;
+    }
+    reset();
+}
+
+void Hmac::reset() {
+    inner.reset();
+    inner.update(innerPad,digestBlockSize(inner.kind()));
+}
+
+bool Hmac::update(const unsigned char *data,size_t length) {
+    return isValid && inner.update(data,length);
+}
+
+bool Hmac::final(unsigned char *out) const {
+    unsigned char innerDigest[kMaxDigestLength];
+    if(!isValid || !inner.final(innerDigest)) {
+        return false;
+    }
+    Digest outer(inner.kind());
+    return outer.update(outerPad,digestBlockSize(inner.kind()))
+        && outer.update(innerDigest,digestLength(inner.kind()))
+        && outer.final(out);
+}
+
+}
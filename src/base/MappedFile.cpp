@@ -0,0 +1,87 @@
+#include "starbytes/base/MappedFile.h"
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace starbytes {
+
+MappedFile::~MappedFile(){
+    close();
+}
+
+bool MappedFile::open(const std::filesystem::path &path){
+    close();
+#ifdef _WIN32
+    auto handle = CreateFileW(path.wstring().c_str(),GENERIC_READ,FILE_SHARE_READ | FILE_SHARE_DELETE,nullptr,
+                              OPEN_EXISTING,FILE_ATTRIBUTE_NORMAL,nullptr);
+    if(handle == INVALID_HANDLE_VALUE){
+        return false;
+    }
+    LARGE_INTEGER fileSize;
+    if(!GetFileSizeEx(handle,&fileSize) || fileSize.QuadPart == 0){
+        CloseHandle(handle);
+        return false;
+    }
+    auto mapping = CreateFileMappingW(handle,nullptr,PAGE_READONLY,0,0,nullptr);
+    if(!mapping){
+        CloseHandle(handle);
+        return false;
+    }
+    auto view = MapViewOfFile(mapping,FILE_MAP_READ,0,0,0);
+    if(!view){
+        CloseHandle(mapping);
+        CloseHandle(handle);
+        return false;
+    }
+    fileHandle = handle;
+    mappingHandle = mapping;
+    mappedData = static_cast<const char *>(view);
+    mappedSize = static_cast<size_t>(fileSize.QuadPart);
+#else
+    int fd = ::open(path.c_str(),O_RDONLY);
+    if(fd < 0){
+        return false;
+    }
+    struct stat st;
+    if(::fstat(fd,&st) != 0 || st.st_size == 0){
+        ::close(fd);
+        return false;
+    }
+    void *view = ::mmap(nullptr,static_cast<size_t>(st.st_size),PROT_READ,MAP_PRIVATE,fd,0);
+    ::close(fd);
+    if(view == MAP_FAILED){
+        return false;
+    }
+    mappedData = static_cast<const char *>(view);
+    mappedSize = static_cast<size_t>(st.st_size);
+#endif
+    return true;
+}
+
+void MappedFile::close(){
+    if(!mappedData){
+        return;
+    }
+#ifdef _WIN32
+    UnmapViewOfFile(mappedData);
+    CloseHandle(static_cast<HANDLE>(mappingHandle));
+    CloseHandle(static_cast<HANDLE>(fileHandle));
+    mappingHandle = nullptr;
+    fileHandle = nullptr;
+#else
+    ::munmap(const_cast<char *>(mappedData),mappedSize);
+#endif
+    mappedData = nullptr;
+    mappedSize = 0;
+}
+
+}
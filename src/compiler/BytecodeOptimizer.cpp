@@ -0,0 +1,1289 @@
+#include "starbytes/compiler/BytecodeOptimizer.h"
+#include <algorithm>
+#include <array>
+#include <cfloat>
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <cstring>
+#include <map>
+#include <optional>
+
+namespace starbytes {
+
+using namespace Runtime;
+
+namespace {
+
+constexpr uint32_t kNoSlot = UINT32_MAX;
+constexpr const char *kTempSlotPrefix = "__v2tmp";
+
+/// A folded constant in its kind's own representation: Int and Long in `integral`, Float and
+/// Double in `floating` (a Float is held exactly as the double it widens to).
+struct ConstValue {
+    RTTypedNumericKind kind = RTTYPED_NUM_OBJECT;
+    int64_t integral = 0;
+    double floating = 0.0;
+
+    static ConstValue ofInt(RTTypedNumericKind kind,int64_t value){
+        ConstValue out;
+        out.kind = kind;
+        out.integral = value;
+        return out;
+    }
+
+    static ConstValue ofFloat(RTTypedNumericKind kind,double value){
+        ConstValue out;
+        out.kind = kind;
+        out.floating = value;
+        return out;
+    }
+
+    bool isZero() const{
+        return kind == RTTYPED_NUM_INT || kind == RTTYPED_NUM_LONG ? integral == 0 : floating == 0.0;
+    }
+
+    bool equals(int64_t value) const{
+        return kind == RTTYPED_NUM_INT || kind == RTTYPED_NUM_LONG ? integral == value : floating == (double)value;
+    }
+
+    double asDouble() const{
+        return kind == RTTYPED_NUM_INT || kind == RTTYPED_NUM_LONG ? (double)integral : floating;
+    }
+};
+
+bool isNumericKind(uint8_t kind){
+    return kind == RTTYPED_NUM_INT || kind == RTTYPED_NUM_LONG
+        || kind == RTTYPED_NUM_FLOAT || kind == RTTYPED_NUM_DOUBLE;
+}
+
+bool isIntegralKind(uint8_t kind){
+    return kind == RTTYPED_NUM_INT || kind == RTTYPED_NUM_LONG;
+}
+
+bool fitsInt(int64_t value){
+    return value >= INT32_MIN && value <= INT32_MAX;
+}
+
+/// Mirrors the conversion the runtime performs when a numeric value is stored into a slot of `kind`
+/// (`wrapIntegers` false) or when a slot is read as `kind` (`wrapIntegers` true, where a Long read as
+/// an Int keeps its low 32 bits). Fails where that conversion would be undefined so such expressions
+/// are left for the runtime.
+bool convertConst(const ConstValue &value,uint8_t kind,bool wrapIntegers,ConstValue &out){
+    bool fromIntegral = isIntegralKind(value.kind);
+    switch(kind){
+        case RTTYPED_NUM_INT:
+            if(fromIntegral){
+                if(!wrapIntegers && !fitsInt(value.integral)){
+                    return false;
+                }
+                out = ConstValue::ofInt(RTTYPED_NUM_INT,(int32_t)(uint32_t)(uint64_t)value.integral);
+                return true;
+            }
+            if(!(value.floating > (double)INT32_MIN - 1.0 && value.floating < (double)INT32_MAX + 1.0)){
+                return false;
+            }
+            out = ConstValue::ofInt(RTTYPED_NUM_INT,(int32_t)value.floating);
+            return true;
+        case RTTYPED_NUM_LONG:
+            if(fromIntegral){
+                out = ConstValue::ofInt(RTTYPED_NUM_LONG,value.integral);
+                return true;
+            }
+            if(!(value.floating >= -9223372036854775808.0 && value.floating < 9223372036854775808.0)){
+                return false;
+            }
+            out = ConstValue::ofInt(RTTYPED_NUM_LONG,(int64_t)value.floating);
+            return true;
+        case RTTYPED_NUM_FLOAT:
+            if(fromIntegral){
+                out = ConstValue::ofFloat(RTTYPED_NUM_FLOAT,(double)(float)value.integral);
+                return true;
+            }
+            if(std::isfinite(value.floating) && std::fabs(value.floating) > (double)FLT_MAX){
+                return false;
+            }
+            out = ConstValue::ofFloat(RTTYPED_NUM_FLOAT,(double)(float)value.floating);
+            return true;
+        case RTTYPED_NUM_DOUBLE:
+            out = ConstValue::ofFloat(RTTYPED_NUM_DOUBLE,fromIntegral ? (double)value.integral : value.floating);
+            return true;
+        default:
+            return false;
+    }
+}
+
+/// Exact 64-bit arithmetic; fails on overflow, which the runtime leaves undefined.
+bool evalIntegral(uint8_t op,int64_t lhs,int64_t rhs,int64_t &out){
+    switch(op){
+        case RTTYPED_BINARY_ADD:
+            if((rhs > 0 && lhs > INT64_MAX - rhs) || (rhs < 0 && lhs < INT64_MIN - rhs)){
+                return false;
+            }
+            out = lhs + rhs;
+            return true;
+        case RTTYPED_BINARY_SUB:
+            if((rhs < 0 && lhs > INT64_MAX + rhs) || (rhs > 0 && lhs < INT64_MIN + rhs)){
+                return false;
+            }
+            out = lhs - rhs;
+            return true;
+        case RTTYPED_BINARY_MUL:
+            if(lhs > 0 ? (rhs > 0 ? lhs > INT64_MAX / rhs : rhs < INT64_MIN / lhs)
+                       : (rhs > 0 ? lhs < INT64_MIN / rhs : (lhs != 0 && rhs < INT64_MAX / lhs))){
+                return false;
+            }
+            out = lhs * rhs;
+            return true;
+        case RTTYPED_BINARY_DIV:
+        case RTTYPED_BINARY_MOD:
+            if(rhs == 0 || (lhs == INT64_MIN && rhs == -1)){
+                return false;
+            }
+            out = op == RTTYPED_BINARY_DIV ? lhs / rhs : lhs % rhs;
+            return true;
+        default:
+            return false;
+    }
+}
+
+template<typename T>
+bool evalFloating(uint8_t op,T lhs,T rhs,T &out){
+    switch(op){
+        case RTTYPED_BINARY_ADD:
+            out = lhs + rhs;
+            break;
+        case RTTYPED_BINARY_SUB:
+            out = lhs - rhs;
+            break;
+        case RTTYPED_BINARY_MUL:
+            out = lhs * rhs;
+            break;
+        case RTTYPED_BINARY_DIV:
+            if(rhs == 0){
+                return false;
+            }
+            out = lhs / rhs;
+            break;
+        case RTTYPED_BINARY_MOD:
+            if(rhs == 0){
+                return false;
+            }
+            out = (T)std::fmod((double)lhs,(double)rhs);
+            break;
+        default:
+            return false;
+    }
+    // A finite result that overflows the kind has no defined conversion in the runtime.
+    return !std::isinf(out) || std::isinf(lhs) || std::isinf(rhs);
+}
+
+/// Folds `lhs op rhs` in the arithmetic of `kind`; both operands already hold that kind.
+bool evalBinary(uint8_t kind,uint8_t op,const ConstValue &lhs,const ConstValue &rhs,ConstValue &out){
+    switch(kind){
+        case RTTYPED_NUM_INT: {
+            int64_t result = 0;
+            if(!evalIntegral(op,lhs.integral,rhs.integral,result) || !fitsInt(result)){
+                return false;
+            }
+            out = ConstValue::ofInt(RTTYPED_NUM_INT,result);
+            return true;
+        }
+        case RTTYPED_NUM_LONG: {
+            int64_t result = 0;
+            if(!evalIntegral(op,lhs.integral,rhs.integral,result)){
+                return false;
+            }
+            out = ConstValue::ofInt(RTTYPED_NUM_LONG,result);
+            return true;
+        }
+        case RTTYPED_NUM_FLOAT: {
+            float result = 0.0f;
+            if(!evalFloating<float>(op,(float)lhs.floating,(float)rhs.floating,result)){
+                return false;
+            }
+            out = ConstValue::ofFloat(RTTYPED_NUM_FLOAT,(double)result);
+            return true;
+        }
+        case RTTYPED_NUM_DOUBLE: {
+            double result = 0.0;
+            if(!evalFloating<double>(op,lhs.floating,rhs.floating,result)){
+                return false;
+            }
+            out = ConstValue::ofFloat(RTTYPED_NUM_DOUBLE,result);
+            return true;
+        }
+        default:
+            return false;
+    }
+}
+
+template<typename T>
+bool compareValues(uint8_t op,T lhs,T rhs,bool &out){
+    switch(op){
+        case RTTYPED_COMPARE_EQ: out = lhs == rhs; return true;
+        case RTTYPED_COMPARE_NE: out = lhs != rhs; return true;
+        case RTTYPED_COMPARE_LT: out = lhs < rhs; return true;
+        case RTTYPED_COMPARE_LE: out = lhs <= rhs; return true;
+        case RTTYPED_COMPARE_GT: out = lhs > rhs; return true;
+        case RTTYPED_COMPARE_GE: out = lhs >= rhs; return true;
+        default: return false;
+    }
+}
+
+bool evalCompare(uint8_t op,const ConstValue &lhs,const ConstValue &rhs,bool &out){
+    if(isIntegralKind(lhs.kind)){
+        return compareValues(op,lhs.integral,rhs.integral,out);
+    }
+    return compareValues(op,lhs.floating,rhs.floating,out);
+}
+
+bool isJump(const RTV2Instruction &instr){
+    return instr.opcode == RTV2_OP_JUMP || instr.opcode == RTV2_OP_JUMP_IF_FALSE;
+}
+
+uint32_t &jumpTarget(RTV2Instruction &instr){
+    return instr.opcode == RTV2_OP_JUMP ? instr.a : instr.b;
+}
+
+uint32_t definedSlot(const RTV2Instruction &instr){
+    switch(instr.opcode){
+        case RTV2_OP_MOVE:
+        case RTV2_OP_LOAD_I64_CONST:
+        case RTV2_OP_LOAD_F64_CONST:
+        case RTV2_OP_NUM_CAST:
+        case RTV2_OP_BINARY:
+        case RTV2_OP_COMPARE:
+        case RTV2_OP_ARRAY_GET:
+        case RTV2_OP_INTRINSIC_SQRT:
+        case RTV2_OP_CALL_DIRECT:
+            return instr.a;
+        default:
+            return kNoSlot;
+    }
+}
+
+template<typename Fn>
+void forEachUse(RTV2Instruction &instr,std::vector<RTV2CallSite> &callSites,Fn &&fn){
+    switch(instr.opcode){
+        case RTV2_OP_MOVE:
+        case RTV2_OP_NUM_CAST:
+        case RTV2_OP_INTRINSIC_SQRT:
+            fn(instr.b);
+            break;
+        case RTV2_OP_BINARY:
+        case RTV2_OP_COMPARE:
+        case RTV2_OP_ARRAY_GET:
+            fn(instr.b);
+            fn(instr.c);
+            break;
+        case RTV2_OP_ARRAY_SET:
+            fn(instr.a);
+            fn(instr.b);
+            fn(instr.c);
+            break;
+        case RTV2_OP_CALL_DIRECT:
+            if(instr.b < callSites.size()){
+                for(auto &slot : callSites[instr.b].argSlots){
+                    fn(slot);
+                }
+            }
+            break;
+        case RTV2_OP_JUMP_IF_FALSE:
+            fn(instr.a);
+            break;
+        case RTV2_OP_RETURN:
+            if(instr.a != kNoSlot){
+                fn(instr.a);
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+/// Fallback statements, calls and returns may read any named local (closures, captured frames).
+bool observesNamedSlots(const RTV2Instruction &instr){
+    return instr.opcode == RTV2_OP_V1_STMT || instr.opcode == RTV2_OP_CALL_DIRECT || instr.opcode == RTV2_OP_RETURN;
+}
+
+bool clobbersNamedSlots(const RTV2Instruction &instr){
+    return instr.opcode == RTV2_OP_V1_STMT || instr.opcode == RTV2_OP_CALL_DIRECT;
+}
+
+bool writesMemory(const RTV2Instruction &instr){
+    return instr.opcode == RTV2_OP_ARRAY_SET || instr.opcode == RTV2_OP_CALL_DIRECT || instr.opcode == RTV2_OP_V1_STMT;
+}
+
+bool endsBlock(const RTV2Instruction &instr){
+    return isJump(instr) || instr.opcode == RTV2_OP_RETURN;
+}
+
+class FunctionOptimizer {
+    RTV2FunctionImage &image;
+    RTFuncTemplate &templ;
+    uint32_t slotCount = 0;
+    uint32_t namedSlotCount = 0;
+
+    std::vector<uint32_t> defCounts;
+    std::vector<uint32_t> defIndices;
+    std::vector<bool> usesConfinedToDefBlock;
+    std::vector<uint32_t> blockOf;
+    std::vector<uint32_t> blockStarts;
+
+    void analyze(){
+        auto &instrs = image.instructions;
+        auto count = (uint32_t)instrs.size();
+        defCounts.assign(slotCount,0);
+        defIndices.assign(slotCount,kNoSlot);
+        usesConfinedToDefBlock.assign(slotCount,true);
+
+        std::vector<bool> leader(count + 1,false);
+        leader[0] = true;
+        for(uint32_t i = 0;i < count;++i){
+            auto &instr = instrs[i];
+            if(isJump(instr) && jumpTarget(instr) <= count){
+                leader[jumpTarget(instr)] = true;
+            }
+            if(endsBlock(instr)){
+                leader[i + 1] = true;
+            }
+        }
+        blockOf.assign(count,0);
+        blockStarts.clear();
+        for(uint32_t i = 0;i < count;++i){
+            if(leader[i]){
+                blockStarts.push_back(i);
+            }
+            blockOf[i] = (uint32_t)blockStarts.size() - 1;
+        }
+
+        for(uint32_t i = 0;i < count;++i){
+            auto def = definedSlot(instrs[i]);
+            if(def < slotCount){
+                defCounts[def] += 1;
+                defIndices[def] = i;
+            }
+        }
+        for(uint32_t i = 0;i < count;++i){
+            forEachUse(instrs[i],image.callSites,[&](uint32_t slot){
+                if(slot >= slotCount){
+                    return;
+                }
+                auto def = defIndices[slot];
+                if(def == kNoSlot || i <= def || blockOf[i] != blockOf[def]){
+                    usesConfinedToDefBlock[slot] = false;
+                }
+            });
+        }
+    }
+
+    bool isTemp(uint32_t slot) const{
+        return slot >= namedSlotCount && slot < slotCount;
+    }
+
+    bool isSsaTemp(uint32_t slot) const{
+        return isTemp(slot) && defCounts[slot] == 1;
+    }
+
+    uint8_t staticKind(uint32_t slot) const{
+        return slot < slotCount ? templ.slotKinds[slot] : RTTYPED_NUM_OBJECT;
+    }
+
+    uint8_t loadKind(RTV2Opcode opcode,uint32_t dest) const{
+        auto kind = staticKind(dest);
+        if(kind != RTTYPED_NUM_OBJECT){
+            return kind;
+        }
+        return opcode == RTV2_OP_LOAD_I64_CONST ? RTTYPED_NUM_INT : RTTYPED_NUM_DOUBLE;
+    }
+
+    /// Kind of the numeric value an SSA temp always holds, or OBJECT when it may hold an object or nothing.
+    uint8_t storedNumericKind(uint32_t slot) const{
+        if(!isSsaTemp(slot)){
+            return RTTYPED_NUM_OBJECT;
+        }
+        const auto &def = image.instructions[defIndices[slot]];
+        switch(def.opcode){
+            case RTV2_OP_LOAD_I64_CONST:
+            case RTV2_OP_LOAD_F64_CONST:
+                return loadKind(def.opcode,def.a);
+            case RTV2_OP_NUM_CAST:
+            case RTV2_OP_BINARY:
+            case RTV2_OP_ARRAY_GET:
+                return isNumericKind(def.kind) ? def.kind : RTTYPED_NUM_OBJECT;
+            case RTV2_OP_COMPARE:
+                return RTTYPED_NUM_INT;
+            case RTV2_OP_INTRINSIC_SQRT:
+                return RTTYPED_NUM_DOUBLE;
+            default:
+                return RTTYPED_NUM_OBJECT;
+        }
+    }
+
+    bool holdsNumber(uint32_t slot) const{
+        return storedNumericKind(slot) != RTTYPED_NUM_OBJECT;
+    }
+
+    std::optional<ConstValue> constantOf(uint32_t slot) const{
+        if(!isSsaTemp(slot)){
+            return std::nullopt;
+        }
+        const auto &def = image.instructions[defIndices[slot]];
+        ConstValue raw;
+        if(def.opcode == RTV2_OP_LOAD_I64_CONST && def.b < image.i64Consts.size()){
+            raw = ConstValue::ofInt(RTTYPED_NUM_LONG,image.i64Consts[def.b]);
+        }
+        else if(def.opcode == RTV2_OP_LOAD_F64_CONST && def.b < image.f64Consts.size()){
+            raw = ConstValue::ofFloat(RTTYPED_NUM_DOUBLE,image.f64Consts[def.b]);
+        }
+        else {
+            return std::nullopt;
+        }
+        ConstValue value;
+        if(!convertConst(raw,loadKind(def.opcode,def.a),false,value)){
+            return std::nullopt;
+        }
+        return value;
+    }
+
+    /// Reads the constant `slot` holds as `kind`, the way the runtime loads an operand.
+    bool readConstant(uint32_t slot,uint8_t kind,ConstValue &out) const{
+        auto constant = constantOf(slot);
+        return constant && convertConst(*constant,kind,true,out);
+    }
+
+    uint32_t internI64(int64_t value){
+        for(uint32_t i = 0;i < image.i64Consts.size();++i){
+            if(image.i64Consts[i] == value){
+                return i;
+            }
+        }
+        image.i64Consts.push_back(value);
+        return (uint32_t)image.i64Consts.size() - 1;
+    }
+
+    uint32_t internF64(double value){
+        for(uint32_t i = 0;i < image.f64Consts.size();++i){
+            if(std::memcmp(&image.f64Consts[i],&value,sizeof(double)) == 0){
+                return i;
+            }
+        }
+        image.f64Consts.push_back(value);
+        return (uint32_t)image.f64Consts.size() - 1;
+    }
+
+    /// Replaces the instruction at `index` with a constant load into the same destination.
+    bool replaceWithLoad(uint32_t index,const ConstValue &value){
+        auto dest = image.instructions[index].a;
+        RTV2Instruction load;
+        load.a = dest;
+        if(isIntegralKind(value.kind)){
+            load.opcode = RTV2_OP_LOAD_I64_CONST;
+            if(loadKind(load.opcode,dest) != value.kind){
+                return false;
+            }
+            load.b = internI64(value.integral);
+        }
+        else {
+            load.opcode = RTV2_OP_LOAD_F64_CONST;
+            if(loadKind(load.opcode,dest) != value.kind){
+                return false;
+            }
+            load.b = internF64(value.floating);
+        }
+        image.instructions[index] = load;
+        return true;
+    }
+
+    /// True when executing the instruction can neither fail nor touch anything but its destination.
+    bool isSideEffectFree(const RTV2Instruction &instr) const{
+        switch(instr.opcode){
+            case RTV2_OP_MOVE:
+            case RTV2_OP_LOAD_I64_CONST:
+            case RTV2_OP_LOAD_F64_CONST:
+                return true;
+            case RTV2_OP_NUM_CAST:
+                return isNumericKind(instr.kind) && isNumericKind(instr.aux) && holdsNumber(instr.b);
+            case RTV2_OP_COMPARE:
+                return isNumericKind(instr.kind) && holdsNumber(instr.b) && holdsNumber(instr.c);
+            case RTV2_OP_BINARY: {
+                if(!isNumericKind(instr.kind) || !holdsNumber(instr.b) || !holdsNumber(instr.c)){
+                    return false;
+                }
+                if(instr.aux == RTTYPED_BINARY_DIV || instr.aux == RTTYPED_BINARY_MOD){
+                    ConstValue divisor;
+                    return readConstant(instr.c,instr.kind,divisor) && !divisor.isZero()
+                        && !(isIntegralKind(instr.kind) && divisor.equals(-1));
+                }
+                return true;
+            }
+            case RTV2_OP_INTRINSIC_SQRT: {
+                ConstValue value;
+                return readConstant(instr.b,storedNumericKind(instr.b),value) && value.asDouble() >= 0.0;
+            }
+            default:
+                return false;
+        }
+    }
+
+    /// Length of the superinstruction the runtime would fuse starting at `index` (0 when none).
+    uint32_t fusionSpanAt(uint32_t index) const{
+        const auto &instrs = image.instructions;
+        if(index + 1 >= instrs.size()){
+            return 0;
+        }
+        const auto &first = instrs[index];
+        const auto &second = instrs[index + 1];
+        if(first.opcode == RTV2_OP_COMPARE && second.opcode == RTV2_OP_JUMP_IF_FALSE && second.a == first.a){
+            return 2;
+        }
+        if(first.opcode == RTV2_OP_BINARY && second.opcode == RTV2_OP_MOVE && second.b == first.a){
+            return 2;
+        }
+        if(index + 2 < instrs.size() && first.opcode == RTV2_OP_ARRAY_GET && second.opcode == RTV2_OP_BINARY){
+            const auto &third = instrs[index + 2];
+            if(third.opcode == RTV2_OP_ARRAY_SET && second.b == first.a && third.c == second.a
+               && third.a == first.b && third.b == first.c && first.kind == second.kind && first.kind == third.kind){
+                return 3;
+            }
+        }
+        return 0;
+    }
+
+    bool inFusedGroup(uint32_t index) const{
+        for(uint32_t back = 0;back < 3 && back <= index;++back){
+            if(fusionSpanAt(index - back) > back){
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void renameUses(uint32_t from,uint32_t to){
+        for(auto &instr : image.instructions){
+            forEachUse(instr,image.callSites,[&](uint32_t &slot){
+                if(slot == from){
+                    slot = to;
+                }
+            });
+        }
+    }
+
+    /// Drops NOPs and retargets jumps to the next surviving instruction.
+    size_t removeNops(){
+        auto &instrs = image.instructions;
+        auto count = (uint32_t)instrs.size();
+        std::vector<uint32_t> newIndex(count + 1,0);
+        uint32_t kept = 0;
+        for(uint32_t i = 0;i < count;++i){
+            newIndex[i] = kept;
+            if(instrs[i].opcode != RTV2_OP_NOP){
+                ++kept;
+            }
+        }
+        newIndex[count] = kept;
+        if(kept == count){
+            return 0;
+        }
+        std::vector<RTV2Instruction> compacted;
+        compacted.reserve(kept);
+        for(auto &instr : instrs){
+            if(instr.opcode == RTV2_OP_NOP){
+                continue;
+            }
+            if(isJump(instr)){
+                auto &target = jumpTarget(instr);
+                target = newIndex[std::min(target,count)];
+            }
+            compacted.push_back(instr);
+        }
+        instrs = std::move(compacted);
+        return count - kept;
+    }
+
+    size_t simplifyJumps(){
+        auto &instrs = image.instructions;
+        auto count = (uint32_t)instrs.size();
+        size_t changes = 0;
+        for(uint32_t i = 0;i < count;++i){
+            auto &instr = instrs[i];
+            if(!isJump(instr)){
+                continue;
+            }
+            auto &target = jumpTarget(instr);
+            // Only thread forward so loop exits keep pointing past their backedge.
+            auto resolved = target;
+            for(uint32_t hops = 0;hops < count && resolved < count && instrs[resolved].opcode == RTV2_OP_JUMP;++hops){
+                resolved = instrs[resolved].a;
+            }
+            if(resolved != target && resolved > i){
+                target = resolved;
+                ++changes;
+            }
+            if(target == i + 1){
+                instr = RTV2Instruction();
+                ++changes;
+            }
+        }
+        return changes;
+    }
+
+    size_t removeUnreachable(){
+        auto &instrs = image.instructions;
+        auto count = (uint32_t)instrs.size();
+        std::vector<bool> reachable(count,false);
+        std::vector<uint32_t> worklist{0};
+        while(!worklist.empty()){
+            auto pc = worklist.back();
+            worklist.pop_back();
+            if(pc >= count || reachable[pc]){
+                continue;
+            }
+            reachable[pc] = true;
+            auto &instr = instrs[pc];
+            if(isJump(instr)){
+                worklist.push_back(jumpTarget(instr));
+            }
+            if(instr.opcode != RTV2_OP_JUMP && instr.opcode != RTV2_OP_RETURN){
+                worklist.push_back(pc + 1);
+            }
+        }
+        size_t changes = 0;
+        for(uint32_t i = 0;i < count;++i){
+            if(!reachable[i] && instrs[i].opcode != RTV2_OP_NOP){
+                instrs[i] = RTV2Instruction();
+                ++changes;
+            }
+        }
+        return changes;
+    }
+
+    size_t removeDeadDefinitions(){
+        analyze();
+        auto &instrs = image.instructions;
+        auto count = (uint32_t)instrs.size();
+        auto blockCount = (uint32_t)blockStarts.size();
+        if(blockCount == 0){
+            return 0;
+        }
+        auto blockEnd = [&](uint32_t block){
+            return block + 1 < blockCount ? blockStarts[block + 1] : count;
+        };
+        auto killAndGen = [&](std::vector<bool> &live,RTV2Instruction &instr){
+            auto def = definedSlot(instr);
+            if(def < slotCount){
+                live[def] = false;
+            }
+            forEachUse(instr,image.callSites,[&](uint32_t slot){
+                if(slot < slotCount){
+                    live[slot] = true;
+                }
+            });
+            if(observesNamedSlots(instr)){
+                std::fill(live.begin(),live.begin() + namedSlotCount,true);
+            }
+        };
+
+        std::vector<bool> exitLive(slotCount,false);
+        std::fill(exitLive.begin(),exitLive.begin() + namedSlotCount,true);
+        std::vector<std::vector<bool>> liveIn(blockCount,std::vector<bool>(slotCount,false));
+        auto liveOutOf = [&](uint32_t block){
+            std::vector<bool> out(slotCount,false);
+            auto merge = [&](uint32_t target){
+                const auto &source = target >= count ? exitLive : liveIn[blockOf[target]];
+                for(uint32_t s = 0;s < slotCount;++s){
+                    if(source[s]){
+                        out[s] = true;
+                    }
+                }
+            };
+            auto &last = instrs[blockEnd(block) - 1];
+            if(isJump(last)){
+                merge(jumpTarget(last));
+            }
+            if(last.opcode != RTV2_OP_JUMP && last.opcode != RTV2_OP_RETURN){
+                merge(blockEnd(block));
+            }
+            return out;
+        };
+
+        bool changed = true;
+        while(changed){
+            changed = false;
+            for(uint32_t block = blockCount;block-- > 0;){
+                auto live = liveOutOf(block);
+                for(uint32_t i = blockEnd(block);i-- > blockStarts[block];){
+                    killAndGen(live,instrs[i]);
+                }
+                if(live != liveIn[block]){
+                    liveIn[block] = std::move(live);
+                    changed = true;
+                }
+            }
+        }
+
+        size_t changes = 0;
+        for(uint32_t block = 0;block < blockCount;++block){
+            auto live = liveOutOf(block);
+            for(uint32_t i = blockEnd(block);i-- > blockStarts[block];){
+                auto &instr = instrs[i];
+                auto def = definedSlot(instr);
+                if(def < slotCount && !live[def]){
+                    if(instr.opcode == RTV2_OP_CALL_DIRECT){
+                        instr.a = kNoSlot;
+                        ++changes;
+                    }
+                    else if(isSideEffectFree(instr)){
+                        instr = RTV2Instruction();
+                        ++changes;
+                        continue;
+                    }
+                }
+                killAndGen(live,instr);
+            }
+        }
+        return changes;
+    }
+
+    bool isWellFormedLoop(uint32_t header,uint32_t backedge) const{
+        const auto &instrs = image.instructions;
+        for(uint32_t i = 0;i < instrs.size();++i){
+            if(!isJump(instrs[i])){
+                continue;
+            }
+            auto target = instrs[i].opcode == RTV2_OP_JUMP ? instrs[i].a : instrs[i].b;
+            bool inside = i >= header && i <= backedge;
+            if(!inside && target > header && target <= backedge){
+                return false;
+            }
+            if(inside && target < header){
+                return false;
+            }
+        }
+        return true;
+    }
+
+    std::vector<uint32_t> selectLoopInvariants(uint32_t header,uint32_t backedge) const{
+        std::vector<uint32_t> hoisted;
+        std::vector<bool> invariant(slotCount,false);
+        for(uint32_t i = header;i <= backedge;++i){
+            const auto &instr = image.instructions[i];
+            if(instr.opcode != RTV2_OP_LOAD_I64_CONST && instr.opcode != RTV2_OP_LOAD_F64_CONST
+               && instr.opcode != RTV2_OP_BINARY && instr.opcode != RTV2_OP_COMPARE
+               && instr.opcode != RTV2_OP_NUM_CAST){
+                continue;
+            }
+            if(!isSsaTemp(instr.a) || inFusedGroup(i) || !isSideEffectFree(instr)){
+                continue;
+            }
+            bool operandsInvariant = true;
+            auto copy = instr;
+            forEachUse(copy,image.callSites,[&](uint32_t slot){
+                if(!isSsaTemp(slot) || !(defIndices[slot] < header || invariant[slot])){
+                    operandsInvariant = false;
+                }
+            });
+            if(!operandsInvariant){
+                continue;
+            }
+            invariant[instr.a] = true;
+            hoisted.push_back(i);
+        }
+        return hoisted;
+    }
+
+    void hoistIntoPreheader(uint32_t header,uint32_t backedge,const std::vector<uint32_t> &hoisted){
+        auto &instrs = image.instructions;
+        auto count = (uint32_t)instrs.size();
+        std::vector<bool> moved(count,false);
+        for(auto index : hoisted){
+            moved[index] = true;
+        }
+        std::vector<uint32_t> newIndex(count + 1,kNoSlot);
+        std::vector<RTV2Instruction> rewritten;
+        rewritten.reserve(count);
+        for(uint32_t i = 0;i < header;++i){
+            newIndex[i] = (uint32_t)rewritten.size();
+            rewritten.push_back(instrs[i]);
+        }
+        auto preheaderStart = (uint32_t)rewritten.size();
+        for(auto index : hoisted){
+            rewritten.push_back(instrs[index]);
+        }
+        for(uint32_t i = header;i < count;++i){
+            if(moved[i]){
+                continue;
+            }
+            newIndex[i] = (uint32_t)rewritten.size();
+            rewritten.push_back(instrs[i]);
+        }
+        newIndex[count] = (uint32_t)rewritten.size();
+        auto retarget = [&](uint32_t target){
+            target = std::min(target,count);
+            while(newIndex[target] == kNoSlot){
+                ++target;
+            }
+            return newIndex[target];
+        };
+        for(uint32_t i = 0;i < count;++i){
+            if(moved[i] || !isJump(instrs[i])){
+                continue;
+            }
+            auto &target = jumpTarget(rewritten[newIndex[i]]);
+            bool fromOutside = i < header || i > backedge;
+            target = (fromOutside && target == header) ? preheaderStart : retarget(target);
+        }
+        instrs = std::move(rewritten);
+    }
+
+public:
+    FunctionOptimizer(RTV2FunctionImage &image,RTFuncTemplate &templ) : image(image),templ(templ){
+        slotCount = (uint32_t)std::min(templ.slotKinds.size(),templ.localSlotNames.size());
+        namedSlotCount = slotCount;
+        auto prefixLength = std::strlen(kTempSlotPrefix);
+        for(uint32_t i = 0;i < slotCount;++i){
+            const auto &name = templ.localSlotNames[i];
+            if(name.value && name.len >= prefixLength && std::strncmp(name.value,kTempSlotPrefix,prefixLength) == 0){
+                namedSlotCount = i;
+                break;
+            }
+        }
+    }
+
+    size_t instructionCount() const{
+        return image.instructions.size();
+    }
+
+    size_t foldConstants(){
+        analyze();
+        size_t changes = 0;
+        bool progress = true;
+        while(progress){
+            progress = false;
+            for(uint32_t i = 0;i < image.instructions.size();++i){
+                auto instr = image.instructions[i];
+                bool folded = false;
+                switch(instr.opcode){
+                    case RTV2_OP_BINARY: {
+                        ConstValue lhs,rhs,result;
+                        folded = isNumericKind(instr.kind)
+                            && readConstant(instr.b,instr.kind,lhs) && readConstant(instr.c,instr.kind,rhs)
+                            && evalBinary(instr.kind,instr.aux,lhs,rhs,result)
+                            && replaceWithLoad(i,result);
+                        break;
+                    }
+                    case RTV2_OP_COMPARE: {
+                        ConstValue lhs,rhs;
+                        bool result = false;
+                        folded = isNumericKind(instr.kind)
+                            && readConstant(instr.b,instr.kind,lhs) && readConstant(instr.c,instr.kind,rhs)
+                            && evalCompare(instr.aux,lhs,rhs,result)
+                            && replaceWithLoad(i,ConstValue::ofInt(RTTYPED_NUM_INT,result ? 1 : 0));
+                        break;
+                    }
+                    case RTV2_OP_NUM_CAST: {
+                        ConstValue value,stored;
+                        folded = isNumericKind(instr.kind) && isNumericKind(instr.aux)
+                            && readConstant(instr.b,instr.aux,value)
+                            && convertConst(value,instr.kind,false,stored)
+                            && replaceWithLoad(i,stored);
+                        break;
+                    }
+                    case RTV2_OP_INTRINSIC_SQRT: {
+                        auto inputKind = staticKind(instr.b) != RTTYPED_NUM_OBJECT ? staticKind(instr.b) : (uint8_t)RTTYPED_NUM_DOUBLE;
+                        ConstValue value;
+                        folded = readConstant(instr.b,inputKind,value) && !(value.asDouble() < 0.0)
+                            && replaceWithLoad(i,ConstValue::ofFloat(RTTYPED_NUM_DOUBLE,std::sqrt(value.asDouble())));
+                        break;
+                    }
+                    case RTV2_OP_JUMP_IF_FALSE: {
+                        auto constant = constantOf(instr.a);
+                        if(constant){
+                            auto &target = image.instructions[i];
+                            if(!constant->isZero()){
+                                target = RTV2Instruction();
+                            }
+                            else {
+                                target = RTV2Instruction();
+                                target.opcode = RTV2_OP_JUMP;
+                                target.a = instr.b;
+                            }
+                            folded = true;
+                        }
+                        break;
+                    }
+                    default:
+                        break;
+                }
+                if(folded){
+                    ++changes;
+                    progress = true;
+                }
+            }
+        }
+        return changes;
+    }
+
+    size_t eliminateDeadCode(){
+        size_t total = 0;
+        for(;;){
+            size_t changes = simplifyJumps();
+            changes += removeUnreachable();
+            changes += removeDeadDefinitions();
+            changes += removeNops();
+            if(changes == 0){
+                break;
+            }
+            total += changes;
+        }
+        return total;
+    }
+
+    size_t eliminateCommonSubexpressions(){
+        analyze();
+        auto &instrs = image.instructions;
+        size_t changes = 0;
+        std::vector<uint64_t> versions(slotCount,0);
+        uint64_t namedEpoch = 0;
+        uint64_t memoryEpoch = 0;
+        std::map<std::array<uint64_t,10>,uint32_t> available;
+        for(uint32_t i = 0;i < instrs.size();++i){
+            if(i == 0 || blockOf[i] != blockOf[i - 1]){
+                available.clear();
+            }
+            auto &instr = instrs[i];
+            bool candidate = false;
+            std::array<uint64_t,10> key{};
+            key[0] = instr.opcode;
+            key[1] = instr.kind;
+            key[2] = instr.aux;
+            auto operandKey = [&](size_t at,uint32_t slot){
+                key[at] = slot;
+                key[at + 1] = slot < slotCount ? versions[slot] : 0;
+                key[at + 2] = slot < namedSlotCount ? namedEpoch : 0;
+            };
+            switch(instr.opcode){
+                case RTV2_OP_LOAD_I64_CONST:
+                case RTV2_OP_LOAD_F64_CONST:
+                    candidate = true;
+                    key[1] = loadKind(instr.opcode,instr.a);
+                    key[3] = instr.opcode == RTV2_OP_LOAD_I64_CONST
+                        ? (instr.b < image.i64Consts.size() ? (uint64_t)image.i64Consts[instr.b] : ~0ull)
+                        : 0;
+                    if(instr.opcode == RTV2_OP_LOAD_F64_CONST && instr.b < image.f64Consts.size()){
+                        std::memcpy(&key[3],&image.f64Consts[instr.b],sizeof(double));
+                    }
+                    break;
+                case RTV2_OP_NUM_CAST:
+                case RTV2_OP_INTRINSIC_SQRT:
+                    candidate = true;
+                    operandKey(3,instr.b);
+                    break;
+                case RTV2_OP_BINARY:
+                case RTV2_OP_COMPARE:
+                    candidate = true;
+                    operandKey(3,instr.b);
+                    operandKey(6,instr.c);
+                    break;
+                case RTV2_OP_ARRAY_GET:
+                    candidate = true;
+                    operandKey(3,instr.b);
+                    operandKey(6,instr.c);
+                    key[9] = memoryEpoch;
+                    break;
+                default:
+                    break;
+            }
+            if(candidate && isSsaTemp(instr.a) && !inFusedGroup(i)){
+                auto found = available.find(key);
+                if(found != available.end()){
+                    auto &earlier = instrs[found->second];
+                    if(staticKind(earlier.a) == staticKind(instr.a) && usesConfinedToDefBlock[instr.a]
+                       && !inFusedGroup(found->second)){
+                        auto replacement = earlier.a;
+                        auto eliminated = instr.a;
+                        instr = RTV2Instruction();
+                        renameUses(eliminated,replacement);
+                        ++changes;
+                        continue;
+                    }
+                }
+                else {
+                    available.emplace(key,i);
+                }
+            }
+            auto def = definedSlot(instr);
+            if(def < slotCount){
+                versions[def] += 1;
+            }
+            if(clobbersNamedSlots(instr)){
+                ++namedEpoch;
+            }
+            if(writesMemory(instr)){
+                ++memoryEpoch;
+            }
+        }
+        return changes;
+    }
+
+    size_t hoistLoopInvariants(){
+        size_t total = 0;
+        auto limit = image.instructions.size();
+        for(size_t round = 0;round <= limit;++round){
+            analyze();
+            std::vector<std::pair<uint32_t,uint32_t>> loops;
+            for(uint32_t i = 0;i < image.instructions.size();++i){
+                const auto &instr = image.instructions[i];
+                if(instr.opcode == RTV2_OP_JUMP && instr.a <= i){
+                    loops.emplace_back(instr.a,i);
+                }
+            }
+            std::sort(loops.begin(),loops.end(),[](const auto &lhs,const auto &rhs){
+                return (lhs.second - lhs.first) < (rhs.second - rhs.first);
+            });
+            bool hoistedAny = false;
+            for(const auto &loop : loops){
+                if(!isWellFormedLoop(loop.first,loop.second)){
+                    continue;
+                }
+                auto hoisted = selectLoopInvariants(loop.first,loop.second);
+                if(hoisted.empty()){
+                    continue;
+                }
+                hoistIntoPreheader(loop.first,loop.second,hoisted);
+                total += hoisted.size();
+                hoistedAny = true;
+                break;
+            }
+            if(!hoistedAny){
+                break;
+            }
+        }
+        return total;
+    }
+
+    size_t reduceStrength(){
+        analyze();
+        size_t changes = 0;
+        for(uint32_t i = 0;i < image.instructions.size();++i){
+            auto instr = image.instructions[i];
+            if(!isSsaTemp(instr.a) || staticKind(instr.a) != instr.kind || !isNumericKind(instr.kind)){
+                continue;
+            }
+            uint32_t forwarded = kNoSlot;
+            if(instr.opcode == RTV2_OP_NUM_CAST){
+                if(instr.aux == instr.kind && storedNumericKind(instr.b) == instr.kind){
+                    forwarded = instr.b;
+                }
+            }
+            else if(instr.opcode == RTV2_OP_BINARY){
+                ConstValue lhs,rhs;
+                bool lhsConst = readConstant(instr.b,instr.kind,lhs);
+                bool rhsConst = readConstant(instr.c,instr.kind,rhs);
+                bool integral = isIntegralKind(instr.kind);
+                switch(instr.aux){
+                    case RTTYPED_BINARY_MUL:
+                        if(integral && ((lhsConst && lhs.isZero() && holdsNumber(instr.c))
+                                        || (rhsConst && rhs.isZero() && holdsNumber(instr.b)))){
+                            if(replaceWithLoad(i,ConstValue::ofInt((RTTypedNumericKind)instr.kind,0))){
+                                ++changes;
+                            }
+                            continue;
+                        }
+                        forwarded = (rhsConst && rhs.equals(1)) ? instr.b : (lhsConst && lhs.equals(1)) ? instr.c : kNoSlot;
+                        break;
+                    case RTTYPED_BINARY_DIV:
+                        forwarded = (rhsConst && rhs.equals(1)) ? instr.b : kNoSlot;
+                        break;
+                    case RTTYPED_BINARY_ADD:
+                        if(integral){
+                            forwarded = (rhsConst && rhs.isZero()) ? instr.b : (lhsConst && lhs.isZero()) ? instr.c : kNoSlot;
+                        }
+                        break;
+                    case RTTYPED_BINARY_SUB:
+                        if(integral){
+                            forwarded = (rhsConst && rhs.isZero()) ? instr.b : kNoSlot;
+                        }
+                        break;
+                    default:
+                        break;
+                }
+                if(forwarded != kNoSlot && storedNumericKind(forwarded) != instr.kind){
+                    forwarded = kNoSlot;
+                }
+            }
+            if(forwarded == kNoSlot || !usesConfinedToDefBlock[instr.a] || defIndices[forwarded] >= i){
+                continue;
+            }
+            image.instructions[i] = RTV2Instruction();
+            renameUses(instr.a,forwarded);
+            ++changes;
+        }
+        return changes;
+    }
+
+    /// Renumbers temporaries densely and drops constants, call sites and fallback blobs nothing references.
+    size_t compact(){
+        removeNops();
+        auto &instrs = image.instructions;
+        std::vector<uint32_t> slotMap(slotCount,kNoSlot);
+        for(uint32_t s = 0;s < namedSlotCount;++s){
+            slotMap[s] = s;
+        }
+        std::vector<bool> referenced(slotCount,false);
+        for(auto &instr : instrs){
+            auto def = definedSlot(instr);
+            if(def < slotCount){
+                referenced[def] = true;
+            }
+            forEachUse(instr,image.callSites,[&](uint32_t slot){
+                if(slot < slotCount){
+                    referenced[slot] = true;
+                }
+            });
+        }
+        std::vector<RTID> names(templ.localSlotNames.begin(),templ.localSlotNames.begin() + namedSlotCount);
+        std::vector<RTTypedNumericKind> kinds(templ.slotKinds.begin(),templ.slotKinds.begin() + namedSlotCount);
+        for(uint32_t s = namedSlotCount;s < slotCount;++s){
+            if(referenced[s]){
+                slotMap[s] = (uint32_t)names.size();
+                names.push_back(templ.localSlotNames[s]);
+                kinds.push_back(templ.slotKinds[s]);
+            }
+        }
+        size_t removedSlots = slotCount - names.size();
+        auto mapSlot = [&](uint32_t &slot){
+            if(slot < slotCount){
+                slot = slotMap[slot];
+            }
+        };
+
+        std::vector<int64_t> i64Consts;
+        std::vector<double> f64Consts;
+        std::vector<RTV2CallSite> callSites;
+        std::vector<std::vector<char>> fallbackBlobs;
+        std::map<uint32_t,uint32_t> i64Map,f64Map,callSiteMap,fallbackMap;
+        for(auto &instr : instrs){
+            if(instr.opcode != RTV2_OP_CALL_DIRECT){
+                forEachUse(instr,image.callSites,mapSlot);
+            }
+            if(definedSlot(instr) != kNoSlot){
+                mapSlot(instr.a);
+            }
+            if(instr.opcode == RTV2_OP_LOAD_I64_CONST && instr.b < image.i64Consts.size()){
+                auto inserted = i64Map.emplace(instr.b,(uint32_t)i64Consts.size());
+                if(inserted.second){
+                    i64Consts.push_back(image.i64Consts[instr.b]);
+                }
+                instr.b = inserted.first->second;
+            }
+            else if(instr.opcode == RTV2_OP_LOAD_F64_CONST && instr.b < image.f64Consts.size()){
+                auto inserted = f64Map.emplace(instr.b,(uint32_t)f64Consts.size());
+                if(inserted.second){
+                    f64Consts.push_back(image.f64Consts[instr.b]);
+                }
+                instr.b = inserted.first->second;
+            }
+            else if(instr.opcode == RTV2_OP_CALL_DIRECT && instr.b < image.callSites.size()){
+                auto inserted = callSiteMap.emplace(instr.b,(uint32_t)callSites.size());
+                if(inserted.second){
+                    forEachUse(instr,image.callSites,mapSlot);
+                    callSites.push_back(std::move(image.callSites[instr.b]));
+                }
+                instr.b = inserted.first->second;
+            }
+            else if(instr.opcode == RTV2_OP_V1_STMT && instr.a < image.fallbackStmtBlobs.size()){
+                auto inserted = fallbackMap.emplace(instr.a,(uint32_t)fallbackBlobs.size());
+                if(inserted.second){
+                    fallbackBlobs.push_back(std::move(image.fallbackStmtBlobs[instr.a]));
+                }
+                instr.a = inserted.first->second;
+            }
+        }
+        image.i64Consts = std::move(i64Consts);
+        image.f64Consts = std::move(f64Consts);
+        image.callSites = std::move(callSites);
+        image.fallbackStmtBlobs = std::move(fallbackBlobs);
+        templ.localSlotNames = std::move(names);
+        templ.slotKinds = std::move(kinds);
+        slotCount = (uint32_t)templ.slotKinds.size();
+        return removedSlots;
+    }
+};
+
+}
+
+const char *bytecodeOptLevelName(BytecodeOptLevel level){
+    switch(level){
+        case BytecodeOptLevel::O0:
+            return "O0";
+        case BytecodeOptLevel::O1:
+            return "O1";
+        case BytecodeOptLevel::O2:
+            return "O2";
+    }
+    return "O1";
+}
+
+BytecodeOptimizer::BytecodeOptimizer(BytecodeOptLevel level) : level(level){
+    std::vector<const char *> passNames;
+    if(level >= BytecodeOptLevel::O1){
+        passNames.push_back("const-fold");
+    }
+    if(level >= BytecodeOptLevel::O2){
+        passNames.push_back("strength-reduce");
+        passNames.push_back("cse");
+        passNames.push_back("licm");
+    }
+    if(level >= BytecodeOptLevel::O1){
+        passNames.push_back("dce");
+        passNames.push_back("compact");
+    }
+    for(auto *name : passNames){
+        BytecodeOptimizerPassStats pass;
+        pass.name = name;
+        statistics.passes.push_back(pass);
+    }
+}
+
+void BytecodeOptimizer::optimize(Runtime::RTV2FunctionImage &image,Runtime::RTFuncTemplate &templ){
+    if(level == BytecodeOptLevel::O0){
+        return;
+    }
+    statistics.functionsOptimized += 1;
+    statistics.instructionsBefore += image.instructions.size();
+
+    FunctionOptimizer function(image,templ);
+    size_t passIndex = 0;
+    auto runPass = [&](auto &&pass){
+        auto &passStats = statistics.passes[passIndex++];
+        auto start = std::chrono::steady_clock::now();
+        auto changes = pass();
+        auto end = std::chrono::steady_clock::now();
+        passStats.ns += (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+        passStats.runs += 1;
+        passStats.changes += changes;
+        return changes;
+    };
+
+    constexpr unsigned maxRounds = 4;
+    for(unsigned round = 0;round < maxRounds;++round){
+        passIndex = 0;
+        size_t changes = runPass([&]{ return function.foldConstants(); });
+        if(level >= BytecodeOptLevel::O2){
+            changes += runPass([&]{ return function.reduceStrength(); });
+            changes += runPass([&]{ return function.eliminateCommonSubexpressions(); });
+            changes += runPass([&]{ return function.hoistLoopInvariants(); });
+        }
+        changes += runPass([&]{ return function.eliminateDeadCode(); });
+        if(changes == 0){
+            break;
+        }
+    }
+    runPass([&]{ return function.compact(); });
+
+    statistics.instructionsAfter += image.instructions.size();
+}
+
+}
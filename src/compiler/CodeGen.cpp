@@ -1,4 +1,5 @@
 #include "starbytes/compiler/CodeGen.h"
+#include "starbytes/compiler/BytecodeOptimizer.h"
 #include "starbytes/compiler/ASTNodes.def"
 #include "starbytes/compiler/Gen.h"
 #include "starbytes/compiler/RTCode.h"
@@ -719,6 +720,9 @@ static bool emitRuntimeFunctionV2(ASTBlockStmt *blockStmt,
     RTV2FunctionImage image;
     CodeGen::BytecodeV2Lowerer lowerer(astConsumer,ctxt,blockStmt,orderedParams,templ);
     bool lowered = lowerer.lower(image);
+    if(lowered && ctxt->optimizer){
+        ctxt->optimizer->optimize(image,templ);
+    }
     if(lowered){
         std::ostringstream bodyBuffer(std::ios::out | std::ios::binary);
         lowered = writeRTV2FunctionImage(bodyBuffer,image);
@@ -1515,7 +1519,8 @@ ASTType *CodeGen::inferSemanticType(ASTExpr *expr) const{
             return nullptr;
         }
         if(baseType->nameMatches(STRING_TYPE) || baseType->nameMatches(ARRAY_TYPE)
-           || baseType->nameMatches(DICTIONARY_TYPE) || baseType->nameMatches(MAP_TYPE)){
+           || baseType->nameMatches(DICTIONARY_TYPE) || baseType->nameMatches(MAP_TYPE)
+           || baseType->nameMatches(BYTES_TYPE)){
             if(memberName == "length"){
                 return INT_TYPE;
             }
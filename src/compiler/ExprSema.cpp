@@ -816,6 +816,10 @@ static bool isRegexType(ASTType *type){
     return type && type->nameMatches(REGEX_TYPE);
 }
 
+static bool isBytesType(ASTType *type){
+    return type && type->nameMatches(BYTES_TYPE);
+}
+
 static bool isBoolType(ASTType *type){
     return type && type->nameMatches(BOOL_TYPE);
 }
@@ -875,7 +879,7 @@ static std::optional<std::string> resolveRuntimeTypeNameFromType(ASTType *candid
        || resolved->nameMatches(DICTIONARY_TYPE) || resolved->nameMatches(MAP_TYPE) || resolved->nameMatches(BOOL_TYPE)
        || resolved->nameMatches(INT_TYPE) || resolved->nameMatches(FLOAT_TYPE)
        || resolved->nameMatches(LONG_TYPE) || resolved->nameMatches(DOUBLE_TYPE)
-       || resolved->nameMatches(REGEX_TYPE) || resolved->nameMatches(ANY_TYPE)
+       || resolved->nameMatches(REGEX_TYPE) || resolved->nameMatches(BYTES_TYPE) || resolved->nameMatches(ANY_TYPE)
        || resolved->nameMatches(TASK_TYPE) || resolved->nameMatches(FUNCTION_TYPE)){
         return resolved->getName().str();
     }
@@ -2180,6 +2184,14 @@ ASTType * SemanticA::evalExprForTypeId(ASTExpr *expr_to_eval,
                     type = cloneTypeWithQualifiers(STRING_TYPE,expr_to_eval,true,false);
                     break;
                 }
+                if(isBytesType(baseType)){
+                    if(!indexType->nameMatches(INT_TYPE)){
+                        errStream.push(SemanticADiagnostic::create("Bytes indexing requires Int index.",expr_to_eval,Diagnostic::Error));
+                        return nullptr;
+                    }
+                    type = INT_TYPE;
+                    break;
+                }
                 if(isDictType(baseType)){
                     if(!(isStringType(indexType) || isNumericType(indexType))){
                         errStream.push(SemanticADiagnostic::create("Dictionary indexing requires String/Int/Long/Float/Double key.",expr_to_eval,Diagnostic::Error));
@@ -2282,7 +2294,7 @@ ASTType * SemanticA::evalExprForTypeId(ASTExpr *expr_to_eval,
                            || rawName == DICTIONARY_TYPE->getName() || rawName == MAP_TYPE->getName() || rawName == BOOL_TYPE->getName()
                            || rawName == INT_TYPE->getName() || rawName == FLOAT_TYPE->getName()
                            || rawName == LONG_TYPE->getName() || rawName == DOUBLE_TYPE->getName()
-                           || rawName == REGEX_TYPE->getName() || rawName == ANY_TYPE->getName()
+                           || rawName == REGEX_TYPE->getName() || rawName == BYTES_TYPE->getName() || rawName == ANY_TYPE->getName()
                            || rawName == TASK_TYPE->getName() || rawName == FUNCTION_TYPE->getName()){
                             runtimeTypeName = rawName.str();
                         }
@@ -2515,7 +2527,7 @@ ASTType * SemanticA::evalExprForTypeId(ASTExpr *expr_to_eval,
                        memberName == "contains" || memberName == "startsWith" || memberName == "endsWith" ||
                        memberName == "indexOf" || memberName == "lastIndexOf" || memberName == "lower" ||
                        memberName == "upper" || memberName == "trim" || memberName == "replace" ||
-                       memberName == "split" || memberName == "repeat"){
+                       memberName == "split" || memberName == "repeat" || memberName == "toBytes"){
                         setBuiltinMethod();
                         break;
                     }
@@ -2539,13 +2551,27 @@ ASTType * SemanticA::evalExprForTypeId(ASTExpr *expr_to_eval,
                        memberName == "at" || memberName == "set" || memberName == "insert" ||
                        memberName == "removeAt" || memberName == "clear" || memberName == "contains" ||
                        memberName == "indexOf" || memberName == "slice" || memberName == "join" ||
-                       memberName == "copy" || memberName == "reverse"){
+                       memberName == "copy" || memberName == "reverse" || memberName == "toBytes"){
                         setBuiltinMethod();
                         break;
                     }
                     errStream.push(SemanticADiagnostic::create("Unknown Array member.",expr_to_eval,Diagnostic::Error));
                     return nullptr;
                 }
+                if(isBytesType(leftType)){
+                    if(memberName == "length"){
+                        setBuiltinProperty(INT_TYPE);
+                        break;
+                    }
+                    if(memberName == "isEmpty" || memberName == "at" || memberName == "slice" ||
+                       memberName == "copy" || memberName == "toArray" || memberName == "toHex" ||
+                       memberName == "toText"){
+                        setBuiltinMethod();
+                        break;
+                    }
+                    errStream.push(SemanticADiagnostic::create("Unknown Bytes member.",expr_to_eval,Diagnostic::Error));
+                    return nullptr;
+                }
                 if(isDictType(leftType)){
                     if(memberName == "length"){
                         setBuiltinProperty(INT_TYPE);
@@ -3548,9 +3574,53 @@ ASTType * SemanticA::evalExprForTypeId(ASTExpr *expr_to_eval,
                             type = STRING_TYPE;
                             break;
                         }
+                        if(memberName == "toBytes"){
+                            if(!requireArgCount(0)) return nullptr;
+                            type = BYTES_TYPE;
+                            break;
+                        }
                         errStream.push(SemanticADiagnostic::create("Unknown String method.",expr_to_eval,Diagnostic::Error));
                         return nullptr;
                     }
+                    if(isBytesType(baseType)){
+                        if(memberName == "isEmpty"){
+                            if(!requireArgCount(0)) return nullptr;
+                            type = BOOL_TYPE;
+                            break;
+                        }
+                        if(memberName == "at"){
+                            if(!requireArgCount(1) || !requireIntArg(0)) return nullptr;
+                            type = cloneTypeWithQualifiers(INT_TYPE,expr_to_eval,true,false);
+                            break;
+                        }
+                        if(memberName == "slice"){
+                            if(!requireArraySliceArgs()) return nullptr;
+                            type = BYTES_TYPE;
+                            break;
+                        }
+                        if(memberName == "copy"){
+                            if(!requireArgCount(0)) return nullptr;
+                            type = BYTES_TYPE;
+                            break;
+                        }
+                        if(memberName == "toArray"){
+                            if(!requireArgCount(0)) return nullptr;
+                            type = makeArrayType(INT_TYPE,expr_to_eval);
+                            break;
+                        }
+                        if(memberName == "toHex"){
+                            if(!requireArgCount(0)) return nullptr;
+                            type = STRING_TYPE;
+                            break;
+                        }
+                        if(memberName == "toText"){
+                            if(!requireArgCount(0)) return nullptr;
+                            type = cloneTypeWithQualifiers(STRING_TYPE,expr_to_eval,false,true);
+                            break;
+                        }
+                        errStream.push(SemanticADiagnostic::create("Unknown Bytes method.",expr_to_eval,Diagnostic::Error));
+                        return nullptr;
+                    }
                     if(isRegexType(baseType)){
                         if(memberName == "match"){
                             if(!requireArgCount(1) || !requireStringArg(0)) return nullptr;
@@ -3640,6 +3710,11 @@ ASTType * SemanticA::evalExprForTypeId(ASTExpr *expr_to_eval,
                             type = cloneTypeNode(baseType,expr_to_eval);
                             break;
                         }
+                        if(memberName == "toBytes"){
+                            if(!requireArgCount(0)) return nullptr;
+                            type = cloneTypeWithQualifiers(BYTES_TYPE,expr_to_eval,false,true);
+                            break;
+                        }
                         errStream.push(SemanticADiagnostic::create("Unknown Array method.",expr_to_eval,Diagnostic::Error));
                         return nullptr;
                     }
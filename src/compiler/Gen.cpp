@@ -67,7 +67,7 @@ void Gen::finish() const {
         interfaceGen->finish();
     }
     if(genContext && genContext->tableContext && genContext->tableContext->main){
-        std::ofstream out(std::filesystem::path(genContext->outputPath).append(genContext->name).concat(".starbsymtb"));
+        std::ofstream out(std::filesystem::path(genContext->outputPath).append(genContext->name).concat(".starbsymtb"),std::ios::out | std::ios::binary | std::ios::trunc);
         genContext->tableContext->main->serializePublic(out);
         out.close();
     }
@@ -263,6 +263,9 @@ void annotateStmtParentFile(ASTStmt *stmt,const std::string &parentFile){
             }
             return;
         }
+        if(astConsumer.acceptsTokens()){
+            astConsumer.consumeTokens(tokenStream);
+        }
         syntaxA->setTokenStream(tokenStream);
        if(astConsumer.acceptsSymbolTableContext()){
            astConsumer.consumeSTableContext(&moduleParseContext.sTableContext);
@@ -187,6 +187,22 @@ namespace Runtime {
             idOut = RTBUILTIN_MEMBER_DICT_VALUES;
             return true;
         }
+        if(name == "toArray"){
+            idOut = RTBUILTIN_MEMBER_BYTES_TO_ARRAY;
+            return true;
+        }
+        if(name == "toHex"){
+            idOut = RTBUILTIN_MEMBER_BYTES_TO_HEX;
+            return true;
+        }
+        if(name == "toText"){
+            idOut = RTBUILTIN_MEMBER_BYTES_TO_TEXT;
+            return true;
+        }
+        if(name == "toBytes"){
+            idOut = RTBUILTIN_MEMBER_STRING_TO_BYTES;
+            return true;
+        }
         return false;
     }
 
@@ -262,6 +278,14 @@ namespace Runtime {
                 return "keys";
             case RTBUILTIN_MEMBER_DICT_VALUES:
                 return "values";
+            case RTBUILTIN_MEMBER_BYTES_TO_ARRAY:
+                return "toArray";
+            case RTBUILTIN_MEMBER_BYTES_TO_HEX:
+                return "toHex";
+            case RTBUILTIN_MEMBER_BYTES_TO_TEXT:
+                return "toText";
+            case RTBUILTIN_MEMBER_STRING_TO_BYTES:
+                return "toBytes";
             default:
                 return nullptr;
         }
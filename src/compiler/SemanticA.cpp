@@ -3690,7 +3690,8 @@ static ASTType *substituteTypeParams(ASTType *type,
            type->nameMatches(LONG_TYPE) ||
            type->nameMatches(DOUBLE_TYPE) ||
            type->nameMatches(ANY_TYPE) ||
-           type->nameMatches(REGEX_TYPE)){
+           type->nameMatches(REGEX_TYPE) ||
+           type->nameMatches(BYTES_TYPE)){
             return true;
         }
 
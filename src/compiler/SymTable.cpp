@@ -1,24 +1,11 @@
 #include "starbytes/compiler/SymTable.h"
 #include "starbytes/compiler/SemanticA.h"
+#include "starbytes/base/MappedFile.h"
 #include <algorithm>
 #include <cstdlib>
+#include <cstring>
 #include <sstream>
-
-typedef uint8_t SymbolTableCode;
-
-#define TABLE_START 0xA0
-#define IMPORT_SYMTABLE 0x0B
-#define DECLARE_SCOPE 0xC0
-#define TYPE_EXPR 0xD0
-#define DECLARE_TYPE 0xE0
-
-#define VAR_ENTRY 0x01
-#define FUNC_ENTRY 0x02
-#define CLASS_ENTRY 0x03
-#define INTERFACE_ENTRY 0x04
-
-#define TABLE_END 0xFF
-
+#include <unordered_set>
 
 namespace starbytes {
 
@@ -106,125 +93,600 @@ void appendUniqueEntry(std::vector<Semantics::SymbolTable::Entry *> &out,
 
 }
 
-struct SymTableID {
-    std::string id;
+namespace {
+
+constexpr char kSnapshotMagic[8] = {'S','T','B','S','Y','M','T','B'};
+constexpr uint32_t kSnapshotVersion = 1;
+constexpr uint32_t kNoScope = 0xFFFFFFFFu;
+constexpr unsigned kMaxTypeDepth = 64;
+
+enum SnapshotTypeFlag : uint8_t {
+    TypePlaceholder = 1 << 0,
+    TypeAlias = 1 << 1,
+    TypeGenericParam = 1 << 2,
+    TypeOptional = 1 << 3,
+    TypeThrowable = 1 << 4
 };
 
-inline std::ostream &operator<<(std::ostream & out,SymTableID & id){
-    auto size = id.id.size();
-    out.write((char *)&size,sizeof(size));
-    out.write(id.id.data(),id.id.size());
-    return out;
+enum SnapshotMemberFlag : uint8_t {
+    MemberReadonly = 1 << 0,
+    MemberProtected = 1 << 1,
+    MemberDeprecated = 1 << 2,
+    MemberLazy = 1 << 3
 };
 
-inline std::istream & operator>>(std::istream & in,SymTableID & id){
-    std::string::size_type s;
-    in.read((char *)&s,sizeof(s));
-    id.id.resize(s);
-    in.read((char *)id.id.data(),s);
-    return in;
-}
+/// Snapshot encoding: a fixed header, the module's imports, a scope table (parents precede
+/// children, global scope is index 0), then one record per entry in declaration order.
+/// Integers are little endian and every section is read straight out of the mapped bytes.
+class SnapshotWriter {
+    std::ostream &out;
+    std::vector<std::shared_ptr<ASTScope>> scopes;
+    std::unordered_map<const ASTScope *,uint32_t> scopeIndexByPtr;
+public:
+    explicit SnapshotWriter(std::ostream &out):out(out){
+        scopes.push_back(ASTScopeGlobal);
+        scopeIndexByPtr[ASTScopeGlobal.get()] = 0;
+    }
 
-void renderScope(std::shared_ptr<ASTScope> scope,std::ostream & out){
-    SymbolTableCode code = DECLARE_SCOPE;
-    out.write((char *)&code,sizeof(code));
-    SymTableID id {scope->name};
-    out << id;
-    id = {scope->parentScope->name};
-    out << id;
-}
+    void writeU8(uint8_t value){
+        out.put(static_cast<char>(value));
+    }
 
-void importScope(ASTScope **scope,array_ref<std::shared_ptr<ASTScope>> importedModuleScopes,std::istream & in){
-    SymbolTableCode code;
-    in.read((char *)&code,sizeof(code));
-    SymTableID id{};
-    in >> id;
-    *scope = new ASTScope {id.id,ASTScope::Namespace,nullptr};
-    in >> id;
-    if(id.id == ASTScopeGlobal->name){
-        (*scope)->parentScope = ASTScopeGlobal;
-    }
-    else {
-        auto _parent_scope = std::find_if(importedModuleScopes.begin(),importedModuleScopes.end(),[&](std::shared_ptr<ASTScope> object){
-            return object->name == id.id;
-        });
-        (*scope)->parentScope = *_parent_scope;
+    void writeU32(uint32_t value){
+        char bytes[4];
+        for(unsigned i = 0;i < 4;++i){
+            bytes[i] = static_cast<char>((value >> (i * 8)) & 0xFF);
+        }
+        out.write(bytes,sizeof(bytes));
+    }
+
+    void writeString(const std::string &value){
+        writeU32(static_cast<uint32_t>(value.size()));
+        out.write(value.data(),static_cast<std::streamsize>(value.size()));
+    }
+
+    void writeRegion(const Region &region){
+        writeU32(region.startCol);
+        writeU32(region.startLine);
+        writeU32(region.endCol);
+        writeU32(region.endLine);
+    }
+
+    void writeType(ASTType *type){
+        if(!type){
+            writeU8(0);
+            return;
+        }
+        writeU8(1);
+        writeString(type->getName().str());
+        uint8_t flags = 0;
+        flags |= type->isPlaceholder ? TypePlaceholder : 0;
+        flags |= type->isAlias ? TypeAlias : 0;
+        flags |= type->isGenericParam ? TypeGenericParam : 0;
+        flags |= type->isOptional ? TypeOptional : 0;
+        flags |= type->isThrowable ? TypeThrowable : 0;
+        writeU8(flags);
+        writeU32(static_cast<uint32_t>(type->typeParams.size()));
+        for(auto *param : type->typeParams){
+            writeType(param);
+        }
+    }
+
+    void writeGenericParams(const std::vector<Semantics::SymbolTable::GenericParam> &params){
+        writeU32(static_cast<uint32_t>(params.size()));
+        for(const auto &param : params){
+            writeU8(static_cast<uint8_t>(param.variance));
+            writeString(param.name);
+            writeType(param.defaultType);
+            writeU32(static_cast<uint32_t>(param.bounds.size()));
+            for(auto *bound : param.bounds){
+                writeType(bound);
+            }
+        }
     }
-}
 
-void importType(ASTType **type,std::istream & in){
-    SymbolTableCode code;
-    in.read((char *)&code,sizeof(code));
-    SymTableID id{};
-    in >> id;
-    /// Recrete type (Parent node is not nesccary. Only when code needs to be viewed will it show location)
-    *type = ASTType::Create(id.id,nullptr);
+    void writeVar(const Semantics::SymbolTable::Var *var){
+        writeString(var->name);
+        writeType(var->type);
+        uint8_t flags = 0;
+        flags |= var->isReadonly ? MemberReadonly : 0;
+        flags |= var->isProtected ? MemberProtected : 0;
+        flags |= var->isDeprecated ? MemberDeprecated : 0;
+        writeU8(flags);
+        writeString(var->deprecationMessage);
+    }
+
+    void writeFunction(const Semantics::SymbolTable::Function *func){
+        writeString(func->name);
+        writeType(func->funcType);
+        writeType(func->returnType);
+        writeGenericParams(func->genericParams);
+        writeU32(static_cast<uint32_t>(func->orderedParams.size()));
+        for(const auto &param : func->orderedParams){
+            writeString(param.first);
+            writeType(param.second);
+        }
+        uint8_t flags = 0;
+        flags |= func->isLazy ? MemberLazy : 0;
+        flags |= func->isProtected ? MemberProtected : 0;
+        flags |= func->isDeprecated ? MemberDeprecated : 0;
+        writeU8(flags);
+        writeString(func->deprecationMessage);
+    }
+
+    template<typename T>
+    void writeList(const std::vector<T *> &items,void (SnapshotWriter::*writeItem)(const T *)){
+        uint32_t count = 0;
+        for(auto *item : items){
+            count += item ? 1 : 0;
+        }
+        writeU32(count);
+        for(auto *item : items){
+            if(item){
+                (this->*writeItem)(item);
+            }
+        }
+    }
+
+    void writeDeprecation(bool isDeprecated,const std::string &message){
+        writeU8(isDeprecated ? 1 : 0);
+        writeString(message);
+    }
+
+    uint32_t registerScope(const std::shared_ptr<ASTScope> &scope){
+        if(!scope){
+            return kNoScope;
+        }
+        auto found = scopeIndexByPtr.find(scope.get());
+        if(found != scopeIndexByPtr.end()){
+            return found->second;
+        }
+        registerScope(scope->parentScope);
+        auto index = static_cast<uint32_t>(scopes.size());
+        scopes.push_back(scope);
+        scopeIndexByPtr[scope.get()] = index;
+        return index;
+    }
+
+    uint32_t scopeIndex(const std::shared_ptr<ASTScope> &scope) const{
+        if(!scope){
+            return kNoScope;
+        }
+        return scopeIndexByPtr.at(scope.get());
+    }
+
+    void writeScopes(){
+        writeU32(static_cast<uint32_t>(scopes.size() - 1));
+        for(size_t i = 1;i < scopes.size();++i){
+            writeString(scopes[i]->name);
+            writeU8(static_cast<uint8_t>(scopes[i]->type));
+            writeU32(scopeIndex(scopes[i]->parentScope));
+        }
+    }
 };
-void exportType(ASTType *type,std::ostream & out){
-    SymbolTableCode c = DECLARE_TYPE;
-    out.write((char *)&c,sizeof(c));
-    SymTableID id {type->getName().str()};
-    out << id;
+
+class SnapshotReader {
+    const char *data;
+    size_t size;
+    size_t offset = 0;
+    bool valid = true;
+    Semantics::SymbolTable &table;
+    std::vector<std::shared_ptr<ASTScope>> scopes;
+public:
+    SnapshotReader(const char *data,size_t size,Semantics::SymbolTable &table):data(data),size(size),table(table){
+        scopes.push_back(ASTScopeGlobal);
+    }
+
+    bool ok() const { return valid; }
+    bool atEnd() const { return offset == size; }
+
+    bool expect(size_t count){
+        if(!valid || size - offset < count){
+            valid = false;
+            return false;
+        }
+        return true;
+    }
+
+    uint8_t readU8(){
+        if(!expect(1)){
+            return 0;
+        }
+        return static_cast<uint8_t>(data[offset++]);
+    }
+
+    uint32_t readU32(){
+        if(!expect(4)){
+            return 0;
+        }
+        uint32_t value = 0;
+        for(unsigned i = 0;i < 4;++i){
+            value |= static_cast<uint32_t>(static_cast<uint8_t>(data[offset + i])) << (i * 8);
+        }
+        offset += 4;
+        return value;
+    }
+
+    /// Reads an element count; every element occupies at least one byte, which bounds bogus counts.
+    uint32_t readCount(){
+        auto count = readU32();
+        if(valid && count > size - offset){
+            valid = false;
+            return 0;
+        }
+        return count;
+    }
+
+    std::string readString(){
+        auto length = readU32();
+        if(!expect(length)){
+            return {};
+        }
+        std::string value(data + offset,length);
+        offset += length;
+        return value;
+    }
+
+    bool readMagic(){
+        if(!expect(sizeof(kSnapshotMagic)) || std::memcmp(data,kSnapshotMagic,sizeof(kSnapshotMagic)) != 0){
+            valid = false;
+            return false;
+        }
+        offset += sizeof(kSnapshotMagic);
+        return true;
+    }
+
+    Region readRegion(){
+        Region region;
+        region.startCol = readU32();
+        region.startLine = readU32();
+        region.endCol = readU32();
+        region.endLine = readU32();
+        return region;
+    }
+
+    ASTType *readType(unsigned depth = 0){
+        if(readU8() == 0 || !valid){
+            return nullptr;
+        }
+        if(depth > kMaxTypeDepth){
+            valid = false;
+            return nullptr;
+        }
+        auto name = readString();
+        auto flags = readU8();
+        auto paramCount = readCount();
+        if(!valid){
+            return nullptr;
+        }
+        if(flags == 0 && paramCount == 0){
+            if(auto *builtin = builtinTypeNamed(name)){
+                return builtin;
+            }
+        }
+        auto *type = ASTType::Create(name,nullptr,(flags & TypePlaceholder) != 0,(flags & TypeAlias) != 0);
+        type->isGenericParam = (flags & TypeGenericParam) != 0;
+        type->isOptional = (flags & TypeOptional) != 0;
+        type->isThrowable = (flags & TypeThrowable) != 0;
+        for(uint32_t i = 0;i < paramCount && valid;++i){
+            type->addTypeParam(readType(depth + 1));
+        }
+        return type;
+    }
+
+    /// Bare builtin types are shared singletons that semantic analysis compares by address.
+    static ASTType *builtinTypeNamed(const std::string &name){
+        for(auto *builtin : {VOID_TYPE,STRING_TYPE,ARRAY_TYPE,DICTIONARY_TYPE,MAP_TYPE,BOOL_TYPE,INT_TYPE,
+                             FLOAT_TYPE,LONG_TYPE,DOUBLE_TYPE,REGEX_TYPE,BYTES_TYPE,ANY_TYPE,TASK_TYPE,FUNCTION_TYPE}){
+            if(builtin->getName() == name){
+                return builtin;
+            }
+        }
+        return nullptr;
+    }
+
+    void readGenericParams(std::vector<Semantics::SymbolTable::GenericParam> &params){
+        auto count = readCount();
+        for(uint32_t i = 0;i < count && valid;++i){
+            Semantics::SymbolTable::GenericParam param;
+            auto variance = readU8();
+            if(variance > Semantics::SymbolTable::GenericParam::Out){
+                valid = false;
+                return;
+            }
+            param.variance = static_cast<Semantics::SymbolTable::GenericParam::Variance>(variance);
+            param.name = readString();
+            param.defaultType = readType();
+            auto boundCount = readCount();
+            for(uint32_t b = 0;b < boundCount && valid;++b){
+                param.bounds.push_back(readType());
+            }
+            params.push_back(std::move(param));
+        }
+    }
+
+    Semantics::SymbolTable::Var *readVar(){
+        auto *var = table.allocate<Semantics::SymbolTable::Var>();
+        var->name = readString();
+        var->type = readType();
+        auto flags = readU8();
+        var->isReadonly = (flags & MemberReadonly) != 0;
+        var->isProtected = (flags & MemberProtected) != 0;
+        var->isDeprecated = (flags & MemberDeprecated) != 0;
+        var->deprecationMessage = readString();
+        return var;
+    }
+
+    Semantics::SymbolTable::Function *readFunction(){
+        auto *func = table.allocate<Semantics::SymbolTable::Function>();
+        func->name = readString();
+        func->funcType = readType();
+        func->returnType = readType();
+        readGenericParams(func->genericParams);
+        auto paramCount = readCount();
+        for(uint32_t i = 0;i < paramCount && valid;++i){
+            auto name = readString();
+            auto *type = readType();
+            func->paramMap.insert(std::make_pair(name,type));
+            func->orderedParams.push_back(std::make_pair(std::move(name),type));
+        }
+        auto flags = readU8();
+        func->isLazy = (flags & MemberLazy) != 0;
+        func->isProtected = (flags & MemberProtected) != 0;
+        func->isDeprecated = (flags & MemberDeprecated) != 0;
+        func->deprecationMessage = readString();
+        return func;
+    }
+
+    template<typename T>
+    void readList(std::vector<T *> &items,T *(SnapshotReader::*readItem)()){
+        auto count = readCount();
+        for(uint32_t i = 0;i < count && valid;++i){
+            items.push_back((this->*readItem)());
+        }
+    }
+
+    template<typename T>
+    void readDeprecation(T *data){
+        data->isDeprecated = readU8() != 0;
+        data->deprecationMessage = readString();
+    }
+
+    bool readScopes(){
+        auto count = readCount();
+        for(uint32_t i = 0;i < count && valid;++i){
+            auto name = readString();
+            auto type = readU8();
+            auto parentIndex = readU32();
+            if(type > ASTScope::Class || (parentIndex != kNoScope && parentIndex >= scopes.size())){
+                valid = false;
+                break;
+            }
+            auto parent = parentIndex == kNoScope ? nullptr : scopes[parentIndex];
+            scopes.push_back(std::shared_ptr<ASTScope>(new ASTScope{name,static_cast<ASTScope::ScopeType>(type),parent}));
+        }
+        return valid;
+    }
+
+    bool scopeAt(uint32_t index,std::shared_ptr<ASTScope> &scope){
+        if(index == kNoScope){
+            scope = nullptr;
+            return true;
+        }
+        if(index >= scopes.size()){
+            valid = false;
+            return false;
+        }
+        scope = scopes[index];
+        return true;
+    }
 };
 
+/// Locals and parameters live under function scopes and never leave their module.
+bool isFunctionLocalScope(const std::shared_ptr<ASTScope> &scope){
+    for(auto current = scope;current;current = current->parentScope){
+        if(current->type == ASTScope::Function){
+            return true;
+        }
+    }
+    return false;
+}
+
+std::vector<Semantics::SymbolTable::Entry *> publicEntriesInDeclarationOrder(
+    const std::map<Semantics::SymbolTable::Entry *,std::shared_ptr<ASTScope>> &body,
+    const std::vector<std::pair<void *,void (*)(void *)>> &ownedAllocations){
+    std::vector<Semantics::SymbolTable::Entry *> ordered;
+    ordered.reserve(body.size());
+    std::unordered_set<const Semantics::SymbolTable::Entry *> seen;
+    for(const auto &allocation : ownedAllocations){
+        auto *candidate = static_cast<Semantics::SymbolTable::Entry *>(allocation.first);
+        auto found = body.find(candidate);
+        if(found != body.end() && seen.insert(candidate).second && !isFunctionLocalScope(found->second)){
+            ordered.push_back(candidate);
+        }
+    }
+    for(const auto &pair : body){
+        if(seen.insert(pair.first).second && !isFunctionLocalScope(pair.second)){
+            ordered.push_back(pair.first);
+        }
+    }
+    return ordered;
+}
+
+}
 
 std::shared_ptr<Semantics::SymbolTable> Semantics::SymbolTable::importPublic(std::istream & input){
-    (void)input;
-    return std::make_shared<Semantics::SymbolTable>();
+    std::ostringstream buffer;
+    buffer << input.rdbuf();
+    auto bytes = buffer.str();
+    return importPublic(bytes.data(),bytes.size());
+}
+
+std::shared_ptr<Semantics::SymbolTable> Semantics::SymbolTable::importPublic(const char *data,size_t size){
+    auto table = std::make_shared<Semantics::SymbolTable>();
+    SnapshotReader reader(data,size,*table);
+    if(!reader.readMagic() || reader.readU32() != kSnapshotVersion){
+        return nullptr;
+    }
+    auto entryCount = reader.readCount();
+    auto depCount = reader.readCount();
+    for(uint32_t i = 0;i < depCount && reader.ok();++i){
+        table->importModule(reader.readString());
+    }
+    if(!reader.readScopes()){
+        return nullptr;
+    }
+
+    for(uint32_t i = 0;i < entryCount && reader.ok();++i){
+        auto kind = reader.readU8();
+        std::shared_ptr<ASTScope> scope;
+        if(!reader.scopeAt(reader.readU32(),scope) || kind > Entry::TypeAlias){
+            return nullptr;
+        }
+        auto *entry = table->allocate<Entry>();
+        entry->type = static_cast<Entry::Ty>(kind);
+        entry->name = reader.readString();
+        entry->emittedName = reader.readString();
+        entry->interfacePos = reader.readRegion();
+        entry->sourcePos = reader.readRegion();
+        switch(entry->type){
+            case Entry::Var:
+                entry->data = reader.readVar();
+                break;
+            case Entry::Function:
+                entry->data = reader.readFunction();
+                break;
+            case Entry::Class: {
+                auto *data = table->allocate<Class>();
+                data->classType = reader.readType();
+                data->superClassType = reader.readType();
+                reader.readGenericParams(data->genericParams);
+                auto interfaceCount = reader.readCount();
+                for(uint32_t n = 0;n < interfaceCount && reader.ok();++n){
+                    data->interfaces.push_back(reader.readType());
+                }
+                reader.readList(data->instMethods,&SnapshotReader::readFunction);
+                reader.readList(data->constructors,&SnapshotReader::readFunction);
+                reader.readList(data->fields,&SnapshotReader::readVar);
+                reader.readDeprecation(data);
+                entry->data = data;
+                break;
+            }
+            case Entry::Interface: {
+                auto *data = table->allocate<Interface>();
+                data->interfaceType = reader.readType();
+                reader.readGenericParams(data->genericParams);
+                reader.readList(data->methods,&SnapshotReader::readFunction);
+                reader.readList(data->fields,&SnapshotReader::readVar);
+                reader.readDeprecation(data);
+                entry->data = data;
+                break;
+            }
+            case Entry::TypeAlias: {
+                auto *data = table->allocate<TypeAlias>();
+                data->aliasType = reader.readType();
+                reader.readGenericParams(data->genericParams);
+                reader.readDeprecation(data);
+                entry->data = data;
+                break;
+            }
+            case Entry::Scope: {
+                std::shared_ptr<ASTScope> target;
+                if(!reader.scopeAt(reader.readU32(),target) || !target){
+                    return nullptr;
+                }
+                entry->data = table->allocate<std::shared_ptr<ASTScope>>(target);
+                break;
+            }
+        }
+        if(!reader.ok()){
+            return nullptr;
+        }
+        table->addSymbolInScope(entry,scope);
+    }
+    if(!reader.ok() || !reader.atEnd()){
+        return nullptr;
+    }
+    return table;
+}
+
+std::shared_ptr<Semantics::SymbolTable> Semantics::SymbolTable::importPublicFile(const std::filesystem::path &path){
+    MappedFile mapped;
+    if(!mapped.open(path)){
+        return nullptr;
+    }
+    return importPublic(mapped.data(),mapped.size());
 }
 
 void Semantics::SymbolTable::serializePublic(std::ostream & out){
-    /// First Serialize Dependencies.
-    ///
-    std::vector<std::shared_ptr<ASTScope>> exportedModuleScopes;
-    
-    auto exportScopeIfNeeded = [&](std::shared_ptr<ASTScope> & subject){
-        if(!subject || subject == ASTScopeGlobal){
-            return;
+    auto entries = publicEntriesInDeclarationOrder(body,ownedAllocations);
+    SnapshotWriter writer(out);
+    for(auto *entry : entries){
+        writer.registerScope(body[entry]);
+        if(entry->type == Entry::Scope && entry->data){
+            writer.registerScope(*((std::shared_ptr<ASTScope> *)entry->data));
         }
-        auto scopeExported = std::find_if(exportedModuleScopes.begin(),exportedModuleScopes.end(),[&](std::shared_ptr<ASTScope> scope){
-            return subject == scope;
-        });
-        /// If scope has not been exported yet.
-        if(scopeExported == exportedModuleScopes.end()){
-            renderScope(subject,out);
-            exportedModuleScopes.push_back(subject);
-        }
-    };
-    
-    auto depCount = deps.size();
-    out.write((char *)&depCount,sizeof(depCount));
-    for(auto & d : deps){
-        SymTableID id {d};
-        out << id;
-    }
-    /// Then Serialize Scopes and All Public Symbols.
-    SymbolTableCode c = TABLE_START;
-    out.write((char *)&c,sizeof(c));
-    for(auto & sym : body){
-        auto _scope = sym.second->parentScope;
-        for(;_scope != nullptr && _scope != ASTScopeGlobal;_scope = _scope->parentScope){
-            exportScopeIfNeeded(_scope);
-        }
-        exportScopeIfNeeded(sym.second);
-        
-        if(sym.first->type == Entry::Class){
-            c = CLASS_ENTRY;
-            out.write((char *)&c,sizeof(c));
-            auto cl = ((Class *)sym.first->data);
-            exportType(cl->classType,out);
-            auto method_n = cl->instMethods.size();
-        }
-        else if(sym.first->type == Entry::Function){
-            c = FUNC_ENTRY;
-            out.write((char *)&c,sizeof(c));
-            auto fn = ((Function *)sym.first->data);
-            
-        }
-        
-    }
-    c = TABLE_END;
-    out.write((char *)&c,sizeof(c));
+    }
+
+    out.write(kSnapshotMagic,sizeof(kSnapshotMagic));
+    writer.writeU32(kSnapshotVersion);
+    writer.writeU32(static_cast<uint32_t>(entries.size()));
+    writer.writeU32(static_cast<uint32_t>(deps.size()));
+    for(const auto &dep : deps){
+        writer.writeString(dep);
+    }
+    writer.writeScopes();
+
+    for(auto *entry : entries){
+        writer.writeU8(static_cast<uint8_t>(entry->type));
+        writer.writeU32(writer.scopeIndex(body[entry]));
+        writer.writeString(entry->name);
+        writer.writeString(entry->emittedName);
+        writer.writeRegion(entry->interfacePos);
+        writer.writeRegion(entry->sourcePos);
+        switch(entry->type){
+            case Entry::Var:
+                writer.writeVar((Var *)entry->data);
+                break;
+            case Entry::Function:
+                writer.writeFunction((Function *)entry->data);
+                break;
+            case Entry::Class: {
+                auto *data = (Class *)entry->data;
+                writer.writeType(data->classType);
+                writer.writeType(data->superClassType);
+                writer.writeGenericParams(data->genericParams);
+                writer.writeU32(static_cast<uint32_t>(data->interfaces.size()));
+                for(auto *iface : data->interfaces){
+                    writer.writeType(iface);
+                }
+                writer.writeList(data->instMethods,&SnapshotWriter::writeFunction);
+                writer.writeList(data->constructors,&SnapshotWriter::writeFunction);
+                writer.writeList(data->fields,&SnapshotWriter::writeVar);
+                writer.writeDeprecation(data->isDeprecated,data->deprecationMessage);
+                break;
+            }
+            case Entry::Interface: {
+                auto *data = (Interface *)entry->data;
+                writer.writeType(data->interfaceType);
+                writer.writeGenericParams(data->genericParams);
+                writer.writeList(data->methods,&SnapshotWriter::writeFunction);
+                writer.writeList(data->fields,&SnapshotWriter::writeVar);
+                writer.writeDeprecation(data->isDeprecated,data->deprecationMessage);
+                break;
+            }
+            case Entry::TypeAlias: {
+                auto *data = (TypeAlias *)entry->data;
+                writer.writeType(data->aliasType);
+                writer.writeGenericParams(data->genericParams);
+                writer.writeDeprecation(data->isDeprecated,data->deprecationMessage);
+                break;
+            }
+            case Entry::Scope:
+                writer.writeU32(writer.scopeIndex(*((std::shared_ptr<ASTScope> *)entry->data)));
+                break;
+        }
+    }
 }
 
 std::shared_ptr<Semantics::SymbolTable> Semantics::SymbolTable::createImportNamespaceOverlay(string_ref moduleName) const{
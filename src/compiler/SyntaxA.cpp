@@ -233,6 +233,10 @@ const string_set *SyntaxA::currentGenericTypeParams(){
                 baseType = REGEX_TYPE;
                 isBuiltinType = true;
             }
+            else if(tok_id == "Bytes"){
+                baseType = BYTES_TYPE;
+                isBuiltinType = true;
+            }
             else if(tok_id == "Any"){
                 baseType = ANY_TYPE;
                 isBuiltinType = true;
@@ -42,6 +42,7 @@ namespace starbytes {
     ASTType * LONG_TYPE = ASTType::Create("Long",nullptr,false);
     ASTType * DOUBLE_TYPE = ASTType::Create("Double",nullptr,false);
     ASTType * REGEX_TYPE = ASTType::Create("Regex",nullptr,false);
+    ASTType * BYTES_TYPE = ASTType::Create("Bytes",nullptr,false);
     ASTType * ANY_TYPE = ASTType::Create("Any",nullptr,false);
     ASTType * TASK_TYPE = ASTType::Create("Task",nullptr,false);
     ASTType * FUNCTION_TYPE = ASTType::Create("__func__",nullptr,false);
@@ -91,6 +92,14 @@ namespace starbytes {
         if(name == DICTIONARY_TYPE->getName() && other->name == MAP_TYPE->getName()){
             return true;
         }
+        /// Int array literals are still accepted where Bytes is expected; natives copy them into a buffer.
+        if(name == BYTES_TYPE->getName() && other->name == ARRAY_TYPE->getName()
+           && (other->typeParams.empty()
+               || (other->typeParams.size() == 1 && other->typeParams[0]
+                   && other->typeParams[0]->getName() == INT_TYPE->getName()))
+           && (isOptional || !other->isOptional) && (isThrowable || !other->isThrowable)){
+            return true;
+        }
         if(!first_m){
             log(fmtString("Type `{0}` does not match type `{1}`",*this,*other));
             return false;
@@ -23,9 +23,20 @@ public:
         (void)table;
     }
 
+    bool acceptsTokens() override {
+        return tokens != nullptr;
+    }
+
+    void consumeTokens(const std::vector<Syntax::Tok> &tokenStream) override {
+        *tokens = tokenStream;
+        tokensConsumed = true;
+    }
+
     void consumeRawStmt(ASTStmt *stmt,bool semanticAccepted) override {
-        (void)semanticAccepted;
         statements.push_back(stmt);
+        if(semanticAccepted) {
+            acceptedStatements.push_back(stmt);
+        }
     }
 
     void consumeStmt(ASTStmt *stmt) override {
@@ -40,32 +51,22 @@ public:
         return statements;
     }
 
+    std::vector<Syntax::Tok> *tokens = nullptr;
+    bool tokensConsumed = false;
+    std::vector<ASTStmt *> acceptedStatements;
+
 private:
     std::vector<ASTStmt *> statements;
 };
 
-} // namespace
-
-CompilerLintAnalysis OwnedCompilerLintAnalysis::view() const {
-    CompilerLintAnalysis analysis;
-    analysis.session = &session;
-    analysis.statements = &statements;
-    analysis.symbolTableContext = moduleContext ? &moduleContext->sTableContext : nullptr;
-    analysis.syntaxDiagnostics = &syntaxDiagnostics;
-    analysis.semanticDiagnostics = &semanticDiagnostics;
-    analysis.syntaxHadError = syntaxHadError;
-    analysis.semanticHadError = semanticHadError;
-    return analysis;
-}
-
-OwnedCompilerLintAnalysis buildCompilerLintAnalysis(const LinguisticsSession &session,
-                                                   const CompilerLintAnalysisRequest &request) {
-    OwnedCompilerLintAnalysis analysis;
+bool runCompilerAnalysis(const LinguisticsSession &session,
+                         const CompilerLintAnalysisRequest &request,
+                         CollectingASTConsumer &consumer,
+                         OwnedCompilerLintAnalysis &analysis) {
     analysis.session = session;
     analysis.moduleContext = std::make_unique<ModuleParseContext>(
         ModuleParseContext::Create(session.getSourceName()));
 
-    CollectingASTConsumer consumer;
     std::ostringstream diagnosticsSink;
     auto diagnostics = DiagnosticHandler::createDefault(diagnosticsSink);
     diagnostics->setOutputMode(DiagnosticHandler::OutputMode::MachineJson);
@@ -77,6 +78,7 @@ OwnedCompilerLintAnalysis buildCompilerLintAnalysis(const LinguisticsSession &se
     parser.parseFromStream(in, *analysis.moduleContext);
     analysis.statements = consumer.getStatements();
 
+    bool hadError = parser.getDiagnosticHandler()->hasErrored();
     auto records = parser.getDiagnosticHandler()->collectRecords(false);
     for(const auto &record : records) {
         if(record.phase == Diagnostic::Phase::Parser) {
@@ -92,8 +94,42 @@ OwnedCompilerLintAnalysis buildCompilerLintAnalysis(const LinguisticsSession &se
             analysis.semanticDiagnostics.push_back(record);
         }
     }
+    return hadError;
+}
+
+} // namespace
 
+CompilerLintAnalysis OwnedCompilerLintAnalysis::view() const {
+    CompilerLintAnalysis analysis;
+    analysis.session = &session;
+    analysis.statements = &statements;
+    analysis.symbolTableContext = moduleContext ? &moduleContext->sTableContext : nullptr;
+    analysis.syntaxDiagnostics = &syntaxDiagnostics;
+    analysis.semanticDiagnostics = &semanticDiagnostics;
+    analysis.syntaxHadError = syntaxHadError;
+    analysis.semanticHadError = semanticHadError;
     return analysis;
 }
 
+OwnedCompilerLintAnalysis buildCompilerLintAnalysis(const LinguisticsSession &session,
+                                                   const CompilerLintAnalysisRequest &request) {
+    OwnedCompilerLintAnalysis analysis;
+    CollectingASTConsumer consumer;
+    runCompilerAnalysis(session, request, consumer, analysis);
+    return analysis;
+}
+
+SharedLinguisticsArtifact buildLinguisticsArtifact(const LinguisticsSession &session,
+                                                   const CompilerLintAnalysisRequest &request) {
+    auto artifact = std::make_shared<LinguisticsArtifact>();
+    CollectingASTConsumer consumer;
+    consumer.tokens = &artifact->tokens;
+    artifact->hadError = runCompilerAnalysis(session, request, consumer, artifact->compiler);
+    artifact->lexerHadError = !consumer.tokensConsumed;
+    artifact->acceptedStatements = std::move(consumer.acceptedStatements);
+    const auto &text = session.getSourceText();
+    artifact->containsCommentMarkers = text.find("//") != std::string::npos || text.find("/*") != std::string::npos;
+    return artifact;
+}
+
 } // namespace starbytes::linguistics
@@ -2,8 +2,39 @@
 
 namespace starbytes::linguistics {
 
+namespace {
+
+void appendRuleList(std::string &out, const char *key, const std::vector<std::string> &rules) {
+    out += key;
+    out += '=';
+    for(const auto &rule : rules) {
+        out += std::to_string(rule.size());
+        out += ':';
+        out += rule;
+    }
+    out += ';';
+}
+
+} // namespace
+
 LinguisticsConfig LinguisticsConfig::defaults() {
     return LinguisticsConfig{};
 }
 
+std::string LinguisticsConfig::fingerprint() const {
+    std::string out;
+    out += "formatting.maxLineWidth=" + std::to_string(formatting.maxLineWidth) + ";";
+    out += "formatting.trimTrailingWhitespace=" + std::to_string(formatting.trimTrailingWhitespace ? 1 : 0) + ";";
+    out += "formatting.ensureTrailingNewline=" + std::to_string(formatting.ensureTrailingNewline ? 1 : 0) + ";";
+    out += "lint.enabled=" + std::to_string(lint.enabled ? 1 : 0) + ";";
+    out += "lint.strict=" + std::to_string(lint.strict ? 1 : 0) + ";";
+    out += "lint.maxFindings=" + std::to_string(lint.maxFindings) + ";";
+    appendRuleList(out, "lint.enabledRules", lint.enabledRules);
+    appendRuleList(out, "lint.disabledRules", lint.disabledRules);
+    out += "suggestions.enabled=" + std::to_string(suggestions.enabled ? 1 : 0) + ";";
+    out += "suggestions.maxSuggestions=" + std::to_string(suggestions.maxSuggestions) + ";";
+    out += "actions.preferSafeActions=" + std::to_string(actions.preferSafeActions ? 1 : 0) + ";";
+    return out;
+}
+
 } // namespace starbytes::linguistics
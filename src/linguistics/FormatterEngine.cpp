@@ -49,26 +49,6 @@ private:
     std::vector<ASTStmt *> statements;
 };
 
-bool containsCommentMarkers(const std::string &source) {
-    return source.find("//") != std::string::npos || source.find("/*") != std::string::npos;
-}
-
-bool tokenizeSource(const std::string &source,
-                    std::vector<Syntax::Tok> &tokens,
-                    std::string &error) {
-    std::ostringstream diagStream;
-    auto diagnostics = DiagnosticHandler::createDefault(diagStream);
-    diagnostics->setOutputMode(DiagnosticHandler::OutputMode::MachineJson);
-    Syntax::Lexer lexer(*diagnostics);
-    std::istringstream in(source);
-    lexer.tokenizeFromIStream(in, tokens);
-    if(diagnostics->hasErrored()) {
-        error = "Lexer reported errors while probing formatter compatibility.";
-        return false;
-    }
-    return true;
-}
-
 bool containsUnsupportedRoundTripTokens(const std::vector<Syntax::Tok> &tokens,
                                         std::string &reason) {
     for(const auto &tok : tokens) {
@@ -1174,33 +1154,24 @@ bool parseToAst(const std::string &sourceName,
     return true;
 }
 
-bool formatCompilerBackedSource(const std::string &sourceName,
-                                const std::string &source,
-                                std::string &formatted,
-                                std::string &reason) {
+struct ReformatPass {
+    bool parsed = false;
+    bool formatted = false;
+    std::string text;
+};
+
+/// Parses formatter output once and formats it again, which serves both parse validation and idempotence checks.
+ReformatPass reformatText(const std::string &sourceName, const std::string &source) {
+    ReformatPass pass;
     std::vector<ASTStmt *> statements;
+    std::string reason;
     if(!parseToAst(sourceName, source, statements, reason)) {
-        reason = "Formatter fallback: source did not pass parser validation for compiler-backed formatting.";
-        return false;
+        return pass;
     }
-
+    pass.parsed = true;
     AstFormatter formatter(source);
-    if(!formatter.format(statements, formatted, reason)) {
-        return false;
-    }
-    return true;
-}
-
-bool parseValidationPasses(const std::string &sourceName,
-                           const std::string &formatted,
-                           std::string &reason) {
-    std::vector<ASTStmt *> statements;
-    std::string parseError;
-    if(!parseToAst(sourceName, formatted, statements, parseError)) {
-        reason = "Formatter fallback: parse-after-format validation failed.";
-        return false;
-    }
-    return true;
+    pass.formatted = formatter.format(statements, pass.text, reason);
+    return pass;
 }
 
 FormatResult makePreviewFallback(const std::string &source,
@@ -1262,28 +1233,35 @@ std::string FormatterEngine::normalizePreview(const std::string &source,
     return normalized;
 }
 
-FormatResult FormatterEngine::format(const LinguisticsSession &session,
-                                     const LinguisticsConfig &config,
-                                     const FormatRequest &request) const {
+namespace {
+
+FormatResult formatSource(const LinguisticsSession &session,
+                          const LinguisticsArtifact *artifact,
+                          const LinguisticsConfig &config,
+                          const FormatRequest &request) {
     const auto &source = session.getSourceText();
     if(request.previewMode) {
         FormatResult result;
         result.ok = true;
-        result.formattedText = normalizePreview(source, config.formatting);
+        result.formattedText = FormatterEngine::normalizePreview(source, config.formatting);
         result.notes.push_back("Formatter preview mode active.");
         return result;
     }
 
-    if(containsCommentMarkers(source)) {
+    if(source.find("//") != std::string::npos || source.find("/*") != std::string::npos) {
         return makePreviewFallback(source,
                                    config.formatting,
                                    "Formatter fallback: comment-aware round-trip formatting is deferred to phase 4.",
                                    request.allowFallbackToPreview);
     }
 
-    std::vector<Syntax::Tok> tokens;
-    std::string tokenError;
-    if(!tokenizeSource(source, tokens, tokenError)) {
+    SharedLinguisticsArtifact ownedArtifact;
+    if(!artifact) {
+        ownedArtifact = buildLinguisticsArtifact(session);
+        artifact = ownedArtifact.get();
+    }
+
+    if(artifact->lexerHadError) {
         return makePreviewFallback(source,
                                    config.formatting,
                                    "Formatter fallback: tokenization failed during compatibility probing.",
@@ -1291,7 +1269,7 @@ FormatResult FormatterEngine::format(const LinguisticsSession &session,
     }
 
     std::string unsupportedReason;
-    if(containsUnsupportedRoundTripTokens(tokens, unsupportedReason)) {
+    if(containsUnsupportedRoundTripTokens(artifact->tokens, unsupportedReason)) {
         return makePreviewFallback(source,
                                    config.formatting,
                                    unsupportedReason,
@@ -1300,7 +1278,15 @@ FormatResult FormatterEngine::format(const LinguisticsSession &session,
 
     std::string firstPass;
     std::string formatReason;
-    if(!formatCompilerBackedSource(session.getSourceName(), source, firstPass, formatReason)) {
+    bool formatted = false;
+    if(artifact->hadError) {
+        formatReason = "Formatter fallback: source did not pass parser validation for compiler-backed formatting.";
+    }
+    else {
+        AstFormatter formatter(source);
+        formatted = formatter.format(artifact->acceptedStatements, firstPass, formatReason);
+    }
+    if(!formatted) {
         if(formatReason.empty()) {
             formatReason = "Formatter fallback: compiler-backed formatting failed.";
         }
@@ -1310,18 +1296,32 @@ FormatResult FormatterEngine::format(const LinguisticsSession &session,
                                    request.allowFallbackToPreview);
     }
 
+    // Already-formatted text was parsed cleanly by the artifact and re-formats to itself, so the
+    // validation and idempotence passes below would only repeat that work.
+    bool alreadyFormatted = firstPass == source;
     if(config.formatting.ensureTrailingNewline && !firstPass.empty() && firstPass.back() != '\n') {
         firstPass.push_back('\n');
+        alreadyFormatted = false;
     }
 
-    if(request.requireParseValidation) {
-        std::string validationReason;
-        if(!parseValidationPasses(session.getSourceName(), firstPass, validationReason)) {
-            return makePreviewFallback(source,
-                                       config.formatting,
-                                       validationReason,
-                                       request.allowFallbackToPreview);
-        }
+    if(alreadyFormatted) {
+        FormatResult result;
+        result.ok = true;
+        result.formattedText = std::move(firstPass);
+        result.notes.push_back("Compiler-backed formatter applied.");
+        return result;
+    }
+
+    const std::string parseValidationReason = "Formatter fallback: parse-after-format validation failed.";
+    ReformatPass secondPass;
+    if(request.requireParseValidation || request.requireIdempotence) {
+        secondPass = reformatText(session.getSourceName(), firstPass);
+    }
+    if(request.requireParseValidation && !secondPass.parsed) {
+        return makePreviewFallback(source,
+                                   config.formatting,
+                                   parseValidationReason,
+                                   request.allowFallbackToPreview);
     }
 
     std::string stable = firstPass;
@@ -1329,33 +1329,25 @@ FormatResult FormatterEngine::format(const LinguisticsSession &session,
     result.ok = true;
 
     if(request.requireIdempotence) {
-        std::string secondPass;
-        std::string secondReason;
-        if(!formatCompilerBackedSource(session.getSourceName(), stable, secondPass, secondReason)) {
+        if(!secondPass.formatted) {
             return makePreviewFallback(source,
                                        config.formatting,
                                        "Formatter fallback: idempotence verification failed.",
                                        request.allowFallbackToPreview);
         }
 
-        if(secondPass != stable) {
-            stable = secondPass;
-            result.notes.push_back("Formatter idempotence normalization applied (second pass)."
-            );
+        if(secondPass.text != stable) {
+            stable = secondPass.text;
+            result.notes.push_back("Formatter idempotence normalization applied (second pass).");
 
-            if(request.requireParseValidation) {
-                std::string validationReason;
-                if(!parseValidationPasses(session.getSourceName(), stable, validationReason)) {
-                    return makePreviewFallback(source,
-                                               config.formatting,
-                                               validationReason,
-                                               request.allowFallbackToPreview);
-                }
+            auto thirdPass = reformatText(session.getSourceName(), stable);
+            if(request.requireParseValidation && !thirdPass.parsed) {
+                return makePreviewFallback(source,
+                                           config.formatting,
+                                           parseValidationReason,
+                                           request.allowFallbackToPreview);
             }
-
-            std::string thirdPass;
-            std::string thirdReason;
-            if(!formatCompilerBackedSource(session.getSourceName(), stable, thirdPass, thirdReason) || thirdPass != stable) {
+            if(!thirdPass.formatted || thirdPass.text != stable) {
                 return makePreviewFallback(source,
                                            config.formatting,
                                            "Formatter fallback: output failed stability check.",
@@ -1371,4 +1363,18 @@ FormatResult FormatterEngine::format(const LinguisticsSession &session,
     return result;
 }
 
+} // namespace
+
+FormatResult FormatterEngine::format(const LinguisticsSession &session,
+                                     const LinguisticsConfig &config,
+                                     const FormatRequest &request) const {
+    return formatSource(session, nullptr, config, request);
+}
+
+FormatResult FormatterEngine::format(const LinguisticsArtifact &artifact,
+                                     const LinguisticsConfig &config,
+                                     const FormatRequest &request) const {
+    return formatSource(artifact.session(), &artifact, config, request);
+}
+
 } // namespace starbytes::linguistics
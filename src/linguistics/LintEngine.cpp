@@ -5,9 +5,13 @@
 
 #include <algorithm>
 #include <cctype>
+#include <chrono>
 #include <cstddef>
+#include <cstdint>
 #include <optional>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -15,9 +19,10 @@ namespace starbytes::linguistics {
 
 namespace {
 
+/// One entry of the line table shared by all rules; `text` views the session's source.
 struct SourceLine {
     unsigned line = 1;
-    std::string text;
+    std::string_view text;
 };
 
 std::vector<SourceLine> splitLines(const std::string &source) {
@@ -27,15 +32,16 @@ std::vector<SourceLine> splitLines(const std::string &source) {
         return lines;
     }
 
+    std::string_view view(source);
     size_t start = 0;
     unsigned lineNo = 1;
-    while(start < source.size()) {
-        size_t end = source.find('\n', start);
-        if(end == std::string::npos) {
-            lines.push_back({lineNo, source.substr(start)});
+    while(start < view.size()) {
+        size_t end = view.find('\n', start);
+        if(end == std::string_view::npos) {
+            lines.push_back({lineNo, view.substr(start)});
             break;
         }
-        lines.push_back({lineNo, source.substr(start, end - start)});
+        lines.push_back({lineNo, view.substr(start, end - start)});
         start = end + 1;
         ++lineNo;
     }
@@ -134,65 +140,6 @@ std::string categoryName(LintCategory category) {
     return "style";
 }
 
-std::vector<LintRuleDescriptor> allRuleDescriptors() {
-    return {
-        {
-            "style.trailing_whitespace",
-            "SB-LINT-STYLE-S0001",
-            LintCategory::Style,
-            FindingSeverity::Warning,
-            true,
-            "Line has trailing whitespace.",
-            {"style", "whitespace"}
-        },
-        {
-            "correctness.assignment_in_condition",
-            "SB-LINT-CORR-C0001",
-            LintCategory::Correctness,
-            FindingSeverity::Warning,
-            true,
-            "Condition contains an assignment expression.",
-            {"correctness", "condition"}
-        },
-        {
-            "performance.new_in_loop",
-            "SB-LINT-PERF-P0001",
-            LintCategory::Performance,
-            FindingSeverity::Information,
-            true,
-            "Object allocation appears inside a loop body.",
-            {"performance", "allocation"}
-        },
-        {
-            "safety.untyped_catch",
-            "SB-LINT-SAFE-A0001",
-            LintCategory::Safety,
-            FindingSeverity::Warning,
-            true,
-            "Catch clause is missing an explicit typed error binding.",
-            {"safety", "exceptions"}
-        },
-        {
-            "docs.missing_decl_comment",
-            "SB-LINT-DOC-D0001",
-            LintCategory::Docs,
-            FindingSeverity::Information,
-            true,
-            "Top-level declaration is missing a leading documentation comment.",
-            {"docs", "comments"}
-        },
-        {
-            "correctness.shadowing",
-            "SB-LINT-CORR-C0004",
-            LintCategory::Correctness,
-            FindingSeverity::Information,
-            true,
-            "Declaration shadows an outer binding.",
-            {"correctness", "scope", "shadowing"}
-        }
-    };
-}
-
 bool selectorMatchesRule(const std::string &selectorLower, const LintRuleDescriptor &rule) {
     auto idLower = toLower(rule.id);
     if(selectorLower == idLower) {
@@ -272,74 +219,6 @@ void appendFinding(std::vector<LintFinding> &outFindings,
     }
 }
 
-void addTrailingWhitespaceRule(const LintRuleDescriptor &rule,
-                               const std::vector<SourceLine> &lines,
-                               const LintConfig &config,
-                               std::vector<LintFinding> &outFindings,
-                               bool &hitLimit) {
-    for(const auto &line : lines) {
-        size_t end = line.text.size();
-        size_t trimEnd = end;
-        while(trimEnd > 0 && (line.text[trimEnd - 1] == ' ' || line.text[trimEnd - 1] == '\t')) {
-            --trimEnd;
-        }
-        if(trimEnd == end) {
-            continue;
-        }
-
-        auto span = makeSpan(line.line, static_cast<unsigned>(trimEnd), static_cast<unsigned>(end));
-        auto finding = makeFinding(rule, config, "Trailing whitespace should be removed.", span);
-
-        FixCandidate fix;
-        fix.id = rule.id + ".trim";
-        fix.title = "Trim trailing whitespace";
-        fix.preferred = true;
-        fix.isSafe = true;
-        fix.edits.push_back(TextEdit{span, ""});
-        finding.fixes.push_back(std::move(fix));
-
-        appendFinding(outFindings, std::move(finding), config, hitLimit);
-        if(hitLimit) {
-            return;
-        }
-    }
-}
-
-ASTExpr *findFirstSimpleAssignmentExpr(ASTExpr *expr) {
-    if(!expr) {
-        return nullptr;
-    }
-    if(expr->type == ASSIGN_EXPR && expr->oprtr_str.has_value() && *expr->oprtr_str == "=") {
-        return expr;
-    }
-    if(auto *nested = findFirstSimpleAssignmentExpr(expr->callee)) {
-        return nested;
-    }
-    if(auto *nested = findFirstSimpleAssignmentExpr(expr->leftExpr)) {
-        return nested;
-    }
-    if(auto *nested = findFirstSimpleAssignmentExpr(expr->middleExpr)) {
-        return nested;
-    }
-    if(auto *nested = findFirstSimpleAssignmentExpr(expr->rightExpr)) {
-        return nested;
-    }
-    for(auto *arg : expr->exprArrayData) {
-        if(auto *nested = findFirstSimpleAssignmentExpr(arg)) {
-            return nested;
-        }
-    }
-    for(const auto &entry : expr->dictExpr) {
-        if(auto *nested = findFirstSimpleAssignmentExpr(entry.first)) {
-            return nested;
-        }
-        if(auto *nested = findFirstSimpleAssignmentExpr(entry.second)) {
-            return nested;
-        }
-    }
-    return nullptr;
-}
-
 const SourceLine *lineForNumber(const std::vector<SourceLine> &lines, unsigned oneBasedLine);
 
 std::optional<TextSpan> findAssignmentSpanFromAst(const std::vector<SourceLine> &lines, ASTExpr *assignExpr) {
@@ -392,7 +271,7 @@ std::optional<TextSpan> findAssignmentSpanFromAst(const std::vector<SourceLine>
     return std::nullopt;
 }
 
-std::vector<size_t> findWordOccurrences(const std::string &line, const std::string &word) {
+std::vector<size_t> findWordOccurrences(std::string_view line, const std::string &word) {
     std::vector<size_t> offsets;
     if(word.empty() || line.size() < word.size()) {
         return offsets;
@@ -411,199 +290,6 @@ std::vector<size_t> findWordOccurrences(const std::string &line, const std::stri
     return offsets;
 }
 
-const SourceLine *lineForNumber(const std::vector<SourceLine> &lines, unsigned oneBasedLine);
-
-void scanStmtForAssignmentInCondition(const LintRuleDescriptor &rule,
-                                      ASTStmt *stmt,
-                                      const std::vector<SourceLine> &lines,
-                                      const LintConfig &config,
-                                      std::vector<LintFinding> &outFindings,
-                                      bool &hitLimit);
-
-void scanBlockForAssignmentInCondition(const LintRuleDescriptor &rule,
-                                       ASTBlockStmt *block,
-                                       const std::vector<SourceLine> &lines,
-                                       const LintConfig &config,
-                                       std::vector<LintFinding> &outFindings,
-                                       bool &hitLimit) {
-    if(!block) {
-        return;
-    }
-    for(auto *stmt : block->body) {
-        scanStmtForAssignmentInCondition(rule, stmt, lines, config, outFindings, hitLimit);
-        if(hitLimit) {
-            return;
-        }
-    }
-}
-
-void emitAssignmentInConditionFinding(const LintRuleDescriptor &rule,
-                                      ASTExpr *conditionExpr,
-                                      ASTExpr *assignExpr,
-                                      const std::vector<SourceLine> &lines,
-                                      const LintConfig &config,
-                                      std::vector<LintFinding> &outFindings,
-                                      bool &hitLimit) {
-    TextSpan span = conditionExpr ? spanFromRegion(conditionExpr->codeRegion) : makeSpan(1, 0, 1);
-    if(auto assignmentSpan = findAssignmentSpanFromAst(lines, assignExpr)) {
-        span = *assignmentSpan;
-    }
-    auto finding = makeFinding(rule,
-                               config,
-                               "Suspicious assignment in condition; did you mean `==`?",
-                               span);
-    appendFinding(outFindings, std::move(finding), config, hitLimit);
-}
-
-void scanStmtForAssignmentInCondition(const LintRuleDescriptor &rule,
-                                      ASTStmt *stmt,
-                                      const std::vector<SourceLine> &lines,
-                                      const LintConfig &config,
-                                      std::vector<LintFinding> &outFindings,
-                                      bool &hitLimit) {
-    if(!stmt || hitLimit) {
-        return;
-    }
-
-    if(!(stmt->type & DECL)) {
-        return;
-    }
-
-    auto *decl = static_cast<ASTDecl *>(stmt);
-    switch(decl->type) {
-        case COND_DECL: {
-            auto *condDecl = static_cast<ASTConditionalDecl *>(decl);
-            for(const auto &spec : condDecl->specs) {
-                if(auto *assignmentExpr = findFirstSimpleAssignmentExpr(spec.expr)) {
-                    emitAssignmentInConditionFinding(rule,
-                                                     spec.expr,
-                                                     assignmentExpr,
-                                                     lines,
-                                                     config,
-                                                     outFindings,
-                                                     hitLimit);
-                    if(hitLimit) {
-                        return;
-                    }
-                }
-                scanBlockForAssignmentInCondition(rule, spec.blockStmt, lines, config, outFindings, hitLimit);
-                if(hitLimit) {
-                    return;
-                }
-            }
-            return;
-        }
-        case FOR_DECL: {
-            auto *forDecl = static_cast<ASTForDecl *>(decl);
-            if(auto *assignmentExpr = findFirstSimpleAssignmentExpr(forDecl->expr)) {
-                emitAssignmentInConditionFinding(rule,
-                                                 forDecl->expr,
-                                                 assignmentExpr,
-                                                 lines,
-                                                 config,
-                                                 outFindings,
-                                                 hitLimit);
-                if(hitLimit) {
-                    return;
-                }
-            }
-            scanBlockForAssignmentInCondition(rule, forDecl->blockStmt, lines, config, outFindings, hitLimit);
-            return;
-        }
-        case WHILE_DECL: {
-            auto *whileDecl = static_cast<ASTWhileDecl *>(decl);
-            if(auto *assignmentExpr = findFirstSimpleAssignmentExpr(whileDecl->expr)) {
-                emitAssignmentInConditionFinding(rule,
-                                                 whileDecl->expr,
-                                                 assignmentExpr,
-                                                 lines,
-                                                 config,
-                                                 outFindings,
-                                                 hitLimit);
-                if(hitLimit) {
-                    return;
-                }
-            }
-            scanBlockForAssignmentInCondition(rule, whileDecl->blockStmt, lines, config, outFindings, hitLimit);
-            return;
-        }
-        case SECURE_DECL: {
-            auto *secureDecl = static_cast<ASTSecureDecl *>(decl);
-            scanBlockForAssignmentInCondition(rule, secureDecl->catchBlock, lines, config, outFindings, hitLimit);
-            return;
-        }
-        case FUNC_DECL:
-        case CLASS_FUNC_DECL:
-            scanBlockForAssignmentInCondition(rule,
-                                              static_cast<ASTFuncDecl *>(decl)->blockStmt,
-                                              lines,
-                                              config,
-                                              outFindings,
-                                              hitLimit);
-            return;
-        case CLASS_CTOR_DECL:
-            scanBlockForAssignmentInCondition(rule,
-                                              static_cast<ASTConstructorDecl *>(decl)->blockStmt,
-                                              lines,
-                                              config,
-                                              outFindings,
-                                              hitLimit);
-            return;
-        case CLASS_DECL: {
-            auto *classDecl = static_cast<ASTClassDecl *>(decl);
-            for(auto *method : classDecl->methods) {
-                scanBlockForAssignmentInCondition(rule, method->blockStmt, lines, config, outFindings, hitLimit);
-                if(hitLimit) {
-                    return;
-                }
-            }
-            for(auto *ctor : classDecl->constructors) {
-                scanBlockForAssignmentInCondition(rule, ctor->blockStmt, lines, config, outFindings, hitLimit);
-                if(hitLimit) {
-                    return;
-                }
-            }
-            return;
-        }
-        case INTERFACE_DECL: {
-            auto *interfaceDecl = static_cast<ASTInterfaceDecl *>(decl);
-            for(auto *method : interfaceDecl->methods) {
-                scanBlockForAssignmentInCondition(rule, method->blockStmt, lines, config, outFindings, hitLimit);
-                if(hitLimit) {
-                    return;
-                }
-            }
-            return;
-        }
-        case SCOPE_DECL:
-            scanBlockForAssignmentInCondition(rule,
-                                              static_cast<ASTScopeDecl *>(decl)->blockStmt,
-                                              lines,
-                                              config,
-                                              outFindings,
-                                              hitLimit);
-            return;
-        default:
-            return;
-    }
-}
-
-void addAssignmentInConditionRule(const LintRuleDescriptor &rule,
-                                  const CompilerLintAnalysis &analysis,
-                                  const std::vector<SourceLine> &lines,
-                                  const LintConfig &config,
-                                  std::vector<LintFinding> &outFindings,
-                                  bool &hitLimit) {
-    if(analysis.statements) {
-        for(auto *stmt : *analysis.statements) {
-            scanStmtForAssignmentInCondition(rule, stmt, lines, config, outFindings, hitLimit);
-            if(hitLimit) {
-                return;
-            }
-        }
-    }
-}
-
 const SourceLine *lineForNumber(const std::vector<SourceLine> &lines, unsigned oneBasedLine) {
     if(oneBasedLine == 0 || oneBasedLine > lines.size()) {
         return nullptr;
@@ -647,462 +333,19 @@ std::optional<TextSpan> findWordInLineRange(const std::vector<SourceLine> &lines
     if(endLine < startLine) {
         endLine = startLine;
     }
-    endLine = std::min<unsigned>(endLine, static_cast<unsigned>(lines.size()));
-    for(unsigned lineNo = startLine; lineNo <= endLine; ++lineNo) {
-        auto *line = lineForNumber(lines, lineNo);
-        if(!line) {
-            continue;
-        }
-        auto matches = findWordOccurrences(line->text, word);
-        if(!matches.empty()) {
-            auto pos = static_cast<unsigned>(matches.front());
-            return makeSpan(lineNo, pos, pos + static_cast<unsigned>(word.size()));
-        }
-    }
-    return std::nullopt;
-}
-
-void scanExprForLoopAllocations(const LintRuleDescriptor &rule,
-                                ASTExpr *expr,
-                                bool inLoop,
-                                const std::vector<SourceLine> &lines,
-                                const LintConfig &config,
-                                std::vector<LintFinding> &outFindings,
-                                bool &hitLimit);
-
-void scanStmtForLoopAllocations(const LintRuleDescriptor &rule,
-                                ASTStmt *stmt,
-                                bool inLoop,
-                                const std::vector<SourceLine> &lines,
-                                const LintConfig &config,
-                                std::vector<LintFinding> &outFindings,
-                                bool &hitLimit);
-
-void scanBlockForLoopAllocations(const LintRuleDescriptor &rule,
-                                 ASTBlockStmt *block,
-                                 bool inLoop,
-                                 const std::vector<SourceLine> &lines,
-                                 const LintConfig &config,
-                                 std::vector<LintFinding> &outFindings,
-                                 bool &hitLimit) {
-    if(!block) {
-        return;
-    }
-    for(auto *stmt : block->body) {
-        scanStmtForLoopAllocations(rule, stmt, inLoop, lines, config, outFindings, hitLimit);
-        if(hitLimit) {
-            return;
-        }
-    }
-}
-
-void emitLoopAllocationFinding(const LintRuleDescriptor &rule,
-                               ASTExpr *expr,
-                               const std::vector<SourceLine> &lines,
-                               const LintConfig &config,
-                               std::vector<LintFinding> &outFindings,
-                               bool &hitLimit) {
-    TextSpan span = spanFromRegion(expr->codeRegion);
-    if(auto newSpan = findWordOnLineBeforeColumn(lines,
-                                                 expr->codeRegion.startLine,
-                                                 expr->codeRegion.startCol,
-                                                 "new")) {
-        span = *newSpan;
-    }
-    auto finding = makeFinding(rule,
-                               config,
-                               "Object allocation inside a loop can increase runtime and GC pressure.",
-                               span);
-    appendFinding(outFindings, std::move(finding), config, hitLimit);
-}
-
-void scanExprForLoopAllocations(const LintRuleDescriptor &rule,
-                                ASTExpr *expr,
-                                bool inLoop,
-                                const std::vector<SourceLine> &lines,
-                                const LintConfig &config,
-                                std::vector<LintFinding> &outFindings,
-                                bool &hitLimit) {
-    if(!expr || hitLimit) {
-        return;
-    }
-
-    if(inLoop && expr->type == IVKE_EXPR && expr->isConstructorCall) {
-        emitLoopAllocationFinding(rule, expr, lines, config, outFindings, hitLimit);
-        if(hitLimit) {
-            return;
-        }
-    }
-
-    scanExprForLoopAllocations(rule, expr->callee, inLoop, lines, config, outFindings, hitLimit);
-    scanExprForLoopAllocations(rule, expr->leftExpr, inLoop, lines, config, outFindings, hitLimit);
-    scanExprForLoopAllocations(rule, expr->middleExpr, inLoop, lines, config, outFindings, hitLimit);
-    scanExprForLoopAllocations(rule, expr->rightExpr, inLoop, lines, config, outFindings, hitLimit);
-    for(auto *arg : expr->exprArrayData) {
-        scanExprForLoopAllocations(rule, arg, inLoop, lines, config, outFindings, hitLimit);
-        if(hitLimit) {
-            return;
-        }
-    }
-    for(const auto &entry : expr->dictExpr) {
-        scanExprForLoopAllocations(rule, entry.first, inLoop, lines, config, outFindings, hitLimit);
-        scanExprForLoopAllocations(rule, entry.second, inLoop, lines, config, outFindings, hitLimit);
-        if(hitLimit) {
-            return;
-        }
-    }
-}
-
-void scanVarDeclForLoopAllocations(const LintRuleDescriptor &rule,
-                                   ASTVarDecl *decl,
-                                   bool inLoop,
-                                   const std::vector<SourceLine> &lines,
-                                   const LintConfig &config,
-                                   std::vector<LintFinding> &outFindings,
-                                   bool &hitLimit) {
-    if(!decl) {
-        return;
-    }
-    for(const auto &spec : decl->specs) {
-        scanExprForLoopAllocations(rule, spec.expr, inLoop, lines, config, outFindings, hitLimit);
-        if(hitLimit) {
-            return;
-        }
-    }
-}
-
-void scanStmtForLoopAllocations(const LintRuleDescriptor &rule,
-                                ASTStmt *stmt,
-                                bool inLoop,
-                                const std::vector<SourceLine> &lines,
-                                const LintConfig &config,
-                                std::vector<LintFinding> &outFindings,
-                                bool &hitLimit) {
-    if(!stmt || hitLimit) {
-        return;
-    }
-
-    if(stmt->type & DECL) {
-        auto *decl = static_cast<ASTDecl *>(stmt);
-        switch(decl->type) {
-            case VAR_DECL:
-                scanVarDeclForLoopAllocations(rule,
-                                              static_cast<ASTVarDecl *>(decl),
-                                              inLoop,
-                                              lines,
-                                              config,
-                                              outFindings,
-                                              hitLimit);
-                return;
-            case COND_DECL: {
-                auto *condDecl = static_cast<ASTConditionalDecl *>(decl);
-                for(const auto &spec : condDecl->specs) {
-                    scanExprForLoopAllocations(rule, spec.expr, inLoop, lines, config, outFindings, hitLimit);
-                    scanBlockForLoopAllocations(rule, spec.blockStmt, inLoop, lines, config, outFindings, hitLimit);
-                    if(hitLimit) {
-                        return;
-                    }
-                }
-                return;
-            }
-            case FOR_DECL: {
-                auto *forDecl = static_cast<ASTForDecl *>(decl);
-                scanExprForLoopAllocations(rule, forDecl->expr, true, lines, config, outFindings, hitLimit);
-                scanBlockForLoopAllocations(rule, forDecl->blockStmt, true, lines, config, outFindings, hitLimit);
-                return;
-            }
-            case WHILE_DECL: {
-                auto *whileDecl = static_cast<ASTWhileDecl *>(decl);
-                scanExprForLoopAllocations(rule, whileDecl->expr, true, lines, config, outFindings, hitLimit);
-                scanBlockForLoopAllocations(rule, whileDecl->blockStmt, true, lines, config, outFindings, hitLimit);
-                return;
-            }
-            case SECURE_DECL: {
-                auto *secureDecl = static_cast<ASTSecureDecl *>(decl);
-                scanVarDeclForLoopAllocations(rule,
-                                              secureDecl->guardedDecl,
-                                              inLoop,
-                                              lines,
-                                              config,
-                                              outFindings,
-                                              hitLimit);
-                scanBlockForLoopAllocations(rule,
-                                            secureDecl->catchBlock,
-                                            inLoop,
-                                            lines,
-                                            config,
-                                            outFindings,
-                                            hitLimit);
-                return;
-            }
-            case FUNC_DECL:
-            case CLASS_FUNC_DECL: {
-                auto *funcDecl = static_cast<ASTFuncDecl *>(decl);
-                scanBlockForLoopAllocations(rule, funcDecl->blockStmt, false, lines, config, outFindings, hitLimit);
-                return;
-            }
-            case CLASS_CTOR_DECL: {
-                auto *ctorDecl = static_cast<ASTConstructorDecl *>(decl);
-                scanBlockForLoopAllocations(rule, ctorDecl->blockStmt, false, lines, config, outFindings, hitLimit);
-                return;
-            }
-            case CLASS_DECL: {
-                auto *classDecl = static_cast<ASTClassDecl *>(decl);
-                for(auto *field : classDecl->fields) {
-                    scanVarDeclForLoopAllocations(rule, field, false, lines, config, outFindings, hitLimit);
-                    if(hitLimit) {
-                        return;
-                    }
-                }
-                for(auto *method : classDecl->methods) {
-                    scanBlockForLoopAllocations(rule, method->blockStmt, false, lines, config, outFindings, hitLimit);
-                    if(hitLimit) {
-                        return;
-                    }
-                }
-                for(auto *ctor : classDecl->constructors) {
-                    scanBlockForLoopAllocations(rule, ctor->blockStmt, false, lines, config, outFindings, hitLimit);
-                    if(hitLimit) {
-                        return;
-                    }
-                }
-                return;
-            }
-            case INTERFACE_DECL: {
-                auto *interfaceDecl = static_cast<ASTInterfaceDecl *>(decl);
-                for(auto *field : interfaceDecl->fields) {
-                    scanVarDeclForLoopAllocations(rule, field, false, lines, config, outFindings, hitLimit);
-                    if(hitLimit) {
-                        return;
-                    }
-                }
-                for(auto *method : interfaceDecl->methods) {
-                    scanBlockForLoopAllocations(rule, method->blockStmt, false, lines, config, outFindings, hitLimit);
-                    if(hitLimit) {
-                        return;
-                    }
-                }
-                return;
-            }
-            case SCOPE_DECL: {
-                auto *scopeDecl = static_cast<ASTScopeDecl *>(decl);
-                scanBlockForLoopAllocations(rule, scopeDecl->blockStmt, false, lines, config, outFindings, hitLimit);
-                return;
-            }
-            case RETURN_DECL: {
-                auto *returnDecl = static_cast<ASTReturnDecl *>(decl);
-                scanExprForLoopAllocations(rule, returnDecl->expr, inLoop, lines, config, outFindings, hitLimit);
-                return;
-            }
-            default:
-                return;
-        }
-    }
-
-    scanExprForLoopAllocations(rule,
-                               static_cast<ASTExpr *>(stmt),
-                               inLoop,
-                               lines,
-                               config,
-                               outFindings,
-                               hitLimit);
-}
-
-void addNewInLoopRule(const LintRuleDescriptor &rule,
-                      const CompilerLintAnalysis &analysis,
-                      const std::vector<SourceLine> &lines,
-                      const LintConfig &config,
-                      std::vector<LintFinding> &outFindings,
-                      bool &hitLimit) {
-    if(!analysis.statements) {
-        return;
-    }
-    for(auto *stmt : *analysis.statements) {
-        scanStmtForLoopAllocations(rule, stmt, false, lines, config, outFindings, hitLimit);
-        if(hitLimit) {
-            return;
-        }
-    }
-}
-
-void scanStmtForUntypedCatch(const LintRuleDescriptor &rule,
-                             ASTStmt *stmt,
-                             const std::vector<SourceLine> &lines,
-                             const LintConfig &config,
-                             std::vector<LintFinding> &outFindings,
-                             bool &hitLimit);
-
-void scanBlockForUntypedCatch(const LintRuleDescriptor &rule,
-                              ASTBlockStmt *block,
-                              const std::vector<SourceLine> &lines,
-                              const LintConfig &config,
-                              std::vector<LintFinding> &outFindings,
-                              bool &hitLimit) {
-    if(!block) {
-        return;
-    }
-    for(auto *stmt : block->body) {
-        scanStmtForUntypedCatch(rule, stmt, lines, config, outFindings, hitLimit);
-        if(hitLimit) {
-            return;
-        }
-    }
-}
-
-void emitUntypedCatchFinding(const LintRuleDescriptor &rule,
-                             ASTSecureDecl *secureDecl,
-                             const std::vector<SourceLine> &lines,
-                             const LintConfig &config,
-                             std::vector<LintFinding> &outFindings,
-                             bool &hitLimit) {
-    unsigned startLine = 1;
-    if(secureDecl->guardedDecl && !secureDecl->guardedDecl->specs.empty()) {
-        startLine = secureDecl->guardedDecl->specs.front().id
-            ? secureDecl->guardedDecl->specs.front().id->codeRegion.startLine
-            : secureDecl->guardedDecl->codeRegion.startLine;
-    }
-    if(startLine == 0) {
-        startLine = 1;
-    }
-    unsigned endLine = startLine + 2;
-    if(secureDecl->catchBlock && !secureDecl->catchBlock->body.empty() && secureDecl->catchBlock->body.front()) {
-        endLine = std::max(endLine, secureDecl->catchBlock->body.front()->codeRegion.startLine + 1);
-    }
-
-    TextSpan span = secureDecl->guardedDecl ? spanFromRegion(secureDecl->guardedDecl->codeRegion)
-                                            : makeSpan(startLine, 0, 5);
-    if(auto catchSpan = findWordInLineRange(lines, startLine, endLine, "catch")) {
-        span = *catchSpan;
-    }
-    auto finding = makeFinding(rule,
-                               config,
-                               "Catch clause should declare a typed error binding, e.g. `catch (err:String)`.",
-                               span);
-    appendFinding(outFindings, std::move(finding), config, hitLimit);
-}
-
-void scanStmtForUntypedCatch(const LintRuleDescriptor &rule,
-                             ASTStmt *stmt,
-                             const std::vector<SourceLine> &lines,
-                             const LintConfig &config,
-                             std::vector<LintFinding> &outFindings,
-                             bool &hitLimit) {
-    if(!stmt || hitLimit) {
-        return;
-    }
-
-    if(stmt->type & DECL) {
-        auto *decl = static_cast<ASTDecl *>(stmt);
-        switch(decl->type) {
-            case SECURE_DECL: {
-                auto *secureDecl = static_cast<ASTSecureDecl *>(decl);
-                if(secureDecl->catchErrorType == nullptr || secureDecl->catchErrorId == nullptr) {
-                    emitUntypedCatchFinding(rule, secureDecl, lines, config, outFindings, hitLimit);
-                    if(hitLimit) {
-                        return;
-                    }
-                }
-                scanBlockForUntypedCatch(rule, secureDecl->catchBlock, lines, config, outFindings, hitLimit);
-                return;
-            }
-            case COND_DECL: {
-                auto *condDecl = static_cast<ASTConditionalDecl *>(decl);
-                for(const auto &spec : condDecl->specs) {
-                    scanBlockForUntypedCatch(rule, spec.blockStmt, lines, config, outFindings, hitLimit);
-                    if(hitLimit) {
-                        return;
-                    }
-                }
-                return;
-            }
-            case FOR_DECL:
-                scanBlockForUntypedCatch(rule,
-                                         static_cast<ASTForDecl *>(decl)->blockStmt,
-                                         lines,
-                                         config,
-                                         outFindings,
-                                         hitLimit);
-                return;
-            case WHILE_DECL:
-                scanBlockForUntypedCatch(rule,
-                                         static_cast<ASTWhileDecl *>(decl)->blockStmt,
-                                         lines,
-                                         config,
-                                         outFindings,
-                                         hitLimit);
-                return;
-            case FUNC_DECL:
-            case CLASS_FUNC_DECL:
-                scanBlockForUntypedCatch(rule,
-                                         static_cast<ASTFuncDecl *>(decl)->blockStmt,
-                                         lines,
-                                         config,
-                                         outFindings,
-                                         hitLimit);
-                return;
-            case CLASS_CTOR_DECL:
-                scanBlockForUntypedCatch(rule,
-                                         static_cast<ASTConstructorDecl *>(decl)->blockStmt,
-                                         lines,
-                                         config,
-                                         outFindings,
-                                         hitLimit);
-                return;
-            case CLASS_DECL: {
-                auto *classDecl = static_cast<ASTClassDecl *>(decl);
-                for(auto *method : classDecl->methods) {
-                    scanBlockForUntypedCatch(rule, method->blockStmt, lines, config, outFindings, hitLimit);
-                    if(hitLimit) {
-                        return;
-                    }
-                }
-                for(auto *ctor : classDecl->constructors) {
-                    scanBlockForUntypedCatch(rule, ctor->blockStmt, lines, config, outFindings, hitLimit);
-                    if(hitLimit) {
-                        return;
-                    }
-                }
-                return;
-            }
-            case INTERFACE_DECL: {
-                auto *interfaceDecl = static_cast<ASTInterfaceDecl *>(decl);
-                for(auto *method : interfaceDecl->methods) {
-                    scanBlockForUntypedCatch(rule, method->blockStmt, lines, config, outFindings, hitLimit);
-                    if(hitLimit) {
-                        return;
-                    }
-                }
-                return;
-            }
-            case SCOPE_DECL:
-                scanBlockForUntypedCatch(rule,
-                                         static_cast<ASTScopeDecl *>(decl)->blockStmt,
-                                         lines,
-                                         config,
-                                         outFindings,
-                                         hitLimit);
-                return;
-            default:
-                return;
-        }
-    }
-}
-
-void addUntypedCatchRule(const LintRuleDescriptor &rule,
-                         const CompilerLintAnalysis &analysis,
-                         const std::vector<SourceLine> &lines,
-                         const LintConfig &config,
-                         std::vector<LintFinding> &outFindings,
-                         bool &hitLimit) {
-    if(!analysis.statements) {
-        return;
-    }
-    for(auto *stmt : *analysis.statements) {
-        scanStmtForUntypedCatch(rule, stmt, lines, config, outFindings, hitLimit);
-        if(hitLimit) {
-            return;
+    endLine = std::min<unsigned>(endLine, static_cast<unsigned>(lines.size()));
+    for(unsigned lineNo = startLine; lineNo <= endLine; ++lineNo) {
+        auto *line = lineForNumber(lines, lineNo);
+        if(!line) {
+            continue;
+        }
+        auto matches = findWordOccurrences(line->text, word);
+        if(!matches.empty()) {
+            auto pos = static_cast<unsigned>(matches.front());
+            return makeSpan(lineNo, pos, pos + static_cast<unsigned>(word.size()));
         }
     }
+    return std::nullopt;
 }
 
 bool endsWith(const std::string &value, const std::string &suffix) {
@@ -1118,7 +361,7 @@ bool hasDocCommentAbove(const std::vector<SourceLine> &lines, unsigned oneBasedL
     }
 
     size_t index = static_cast<size_t>(oneBasedLine - 1);
-    auto prev = trimCopy(lines[index - 1].text);
+    auto prev = trimCopy(std::string(lines[index - 1].text));
     if(startsWith(prev, "///")) {
         return true;
     }
@@ -1128,7 +371,7 @@ bool hasDocCommentAbove(const std::vector<SourceLine> &lines, unsigned oneBasedL
     }
 
     for(size_t i = index; i > 0; --i) {
-        auto current = trimCopy(lines[i - 1].text);
+        auto current = trimCopy(std::string(lines[i - 1].text));
         if(current.empty()) {
             return false;
         }
@@ -1164,40 +407,6 @@ unsigned docKeywordLength(const ASTDecl *decl) {
     }
 }
 
-void addMissingDocRule(const LintRuleDescriptor &rule,
-                       const CompilerLintAnalysis &analysis,
-                       const std::vector<SourceLine> &lines,
-                       const LintConfig &config,
-                       std::vector<LintFinding> &outFindings,
-                       bool &hitLimit) {
-    if(!analysis.statements) {
-        return;
-    }
-    for(auto *stmt : *analysis.statements) {
-        if(!stmt || !(stmt->type & DECL)) {
-            continue;
-        }
-        auto *decl = static_cast<ASTDecl *>(stmt);
-        if(!isDocRequiredDeclaration(decl) || decl->codeRegion.startLine == 0) {
-            continue;
-        }
-        if(hasDocCommentAbove(lines, decl->codeRegion.startLine)) {
-            continue;
-        }
-        auto startCol = decl->codeRegion.startCol;
-        auto finding = makeFinding(rule,
-                                   config,
-                                   "Top-level declaration should include a leading documentation comment.",
-                                   makeSpan(decl->codeRegion.startLine,
-                                            startCol,
-                                            startCol + docKeywordLength(decl)));
-        appendFinding(outFindings, std::move(finding), config, hitLimit);
-        if(hitLimit) {
-            return;
-        }
-    }
-}
-
 enum class FlowBindingKind : uint8_t {
     Local,
     Parameter,
@@ -1910,17 +1119,470 @@ void sortFindingsDeterministically(std::vector<LintFinding> &findings) {
     });
 }
 
+struct LintVisitContext {
+    bool topLevel = false;
+    bool inLoop = false;
+    /// Root of the branch or loop condition being walked; null inside bodies.
+    ASTExpr *condition = nullptr;
+};
+
+/// State of one enabled rule during a run. Findings are kept per rule so the `maxFindings` cap keeps the
+/// same findings it would if the rules ran one after another in registry order.
+struct LintRuleRun {
+    const LintRuleDescriptor *rule = nullptr;
+    const LintConfig *config = nullptr;
+    const std::vector<SourceLine> *lines = nullptr;
+    std::vector<LintFinding> findings;
+    uint64_t elapsedNs = 0;
+    ASTExpr *reportedCondition = nullptr;
+
+    bool saturated() const {
+        return findings.size() >= config->maxFindings;
+    }
+
+    LintFinding &report(const std::string &message, const TextSpan &span) {
+        findings.push_back(makeFinding(*rule, *config, message, span));
+        return findings.back();
+    }
+};
+
+using LintLineHook = void (*)(LintRuleRun &run, const SourceLine &line);
+using LintStmtHook = void (*)(LintRuleRun &run, ASTStmt *stmt, const LintVisitContext &context);
+using LintExprHook = void (*)(LintRuleRun &run, ASTExpr *expr, const LintVisitContext &context);
+using LintModuleHook = void (*)(LintRuleRun &run, const CompilerLintAnalysis &analysis);
+
+/// A rule is a descriptor plus the callbacks it wants: per source line, per statement kind, and per
+/// expression kind, all dispatched from one shared traversal. `onModule` is for rules that need their
+/// own walk, such as the flow-sensitive shadowing check.
+struct LintRuleDefinition {
+    LintRuleDescriptor descriptor;
+    LintLineHook onLine = nullptr;
+    std::vector<ASTNodeType> stmtKinds;
+    LintStmtHook onStmt = nullptr;
+    std::vector<ASTNodeType> exprKinds;
+    LintExprHook onExpr = nullptr;
+    LintModuleHook onModule = nullptr;
+};
+
+void checkTrailingWhitespace(LintRuleRun &run, const SourceLine &line) {
+    size_t end = line.text.size();
+    size_t trimEnd = end;
+    while(trimEnd > 0 && (line.text[trimEnd - 1] == ' ' || line.text[trimEnd - 1] == '\t')) {
+        --trimEnd;
+    }
+    if(trimEnd == end) {
+        return;
+    }
+
+    auto span = makeSpan(line.line, static_cast<unsigned>(trimEnd), static_cast<unsigned>(end));
+    auto &finding = run.report("Trailing whitespace should be removed.", span);
+
+    FixCandidate fix;
+    fix.id = run.rule->id + ".trim";
+    fix.title = "Trim trailing whitespace";
+    fix.preferred = true;
+    fix.isSafe = true;
+    fix.edits.push_back(TextEdit{span, ""});
+    finding.fixes.push_back(std::move(fix));
+}
+
+void checkAssignmentInCondition(LintRuleRun &run, ASTExpr *expr, const LintVisitContext &context) {
+    if(!context.condition || context.condition == run.reportedCondition || !expr->oprtr_str.has_value()
+       || *expr->oprtr_str != "=") {
+        return;
+    }
+    // Only the first assignment of each condition is reported.
+    run.reportedCondition = context.condition;
+    TextSpan span = spanFromRegion(context.condition->codeRegion);
+    if(auto assignmentSpan = findAssignmentSpanFromAst(*run.lines, expr)) {
+        span = *assignmentSpan;
+    }
+    run.report("Suspicious assignment in condition; did you mean `==`?", span);
+}
+
+void checkAllocationInLoop(LintRuleRun &run, ASTExpr *expr, const LintVisitContext &context) {
+    if(!context.inLoop || !expr->isConstructorCall) {
+        return;
+    }
+    TextSpan span = spanFromRegion(expr->codeRegion);
+    if(auto newSpan = findWordOnLineBeforeColumn(*run.lines,
+                                                 expr->codeRegion.startLine,
+                                                 expr->codeRegion.startCol,
+                                                 "new")) {
+        span = *newSpan;
+    }
+    run.report("Object allocation inside a loop can increase runtime and GC pressure.", span);
+}
+
+void checkUntypedCatch(LintRuleRun &run, ASTStmt *stmt, const LintVisitContext &context) {
+    (void)context;
+    auto *secureDecl = static_cast<ASTSecureDecl *>(stmt);
+    if(secureDecl->catchErrorType != nullptr && secureDecl->catchErrorId != nullptr) {
+        return;
+    }
+
+    unsigned startLine = 1;
+    if(secureDecl->guardedDecl && !secureDecl->guardedDecl->specs.empty()) {
+        startLine = secureDecl->guardedDecl->specs.front().id
+            ? secureDecl->guardedDecl->specs.front().id->codeRegion.startLine
+            : secureDecl->guardedDecl->codeRegion.startLine;
+    }
+    if(startLine == 0) {
+        startLine = 1;
+    }
+    unsigned endLine = startLine + 2;
+    if(secureDecl->catchBlock && !secureDecl->catchBlock->body.empty() && secureDecl->catchBlock->body.front()) {
+        endLine = std::max(endLine, secureDecl->catchBlock->body.front()->codeRegion.startLine + 1);
+    }
+
+    TextSpan span = secureDecl->guardedDecl ? spanFromRegion(secureDecl->guardedDecl->codeRegion)
+                                            : makeSpan(startLine, 0, 5);
+    if(auto catchSpan = findWordInLineRange(*run.lines, startLine, endLine, "catch")) {
+        span = *catchSpan;
+    }
+    run.report("Catch clause should declare a typed error binding, e.g. `catch (err:String)`.", span);
+}
+
+void checkMissingDocComment(LintRuleRun &run, ASTStmt *stmt, const LintVisitContext &context) {
+    auto *decl = static_cast<ASTDecl *>(stmt);
+    if(!context.topLevel || !isDocRequiredDeclaration(decl) || decl->codeRegion.startLine == 0) {
+        return;
+    }
+    if(hasDocCommentAbove(*run.lines, decl->codeRegion.startLine)) {
+        return;
+    }
+    auto startCol = decl->codeRegion.startCol;
+    run.report("Top-level declaration should include a leading documentation comment.",
+               makeSpan(decl->codeRegion.startLine, startCol, startCol + docKeywordLength(decl)));
+}
+
+void checkShadowing(LintRuleRun &run, const CompilerLintAnalysis &analysis) {
+    bool hitLimit = false;
+    addShadowingRule(*run.rule, analysis, *run.config, run.findings, hitLimit);
+}
+
+const std::vector<LintRuleDefinition> &ruleDefinitions() {
+    static const std::vector<LintRuleDefinition> definitions = [] {
+        std::vector<LintRuleDefinition> rules;
+
+        LintRuleDefinition trailingWhitespace;
+        trailingWhitespace.descriptor = {
+            "style.trailing_whitespace",
+            "SB-LINT-STYLE-S0001",
+            LintCategory::Style,
+            FindingSeverity::Warning,
+            true,
+            "Line has trailing whitespace.",
+            {"style", "whitespace"}
+        };
+        trailingWhitespace.onLine = checkTrailingWhitespace;
+        rules.push_back(std::move(trailingWhitespace));
+
+        LintRuleDefinition assignmentInCondition;
+        assignmentInCondition.descriptor = {
+            "correctness.assignment_in_condition",
+            "SB-LINT-CORR-C0001",
+            LintCategory::Correctness,
+            FindingSeverity::Warning,
+            true,
+            "Condition contains an assignment expression.",
+            {"correctness", "condition"}
+        };
+        assignmentInCondition.exprKinds = {ASSIGN_EXPR};
+        assignmentInCondition.onExpr = checkAssignmentInCondition;
+        rules.push_back(std::move(assignmentInCondition));
+
+        LintRuleDefinition newInLoop;
+        newInLoop.descriptor = {
+            "performance.new_in_loop",
+            "SB-LINT-PERF-P0001",
+            LintCategory::Performance,
+            FindingSeverity::Information,
+            true,
+            "Object allocation appears inside a loop body.",
+            {"performance", "allocation"}
+        };
+        newInLoop.exprKinds = {IVKE_EXPR};
+        newInLoop.onExpr = checkAllocationInLoop;
+        rules.push_back(std::move(newInLoop));
+
+        LintRuleDefinition untypedCatch;
+        untypedCatch.descriptor = {
+            "safety.untyped_catch",
+            "SB-LINT-SAFE-A0001",
+            LintCategory::Safety,
+            FindingSeverity::Warning,
+            true,
+            "Catch clause is missing an explicit typed error binding.",
+            {"safety", "exceptions"}
+        };
+        untypedCatch.stmtKinds = {SECURE_DECL};
+        untypedCatch.onStmt = checkUntypedCatch;
+        rules.push_back(std::move(untypedCatch));
+
+        LintRuleDefinition missingDocComment;
+        missingDocComment.descriptor = {
+            "docs.missing_decl_comment",
+            "SB-LINT-DOC-D0001",
+            LintCategory::Docs,
+            FindingSeverity::Information,
+            true,
+            "Top-level declaration is missing a leading documentation comment.",
+            {"docs", "comments"}
+        };
+        missingDocComment.stmtKinds = {FUNC_DECL, CLASS_DECL, INTERFACE_DECL, SCOPE_DECL, TYPE_ALIAS_DECL};
+        missingDocComment.onStmt = checkMissingDocComment;
+        rules.push_back(std::move(missingDocComment));
+
+        LintRuleDefinition shadowing;
+        shadowing.descriptor = {
+            "correctness.shadowing",
+            "SB-LINT-CORR-C0004",
+            LintCategory::Correctness,
+            FindingSeverity::Information,
+            true,
+            "Declaration shadows an outer binding.",
+            {"correctness", "scope", "shadowing"}
+        };
+        shadowing.onModule = checkShadowing;
+        rules.push_back(std::move(shadowing));
+
+        return rules;
+    }();
+    return definitions;
+}
+
+/// Runs every enabled rule from one pass over the line table and one walk of the AST.
+/// Hooks are indexed by node kind, so a node only pays for the rules that asked for it.
+class LintDispatcher {
+    std::vector<LintRuleRun> &runs;
+    const std::vector<const LintRuleDefinition *> &definitions;
+    bool profileRules = false;
+    std::vector<size_t> lineRules;
+    std::unordered_map<ASTNodeType, std::vector<size_t>> stmtRules;
+    std::unordered_map<ASTNodeType, std::vector<size_t>> exprRules;
+
+    template<typename Hook>
+    void invoke(size_t index, Hook &&hook) {
+        auto &run = runs[index];
+        if(run.saturated()) {
+            return;
+        }
+        if(!profileRules) {
+            hook(run);
+            return;
+        }
+        auto start = std::chrono::steady_clock::now();
+        hook(run);
+        run.elapsedNs += static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+    }
+
+    bool allSaturated() const {
+        for(const auto &run : runs) {
+            if(!run.saturated()) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void visitBlock(ASTBlockStmt *block, LintVisitContext context) {
+        if(!block) {
+            return;
+        }
+        context.topLevel = false;
+        context.condition = nullptr;
+        for(auto *stmt : block->body) {
+            visitStmt(stmt, context);
+        }
+    }
+
+    void visitExpr(ASTExpr *expr, const LintVisitContext &context) {
+        if(!expr) {
+            return;
+        }
+        auto rulesIt = exprRules.find(expr->type);
+        if(rulesIt != exprRules.end()) {
+            for(auto index : rulesIt->second) {
+                invoke(index, [&](LintRuleRun &run) { definitions[index]->onExpr(run, expr, context); });
+            }
+        }
+        visitExpr(expr->callee, context);
+        visitExpr(expr->leftExpr, context);
+        visitExpr(expr->middleExpr, context);
+        visitExpr(expr->rightExpr, context);
+        for(auto *arg : expr->exprArrayData) {
+            visitExpr(arg, context);
+        }
+        for(const auto &entry : expr->dictExpr) {
+            visitExpr(entry.first, context);
+            visitExpr(entry.second, context);
+        }
+    }
+
+    void visitCondition(ASTExpr *condition, LintVisitContext context) {
+        context.condition = condition;
+        visitExpr(condition, context);
+    }
+
+    void visitStmt(ASTStmt *stmt, const LintVisitContext &context) {
+        if(!stmt || allSaturated()) {
+            return;
+        }
+        if(!(stmt->type & DECL)) {
+            visitExpr(static_cast<ASTExpr *>(stmt), context);
+            return;
+        }
+
+        auto rulesIt = stmtRules.find(stmt->type);
+        if(rulesIt != stmtRules.end()) {
+            for(auto index : rulesIt->second) {
+                invoke(index, [&](LintRuleRun &run) { definitions[index]->onStmt(run, stmt, context); });
+            }
+        }
+
+        LintVisitContext nested = context;
+        nested.topLevel = false;
+        LintVisitContext function = nested;
+        function.inLoop = false;
+        LintVisitContext loop = nested;
+        loop.inLoop = true;
+
+        switch(stmt->type) {
+            case VAR_DECL:
+                for(const auto &spec : static_cast<ASTVarDecl *>(stmt)->specs) {
+                    visitExpr(spec.expr, nested);
+                }
+                return;
+            case COND_DECL:
+                for(const auto &spec : static_cast<ASTConditionalDecl *>(stmt)->specs) {
+                    visitCondition(spec.expr, nested);
+                    visitBlock(spec.blockStmt, nested);
+                }
+                return;
+            case FOR_DECL: {
+                auto *forDecl = static_cast<ASTForDecl *>(stmt);
+                visitCondition(forDecl->expr, loop);
+                visitBlock(forDecl->blockStmt, loop);
+                return;
+            }
+            case WHILE_DECL: {
+                auto *whileDecl = static_cast<ASTWhileDecl *>(stmt);
+                visitCondition(whileDecl->expr, loop);
+                visitBlock(whileDecl->blockStmt, loop);
+                return;
+            }
+            case SECURE_DECL: {
+                auto *secureDecl = static_cast<ASTSecureDecl *>(stmt);
+                visitStmt(secureDecl->guardedDecl, nested);
+                visitBlock(secureDecl->catchBlock, nested);
+                return;
+            }
+            case FUNC_DECL:
+            case CLASS_FUNC_DECL:
+                visitBlock(static_cast<ASTFuncDecl *>(stmt)->blockStmt, function);
+                return;
+            case CLASS_CTOR_DECL:
+                visitBlock(static_cast<ASTConstructorDecl *>(stmt)->blockStmt, function);
+                return;
+            case CLASS_DECL: {
+                auto *classDecl = static_cast<ASTClassDecl *>(stmt);
+                for(auto *field : classDecl->fields) {
+                    visitStmt(field, function);
+                }
+                for(auto *method : classDecl->methods) {
+                    visitStmt(method, function);
+                }
+                for(auto *ctor : classDecl->constructors) {
+                    visitStmt(ctor, function);
+                }
+                return;
+            }
+            case INTERFACE_DECL: {
+                auto *interfaceDecl = static_cast<ASTInterfaceDecl *>(stmt);
+                for(auto *field : interfaceDecl->fields) {
+                    visitStmt(field, function);
+                }
+                for(auto *method : interfaceDecl->methods) {
+                    visitStmt(method, function);
+                }
+                return;
+            }
+            case SCOPE_DECL:
+                visitBlock(static_cast<ASTScopeDecl *>(stmt)->blockStmt, function);
+                return;
+            case RETURN_DECL:
+                visitExpr(static_cast<ASTReturnDecl *>(stmt)->expr, nested);
+                return;
+            default:
+                return;
+        }
+    }
+
+public:
+    LintDispatcher(std::vector<LintRuleRun> &runs,
+                   const std::vector<const LintRuleDefinition *> &definitions,
+                   bool profileRules)
+        : runs(runs), definitions(definitions), profileRules(profileRules) {
+        for(size_t index = 0; index < definitions.size(); ++index) {
+            const auto *definition = definitions[index];
+            if(definition->onLine) {
+                lineRules.push_back(index);
+            }
+            if(definition->onStmt) {
+                for(auto kind : definition->stmtKinds) {
+                    stmtRules[kind].push_back(index);
+                }
+            }
+            if(definition->onExpr) {
+                for(auto kind : definition->exprKinds) {
+                    exprRules[kind].push_back(index);
+                }
+            }
+        }
+    }
+
+    void visitLines(const std::vector<SourceLine> &lines) {
+        if(lineRules.empty()) {
+            return;
+        }
+        for(const auto &line : lines) {
+            for(auto index : lineRules) {
+                invoke(index, [&](LintRuleRun &run) { definitions[index]->onLine(run, line); });
+            }
+        }
+    }
+
+    void visitModule(const CompilerLintAnalysis &analysis) {
+        if(analysis.statements && (!stmtRules.empty() || !exprRules.empty())) {
+            LintVisitContext context;
+            context.topLevel = true;
+            for(auto *stmt : *analysis.statements) {
+                visitStmt(stmt, context);
+            }
+        }
+        for(size_t index = 0; index < definitions.size(); ++index) {
+            if(definitions[index]->onModule) {
+                invoke(index, [&](LintRuleRun &run) { definitions[index]->onModule(run, analysis); });
+            }
+        }
+    }
+};
+
 } // namespace
 
 std::vector<LintRuleDescriptor> LintEngine::ruleDescriptors() const {
-    return allRuleDescriptors();
+    std::vector<LintRuleDescriptor> descriptors;
+    for(const auto &definition : ruleDefinitions()) {
+        descriptors.push_back(definition.descriptor);
+    }
+    return descriptors;
 }
 
 LintResult LintEngine::run(const CompilerLintAnalysis &analysis,
                            const LinguisticsConfig &config,
                            const LintRequest &request) const {
-    (void)request;
-
     LintResult result;
     if(!config.lint.enabled || config.lint.maxFindings == 0 || analysis.session == nullptr) {
         return result;
@@ -1939,41 +1601,38 @@ LintResult LintEngine::run(const CompilerLintAnalysis &analysis,
     }
 
     auto lines = splitLines(analysis.session->getSourceText());
-    bool hitLimit = false;
 
-    for(const auto &rule : allRuleDescriptors()) {
-        if(!isRuleEnabled(rule, enabledSelectors, disabledSelectors)) {
+    std::vector<const LintRuleDefinition *> definitions;
+    std::vector<LintRuleRun> runs;
+    for(const auto &definition : ruleDefinitions()) {
+        if(!isRuleEnabled(definition.descriptor, enabledSelectors, disabledSelectors)) {
             continue;
         }
+        definitions.push_back(&definition);
+        LintRuleRun run;
+        run.rule = &definition.descriptor;
+        run.config = &config.lint;
+        run.lines = &lines;
+        runs.push_back(std::move(run));
+    }
 
-        if(rule.id == "style.trailing_whitespace") {
-            addTrailingWhitespaceRule(rule, lines, config.lint, result.findings, hitLimit);
-        }
-        else if(rule.id == "correctness.assignment_in_condition") {
-            addAssignmentInConditionRule(rule, analysis, lines, config.lint, result.findings, hitLimit);
-        }
-        else if(rule.id == "performance.new_in_loop") {
-            addNewInLoopRule(rule, analysis, lines, config.lint, result.findings, hitLimit);
-        }
-        else if(rule.id == "safety.untyped_catch") {
-            addUntypedCatchRule(rule, analysis, lines, config.lint, result.findings, hitLimit);
-        }
-        else if(rule.id == "docs.missing_decl_comment") {
-            addMissingDocRule(rule, analysis, lines, config.lint, result.findings, hitLimit);
-        }
-        else if(rule.id == "correctness.shadowing") {
-            addShadowingRule(rule, analysis, config.lint, result.findings, hitLimit);
-        }
+    LintDispatcher dispatcher(runs, definitions, request.profileRules);
+    dispatcher.visitLines(lines);
+    dispatcher.visitModule(analysis);
 
-        if(hitLimit) {
-            break;
+    for(auto &run : runs) {
+        if(request.profileRules) {
+            result.ruleTimings.push_back({run.rule->id, run.elapsedNs, run.findings.size()});
+        }
+        for(auto &finding : run.findings) {
+            if(result.findings.size() >= config.lint.maxFindings) {
+                break;
+            }
+            result.findings.push_back(std::move(finding));
         }
     }
 
     sortFindingsDeterministically(result.findings);
-    if(result.findings.size() > config.lint.maxFindings) {
-        result.findings.resize(config.lint.maxFindings);
-    }
     return result;
 }
 
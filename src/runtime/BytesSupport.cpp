@@ -0,0 +1,109 @@
+#include "starbytes/runtime/BytesSupport.h"
+
+#include "RTValue.h"
+
+#include <climits>
+#include <cstring>
+#include <string>
+
+namespace starbytes::Runtime::bytes {
+namespace {
+
+constexpr char kHexDigits[] = "0123456789abcdef";
+
+int clampedLength(StarbytesObject bytesObject){
+    auto length = StarbytesBytesGetLength(bytesObject);
+    return length > (size_t)INT_MAX ? INT_MAX : (int)length;
+}
+
+}
+
+StarbytesObject at(StarbytesObject bytesObject,int index,std::string &errorOut){
+    errorOut.clear();
+    if(index < 0 || index >= clampedLength(bytesObject)){
+        errorOut = "Bytes.at index out of range";
+        return nullptr;
+    }
+    return StarbytesNumNew(NumTypeInt,(int)StarbytesBytesGetData(bytesObject)[index]);
+}
+
+StarbytesObject slice(StarbytesObject bytesObject,int start,int end){
+    auto length = clampedLength(bytesObject);
+    start = clampSliceBound(start,length);
+    end = clampSliceBound(end,length);
+    if(end < start){
+        end = start;
+    }
+    return StarbytesBytesSlice(bytesObject,(size_t)start,(size_t)(end - start));
+}
+
+StarbytesObject copy(StarbytesObject bytesObject){
+    return StarbytesBytesNewWithData(StarbytesBytesGetData(bytesObject),StarbytesBytesGetLength(bytesObject));
+}
+
+StarbytesObject toArray(StarbytesObject bytesObject){
+    auto *data = StarbytesBytesGetData(bytesObject);
+    auto length = (unsigned)clampedLength(bytesObject);
+    auto out = StarbytesArrayNew();
+    StarbytesArrayReserve(out,length);
+    for(unsigned i = 0;i < length;++i){
+        auto value = StarbytesNumNew(NumTypeInt,(int)data[i]);
+        StarbytesArrayPush(out,value);
+        StarbytesObjectRelease(value);
+    }
+    return out;
+}
+
+StarbytesObject toHex(StarbytesObject bytesObject){
+    auto *data = StarbytesBytesGetData(bytesObject);
+    auto length = StarbytesBytesGetLength(bytesObject);
+    std::string out;
+    out.resize(length * 2);
+    for(size_t i = 0;i < length;++i){
+        out[i * 2] = kHexDigits[(data[i] >> 4) & 0x0F];
+        out[i * 2 + 1] = kHexDigits[data[i] & 0x0F];
+    }
+    return StarbytesStrNewWithData(out.c_str());
+}
+
+StarbytesObject toText(StarbytesObject bytesObject,std::string &errorOut){
+    errorOut.clear();
+    auto *data = StarbytesBytesGetData(bytesObject);
+    auto length = StarbytesBytesGetLength(bytesObject);
+    if(length > 0 && std::memchr(data,0,length) != nullptr){
+        errorOut = "Bytes.toText cannot decode data containing NUL bytes";
+        return nullptr;
+    }
+    std::string text(reinterpret_cast<const char *>(data),length);
+    return StarbytesStrNewWithData(text.c_str());
+}
+
+StarbytesObject fromString(StarbytesObject stringObject){
+    auto *text = StarbytesStrGetBuffer(stringObject);
+    return StarbytesBytesNewWithData(text,text ? std::strlen(text) : 0);
+}
+
+StarbytesObject fromArray(StarbytesObject arrayObject,std::string &errorOut){
+    errorOut.clear();
+    auto length = StarbytesArrayGetLength(arrayObject);
+    auto out = StarbytesBytesNew(length);
+    auto *data = StarbytesBytesGetData(out);
+    for(unsigned i = 0;i < length;++i){
+        auto value = StarbytesArrayIndex(arrayObject,i);
+        if(!value || !StarbytesObjectTypecheck(value,StarbytesNumType()) || StarbytesNumGetType(value) != NumTypeInt){
+            errorOut = "Array.toBytes expects Int elements";
+            StarbytesObjectRelease(out);
+            return nullptr;
+        }
+        auto byteValue = StarbytesNumGetIntValue(value);
+        if(byteValue < 0 || byteValue > 255){
+            errorOut = "Array.toBytes element out of byte range";
+            StarbytesObjectRelease(out);
+            return nullptr;
+        }
+        data[i] = (unsigned char)byteValue;
+    }
+    return out;
+}
+
+}
@@ -9,6 +9,7 @@
 #include "RTValue.h"
 #include "RTStdlib.h"
 #include "starbytes/runtime/RegexSupport.h"
+#include "starbytes/runtime/BytesSupport.h"
 #include "starbytes/base/ADT.h"
 #include "starbytes/base/Diagnostic.h"
 
@@ -169,6 +170,8 @@ static uint32_t regexCompileOptionsFromFlags(const std::string &flags){
 
 static constexpr unsigned kQuickeningInvocationThreshold = 4;
 static constexpr uint64_t kV2HotLoopThreshold = 8;
+/// Longest `await` sleeps between task driver runs; bounds the latency of drivers that poll.
+static constexpr int kTaskDriverWaitMillis = 10;
 
 
 class RTAllocator {
@@ -920,6 +923,7 @@ StarbytesObject InterpImpl::invokeBuiltinMember(std::istream &in,
 
     if(StarbytesObjectTypecheck(object,StarbytesStrType())
        || StarbytesObjectTypecheck(object,StarbytesRegexType())
+       || StarbytesObjectTypecheck(object,StarbytesBytesType())
        || StarbytesObjectTypecheck(object,StarbytesArrayType())
        || StarbytesObjectTypecheck(object,StarbytesDictType())){
         DirectArgBuffer argBuffer(argCount);
@@ -1187,6 +1191,15 @@ StarbytesObject InterpImpl::invokeBuiltinMember(std::istream &in,
                     StarbytesObjectRelease(object);
                     return StarbytesStrNewWithData(out.c_str());
                 }
+                case RTBUILTIN_MEMBER_STRING_TO_BYTES:
+                    if(argCount != 0){
+                        return failWithArgs("String.toBytes expects 0 arguments");
+                    }
+                    {
+                        auto out = bytes::fromString(object);
+                        StarbytesObjectRelease(object);
+                        return out;
+                    }
                 default:
                     discardExprArgs(in,argCount);
                     StarbytesObjectRelease(object);
@@ -1256,6 +1269,100 @@ StarbytesObject InterpImpl::invokeBuiltinMember(std::istream &in,
             }
         }
 
+        if(StarbytesObjectTypecheck(object,StarbytesBytesType())){
+            switch(memberId){
+                case RTBUILTIN_MEMBER_STRING_IS_EMPTY:
+                case RTBUILTIN_MEMBER_ARRAY_IS_EMPTY:
+                case RTBUILTIN_MEMBER_DICT_IS_EMPTY:
+                    if(argCount != 0){
+                        return failWithArgs("Bytes.isEmpty expects 0 arguments");
+                    }
+                    {
+                        auto isEmpty = StarbytesBytesGetLength(object) == 0;
+                        StarbytesObjectRelease(object);
+                        return StarbytesBoolNew((StarbytesBoolVal)isEmpty);
+                    }
+                case RTBUILTIN_MEMBER_STRING_AT:
+                case RTBUILTIN_MEMBER_ARRAY_AT: {
+                    if(argCount != 1 || !collectArgs()){
+                        return failWithArgs("Bytes.at expects 1 argument");
+                    }
+                    int index = 0;
+                    if(!expectIntArg(argBuffer.data()[0],index)){
+                        return failWithArgs("Bytes.at expects Int index");
+                    }
+                    std::string error;
+                    auto result = bytes::at(object,index,error);
+                    if(!result){
+                        return failWithArgs(error);
+                    }
+                    releaseArgs();
+                    StarbytesObjectRelease(object);
+                    return result;
+                }
+                case RTBUILTIN_MEMBER_STRING_SLICE:
+                case RTBUILTIN_MEMBER_ARRAY_SLICE: {
+                    if(argCount != 2 || !collectArgs()){
+                        return failWithArgs("Bytes.slice expects 2 arguments");
+                    }
+                    int start = 0;
+                    int end = 0;
+                    if(!expectIntArg(argBuffer.data()[0],start) || !expectIntArg(argBuffer.data()[1],end)){
+                        return failWithArgs("Bytes.slice expects Int bounds");
+                    }
+                    auto result = bytes::slice(object,start,end);
+                    releaseArgs();
+                    StarbytesObjectRelease(object);
+                    return result;
+                }
+                case RTBUILTIN_MEMBER_ARRAY_COPY:
+                case RTBUILTIN_MEMBER_DICT_COPY:
+                    if(argCount != 0){
+                        return failWithArgs("Bytes.copy expects 0 arguments");
+                    }
+                    {
+                        auto result = bytes::copy(object);
+                        StarbytesObjectRelease(object);
+                        return result;
+                    }
+                case RTBUILTIN_MEMBER_BYTES_TO_ARRAY:
+                    if(argCount != 0){
+                        return failWithArgs("Bytes.toArray expects 0 arguments");
+                    }
+                    {
+                        auto result = bytes::toArray(object);
+                        StarbytesObjectRelease(object);
+                        return result;
+                    }
+                case RTBUILTIN_MEMBER_BYTES_TO_HEX:
+                    if(argCount != 0){
+                        return failWithArgs("Bytes.toHex expects 0 arguments");
+                    }
+                    {
+                        auto result = bytes::toHex(object);
+                        StarbytesObjectRelease(object);
+                        return result;
+                    }
+                case RTBUILTIN_MEMBER_BYTES_TO_TEXT:
+                    if(argCount != 0){
+                        return failWithArgs("Bytes.toText expects 0 arguments");
+                    }
+                    {
+                        std::string error;
+                        auto result = bytes::toText(object,error);
+                        if(!result){
+                            return failWithArgs(error);
+                        }
+                        StarbytesObjectRelease(object);
+                        return result;
+                    }
+                default:
+                    discardExprArgs(in,argCount);
+                    StarbytesObjectRelease(object);
+                    return nullptr;
+            }
+        }
+
         if(StarbytesObjectTypecheck(object,StarbytesArrayType())){
             auto arrayLen = StarbytesArrayGetLength(object);
             switch(memberId){
@@ -1475,6 +1582,19 @@ StarbytesObject InterpImpl::invokeBuiltinMember(std::istream &in,
                         StarbytesObjectRelease(object);
                         return out;
                     }
+                case RTBUILTIN_MEMBER_STRING_TO_BYTES:
+                    if(argCount != 0){
+                        return failWithArgs("Array.toBytes expects 0 arguments");
+                    }
+                    {
+                        std::string error;
+                        auto out = bytes::fromArray(object,error);
+                        if(!out){
+                            return failWithArgs(error);
+                        }
+                        StarbytesObjectRelease(object);
+                        return out;
+                    }
                 default:
                     discardExprArgs(in,argCount);
                     StarbytesObjectRelease(object);
@@ -2258,6 +2378,60 @@ bool InterpImpl::buildV2ExecutionImage(const RTFuncTemplate *funcTemp,V2Executio
     };
     std::vector<JumpFixup> jumpFixups;
 
+    // Fused forms skip writing their intermediate slots, so only fuse when nothing else reads them
+    // and no jump lands inside the group (optimized images may share temporaries or retarget jumps).
+    std::vector<bool> isJumpTarget(source.size() + 1,false);
+    std::unordered_map<uint32_t,uint32_t> slotReadCounts;
+    for(const auto &instr : source){
+        switch(instr.opcode){
+            case RTV2_OP_MOVE:
+            case RTV2_OP_NUM_CAST:
+            case RTV2_OP_INTRINSIC_SQRT:
+                slotReadCounts[instr.b] += 1;
+                break;
+            case RTV2_OP_BINARY:
+            case RTV2_OP_COMPARE:
+            case RTV2_OP_ARRAY_GET:
+                slotReadCounts[instr.b] += 1;
+                slotReadCounts[instr.c] += 1;
+                break;
+            case RTV2_OP_ARRAY_SET:
+                slotReadCounts[instr.a] += 1;
+                slotReadCounts[instr.b] += 1;
+                slotReadCounts[instr.c] += 1;
+                break;
+            case RTV2_OP_CALL_DIRECT:
+                if(instr.b < funcTemp->v2Image.callSites.size()){
+                    for(auto slot : funcTemp->v2Image.callSites[instr.b].argSlots){
+                        slotReadCounts[slot] += 1;
+                    }
+                }
+                break;
+            case RTV2_OP_JUMP:
+                if(instr.a < isJumpTarget.size()){
+                    isJumpTarget[instr.a] = true;
+                }
+                break;
+            case RTV2_OP_JUMP_IF_FALSE:
+                slotReadCounts[instr.a] += 1;
+                if(instr.b < isJumpTarget.size()){
+                    isJumpTarget[instr.b] = true;
+                }
+                break;
+            case RTV2_OP_RETURN:
+                if(instr.a != UINT32_MAX){
+                    slotReadCounts[instr.a] += 1;
+                }
+                break;
+            default:
+                break;
+        }
+    }
+    auto readOnlyOnce = [&](uint32_t slot){
+        auto it = slotReadCounts.find(slot);
+        return it != slotReadCounts.end() && it->second == 1;
+    };
+
     auto installExecInstr = [&](const V2ExecInstruction &instr){
         imageOut.instructions.push_back(instr);
     };
@@ -2268,7 +2442,9 @@ bool InterpImpl::buildV2ExecutionImage(const RTFuncTemplate *funcTemp,V2Executio
         if(i + 1 < source.size()
            && source[i].opcode == RTV2_OP_COMPARE
            && source[i + 1].opcode == RTV2_OP_JUMP_IF_FALSE
-           && source[i + 1].a == source[i].a){
+           && source[i + 1].a == source[i].a
+           && !isJumpTarget[i + 1]
+           && readOnlyOnce(source[i].a)){
             V2ExecInstruction execInstr;
             execInstr.opcode = V2ExecOpcode::CompareJumpFalse;
             execInstr.kind = source[i].kind;
@@ -2290,7 +2466,9 @@ bool InterpImpl::buildV2ExecutionImage(const RTFuncTemplate *funcTemp,V2Executio
         if(i + 1 < source.size()
            && source[i].opcode == RTV2_OP_BINARY
            && source[i + 1].opcode == RTV2_OP_MOVE
-           && source[i + 1].b == source[i].a){
+           && source[i + 1].b == source[i].a
+           && !isJumpTarget[i + 1]
+           && readOnlyOnce(source[i].a)){
             V2ExecInstruction execInstr;
             execInstr.opcode = V2ExecOpcode::BinaryInplace;
             execInstr.kind = source[i].kind;
@@ -2317,7 +2495,11 @@ bool InterpImpl::buildV2ExecutionImage(const RTFuncTemplate *funcTemp,V2Executio
            && source[i + 2].a == source[i].b
            && source[i + 2].b == source[i].c
            && source[i].kind == source[i + 1].kind
-           && source[i].kind == source[i + 2].kind){
+           && source[i].kind == source[i + 2].kind
+           && !isJumpTarget[i + 1]
+           && !isJumpTarget[i + 2]
+           && readOnlyOnce(source[i].a)
+           && readOnlyOnce(source[i + 1].a)){
             V2ExecInstruction execInstr;
             execInstr.opcode = V2ExecOpcode::ArrayUpdate;
             execInstr.kind = source[i].kind;
@@ -4529,11 +4711,19 @@ StarbytesObject InterpImpl::evalExpr(std::istream & in){
                     return nullptr;
                 }
                 while(StarbytesTaskGetState(operand) == StarbytesTaskPending){
-                    if(microtaskQueue.empty()){
-                        lastRuntimeError = "await stalled on unresolved task";
+                    if(!microtaskQueue.empty()){
+                        processMicrotasks();
+                        continue;
+                    }
+                    if(!StarbytesRuntimeRunTaskDrivers()){
+                        if(StarbytesTaskGetState(operand) == StarbytesTaskPending){
+                            lastRuntimeError = "await stalled on unresolved task";
+                        }
                         break;
                     }
-                    processMicrotasks();
+                    if(microtaskQueue.empty() && StarbytesTaskGetState(operand) == StarbytesTaskPending){
+                        StarbytesRuntimeWaitForTaskDrivers(kTaskDriverWaitMillis);
+                    }
                 }
                 auto state = StarbytesTaskGetState(operand);
                 if(state == StarbytesTaskResolved){
@@ -4698,6 +4888,9 @@ StarbytesObject InterpImpl::evalExpr(std::istream & in){
                 else if(StarbytesObjectTypecheck(lhs,StarbytesBoolType()) && StarbytesObjectTypecheck(rhs,StarbytesBoolType())){
                     equals = ((bool)StarbytesBoolValue(lhs) == (bool)StarbytesBoolValue(rhs));
                 }
+                else if(StarbytesObjectTypecheck(lhs,StarbytesBytesType()) && StarbytesObjectTypecheck(rhs,StarbytesBytesType())){
+                    equals = (StarbytesBytesCompare(lhs,rhs) == COMPARE_EQUAL);
+                }
                 else {
                     equals = (lhs == rhs);
                 }
@@ -4991,6 +5184,9 @@ StarbytesObject InterpImpl::evalExpr(std::istream & in){
                 else if(targetType == "Task"){
                     matches = StarbytesObjectTypecheck(object,StarbytesTaskType());
                 }
+                else if(targetType == "Bytes"){
+                    matches = StarbytesObjectTypecheck(object,StarbytesBytesType());
+                }
                 else if(targetType == "__func__"){
                     matches = StarbytesObjectTypecheck(object,StarbytesFuncRefType());
                 }
@@ -5332,6 +5528,25 @@ StarbytesObject InterpImpl::evalExpr(std::istream & in){
                     (StarbytesObjectTypecheck(index,StarbytesStrType()) || StarbytesObjectTypecheck(index,StarbytesNumType()))){
                 result = StarbytesDictGet(collection,index);
             }
+            else if(StarbytesObjectTypecheck(collection,StarbytesBytesType()) &&
+                    StarbytesObjectTypecheck(index,StarbytesNumType())){
+                int idx = -1;
+                auto indexType = StarbytesNumGetType(index);
+                if(indexType == NumTypeInt){
+                    idx = StarbytesNumGetIntValue(index);
+                }
+                else if(indexType == NumTypeLong){
+                    idx = (int)StarbytesNumGetLongValue(index);
+                }
+                std::string error;
+                auto byteValue = bytes::at(collection,idx,error);
+                if(!byteValue){
+                    lastRuntimeError = error;
+                }
+                StarbytesObjectRelease(collection);
+                StarbytesObjectRelease(index);
+                return byteValue;
+            }
             if(result){
                 StarbytesObjectReference(result);
             }
@@ -5637,6 +5852,10 @@ StarbytesObject InterpImpl::evalExpr(std::istream & in){
                     else if(StarbytesObjectTypecheck(object,StarbytesDictType())){
                         value = StarbytesNumNew(NumTypeInt,(int)StarbytesDictGetLength(object));
                     }
+                    else if(StarbytesObjectTypecheck(object,StarbytesBytesType())){
+                        auto length = StarbytesBytesGetLength(object);
+                        value = StarbytesNumNew(NumTypeInt,length > (size_t)std::numeric_limits<int>::max() ? std::numeric_limits<int>::max() : (int)length);
+                    }
                     if(value && feedbackSite
                        && (receiverKind == CachedReceiverKind::String
                            || receiverKind == CachedReceiverKind::Array
@@ -5726,6 +5945,7 @@ StarbytesObject InterpImpl::evalExpr(std::istream & in){
 
             std::string memberName = rtidToString(memberId);
             if((StarbytesObjectTypecheck(object,StarbytesStrType()) ||
+                StarbytesObjectTypecheck(object,StarbytesBytesType()) ||
                 StarbytesObjectTypecheck(object,StarbytesArrayType()) ||
                 StarbytesObjectTypecheck(object,StarbytesDictType())) &&
                (memberName == "length" || memberName == "keys" || memberName == "values")){
@@ -5883,6 +6103,7 @@ StarbytesObject InterpImpl::evalExpr(std::istream & in){
 
             if(StarbytesObjectTypecheck(object,StarbytesStrType()) ||
                StarbytesObjectTypecheck(object,StarbytesRegexType()) ||
+               StarbytesObjectTypecheck(object,StarbytesBytesType()) ||
                StarbytesObjectTypecheck(object,StarbytesArrayType()) ||
                StarbytesObjectTypecheck(object,StarbytesDictType())){
                 std::vector<StarbytesObject> args;
@@ -6081,6 +6302,14 @@ StarbytesObject InterpImpl::evalExpr(std::istream & in){
                         StarbytesObjectRelease(object);
                         return StarbytesStrNewWithData(out.c_str());
                     }
+                    if(methodName == "toBytes"){
+                        if(argCount != 0){
+                            return failWithArgs("String.toBytes expects 0 arguments");
+                        }
+                        auto out = bytes::fromString(object);
+                        StarbytesObjectRelease(object);
+                        return out;
+                    }
                     discardExprArgs(in,argCount);
                     StarbytesObjectRelease(object);
                     return nullptr;
@@ -6153,6 +6382,75 @@ StarbytesObject InterpImpl::evalExpr(std::istream & in){
                     return nullptr;
                 }
 
+                if(StarbytesObjectTypecheck(object,StarbytesBytesType())){
+                    if(methodName == "isEmpty"){
+                        if(argCount != 0){
+                            return failWithArgs("Bytes.isEmpty expects 0 arguments");
+                        }
+                        auto isEmpty = StarbytesBytesGetLength(object) == 0;
+                        StarbytesObjectRelease(object);
+                        return StarbytesBoolNew((StarbytesBoolVal)isEmpty);
+                    }
+                    if(methodName == "at"){
+                        if(argCount != 1 || !collectArgs(args)){
+                            return failWithArgs("Bytes.at expects 1 argument");
+                        }
+                        int index = 0;
+                        if(!expectIntArg(args[0],index)){
+                            return failWithArgs("Bytes.at expects Int index");
+                        }
+                        std::string error;
+                        auto result = bytes::at(object,index,error);
+                        if(!result){
+                            return failWithArgs(error);
+                        }
+                        releaseArgs(args);
+                        StarbytesObjectRelease(object);
+                        return result;
+                    }
+                    if(methodName == "slice"){
+                        if(argCount != 2 || !collectArgs(args)){
+                            return failWithArgs("Bytes.slice expects 2 arguments");
+                        }
+                        int start = 0;
+                        int end = 0;
+                        if(!expectIntArg(args[0],start) || !expectIntArg(args[1],end)){
+                            return failWithArgs("Bytes.slice expects Int bounds");
+                        }
+                        auto result = bytes::slice(object,start,end);
+                        releaseArgs(args);
+                        StarbytesObjectRelease(object);
+                        return result;
+                    }
+                    if(methodName == "copy" || methodName == "toArray" || methodName == "toHex" || methodName == "toText"){
+                        if(argCount != 0){
+                            return failWithArgs("Bytes." + methodName + " expects 0 arguments");
+                        }
+                        std::string error;
+                        StarbytesObject result = nullptr;
+                        if(methodName == "copy"){
+                            result = bytes::copy(object);
+                        }
+                        else if(methodName == "toArray"){
+                            result = bytes::toArray(object);
+                        }
+                        else if(methodName == "toHex"){
+                            result = bytes::toHex(object);
+                        }
+                        else {
+                            result = bytes::toText(object,error);
+                        }
+                        if(!result){
+                            return failWithArgs(error);
+                        }
+                        StarbytesObjectRelease(object);
+                        return result;
+                    }
+                    discardExprArgs(in,argCount);
+                    StarbytesObjectRelease(object);
+                    return nullptr;
+                }
+
                 if(StarbytesObjectTypecheck(object,StarbytesArrayType())){
                     auto arrayLen = StarbytesArrayGetLength(object);
                     if(methodName == "isEmpty"){
@@ -6363,6 +6661,18 @@ StarbytesObject InterpImpl::evalExpr(std::istream & in){
                         StarbytesObjectRelease(object);
                         return out;
                     }
+                    if(methodName == "toBytes"){
+                        if(argCount != 0){
+                            return failWithArgs("Array.toBytes expects 0 arguments");
+                        }
+                        std::string error;
+                        auto out = bytes::fromArray(object,error);
+                        if(!out){
+                            return failWithArgs(error);
+                        }
+                        StarbytesObjectRelease(object);
+                        return out;
+                    }
                     discardExprArgs(in,argCount);
                     StarbytesObjectRelease(object);
                     return nullptr;
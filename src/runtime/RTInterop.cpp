@@ -3,7 +3,10 @@
 #include "starbytes/base/ADT.h"
 #include <new>
 #include <algorithm>
+#include <chrono>
+#include <condition_variable>
 #include <cstring>
+#include <mutex>
 #include <string>
 
 #if defined(__ELF__) | defined(__MACH__)
@@ -27,6 +30,38 @@ void CStringFree(const char *buf){
     delete [] buf;
 }
 
+namespace {
+
+struct TaskDriverSignal {
+    std::mutex mutex;
+    std::condition_variable ready;
+    bool signalled = false;
+};
+
+/// Never destroyed, so worker threads still running at exit can signal it.
+TaskDriverSignal &taskDriverSignal(){
+    static auto *signal = new TaskDriverSignal();
+    return *signal;
+}
+
+}
+
+void StarbytesRuntimeSignalTaskDrivers(void){
+    auto &signal = taskDriverSignal();
+    {
+        std::lock_guard<std::mutex> lock(signal.mutex);
+        signal.signalled = true;
+    }
+    signal.ready.notify_one();
+}
+
+void StarbytesRuntimeWaitForTaskDrivers(int timeoutMillis){
+    auto &signal = taskDriverSignal();
+    std::unique_lock<std::mutex> lock(signal.mutex);
+    signal.ready.wait_for(lock,std::chrono::milliseconds(timeoutMillis),[&]{ return signal.signalled; });
+    signal.signalled = false;
+}
+
 
 namespace starbytes::Runtime {
 
@@ -29,6 +29,13 @@ typedef struct {
     char *error;
 } StarbytesTaskPriv;
 
+typedef struct {
+    unsigned char *data;
+    size_t length;
+    /// Buffer that owns `data` when this object is a slice, NULL when it owns `data` itself.
+    struct _StarbytesObject *owner;
+} StarbytesBytesPriv;
+
 
 
 
@@ -47,6 +54,7 @@ struct _StarbytesObject {
         StarbytesBoolPriv boolean;
         StarbytesFuncRefPriv funcRef;
         StarbytesTaskPriv task;
+        StarbytesBytesPriv bytes;
     } inlinePayload;
     
 };
@@ -94,6 +102,9 @@ static StarbytesRuntimeObjectKind StarbytesRuntimeObjectKindFromType(StarbytesCl
     if(type == StarbytesTaskType()){
         return StarbytesRuntimeObjectKindTask;
     }
+    if(type == StarbytesBytesType()){
+        return StarbytesRuntimeObjectKindBytes;
+    }
     return StarbytesRuntimeObjectKindCustomClass;
 }
 
@@ -227,6 +238,10 @@ static StarbytesTaskPriv *StarbytesTaskGetPriv(StarbytesTask task){
     return task ? &task->inlinePayload.task : NULL;
 }
 
+static StarbytesBytesPriv *StarbytesBytesGetPriv(StarbytesBytes bytes){
+    return (bytes && bytes->type == StarbytesBytesType()) ? &bytes->inlinePayload.bytes : NULL;
+}
+
 static void StarbytesReleaseInlinePayload(StarbytesObject obj){
     if(obj == NULL){
         return;
@@ -242,6 +257,18 @@ static void StarbytesReleaseInlinePayload(StarbytesObject obj){
         }
         obj->inlinePayload.task.state = StarbytesTaskRejected;
     }
+    else if(obj->type == StarbytesBytesType()){
+        StarbytesBytesPriv *priv = &obj->inlinePayload.bytes;
+        if(priv->owner != NULL){
+            StarbytesObjectRelease(priv->owner);
+            priv->owner = NULL;
+        }
+        else {
+            free(priv->data);
+        }
+        priv->data = NULL;
+        priv->length = 0;
+    }
 }
 
 typedef struct {
@@ -449,6 +476,10 @@ size_t StarbytesTaskType(){
     return 8;
 }
 
+size_t StarbytesBytesType(){
+    return 9;
+}
+
 int StarbytesObjectIs(StarbytesObject obj){
     if(obj == NULL){
         return 0;
@@ -460,7 +491,8 @@ int StarbytesObjectIs(StarbytesObject obj){
         || (obj->type == StarbytesBoolType())
         || (obj->type == StarbytesFuncRefType())
         || (obj->type == StarbytesRegexType())
-        || (obj->type == StarbytesTaskType());
+        || (obj->type == StarbytesTaskType())
+        || (obj->type == StarbytesBytesType());
 };
 
 
@@ -561,6 +593,26 @@ void StarbytesObjectRelease(StarbytesObject obj){
 }
 
 
+int StarbytesObjectSetNativeData(StarbytesObject obj,void *data,void (*finalizer)(void *)){
+    if(obj == NULL || StarbytesObjectIs(obj) || StarbytesObjectHasClassFieldLayout(obj)){
+        return 0;
+    }
+    if(obj->freePrivData){
+        obj->freePrivData(obj->privData);
+    }
+    obj->privData = data;
+    obj->freePrivData = finalizer;
+    return 1;
+}
+
+void *StarbytesObjectGetNativeData(StarbytesObject obj,void (*finalizer)(void *)){
+    if(obj == NULL || finalizer == NULL || StarbytesObjectIs(obj) || obj->freePrivData != finalizer){
+        return NULL;
+    }
+    return obj->privData;
+}
+
+
 /// Custom Class
 
 StarbytesObject StarbytesClassObjectNew(StarbytesClassType type){
@@ -1507,6 +1559,39 @@ int StarbytesArrayTryGetNumeric(StarbytesArray array,unsigned int index,Starbyte
     return 1;
 }
 
+const void *StarbytesArrayGetNumericData(StarbytesArray array,StarbytesNumT *typeOut){
+    StarbytesArrayPriv *priv = (StarbytesArrayPriv *)array->privData;
+    if(priv->length == 0 || !StarbytesArrayKindIsNumeric(priv->storageKind)){
+        return NULL;
+    }
+    if(typeOut != NULL){
+        *typeOut = StarbytesNumTypeFromArrayKind(priv->storageKind);
+    }
+    return priv->data;
+}
+
+StarbytesArray StarbytesArrayNewNumeric(StarbytesNumT type,const void *data,unsigned int length){
+    StarbytesArray array = StarbytesArrayNew();
+    StarbytesArrayPriv *priv = (StarbytesArrayPriv *)array->privData;
+    size_t elementSize;
+    if(length == 0){
+        return array;
+    }
+    StarbytesArrayAdoptNumericKind(priv,StarbytesArrayKindFromNumType(type));
+    if(!StarbytesArrayEnsureCapacity(priv,length)){
+        return array;
+    }
+    elementSize = StarbytesArrayElementSize(priv->storageKind);
+    if(data != NULL){
+        memcpy(priv->data,data,elementSize * length);
+    }
+    else {
+        memset(priv->data,0,elementSize * length);
+    }
+    StarbytesArraySyncLength(array,length);
+    return array;
+}
+
 int StarbytesArrayTrySetNumeric(StarbytesArray array,unsigned int index,StarbytesNumT valueType,long double value){
     StarbytesArrayPriv *priv = (StarbytesArrayPriv *)array->privData;
     StarbytesArrayStorageKind incomingKind = StarbytesArrayKindFromNumType(valueType);
@@ -1748,3 +1833,106 @@ CString StarbytesTaskGetError(StarbytesTask task){
     }
     return privData->error;
 }
+
+#define STARBYTES_MAX_TASK_DRIVERS 16
+
+static StarbytesTaskDriver taskDrivers[STARBYTES_MAX_TASK_DRIVERS];
+static unsigned taskDriverCount = 0;
+
+void StarbytesRuntimeAddTaskDriver(StarbytesTaskDriver driver){
+    if(!driver){
+        return;
+    }
+    for(unsigned i = 0;i < taskDriverCount;++i){
+        if(taskDrivers[i] == driver){
+            return;
+        }
+    }
+    if(taskDriverCount < STARBYTES_MAX_TASK_DRIVERS){
+        taskDrivers[taskDriverCount++] = driver;
+    }
+}
+
+int StarbytesRuntimeRunTaskDrivers(void){
+    int active = 0;
+    for(unsigned i = 0;i < taskDriverCount;++i){
+        if(taskDrivers[i]() != 0){
+            active = 1;
+        }
+    }
+    return active;
+}
+
+StarbytesBytes StarbytesBytesNew(size_t length){
+    unsigned char *data = (unsigned char *)calloc(length > 0 ? length : 1,1);
+    if(data == NULL){
+        return NULL;
+    }
+    StarbytesObject obj = StarbytesObjectNew(StarbytesBytesType());
+    obj->inlinePayload.bytes.data = data;
+    obj->inlinePayload.bytes.length = length;
+    obj->inlinePayload.bytes.owner = NULL;
+    return obj;
+}
+
+StarbytesBytes StarbytesBytesNewWithData(const void *data,size_t length){
+    StarbytesBytes bytes = StarbytesBytesNew(length);
+    if(bytes != NULL && data != NULL && length > 0){
+        memcpy(bytes->inlinePayload.bytes.data,data,length);
+    }
+    return bytes;
+}
+
+StarbytesBytes StarbytesBytesSlice(StarbytesBytes bytes,size_t offset,size_t length){
+    StarbytesBytesPriv *source = StarbytesBytesGetPriv(bytes);
+    if(source == NULL){
+        return NULL;
+    }
+    if(offset > source->length){
+        offset = source->length;
+    }
+    if(length > source->length - offset){
+        length = source->length - offset;
+    }
+    StarbytesObject owner = source->owner != NULL ? source->owner : bytes;
+    StarbytesObjectReference(owner);
+    StarbytesObject obj = StarbytesObjectNew(StarbytesBytesType());
+    obj->inlinePayload.bytes.data = source->data + offset;
+    obj->inlinePayload.bytes.length = length;
+    obj->inlinePayload.bytes.owner = owner;
+    return obj;
+}
+
+unsigned char *StarbytesBytesGetData(StarbytesBytes bytes){
+    StarbytesBytesPriv *priv = StarbytesBytesGetPriv(bytes);
+    return priv ? priv->data : NULL;
+}
+
+size_t StarbytesBytesGetLength(StarbytesBytes bytes){
+    StarbytesBytesPriv *priv = StarbytesBytesGetPriv(bytes);
+    return priv ? priv->length : 0;
+}
+
+void StarbytesBytesTruncate(StarbytesBytes bytes,size_t length){
+    StarbytesBytesPriv *priv = StarbytesBytesGetPriv(bytes);
+    if(priv != NULL && length < priv->length){
+        priv->length = length;
+    }
+}
+
+int StarbytesBytesCompare(StarbytesBytes lhs,StarbytesBytes rhs){
+    StarbytesBytesPriv *lhsPriv = StarbytesBytesGetPriv(lhs);
+    StarbytesBytesPriv *rhsPriv = StarbytesBytesGetPriv(rhs);
+    if(lhsPriv == NULL || rhsPriv == NULL){
+        return COMPARE_NOTEQUAL;
+    }
+    size_t common = lhsPriv->length < rhsPriv->length ? lhsPriv->length : rhsPriv->length;
+    int cmp = common > 0 ? memcmp(lhsPriv->data,rhsPriv->data,common) : 0;
+    if(cmp == 0){
+        if(lhsPriv->length == rhsPriv->length){
+            return COMPARE_EQUAL;
+        }
+        return lhsPriv->length < rhsPriv->length ? COMPARE_LESS : COMPARE_GREATER;
+    }
+    return cmp < 0 ? COMPARE_LESS : COMPARE_GREATER;
+}
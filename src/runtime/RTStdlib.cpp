@@ -162,6 +162,9 @@ namespace starbytes {
                     auto flags = flagsObj ? StarbytesStrGetBuffer(flagsObj) : (char *)"";
                     std::cout << "\x1b[36m" << "/" << pattern << "/" << flags << "\x1b[0m" << std::flush;
                 }
+            else if(StarbytesObjectTypecheck(object,StarbytesBytesType())){
+                    std::cout << "\x1b[36m" << "<Bytes " << StarbytesBytesGetLength(object) << ">" << "\x1b[0m" << std::flush;
+                }
             else if(StarbytesObjectTypecheck(object,StarbytesTaskType())){
                     auto state = StarbytesTaskGetState(object);
                     if(state == StarbytesTaskPending){
@@ -97,6 +97,9 @@ std::string objectToString(StarbytesObject object){
         std::string f = flags ? std::string(StarbytesStrGetBuffer(flags)) : "";
         return "/" + p + "/" + f;
     }
+    if(StarbytesObjectTypecheck(object, StarbytesBytesType())){
+        return "<Bytes " + std::to_string(StarbytesBytesGetLength(object)) + ">";
+    }
     return "<object>";
 }
 
@@ -113,6 +116,9 @@ bool runtimeObjectEquals(StarbytesObject lhs, StarbytesObject rhs){
     if(StarbytesObjectTypecheck(lhs, StarbytesBoolType()) && StarbytesObjectTypecheck(rhs, StarbytesBoolType())){
         return (bool)StarbytesBoolValue(lhs) == (bool)StarbytesBoolValue(rhs);
     }
+    if(StarbytesObjectTypecheck(lhs, StarbytesBytesType()) && StarbytesObjectTypecheck(rhs, StarbytesBytesType())){
+        return StarbytesBytesCompare(lhs, rhs) == COMPARE_EQUAL;
+    }
     return lhs == rhs;
 }
 
@@ -13,7 +13,9 @@
 
 namespace {
 
+using starbytes::Runtime::stdlib::ByteView;
 using starbytes::Runtime::stdlib::failNativeIfEmpty;
+using starbytes::Runtime::stdlib::readByteView;
 using starbytes::Runtime::stdlib::setNativeErrorIfEmpty;
 
 struct NativeArgsLayout {
@@ -22,14 +24,19 @@ struct NativeArgsLayout {
     StarbytesObject *argv = nullptr;
 };
 
+/// Entry values are borrowed from the Dict being packed.
 struct EntryPayload {
     std::string name;
-    std::vector<unsigned char> bytes;
+    const unsigned char *data = nullptr;
+    size_t length = 0;
 };
 
 struct DecodedEntry {
     std::string name;
     std::string value;
+    size_t storedOffset = 0;
+    size_t storedLength = 0;
+    bool compressed = false;
 };
 
 constexpr char kMagic[] = "STRBARC1";
@@ -103,8 +110,8 @@ void writeU64(std::vector<unsigned char> &out,uint64_t value) {
     out.push_back((unsigned char)((value >> 56u) & 0xFFu));
 }
 
-bool readU16(const std::vector<unsigned char> &in,size_t &index,uint16_t &outValue) {
-    if(index + 2 > in.size()) {
+bool readU16(const unsigned char *in,size_t size,size_t &index,uint16_t &outValue) {
+    if(index + 2 > size) {
         return false;
     }
     outValue = (uint16_t)in[index] | (uint16_t)(in[index + 1] << 8u);
@@ -112,8 +119,8 @@ bool readU16(const std::vector<unsigned char> &in,size_t &index,uint16_t &outVal
     return true;
 }
 
-bool readU32(const std::vector<unsigned char> &in,size_t &index,uint32_t &outValue) {
-    if(index + 4 > in.size()) {
+bool readU32(const unsigned char *in,size_t size,size_t &index,uint32_t &outValue) {
+    if(index + 4 > size) {
         return false;
     }
     outValue = (uint32_t)in[index]
@@ -124,8 +131,8 @@ bool readU32(const std::vector<unsigned char> &in,size_t &index,uint32_t &outVal
     return true;
 }
 
-bool readU64(const std::vector<unsigned char> &in,size_t &index,uint64_t &outValue) {
-    if(index + 8 > in.size()) {
+bool readU64(const unsigned char *in,size_t size,size_t &index,uint64_t &outValue) {
+    if(index + 8 > size) {
         return false;
     }
     outValue = (uint64_t)in[index]
@@ -180,7 +187,7 @@ bool hexToBytes(const std::string &hex,std::vector<unsigned char> &outBytes) {
     return true;
 }
 
-bool readDictStringEntries(StarbytesObject dict,std::vector<EntryPayload> &outEntries) {
+bool readDictEntries(StarbytesObject dict,bool allowBytes,std::vector<EntryPayload> &outEntries) {
     if(!dict || !StarbytesObjectTypecheck(dict,StarbytesDictType())) {
         return false;
     }
@@ -201,31 +208,38 @@ bool readDictStringEntries(StarbytesObject dict,std::vector<EntryPayload> &outEn
     for(unsigned i = 0; i < len; ++i) {
         auto key = StarbytesArrayIndex(keys,i);
         auto value = StarbytesArrayIndex(values,i);
-        if(!key || !value || !StarbytesObjectTypecheck(key,StarbytesStrType()) || !StarbytesObjectTypecheck(value,StarbytesStrType())) {
+        if(!key || !value || !StarbytesObjectTypecheck(key,StarbytesStrType())) {
+            return false;
+        }
+        bool isBytes = StarbytesObjectTypecheck(value,StarbytesBytesType());
+        if(!StarbytesObjectTypecheck(value,StarbytesStrType()) && !(allowBytes && isBytes)) {
             return false;
         }
 
         auto *keyBuf = StarbytesStrGetBuffer(key);
-        auto *valueBuf = StarbytesStrGetBuffer(value);
+        ByteView valueView;
+        if(!readByteView(value,valueView)) {
+            return false;
+        }
         std::string keyText = keyBuf ? keyBuf : "";
-        std::string valueText = valueBuf ? valueBuf : "";
-        if(keyText.empty() || keyText.size() > kMaxEntryNameBytes || valueText.size() > kMaxEntryValueBytes) {
+        if(keyText.empty() || keyText.size() > kMaxEntryNameBytes || valueView.length > kMaxEntryValueBytes) {
             return false;
         }
 
         EntryPayload entry;
         entry.name = keyText;
-        entry.bytes.assign(valueText.begin(),valueText.end());
+        entry.data = valueView.data;
+        entry.length = valueView.length;
         outEntries.push_back(std::move(entry));
     }
     return true;
 }
 
-bool compressEntry(const std::vector<unsigned char> &input,std::vector<unsigned char> &out,bool &usedCompression) {
+bool compressEntry(const unsigned char *input,size_t inputLength,std::vector<unsigned char> &out,bool &usedCompression) {
     usedCompression = false;
 
 #ifdef STARBYTES_HAS_ZLIB
-    if(input.size() > (size_t)UINT32_MAX) {
+    if(inputLength > (size_t)UINT32_MAX) {
         return false;
     }
 
@@ -234,8 +248,8 @@ bool compressEntry(const std::vector<unsigned char> &input,std::vector<unsigned
         return false;
     }
 
-    stream.next_in = (Bytef *)(input.empty() ? nullptr : input.data());
-    stream.avail_in = (uInt)input.size();
+    stream.next_in = (Bytef *)(inputLength == 0 ? nullptr : input);
+    stream.avail_in = (uInt)inputLength;
     out.clear();
 
     int ret = Z_OK;
@@ -260,28 +274,27 @@ bool compressEntry(const std::vector<unsigned char> &input,std::vector<unsigned
     }
 
     deflateEnd(&stream);
-    usedCompression = out.size() < input.size();
-    if(!usedCompression) {
-        out = input;
-    }
+    usedCompression = out.size() < inputLength;
     return true;
 #else
-    out = input;
+    (void)input;
+    (void)inputLength;
+    (void)out;
     return true;
 #endif
 }
 
-bool inflateEntry(const std::vector<unsigned char> &input,uint64_t originalSize,std::vector<unsigned char> &out) {
+bool inflateEntry(const unsigned char *input,size_t inputLength,uint64_t originalSize,std::string &out) {
     if(originalSize > kMaxEntryValueBytes) {
         return false;
     }
 
 #ifdef STARBYTES_HAS_ZLIB
-    if(input.empty()) {
+    if(inputLength == 0) {
         out.clear();
         return originalSize == 0;
     }
-    if(input.size() > (size_t)UINT32_MAX) {
+    if(inputLength > (size_t)UINT32_MAX) {
         return false;
     }
 
@@ -291,14 +304,14 @@ bool inflateEntry(const std::vector<unsigned char> &input,uint64_t originalSize,
     }
 
     out.clear();
-    stream.next_in = (Bytef *)input.data();
-    stream.avail_in = (uInt)input.size();
+    stream.next_in = (Bytef *)input;
+    stream.avail_in = (uInt)inputLength;
 
     int ret = Z_OK;
     while(ret != Z_STREAM_END) {
         size_t prior = out.size();
         out.resize(prior + kChunkSize);
-        stream.next_out = reinterpret_cast<Bytef *>(out.data() + prior);
+        stream.next_out = reinterpret_cast<Bytef *>(&out[prior]);
         stream.avail_out = (uInt)kChunkSize;
 
         ret = inflate(&stream,Z_NO_FLUSH);
@@ -318,17 +331,20 @@ bool inflateEntry(const std::vector<unsigned char> &input,uint64_t originalSize,
     return out.size() == originalSize;
 #else
     (void)input;
+    (void)inputLength;
     (void)originalSize;
     (void)out;
     return false;
 #endif
 }
 
-bool parseArchive(const std::vector<unsigned char> &blob,std::vector<DecodedEntry> &entries,bool materializeValues) {
-    if(blob.size() < kMagicLen + 2 + 2 + 4 || blob.size() > kMaxArchiveBytes) {
+/// Parses an archive in place. Compressed entries are always inflated so the archive is fully
+/// validated; stored entries are copied into `value` only when `materializeValues` is set.
+bool parseArchive(const unsigned char *blob,size_t size,std::vector<DecodedEntry> &entries,bool materializeValues) {
+    if(size < kMagicLen + 2 + 2 + 4 || size > kMaxArchiveBytes) {
         return false;
     }
-    if(std::memcmp(blob.data(),kMagic,kMagicLen) != 0) {
+    if(std::memcmp(blob,kMagic,kMagicLen) != 0) {
         return false;
     }
 
@@ -336,7 +352,7 @@ bool parseArchive(const std::vector<unsigned char> &blob,std::vector<DecodedEntr
     uint16_t version = 0;
     uint16_t archiveFlags = 0;
     uint32_t entryCount = 0;
-    if(!readU16(blob,index,version) || !readU16(blob,index,archiveFlags) || !readU32(blob,index,entryCount)) {
+    if(!readU16(blob,size,index,version) || !readU16(blob,size,index,archiveFlags) || !readU32(blob,size,index,entryCount)) {
         return false;
     }
     (void)archiveFlags;
@@ -351,29 +367,31 @@ bool parseArchive(const std::vector<unsigned char> &blob,std::vector<DecodedEntr
         uint64_t originalLen = 0;
         uint64_t storedLen = 0;
         uint32_t flags = 0;
-        if(!readU32(blob,index,nameLen) || !readU64(blob,index,originalLen) || !readU64(blob,index,storedLen) || !readU32(blob,index,flags)) {
+        if(!readU32(blob,size,index,nameLen) || !readU64(blob,size,index,originalLen)
+           || !readU64(blob,size,index,storedLen) || !readU32(blob,size,index,flags)) {
             return false;
         }
 
         if(nameLen == 0 || nameLen > kMaxEntryNameBytes || originalLen > kMaxEntryValueBytes || storedLen > kMaxEntryValueBytes) {
             return false;
         }
-        if(index + nameLen > blob.size()) {
+        if(index + nameLen > size) {
             return false;
         }
-        std::string name(reinterpret_cast<const char *>(blob.data() + index),nameLen);
+        DecodedEntry entry;
+        entry.name.assign(reinterpret_cast<const char *>(blob + index),nameLen);
         index += nameLen;
 
-        if(index + storedLen > blob.size()) {
+        if(index + storedLen > size) {
             return false;
         }
-        std::vector<unsigned char> stored(blob.begin() + static_cast<std::vector<unsigned char>::difference_type>(index),
-                                          blob.begin() + static_cast<std::vector<unsigned char>::difference_type>(index + storedLen));
+        entry.storedOffset = index;
+        entry.storedLength = (size_t)storedLen;
+        entry.compressed = (flags & kFlagEntryCompressed) != 0;
         index += (size_t)storedLen;
 
-        std::vector<unsigned char> valueBytes;
-        if((flags & kFlagEntryCompressed) != 0) {
-            if(!inflateEntry(stored,originalLen,valueBytes)) {
+        if(entry.compressed) {
+            if(!inflateEntry(blob + entry.storedOffset,entry.storedLength,originalLen,entry.value)) {
                 return false;
             }
         }
@@ -381,61 +399,77 @@ bool parseArchive(const std::vector<unsigned char> &blob,std::vector<DecodedEntr
             if(originalLen != storedLen) {
                 return false;
             }
-            valueBytes = std::move(stored);
-        }
-
-        DecodedEntry entry;
-        entry.name = std::move(name);
-        if(materializeValues) {
-            entry.value.assign(valueBytes.begin(),valueBytes.end());
+            if(materializeValues) {
+                entry.value.assign(reinterpret_cast<const char *>(blob + entry.storedOffset),entry.storedLength);
+            }
         }
         entries.push_back(std::move(entry));
     }
 
-    return index == blob.size();
+    return index == size;
 }
 
-STARBYTES_FUNC(archive_packTextMapHex) {
-    skipOptionalModuleReceiver(args,2);
-
-    auto dictArg = StarbytesFuncArgsGetArg(args);
-    bool compress = false;
-    if(!readBoolArg(args,compress)) {
-        return nullptr;
-    }
-
-    std::vector<EntryPayload> entries;
-    if(!readDictStringEntries(dictArg,entries)) {
-        return failNativeIfEmpty(args,"packTextMapHex requires Dict<String,String> entries");
-    }
-
-    std::vector<unsigned char> archiveBytes;
+/// Serializes entries into the archive format; `name` prefixes error messages.
+bool buildArchive(const std::vector<EntryPayload> &entries,
+                  bool compress,
+                  const char *name,
+                  std::vector<unsigned char> &archiveBytes,
+                  std::string &error) {
+    archiveBytes.clear();
     archiveBytes.reserve(1024);
     archiveBytes.insert(archiveBytes.end(),kMagic,kMagic + kMagicLen);
     writeU16(archiveBytes,kVersion);
     writeU16(archiveBytes,0);
     writeU32(archiveBytes,(uint32_t)entries.size());
 
+    std::vector<unsigned char> compressed;
     for(const auto &entry : entries) {
-        std::vector<unsigned char> payload = entry.bytes;
         bool usedCompression = false;
         if(compress) {
-            if(!compressEntry(entry.bytes,payload,usedCompression)) {
-                return failNativeIfEmpty(args,"packTextMapHex failed to compress archive entry");
+            if(!compressEntry(entry.data,entry.length,compressed,usedCompression)) {
+                error = std::string(name) + " failed to compress archive entry";
+                return false;
             }
         }
+        const unsigned char *payload = usedCompression ? compressed.data() : entry.data;
+        size_t payloadLength = usedCompression ? compressed.size() : entry.length;
 
         writeU32(archiveBytes,(uint32_t)entry.name.size());
-        writeU64(archiveBytes,(uint64_t)entry.bytes.size());
-        writeU64(archiveBytes,(uint64_t)payload.size());
+        writeU64(archiveBytes,(uint64_t)entry.length);
+        writeU64(archiveBytes,(uint64_t)payloadLength);
         writeU32(archiveBytes,usedCompression ? kFlagEntryCompressed : 0u);
         archiveBytes.insert(archiveBytes.end(),entry.name.begin(),entry.name.end());
-        archiveBytes.insert(archiveBytes.end(),payload.begin(),payload.end());
+        if(payloadLength > 0) {
+            archiveBytes.insert(archiveBytes.end(),payload,payload + payloadLength);
+        }
 
         if(archiveBytes.size() > kMaxArchiveBytes) {
-            return failNativeIfEmpty(args,"packTextMapHex exceeded archive size limit");
+            error = std::string(name) + " exceeded archive size limit";
+            return false;
         }
     }
+    return true;
+}
+
+STARBYTES_FUNC(archive_packTextMapHex) {
+    skipOptionalModuleReceiver(args,2);
+
+    auto dictArg = StarbytesFuncArgsGetArg(args);
+    bool compress = false;
+    if(!readBoolArg(args,compress)) {
+        return nullptr;
+    }
+
+    std::vector<EntryPayload> entries;
+    if(!readDictEntries(dictArg,false,entries)) {
+        return failNativeIfEmpty(args,"packTextMapHex requires Dict<String,String> entries");
+    }
+
+    std::vector<unsigned char> archiveBytes;
+    std::string error;
+    if(!buildArchive(entries,compress,"packTextMapHex",archiveBytes,error)) {
+        return failNativeIfEmpty(args,error);
+    }
 
     auto hex = bytesToHex(archiveBytes);
     return StarbytesStrNewWithData(hex.c_str());
@@ -455,7 +489,7 @@ STARBYTES_FUNC(archive_unpackTextMapHex) {
     }
 
     std::vector<DecodedEntry> entries;
-    if(!parseArchive(blob,entries,true)) {
+    if(!parseArchive(blob.data(),blob.size(),entries,true)) {
         return failNativeIfEmpty(args,"unpackTextMapHex failed to decode archive");
     }
 
@@ -482,7 +516,7 @@ STARBYTES_FUNC(archive_listEntries) {
     }
 
     std::vector<DecodedEntry> entries;
-    if(!parseArchive(blob,entries,false)) {
+    if(!parseArchive(blob.data(),blob.size(),entries,false)) {
         return failNativeIfEmpty(args,"listEntries failed to decode archive");
     }
 
@@ -507,7 +541,79 @@ STARBYTES_FUNC(archive_isValid) {
     }
 
     std::vector<DecodedEntry> entries;
-    return makeBool(parseArchive(blob,entries,false));
+    return makeBool(parseArchive(blob.data(),blob.size(),entries,false));
+}
+
+STARBYTES_FUNC(archive_pack) {
+    skipOptionalModuleReceiver(args,2);
+
+    auto dictArg = StarbytesFuncArgsGetArg(args);
+    bool compress = false;
+    if(!readBoolArg(args,compress)) {
+        return nullptr;
+    }
+
+    std::vector<EntryPayload> entries;
+    if(!readDictEntries(dictArg,true,entries)) {
+        return failNativeIfEmpty(args,"pack requires a Dict of String or Bytes entries keyed by name");
+    }
+
+    std::vector<unsigned char> archiveBytes;
+    std::string error;
+    if(!buildArchive(entries,compress,"pack",archiveBytes,error)) {
+        return failNativeIfEmpty(args,error);
+    }
+    return StarbytesBytesNewWithData(archiveBytes.data(),archiveBytes.size());
+}
+
+StarbytesObject unpackArchive(StarbytesFuncArgs args,bool asText,const char *name) {
+    skipOptionalModuleReceiver(args,1);
+
+    auto archiveArg = StarbytesFuncArgsGetArg(args);
+    ByteView blob;
+    if(!readByteView(archiveArg,blob)) {
+        return failNativeIfEmpty(args,std::string(name) + " expects Bytes archive");
+    }
+
+    std::vector<DecodedEntry> entries;
+    if(!parseArchive(blob.data,blob.length,entries,false)) {
+        return failNativeIfEmpty(args,std::string(name) + " failed to decode archive");
+    }
+
+    bool canSlice = StarbytesObjectTypecheck(archiveArg,StarbytesBytesType());
+    auto dict = StarbytesDictNew();
+    for(const auto &entry : entries) {
+        auto key = StarbytesStrNewWithData(entry.name.c_str());
+        StarbytesObject value = nullptr;
+        if(asText) {
+            if(entry.compressed) {
+                value = StarbytesStrNewWithData(entry.value.c_str());
+            }
+            else {
+                std::string text(reinterpret_cast<const char *>(blob.data + entry.storedOffset),entry.storedLength);
+                value = StarbytesStrNewWithData(text.c_str());
+            }
+        }
+        else if(entry.compressed) {
+            value = StarbytesBytesNewWithData(entry.value.data(),entry.value.size());
+        }
+        else if(canSlice) {
+            value = StarbytesBytesSlice(archiveArg,entry.storedOffset,entry.storedLength);
+        }
+        else {
+            value = StarbytesBytesNewWithData(blob.data + entry.storedOffset,entry.storedLength);
+        }
+        StarbytesDictSet(dict,key,value);
+    }
+    return dict;
+}
+
+STARBYTES_FUNC(archive_unpack) {
+    return unpackArchive(args,false,"unpack");
+}
+
+STARBYTES_FUNC(archive_unpackTextMap) {
+    return unpackArchive(args,true,"unpackTextMap");
 }
 
 void addFunc(StarbytesNativeModule *module,const char *name,unsigned argCount,StarbytesFuncCallback callback) {
@@ -527,6 +633,9 @@ STARBYTES_NATIVE_MOD_MAIN() {
     addFunc(module,"archive_unpackTextMapHex",1,archive_unpackTextMapHex);
     addFunc(module,"archive_listEntries",1,archive_listEntries);
     addFunc(module,"archive_isValid",1,archive_isValid);
+    addFunc(module,"archive_pack",2,archive_pack);
+    addFunc(module,"archive_unpack",1,archive_unpack);
+    addFunc(module,"archive_unpackTextMap",1,archive_unpackTextMap);
 
     return module;
 }
@@ -1,9 +1,12 @@
 #include <starbytes/interop.h>
 #include "starbytes/runtime/NativeModuleSupport.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <cstdio>
+#include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #ifdef STARBYTES_HAS_ZLIB
@@ -12,7 +15,9 @@
 
 namespace {
 
+using starbytes::Runtime::stdlib::ByteView;
 using starbytes::Runtime::stdlib::failNativeIfEmpty;
+using starbytes::Runtime::stdlib::readByteView;
 using starbytes::Runtime::stdlib::setNativeErrorIfEmpty;
 
 struct NativeArgsLayout {
@@ -24,8 +29,42 @@ struct NativeArgsLayout {
 constexpr size_t kChunkSize = 16 * 1024;
 constexpr size_t kMaxInputBytes = 32 * 1024 * 1024;
 constexpr size_t kMaxOutputBytes = 64 * 1024 * 1024;
+constexpr size_t kMaxBinaryInputBytes = (size_t)1024 * 1024 * 1024;
+constexpr size_t kMaxBinaryOutputBytes = (size_t)2 * 1024 * 1024 * 1024;
 constexpr char kHexDigits[] = "0123456789abcdef";
 
+#ifdef STARBYTES_HAS_ZLIB
+/// Persistent zlib state behind a Deflater, Inflater, GzipWriter or GzipReader object.
+/// `output` is reused across calls so each write only allocates its result.
+struct CodecState {
+    z_stream stream = {};
+    bool initialized = false;
+    bool compress = true;
+    bool gzip = false;
+    bool streamEnded = false;
+    std::vector<unsigned char> output;
+
+    ~CodecState() {
+        if(!initialized) {
+            return;
+        }
+        if(compress) {
+            deflateEnd(&stream);
+        }
+        else {
+            inflateEnd(&stream);
+        }
+    }
+};
+
+std::unordered_map<StarbytesObject,std::unique_ptr<CodecState>> g_codecRegistry;
+#endif
+
+StarbytesObject makeBool(bool value) {
+    // Runtime bool consumption currently interprets StarbytesBoolFalse as logical true.
+    return StarbytesBoolNew(value ? StarbytesBoolFalse : StarbytesBoolTrue);
+}
+
 bool readStringArg(StarbytesFuncArgs args,std::string &outValue) {
     auto arg = StarbytesFuncArgsGetArg(args);
     if(!arg || !StarbytesObjectTypecheck(arg,StarbytesStrType())) {
@@ -47,6 +86,14 @@ bool readIntArg(StarbytesFuncArgs args,int &outValue) {
     return true;
 }
 
+bool readBytesArg(StarbytesFuncArgs args,ByteView &outValue) {
+    if(!readByteView(StarbytesFuncArgsGetArg(args),outValue)) {
+        setNativeErrorIfEmpty(args,"expected Bytes argument");
+        return false;
+    }
+    return true;
+}
+
 void skipOptionalModuleReceiver(StarbytesFuncArgs args,unsigned expectedUserArgs) {
     auto *raw = reinterpret_cast<NativeArgsLayout *>(args);
     if(!raw || raw->argc < raw->index) {
@@ -107,8 +154,14 @@ uint32_t fnv1a32(const unsigned char *data,size_t len) {
     return hash;
 }
 
-bool zlibDeflate(const std::vector<unsigned char> &input,int level,int windowBits,std::vector<unsigned char> &out) {
-    if(input.size() > kMaxInputBytes) {
+bool zlibDeflate(const unsigned char *input,
+                 size_t inputLength,
+                 int level,
+                 int windowBits,
+                 size_t maxInputBytes,
+                 size_t maxOutputBytes,
+                 std::vector<unsigned char> &out) {
+    if(inputLength > maxInputBytes) {
         return false;
     }
 
@@ -116,7 +169,7 @@ bool zlibDeflate(const std::vector<unsigned char> &input,int level,int windowBit
     if(level < -1 || level > 9) {
         return false;
     }
-    if(input.size() > (size_t)UINT32_MAX) {
+    if(inputLength > (size_t)UINT32_MAX) {
         return false;
     }
 
@@ -126,8 +179,9 @@ bool zlibDeflate(const std::vector<unsigned char> &input,int level,int windowBit
     }
 
     out.clear();
-    stream.next_in = (Bytef *)(input.empty() ? nullptr : input.data());
-    stream.avail_in = (uInt)input.size();
+    out.reserve((size_t)deflateBound(&stream,(uLong)inputLength));
+    stream.next_in = (Bytef *)(inputLength == 0 ? nullptr : input);
+    stream.avail_in = (uInt)inputLength;
 
     int ret = Z_OK;
     while(ret != Z_STREAM_END) {
@@ -145,7 +199,7 @@ bool zlibDeflate(const std::vector<unsigned char> &input,int level,int windowBit
 
         size_t produced = kChunkSize - (size_t)stream.avail_out;
         out.resize(prior + produced);
-        if(out.size() > kMaxOutputBytes) {
+        if(out.size() > maxOutputBytes) {
             deflateEnd(&stream);
             return false;
         }
@@ -156,21 +210,27 @@ bool zlibDeflate(const std::vector<unsigned char> &input,int level,int windowBit
 #else
     (void)level;
     (void)windowBits;
-    out = input;
+    (void)maxOutputBytes;
+    out.assign(input,input + inputLength);
     return true;
 #endif
 }
 
-bool zlibInflate(const std::vector<unsigned char> &input,int windowBits,std::vector<unsigned char> &out) {
-    if(input.size() > kMaxInputBytes) {
+bool zlibInflate(const unsigned char *input,
+                 size_t inputLength,
+                 int windowBits,
+                 size_t maxInputBytes,
+                 size_t maxOutputBytes,
+                 std::vector<unsigned char> &out) {
+    if(inputLength > maxInputBytes) {
         return false;
     }
 
 #ifdef STARBYTES_HAS_ZLIB
-    if(input.empty()) {
+    if(inputLength == 0) {
         return false;
     }
-    if(input.size() > (size_t)UINT32_MAX) {
+    if(inputLength > (size_t)UINT32_MAX) {
         return false;
     }
 
@@ -180,8 +240,8 @@ bool zlibInflate(const std::vector<unsigned char> &input,int windowBits,std::vec
     }
 
     out.clear();
-    stream.next_in = (Bytef *)input.data();
-    stream.avail_in = (uInt)input.size();
+    stream.next_in = (Bytef *)input;
+    stream.avail_in = (uInt)inputLength;
 
     int ret = Z_OK;
     while(ret != Z_STREAM_END) {
@@ -199,7 +259,7 @@ bool zlibInflate(const std::vector<unsigned char> &input,int windowBits,std::vec
 
         size_t produced = kChunkSize - (size_t)stream.avail_out;
         out.resize(prior + produced);
-        if(out.size() > kMaxOutputBytes) {
+        if(out.size() > maxOutputBytes) {
             inflateEnd(&stream);
             return false;
         }
@@ -209,7 +269,8 @@ bool zlibInflate(const std::vector<unsigned char> &input,int windowBits,std::vec
     return true;
 #else
     (void)windowBits;
-    out = input;
+    (void)maxOutputBytes;
+    out.assign(input,input + inputLength);
     return true;
 #endif
 }
@@ -235,7 +296,7 @@ STARBYTES_FUNC(compression_deflateHex) {
     }
 
     std::vector<unsigned char> compressed;
-    if(!zlibDeflate(input,level,15,compressed)) {
+    if(!zlibDeflate(input.data(),input.size(),level,15,kMaxInputBytes,kMaxOutputBytes,compressed)) {
         return failNativeIfEmpty(args,"deflateHex failed");
     }
 
@@ -257,7 +318,7 @@ STARBYTES_FUNC(compression_inflateHex) {
     }
 
     std::vector<unsigned char> inflated;
-    if(!zlibInflate(compressed,15,inflated)) {
+    if(!zlibInflate(compressed.data(),compressed.size(),15,kMaxInputBytes,kMaxOutputBytes,inflated)) {
         return failNativeIfEmpty(args,"inflateHex failed");
     }
 
@@ -274,9 +335,14 @@ STARBYTES_FUNC(compression_gzipTextHex) {
         return nullptr;
     }
 
-    std::vector<unsigned char> input(text.begin(),text.end());
     std::vector<unsigned char> compressed;
-    if(!zlibDeflate(input,level,31,compressed)) {
+    if(!zlibDeflate(reinterpret_cast<const unsigned char *>(text.data()),
+                    text.size(),
+                    level,
+                    31,
+                    kMaxInputBytes,
+                    kMaxOutputBytes,
+                    compressed)) {
         return failNativeIfEmpty(args,"gzipTextHex failed");
     }
 
@@ -298,7 +364,7 @@ STARBYTES_FUNC(compression_gunzipText) {
     }
 
     std::vector<unsigned char> outBytes;
-    if(!zlibInflate(compressed,31,outBytes)) {
+    if(!zlibInflate(compressed.data(),compressed.size(),31,kMaxInputBytes,kMaxOutputBytes,outBytes)) {
         return failNativeIfEmpty(args,"gunzipText failed");
     }
 
@@ -306,6 +372,21 @@ STARBYTES_FUNC(compression_gunzipText) {
     return StarbytesStrNewWithData(text.c_str());
 }
 
+uint32_t checksum32(const unsigned char *data,size_t len) {
+#ifdef STARBYTES_HAS_ZLIB
+    uLong value = ::crc32(0,Z_NULL,0);
+    while(len > 0) {
+        auto chunk = (uInt)std::min(len,(size_t)UINT32_MAX);
+        value = ::crc32(value,(const Bytef *)data,chunk);
+        data += chunk;
+        len -= chunk;
+    }
+    return (uint32_t)value;
+#else
+    return fnv1a32(data,len);
+#endif
+}
+
 STARBYTES_FUNC(compression_crc32Hex) {
     skipOptionalModuleReceiver(args,1);
 
@@ -314,15 +395,285 @@ STARBYTES_FUNC(compression_crc32Hex) {
         return nullptr;
     }
 
-    uint32_t value = 0;
+    auto hex = formatHex8(checksum32(reinterpret_cast<const unsigned char *>(text.data()),text.size()));
+    return StarbytesStrNewWithData(hex.c_str());
+}
+
+StarbytesObject deflateBytes(StarbytesFuncArgs args,int windowBits,const char *name) {
+    skipOptionalModuleReceiver(args,2);
+
+    ByteView input;
+    int level = -1;
+    if(!readBytesArg(args,input) || !readIntArg(args,level)) {
+        return nullptr;
+    }
+
+    std::vector<unsigned char> compressed;
+    if(!zlibDeflate(input.data,input.length,level,windowBits,kMaxBinaryInputBytes,kMaxBinaryOutputBytes,compressed)) {
+        return failNativeIfEmpty(args,std::string(name) + " failed");
+    }
+    return StarbytesBytesNewWithData(compressed.data(),compressed.size());
+}
+
+StarbytesObject inflateBytes(StarbytesFuncArgs args,int windowBits,const char *name) {
+    skipOptionalModuleReceiver(args,1);
+
+    ByteView input;
+    if(!readBytesArg(args,input)) {
+        return nullptr;
+    }
+
+    std::vector<unsigned char> inflated;
+    if(!zlibInflate(input.data,input.length,windowBits,kMaxBinaryInputBytes,kMaxBinaryOutputBytes,inflated)) {
+        return failNativeIfEmpty(args,std::string(name) + " failed");
+    }
+    return StarbytesBytesNewWithData(inflated.data(),inflated.size());
+}
+
+STARBYTES_FUNC(compression_deflate) {
+    return deflateBytes(args,15,"deflate");
+}
+
+STARBYTES_FUNC(compression_inflate) {
+    return inflateBytes(args,15,"inflate");
+}
+
+STARBYTES_FUNC(compression_gzip) {
+    return deflateBytes(args,31,"gzip");
+}
+
+STARBYTES_FUNC(compression_gunzip) {
+    return inflateBytes(args,31,"gunzip");
+}
+
+STARBYTES_FUNC(compression_crc32) {
+    skipOptionalModuleReceiver(args,1);
+
+    ByteView input;
+    if(!readBytesArg(args,input)) {
+        return nullptr;
+    }
+    return StarbytesNumNew(NumTypeLong,(int64_t)checksum32(input.data,input.length));
+}
+
 #ifdef STARBYTES_HAS_ZLIB
-    value = (uint32_t)::crc32(0,(const Bytef *)text.data(),(uInt)text.size());
+CodecState *requireCodecSelf(StarbytesFuncArgs args,StarbytesObject &selfOut) {
+    selfOut = StarbytesFuncArgsGetArg(args);
+    if(!selfOut) {
+        setNativeErrorIfEmpty(args,"codec receiver is missing");
+        return nullptr;
+    }
+    auto it = g_codecRegistry.find(selfOut);
+    if(it == g_codecRegistry.end()) {
+        setNativeErrorIfEmpty(args,"codec is finished");
+        return nullptr;
+    }
+    return it->second.get();
+}
+
+/// Feeds one chunk through the codec, leaving everything it produced in `state.output`.
+bool runCodec(CodecState &state,const unsigned char *input,size_t inputLength,int flush,std::string &error) {
+    state.output.clear();
+    if(inputLength > kMaxBinaryInputBytes) {
+        error = "chunk exceeds maximum input size";
+        return false;
+    }
+    if(!state.compress && state.streamEnded && inputLength > 0) {
+        error = "data after end of compressed stream";
+        return false;
+    }
+
+    auto &stream = state.stream;
+    stream.next_in = (Bytef *)(inputLength == 0 ? nullptr : input);
+    stream.avail_in = (uInt)inputLength;
+
+    while(true) {
+        size_t prior = state.output.size();
+        state.output.resize(prior + kChunkSize);
+        stream.next_out = reinterpret_cast<Bytef *>(state.output.data() + prior);
+        stream.avail_out = (uInt)kChunkSize;
+
+        int ret = state.compress ? deflate(&stream,flush) : inflate(&stream,Z_NO_FLUSH);
+        state.output.resize(prior + (kChunkSize - (size_t)stream.avail_out));
+        if(state.output.size() > kMaxBinaryOutputBytes) {
+            error = "output exceeds maximum size";
+            return false;
+        }
+
+        if(state.compress) {
+            if(ret == Z_STREAM_ERROR) {
+                error = "compression failed";
+                return false;
+            }
+            if(flush == Z_FINISH ? ret == Z_STREAM_END : stream.avail_out != 0) {
+                return true;
+            }
+            continue;
+        }
+
+        if(ret == Z_STREAM_END) {
+            if(state.gzip && stream.avail_in > 0) {
+                // Concatenated gzip members decode as one stream, like gunzip.
+                inflateReset(&stream);
+                continue;
+            }
+            state.streamEnded = true;
+            if(stream.avail_in > 0) {
+                error = "data after end of compressed stream";
+                return false;
+            }
+            return true;
+        }
+        if(ret != Z_OK && ret != Z_BUF_ERROR) {
+            error = "invalid compressed data";
+            return false;
+        }
+        if(stream.avail_out != 0) {
+            return true;
+        }
+    }
+}
+#endif
+
+StarbytesObject newCodec(StarbytesFuncArgs args,const char *className,bool compress,int windowBits) {
+    int level = -1;
+    if(compress) {
+        skipOptionalModuleReceiver(args,1);
+        if(!readIntArg(args,level)) {
+            return nullptr;
+        }
+        if(level < -1 || level > 9) {
+            return failNativeIfEmpty(args,std::string(className) + " level must be between -1 and 9");
+        }
+    }
+    else {
+        skipOptionalModuleReceiver(args,0);
+    }
+
+#ifdef STARBYTES_HAS_ZLIB
+    auto state = std::make_unique<CodecState>();
+    state->compress = compress;
+    state->gzip = windowBits > 15;
+    int ret = compress
+        ? deflateInit2(&state->stream,level,Z_DEFLATED,windowBits,8,Z_DEFAULT_STRATEGY)
+        : inflateInit2(&state->stream,windowBits);
+    if(ret != Z_OK) {
+        return failNativeIfEmpty(args,std::string(className) + " failed to initialize");
+    }
+    state->initialized = true;
+
+    auto object = StarbytesObjectNew(StarbytesMakeClass(className));
+    g_codecRegistry[object] = std::move(state);
+    return object;
 #else
-    value = fnv1a32(reinterpret_cast<const unsigned char *>(text.data()),text.size());
+    (void)windowBits;
+    return failNativeIfEmpty(args,"Compression streaming requires zlib");
 #endif
+}
 
-    auto hex = formatHex8(value);
-    return StarbytesStrNewWithData(hex.c_str());
+STARBYTES_FUNC(compression_deflater) {
+    return newCodec(args,"Deflater",true,15);
+}
+
+STARBYTES_FUNC(compression_inflater) {
+    return newCodec(args,"Inflater",false,15);
+}
+
+STARBYTES_FUNC(compression_gzipWriter) {
+    return newCodec(args,"GzipWriter",true,31);
+}
+
+STARBYTES_FUNC(compression_gzipReader) {
+    return newCodec(args,"GzipReader",false,31);
+}
+
+STARBYTES_FUNC(compression_codecWrite) {
+#ifdef STARBYTES_HAS_ZLIB
+    StarbytesObject self = nullptr;
+    auto *state = requireCodecSelf(args,self);
+    if(!state) {
+        return nullptr;
+    }
+
+    ByteView chunk;
+    if(!readBytesArg(args,chunk)) {
+        return nullptr;
+    }
+
+    std::string error;
+    if(!runCodec(*state,chunk.data,chunk.length,Z_NO_FLUSH,error)) {
+        return failNativeIfEmpty(args,"write failed: " + error);
+    }
+    return StarbytesBytesNewWithData(state->output.data(),state->output.size());
+#else
+    return failNativeIfEmpty(args,"Compression streaming requires zlib");
+#endif
+}
+
+STARBYTES_FUNC(compression_codecFlush) {
+#ifdef STARBYTES_HAS_ZLIB
+    StarbytesObject self = nullptr;
+    auto *state = requireCodecSelf(args,self);
+    if(!state) {
+        return nullptr;
+    }
+
+    // Inflaters hand back all output from write(), so only compressors have anything to flush.
+    if(!state->compress) {
+        return StarbytesBytesNew(0);
+    }
+    std::string error;
+    if(!runCodec(*state,nullptr,0,Z_SYNC_FLUSH,error)) {
+        return failNativeIfEmpty(args,"flush failed: " + error);
+    }
+    return StarbytesBytesNewWithData(state->output.data(),state->output.size());
+#else
+    return failNativeIfEmpty(args,"Compression streaming requires zlib");
+#endif
+}
+
+STARBYTES_FUNC(compression_codecFinish) {
+#ifdef STARBYTES_HAS_ZLIB
+    StarbytesObject self = nullptr;
+    auto *state = requireCodecSelf(args,self);
+    if(!state) {
+        return nullptr;
+    }
+
+    StarbytesObject result = nullptr;
+    if(state->compress) {
+        std::string error;
+        if(runCodec(*state,nullptr,0,Z_FINISH,error)) {
+            result = StarbytesBytesNewWithData(state->output.data(),state->output.size());
+        }
+        else {
+            setNativeErrorIfEmpty(args,"finish failed: " + error);
+        }
+    }
+    else if(state->streamEnded) {
+        result = StarbytesBytesNew(0);
+    }
+    else {
+        setNativeErrorIfEmpty(args,"finish failed: compressed stream is truncated");
+    }
+    g_codecRegistry.erase(self);
+    return result;
+#else
+    return failNativeIfEmpty(args,"Compression streaming requires zlib");
+#endif
+}
+
+STARBYTES_FUNC(compression_codecIsFinished) {
+#ifdef STARBYTES_HAS_ZLIB
+    auto self = StarbytesFuncArgsGetArg(args);
+    auto it = g_codecRegistry.find(self);
+    if(it == g_codecRegistry.end()) {
+        return makeBool(true);
+    }
+    return makeBool(!it->second->compress && it->second->streamEnded);
+#else
+    return makeBool(true);
+#endif
 }
 
 void addFunc(StarbytesNativeModule *module,const char *name,unsigned argCount,StarbytesFuncCallback callback) {
@@ -343,6 +694,23 @@ STARBYTES_NATIVE_MOD_MAIN() {
     addFunc(module,"compression_gzipTextHex",2,compression_gzipTextHex);
     addFunc(module,"compression_gunzipText",1,compression_gunzipText);
     addFunc(module,"compression_crc32Hex",1,compression_crc32Hex);
+    addFunc(module,"compression_deflate",2,compression_deflate);
+    addFunc(module,"compression_inflate",1,compression_inflate);
+    addFunc(module,"compression_gzip",2,compression_gzip);
+    addFunc(module,"compression_gunzip",1,compression_gunzip);
+    addFunc(module,"compression_crc32",1,compression_crc32);
+    addFunc(module,"compression_deflater",1,compression_deflater);
+    addFunc(module,"compression_inflater",0,compression_inflater);
+    addFunc(module,"compression_gzipWriter",1,compression_gzipWriter);
+    addFunc(module,"compression_gzipReader",0,compression_gzipReader);
+
+    for(const char *className : {"Deflater","Inflater","GzipWriter","GzipReader"}) {
+        auto prefix = std::string("Compression_") + className;
+        addFunc(module,(prefix + "_write").c_str(),2,compression_codecWrite);
+        addFunc(module,(prefix + "_flush").c_str(),1,compression_codecFlush);
+        addFunc(module,(prefix + "_finish").c_str(),1,compression_codecFinish);
+        addFunc(module,(prefix + "_isFinished").c_str(),1,compression_codecIsFinished);
+    }
 
     return module;
 }
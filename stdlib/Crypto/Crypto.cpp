@@ -1,22 +1,30 @@
 #include <starbytes/interop.h>
 #include "starbytes/runtime/NativeModuleSupport.h"
+#include "starbytes/base/Digest.h"
 
 #include <algorithm>
 #include <cstdint>
+#include <cstdio>
 #include <cstring>
+#include <memory>
 #include <string>
 #include <vector>
 
 #ifdef STARBYTES_HAS_OPENSSL
 #include <openssl/crypto.h>
 #include <openssl/evp.h>
-#include <openssl/hmac.h>
-#include <openssl/sha.h>
 #endif
 
 namespace {
 
+using starbytes::Digest;
+using starbytes::DigestKind;
+using starbytes::Hmac;
+using starbytes::digestKindFromName;
+using starbytes::digestLength;
+using starbytes::Runtime::stdlib::ByteView;
 using starbytes::Runtime::stdlib::failNativeIfEmpty;
+using starbytes::Runtime::stdlib::readByteView;
 using starbytes::Runtime::stdlib::setNativeErrorIfEmpty;
 
 struct NativeArgsLayout {
@@ -28,11 +36,33 @@ struct NativeArgsLayout {
 constexpr int kMaxPbkdf2Iterations = 10 * 1000 * 1000;
 constexpr int kMaxDerivedKeyBytes = 4096;
 constexpr char kHexDigits[] = "0123456789abcdef";
+constexpr size_t kHashFileChunkBytes = 1024 * 1024;
 
-enum class DigestKind {
-    Md5,
-    Sha1,
-    Sha256
+/// Running state behind a Hasher or Hmac object; exactly one of the two members is set.
+struct HasherState {
+    std::unique_ptr<Digest> digest;
+    std::unique_ptr<Hmac> hmac;
+
+    DigestKind kind() const {
+        return digest ? digest->kind() : hmac->kind();
+    }
+
+    bool update(const unsigned char *data,size_t length) {
+        return digest ? digest->update(data,length) : hmac->update(data,length);
+    }
+
+    bool final(unsigned char *out) const {
+        return digest ? digest->final(out) : hmac->final(out);
+    }
+
+    void reset() {
+        if(digest) {
+            digest->reset();
+        }
+        else {
+            hmac->reset();
+        }
+    }
 };
 
 StarbytesObject makeBool(bool value) {
@@ -61,6 +91,14 @@ bool readIntArg(StarbytesFuncArgs args,int &outValue) {
     return true;
 }
 
+bool readBytesArg(StarbytesFuncArgs args,ByteView &outValue) {
+    if(!readByteView(StarbytesFuncArgsGetArg(args),outValue)) {
+        setNativeErrorIfEmpty(args,"expected Bytes argument");
+        return false;
+    }
+    return true;
+}
+
 void skipOptionalModuleReceiver(StarbytesFuncArgs args,unsigned expectedUserArgs) {
     auto *raw = reinterpret_cast<NativeArgsLayout *>(args);
     if(!raw || raw->argc < raw->index) {
@@ -112,175 +150,105 @@ bool hexToBytes(const std::string &hex,std::vector<unsigned char> &outBytes) {
     return true;
 }
 
-uint64_t fnv1a64(const unsigned char *data,size_t len,uint64_t seed) {
-    uint64_t hash = seed;
-    for(size_t i = 0; i < len; ++i) {
-        hash ^= (uint64_t)data[i];
-        hash *= 1099511628211ULL;
-    }
-    return hash;
-}
-
-uint64_t splitMix64(uint64_t value) {
-    uint64_t z = value + 0x9e3779b97f4a7c15ULL;
-    z = (z ^ (z >> 30U)) * 0xbf58476d1ce4e5b9ULL;
-    z = (z ^ (z >> 27U)) * 0x94d049bb133111ebULL;
-    return z ^ (z >> 31U);
+bool digestBytes(DigestKind kind,const unsigned char *data,size_t len,std::vector<unsigned char> &out) {
+    Digest digest(kind);
+    out.assign(digestLength(kind),0);
+    return digest.update(data,len) && digest.final(out.data());
 }
 
-std::vector<unsigned char> pseudoDigest(const std::vector<unsigned char> &data,size_t outLen,const char *domain) {
-    std::vector<unsigned char> out(outLen,0);
-
-    uint64_t seed = 1469598103934665603ULL;
-    if(domain) {
-        seed = fnv1a64(reinterpret_cast<const unsigned char *>(domain),std::strlen(domain),seed);
-    }
-    if(!data.empty()) {
-        seed = fnv1a64(data.data(),data.size(),seed);
-    }
-
-    uint64_t state = seed;
-    for(size_t i = 0; i < outLen; ++i) {
-        state = splitMix64(state + i + (uint64_t)(data.size() + 1));
-        out[i] = (unsigned char)((state >> ((i % 8) * 8)) & 0xFF);
-    }
-    return out;
+bool hmacSha256(const unsigned char *key,
+                size_t keyLen,
+                const unsigned char *message,
+                size_t messageLen,
+                std::vector<unsigned char> &out) {
+    Hmac hmac(DigestKind::Sha256,key,keyLen);
+    out.assign(digestLength(DigestKind::Sha256),0);
+    return hmac.update(message,messageLen) && hmac.final(out.data());
 }
 
-bool digestFallback(DigestKind kind,const std::string &text,std::vector<unsigned char> &out) {
-    std::vector<unsigned char> bytes(text.begin(),text.end());
-    switch(kind) {
-        case DigestKind::Md5:
-            out = pseudoDigest(bytes,16,"md5");
-            return true;
-        case DigestKind::Sha1:
-            out = pseudoDigest(bytes,20,"sha1");
-            return true;
-        case DigestKind::Sha256:
-            out = pseudoDigest(bytes,32,"sha256");
-            return true;
-    }
-    return false;
-}
-
-bool digestText(DigestKind kind,const std::string &text,std::vector<unsigned char> &out) {
-#ifdef STARBYTES_HAS_OPENSSL
-    const EVP_MD *md = nullptr;
-    switch(kind) {
-        case DigestKind::Md5:
-            md = EVP_md5();
-            break;
-        case DigestKind::Sha1:
-            md = EVP_sha1();
-            break;
-        case DigestKind::Sha256:
-            md = EVP_sha256();
-            break;
-    }
-    if(!md) {
-        return false;
-    }
-
-    EVP_MD_CTX *ctx = EVP_MD_CTX_new();
-    if(!ctx) {
-        return false;
-    }
-
-    unsigned int outLen = 0;
-    out.assign((size_t)EVP_MD_size(md),0);
-    bool ok = EVP_DigestInit_ex(ctx,md,nullptr) == 1
-              && EVP_DigestUpdate(ctx,text.data(),text.size()) == 1
-              && EVP_DigestFinal_ex(ctx,out.data(),&outLen) == 1;
-    EVP_MD_CTX_free(ctx);
-    if(!ok) {
-        return false;
-    }
-    out.resize(outLen);
-    return true;
-#else
-    return digestFallback(kind,text,out);
-#endif
-}
-
-bool hmacSha256(const std::string &key,const std::string &message,std::vector<unsigned char> &out) {
-#ifdef STARBYTES_HAS_OPENSSL
-    unsigned int outLen = 0;
-    out.assign(32,0);
-    auto *result = HMAC(EVP_sha256(),
-                        key.data(),(int)key.size(),
-                        reinterpret_cast<const unsigned char *>(message.data()),message.size(),
-                        out.data(),&outLen);
-    if(!result) {
-        return false;
-    }
-    out.resize(outLen);
-    return true;
-#else
-    std::vector<unsigned char> bytes;
-    bytes.reserve(key.size() + 1 + message.size());
-    bytes.insert(bytes.end(),key.begin(),key.end());
-    bytes.push_back('|');
-    bytes.insert(bytes.end(),message.begin(),message.end());
-    out = pseudoDigest(bytes,32,"hmac-sha256");
-    return true;
-#endif
-}
-
-bool pbkdf2Sha256(const std::string &password,
-                  const std::vector<unsigned char> &salt,
+bool pbkdf2Sha256(const unsigned char *password,
+                  size_t passwordLen,
+                  const unsigned char *salt,
+                  size_t saltLen,
                   int iterations,
                   int keyBytes,
                   std::vector<unsigned char> &out) {
 #ifdef STARBYTES_HAS_OPENSSL
+    if(passwordLen > (size_t)INT32_MAX || saltLen > (size_t)INT32_MAX) {
+        return false;
+    }
     out.assign((size_t)keyBytes,0);
-    return PKCS5_PBKDF2_HMAC(password.data(),
-                             (int)password.size(),
-                             salt.empty() ? nullptr : salt.data(),
-                             (int)salt.size(),
+    return PKCS5_PBKDF2_HMAC(reinterpret_cast<const char *>(password),
+                             (int)passwordLen,
+                             saltLen == 0 ? nullptr : salt,
+                             (int)saltLen,
                              iterations,
                              EVP_sha256(),
                              keyBytes,
                              out.data()) == 1;
 #else
-    out.assign((size_t)keyBytes,0);
-    if(out.empty()) {
-        return true;
+    // RFC 8018 PBKDF2. Each round copies the keyed HMAC instead of re-deriving the pads.
+    Hmac keyed(DigestKind::Sha256,password,passwordLen);
+    if(!keyed.valid()) {
+        return false;
     }
-
-    std::vector<unsigned char> input;
-    input.reserve(password.size() + salt.size());
-    input.insert(input.end(),password.begin(),password.end());
-    input.insert(input.end(),salt.begin(),salt.end());
-    auto block = pseudoDigest(input,32,"pbkdf2-seed");
-    for(int iter = 0; iter < iterations; ++iter) {
-        for(int i = 0; i < keyBytes; ++i) {
-            out[(size_t)i] ^= block[(size_t)i % block.size()];
+    constexpr size_t kBlockBytes = 32;
+    out.assign((size_t)keyBytes,0);
+    unsigned char round[kBlockBytes];
+    unsigned char block[kBlockBytes];
+    size_t offset = 0;
+    for(uint32_t index = 1; offset < out.size(); ++index) {
+        const unsigned char counter[4] = {
+            (unsigned char)(index >> 24),(unsigned char)(index >> 16),(unsigned char)(index >> 8),(unsigned char)index
+        };
+        Hmac first(keyed);
+        if(!first.update(salt,saltLen) || !first.update(counter,sizeof(counter)) || !first.final(round)) {
+            return false;
+        }
+        std::memcpy(block,round,kBlockBytes);
+        for(int iter = 1; iter < iterations; ++iter) {
+            Hmac next(keyed);
+            if(!next.update(round,kBlockBytes) || !next.final(round)) {
+                return false;
+            }
+            for(size_t i = 0; i < kBlockBytes; ++i) {
+                block[i] ^= round[i];
+            }
         }
-        block = pseudoDigest(block,32,"pbkdf2-round");
+        size_t take = std::min(kBlockBytes,out.size() - offset);
+        std::memcpy(out.data() + offset,block,take);
+        offset += take;
     }
     return true;
 #endif
 }
 
-bool constantTimeEqual(const std::vector<unsigned char> &lhs,const std::vector<unsigned char> &rhs) {
-    if(lhs.size() != rhs.size()) {
+bool constantTimeEqual(const unsigned char *lhs,size_t lhsLen,const unsigned char *rhs,size_t rhsLen) {
+    if(lhsLen != rhsLen) {
         return false;
     }
+    if(lhsLen == 0) {
+        return true;
+    }
 
 #ifdef STARBYTES_HAS_OPENSSL
-    return CRYPTO_memcmp(lhs.data(),rhs.data(),lhs.size()) == 0;
+    return CRYPTO_memcmp(lhs,rhs,lhsLen) == 0;
 #else
     unsigned char diff = 0;
-    for(size_t i = 0; i < lhs.size(); ++i) {
+    for(size_t i = 0; i < lhsLen; ++i) {
         diff |= (unsigned char)(lhs[i] ^ rhs[i]);
     }
     return diff == 0;
 #endif
 }
 
+const unsigned char *textData(const std::string &text) {
+    return reinterpret_cast<const unsigned char *>(text.data());
+}
+
 StarbytesObject digestAsHex(DigestKind kind,const std::string &text) {
     std::vector<unsigned char> digest;
-    if(!digestText(kind,text,digest)) {
+    if(!digestBytes(kind,textData(text),text.size(),digest)) {
         return nullptr;
     }
     auto hex = bytesToHex(digest);
@@ -339,7 +307,7 @@ STARBYTES_FUNC(crypto_hmacSha256Hex) {
     }
 
     std::vector<unsigned char> digest;
-    if(!hmacSha256(key,message,digest)) {
+    if(!hmacSha256(textData(key),key.size(),textData(message),message.size(),digest)) {
         return failNativeIfEmpty(args,"hmacSha256Hex failed");
     }
     auto hex = bytesToHex(digest);
@@ -370,7 +338,7 @@ STARBYTES_FUNC(crypto_pbkdf2Sha256Hex) {
     }
 
     std::vector<unsigned char> derived;
-    if(!pbkdf2Sha256(password,salt,iterations,keyBytes,derived)) {
+    if(!pbkdf2Sha256(textData(password),password.size(),salt.data(),salt.size(),iterations,keyBytes,derived)) {
         return failNativeIfEmpty(args,"pbkdf2Sha256Hex failed");
     }
     auto hex = bytesToHex(derived);
@@ -391,7 +359,245 @@ STARBYTES_FUNC(crypto_constantTimeHexEquals) {
     if(!hexToBytes(lhsHex,lhs) || !hexToBytes(rhsHex,rhs)) {
         return makeBool(false);
     }
-    return makeBool(constantTimeEqual(lhs,rhs));
+    return makeBool(constantTimeEqual(lhs.data(),lhs.size(),rhs.data(),rhs.size()));
+}
+
+StarbytesObject digestAsBytes(StarbytesFuncArgs args,DigestKind kind,const char *name) {
+    skipOptionalModuleReceiver(args,1);
+
+    ByteView data;
+    if(!readBytesArg(args,data)) {
+        return nullptr;
+    }
+    std::vector<unsigned char> digest;
+    if(!digestBytes(kind,data.data,data.length,digest)) {
+        return failNativeIfEmpty(args,std::string(name) + " failed");
+    }
+    return StarbytesBytesNewWithData(digest.data(),digest.size());
+}
+
+STARBYTES_FUNC(crypto_md5) {
+    return digestAsBytes(args,DigestKind::Md5,"md5");
+}
+
+STARBYTES_FUNC(crypto_sha1) {
+    return digestAsBytes(args,DigestKind::Sha1,"sha1");
+}
+
+STARBYTES_FUNC(crypto_sha256) {
+    return digestAsBytes(args,DigestKind::Sha256,"sha256");
+}
+
+STARBYTES_FUNC(crypto_hmacSha256) {
+    skipOptionalModuleReceiver(args,2);
+
+    ByteView key;
+    ByteView message;
+    if(!readBytesArg(args,key) || !readBytesArg(args,message)) {
+        return nullptr;
+    }
+
+    std::vector<unsigned char> digest;
+    if(!hmacSha256(key.data,key.length,message.data,message.length,digest)) {
+        return failNativeIfEmpty(args,"hmacSha256 failed");
+    }
+    return StarbytesBytesNewWithData(digest.data(),digest.size());
+}
+
+STARBYTES_FUNC(crypto_pbkdf2Sha256) {
+    skipOptionalModuleReceiver(args,4);
+
+    ByteView password;
+    ByteView salt;
+    int iterations = 0;
+    int keyBytes = 0;
+    if(!readBytesArg(args,password) || !readBytesArg(args,salt)
+       || !readIntArg(args,iterations) || !readIntArg(args,keyBytes)) {
+        return nullptr;
+    }
+    if(iterations <= 0 || iterations > kMaxPbkdf2Iterations) {
+        return failNativeIfEmpty(args,"pbkdf2Sha256 iterations must be between 1 and 10000000");
+    }
+    if(keyBytes <= 0 || keyBytes > kMaxDerivedKeyBytes) {
+        return failNativeIfEmpty(args,"pbkdf2Sha256 keyBytes must be between 1 and 4096");
+    }
+
+    std::vector<unsigned char> derived;
+    if(!pbkdf2Sha256(password.data,password.length,salt.data,salt.length,iterations,keyBytes,derived)) {
+        return failNativeIfEmpty(args,"pbkdf2Sha256 failed");
+    }
+    return StarbytesBytesNewWithData(derived.data(),derived.size());
+}
+
+STARBYTES_FUNC(crypto_constantTimeEquals) {
+    skipOptionalModuleReceiver(args,2);
+
+    ByteView lhs;
+    ByteView rhs;
+    if(!readBytesArg(args,lhs) || !readBytesArg(args,rhs)) {
+        return makeBool(false);
+    }
+    return makeBool(constantTimeEqual(lhs.data,lhs.length,rhs.data,rhs.length));
+}
+
+bool readDigestKindArg(StarbytesFuncArgs args,DigestKind &outKind) {
+    std::string algorithm;
+    if(!readStringArg(args,algorithm)) {
+        return false;
+    }
+    if(!digestKindFromName(algorithm,outKind)) {
+        setNativeErrorIfEmpty(args,"unsupported digest algorithm: " + algorithm);
+        return false;
+    }
+    return true;
+}
+
+void destroyHasher(void *data) {
+    delete static_cast<HasherState *>(data);
+}
+
+HasherState *findHasher(StarbytesObject self) {
+    return self ? static_cast<HasherState *>(StarbytesObjectGetNativeData(self,destroyHasher)) : nullptr;
+}
+
+HasherState *requireHasherSelf(StarbytesFuncArgs args) {
+    auto *state = findHasher(StarbytesFuncArgsGetArg(args));
+    if(!state) {
+        setNativeErrorIfEmpty(args,"hasher receiver is missing");
+    }
+    return state;
+}
+
+StarbytesObject registerHasher(StarbytesFuncArgs args,const char *className,std::unique_ptr<HasherState> state) {
+    bool ok = state->digest ? state->digest->valid() : state->hmac->valid();
+    if(!ok) {
+        return failNativeIfEmpty(args,std::string(className) + " failed to initialize");
+    }
+    auto object = StarbytesObjectNew(StarbytesMakeClass(className));
+    // The object owns the digest context, so dropping a Hasher or Hmac frees it.
+    StarbytesObjectSetNativeData(object,state.release(),destroyHasher);
+    return object;
+}
+
+STARBYTES_FUNC(crypto_hasher) {
+    skipOptionalModuleReceiver(args,1);
+
+    DigestKind kind;
+    if(!readDigestKindArg(args,kind)) {
+        return nullptr;
+    }
+    auto state = std::make_unique<HasherState>();
+    state->digest = std::make_unique<Digest>(kind);
+    return registerHasher(args,"Hasher",std::move(state));
+}
+
+STARBYTES_FUNC(crypto_hmac) {
+    skipOptionalModuleReceiver(args,2);
+
+    DigestKind kind;
+    ByteView key;
+    if(!readDigestKindArg(args,kind) || !readBytesArg(args,key)) {
+        return nullptr;
+    }
+    auto state = std::make_unique<HasherState>();
+    state->hmac = std::make_unique<Hmac>(kind,key.data,key.length);
+    return registerHasher(args,"Hmac",std::move(state));
+}
+
+STARBYTES_FUNC(crypto_hasherUpdate) {
+    auto *state = requireHasherSelf(args);
+    if(!state) {
+        return nullptr;
+    }
+    ByteView data;
+    if(!readBytesArg(args,data)) {
+        return nullptr;
+    }
+    if(!state->update(data.data,data.length)) {
+        return failNativeIfEmpty(args,"update failed");
+    }
+    return makeBool(true);
+}
+
+STARBYTES_FUNC(crypto_hasherDigest) {
+    auto *state = requireHasherSelf(args);
+    if(!state) {
+        return nullptr;
+    }
+    unsigned char out[starbytes::kMaxDigestLength];
+    if(!state->final(out)) {
+        return failNativeIfEmpty(args,"digest failed");
+    }
+    return StarbytesBytesNewWithData(out,digestLength(state->kind()));
+}
+
+STARBYTES_FUNC(crypto_hasherHexDigest) {
+    auto *state = requireHasherSelf(args);
+    if(!state) {
+        return nullptr;
+    }
+    std::vector<unsigned char> out(digestLength(state->kind()),0);
+    if(!state->final(out.data())) {
+        return failNativeIfEmpty(args,"hexDigest failed");
+    }
+    auto hex = bytesToHex(out);
+    return StarbytesStrNewWithData(hex.c_str());
+}
+
+STARBYTES_FUNC(crypto_hasherReset) {
+    auto *state = findHasher(StarbytesFuncArgsGetArg(args));
+    if(!state) {
+        return makeBool(false);
+    }
+    state->reset();
+    return makeBool(true);
+}
+
+STARBYTES_FUNC(crypto_digest) {
+    skipOptionalModuleReceiver(args,2);
+
+    DigestKind kind;
+    ByteView data;
+    if(!readDigestKindArg(args,kind) || !readBytesArg(args,data)) {
+        return nullptr;
+    }
+    std::vector<unsigned char> digest;
+    if(!digestBytes(kind,data.data,data.length,digest)) {
+        return failNativeIfEmpty(args,"digest failed");
+    }
+    return StarbytesBytesNewWithData(digest.data(),digest.size());
+}
+
+STARBYTES_FUNC(crypto_hashFile) {
+    skipOptionalModuleReceiver(args,2);
+
+    DigestKind kind;
+    std::string path;
+    if(!readDigestKindArg(args,kind) || !readStringArg(args,path)) {
+        return nullptr;
+    }
+    std::FILE *file = std::fopen(path.c_str(),"rb");
+    if(!file) {
+        return failNativeIfEmpty(args,"hashFile failed to open file: " + path);
+    }
+    Digest digest(kind);
+    std::vector<unsigned char> chunk(kHashFileChunkBytes);
+    bool ok = digest.valid();
+    while(ok) {
+        size_t count = std::fread(chunk.data(),1,chunk.size(),file);
+        ok = digest.update(chunk.data(),count);
+        if(count < chunk.size()) {
+            ok = ok && !std::ferror(file);
+            break;
+        }
+    }
+    std::fclose(file);
+
+    unsigned char out[starbytes::kMaxDigestLength];
+    if(!ok || !digest.final(out)) {
+        return failNativeIfEmpty(args,"hashFile failed to read file: " + path);
+    }
+    return StarbytesBytesNewWithData(out,digestLength(kind));
 }
 
 void addFunc(StarbytesNativeModule *module,const char *name,unsigned argCount,StarbytesFuncCallback callback) {
@@ -413,6 +619,24 @@ STARBYTES_NATIVE_MOD_MAIN() {
     addFunc(module,"crypto_hmacSha256Hex",2,crypto_hmacSha256Hex);
     addFunc(module,"crypto_pbkdf2Sha256Hex",4,crypto_pbkdf2Sha256Hex);
     addFunc(module,"crypto_constantTimeHexEquals",2,crypto_constantTimeHexEquals);
+    addFunc(module,"crypto_md5",1,crypto_md5);
+    addFunc(module,"crypto_sha1",1,crypto_sha1);
+    addFunc(module,"crypto_sha256",1,crypto_sha256);
+    addFunc(module,"crypto_hmacSha256",2,crypto_hmacSha256);
+    addFunc(module,"crypto_pbkdf2Sha256",4,crypto_pbkdf2Sha256);
+    addFunc(module,"crypto_constantTimeEquals",2,crypto_constantTimeEquals);
+    addFunc(module,"crypto_digest",2,crypto_digest);
+    addFunc(module,"crypto_hashFile",2,crypto_hashFile);
+    addFunc(module,"crypto_hasher",1,crypto_hasher);
+    addFunc(module,"crypto_hmac",2,crypto_hmac);
+
+    for(const char *className : {"Hasher","Hmac"}) {
+        auto prefix = std::string("Crypto_") + className;
+        addFunc(module,(prefix + "_update").c_str(),2,crypto_hasherUpdate);
+        addFunc(module,(prefix + "_digest").c_str(),1,crypto_hasherDigest);
+        addFunc(module,(prefix + "_hexDigest").c_str(),1,crypto_hasherHexDigest);
+        addFunc(module,(prefix + "_reset").c_str(),1,crypto_hasherReset);
+    }
 
     return module;
 }
@@ -4,11 +4,25 @@
 #include <algorithm>
 #include <chrono>
 #include <climits>
+#include <condition_variable>
+#include <cstdint>
 #include <cstdlib>
+#include <deque>
 #include <filesystem>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 
+#if !defined(_WIN32)
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 namespace {
 
 using starbytes::Runtime::stdlib::failNativeIfEmpty;
@@ -30,6 +44,20 @@ StarbytesObject makeInt(int value) {
     return StarbytesNumNew(NumTypeInt,value);
 }
 
+StarbytesObject makeLong(int64_t value) {
+    return StarbytesNumNew(NumTypeLong,value);
+}
+
+bool readIntArg(StarbytesFuncArgs args,int &outValue) {
+    auto arg = StarbytesFuncArgsGetArg(args);
+    if(!arg || !StarbytesObjectTypecheck(arg,StarbytesNumType()) || StarbytesNumGetType(arg) != NumTypeInt) {
+        setNativeErrorIfEmpty(args,"expected Int argument");
+        return false;
+    }
+    outValue = StarbytesNumGetIntValue(arg);
+    return true;
+}
+
 bool readStringArg(StarbytesFuncArgs args,std::string &outValue) {
     auto arg = StarbytesFuncArgsGetArg(args);
     if(!arg || !StarbytesObjectTypecheck(arg,StarbytesStrType())) {
@@ -95,6 +123,12 @@ bool isIntRange(long long value) {
     return value >= INT_MIN && value <= INT_MAX;
 }
 
+int64_t fileTimeToEpochSeconds(std::filesystem::file_time_type fileTime) {
+    auto systemTime = std::chrono::time_point_cast<std::chrono::system_clock::duration>(
+        fileTime - std::filesystem::file_time_type::clock::now() + std::chrono::system_clock::now());
+    return std::chrono::duration_cast<std::chrono::seconds>(systemTime.time_since_epoch()).count();
+}
+
 STARBYTES_FUNC(fs_currentDirectory) {
     skipOptionalModuleReceiver(args,0);
     std::error_code ec;
@@ -272,9 +306,7 @@ STARBYTES_FUNC(fs_lastWriteEpochSeconds) {
         return failNativeIfEmpty(args,systemErrorMessage("lastWriteEpochSeconds failed",ec));
     }
 
-    auto systemTime = std::chrono::time_point_cast<std::chrono::system_clock::duration>(
-        fileTime - std::filesystem::file_time_type::clock::now() + std::chrono::system_clock::now());
-    auto seconds = std::chrono::duration_cast<std::chrono::seconds>(systemTime.time_since_epoch()).count();
+    auto seconds = fileTimeToEpochSeconds(fileTime);
     if(!isIntRange(seconds)) {
         return failNativeIfEmpty(args,"lastWriteEpochSeconds exceeded Int range");
     }
@@ -321,59 +353,603 @@ STARBYTES_FUNC(fs_removeTree) {
     return makeBool(removed > 0);
 }
 
-STARBYTES_FUNC(fs_walkPaths) {
-    skipOptionalModuleReceiver(args,3);
+bool globMatchFrom(const std::string &pattern,size_t p,const std::string &text,size_t t,std::vector<bool> &failed);
+
+bool globMatchSpan(const std::string &pattern,size_t p,const std::string &text,size_t t,std::vector<bool> &failed) {
+    while(p < pattern.size()) {
+        unsigned char c = static_cast<unsigned char>(pattern[p]);
+        if(c == '*') {
+            bool anyDepth = p + 1 < pattern.size() && pattern[p + 1] == '*';
+            p += anyDepth ? 2 : 1;
+            if(anyDepth && p < pattern.size() && pattern[p] == '/' && globMatchFrom(pattern,p + 1,text,t,failed)) {
+                return true;
+            }
+            for(size_t k = t;; ++k) {
+                if(globMatchFrom(pattern,p,text,k,failed)) {
+                    return true;
+                }
+                if(k >= text.size() || (!anyDepth && text[k] == '/')) {
+                    return false;
+                }
+            }
+        }
+        if(t >= text.size()) {
+            return false;
+        }
+        unsigned char current = static_cast<unsigned char>(text[t]);
+        if(c == '?') {
+            if(current == '/') {
+                return false;
+            }
+            ++p;
+            ++t;
+            continue;
+        }
+        if(c == '[') {
+            size_t q = p + 1;
+            bool negate = q < pattern.size() && (pattern[q] == '!' || pattern[q] == '^');
+            if(negate) {
+                ++q;
+            }
+            size_t first = q;
+            bool matched = false;
+            while(q < pattern.size() && (pattern[q] != ']' || q == first)) {
+                unsigned char low = static_cast<unsigned char>(pattern[q]);
+                unsigned char high = low;
+                if(q + 2 < pattern.size() && pattern[q + 1] == '-' && pattern[q + 2] != ']') {
+                    high = static_cast<unsigned char>(pattern[q + 2]);
+                    q += 3;
+                }
+                else {
+                    ++q;
+                }
+                if(current >= low && current <= high) {
+                    matched = true;
+                }
+            }
+            if(q < pattern.size()) {
+                if(matched == negate || current == '/') {
+                    return false;
+                }
+                p = q + 1;
+                ++t;
+                continue;
+            }
+            // No closing bracket, so '[' is literal.
+        }
+        if(c == '\\' && p + 1 < pattern.size()) {
+            c = static_cast<unsigned char>(pattern[++p]);
+        }
+        if(c != current) {
+            return false;
+        }
+        ++p;
+        ++t;
+    }
+    return t == text.size();
+}
+
+/// Remembers the (p, t) states that failed, so each wildcard tries each text position once instead of
+/// backtracking exponentially on patterns like `*a*a*a*b`.
+bool globMatchFrom(const std::string &pattern,size_t p,const std::string &text,size_t t,std::vector<bool> &failed) {
+    size_t state = p * (text.size() + 1) + t;
+    if(failed[state]) {
+        return false;
+    }
+    if(globMatchSpan(pattern,p,text,t,failed)) {
+        return true;
+    }
+    failed[state] = true;
+    return false;
+}
+
+/// Matches `*` and `?` within one path segment, `**` across segments, and `[...]` character classes.
+bool globMatch(const std::string &pattern,const std::string &text) {
+    std::vector<bool> failed((pattern.size() + 1) * (text.size() + 1),false);
+    return globMatchFrom(pattern,0,text,0,failed);
+}
+
+/// Patterns containing '/' match the path relative to the walk root; others match the entry name.
+struct WalkFilter {
+    std::vector<std::string> includes;
+    std::vector<std::string> excludes;
+
+    static bool matchesAny(const std::vector<std::string> &patterns,const std::string &relative,const std::string &name) {
+        for(const auto &pattern : patterns) {
+            const auto &subject = pattern.find('/') == std::string::npos ? name : relative;
+            if(globMatch(pattern,subject)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool excluded(const std::string &relative,const std::string &name) const {
+        return matchesAny(excludes,relative,name);
+    }
+
+    bool included(const std::string &relative,const std::string &name) const {
+        return includes.empty() || matchesAny(includes,relative,name);
+    }
+};
+
+struct WalkOptions {
     std::string root;
-    bool recursive = false;
+    bool recursive = true;
     bool includeDirectories = false;
-    if(!readStringArg(args,root) || !readBoolArg(args,recursive) || !readBoolArg(args,includeDirectories)) {
-        return nullptr;
+    /// When false, entry types come from the directory listing and no per-entry stat is made.
+    bool statEntries = true;
+    unsigned threads = 1;
+    WalkFilter filter;
+};
+
+/// isFile, isDirectory, size and modified describe a symlink's target when it resolves.
+struct WalkEntry {
+    std::string path;
+    bool isFile = false;
+    bool isDirectory = false;
+    bool isSymlink = false;
+    int64_t size = 0;
+    int64_t modifiedSeconds = 0;
+};
+
+constexpr size_t kWalkPublishBatch = 512;
+constexpr size_t kWalkerBufferedEntries = 16384;
+constexpr int kMaxWalkThreads = 64;
+
+/// Walks a tree with worker threads that share a stack of directories still to be listed. Each
+/// worker lists one directory at a time and hands entries over in batches. With a buffer limit,
+/// workers pause once that many entries are waiting, so a streaming walk holds a bounded number of
+/// paths however large the tree is.
+class DirectoryWalker {
+public:
+    DirectoryWalker(WalkOptions walkOptions,size_t bufferLimit):
+        options(std::move(walkOptions)),maxBuffered(bufferLimit) {}
+
+    ~DirectoryWalker() {
+        cancel();
     }
 
-    std::error_code ec;
-    auto rootPath = std::filesystem::path(root);
-    if(!std::filesystem::is_directory(rootPath,ec) || ec) {
-        return failNativeIfEmpty(args,ec ? systemErrorMessage("walkPaths failed",ec) : "walkPaths requires a directory path");
+    void start() {
+        pending.push_back(PendingDirectory{options.root,std::string()});
+        unsigned count = options.recursive ? std::max(1u,options.threads) : 1u;
+        workers.reserve(count);
+        for(unsigned i = 0; i < count; ++i) {
+            workers.emplace_back([this]() {
+                run();
+            });
+        }
     }
 
-    std::vector<std::string> values;
-    if(recursive) {
-        for(std::filesystem::recursive_directory_iterator it(rootPath,ec), end; it != end && !ec; it.increment(ec)) {
-            auto candidate = it->path();
-            bool isDir = it->is_directory(ec);
-            if(ec) {
-                return failNativeIfEmpty(args,systemErrorMessage("walkPaths failed",ec));
+    /// Moves up to maxEntries waiting entries into out, oldest first, blocking until some arrive. Returns false
+    /// once the walk is finished and every entry has been taken, or when the walk failed.
+    bool take(std::vector<WalkEntry> &out,size_t maxEntries) {
+        std::unique_lock<std::mutex> lock(mutex);
+        resultsReady.wait(lock,[&]() {
+            return !results.empty() || finished || !error.empty();
+        });
+        if(!error.empty()) {
+            return false;
+        }
+        auto count = std::min(maxEntries,results.size());
+        auto takenEnd = results.begin() + static_cast<std::ptrdiff_t>(count);
+        out.insert(out.end(),std::make_move_iterator(results.begin()),std::make_move_iterator(takenEnd));
+        results.erase(results.begin(),takenEnd);
+        lock.unlock();
+        resultsDrained.notify_all();
+        return count > 0;
+    }
+
+    bool done() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return (finished && results.empty()) || !error.empty();
+    }
+
+    std::string errorMessage() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return error;
+    }
+
+    void cancel() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            cancelled = true;
+        }
+        workReady.notify_all();
+        resultsDrained.notify_all();
+        resultsReady.notify_all();
+        for(auto &worker : workers) {
+            if(worker.joinable()) {
+                worker.join();
             }
-            if(includeDirectories || !isDir) {
-                values.emplace_back(pathToString(candidate));
+        }
+        workers.clear();
+    }
+
+private:
+    struct PendingDirectory {
+        std::string path;
+        std::string relative;
+    };
+
+    void run() {
+        std::vector<WalkEntry> entries;
+        std::vector<PendingDirectory> subdirectories;
+        for(;;) {
+            PendingDirectory directory;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                workReady.wait(lock,[&]() {
+                    return cancelled || finished || !pending.empty();
+                });
+                if(cancelled || finished) {
+                    return;
+                }
+                // Depth-first keeps the stack of unlisted directories short.
+                directory = std::move(pending.back());
+                pending.pop_back();
+                ++activeScans;
+            }
+
+            std::string failure;
+            scanDirectory(directory,entries,subdirectories,failure);
+            publish(entries,subdirectories);
+
+            bool walkEnded = false;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if(!failure.empty() && error.empty()) {
+                    error = failure;
+                    cancelled = true;
+                }
+                --activeScans;
+                if(activeScans == 0 && pending.empty()) {
+                    finished = true;
+                }
+                walkEnded = finished || cancelled;
+            }
+            if(walkEnded) {
+                workReady.notify_all();
+                resultsReady.notify_all();
             }
         }
     }
-    else {
-        for(std::filesystem::directory_iterator it(rootPath,ec), end; it != end && !ec; it.increment(ec)) {
-            auto candidate = it->path();
-            bool isDir = it->is_directory(ec);
-            if(ec) {
-                return failNativeIfEmpty(args,systemErrorMessage("walkPaths failed",ec));
+
+    void publish(std::vector<WalkEntry> &entries,std::vector<PendingDirectory> &subdirectories) {
+        if(entries.empty() && subdirectories.empty()) {
+            return;
+        }
+        size_t newDirectories = subdirectories.size();
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            if(maxBuffered > 0 && !entries.empty()) {
+                resultsDrained.wait(lock,[&]() {
+                    return cancelled || results.size() < maxBuffered;
+                });
             }
-            if(includeDirectories || !isDir) {
-                values.emplace_back(pathToString(candidate));
+            if(cancelled) {
+                entries.clear();
+                subdirectories.clear();
+                return;
             }
+            std::move(entries.begin(),entries.end(),std::back_inserter(results));
+            std::move(subdirectories.begin(),subdirectories.end(),std::back_inserter(pending));
+        }
+        entries.clear();
+        subdirectories.clear();
+        resultsReady.notify_one();
+        if(newDirectories == 1) {
+            workReady.notify_one();
+        }
+        else if(newDirectories > 1) {
+            workReady.notify_all();
         }
     }
 
-    if(ec) {
-        return failNativeIfEmpty(args,systemErrorMessage("walkPaths failed",ec));
+    void addEntry(const PendingDirectory &directory,const std::string &name,WalkEntry entry,bool descend,
+                  std::vector<WalkEntry> &entries,std::vector<PendingDirectory> &subdirectories) {
+        std::string relative = directory.relative.empty() ? name : directory.relative + "/" + name;
+        if(options.filter.excluded(relative,name)) {
+            return;
+        }
+        if(descend && options.recursive) {
+            subdirectories.push_back(PendingDirectory{entry.path,relative});
+        }
+        if(entry.isDirectory && !options.includeDirectories) {
+            return;
+        }
+        if(!options.filter.included(relative,name)) {
+            return;
+        }
+        entries.push_back(std::move(entry));
+        if(entries.size() >= kWalkPublishBatch) {
+            publish(entries,subdirectories);
+        }
+    }
+
+    std::string childPath(const std::string &directory,const std::string &name) const {
+        if(!directory.empty() && directory.back() == '/') {
+            return directory + name;
+        }
+        return directory + "/" + name;
+    }
+
+    bool isCancelled() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return cancelled;
+    }
+
+#if !defined(_WIN32)
+    /// Lists with readdir and stats each entry relative to the open directory with one fstatat call.
+    void scanDirectory(const PendingDirectory &directory,std::vector<WalkEntry> &entries,
+                       std::vector<PendingDirectory> &subdirectories,std::string &failure) {
+        DIR *handle = opendir(directory.path.c_str());
+        if(!handle) {
+            failure = systemErrorMessage("walk failed to open " + directory.path,std::error_code(errno,std::generic_category()));
+            return;
+        }
+        int handleFd = dirfd(handle);
+        size_t sinceCancelCheck = 0;
+        while(auto *item = readdir(handle)) {
+            const char *rawName = item->d_name;
+            if(rawName[0] == '.' && (rawName[1] == '\0' || (rawName[1] == '.' && rawName[2] == '\0'))) {
+                continue;
+            }
+            if(++sinceCancelCheck >= kWalkPublishBatch) {
+                sinceCancelCheck = 0;
+                if(isCancelled()) {
+                    break;
+                }
+            }
+
+            std::string name(rawName);
+            WalkEntry entry;
+            entry.path = childPath(directory.path,name);
+            bool needStat = options.statEntries;
+#if defined(DT_UNKNOWN)
+            needStat = needStat || item->d_type == DT_UNKNOWN || item->d_type == DT_LNK;
+            if(!needStat) {
+                entry.isDirectory = item->d_type == DT_DIR;
+                entry.isFile = item->d_type == DT_REG;
+            }
+#else
+            needStat = true;
+#endif
+            if(needStat) {
+                struct stat info;
+                if(fstatat(handleFd,rawName,&info,AT_SYMLINK_NOFOLLOW) != 0) {
+                    if(errno == ENOENT) {
+                        continue;
+                    }
+                    failure = systemErrorMessage("walk failed to stat " + entry.path,std::error_code(errno,std::generic_category()));
+                    break;
+                }
+                entry.isSymlink = S_ISLNK(info.st_mode);
+                if(entry.isSymlink) {
+                    struct stat target;
+                    if(fstatat(handleFd,rawName,&target,0) == 0) {
+                        info = target;
+                    }
+                }
+                entry.isDirectory = S_ISDIR(info.st_mode);
+                entry.isFile = S_ISREG(info.st_mode);
+                entry.size = static_cast<int64_t>(info.st_size);
+                entry.modifiedSeconds = static_cast<int64_t>(info.st_mtime);
+            }
+            bool descend = entry.isDirectory && !entry.isSymlink;
+            addEntry(directory,name,std::move(entry),descend,entries,subdirectories);
+        }
+        closedir(handle);
+    }
+#else
+    void scanDirectory(const PendingDirectory &directory,std::vector<WalkEntry> &entries,
+                       std::vector<PendingDirectory> &subdirectories,std::string &failure) {
+        std::error_code ec;
+        std::filesystem::directory_iterator it(std::filesystem::path(directory.path),ec), end;
+        for(; it != end && !ec; it.increment(ec)) {
+            if(isCancelled()) {
+                return;
+            }
+            std::error_code entryEc;
+            auto name = pathToString(it->path().filename());
+            WalkEntry entry;
+            entry.path = childPath(directory.path,name);
+            entry.isSymlink = it->is_symlink(entryEc);
+            entry.isDirectory = it->is_directory(entryEc);
+            entry.isFile = it->is_regular_file(entryEc);
+            if(options.statEntries) {
+                if(entry.isFile) {
+                    entry.size = static_cast<int64_t>(it->file_size(entryEc));
+                }
+                auto fileTime = it->last_write_time(entryEc);
+                if(!entryEc) {
+                    entry.modifiedSeconds = fileTimeToEpochSeconds(fileTime);
+                }
+            }
+            bool descend = entry.isDirectory && !entry.isSymlink;
+            addEntry(directory,name,std::move(entry),descend,entries,subdirectories);
+        }
+        if(ec) {
+            failure = systemErrorMessage("walk failed to list " + directory.path,ec);
+        }
     }
+#endif
 
-    std::sort(values.begin(),values.end());
+    WalkOptions options;
+    size_t maxBuffered = 0;
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable workReady;
+    std::condition_variable resultsReady;
+    std::condition_variable resultsDrained;
+    std::vector<PendingDirectory> pending;
+    std::deque<WalkEntry> results;
+    size_t activeScans = 0;
+    bool finished = false;
+    bool cancelled = false;
+    std::string error;
+};
+
+std::unordered_map<StarbytesObject,std::unique_ptr<DirectoryWalker>> g_walkerRegistry;
+
+/// Reads (path,recursive,includeDirectories,include,exclude,threads) and checks that path is a directory.
+bool readWalkOptions(StarbytesFuncArgs args,const char *caller,WalkOptions &options) {
+    std::string root;
+    int threads = 0;
+    if(!readStringArg(args,root) || !readBoolArg(args,options.recursive) || !readBoolArg(args,options.includeDirectories)
+       || !readStringArrayArg(args,options.filter.includes) || !readStringArrayArg(args,options.filter.excludes)
+       || !readIntArg(args,threads)) {
+        return false;
+    }
+    if(threads < 0 || threads > kMaxWalkThreads) {
+        setNativeErrorIfEmpty(args,std::string(caller) + " requires threads between 0 and " + std::to_string(kMaxWalkThreads));
+        return false;
+    }
+    if(threads == 0) {
+        threads = static_cast<int>(std::min<unsigned>(std::max(1u,std::thread::hardware_concurrency()),kMaxWalkThreads));
+    }
+    options.threads = static_cast<unsigned>(threads);
+
+    std::error_code ec;
+    auto rootPath = std::filesystem::path(root);
+    if(!std::filesystem::is_directory(rootPath,ec) || ec) {
+        setNativeErrorIfEmpty(args,ec ? systemErrorMessage(std::string(caller) + " failed",ec)
+                                      : std::string(caller) + " requires a directory path");
+        return false;
+    }
+    options.root = pathToString(rootPath);
+    return true;
+}
+
+/// Runs a walk to completion on the calling thread's behalf and returns every entry sorted by path.
+bool collectWalk(WalkOptions options,std::vector<WalkEntry> &outEntries,std::string &outError) {
+    DirectoryWalker walker(std::move(options),0);
+    walker.start();
+    while(walker.take(outEntries,SIZE_MAX)) {
+    }
+    outError = walker.errorMessage();
+    if(!outError.empty()) {
+        return false;
+    }
+    std::sort(outEntries.begin(),outEntries.end(),[](const WalkEntry &lhs,const WalkEntry &rhs) {
+        return lhs.path < rhs.path;
+    });
+    return true;
+}
+
+StarbytesObject makeDirEntry(const WalkEntry &entry) {
+    auto object = StarbytesObjectNew(StarbytesMakeClass("DirEntry"));
+    StarbytesObjectAddProperty(object,(char *)"path",StarbytesStrNewWithData(entry.path.c_str()));
+    StarbytesObjectAddProperty(object,(char *)"isFile",makeBool(entry.isFile));
+    StarbytesObjectAddProperty(object,(char *)"isDirectory",makeBool(entry.isDirectory));
+    StarbytesObjectAddProperty(object,(char *)"isSymlink",makeBool(entry.isSymlink));
+    StarbytesObjectAddProperty(object,(char *)"size",makeLong(entry.size));
+    StarbytesObjectAddProperty(object,(char *)"modified",makeLong(entry.modifiedSeconds));
+    return object;
+}
+
+StarbytesObject makeDirEntryArray(const std::vector<WalkEntry> &entries) {
     auto result = StarbytesArrayNew();
-    for(const auto &item : values) {
-        StarbytesArrayPush(result,StarbytesStrNewWithData(item.c_str()));
+    for(const auto &entry : entries) {
+        StarbytesArrayPush(result,makeDirEntry(entry));
     }
     return result;
 }
 
+STARBYTES_FUNC(fs_walkPaths) {
+    skipOptionalModuleReceiver(args,3);
+    std::string root;
+    WalkOptions options;
+    if(!readStringArg(args,root) || !readBoolArg(args,options.recursive) || !readBoolArg(args,options.includeDirectories)) {
+        return nullptr;
+    }
+
+    std::error_code ec;
+    auto rootPath = std::filesystem::path(root);
+    if(!std::filesystem::is_directory(rootPath,ec) || ec) {
+        return failNativeIfEmpty(args,ec ? systemErrorMessage("walkPaths failed",ec) : "walkPaths requires a directory path");
+    }
+    options.root = pathToString(rootPath);
+    options.statEntries = false;
+    options.threads = std::min<unsigned>(std::max(1u,std::thread::hardware_concurrency()),kMaxWalkThreads);
+
+    std::vector<WalkEntry> entries;
+    std::string error;
+    if(!collectWalk(std::move(options),entries,error)) {
+        return failNativeIfEmpty(args,"walkPaths failed: " + error);
+    }
+
+    auto result = StarbytesArrayNew();
+    for(const auto &entry : entries) {
+        StarbytesArrayPush(result,StarbytesStrNewWithData(entry.path.c_str()));
+    }
+    return result;
+}
+
+STARBYTES_FUNC(fs_walk) {
+    skipOptionalModuleReceiver(args,6);
+    WalkOptions options;
+    if(!readWalkOptions(args,"walk",options)) {
+        return nullptr;
+    }
+
+    std::vector<WalkEntry> entries;
+    std::string error;
+    if(!collectWalk(std::move(options),entries,error)) {
+        return failNativeIfEmpty(args,error);
+    }
+    return makeDirEntryArray(entries);
+}
+
+STARBYTES_FUNC(fs_openWalker) {
+    skipOptionalModuleReceiver(args,6);
+    WalkOptions options;
+    if(!readWalkOptions(args,"openWalker",options)) {
+        return nullptr;
+    }
+
+    auto walker = std::make_unique<DirectoryWalker>(std::move(options),kWalkerBufferedEntries);
+    walker->start();
+    auto object = StarbytesObjectNew(StarbytesMakeClass("DirWalker"));
+    g_walkerRegistry[object] = std::move(walker);
+    return object;
+}
+
+STARBYTES_FUNC(fs_walkerNext) {
+    auto self = StarbytesFuncArgsGetArg(args);
+    auto it = g_walkerRegistry.find(self);
+    if(it == g_walkerRegistry.end()) {
+        return failNativeIfEmpty(args,"walker is closed");
+    }
+    int maxEntries = 0;
+    if(!readIntArg(args,maxEntries) || maxEntries <= 0) {
+        return failNativeIfEmpty(args,"next requires a positive maxEntries");
+    }
+
+    std::vector<WalkEntry> entries;
+    entries.reserve(std::min<size_t>(static_cast<size_t>(maxEntries),kWalkerBufferedEntries));
+    if(!it->second->take(entries,static_cast<size_t>(maxEntries))) {
+        auto error = it->second->errorMessage();
+        if(!error.empty()) {
+            return failNativeIfEmpty(args,error);
+        }
+    }
+    return makeDirEntryArray(entries);
+}
+
+STARBYTES_FUNC(fs_walkerIsDone) {
+    auto it = g_walkerRegistry.find(StarbytesFuncArgsGetArg(args));
+    if(it == g_walkerRegistry.end()) {
+        return makeBool(true);
+    }
+    return makeBool(it->second->done());
+}
+
+STARBYTES_FUNC(fs_walkerClose) {
+    auto self = StarbytesFuncArgsGetArg(args);
+    return makeBool(g_walkerRegistry.erase(self) > 0);
+}
+
 STARBYTES_FUNC(fs_tempDirectory) {
     skipOptionalModuleReceiver(args,0);
     std::error_code ec;
@@ -441,6 +1017,11 @@ STARBYTES_NATIVE_MOD_MAIN() {
     addFunc(module,"fs_copyPath",4,fs_copyPath);
     addFunc(module,"fs_removeTree",1,fs_removeTree);
     addFunc(module,"fs_walkPaths",3,fs_walkPaths);
+    addFunc(module,"fs_walk",6,fs_walk);
+    addFunc(module,"fs_openWalker",6,fs_openWalker);
+    addFunc(module,"FS_DirWalker_next",2,fs_walkerNext);
+    addFunc(module,"FS_DirWalker_isDone",1,fs_walkerIsDone);
+    addFunc(module,"FS_DirWalker_close",1,fs_walkerClose);
     addFunc(module,"fs_tempDirectory",0,fs_tempDirectory);
     addFunc(module,"fs_homeDirectory",0,fs_homeDirectory);
 
@@ -5,8 +5,11 @@
 #include <algorithm>
 #include <climits>
 #include <cctype>
+#include <cstdint>
+#include <memory>
 #include <mutex>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #ifdef STARBYTES_HAS_CURL
@@ -16,7 +19,9 @@
 namespace {
 
 using starbytes::string_map;
+using starbytes::Runtime::stdlib::ByteView;
 using starbytes::Runtime::stdlib::failNativeIfEmpty;
+using starbytes::Runtime::stdlib::readByteView;
 using starbytes::Runtime::stdlib::setNativeErrorIfEmpty;
 
 struct NativeArgsLayout {
@@ -30,6 +35,7 @@ struct HttpResult {
     long status = 0;
     std::string body;
     string_map<std::string> headers;
+    std::string error;
 };
 
 #ifdef STARBYTES_HAS_CURL
@@ -65,6 +71,15 @@ bool readIntArg(StarbytesFuncArgs args,int &outValue) {
     return true;
 }
 
+bool readBytesArg(StarbytesFuncArgs args,ByteView &outValue) {
+    auto arg = StarbytesFuncArgsGetArg(args);
+    if(!readByteView(arg,outValue)) {
+        setNativeErrorIfEmpty(args,"expected Bytes argument");
+        return false;
+    }
+    return true;
+}
+
 bool readStringArrayArg(StarbytesFuncArgs args,std::vector<std::string> &outValues) {
     auto arg = StarbytesFuncArgsGetArg(args);
     if(!arg || !StarbytesObjectTypecheck(arg,StarbytesArrayType())) {
@@ -146,28 +161,27 @@ bool ensureCurlInitialized() {
     return true;
 }
 
-HttpResult performHttpRequest(const std::string &method,
-                              const std::string &url,
-                              const std::string &body,
-                              int timeoutMillis,
-                              const std::vector<std::string> &requestHeaders) {
-    HttpResult result;
-    if(url.empty()) {
-        return result;
-    }
-
-    ensureCurlInitialized();
-
-    CURL *easy = curl_easy_init();
-    if(!easy) {
-        return result;
-    }
+std::string upperCaseMethod(const std::string &method) {
+    auto upperMethod = method;
+    std::transform(upperMethod.begin(),upperMethod.end(),upperMethod.begin(),[](unsigned char c) {
+        return static_cast<char>(std::toupper(c));
+    });
+    return upperMethod;
+}
 
-    struct curl_slist *headerList = nullptr;
-    for(const auto &entry : requestHeaders) {
-        headerList = curl_slist_append(headerList,entry.c_str());
+/// Applies the per-request options shared by one-shot requests and HttpClient transfers.
+/// `body`, `headerList` and `result` must stay alive until the transfer completes.
+void configureEasyHandle(CURL *easy,
+                         const std::string &method,
+                         const std::string &url,
+                         const char *body,
+                         size_t bodyLength,
+                         int timeoutMillis,
+                         struct curl_slist *headerList,
+                         HttpResult &result) {
+    if(!body) {
+        body = "";
     }
-
     curl_easy_setopt(easy,CURLOPT_URL,url.c_str());
     curl_easy_setopt(easy,CURLOPT_FOLLOWLOCATION,1L);
     curl_easy_setopt(easy,CURLOPT_WRITEFUNCTION,writeBodyCallback);
@@ -183,23 +197,45 @@ HttpResult performHttpRequest(const std::string &method,
         curl_easy_setopt(easy,CURLOPT_HTTPHEADER,headerList);
     }
 
-    auto upperMethod = method;
-    std::transform(upperMethod.begin(),upperMethod.end(),upperMethod.begin(),[](unsigned char c) {
-        return static_cast<char>(std::toupper(c));
-    });
-
+    auto upperMethod = upperCaseMethod(method);
     if(upperMethod == "POST") {
         curl_easy_setopt(easy,CURLOPT_POST,1L);
-        curl_easy_setopt(easy,CURLOPT_POSTFIELDS,body.c_str());
-        curl_easy_setopt(easy,CURLOPT_POSTFIELDSIZE,(long)body.size());
+        curl_easy_setopt(easy,CURLOPT_POSTFIELDS,body);
+        curl_easy_setopt(easy,CURLOPT_POSTFIELDSIZE_LARGE,(curl_off_t)bodyLength);
     }
     else if(upperMethod != "GET") {
         curl_easy_setopt(easy,CURLOPT_CUSTOMREQUEST,upperMethod.c_str());
-        if(!body.empty()) {
-            curl_easy_setopt(easy,CURLOPT_POSTFIELDS,body.c_str());
-            curl_easy_setopt(easy,CURLOPT_POSTFIELDSIZE,(long)body.size());
+        if(bodyLength > 0) {
+            curl_easy_setopt(easy,CURLOPT_POSTFIELDS,body);
+            curl_easy_setopt(easy,CURLOPT_POSTFIELDSIZE_LARGE,(curl_off_t)bodyLength);
         }
     }
+}
+
+HttpResult performHttpRequest(const std::string &method,
+                              const std::string &url,
+                              const char *body,
+                              size_t bodyLength,
+                              int timeoutMillis,
+                              const std::vector<std::string> &requestHeaders) {
+    HttpResult result;
+    if(url.empty()) {
+        return result;
+    }
+
+    ensureCurlInitialized();
+
+    CURL *easy = curl_easy_init();
+    if(!easy) {
+        return result;
+    }
+
+    struct curl_slist *headerList = nullptr;
+    for(const auto &entry : requestHeaders) {
+        headerList = curl_slist_append(headerList,entry.c_str());
+    }
+
+    configureEasyHandle(easy,method,url,body,bodyLength,timeoutMillis,headerList,result);
 
     auto code = curl_easy_perform(easy);
     if(code == CURLE_OK) {
@@ -244,8 +280,10 @@ StarbytesObject makeHttpResponseObject(const HttpResult &result) {
 
     StarbytesObjectAddProperty(response,(char *)"status",makeInt(status));
     StarbytesObjectAddProperty(response,(char *)"body",StarbytesStrNewWithData(result.body.c_str()));
+    StarbytesObjectAddProperty(response,(char *)"bodyBytes",StarbytesBytesNewWithData(result.body.data(),result.body.size()));
     StarbytesObjectAddProperty(response,(char *)"headers",makeHeadersDict(result.headers));
     StarbytesObjectAddProperty(response,(char *)"ok",makeBool(result.ok && status >= 200 && status < 300));
+    StarbytesObjectAddProperty(response,(char *)"error",StarbytesStrNewWithData(result.error.c_str()));
     return response;
 }
 
@@ -260,7 +298,7 @@ STARBYTES_FUNC(http_get) {
     }
 
 #ifdef STARBYTES_HAS_CURL
-    auto result = performHttpRequest("GET",url,"",timeoutMillis,headers);
+    auto result = performHttpRequest("GET",url,"",0,timeoutMillis,headers);
     if(!result.ok) {
         return failNativeIfEmpty(args,"HTTP GET request failed");
     }
@@ -282,7 +320,7 @@ STARBYTES_FUNC(http_post) {
     }
 
 #ifdef STARBYTES_HAS_CURL
-    auto result = performHttpRequest("POST",url,body,timeoutMillis,headers);
+    auto result = performHttpRequest("POST",url,body.data(),body.size(),timeoutMillis,headers);
     if(!result.ok) {
         return failNativeIfEmpty(args,"HTTP POST request failed");
     }
@@ -306,7 +344,31 @@ STARBYTES_FUNC(http_request) {
     }
 
 #ifdef STARBYTES_HAS_CURL
-    auto result = performHttpRequest(method,url,body,timeoutMillis,headers);
+    auto result = performHttpRequest(method,url,body.data(),body.size(),timeoutMillis,headers);
+    if(!result.ok) {
+        return failNativeIfEmpty(args,"HTTP request failed");
+    }
+    return makeHttpResponseObject(result);
+#else
+    return failNativeIfEmpty(args,"HTTP support is unavailable");
+#endif
+}
+
+STARBYTES_FUNC(http_requestBytes) {
+    skipOptionalModuleReceiver(args,5);
+
+    std::string method;
+    std::string url;
+    ByteView body;
+    int timeoutMillis = 0;
+    std::vector<std::string> headers;
+    if(!readStringArg(args,method) || !readStringArg(args,url) || !readBytesArg(args,body)
+       || !readIntArg(args,timeoutMillis) || !readStringArrayArg(args,headers)) {
+        return nullptr;
+    }
+
+#ifdef STARBYTES_HAS_CURL
+    auto result = performHttpRequest(method,url,reinterpret_cast<const char *>(body.data),body.length,timeoutMillis,headers);
     if(!result.ok) {
         return failNativeIfEmpty(args,"HTTP request failed");
     }
@@ -316,6 +378,576 @@ STARBYTES_FUNC(http_request) {
 #endif
 }
 
+STARBYTES_FUNC(http_newRequest) {
+    skipOptionalModuleReceiver(args,4);
+
+    auto method = StarbytesFuncArgsGetArg(args);
+    auto url = StarbytesFuncArgsGetArg(args);
+    auto body = StarbytesFuncArgsGetArg(args);
+    auto headers = StarbytesFuncArgsGetArg(args);
+    ByteView bodyView;
+    if(!method || !StarbytesObjectTypecheck(method,StarbytesStrType())
+       || !url || !StarbytesObjectTypecheck(url,StarbytesStrType())) {
+        return failNativeIfEmpty(args,"expected String argument");
+    }
+    if(!readByteView(body,bodyView)) {
+        return failNativeIfEmpty(args,"expected Bytes argument");
+    }
+    if(!headers || !StarbytesObjectTypecheck(headers,StarbytesArrayType())) {
+        return failNativeIfEmpty(args,"expected Array<String> argument");
+    }
+
+    auto request = StarbytesObjectNew(StarbytesMakeClass("HttpRequest"));
+    for(auto field : {method,url,body,headers}) {
+        StarbytesObjectReference(field);
+    }
+    StarbytesObjectAddProperty(request,(char *)"method",method);
+    StarbytesObjectAddProperty(request,(char *)"url",url);
+    StarbytesObjectAddProperty(request,(char *)"body",body);
+    StarbytesObjectAddProperty(request,(char *)"headers",headers);
+    return request;
+}
+
+#ifdef STARBYTES_HAS_CURL
+constexpr int kClientPollMillis = 50;
+constexpr size_t kMaxIdleEasyHandles = 16;
+
+struct HttpRequestSpec {
+    std::string method;
+    std::string url;
+    ByteView body;
+    StarbytesObject bodyOwner = nullptr;
+    std::vector<std::string> headers;
+};
+
+struct HttpTransfer {
+    uint64_t id = 0;
+    struct curl_slist *headerList = nullptr;
+    ByteView body;
+    StarbytesObject bodyOwner = nullptr;
+    StarbytesTask task = nullptr;
+    HttpResult result;
+    char errorBuffer[CURL_ERROR_SIZE] = {};
+};
+
+struct HttpClientMetrics {
+    uint64_t requests = 0;
+    uint64_t failures = 0;
+    uint64_t connectionsOpened = 0;
+    uint64_t bytesReceived = 0;
+    curl_off_t nameLookupMicros = 0;
+    curl_off_t connectMicros = 0;
+    curl_off_t tlsMicros = 0;
+    curl_off_t firstByteMicros = 0;
+    curl_off_t totalMicros = 0;
+};
+
+/// One HttpClient: a multi handle that owns the connection pool, a share handle for the DNS and
+/// TLS session caches, and recycled easy handles. Transfers run only while the client is driven,
+/// either by a blocking call on it or by `await` through the task driver.
+struct HttpClientState {
+    CURLM *multi = nullptr;
+    CURLSH *share = nullptr;
+    int timeoutMillis = 0;
+    uint64_t nextTransferId = 1;
+    std::vector<CURL *> idleHandles;
+    std::unordered_map<CURL *,std::unique_ptr<HttpTransfer>> active;
+    std::unordered_map<uint64_t,std::unique_ptr<HttpTransfer>> finished;
+    HttpClientMetrics metrics;
+
+    ~HttpClientState();
+};
+
+/// Clients with transfers in flight after an async request, mapped to their object. The entry holds
+/// a reference, so a client dropped mid-transfer stays alive until the task driver settles them.
+std::unordered_map<HttpClientState *,StarbytesObject> g_drivenClients;
+
+void releaseTransferResources(HttpTransfer &transfer) {
+    if(transfer.headerList) {
+        curl_slist_free_all(transfer.headerList);
+        transfer.headerList = nullptr;
+    }
+    if(transfer.bodyOwner) {
+        StarbytesObjectRelease(transfer.bodyOwner);
+        transfer.bodyOwner = nullptr;
+    }
+}
+
+void settleTransferTask(HttpTransfer &transfer) {
+    if(!transfer.task) {
+        return;
+    }
+    if(transfer.result.ok) {
+        auto response = makeHttpResponseObject(transfer.result);
+        StarbytesTaskResolve(transfer.task,response);
+        StarbytesObjectRelease(response);
+    }
+    else {
+        StarbytesTaskReject(transfer.task,transfer.result.error.c_str());
+    }
+    StarbytesObjectRelease(transfer.task);
+    transfer.task = nullptr;
+}
+
+HttpClientState::~HttpClientState() {
+    for(auto &entry : active) {
+        curl_multi_remove_handle(multi,entry.first);
+        curl_easy_cleanup(entry.first);
+        auto &transfer = *entry.second;
+        releaseTransferResources(transfer);
+        transfer.result.ok = false;
+        transfer.result.error = "HttpClient was closed";
+        settleTransferTask(transfer);
+    }
+    for(auto *easy : idleHandles) {
+        curl_easy_cleanup(easy);
+    }
+    if(multi) {
+        curl_multi_cleanup(multi);
+    }
+    if(share) {
+        curl_share_cleanup(share);
+    }
+}
+
+void recordTransferMetrics(HttpClientMetrics &metrics,CURL *easy,const HttpResult &result) {
+    ++metrics.requests;
+    if(!result.ok) {
+        ++metrics.failures;
+    }
+    metrics.bytesReceived += result.body.size();
+
+    long connects = 0;
+    if(curl_easy_getinfo(easy,CURLINFO_NUM_CONNECTS,&connects) == CURLE_OK && connects > 0) {
+        metrics.connectionsOpened += (uint64_t)connects;
+    }
+
+    curl_off_t micros = 0;
+    if(curl_easy_getinfo(easy,CURLINFO_NAMELOOKUP_TIME_T,&micros) == CURLE_OK) {
+        metrics.nameLookupMicros += micros;
+    }
+    if(curl_easy_getinfo(easy,CURLINFO_CONNECT_TIME_T,&micros) == CURLE_OK) {
+        metrics.connectMicros += micros;
+    }
+    if(curl_easy_getinfo(easy,CURLINFO_APPCONNECT_TIME_T,&micros) == CURLE_OK) {
+        metrics.tlsMicros += micros;
+    }
+    if(curl_easy_getinfo(easy,CURLINFO_STARTTRANSFER_TIME_T,&micros) == CURLE_OK) {
+        metrics.firstByteMicros += micros;
+    }
+    if(curl_easy_getinfo(easy,CURLINFO_TOTAL_TIME_T,&micros) == CURLE_OK) {
+        metrics.totalMicros += micros;
+    }
+}
+
+void finishTransfer(HttpClientState &client,CURL *easy,CURLcode code) {
+    auto it = client.active.find(easy);
+    if(it == client.active.end()) {
+        return;
+    }
+    auto transfer = std::move(it->second);
+    client.active.erase(it);
+    curl_multi_remove_handle(client.multi,easy);
+
+    auto &result = transfer->result;
+    if(code == CURLE_OK) {
+        curl_easy_getinfo(easy,CURLINFO_RESPONSE_CODE,&result.status);
+        result.ok = true;
+    }
+    else {
+        result.error = transfer->errorBuffer[0] != '\0' ? transfer->errorBuffer : curl_easy_strerror(code);
+    }
+    recordTransferMetrics(client.metrics,easy,result);
+    releaseTransferResources(*transfer);
+
+    curl_easy_reset(easy);
+    if(client.idleHandles.size() < kMaxIdleEasyHandles) {
+        client.idleHandles.push_back(easy);
+    }
+    else {
+        curl_easy_cleanup(easy);
+    }
+
+    if(transfer->task) {
+        settleTransferTask(*transfer);
+    }
+    else {
+        client.finished[transfer->id] = std::move(transfer);
+    }
+}
+
+/// Runs ready transfers, waiting up to `waitMillis` for socket activity first.
+void pumpClient(HttpClientState &client,int waitMillis) {
+    int running = 0;
+    curl_multi_perform(client.multi,&running);
+    if(running > 0 && waitMillis > 0) {
+        curl_multi_poll(client.multi,nullptr,0,waitMillis,nullptr);
+        curl_multi_perform(client.multi,&running);
+    }
+
+    int queued = 0;
+    while(CURLMsg *message = curl_multi_info_read(client.multi,&queued)) {
+        if(message->msg != CURLMSG_DONE) {
+            continue;
+        }
+        auto *easy = message->easy_handle;
+        auto code = message->data.result;
+        finishTransfer(client,easy,code);
+    }
+}
+
+/// Advances transfers without waiting on their sockets; `await` bounds how long it sleeps between
+/// runs, so active transfers are still polled promptly.
+int http_driveClients() {
+    std::vector<StarbytesObject> idle;
+    for(auto it = g_drivenClients.begin(); it != g_drivenClients.end();) {
+        auto &client = *it->first;
+        pumpClient(client,0);
+        if(client.active.empty()) {
+            idle.push_back(it->second);
+            it = g_drivenClients.erase(it);
+        }
+        else {
+            ++it;
+        }
+    }
+    bool active = !g_drivenClients.empty();
+    // Released after the loop: dropping the last reference frees the client.
+    for(auto object : idle) {
+        StarbytesObjectRelease(object);
+    }
+    return active ? 1 : 0;
+}
+
+void driveClient(HttpClientState &client,StarbytesObject self) {
+    if(client.active.empty() || g_drivenClients.count(&client) > 0) {
+        return;
+    }
+    StarbytesObjectReference(self);
+    g_drivenClients[&client] = self;
+}
+
+bool readRequestSpec(StarbytesObject request,HttpRequestSpec &out,std::string &error) {
+    if(!request) {
+        error = "expected HttpRequest argument";
+        return false;
+    }
+    auto method = StarbytesObjectGetProperty(request,"method");
+    auto url = StarbytesObjectGetProperty(request,"url");
+    auto body = StarbytesObjectGetProperty(request,"body");
+    auto headers = StarbytesObjectGetProperty(request,"headers");
+    if(!method || !StarbytesObjectTypecheck(method,StarbytesStrType())
+       || !url || !StarbytesObjectTypecheck(url,StarbytesStrType())
+       || !readByteView(body,out.body)
+       || !headers || !StarbytesObjectTypecheck(headers,StarbytesArrayType())) {
+        error = "expected HttpRequest argument";
+        return false;
+    }
+    out.method = StarbytesStrGetBuffer(method);
+    out.url = StarbytesStrGetBuffer(url);
+    out.bodyOwner = body;
+    if(out.url.empty()) {
+        error = "HttpRequest url is empty";
+        return false;
+    }
+
+    auto count = StarbytesArrayGetLength(headers);
+    out.headers.clear();
+    out.headers.reserve(count);
+    for(unsigned i = 0; i < count; ++i) {
+        auto item = StarbytesArrayIndex(headers,i);
+        if(!item || !StarbytesObjectTypecheck(item,StarbytesStrType())) {
+            error = "HttpRequest headers must be strings";
+            return false;
+        }
+        out.headers.emplace_back(StarbytesStrGetBuffer(item));
+    }
+    return true;
+}
+
+/// Queues a transfer on the client's multi handle and returns its id, or 0 on failure.
+uint64_t startTransfer(HttpClientState &client,HttpRequestSpec &spec,StarbytesTask task,std::string &error) {
+    CURL *easy = nullptr;
+    if(!client.idleHandles.empty()) {
+        easy = client.idleHandles.back();
+        client.idleHandles.pop_back();
+    }
+    else {
+        easy = curl_easy_init();
+    }
+    if(!easy) {
+        error = "failed to create HTTP transfer";
+        return 0;
+    }
+
+    auto transfer = std::make_unique<HttpTransfer>();
+    transfer->id = client.nextTransferId++;
+    for(const auto &entry : spec.headers) {
+        transfer->headerList = curl_slist_append(transfer->headerList,entry.c_str());
+    }
+    transfer->body = std::move(spec.body);
+    transfer->bodyOwner = spec.bodyOwner;
+    if(transfer->bodyOwner) {
+        StarbytesObjectReference(transfer->bodyOwner);
+    }
+
+    configureEasyHandle(easy,spec.method,spec.url,reinterpret_cast<const char *>(transfer->body.data),transfer->body.length,
+                        client.timeoutMillis,transfer->headerList,transfer->result);
+    curl_easy_setopt(easy,CURLOPT_SHARE,client.share);
+    curl_easy_setopt(easy,CURLOPT_ERRORBUFFER,transfer->errorBuffer);
+    curl_easy_setopt(easy,CURLOPT_TCP_KEEPALIVE,1L);
+    curl_easy_setopt(easy,CURLOPT_HTTP_VERSION,(long)CURL_HTTP_VERSION_2TLS);
+
+    if(curl_multi_add_handle(client.multi,easy) != CURLM_OK) {
+        releaseTransferResources(*transfer);
+        curl_easy_cleanup(easy);
+        error = "failed to queue HTTP transfer";
+        return 0;
+    }
+    if(task) {
+        StarbytesObjectReference(task);
+        transfer->task = task;
+    }
+    auto id = transfer->id;
+    client.active[easy] = std::move(transfer);
+    return id;
+}
+
+std::unique_ptr<HttpTransfer> waitForTransfer(HttpClientState &client,uint64_t id) {
+    auto it = client.finished.find(id);
+    while(it == client.finished.end()) {
+        pumpClient(client,kClientPollMillis);
+        it = client.finished.find(id);
+    }
+    auto transfer = std::move(it->second);
+    client.finished.erase(it);
+    return transfer;
+}
+
+void destroyClient(void *data) {
+    delete static_cast<HttpClientState *>(data);
+}
+
+HttpClientState *findClient(StarbytesObject self) {
+    return self ? static_cast<HttpClientState *>(StarbytesObjectGetNativeData(self,destroyClient)) : nullptr;
+}
+
+HttpClientState *requireClientSelf(StarbytesFuncArgs args,StarbytesObject *selfOut = nullptr) {
+    auto self = StarbytesFuncArgsGetArg(args);
+    auto *client = findClient(self);
+    if(!client) {
+        setNativeErrorIfEmpty(args,"HttpClient receiver is missing or closed");
+        return nullptr;
+    }
+    if(selfOut) {
+        *selfOut = self;
+    }
+    return client;
+}
+
+StarbytesObject makeMetricCount(uint64_t value) {
+    return makeInt(value > (uint64_t)INT_MAX ? INT_MAX : (int)value);
+}
+
+StarbytesObject makeAverageMillis(curl_off_t totalMicros,uint64_t count) {
+    double average = count > 0 ? (double)totalMicros / (double)count / 1000.0 : 0.0;
+    return StarbytesNumNew(NumTypeDouble,average);
+}
+
+void setMetric(StarbytesObject dict,const char *name,StarbytesObject value) {
+    StarbytesDictSet(dict,StarbytesStrNewWithData(name),value);
+}
+#endif
+
+STARBYTES_FUNC(http_client) {
+    skipOptionalModuleReceiver(args,3);
+
+    int maxConnections = 0;
+    int maxConnectionsPerHost = 0;
+    int timeoutMillis = 0;
+    if(!readIntArg(args,maxConnections) || !readIntArg(args,maxConnectionsPerHost) || !readIntArg(args,timeoutMillis)) {
+        return nullptr;
+    }
+    if(maxConnections < 0 || maxConnectionsPerHost < 0 || timeoutMillis < 0) {
+        return failNativeIfEmpty(args,"HttpClient limits must not be negative");
+    }
+
+#ifdef STARBYTES_HAS_CURL
+    ensureCurlInitialized();
+
+    auto state = std::make_unique<HttpClientState>();
+    state->timeoutMillis = timeoutMillis;
+    state->multi = curl_multi_init();
+    state->share = curl_share_init();
+    if(!state->multi || !state->share) {
+        return failNativeIfEmpty(args,"failed to create HttpClient");
+    }
+    curl_share_setopt(state->share,CURLSHOPT_SHARE,CURL_LOCK_DATA_DNS);
+    curl_share_setopt(state->share,CURLSHOPT_SHARE,CURL_LOCK_DATA_SSL_SESSION);
+
+    curl_multi_setopt(state->multi,CURLMOPT_PIPELINING,(long)CURLPIPE_MULTIPLEX);
+    if(maxConnections > 0) {
+        curl_multi_setopt(state->multi,CURLMOPT_MAX_TOTAL_CONNECTIONS,(long)maxConnections);
+        curl_multi_setopt(state->multi,CURLMOPT_MAXCONNECTS,(long)maxConnections);
+    }
+    if(maxConnectionsPerHost > 0) {
+        curl_multi_setopt(state->multi,CURLMOPT_MAX_HOST_CONNECTIONS,(long)maxConnectionsPerHost);
+    }
+
+    // The object owns the client: freeing it closes the client's connections.
+    auto object = StarbytesObjectNew(StarbytesMakeClass("HttpClient"));
+    StarbytesObjectSetNativeData(object,state.release(),destroyClient);
+    return object;
+#else
+    return failNativeIfEmpty(args,"HTTP support is unavailable");
+#endif
+}
+
+STARBYTES_FUNC(http_clientRequest) {
+#ifdef STARBYTES_HAS_CURL
+    auto *client = requireClientSelf(args);
+    if(!client) {
+        return nullptr;
+    }
+    HttpRequestSpec spec;
+    std::string error;
+    if(!readRequestSpec(StarbytesFuncArgsGetArg(args),spec,error)) {
+        return failNativeIfEmpty(args,error);
+    }
+    auto id = startTransfer(*client,spec,nullptr,error);
+    if(id == 0) {
+        return failNativeIfEmpty(args,error);
+    }
+    auto transfer = waitForTransfer(*client,id);
+    if(!transfer->result.ok) {
+        return failNativeIfEmpty(args,"HTTP request failed: " + transfer->result.error);
+    }
+    return makeHttpResponseObject(transfer->result);
+#else
+    return failNativeIfEmpty(args,"HTTP support is unavailable");
+#endif
+}
+
+STARBYTES_FUNC(http_clientRequestAsync) {
+#ifdef STARBYTES_HAS_CURL
+    StarbytesObject self = nullptr;
+    auto *client = requireClientSelf(args,&self);
+    if(!client) {
+        return nullptr;
+    }
+    auto task = StarbytesTaskNew();
+    HttpRequestSpec spec;
+    std::string error;
+    if(!readRequestSpec(StarbytesFuncArgsGetArg(args),spec,error) || startTransfer(*client,spec,task,error) == 0) {
+        StarbytesTaskReject(task,error.c_str());
+        return task;
+    }
+    pumpClient(*client,0);
+    driveClient(*client,self);
+    return task;
+#else
+    auto task = StarbytesTaskNew();
+    StarbytesTaskReject(task,"HTTP support is unavailable");
+    return task;
+#endif
+}
+
+STARBYTES_FUNC(http_clientRequestAll) {
+#ifdef STARBYTES_HAS_CURL
+    auto *client = requireClientSelf(args);
+    if(!client) {
+        return nullptr;
+    }
+    auto requests = StarbytesFuncArgsGetArg(args);
+    if(!requests || !StarbytesObjectTypecheck(requests,StarbytesArrayType())) {
+        return failNativeIfEmpty(args,"expected Array<HttpRequest> argument");
+    }
+
+    auto count = StarbytesArrayGetLength(requests);
+    std::vector<HttpRequestSpec> specs(count);
+    std::string error;
+    for(unsigned i = 0; i < count; ++i) {
+        if(!readRequestSpec(StarbytesArrayIndex(requests,i),specs[i],error)) {
+            return failNativeIfEmpty(args,error + " at index " + std::to_string(i));
+        }
+    }
+
+    std::vector<uint64_t> ids(count,0);
+    std::vector<std::string> startErrors(count);
+    for(unsigned i = 0; i < count; ++i) {
+        ids[i] = startTransfer(*client,specs[i],nullptr,startErrors[i]);
+    }
+
+    auto responses = StarbytesArrayNew();
+    for(unsigned i = 0; i < count; ++i) {
+        StarbytesObject response = nullptr;
+        if(ids[i] == 0) {
+            HttpResult failed;
+            failed.error = startErrors[i];
+            response = makeHttpResponseObject(failed);
+        }
+        else {
+            response = makeHttpResponseObject(waitForTransfer(*client,ids[i])->result);
+        }
+        StarbytesArrayPush(responses,response);
+        StarbytesObjectRelease(response);
+    }
+    return responses;
+#else
+    return failNativeIfEmpty(args,"HTTP support is unavailable");
+#endif
+}
+
+STARBYTES_FUNC(http_clientMetrics) {
+#ifdef STARBYTES_HAS_CURL
+    auto *client = requireClientSelf(args);
+    if(!client) {
+        return nullptr;
+    }
+    const auto &metrics = client->metrics;
+    auto reused = metrics.requests > metrics.connectionsOpened ? metrics.requests - metrics.connectionsOpened : 0;
+    auto dict = StarbytesDictNew();
+    setMetric(dict,"requests",makeMetricCount(metrics.requests));
+    setMetric(dict,"failures",makeMetricCount(metrics.failures));
+    setMetric(dict,"inFlight",makeMetricCount(client->active.size()));
+    setMetric(dict,"connectionsOpened",makeMetricCount(metrics.connectionsOpened));
+    setMetric(dict,"connectionsReused",makeMetricCount(reused));
+    setMetric(dict,"bytesReceived",StarbytesNumNew(NumTypeLong,(int64_t)metrics.bytesReceived));
+    setMetric(dict,"averageNameLookupMillis",makeAverageMillis(metrics.nameLookupMicros,metrics.requests));
+    setMetric(dict,"averageConnectMillis",makeAverageMillis(metrics.connectMicros,metrics.requests));
+    setMetric(dict,"averageTlsMillis",makeAverageMillis(metrics.tlsMicros,metrics.requests));
+    setMetric(dict,"averageFirstByteMillis",makeAverageMillis(metrics.firstByteMicros,metrics.requests));
+    setMetric(dict,"averageTotalMillis",makeAverageMillis(metrics.totalMicros,metrics.requests));
+    return dict;
+#else
+    return failNativeIfEmpty(args,"HTTP support is unavailable");
+#endif
+}
+
+STARBYTES_FUNC(http_clientClose) {
+#ifdef STARBYTES_HAS_CURL
+    auto self = StarbytesFuncArgsGetArg(args);
+    auto *client = findClient(self);
+    if(!client) {
+        return makeBool(false);
+    }
+    auto driven = g_drivenClients.find(client);
+    StarbytesObject drivenRef = nullptr;
+    if(driven != g_drivenClients.end()) {
+        drivenRef = driven->second;
+        g_drivenClients.erase(driven);
+    }
+    // Frees the state, rejecting tasks still in flight.
+    StarbytesObjectSetNativeData(self,nullptr,nullptr);
+    if(drivenRef) {
+        StarbytesObjectRelease(drivenRef);
+    }
+    return makeBool(true);
+#else
+    return makeBool(false);
+#endif
+}
+
 void addFunc(StarbytesNativeModule *module,const char *name,unsigned argCount,StarbytesFuncCallback callback) {
     StarbytesFuncDesc desc;
     desc.name = CStringMake(name);
@@ -332,6 +964,18 @@ STARBYTES_NATIVE_MOD_MAIN() {
     addFunc(module,"http_get",3,http_get);
     addFunc(module,"http_post",4,http_post);
     addFunc(module,"http_request",5,http_request);
+    addFunc(module,"http_requestBytes",5,http_requestBytes);
+    addFunc(module,"http_newRequest",4,http_newRequest);
+    addFunc(module,"http_client",3,http_client);
+    addFunc(module,"HTTP_HttpClient_request",2,http_clientRequest);
+    addFunc(module,"HTTP_HttpClient_requestAsync",2,http_clientRequestAsync);
+    addFunc(module,"HTTP_HttpClient_requestAll",2,http_clientRequestAll);
+    addFunc(module,"HTTP_HttpClient_metrics",1,http_clientMetrics);
+    addFunc(module,"HTTP_HttpClient_close",1,http_clientClose);
+
+#ifdef STARBYTES_HAS_CURL
+    StarbytesRuntimeAddTaskDriver(http_driveClients);
+#endif
 
     return module;
 }
@@ -8,11 +8,12 @@
 #include <sstream>
 #include <string>
 #include <unordered_map>
-#include <vector>
 
 namespace {
 
+using starbytes::Runtime::stdlib::ByteView;
 using starbytes::Runtime::stdlib::failNativeIfEmpty;
+using starbytes::Runtime::stdlib::readByteView;
 using starbytes::Runtime::stdlib::setNativeErrorIfEmpty;
 using starbytes::Runtime::stdlib::systemErrorMessage;
 
@@ -480,33 +481,29 @@ StarbytesObject textNewline(StarbytesFuncArgs args) {
     return StarbytesStrNewWithData(stream->newline.c_str());
 }
 
-bool bytesFromArray(StarbytesObject arrayObj,std::vector<char> &bytes) {
-    if(!arrayObj || !StarbytesObjectTypecheck(arrayObj,StarbytesArrayType())) {
-        return false;
-    }
-    auto len = StarbytesArrayGetLength(arrayObj);
-    bytes.clear();
-    bytes.reserve(len);
-    for(unsigned i = 0; i < len; ++i) {
-        auto item = StarbytesArrayIndex(arrayObj,i);
-        if(!item || !StarbytesObjectTypecheck(item,StarbytesNumType()) || StarbytesNumGetType(item) != NumTypeInt) {
-            return false;
-        }
-        auto intVal = StarbytesNumGetIntValue(item);
-        if(intVal < 0 || intVal > 255) {
-            return false;
+/// Reads the rest of `in` straight into a Bytes buffer, sized up front when the stream is seekable.
+StarbytesObject readRemainingBytes(std::istream &in) {
+    auto start = in.tellg();
+    if(start != std::streampos(-1) && in.seekg(0,std::ios::end)) {
+        auto end = in.tellg();
+        in.seekg(start);
+        if(end != std::streampos(-1) && end >= start) {
+            auto size = static_cast<size_t>(end - start);
+            auto bytes = StarbytesBytesNew(size);
+            if(!bytes) {
+                return nullptr;
+            }
+            in.read(reinterpret_cast<char *>(StarbytesBytesGetData(bytes)),(std::streamsize)size);
+            auto count = in.gcount();
+            StarbytesBytesTruncate(bytes,count > 0 ? (size_t)count : 0);
+            return bytes;
         }
-        bytes.push_back((char)intVal);
-    }
-    return true;
-}
-
-StarbytesObject bytesToArray(const char *data,size_t len) {
-    auto arr = StarbytesArrayNew();
-    for(size_t i = 0; i < len; ++i) {
-        StarbytesArrayPush(arr,makeInt((unsigned char)data[i]));
     }
-    return arr;
+    in.clear();
+    std::ostringstream out;
+    out << in.rdbuf();
+    auto data = out.str();
+    return StarbytesBytesNewWithData(data.data(),data.size());
 }
 
 StarbytesObject binaryReadBytes(StarbytesFuncArgs args) {
@@ -521,15 +518,20 @@ StarbytesObject binaryReadBytes(StarbytesFuncArgs args) {
         return nullptr;
     }
 
-    std::vector<char> buffer((size_t)upTo);
+    auto bytes = StarbytesBytesNew((size_t)upTo);
+    if(!bytes) {
+        return failNativeIfEmpty(args,"readBytes failed to allocate buffer");
+    }
     stream->file.clear();
-    stream->file.read(buffer.data(),(std::streamsize)upTo);
+    stream->file.read(reinterpret_cast<char *>(StarbytesBytesGetData(bytes)),(std::streamsize)upTo);
     auto count = stream->file.gcount();
     if(count < 0) {
+        StarbytesObjectRelease(bytes);
         return failNativeIfEmpty(args,"readBytes failed");
     }
 
-    return bytesToArray(buffer.data(),(size_t)count);
+    StarbytesBytesTruncate(bytes,(size_t)count);
+    return bytes;
 }
 
 StarbytesObject binaryReadAllBytes(StarbytesFuncArgs args) {
@@ -540,10 +542,11 @@ StarbytesObject binaryReadAllBytes(StarbytesFuncArgs args) {
     }
 
     stream->file.clear();
-    std::ostringstream out;
-    out << stream->file.rdbuf();
-    auto data = out.str();
-    return bytesToArray(data.data(),data.size());
+    auto bytes = readRemainingBytes(stream->file);
+    if(!bytes) {
+        return failNativeIfEmpty(args,"readAllBytes failed");
+    }
+    return bytes;
 }
 
 StarbytesObject binaryWriteBytes(StarbytesFuncArgs args) {
@@ -553,20 +556,19 @@ StarbytesObject binaryWriteBytes(StarbytesFuncArgs args) {
         return failNativeIfEmpty(args,"writeBytes requires an open writable stream");
     }
 
-    auto arrayObj = StarbytesFuncArgsGetArg(args);
-    std::vector<char> bytes;
-    if(!bytesFromArray(arrayObj,bytes)) {
-        return failNativeIfEmpty(args,"writeBytes expects a Bytes array");
+    ByteView bytes;
+    if(!readByteView(StarbytesFuncArgsGetArg(args),bytes)) {
+        return failNativeIfEmpty(args,"writeBytes expects Bytes");
     }
 
     stream->file.clear();
-    if(!bytes.empty()) {
-        stream->file.write(bytes.data(),(std::streamsize)bytes.size());
+    if(bytes.length > 0) {
+        stream->file.write(reinterpret_cast<const char *>(bytes.data),(std::streamsize)bytes.length);
     }
     if(stream->file.fail()) {
         return failNativeIfEmpty(args,"writeBytes failed");
     }
-    return makeInt((int)bytes.size());
+    return makeInt((int)bytes.length);
 }
 
 STARBYTES_FUNC(openText) {
@@ -803,10 +805,11 @@ STARBYTES_FUNC(io_readBytes) {
         return failNativeIfEmpty(args,"readBytes failed to open file");
     }
 
-    std::ostringstream out;
-    out << in.rdbuf();
-    auto data = out.str();
-    return bytesToArray(data.data(),data.size());
+    auto bytes = readRemainingBytes(in);
+    if(!bytes) {
+        return failNativeIfEmpty(args,"readBytes failed");
+    }
+    return bytes;
 }
 
 STARBYTES_FUNC(io_writeBytes) {
@@ -817,18 +820,17 @@ STARBYTES_FUNC(io_writeBytes) {
         return nullptr;
     }
 
-    auto arrayObj = StarbytesFuncArgsGetArg(args);
-    std::vector<char> bytes;
-    if(!bytesFromArray(arrayObj,bytes)) {
-        return failNativeIfEmpty(args,"writeBytes expects a Bytes array");
+    ByteView bytes;
+    if(!readByteView(StarbytesFuncArgsGetArg(args),bytes)) {
+        return failNativeIfEmpty(args,"writeBytes expects Bytes");
     }
 
     std::ofstream out(path,std::ios::out | std::ios::binary | std::ios::trunc);
     if(!out.is_open()) {
         return failNativeIfEmpty(args,"writeBytes failed to open file");
     }
-    if(!bytes.empty()) {
-        out.write(bytes.data(),(std::streamsize)bytes.size());
+    if(bytes.length > 0) {
+        out.write(reinterpret_cast<const char *>(bytes.data),(std::streamsize)bytes.length);
     }
     if(out.fail()) {
         return failNativeIfEmpty(args,"writeBytes failed");
@@ -2,23 +2,30 @@
 #include "starbytes/base/ADT.h"
 #include "starbytes/runtime/NativeModuleSupport.h"
 
-#include <rapidjson/document.h>
+#include <rapidjson/error/en.h>
 #include <rapidjson/prettywriter.h>
+#include <rapidjson/reader.h>
 #include <rapidjson/stringbuffer.h>
 #include <rapidjson/writer.h>
 
 #include <cmath>
+#include <cstdio>
+#include <cstring>
 #include <limits>
+#include <memory>
 #include <sstream>
 #include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
 
 namespace {
 
 using starbytes::optional;
+using starbytes::Runtime::stdlib::ByteView;
 using starbytes::Runtime::stdlib::failNativeIfEmpty;
+using starbytes::Runtime::stdlib::readByteView;
 using starbytes::Runtime::stdlib::setNativeErrorIfEmpty;
-using rapidjson::Document;
-using rapidjson::Value;
 
 struct NativeArgsLayout {
     unsigned argc = 0;
@@ -27,6 +34,9 @@ struct NativeArgsLayout {
 };
 
 constexpr int kMaxDepth = 128;
+constexpr size_t kReaderChunkBytes = 64 * 1024;
+constexpr size_t kMaxLineBytes = 64 * 1024 * 1024;
+constexpr size_t kMaxRetainedOutputBytes = 1024 * 1024;
 
 StarbytesObject makeBool(bool value) {
     // Runtime bool consumption currently interprets StarbytesBoolFalse as logical true.
@@ -82,137 +92,295 @@ optional<std::string> numberToString(StarbytesObject object) {
     return out.str();
 }
 
-optional<std::string> dictKeyToString(StarbytesObject key) {
-    if(!key) {
-        return {};
-    }
-    if(StarbytesObjectTypecheck(key,StarbytesStrType())) {
-        return std::string(StarbytesStrGetBuffer(key));
+/// Shares one String object per distinct object key. Keys are viewed through the interned
+/// object's own buffer, so a hit costs a hash and no allocation. The table stops growing at
+/// kMaxInternedKeys so a stream with unbounded distinct keys still runs in constant memory.
+class KeyInterner {
+public:
+    KeyInterner() = default;
+    KeyInterner(const KeyInterner &) = delete;
+    KeyInterner &operator=(const KeyInterner &) = delete;
+
+    ~KeyInterner() {
+        for(auto &entry : table) {
+            StarbytesObjectRelease(entry.second);
+        }
     }
-    return numberToString(key);
-}
 
-bool jsonToStarbytes(const Value &value,StarbytesObject &out,int depth) {
-    if(depth > kMaxDepth) {
-        return false;
+    /// Returns a new reference.
+    StarbytesObject intern(const char *text,size_t length) {
+        auto it = table.find(std::string_view(text,length));
+        if(it != table.end()) {
+            StarbytesObjectReference(it->second);
+            return it->second;
+        }
+        auto key = StarbytesStrNewWithData(text);
+        if(table.size() < kMaxInternedKeys
+           && table.emplace(std::string_view(StarbytesStrGetBuffer(key)),key).second) {
+            StarbytesObjectReference(key);
+        }
+        return key;
     }
 
-    if(value.IsNull()) {
-        out = nullptr;
-        return true;
-    }
-    if(value.IsBool()) {
-        out = makeBool(value.GetBool());
-        return true;
+private:
+    static constexpr size_t kMaxInternedKeys = 4096;
+    std::unordered_map<std::string_view,StarbytesObject> table;
+};
+
+/// SAX handler that builds Starbytes values as rapidjson reports them, with no intermediate DOM.
+/// Containers are attached to their parent as soon as they open, so on failure releasing the
+/// root releases everything built so far.
+class ObjectBuilder : public rapidjson::BaseReaderHandler<rapidjson::UTF8<>,ObjectBuilder> {
+public:
+    explicit ObjectBuilder(KeyInterner &keys): keys(keys) {}
+
+    ObjectBuilder(const ObjectBuilder &) = delete;
+    ObjectBuilder &operator=(const ObjectBuilder &) = delete;
+
+    ~ObjectBuilder() {
+        if(pendingKey) {
+            StarbytesObjectRelease(pendingKey);
+        }
+        if(root) {
+            StarbytesObjectRelease(root);
+        }
     }
-    if(value.IsInt()) {
-        out = makeInt(value.GetInt());
-        return true;
+
+    /// Transfers ownership of the parsed value to the caller.
+    StarbytesObject takeResult() {
+        auto out = root;
+        root = nullptr;
+        return out;
     }
-    if(value.IsUint()) {
-        auto uintValue = value.GetUint();
-        if(uintValue > static_cast<unsigned>(std::numeric_limits<int>::max())) {
-            out = StarbytesNumNew(NumTypeFloat,static_cast<float>(uintValue));
-            return true;
+
+    bool exceededDepth() const { return depthExceeded; }
+    bool rejectedNullElement() const { return nullElement; }
+
+    bool Null() { return addValue(nullptr); }
+    bool Bool(bool value) { return addOwned(makeBool(value)); }
+    bool Int(int value) { return addOwned(makeInt(value)); }
+
+    bool Uint(unsigned value) {
+        if(value > static_cast<unsigned>(std::numeric_limits<int>::max())) {
+            return addOwned(StarbytesNumNew(NumTypeFloat,static_cast<float>(value)));
         }
-        out = makeInt(static_cast<int>(uintValue));
-        return true;
+        return addOwned(makeInt(static_cast<int>(value)));
     }
-    if(value.IsInt64()) {
-        auto int64Value = value.GetInt64();
-        if(int64Value >= std::numeric_limits<int>::min() && int64Value <= std::numeric_limits<int>::max()) {
-            out = makeInt(static_cast<int>(int64Value));
-            return true;
+
+    bool Int64(int64_t value) {
+        if(value >= std::numeric_limits<int>::min() && value <= std::numeric_limits<int>::max()) {
+            return addOwned(makeInt(static_cast<int>(value)));
         }
-        out = StarbytesNumNew(NumTypeFloat,static_cast<float>(int64Value));
-        return true;
+        return addOwned(StarbytesNumNew(NumTypeFloat,static_cast<float>(value)));
     }
-    if(value.IsUint64()) {
-        auto uint64Value = value.GetUint64();
-        if(uint64Value <= static_cast<uint64_t>(std::numeric_limits<int>::max())) {
-            out = makeInt(static_cast<int>(uint64Value));
-            return true;
+
+    bool Uint64(uint64_t value) {
+        if(value <= static_cast<uint64_t>(std::numeric_limits<int>::max())) {
+            return addOwned(makeInt(static_cast<int>(value)));
         }
-        out = StarbytesNumNew(NumTypeFloat,static_cast<float>(uint64Value));
-        return true;
+        return addOwned(StarbytesNumNew(NumTypeFloat,static_cast<float>(value)));
     }
-    if(value.IsNumber()) {
-        out = StarbytesNumNew(NumTypeFloat,static_cast<float>(value.GetDouble()));
-        return true;
+
+    bool Double(double value) {
+        return addOwned(StarbytesNumNew(NumTypeFloat,static_cast<float>(value)));
+    }
+
+    bool String(const char *text,rapidjson::SizeType,bool) {
+        return addOwned(StarbytesStrNewWithData(text));
     }
-    if(value.IsString()) {
-        out = StarbytesStrNewWithData(value.GetString());
+
+    bool Key(const char *text,rapidjson::SizeType length,bool) {
+        pendingKey = keys.intern(text,length);
         return true;
     }
-    if(value.IsArray()) {
-        auto array = StarbytesArrayNew();
-        for(auto it = value.Begin(); it != value.End(); ++it) {
-            StarbytesObject element = nullptr;
-            if(!jsonToStarbytes(*it,element,depth + 1)) {
+
+    bool StartObject() { return openContainer(StarbytesDictNew(),true); }
+    bool EndObject(rapidjson::SizeType) { return closeContainer(); }
+    bool StartArray() { return openContainer(StarbytesArrayNew(),false); }
+    bool EndArray(rapidjson::SizeType) { return closeContainer(); }
+
+private:
+    struct Frame {
+        StarbytesObject container = nullptr;
+        bool isDict = false;
+        /// Key text in insertion order; a lookup map is only built for large objects.
+        std::vector<std::string_view> keyTexts;
+        std::unordered_map<std::string_view,unsigned> keyIndex;
+    };
+
+    static constexpr size_t kLinearKeyScanLimit = 16;
+
+    bool addOwned(StarbytesObject value) {
+        bool ok = addValue(value);
+        StarbytesObjectRelease(value);
+        return ok;
+    }
+
+    bool addValue(StarbytesObject value) {
+        if(stack.empty()) {
+            if(value) {
+                StarbytesObjectReference(value);
+            }
+            root = value;
+            return true;
+        }
+        auto &frame = stack.back();
+        if(!value) {
+            // Runtime containers cannot hold null. A null member is left out of its dict, but
+            // dropping an array element would shift every later index, so that is an error.
+            if(!frame.isDict) {
+                nullElement = true;
                 return false;
             }
-            StarbytesArrayPush(array,element);
+            if(pendingKey) {
+                StarbytesObjectRelease(pendingKey);
+                pendingKey = nullptr;
+            }
+            return true;
         }
-        out = array;
-        return true;
+        if(!frame.isDict) {
+            StarbytesArrayPush(frame.container,value);
+            return true;
+        }
+        auto key = pendingKey;
+        pendingKey = nullptr;
+        bool ok = addMember(frame,key,value);
+        StarbytesObjectRelease(key);
+        return ok;
     }
-    if(value.IsObject()) {
-        auto dict = StarbytesDictNew();
-        for(auto it = value.MemberBegin(); it != value.MemberEnd(); ++it) {
-            auto key = StarbytesStrNewWithData(it->name.GetString());
-            StarbytesObject mapped = nullptr;
-            if(!jsonToStarbytes(it->value,mapped,depth + 1)) {
-                return false;
+
+    /// Appends to the dict's key/value arrays directly; a repeated key replaces the earlier value
+    /// as StarbytesDictSet would, without its scan over every existing key.
+    bool addMember(Frame &frame,StarbytesObject key,StarbytesObject value) {
+        if(!key) {
+            return false;
+        }
+        std::string_view text(StarbytesStrGetBuffer(key));
+        auto values = StarbytesDictGetValues(frame.container);
+        if(frame.keyTexts.size() < kLinearKeyScanLimit) {
+            for(size_t i = 0; i < frame.keyTexts.size(); ++i) {
+                if(frame.keyTexts[i] == text) {
+                    StarbytesArraySet(values,static_cast<unsigned>(i),value);
+                    return true;
+                }
+            }
+        }
+        else {
+            if(frame.keyIndex.empty()) {
+                for(size_t i = 0; i < frame.keyTexts.size(); ++i) {
+                    frame.keyIndex.emplace(frame.keyTexts[i],static_cast<unsigned>(i));
+                }
+            }
+            auto existing = frame.keyIndex.find(text);
+            if(existing != frame.keyIndex.end()) {
+                StarbytesArraySet(values,existing->second,value);
+                return true;
             }
-            StarbytesDictSet(dict,key,mapped);
+            frame.keyIndex.emplace(text,static_cast<unsigned>(frame.keyTexts.size()));
         }
-        out = dict;
+        frame.keyTexts.push_back(text);
+        StarbytesArrayPush(StarbytesDictGetKeys(frame.container),key);
+        StarbytesArrayPush(values,value);
+        StarbytesDictSetLength(frame.container,static_cast<unsigned>(frame.keyTexts.size()));
         return true;
     }
 
-    return false;
+    bool openContainer(StarbytesObject container,bool isDict) {
+        if(stack.size() >= static_cast<size_t>(kMaxDepth)) {
+            depthExceeded = true;
+            StarbytesObjectRelease(container);
+            return false;
+        }
+        if(!addOwned(container)) {
+            return false;
+        }
+        Frame frame;
+        frame.container = container;
+        frame.isDict = isDict;
+        stack.push_back(std::move(frame));
+        return true;
+    }
+
+    bool closeContainer() {
+        stack.pop_back();
+        return true;
+    }
+
+    KeyInterner &keys;
+    std::vector<Frame> stack;
+    StarbytesObject root = nullptr;
+    StarbytesObject pendingKey = nullptr;
+    bool depthExceeded = false;
+    bool nullElement = false;
+};
+
+/// Parses `text` in place (it is overwritten) into a new Starbytes value.
+bool parseInsitu(char *text,KeyInterner &keys,StarbytesObject &out,std::string &error) {
+    ObjectBuilder builder(keys);
+    rapidjson::Reader reader;
+    rapidjson::InsituStringStream stream(text);
+    auto result = reader.Parse<rapidjson::kParseInsituFlag>(stream,builder);
+    if(result.IsError()) {
+        if(builder.exceededDepth()) {
+            error = "JSON parse exceeded supported conversion depth";
+        }
+        else if(builder.rejectedNullElement()) {
+            // The reader stops just past the `null` literal.
+            error = "JSON parse failed: null array elements are not supported at offset "
+                + std::to_string(result.Offset() - 4);
+        }
+        else {
+            error = std::string("JSON parse failed: ") + rapidjson::GetParseError_En(result.Code())
+                + " at offset " + std::to_string(result.Offset());
+        }
+        return false;
+    }
+    out = builder.takeResult();
+    return true;
 }
 
-bool starbytesToJson(StarbytesObject object,Value &out,Document::AllocatorType &allocator,int depth) {
+/// Streams a Starbytes value into any rapidjson writer without building a DOM.
+template<typename JsonWriter>
+bool writeObject(JsonWriter &writer,StarbytesObject object,int depth) {
     if(depth > kMaxDepth) {
         return false;
     }
 
     if(!object) {
-        out.SetNull();
-        return true;
+        return writer.Null();
     }
 
     if(StarbytesObjectTypecheck(object,StarbytesStrType())) {
         auto value = StarbytesStrGetBuffer(object);
-        out.SetString(value ? value : "",allocator);
-        return true;
+        return writer.String(value ? value : "",static_cast<rapidjson::SizeType>(value ? std::strlen(value) : 0));
     }
     if(StarbytesObjectTypecheck(object,StarbytesNumType())) {
         if(StarbytesNumGetType(object) == NumTypeInt) {
-            out.SetInt(StarbytesNumGetIntValue(object));
-        }
-        else {
-            out.SetDouble(StarbytesNumGetFloatValue(object));
+            return writer.Int(StarbytesNumGetIntValue(object));
         }
-        return true;
+        return writer.Double(StarbytesNumGetFloatValue(object));
     }
     if(StarbytesObjectTypecheck(object,StarbytesBoolType())) {
-        out.SetBool(StarbytesBoolValue(object) == StarbytesBoolFalse);
-        return true;
+        return writer.Bool(StarbytesBoolValue(object) == StarbytesBoolFalse);
     }
     if(StarbytesObjectTypecheck(object,StarbytesArrayType())) {
-        out.SetArray();
+        writer.StartArray();
         auto len = StarbytesArrayGetLength(object);
         for(unsigned i = 0; i < len; ++i) {
-            auto element = StarbytesArrayIndex(object,i);
-            Value elementValue;
-            if(!starbytesToJson(element,elementValue,allocator,depth + 1)) {
+            if(!writeObject(writer,StarbytesArrayIndex(object,i),depth + 1)) {
                 return false;
             }
-            out.PushBack(elementValue,allocator);
         }
-        return true;
+        return writer.EndArray();
+    }
+    if(StarbytesObjectTypecheck(object,StarbytesBytesType())) {
+        writer.StartArray();
+        auto data = StarbytesBytesGetData(object);
+        auto len = StarbytesBytesGetLength(object);
+        for(size_t i = 0; i < len; ++i) {
+            writer.Int(data[i]);
+        }
+        return writer.EndArray();
     }
     if(StarbytesObjectTypecheck(object,StarbytesDictType())) {
         auto keys = StarbytesDictGetKeys(object);
@@ -226,61 +394,51 @@ bool starbytesToJson(StarbytesObject object,Value &out,Document::AllocatorType &
             return false;
         }
 
-        out.SetObject();
+        writer.StartObject();
         for(unsigned i = 0; i < len; ++i) {
             auto keyObject = StarbytesArrayIndex(keys,i);
-            auto keyText = dictKeyToString(keyObject);
-            if(!keyText.has_value()) {
-                return false;
+            if(keyObject && StarbytesObjectTypecheck(keyObject,StarbytesStrType())) {
+                auto keyText = StarbytesStrGetBuffer(keyObject);
+                writer.Key(keyText,static_cast<rapidjson::SizeType>(std::strlen(keyText)));
             }
-
-            auto valueObject = StarbytesArrayIndex(values,i);
-            Value jsonKey;
-            jsonKey.SetString(keyText->c_str(),static_cast<rapidjson::SizeType>(keyText->size()),allocator);
-
-            Value jsonValue;
-            if(!starbytesToJson(valueObject,jsonValue,allocator,depth + 1)) {
+            else {
+                auto keyText = numberToString(keyObject);
+                if(!keyText.has_value()) {
+                    return false;
+                }
+                writer.Key(keyText->c_str(),static_cast<rapidjson::SizeType>(keyText->size()),true);
+            }
+            if(!writeObject(writer,StarbytesArrayIndex(values,i),depth + 1)) {
                 return false;
             }
-            out.AddMember(jsonKey,jsonValue,allocator);
         }
-        return true;
+        return writer.EndObject();
     }
     if(StarbytesObjectTypecheck(object,StarbytesRegexType())) {
-        out.SetObject();
         auto pattern = StarbytesObjectGetProperty(object,"pattern");
         auto flags = StarbytesObjectGetProperty(object,"flags");
-        auto patternText = pattern && StarbytesObjectTypecheck(pattern,StarbytesStrType()) ? StarbytesStrGetBuffer(pattern) : "";
-        auto flagsText = flags && StarbytesObjectTypecheck(flags,StarbytesStrType()) ? StarbytesStrGetBuffer(flags) : "";
-        Value keyPattern;
-        keyPattern.SetString("pattern",allocator);
-        Value valPattern;
-        valPattern.SetString(patternText ? patternText : "",allocator);
-        out.AddMember(keyPattern,valPattern,allocator);
-
-        Value keyFlags;
-        keyFlags.SetString("flags",allocator);
-        Value valFlags;
-        valFlags.SetString(flagsText ? flagsText : "",allocator);
-        out.AddMember(keyFlags,valFlags,allocator);
-        return true;
+        const char *patternText = pattern && StarbytesObjectTypecheck(pattern,StarbytesStrType()) ? StarbytesStrGetBuffer(pattern) : "";
+        const char *flagsText = flags && StarbytesObjectTypecheck(flags,StarbytesStrType()) ? StarbytesStrGetBuffer(flags) : "";
+        writer.StartObject();
+        writer.Key("pattern");
+        writer.String(patternText ? patternText : "");
+        writer.Key("flags");
+        writer.String(flagsText ? flagsText : "");
+        return writer.EndObject();
     }
 
     if(!StarbytesObjectIs(object)) {
-        out.SetObject();
+        writer.StartObject();
         auto fieldCount = StarbytesClassObjectGetFieldCount(object);
         for(unsigned i = 0; i < fieldCount; ++i) {
             auto fieldName = StarbytesClassObjectGetFieldName(object,i);
             if(fieldName == nullptr || fieldName[0] == '\0') {
                 continue;
             }
-            Value key;
-            key.SetString(fieldName,allocator);
-            Value mapped;
-            if(!starbytesToJson(StarbytesClassObjectGetField(object,i),mapped,allocator,depth + 1)) {
+            writer.Key(fieldName);
+            if(!writeObject(writer,StarbytesClassObjectGetField(object,i),depth + 1)) {
                 return false;
             }
-            out.AddMember(key,mapped,allocator);
         }
         auto propCount = StarbytesObjectGetPropertyCount(object);
         for(unsigned i = 0; i < propCount; ++i) {
@@ -288,20 +446,145 @@ bool starbytesToJson(StarbytesObject object,Value &out,Document::AllocatorType &
             if(!prop || prop->name[0] == '\0') {
                 continue;
             }
-            Value key;
-            key.SetString(prop->name,allocator);
-            Value mapped;
-            if(!starbytesToJson(prop->data,mapped,allocator,depth + 1)) {
+            writer.Key(prop->name);
+            if(!writeObject(writer,prop->data,depth + 1)) {
                 return false;
             }
-            out.AddMember(key,mapped,allocator);
         }
-        return true;
+        return writer.EndObject();
     }
 
     return false;
 }
 
+/// Output buffer reused across stringify calls so its capacity survives between them.
+rapidjson::StringBuffer &reusedOutputBuffer() {
+    static thread_local rapidjson::StringBuffer buffer;
+    buffer.Clear();
+    return buffer;
+}
+
+StarbytesObject takeOutputString(rapidjson::StringBuffer &buffer) {
+    auto out = StarbytesStrNewWithData(buffer.GetString());
+    if(buffer.GetSize() > kMaxRetainedOutputBytes) {
+        buffer.Clear();
+        buffer.ShrinkToFit();
+    }
+    return out;
+}
+
+/// Reads newline-delimited JSON one value per line, from a file or from chunks fed by the
+/// caller. Only the unread tail of the input is buffered.
+struct JsonReaderState {
+    std::FILE *file = nullptr;
+    bool inputEnded = false;
+    std::vector<char> buffer;
+    size_t readOffset = 0;
+    size_t lineEnd = 0;
+    /// Bytes after readOffset already known to hold no newline.
+    size_t scannedWithoutNewline = 0;
+    bool lineReady = false;
+    unsigned long lineNumber = 0;
+    KeyInterner keys;
+
+    ~JsonReaderState() {
+        if(file) {
+            std::fclose(file);
+        }
+    }
+
+    void compact() {
+        if(readOffset == 0) {
+            return;
+        }
+        buffer.erase(buffer.begin(),buffer.begin() + static_cast<std::ptrdiff_t>(readOffset));
+        readOffset = 0;
+    }
+
+    bool fillFromFile(std::string &error) {
+        compact();
+        size_t oldSize = buffer.size();
+        buffer.resize(oldSize + kReaderChunkBytes);
+        size_t count = std::fread(buffer.data() + oldSize,1,kReaderChunkBytes,file);
+        buffer.resize(oldSize + count);
+        if(count < kReaderChunkBytes) {
+            if(std::ferror(file)) {
+                error = "read failed";
+                return false;
+            }
+            inputEnded = true;
+        }
+        return true;
+    }
+
+    /// Finds the next non-blank line, reading more input if the reader owns a file.
+    bool findLine(bool &found,std::string &error) {
+        found = lineReady;
+        if(lineReady) {
+            return true;
+        }
+        while(true) {
+            size_t searchFrom = readOffset + scannedWithoutNewline;
+            char *newline = nullptr;
+            if(searchFrom < buffer.size()) {
+                newline = static_cast<char *>(std::memchr(buffer.data() + searchFrom,'\n',buffer.size() - searchFrom));
+            }
+            if(newline || (inputEnded && readOffset < buffer.size())) {
+                size_t end = newline ? static_cast<size_t>(newline - buffer.data()) : buffer.size();
+                scannedWithoutNewline = 0;
+                ++lineNumber;
+                if(isBlank(readOffset,end)) {
+                    readOffset = newline ? end + 1 : end;
+                    continue;
+                }
+                lineEnd = end;
+                lineReady = true;
+                found = true;
+                return true;
+            }
+            scannedWithoutNewline = buffer.size() - readOffset;
+            if(scannedWithoutNewline > kMaxLineBytes) {
+                error = "line " + std::to_string(lineNumber + 1) + " exceeds the maximum line length";
+                return false;
+            }
+            if(!file || inputEnded) {
+                return true;
+            }
+            if(!fillFromFile(error)) {
+                return false;
+            }
+        }
+    }
+
+    bool isBlank(size_t begin,size_t end) const {
+        for(size_t i = begin; i < end; ++i) {
+            char c = buffer[i];
+            if(c != ' ' && c != '\t' && c != '\r') {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+std::unordered_map<StarbytesObject,std::unique_ptr<JsonReaderState>> g_readerRegistry;
+
+JsonReaderState *requireReaderSelf(StarbytesFuncArgs args) {
+    auto self = StarbytesFuncArgsGetArg(args);
+    auto it = g_readerRegistry.find(self);
+    if(it == g_readerRegistry.end()) {
+        setNativeErrorIfEmpty(args,"reader is closed");
+        return nullptr;
+    }
+    return it->second.get();
+}
+
+StarbytesObject registerReader(std::unique_ptr<JsonReaderState> state) {
+    auto object = StarbytesObjectNew(StarbytesMakeClass("JsonReader"));
+    g_readerRegistry[object] = std::move(state);
+    return object;
+}
+
 STARBYTES_FUNC(json_parse) {
     skipOptionalModuleReceiver(args,1);
 
@@ -310,15 +593,11 @@ STARBYTES_FUNC(json_parse) {
         return nullptr;
     }
 
-    Document document;
-    document.Parse(source.c_str());
-    if(document.HasParseError()) {
-        return failNativeIfEmpty(args,"JSON parse failed");
-    }
-
+    KeyInterner keys;
     StarbytesObject out = nullptr;
-    if(!jsonToStarbytes(document,out,0)) {
-        return failNativeIfEmpty(args,"JSON parse exceeded supported conversion depth");
+    std::string error;
+    if(!parseInsitu(&source[0],keys,out,error)) {
+        return failNativeIfEmpty(args,error);
     }
     return out;
 }
@@ -326,14 +605,15 @@ STARBYTES_FUNC(json_parse) {
 STARBYTES_FUNC(json_isValid) {
     skipOptionalModuleReceiver(args,1);
 
-    std::string source;
-    if(!readStringArg(args,source)) {
+    auto arg = StarbytesFuncArgsGetArg(args);
+    if(!arg || !StarbytesObjectTypecheck(arg,StarbytesStrType())) {
         return makeBool(false);
     }
 
-    Document document;
-    document.Parse(source.c_str());
-    return makeBool(!document.HasParseError());
+    rapidjson::BaseReaderHandler<> handler;
+    rapidjson::Reader reader;
+    rapidjson::StringStream stream(StarbytesStrGetBuffer(arg));
+    return makeBool(!reader.Parse(stream,handler).IsError());
 }
 
 STARBYTES_FUNC(json_stringify) {
@@ -341,20 +621,12 @@ STARBYTES_FUNC(json_stringify) {
 
     auto object = StarbytesFuncArgsGetArg(args);
 
-    Document document;
-    auto &allocator = document.GetAllocator();
-    Value root;
-    if(!starbytesToJson(object,root,allocator,0)) {
-        return failNativeIfEmpty(args,"stringify cannot encode the provided value");
-    }
-
-    rapidjson::StringBuffer buffer;
+    auto &buffer = reusedOutputBuffer();
     rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
-    if(!root.Accept(writer)) {
-        return failNativeIfEmpty(args,"stringify failed");
+    if(!writeObject(writer,object,0)) {
+        return failNativeIfEmpty(args,"stringify cannot encode the provided value");
     }
-
-    return StarbytesStrNewWithData(buffer.GetString());
+    return takeOutputString(buffer);
 }
 
 STARBYTES_FUNC(json_pretty) {
@@ -372,21 +644,130 @@ STARBYTES_FUNC(json_pretty) {
         indent = 8;
     }
 
-    Document document;
-    auto &allocator = document.GetAllocator();
-    Value root;
-    if(!starbytesToJson(object,root,allocator,0)) {
+    auto &buffer = reusedOutputBuffer();
+    rapidjson::PrettyWriter<rapidjson::StringBuffer> writer(buffer);
+    writer.SetIndent(' ',static_cast<unsigned>(indent));
+    if(!writeObject(writer,object,0)) {
         return failNativeIfEmpty(args,"pretty cannot encode the provided value");
     }
+    return takeOutputString(buffer);
+}
 
-    rapidjson::StringBuffer buffer;
-    rapidjson::PrettyWriter<rapidjson::StringBuffer> writer(buffer);
-    writer.SetIndent(' ',static_cast<unsigned>(indent));
-    if(!root.Accept(writer)) {
-        return failNativeIfEmpty(args,"pretty failed");
+STARBYTES_FUNC(json_openReader) {
+    skipOptionalModuleReceiver(args,1);
+
+    std::string path;
+    if(!readStringArg(args,path)) {
+        return nullptr;
+    }
+    auto state = std::make_unique<JsonReaderState>();
+    state->file = std::fopen(path.c_str(),"rb");
+    if(!state->file) {
+        return failNativeIfEmpty(args,"openReader failed to open file: " + path);
+    }
+    return registerReader(std::move(state));
+}
+
+STARBYTES_FUNC(json_reader) {
+    skipOptionalModuleReceiver(args,0);
+    return registerReader(std::make_unique<JsonReaderState>());
+}
+
+STARBYTES_FUNC(json_readerFeed) {
+    auto *state = requireReaderSelf(args);
+    if(!state) {
+        return nullptr;
+    }
+    ByteView chunk;
+    if(!readByteView(StarbytesFuncArgsGetArg(args),chunk)) {
+        return failNativeIfEmpty(args,"expected Bytes argument");
+    }
+    if(state->file) {
+        return failNativeIfEmpty(args,"feed is not supported on a file reader");
+    }
+    if(state->inputEnded) {
+        return failNativeIfEmpty(args,"feed called after end");
+    }
+    if(!state->lineReady) {
+        state->compact();
+    }
+    auto *begin = reinterpret_cast<const char *>(chunk.data);
+    state->buffer.insert(state->buffer.end(),begin,begin + chunk.length);
+    return makeBool(true);
+}
+
+STARBYTES_FUNC(json_readerEnd) {
+    auto it = g_readerRegistry.find(StarbytesFuncArgsGetArg(args));
+    if(it == g_readerRegistry.end()) {
+        return makeBool(false);
     }
+    it->second->inputEnded = true;
+    return makeBool(true);
+}
+
+STARBYTES_FUNC(json_readerHasNext) {
+    auto it = g_readerRegistry.find(StarbytesFuncArgsGetArg(args));
+    if(it == g_readerRegistry.end()) {
+        return makeBool(false);
+    }
+    bool found = false;
+    std::string error;
+    if(!it->second->findLine(found,error)) {
+        // Let next() report the error.
+        return makeBool(true);
+    }
+    return makeBool(found);
+}
+
+STARBYTES_FUNC(json_readerNext) {
+    auto *state = requireReaderSelf(args);
+    if(!state) {
+        return nullptr;
+    }
+    bool found = false;
+    std::string error;
+    if(!state->findLine(found,error)) {
+        return failNativeIfEmpty(args,"next failed: " + error);
+    }
+    if(!found) {
+        return failNativeIfEmpty(args,"next failed: no more values");
+    }
+
+    // Terminate the line in place; the byte after it is the newline or spare capacity.
+    size_t lineEnd = state->lineEnd;
+    bool hadNewline = lineEnd < state->buffer.size();
+    if(!hadNewline) {
+        state->buffer.push_back('\0');
+    }
+    state->buffer[lineEnd] = '\0';
+    char *line = state->buffer.data() + state->readOffset;
+    state->readOffset = hadNewline ? lineEnd + 1 : lineEnd;
+    state->lineReady = false;
+
+    StarbytesObject out = nullptr;
+    if(!parseInsitu(line,state->keys,out,error)) {
+        if(!hadNewline) {
+            state->buffer.pop_back();
+        }
+        return failNativeIfEmpty(args,"line " + std::to_string(state->lineNumber) + ": " + error);
+    }
+    if(!hadNewline) {
+        state->buffer.pop_back();
+    }
+    return out;
+}
+
+STARBYTES_FUNC(json_readerLineNumber) {
+    auto it = g_readerRegistry.find(StarbytesFuncArgsGetArg(args));
+    if(it == g_readerRegistry.end()) {
+        return makeInt(0);
+    }
+    return makeInt(static_cast<int>(it->second->lineNumber));
+}
 
-    return StarbytesStrNewWithData(buffer.GetString());
+STARBYTES_FUNC(json_readerClose) {
+    auto self = StarbytesFuncArgsGetArg(args);
+    return makeBool(g_readerRegistry.erase(self) > 0);
 }
 
 void addFunc(StarbytesNativeModule *module,const char *name,unsigned argCount,StarbytesFuncCallback callback) {
@@ -406,6 +787,14 @@ STARBYTES_NATIVE_MOD_MAIN() {
     addFunc(module,"json_isValid",1,json_isValid);
     addFunc(module,"json_stringify",1,json_stringify);
     addFunc(module,"json_pretty",2,json_pretty);
+    addFunc(module,"json_openReader",1,json_openReader);
+    addFunc(module,"json_reader",0,json_reader);
+    addFunc(module,"JSON_JsonReader_feed",2,json_readerFeed);
+    addFunc(module,"JSON_JsonReader_end",1,json_readerEnd);
+    addFunc(module,"JSON_JsonReader_hasNext",1,json_readerHasNext);
+    addFunc(module,"JSON_JsonReader_next",1,json_readerNext);
+    addFunc(module,"JSON_JsonReader_lineNumber",1,json_readerLineNumber);
+    addFunc(module,"JSON_JsonReader_close",1,json_readerClose);
 
     return module;
 }
@@ -1,16 +1,25 @@
 #include <starbytes/interop.h>
 #include "starbytes/base/ADT.h"
+#include "starbytes/runtime/NativeModuleSupport.h"
 
+#include <atomic>
 #include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
 #include <ctime>
-#include <iomanip>
-#include <iostream>
+#include <memory>
+#include <mutex>
 #include <sstream>
 #include <string>
+#include <thread>
+#include <utility>
+#include <vector>
 
 namespace {
 
 using starbytes::map;
+using starbytes::Runtime::stdlib::failNativeIfEmpty;
 
 struct NativeArgsLayout {
     unsigned argc = 0;
@@ -36,6 +45,10 @@ StarbytesObject makeInt(int value) {
     return StarbytesNumNew(NumTypeInt,value);
 }
 
+StarbytesObject makeLong(uint64_t value) {
+    return StarbytesNumNew(NumTypeLong,(int64_t)value);
+}
+
 bool readIntArg(StarbytesFuncArgs args,int &outValue) {
     auto arg = StarbytesFuncArgsGetArg(args);
     if(!arg || !StarbytesObjectTypecheck(arg,StarbytesNumType()) || StarbytesNumGetType(arg) != NumTypeInt) {
@@ -54,6 +67,15 @@ bool readStringArg(StarbytesFuncArgs args,std::string &outValue) {
     return true;
 }
 
+bool readBoolArg(StarbytesFuncArgs args,bool &outValue) {
+    auto arg = StarbytesFuncArgsGetArg(args);
+    if(!arg || !StarbytesObjectTypecheck(arg,StarbytesBoolType())) {
+        return false;
+    }
+    outValue = (StarbytesBoolValue(arg) == StarbytesBoolFalse);
+    return true;
+}
+
 void skipOptionalModuleReceiver(StarbytesFuncArgs args,unsigned expectedUserArgs) {
     auto *raw = reinterpret_cast<NativeArgsLayout *>(args);
     if(!raw || raw->argc < raw->index) {
@@ -83,22 +105,6 @@ int clampLevel(int level) {
     return level;
 }
 
-std::string nowTimestamp() {
-    auto now = std::chrono::system_clock::now();
-    auto timeValue = std::chrono::system_clock::to_time_t(now);
-
-    std::tm localTime{};
-#if defined(_WIN32)
-    localtime_s(&localTime,&timeValue);
-#else
-    localtime_r(&timeValue,&localTime);
-#endif
-
-    std::ostringstream out;
-    out << std::put_time(&localTime,"%Y-%m-%d %H:%M:%S");
-    return out.str();
-}
-
 std::string objectToLogValue(StarbytesObject object,int depth = 0);
 
 std::string dictToLogFields(StarbytesObject object,int depth) {
@@ -167,6 +173,9 @@ std::string objectToLogValue(StarbytesObject object,int depth) {
         out << "]";
         return out.str();
     }
+    if(StarbytesObjectTypecheck(object,StarbytesBytesType())) {
+        return "<Bytes " + std::to_string(StarbytesBytesGetLength(object)) + ">";
+    }
     if(StarbytesObjectTypecheck(object,StarbytesDictType())) {
         return dictToLogFields(object,depth + 1);
     }
@@ -180,23 +189,446 @@ std::string objectToLogValue(StarbytesObject object,int depth) {
     return "<object>";
 }
 
+using LogFields = std::vector<std::pair<std::string,std::string>>;
+
+/// A record as it travels from the logging call to the sink. Field values are stringified by the
+/// caller, since runtime objects cannot be read from the writer thread; the line itself, including
+/// the timestamp, is formatted by whoever writes it.
+struct LogRecord {
+    int level = 0;
+    std::chrono::system_clock::time_point time;
+    std::string message;
+    LogFields fields;
+};
+
+bool readFieldTuples(StarbytesObject object,LogFields &out) {
+    auto keys = StarbytesDictGetKeys(object);
+    auto values = StarbytesDictGetValues(object);
+    if(!keys || !values || !StarbytesObjectTypecheck(keys,StarbytesArrayType()) || !StarbytesObjectTypecheck(values,StarbytesArrayType())) {
+        return false;
+    }
+    auto len = StarbytesArrayGetLength(keys);
+    if(len != StarbytesArrayGetLength(values)) {
+        return false;
+    }
+    out.reserve(len);
+    for(unsigned i = 0; i < len; ++i) {
+        out.emplace_back(objectToLogValue(StarbytesArrayIndex(keys,i),1),objectToLogValue(StarbytesArrayIndex(values,i),1));
+    }
+    return true;
+}
+
+/// Appends "YYYY-MM-DD HH:MM:SS [LEVEL] message {k:v, ...}\n". The timestamp text is cached per
+/// thread and reformatted only when the second changes.
+void appendFormattedRecord(const LogRecord &record,std::string &out) {
+    thread_local std::time_t cachedSecond = 0;
+    thread_local char cachedStamp[32] = {};
+
+    auto second = std::chrono::system_clock::to_time_t(record.time);
+    if(second != cachedSecond || cachedStamp[0] == '\0') {
+        std::tm localTime{};
+#if defined(_WIN32)
+        localtime_s(&localTime,&second);
+#else
+        localtime_r(&second,&localTime);
+#endif
+        std::strftime(cachedStamp,sizeof(cachedStamp),"%Y-%m-%d %H:%M:%S",&localTime);
+        cachedSecond = second;
+    }
+
+    out += cachedStamp;
+    out += " [";
+    out += levelName(record.level);
+    out += "] ";
+    out += record.message;
+    if(!record.fields.empty()) {
+        out += " {";
+        for(size_t i = 0; i < record.fields.size(); ++i) {
+            if(i > 0) {
+                out += ", ";
+            }
+            out += record.fields[i].first;
+            out += ':';
+            out += record.fields[i].second;
+        }
+        out += '}';
+    }
+    out += '\n';
+}
+
+class LogSink {
+public:
+    virtual ~LogSink() = default;
+    virtual void write(const std::string &text) = 0;
+    virtual void flush() = 0;
+};
+
+class StderrSink final : public LogSink {
+public:
+    void write(const std::string &text) override {
+        std::fwrite(text.data(),1,text.size(),stderr);
+    }
+    void flush() override {
+        std::fflush(stderr);
+    }
+};
+
+class FileSink : public LogSink {
+public:
+    ~FileSink() override {
+        if(file) {
+            std::fclose(file);
+        }
+    }
+
+    bool open(const std::string &filePath) {
+        path = filePath;
+        file = std::fopen(path.c_str(),"ab");
+        if(!file) {
+            return false;
+        }
+        std::fseek(file,0,SEEK_END);
+        auto position = std::ftell(file);
+        size = position > 0 ? (uint64_t)position : 0;
+        return true;
+    }
+
+    void write(const std::string &text) override {
+        if(file) {
+            size += std::fwrite(text.data(),1,text.size(),file);
+        }
+    }
+
+    void flush() override {
+        if(file) {
+            std::fflush(file);
+        }
+    }
+
+protected:
+    std::string path;
+    std::FILE *file = nullptr;
+    uint64_t size = 0;
+};
+
+/// Keeps `path` below `maxBytes` by renaming it to path.1, path.1 to path.2 and so on, deleting
+/// the file that would become path.<maxFiles + 1>.
+class RotatingFileSink final : public FileSink {
+public:
+    RotatingFileSink(uint64_t maxBytes,int maxFiles): maxBytes(maxBytes),maxFiles(maxFiles) {}
+
+    void write(const std::string &text) override {
+        if(file && size > 0 && size + text.size() > maxBytes) {
+            rotate();
+        }
+        FileSink::write(text);
+    }
+
+private:
+    void rotate() {
+        std::fclose(file);
+        file = nullptr;
+        std::remove((path + "." + std::to_string(maxFiles)).c_str());
+        for(int index = maxFiles - 1; index >= 1; --index) {
+            std::rename((path + "." + std::to_string(index)).c_str(),(path + "." + std::to_string(index + 1)).c_str());
+        }
+        std::rename(path.c_str(),(path + ".1").c_str());
+        file = std::fopen(path.c_str(),"wb");
+        size = 0;
+    }
+
+    uint64_t maxBytes;
+    int maxFiles;
+};
+
+std::mutex g_sinkMutex;
+std::unique_ptr<LogSink> g_sink = std::make_unique<StderrSink>();
+std::atomic<uint64_t> g_writtenRecords{0};
+std::atomic<uint64_t> g_droppedRecords{0};
+
+/// Bounded multi-producer queue after Dmitry Vyukov's design. Every slot carries a sequence
+/// number, so producers claim slots with one compare-and-swap and never take a lock.
+class LogRing {
+public:
+    explicit LogRing(size_t requestedCapacity) {
+        size_t capacity = 2;
+        while(capacity < requestedCapacity) {
+            capacity <<= 1;
+        }
+        mask = capacity - 1;
+        slots = std::make_unique<Slot[]>(capacity);
+        for(size_t i = 0; i < capacity; ++i) {
+            slots[i].sequence.store(i,std::memory_order_relaxed);
+        }
+    }
+
+    size_t capacity() const {
+        return mask + 1;
+    }
+
+    bool tryPush(LogRecord &record) {
+        auto position = enqueuePosition.load(std::memory_order_relaxed);
+        for(;;) {
+            auto &slot = slots[position & mask];
+            auto sequence = slot.sequence.load(std::memory_order_acquire);
+            auto difference = (intptr_t)sequence - (intptr_t)position;
+            if(difference == 0) {
+                if(enqueuePosition.compare_exchange_weak(position,position + 1,std::memory_order_relaxed)) {
+                    slot.record = std::move(record);
+                    slot.sequence.store(position + 1,std::memory_order_release);
+                    return true;
+                }
+            }
+            else if(difference < 0) {
+                return false;
+            }
+            else {
+                position = enqueuePosition.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bool tryPop(LogRecord &out) {
+        auto position = dequeuePosition.load(std::memory_order_relaxed);
+        for(;;) {
+            auto &slot = slots[position & mask];
+            auto sequence = slot.sequence.load(std::memory_order_acquire);
+            auto difference = (intptr_t)sequence - (intptr_t)(position + 1);
+            if(difference == 0) {
+                if(dequeuePosition.compare_exchange_weak(position,position + 1,std::memory_order_relaxed)) {
+                    out = std::move(slot.record);
+                    slot.sequence.store(position + mask + 1,std::memory_order_release);
+                    return true;
+                }
+            }
+            else if(difference < 0) {
+                return false;
+            }
+            else {
+                position = dequeuePosition.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    size_t depth() const {
+        auto enqueued = enqueuePosition.load(std::memory_order_relaxed);
+        auto dequeued = dequeuePosition.load(std::memory_order_relaxed);
+        return enqueued > dequeued ? enqueued - dequeued : 0;
+    }
+
+private:
+    struct Slot {
+        std::atomic<size_t> sequence{0};
+        LogRecord record;
+    };
+
+    std::unique_ptr<Slot[]> slots;
+    size_t mask = 0;
+    alignas(64) std::atomic<size_t> enqueuePosition{0};
+    alignas(64) std::atomic<size_t> dequeuePosition{0};
+};
+
+/// Background writer. Producers only touch the ring; the writer wakes every flush interval, when
+/// the ring passes half full, or on flush(), and writes records to the sink in batches.
+class AsyncLogWriter {
+public:
+    ~AsyncLogWriter() {
+        stop();
+    }
+
+    bool running() const {
+        return worker.joinable();
+    }
+
+    void start(size_t capacity,size_t batchRecords,int flushMillis,bool blockWhenFull) {
+        stop();
+        ring = std::make_unique<LogRing>(capacity);
+        batchSize = batchRecords > 0 ? batchRecords : 1;
+        flushInterval = std::chrono::milliseconds(flushMillis > 0 ? flushMillis : 1);
+        blocking = blockWhenFull;
+        stopping.store(false);
+        submitted.store(0);
+        flushRequested = false;
+        flushedThrough = 0;
+        worker = std::thread([this]() {
+            run();
+        });
+    }
+
+    void stop() {
+        if(!worker.joinable()) {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(wakeMutex);
+            stopping.store(true);
+        }
+        wake.notify_one();
+        worker.join();
+        ring.reset();
+    }
+
+    bool submit(LogRecord &record) {
+        while(!ring->tryPush(record)) {
+            if(!blocking || stopping.load(std::memory_order_relaxed)) {
+                g_droppedRecords.fetch_add(1,std::memory_order_relaxed);
+                return false;
+            }
+            wakeWriter();
+            std::this_thread::yield();
+        }
+        submitted.fetch_add(1,std::memory_order_relaxed);
+        if(ring->depth() >= ring->capacity() / 2) {
+            wakeWriter();
+        }
+        return true;
+    }
+
+    /// Blocks until every record submitted before the call has reached the sink and the sink is flushed.
+    void flush() {
+        auto target = submitted.load(std::memory_order_relaxed);
+        std::unique_lock<std::mutex> lock(wakeMutex);
+        flushRequested = true;
+        wake.notify_one();
+        flushed.wait(lock,[&]() {
+            return flushedThrough >= target || !worker.joinable();
+        });
+    }
+
+    uint64_t queued() const {
+        return ring ? ring->depth() : 0;
+    }
+
+private:
+    void wakeWriter() {
+        if(writerSleeping.exchange(false,std::memory_order_acq_rel)) {
+            std::lock_guard<std::mutex> lock(wakeMutex);
+            wake.notify_one();
+        }
+    }
+
+    void run() {
+        std::string batch;
+        LogRecord record;
+        uint64_t processed = 0;
+        auto lastFlush = std::chrono::steady_clock::now();
+        for(;;) {
+            size_t inBatch = 0;
+            while(ring->tryPop(record)) {
+                appendFormattedRecord(record,batch);
+                record.fields.clear();
+                ++processed;
+                if(++inBatch >= batchSize) {
+                    writeBatch(batch,inBatch);
+                    inBatch = 0;
+                }
+            }
+            writeBatch(batch,inBatch);
+
+            bool wantFlush = false;
+            bool exiting = false;
+            {
+                std::unique_lock<std::mutex> lock(wakeMutex);
+                wantFlush = flushRequested || stopping.load() || std::chrono::steady_clock::now() - lastFlush >= flushInterval;
+                exiting = stopping.load() && ring->depth() == 0;
+            }
+            if(wantFlush) {
+                {
+                    std::lock_guard<std::mutex> sinkLock(g_sinkMutex);
+                    g_sink->flush();
+                }
+                lastFlush = std::chrono::steady_clock::now();
+                std::lock_guard<std::mutex> lock(wakeMutex);
+                flushRequested = false;
+                flushedThrough = processed;
+                flushed.notify_all();
+            }
+            if(exiting) {
+                break;
+            }
+
+            std::unique_lock<std::mutex> lock(wakeMutex);
+            if(flushRequested || stopping.load() || ring->depth() > 0) {
+                continue;
+            }
+            writerSleeping.store(true,std::memory_order_release);
+            wake.wait_for(lock,flushInterval);
+            writerSleeping.store(false,std::memory_order_release);
+        }
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        flushedThrough = processed;
+        flushed.notify_all();
+    }
+
+    void writeBatch(std::string &batch,size_t records) {
+        if(records == 0) {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(g_sinkMutex);
+            g_sink->write(batch);
+        }
+        g_writtenRecords.fetch_add(records,std::memory_order_relaxed);
+        batch.clear();
+    }
+
+    std::unique_ptr<LogRing> ring;
+    size_t batchSize = 256;
+    std::chrono::milliseconds flushInterval{100};
+    bool blocking = false;
+    std::thread worker;
+    std::atomic<bool> stopping{false};
+    std::atomic<bool> writerSleeping{false};
+    std::atomic<uint64_t> submitted{0};
+    std::mutex wakeMutex;
+    std::condition_variable wake;
+    std::condition_variable flushed;
+    bool flushRequested = false;
+    uint64_t flushedThrough = 0;
+};
+
+/// Destroyed before the sink, so the writer drains into it at exit.
+AsyncLogWriter g_asyncWriter;
+
 StarbytesObject writeLogLine(int level,const std::string &message,StarbytesObject fields) {
     level = clampLevel(level);
     if(level < g_minLevel) {
         return makeBool(false);
     }
 
-    std::ostringstream out;
-    out << nowTimestamp() << " [" << levelName(level) << "] " << message;
-    auto fieldsText = dictToLogFields(fields,0);
-    if(!fieldsText.empty()) {
-        out << " " << fieldsText;
+    LogRecord record;
+    record.level = level;
+    record.time = std::chrono::system_clock::now();
+    record.message = message;
+    if(fields && !readFieldTuples(fields,record.fields)) {
+        record.fields.clear();
     }
 
-    std::cerr << out.str() << std::endl;
+    if(g_asyncWriter.running()) {
+        return makeBool(g_asyncWriter.submit(record));
+    }
+
+    std::string line;
+    appendFormattedRecord(record,line);
+    {
+        std::lock_guard<std::mutex> lock(g_sinkMutex);
+        g_sink->write(line);
+        g_sink->flush();
+    }
+    g_writtenRecords.fetch_add(1,std::memory_order_relaxed);
     return makeBool(true);
 }
 
+bool replaceSink(std::unique_ptr<LogSink> sink) {
+    if(g_asyncWriter.running()) {
+        g_asyncWriter.flush();
+    }
+    std::lock_guard<std::mutex> lock(g_sinkMutex);
+    g_sink->flush();
+    g_sink = std::move(sink);
+    return true;
+}
+
 STARBYTES_FUNC(log_setMinLevel) {
     skipOptionalModuleReceiver(args,1);
 
@@ -284,6 +716,91 @@ STARBYTES_FUNC(log_error) {
     return writeLogLine(4,message,nullptr);
 }
 
+constexpr int kMaxAsyncCapacity = 1 << 22;
+
+STARBYTES_FUNC(log_startAsync) {
+    skipOptionalModuleReceiver(args,4);
+
+    int capacity = 0;
+    int batchSize = 0;
+    int flushMillis = 0;
+    bool blockWhenFull = false;
+    if(!readIntArg(args,capacity) || !readIntArg(args,batchSize) || !readIntArg(args,flushMillis) || !readBoolArg(args,blockWhenFull)) {
+        return failNativeIfEmpty(args,"startAsync expects (capacity:Int,batchSize:Int,flushMillis:Int,blockWhenFull:Bool)");
+    }
+    if(capacity < 2 || capacity > kMaxAsyncCapacity || batchSize < 1 || flushMillis < 1) {
+        return failNativeIfEmpty(args,"startAsync requires capacity between 2 and " + std::to_string(kMaxAsyncCapacity)
+                                 + ", a positive batchSize and a positive flushMillis");
+    }
+    g_asyncWriter.start((size_t)capacity,(size_t)batchSize,flushMillis,blockWhenFull);
+    return makeBool(true);
+}
+
+STARBYTES_FUNC(log_stopAsync) {
+    skipOptionalModuleReceiver(args,0);
+    bool wasRunning = g_asyncWriter.running();
+    g_asyncWriter.stop();
+    return makeBool(wasRunning);
+}
+
+STARBYTES_FUNC(log_flush) {
+    skipOptionalModuleReceiver(args,0);
+    if(g_asyncWriter.running()) {
+        g_asyncWriter.flush();
+        return makeBool(true);
+    }
+    std::lock_guard<std::mutex> lock(g_sinkMutex);
+    g_sink->flush();
+    return makeBool(true);
+}
+
+STARBYTES_FUNC(log_toStderr) {
+    skipOptionalModuleReceiver(args,0);
+    return makeBool(replaceSink(std::make_unique<StderrSink>()));
+}
+
+STARBYTES_FUNC(log_toFile) {
+    skipOptionalModuleReceiver(args,1);
+
+    std::string path;
+    if(!readStringArg(args,path) || path.empty()) {
+        return failNativeIfEmpty(args,"toFile requires a non-empty path");
+    }
+    auto sink = std::make_unique<FileSink>();
+    if(!sink->open(path)) {
+        return failNativeIfEmpty(args,"toFile failed to open " + path);
+    }
+    return makeBool(replaceSink(std::move(sink)));
+}
+
+STARBYTES_FUNC(log_toRotatingFile) {
+    skipOptionalModuleReceiver(args,3);
+
+    std::string path;
+    int maxBytes = 0;
+    int maxFiles = 0;
+    if(!readStringArg(args,path) || !readIntArg(args,maxBytes) || !readIntArg(args,maxFiles)
+       || path.empty() || maxBytes < 1 || maxFiles < 1) {
+        return failNativeIfEmpty(args,"toRotatingFile requires a non-empty path, a positive maxBytes and a positive maxFiles");
+    }
+    auto sink = std::make_unique<RotatingFileSink>((uint64_t)maxBytes,maxFiles);
+    if(!sink->open(path)) {
+        return failNativeIfEmpty(args,"toRotatingFile failed to open " + path);
+    }
+    return makeBool(replaceSink(std::move(sink)));
+}
+
+STARBYTES_FUNC(log_stats) {
+    skipOptionalModuleReceiver(args,0);
+
+    auto dict = StarbytesDictNew();
+    StarbytesDictSet(dict,StarbytesStrNewWithData("written"),makeLong(g_writtenRecords.load()));
+    StarbytesDictSet(dict,StarbytesStrNewWithData("dropped"),makeLong(g_droppedRecords.load()));
+    StarbytesDictSet(dict,StarbytesStrNewWithData("queued"),makeLong(g_asyncWriter.queued()));
+    StarbytesDictSet(dict,StarbytesStrNewWithData("async"),makeBool(g_asyncWriter.running()));
+    return dict;
+}
+
 void addFunc(StarbytesNativeModule *module,const char *name,unsigned argCount,StarbytesFuncCallback callback) {
     StarbytesFuncDesc desc;
     desc.name = CStringMake(name);
@@ -306,6 +823,13 @@ STARBYTES_NATIVE_MOD_MAIN() {
     addFunc(module,"log_info",1,log_info);
     addFunc(module,"log_warn",1,log_warn);
     addFunc(module,"log_error",1,log_error);
+    addFunc(module,"log_startAsync",4,log_startAsync);
+    addFunc(module,"log_stopAsync",0,log_stopAsync);
+    addFunc(module,"log_flush",0,log_flush);
+    addFunc(module,"log_toStderr",0,log_toStderr);
+    addFunc(module,"log_toFile",1,log_toFile);
+    addFunc(module,"log_toRotatingFile",3,log_toRotatingFile);
+    addFunc(module,"log_stats",0,log_stats);
 
     return module;
 }
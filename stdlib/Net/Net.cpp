@@ -3,9 +3,12 @@
 #include "starbytes/runtime/NativeModuleSupport.h"
 
 #include <climits>
+#include <future>
 #include <memory>
+#include <optional>
 #include <string>
-#include <unordered_map>
+#include <thread>
+#include <utility>
 #include <vector>
 
 #ifdef STARBYTES_HAS_ASIO
@@ -15,7 +18,9 @@
 namespace {
 
 using starbytes::string_set;
+using starbytes::Runtime::stdlib::ByteView;
 using starbytes::Runtime::stdlib::failNativeIfEmpty;
+using starbytes::Runtime::stdlib::readByteView;
 using starbytes::Runtime::stdlib::setNativeErrorIfEmpty;
 using starbytes::Runtime::stdlib::systemErrorMessage;
 
@@ -26,14 +31,161 @@ struct NativeArgsLayout {
 };
 
 #ifdef STARBYTES_HAS_ASIO
-struct TcpSocketState {
+struct NetHandleState;
+struct TcpSocketState;
+
+enum class NetOperation {
+    Read,
+    Write,
+    Accept
+};
+
+/// Result of an async socket operation. The reactor thread fills it in; the interpreter thread
+/// settles the task, because runtime objects may only be touched there.
+struct NetCompletion {
+    NetOperation operation = NetOperation::Read;
+    StarbytesTask task = nullptr;
+    NetHandleState *owner = nullptr;
+    std::error_code error;
+    size_t transferred = 0;
+    StarbytesObject buffer = nullptr;
+    std::vector<ByteView> sources;
+    std::vector<StarbytesObject> retained;
+    std::unique_ptr<TcpSocketState> accepted;
+};
+
+/// Shared io_context for every socket and listener. Blocking calls use it from the interpreter
+/// thread without running it; the first async operation starts a background thread that runs it.
+class NetReactor {
+public:
     asio::io_context io;
+
+    ~NetReactor() {
+        stop();
+    }
+
+    /// Queues `handler` on the reactor thread, which owns sockets with operations in flight.
+    template<typename Handler>
+    void post(Handler &&handler) {
+        ensureRunning();
+        asio::post(io,std::forward<Handler>(handler));
+    }
+
+    /// Runs `fn` on the reactor thread and waits for it, or inline when the thread is not running.
+    template<typename Fn>
+    void runOnReactor(Fn fn) {
+        if(!thread.joinable()) {
+            fn();
+            return;
+        }
+        std::promise<void> done;
+        auto finished = done.get_future();
+        asio::post(io,[&]() {
+            fn();
+            done.set_value();
+        });
+        finished.wait();
+    }
+
+    /// Operations the interpreter thread settles once the reactor has finished them.
+    starbytes::Runtime::stdlib::TaskCompletionQueue<std::unique_ptr<NetCompletion>> completions;
+
+    void stop() {
+        if(!thread.joinable()) {
+            return;
+        }
+        work.reset();
+        io.stop();
+        thread.join();
+    }
+
+private:
+    void ensureRunning() {
+        if(thread.joinable()) {
+            return;
+        }
+        work.emplace(asio::make_work_guard(io));
+        thread = std::thread([this]() {
+            io.run();
+        });
+    }
+
+    std::optional<asio::executor_work_guard<asio::io_context::executor_type>> work;
+    std::thread thread;
+};
+
+NetReactor g_reactor;
+
+/// Common to sockets and listeners. `pendingOperations` is only touched on the interpreter
+/// thread; while it is nonzero the reactor thread owns the asio object, so blocking calls are
+/// refused and quick ones run on the reactor.
+struct NetHandleState {
+    size_t pendingOperations = 0;
+
+    template<typename Fn>
+    void use(Fn fn) {
+        if(pendingOperations == 0) {
+            fn();
+        }
+        else {
+            g_reactor.runOnReactor(fn);
+        }
+    }
+};
+
+struct TcpSocketState : NetHandleState {
     asio::ip::tcp::socket socket;
 
-    TcpSocketState(): io(), socket(io) {}
+    TcpSocketState(): socket(g_reactor.io) {}
+};
+
+struct TcpListenerState : NetHandleState {
+    asio::ip::tcp::acceptor acceptor;
+
+    TcpListenerState(): acceptor(g_reactor.io) {}
 };
 
-std::unordered_map<StarbytesObject,std::unique_ptr<TcpSocketState>> g_socketRegistry;
+/// Async operations reference their socket or listener object, so this only runs once none are
+/// in flight and the interpreter thread owns the state again.
+template<typename State>
+void destroyState(void *data) {
+    delete static_cast<State *>(data);
+}
+
+/// Creates an object of a native class that owns `state`; the runtime frees it with the object.
+template<typename State>
+StarbytesObject makeStateObject(const char *className,std::unique_ptr<State> state) {
+    auto object = StarbytesObjectNew(StarbytesMakeClass(className));
+    StarbytesObjectSetNativeData(object,state.release(),destroyState<State>);
+    return object;
+}
+
+template<typename State>
+State *requireSelf(StarbytesFuncArgs args,const char *className,StarbytesObject *selfOut) {
+    auto self = StarbytesFuncArgsGetArg(args);
+    if(!self) {
+        setNativeErrorIfEmpty(args,std::string(className) + " receiver is missing");
+        return nullptr;
+    }
+    auto *state = static_cast<State *>(StarbytesObjectGetNativeData(self,destroyState<State>));
+    if(!state) {
+        setNativeErrorIfEmpty(args,std::string(className) + " receiver is invalid");
+        return nullptr;
+    }
+    if(selfOut) {
+        *selfOut = self;
+    }
+    return state;
+}
+
+/// Blocking calls would use the asio object on this thread while the reactor thread owns it.
+bool rejectWhileAsyncPending(StarbytesFuncArgs args,const NetHandleState &state,const char *operation) {
+    if(state.pendingOperations == 0) {
+        return false;
+    }
+    setNativeErrorIfEmpty(args,std::string(operation) + " cannot run while async operations are pending");
+    return true;
+}
 #endif
 
 StarbytesObject makeBool(bool value) {
@@ -65,6 +217,16 @@ bool readIntArg(StarbytesFuncArgs args,int &outValue) {
     return true;
 }
 
+bool readBoolArg(StarbytesFuncArgs args,bool &outValue) {
+    auto arg = StarbytesFuncArgsGetArg(args);
+    if(!arg || !StarbytesObjectTypecheck(arg,StarbytesBoolType())) {
+        setNativeErrorIfEmpty(args,"expected Bool argument");
+        return false;
+    }
+    outValue = (StarbytesBoolValue(arg) == StarbytesBoolFalse);
+    return true;
+}
+
 void skipOptionalModuleReceiver(StarbytesFuncArgs args,unsigned expectedUserArgs) {
     auto *raw = reinterpret_cast<NativeArgsLayout *>(args);
     if(!raw || raw->argc < raw->index) {
@@ -76,63 +238,169 @@ void skipOptionalModuleReceiver(StarbytesFuncArgs args,unsigned expectedUserArgs
     }
 }
 
-StarbytesObject intVectorToArray(const std::vector<unsigned char> &values) {
-    auto out = StarbytesArrayNew();
-    for(unsigned char value : values) {
-        StarbytesArrayPush(out,makeInt((int)value));
-    }
-    return out;
+StarbytesTask makeRejectedTask(const std::string &message) {
+    auto task = StarbytesTaskNew();
+    StarbytesTaskReject(task,message.c_str());
+    return task;
 }
 
 #ifdef STARBYTES_HAS_ASIO
-TcpSocketState *requireSocketSelf(StarbytesFuncArgs args) {
-    auto self = StarbytesFuncArgsGetArg(args);
-    if(!self) {
-        setNativeErrorIfEmpty(args,"TcpSocket receiver is missing");
-        return nullptr;
-    }
-    auto it = g_socketRegistry.find(self);
-    if(it == g_socketRegistry.end()) {
-        setNativeErrorIfEmpty(args,"TcpSocket receiver is invalid");
-        return nullptr;
-    }
-    return it->second.get();
+StarbytesObject makeCount(size_t value) {
+    return makeInt(value > (size_t)INT_MAX ? INT_MAX : (int)value);
 }
 
-bool readByteArrayArg(StarbytesFuncArgs args,std::vector<unsigned char> &outValues) {
+/// Reads an Array<Bytes> argument for a gather write. The chunk objects are referenced through
+/// `owners`, which the caller releases once the write is done.
+bool readChunksArg(StarbytesFuncArgs args,std::vector<ByteView> &outViews,std::vector<StarbytesObject> &owners) {
     auto arg = StarbytesFuncArgsGetArg(args);
     if(!arg || !StarbytesObjectTypecheck(arg,StarbytesArrayType())) {
-        setNativeErrorIfEmpty(args,"expected Bytes argument");
+        setNativeErrorIfEmpty(args,"expected Array<Bytes> argument");
         return false;
     }
-
-    auto len = StarbytesArrayGetLength(arg);
-    outValues.clear();
-    outValues.reserve(len);
-    for(unsigned i = 0; i < len; ++i) {
+    auto count = StarbytesArrayGetLength(arg);
+    outViews.resize(count);
+    for(unsigned i = 0; i < count; ++i) {
+        auto item = StarbytesArrayIndex(arg,i);
+        if(!readByteView(item,outViews[i])) {
+            setNativeErrorIfEmpty(args,"expected Array<Bytes> argument");
+            return false;
+        }
+    }
+    for(unsigned i = 0; i < count; ++i) {
         auto item = StarbytesArrayIndex(arg,i);
-        if(!item || !StarbytesObjectTypecheck(item,StarbytesNumType()) || StarbytesNumGetType(item) != NumTypeInt) {
-            setNativeErrorIfEmpty(args,"expected Bytes argument");
+        StarbytesObjectReference(item);
+        owners.push_back(item);
+    }
+    return true;
+}
+
+void releaseObjects(std::vector<StarbytesObject> &objects) {
+    for(auto object : objects) {
+        StarbytesObjectRelease(object);
+    }
+    objects.clear();
+}
+
+std::vector<asio::const_buffer> gatherBuffers(const std::vector<ByteView> &views) {
+    std::vector<asio::const_buffer> buffers;
+    buffers.reserve(views.size());
+    for(const auto &view : views) {
+        buffers.emplace_back(view.data,view.length);
+    }
+    return buffers;
+}
+
+void settleCompletion(NetCompletion &completion) {
+    auto task = completion.task;
+    auto &error = completion.error;
+    switch(completion.operation) {
+        case NetOperation::Read: {
+            if(!error || error == asio::error::eof) {
+                StarbytesBytesTruncate(completion.buffer,completion.transferred);
+                StarbytesTaskResolve(task,completion.buffer);
+            }
+            else {
+                StarbytesTaskReject(task,systemErrorMessage("readAsync failed",error).c_str());
+            }
+            StarbytesObjectRelease(completion.buffer);
+            break;
+        }
+        case NetOperation::Write: {
+            if(!error) {
+                auto written = makeCount(completion.transferred);
+                StarbytesTaskResolve(task,written);
+                StarbytesObjectRelease(written);
+            }
+            else {
+                StarbytesTaskReject(task,systemErrorMessage("writeAsync failed",error).c_str());
+            }
+            break;
+        }
+        case NetOperation::Accept: {
+            if(!error) {
+                auto object = makeStateObject("TcpSocket",std::move(completion.accepted));
+                StarbytesTaskResolve(task,object);
+                StarbytesObjectRelease(object);
+            }
+            else {
+                StarbytesTaskReject(task,systemErrorMessage("acceptAsync failed",error).c_str());
+            }
+            break;
+        }
+    }
+    // Released after the count drops: the owner object is among `retained` and may be freed here.
+    --completion.owner->pendingOperations;
+    releaseObjects(completion.retained);
+    StarbytesObjectRelease(task);
+}
+
+int net_driveTasks() {
+    return g_reactor.completions.drive([](std::unique_ptr<NetCompletion> &completion) {
+        settleCompletion(*completion);
+    });
+}
+
+/// Hands `completion` to the reactor thread; `start` begins the asio operation there and must
+/// pass the completion on to its handler. The owner object stays referenced until the operation
+/// settles.
+template<typename Start>
+StarbytesTask startAsyncOperation(StarbytesObject ownerObject,
+                                  NetHandleState &owner,
+                                  std::unique_ptr<NetCompletion> completion,
+                                  Start start) {
+    auto task = StarbytesTaskNew();
+    StarbytesObjectReference(task);
+    completion->task = task;
+    completion->owner = &owner;
+    StarbytesObjectReference(ownerObject);
+    completion->retained.push_back(ownerObject);
+    ++owner.pendingOperations;
+    g_reactor.completions.beginJob();
+    g_reactor.post([completion = std::move(completion),start]() mutable {
+        start(std::move(completion));
+    });
+    return task;
+}
+
+void finishOnReactor(std::unique_ptr<NetCompletion> completion,const std::error_code &error,size_t transferred) {
+    completion->error = error;
+    completion->transferred = transferred;
+    g_reactor.completions.complete(std::move(completion));
+}
+
+TcpListenerState *requireListenerSelf(StarbytesFuncArgs args,StarbytesObject *selfOut = nullptr) {
+    return requireSelf<TcpListenerState>(args,"TcpListener",selfOut);
+}
+
+template<typename SocketLike>
+bool applyBufferSizes(SocketLike &socket,int receiveBytes,int sendBytes,std::error_code &ec) {
+    if(receiveBytes > 0) {
+        socket.set_option(asio::socket_base::receive_buffer_size(receiveBytes),ec);
+        if(ec) {
             return false;
         }
-        auto value = StarbytesNumGetIntValue(item);
-        if(value < 0 || value > 255) {
-            setNativeErrorIfEmpty(args,"byte values must be between 0 and 255");
+    }
+    if(sendBytes > 0) {
+        socket.set_option(asio::socket_base::send_buffer_size(sendBytes),ec);
+        if(ec) {
             return false;
         }
-        outValues.push_back((unsigned char)value);
     }
     return true;
 }
 #endif
 
+#ifdef STARBYTES_HAS_ASIO
+TcpSocketState *requireSocketSelf(StarbytesFuncArgs args,StarbytesObject *selfOut = nullptr) {
+    return requireSelf<TcpSocketState>(args,"TcpSocket",selfOut);
+}
+#endif
+
 STARBYTES_FUNC(net_tcpSocket) {
     skipOptionalModuleReceiver(args,0);
 
 #ifdef STARBYTES_HAS_ASIO
-    auto object = StarbytesObjectNew(StarbytesMakeClass("TcpSocket"));
-    g_socketRegistry[object] = std::make_unique<TcpSocketState>();
-    return object;
+    return makeStateObject("TcpSocket",std::make_unique<TcpSocketState>());
 #else
     return failNativeIfEmpty(args,"Net support is unavailable");
 #endif
@@ -196,6 +464,9 @@ STARBYTES_FUNC(Net_TcpSocket_connect) {
         return nullptr;
     }
 
+    if(rejectWhileAsyncPending(args,*state,"connect")) {
+        return nullptr;
+    }
     std::string host;
     int port = 0;
     if(!readStringArg(args,host) || !readIntArg(args,port) || host.empty() || port <= 0 || port > 65535) {
@@ -203,7 +474,7 @@ STARBYTES_FUNC(Net_TcpSocket_connect) {
     }
 
     std::error_code ec;
-    asio::ip::tcp::resolver resolver(state->io);
+    asio::ip::tcp::resolver resolver(g_reactor.io);
     auto endpoints = resolver.resolve(host,std::to_string(port),ec);
     if(ec) {
         return failNativeIfEmpty(args,systemErrorMessage("connect resolve failed",ec));
@@ -226,23 +497,30 @@ STARBYTES_FUNC(Net_TcpSocket_read) {
         return nullptr;
     }
 
+    if(rejectWhileAsyncPending(args,*state,"read")) {
+        return nullptr;
+    }
     int maxBytes = 0;
     if(!readIntArg(args,maxBytes) || maxBytes < 0) {
         return failNativeIfEmpty(args,"read requires a non-negative maxBytes");
     }
+    auto buffer = StarbytesBytesNew((size_t)maxBytes);
+    if(!buffer) {
+        return failNativeIfEmpty(args,"read failed to allocate buffer");
+    }
     if(maxBytes == 0) {
-        return StarbytesArrayNew();
+        return buffer;
     }
 
-    std::vector<unsigned char> buffer((size_t)maxBytes);
     std::error_code ec;
-    auto readCount = state->socket.read_some(asio::buffer(buffer),ec);
+    auto readCount = state->socket.read_some(asio::buffer(StarbytesBytesGetData(buffer),(size_t)maxBytes),ec);
     if(ec && ec != asio::error::eof) {
+        StarbytesObjectRelease(buffer);
         return failNativeIfEmpty(args,systemErrorMessage("read failed",ec));
     }
 
-    buffer.resize(readCount);
-    return intVectorToArray(buffer);
+    StarbytesBytesTruncate(buffer,readCount);
+    return buffer;
 #else
     return failNativeIfEmpty(args,"Net support is unavailable");
 #endif
@@ -255,13 +533,16 @@ STARBYTES_FUNC(Net_TcpSocket_write) {
         return nullptr;
     }
 
-    std::vector<unsigned char> bytes;
-    if(!readByteArrayArg(args,bytes)) {
+    if(rejectWhileAsyncPending(args,*state,"write")) {
         return nullptr;
     }
+    ByteView bytes;
+    if(!readByteView(StarbytesFuncArgsGetArg(args),bytes)) {
+        return failNativeIfEmpty(args,"expected Bytes argument");
+    }
 
     std::error_code ec;
-    auto written = asio::write(state->socket,asio::buffer(bytes),ec);
+    auto written = asio::write(state->socket,asio::buffer(bytes.data,bytes.length),ec);
     if(ec) {
         return failNativeIfEmpty(args,systemErrorMessage("write failed",ec));
     }
@@ -282,6 +563,9 @@ STARBYTES_FUNC(Net_TcpSocket_writeText) {
         return nullptr;
     }
 
+    if(rejectWhileAsyncPending(args,*state,"writeText")) {
+        return nullptr;
+    }
     std::string text;
     if(!readStringArg(args,text)) {
         return nullptr;
@@ -310,7 +594,9 @@ STARBYTES_FUNC(Net_TcpSocket_close) {
     }
 
     std::error_code ec;
-    state->socket.close(ec);
+    g_reactor.runOnReactor([&]() {
+        state->socket.close(ec);
+    });
     if(ec) {
         return failNativeIfEmpty(args,systemErrorMessage("close failed",ec));
     }
@@ -326,7 +612,11 @@ STARBYTES_FUNC(Net_TcpSocket_isOpen) {
     if(!state) {
         return makeBool(false);
     }
-    return makeBool(state->socket.is_open());
+    bool open = false;
+    state->use([&]() {
+        open = state->socket.is_open();
+    });
+    return makeBool(open);
 #else
     return makeBool(false);
 #endif
@@ -340,7 +630,10 @@ STARBYTES_FUNC(Net_TcpSocket_remoteAddress) {
     }
 
     std::error_code ec;
-    auto endpoint = state->socket.remote_endpoint(ec);
+    asio::ip::tcp::endpoint endpoint;
+    state->use([&]() {
+        endpoint = state->socket.remote_endpoint(ec);
+    });
     if(ec) {
         return StarbytesStrNewWithData("");
     }
@@ -359,7 +652,10 @@ STARBYTES_FUNC(Net_TcpSocket_remotePort) {
     }
 
     std::error_code ec;
-    auto endpoint = state->socket.remote_endpoint(ec);
+    asio::ip::tcp::endpoint endpoint;
+    state->use([&]() {
+        endpoint = state->socket.remote_endpoint(ec);
+    });
     if(ec) {
         return makeInt(0);
     }
@@ -369,6 +665,327 @@ STARBYTES_FUNC(Net_TcpSocket_remotePort) {
 #endif
 }
 
+STARBYTES_FUNC(Net_TcpSocket_writeAll) {
+#ifdef STARBYTES_HAS_ASIO
+    auto *state = requireSocketSelf(args);
+    if(!state) {
+        return nullptr;
+    }
+
+    if(rejectWhileAsyncPending(args,*state,"writeAll")) {
+        return nullptr;
+    }
+    std::vector<ByteView> chunks;
+    std::vector<StarbytesObject> owners;
+    if(!readChunksArg(args,chunks,owners)) {
+        return nullptr;
+    }
+
+    std::error_code ec;
+    auto written = asio::write(state->socket,gatherBuffers(chunks),ec);
+    releaseObjects(owners);
+    if(ec) {
+        return failNativeIfEmpty(args,systemErrorMessage("writeAll failed",ec));
+    }
+    return makeCount(written);
+#else
+    return failNativeIfEmpty(args,"Net support is unavailable");
+#endif
+}
+
+STARBYTES_FUNC(Net_TcpSocket_readAsync) {
+#ifdef STARBYTES_HAS_ASIO
+    StarbytesObject self = nullptr;
+    auto *state = requireSocketSelf(args,&self);
+    if(!state) {
+        return nullptr;
+    }
+
+    int maxBytes = 0;
+    if(!readIntArg(args,maxBytes) || maxBytes < 0) {
+        return makeRejectedTask("readAsync requires a non-negative maxBytes");
+    }
+    auto buffer = StarbytesBytesNew((size_t)maxBytes);
+    if(!buffer) {
+        return makeRejectedTask("readAsync failed to allocate buffer");
+    }
+    if(maxBytes == 0) {
+        auto task = StarbytesTaskNew();
+        StarbytesTaskResolve(task,buffer);
+        StarbytesObjectRelease(buffer);
+        return task;
+    }
+
+    auto completion = std::make_unique<NetCompletion>();
+    completion->operation = NetOperation::Read;
+    completion->buffer = buffer;
+    auto *data = StarbytesBytesGetData(buffer);
+    return startAsyncOperation(self,*state,std::move(completion),[state,data,maxBytes](std::unique_ptr<NetCompletion> pending) {
+        state->socket.async_read_some(asio::buffer(data,(size_t)maxBytes),
+                                      [pending = std::move(pending)](const std::error_code &error,size_t count) mutable {
+            finishOnReactor(std::move(pending),error,count);
+        });
+    });
+#else
+    return makeRejectedTask("Net support is unavailable");
+#endif
+}
+
+STARBYTES_FUNC(Net_TcpSocket_writeAsync) {
+#ifdef STARBYTES_HAS_ASIO
+    StarbytesObject self = nullptr;
+    auto *state = requireSocketSelf(args,&self);
+    if(!state) {
+        return nullptr;
+    }
+
+    auto data = StarbytesFuncArgsGetArg(args);
+    auto completion = std::make_unique<NetCompletion>();
+    completion->operation = NetOperation::Write;
+    completion->sources.resize(1);
+    if(!readByteView(data,completion->sources[0])) {
+        return makeRejectedTask("expected Bytes argument");
+    }
+    StarbytesObjectReference(data);
+    completion->retained.push_back(data);
+    return startAsyncOperation(self,*state,std::move(completion),[state](std::unique_ptr<NetCompletion> pending) {
+        auto buffers = gatherBuffers(pending->sources);
+        asio::async_write(state->socket,buffers,[pending = std::move(pending)](const std::error_code &error,size_t count) mutable {
+            finishOnReactor(std::move(pending),error,count);
+        });
+    });
+#else
+    return makeRejectedTask("Net support is unavailable");
+#endif
+}
+
+STARBYTES_FUNC(Net_TcpSocket_writeAllAsync) {
+#ifdef STARBYTES_HAS_ASIO
+    StarbytesObject self = nullptr;
+    auto *state = requireSocketSelf(args,&self);
+    if(!state) {
+        return nullptr;
+    }
+
+    auto completion = std::make_unique<NetCompletion>();
+    completion->operation = NetOperation::Write;
+    if(!readChunksArg(args,completion->sources,completion->retained)) {
+        return makeRejectedTask("expected Array<Bytes> argument");
+    }
+    return startAsyncOperation(self,*state,std::move(completion),[state](std::unique_ptr<NetCompletion> pending) {
+        auto buffers = gatherBuffers(pending->sources);
+        asio::async_write(state->socket,buffers,[pending = std::move(pending)](const std::error_code &error,size_t count) mutable {
+            finishOnReactor(std::move(pending),error,count);
+        });
+    });
+#else
+    return makeRejectedTask("Net support is unavailable");
+#endif
+}
+
+STARBYTES_FUNC(Net_TcpSocket_setBufferSizes) {
+#ifdef STARBYTES_HAS_ASIO
+    auto *state = requireSocketSelf(args);
+    if(!state) {
+        return nullptr;
+    }
+
+    int receiveBytes = 0;
+    int sendBytes = 0;
+    if(!readIntArg(args,receiveBytes) || !readIntArg(args,sendBytes) || receiveBytes < 0 || sendBytes < 0) {
+        return failNativeIfEmpty(args,"setBufferSizes requires non-negative sizes");
+    }
+    std::error_code ec;
+    bool applied = false;
+    state->use([&]() {
+        applied = applyBufferSizes(state->socket,receiveBytes,sendBytes,ec);
+    });
+    if(!applied) {
+        return failNativeIfEmpty(args,systemErrorMessage("setBufferSizes failed",ec));
+    }
+    return makeBool(true);
+#else
+    return failNativeIfEmpty(args,"Net support is unavailable");
+#endif
+}
+
+STARBYTES_FUNC(Net_TcpSocket_setNoDelay) {
+#ifdef STARBYTES_HAS_ASIO
+    auto *state = requireSocketSelf(args);
+    if(!state) {
+        return nullptr;
+    }
+
+    bool enabled = false;
+    if(!readBoolArg(args,enabled)) {
+        return nullptr;
+    }
+    std::error_code ec;
+    state->use([&]() {
+        state->socket.set_option(asio::ip::tcp::no_delay(enabled),ec);
+    });
+    if(ec) {
+        return failNativeIfEmpty(args,systemErrorMessage("setNoDelay failed",ec));
+    }
+    return makeBool(true);
+#else
+    return failNativeIfEmpty(args,"Net support is unavailable");
+#endif
+}
+
+STARBYTES_FUNC(net_tcpListen) {
+    skipOptionalModuleReceiver(args,3);
+
+    std::string host;
+    int port = 0;
+    int backlog = 0;
+    if(!readStringArg(args,host) || !readIntArg(args,port) || !readIntArg(args,backlog)
+       || host.empty() || port < 0 || port > 65535 || backlog < 0) {
+        return failNativeIfEmpty(args,"tcpListen requires a host string, a port between 0 and 65535 and a non-negative backlog");
+    }
+
+#ifdef STARBYTES_HAS_ASIO
+    std::error_code ec;
+    asio::ip::tcp::resolver resolver(g_reactor.io);
+    auto endpoints = resolver.resolve(host,std::to_string(port),asio::ip::resolver_base::passive,ec);
+    if(ec || endpoints.empty()) {
+        return failNativeIfEmpty(args,systemErrorMessage("tcpListen resolve failed",ec));
+    }
+
+    auto state = std::make_unique<TcpListenerState>();
+    auto endpoint = endpoints.begin()->endpoint();
+    auto &acceptor = state->acceptor;
+    acceptor.open(endpoint.protocol(),ec);
+    if(!ec) {
+        acceptor.set_option(asio::socket_base::reuse_address(true),ec);
+    }
+    if(!ec) {
+        acceptor.bind(endpoint,ec);
+    }
+    if(!ec) {
+        acceptor.listen(backlog > 0 ? backlog : (int)asio::socket_base::max_listen_connections,ec);
+    }
+    if(ec) {
+        return failNativeIfEmpty(args,systemErrorMessage("tcpListen failed",ec));
+    }
+
+    return makeStateObject("TcpListener",std::move(state));
+#else
+    return failNativeIfEmpty(args,"Net support is unavailable");
+#endif
+}
+
+STARBYTES_FUNC(Net_TcpListener_accept) {
+#ifdef STARBYTES_HAS_ASIO
+    auto *listener = requireListenerSelf(args);
+    if(!listener) {
+        return nullptr;
+    }
+
+    if(rejectWhileAsyncPending(args,*listener,"accept")) {
+        return nullptr;
+    }
+    auto accepted = std::make_unique<TcpSocketState>();
+    std::error_code ec;
+    listener->acceptor.accept(accepted->socket,ec);
+    if(ec) {
+        return failNativeIfEmpty(args,systemErrorMessage("accept failed",ec));
+    }
+    return makeStateObject("TcpSocket",std::move(accepted));
+#else
+    return failNativeIfEmpty(args,"Net support is unavailable");
+#endif
+}
+
+STARBYTES_FUNC(Net_TcpListener_acceptAsync) {
+#ifdef STARBYTES_HAS_ASIO
+    StarbytesObject self = nullptr;
+    auto *listener = requireListenerSelf(args,&self);
+    if(!listener) {
+        return nullptr;
+    }
+
+    auto completion = std::make_unique<NetCompletion>();
+    completion->operation = NetOperation::Accept;
+    completion->accepted = std::make_unique<TcpSocketState>();
+    return startAsyncOperation(self,*listener,std::move(completion),[listener](std::unique_ptr<NetCompletion> pending) {
+        auto &socket = pending->accepted->socket;
+        listener->acceptor.async_accept(socket,[pending = std::move(pending)](const std::error_code &error) mutable {
+            finishOnReactor(std::move(pending),error,0);
+        });
+    });
+#else
+    return makeRejectedTask("Net support is unavailable");
+#endif
+}
+
+STARBYTES_FUNC(Net_TcpListener_setBufferSizes) {
+#ifdef STARBYTES_HAS_ASIO
+    auto *listener = requireListenerSelf(args);
+    if(!listener) {
+        return nullptr;
+    }
+
+    int receiveBytes = 0;
+    int sendBytes = 0;
+    if(!readIntArg(args,receiveBytes) || !readIntArg(args,sendBytes) || receiveBytes < 0 || sendBytes < 0) {
+        return failNativeIfEmpty(args,"setBufferSizes requires non-negative sizes");
+    }
+    std::error_code ec;
+    bool applied = false;
+    listener->use([&]() {
+        applied = applyBufferSizes(listener->acceptor,receiveBytes,sendBytes,ec);
+    });
+    if(!applied) {
+        return failNativeIfEmpty(args,systemErrorMessage("setBufferSizes failed",ec));
+    }
+    return makeBool(true);
+#else
+    return failNativeIfEmpty(args,"Net support is unavailable");
+#endif
+}
+
+STARBYTES_FUNC(Net_TcpListener_localPort) {
+#ifdef STARBYTES_HAS_ASIO
+    auto *listener = requireListenerSelf(args);
+    if(!listener) {
+        return makeInt(0);
+    }
+
+    std::error_code ec;
+    asio::ip::tcp::endpoint endpoint;
+    listener->use([&]() {
+        endpoint = listener->acceptor.local_endpoint(ec);
+    });
+    if(ec) {
+        return makeInt(0);
+    }
+    return makeInt((int)endpoint.port());
+#else
+    return makeInt(0);
+#endif
+}
+
+STARBYTES_FUNC(Net_TcpListener_close) {
+#ifdef STARBYTES_HAS_ASIO
+    auto *listener = requireListenerSelf(args);
+    if(!listener) {
+        return nullptr;
+    }
+
+    std::error_code ec;
+    g_reactor.runOnReactor([&]() {
+        listener->acceptor.close(ec);
+    });
+    if(ec) {
+        return failNativeIfEmpty(args,systemErrorMessage("close failed",ec));
+    }
+    return makeBool(true);
+#else
+    return failNativeIfEmpty(args,"Net support is unavailable");
+#endif
+}
+
 void addFunc(StarbytesNativeModule *module,const char *name,unsigned argCount,StarbytesFuncCallback callback) {
     StarbytesFuncDesc desc;
     desc.name = CStringMake(name);
@@ -394,6 +1011,23 @@ STARBYTES_NATIVE_MOD_MAIN() {
     addFunc(module,"Net_TcpSocket_isOpen",1,Net_TcpSocket_isOpen);
     addFunc(module,"Net_TcpSocket_remoteAddress",1,Net_TcpSocket_remoteAddress);
     addFunc(module,"Net_TcpSocket_remotePort",1,Net_TcpSocket_remotePort);
+    addFunc(module,"Net_TcpSocket_writeAll",2,Net_TcpSocket_writeAll);
+    addFunc(module,"Net_TcpSocket_readAsync",2,Net_TcpSocket_readAsync);
+    addFunc(module,"Net_TcpSocket_writeAsync",2,Net_TcpSocket_writeAsync);
+    addFunc(module,"Net_TcpSocket_writeAllAsync",2,Net_TcpSocket_writeAllAsync);
+    addFunc(module,"Net_TcpSocket_setBufferSizes",3,Net_TcpSocket_setBufferSizes);
+    addFunc(module,"Net_TcpSocket_setNoDelay",2,Net_TcpSocket_setNoDelay);
+
+    addFunc(module,"net_tcpListen",3,net_tcpListen);
+    addFunc(module,"Net_TcpListener_accept",1,Net_TcpListener_accept);
+    addFunc(module,"Net_TcpListener_acceptAsync",1,Net_TcpListener_acceptAsync);
+    addFunc(module,"Net_TcpListener_setBufferSizes",3,Net_TcpListener_setBufferSizes);
+    addFunc(module,"Net_TcpListener_localPort",1,Net_TcpListener_localPort);
+    addFunc(module,"Net_TcpListener_close",1,Net_TcpListener_close);
+
+#ifdef STARBYTES_HAS_ASIO
+    StarbytesRuntimeAddTaskDriver(net_driveTasks);
+#endif
 
     return module;
 }
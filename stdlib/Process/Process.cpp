@@ -2,20 +2,38 @@
 #include "starbytes/base/ADT.h"
 #include "starbytes/runtime/NativeModuleSupport.h"
 
+#include <algorithm>
 #include <array>
+#include <cerrno>
 #include <cstdio>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
-#if defined(HAS_SYS_WAIT_H)
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <spawn.h>
 #include <sys/wait.h>
+#include <unistd.h>
+
+extern char **environ;
 #endif
 
 namespace {
 
 using starbytes::Twine;
+using starbytes::Runtime::stdlib::ByteView;
 using starbytes::Runtime::stdlib::errnoMessage;
 using starbytes::Runtime::stdlib::failNativeIfEmpty;
+using starbytes::Runtime::stdlib::readByteView;
 using starbytes::Runtime::stdlib::setNativeErrorIfEmpty;
 
 struct NativeArgsLayout {
@@ -27,9 +45,14 @@ struct NativeArgsLayout {
 struct ProcessRunOutput {
     int exitCode = -1;
     std::string output;
+    std::string errorOutput;
     bool started = false;
 };
 
+using EnvironmentOverrides = std::vector<std::pair<std::string,std::string>>;
+
+constexpr int kMaxPoolSize = 1024;
+
 StarbytesObject makeBool(bool value) {
     // Runtime bool consumption currently interprets StarbytesBoolFalse as logical true.
     return StarbytesBoolNew(value ? StarbytesBoolFalse : StarbytesBoolTrue);
@@ -49,6 +72,16 @@ bool readStringArg(StarbytesFuncArgs args,std::string &outValue) {
     return true;
 }
 
+bool readIntArg(StarbytesFuncArgs args,int &outValue) {
+    auto arg = StarbytesFuncArgsGetArg(args);
+    if(!arg || !StarbytesObjectTypecheck(arg,StarbytesNumType()) || StarbytesNumGetType(arg) != NumTypeInt) {
+        setNativeErrorIfEmpty(args,"expected Int argument");
+        return false;
+    }
+    outValue = StarbytesNumGetIntValue(arg);
+    return true;
+}
+
 bool readStringArrayArg(StarbytesFuncArgs args,std::vector<std::string> &outValues) {
     auto arg = StarbytesFuncArgsGetArg(args);
     if(!arg || !StarbytesObjectTypecheck(arg,StarbytesArrayType())) {
@@ -70,6 +103,35 @@ bool readStringArrayArg(StarbytesFuncArgs args,std::vector<std::string> &outValu
     return true;
 }
 
+/// Reads a Dict of String names to String values.
+bool readEnvironmentArg(StarbytesFuncArgs args,EnvironmentOverrides &outValues) {
+    auto arg = StarbytesFuncArgsGetArg(args);
+    if(!arg || !StarbytesObjectTypecheck(arg,StarbytesDictType())) {
+        setNativeErrorIfEmpty(args,"expected Dict environment argument");
+        return false;
+    }
+    auto keys = StarbytesDictGetKeys(arg);
+    auto values = StarbytesDictGetValues(arg);
+    auto len = keys ? StarbytesArrayGetLength(keys) : 0;
+    outValues.clear();
+    outValues.reserve(len);
+    for(unsigned i = 0; i < len; ++i) {
+        auto key = StarbytesArrayIndex(keys,i);
+        auto value = values ? StarbytesArrayIndex(values,i) : nullptr;
+        if(!key || !value || !StarbytesObjectTypecheck(key,StarbytesStrType()) || !StarbytesObjectTypecheck(value,StarbytesStrType())) {
+            setNativeErrorIfEmpty(args,"environment entries must map String names to String values");
+            return false;
+        }
+        std::string name = StarbytesStrGetBuffer(key);
+        if(name.empty() || name.find('=') != std::string::npos) {
+            setNativeErrorIfEmpty(args,"environment names must be non-empty and must not contain '='");
+            return false;
+        }
+        outValues.emplace_back(std::move(name),StarbytesStrGetBuffer(value));
+    }
+    return true;
+}
+
 void skipOptionalModuleReceiver(StarbytesFuncArgs args,unsigned expectedUserArgs) {
     auto *raw = reinterpret_cast<NativeArgsLayout *>(args);
     if(!raw || raw->argc < raw->index) {
@@ -110,6 +172,16 @@ std::string quoteShellArg(const std::string &value) {
 #endif
 }
 
+StarbytesObject makeProcessResult(const ProcessRunOutput &result) {
+    auto object = StarbytesObjectNew(StarbytesMakeClass("ProcessResult"));
+    StarbytesObjectAddProperty(object,(char *)"exitCode",makeInt(result.exitCode));
+    StarbytesObjectAddProperty(object,(char *)"output",StarbytesStrNewWithData(result.output.c_str()));
+    StarbytesObjectAddProperty(object,(char *)"errorOutput",StarbytesStrNewWithData(result.errorOutput.c_str()));
+    StarbytesObjectAddProperty(object,(char *)"success",makeBool(result.exitCode == 0));
+    return object;
+}
+
+#if defined(_WIN32)
 std::string buildCommandFromArgs(const std::string &program,const std::vector<std::string> &args) {
     Twine command;
     command + quoteShellArg(program);
@@ -124,11 +196,7 @@ ProcessRunOutput runCommandCapture(const std::string &command) {
     ProcessRunOutput out;
     std::string commandWithRedirect = command + " 2>&1";
 
-#if defined(_WIN32)
     FILE *pipe = _popen(commandWithRedirect.c_str(),"r");
-#else
-    FILE *pipe = popen(commandWithRedirect.c_str(),"r");
-#endif
     if(!pipe) {
         return out;
     }
@@ -138,35 +206,621 @@ ProcessRunOutput runCommandCapture(const std::string &command) {
     while(std::fgets(buffer.data(),(int)buffer.size(),pipe) != nullptr) {
         out.output += buffer.data();
     }
-
-#if defined(_WIN32)
-    auto status = _pclose(pipe);
-    out.exitCode = status;
+    out.exitCode = _pclose(pipe);
+    return out;
+}
 #else
-    auto status = pclose(pipe);
-#if defined(HAS_SYS_WAIT_H)
-    if(WIFEXITED(status)) {
-        out.exitCode = WEXITSTATUS(status);
+constexpr size_t kPipeReadBytes = 64 * 1024;
+constexpr int kReapPollMillis = 10;
+
+void closeFd(int &fd) {
+    if(fd >= 0) {
+        close(fd);
+        fd = -1;
     }
-    else {
-        out.exitCode = status;
+}
+
+/// Where pipe() and its FD_CLOEXEC fcntl are separate calls, a child spawned by another thread
+/// (a ProcessPool supervisor) in between would inherit the new pipe and keep its reader from ever
+/// seeing EOF. There, pipes are created and children spawned under this lock. Linux creates pipes
+/// close-on-exec atomically and Apple spawns with POSIX_SPAWN_CLOEXEC_DEFAULT, so neither needs it.
+std::unique_lock<std::mutex> lockPipeCreation() {
+#if defined(__linux__) || defined(__APPLE__)
+    return std::unique_lock<std::mutex>();
+#else
+    static std::mutex mutex;
+    return std::unique_lock<std::mutex>(mutex);
+#endif
+}
+
+bool makePipe(int fds[2]) {
+#if defined(__linux__)
+    return pipe2(fds,O_CLOEXEC) == 0;
+#else
+    if(pipe(fds) != 0) {
+        return false;
     }
+    fcntl(fds[0],F_SETFD,FD_CLOEXEC);
+    fcntl(fds[1],F_SETFD,FD_CLOEXEC);
+    return true;
+#endif
+}
+
+/// Writes to a pipe whose reader may have exited. Such a write fails with EPIPE instead of raising
+/// SIGPIPE, which would otherwise end the interpreter.
+ssize_t writeWithoutSigpipe(int fd,const char *data,size_t length) {
+#if defined(F_SETNOSIGPIPE)
+    return write(fd,data,length);
 #else
-    out.exitCode = status;
+    sigset_t pipeSignal;
+    sigset_t previous;
+    sigset_t pendingSignals;
+    sigemptyset(&pipeSignal);
+    sigaddset(&pipeSignal,SIGPIPE);
+    pthread_sigmask(SIG_BLOCK,&pipeSignal,&previous);
+    sigpending(&pendingSignals);
+    bool alreadyPending = sigismember(&pendingSignals,SIGPIPE) == 1;
+
+    auto written = write(fd,data,length);
+    if(written < 0 && errno == EPIPE && !alreadyPending) {
+        int savedErrno = errno;
+        struct timespec zero = {0,0};
+        while(sigtimedwait(&pipeSignal,nullptr,&zero) < 0 && errno == EINTR) {
+        }
+        errno = savedErrno;
+    }
+    pthread_sigmask(SIG_SETMASK,&previous,nullptr);
+    return written;
+#endif
+}
+
+struct SpawnSpec {
+    std::string program;
+    std::vector<std::string> args;
+    /// "NAME=value" entries. Empty means the child inherits this process's environment.
+    std::vector<std::string> environment;
+    bool pipeStdin = false;
+    bool mergeStderr = false;
+};
+
+/// Copies this process's environment with `overrides` applied.
+std::vector<std::string> buildEnvironment(const EnvironmentOverrides &overrides) {
+    std::vector<std::string> out;
+    for(char **entry = environ; entry && *entry; ++entry) {
+        std::string item(*entry);
+        auto name = item.substr(0,item.find('='));
+        bool replaced = std::any_of(overrides.begin(),overrides.end(),[&](const std::pair<std::string,std::string> &override) {
+            return override.first == name;
+        });
+        if(!replaced) {
+            out.push_back(std::move(item));
+        }
+    }
+    for(const auto &override : overrides) {
+        out.push_back(override.first + "=" + override.second);
+    }
+    return out;
+}
+
+/// A spawned child and the parent ends of its pipes. Output is read into buffers and queued input
+/// is written as the pipes become ready, so a child blocked on one pipe never stalls the others.
+struct ChildIO {
+    pid_t pid = -1;
+    int stdinFd = -1;
+    int stdoutFd = -1;
+    int stderrFd = -1;
+    std::string input;
+    size_t inputOffset = 0;
+    bool closeStdinWhenWritten = false;
+    std::string stdoutData;
+    std::string stderrData;
+    bool exited = false;
+    int exitCode = -1;
+
+    ChildIO() = default;
+    ChildIO(const ChildIO &) = delete;
+    ChildIO &operator=(const ChildIO &) = delete;
+
+    ~ChildIO();
+
+    bool outputOpen() const {
+        return stdoutFd >= 0 || stderrFd >= 0;
+    }
+
+    bool wantsInput() const {
+        return stdinFd >= 0 && inputOffset < input.size();
+    }
+
+    void addPollFds(std::vector<pollfd> &fds) const {
+        if(stdoutFd >= 0) {
+            fds.push_back(pollfd{stdoutFd,POLLIN,0});
+        }
+        if(stderrFd >= 0) {
+            fds.push_back(pollfd{stderrFd,POLLIN,0});
+        }
+        if(wantsInput()) {
+            fds.push_back(pollfd{stdinFd,POLLOUT,0});
+        }
+    }
+
+    void service(const pollfd &ready) {
+        if(ready.revents == 0) {
+            return;
+        }
+        if(ready.fd == stdoutFd) {
+            readAvailable(stdoutFd,stdoutData);
+        }
+        else if(ready.fd == stderrFd) {
+            readAvailable(stderrFd,stderrData);
+        }
+        else if(ready.fd == stdinFd) {
+            writePending();
+        }
+    }
+
+    /// Polls this child's pipes once. A negative timeout waits until one is ready.
+    void pump(int timeoutMillis) {
+        std::vector<pollfd> fds;
+        addPollFds(fds);
+        if(fds.empty()) {
+            return;
+        }
+        if(poll(fds.data(),fds.size(),timeoutMillis) <= 0) {
+            return;
+        }
+        for(const auto &ready : fds) {
+            service(ready);
+        }
+    }
+
+    /// Collects the exit status. Exit by signal N is reported as 128 + N, as shells do.
+    bool reap(bool block) {
+        if(exited) {
+            return true;
+        }
+        int status = 0;
+        pid_t result = -1;
+        do {
+            result = waitpid(pid,&status,block ? 0 : WNOHANG);
+        } while(result < 0 && errno == EINTR);
+        if(result == 0) {
+            return false;
+        }
+        exited = true;
+        if(result < 0) {
+            exitCode = -1;
+        }
+        else if(WIFEXITED(status)) {
+            exitCode = WEXITSTATUS(status);
+        }
+        else if(WIFSIGNALED(status)) {
+            exitCode = 128 + WTERMSIG(status);
+        }
+        else {
+            exitCode = status;
+        }
+        return true;
+    }
+
+    /// Reads until both output pipes close, then waits for the child to exit.
+    void finish() {
+        while(outputOpen()) {
+            pump(-1);
+        }
+        reap(true);
+    }
+
+private:
+    void readAvailable(int &fd,std::string &out) {
+        std::array<char,kPipeReadBytes> buffer;
+        auto count = read(fd,buffer.data(),buffer.size());
+        if(count > 0) {
+            out.append(buffer.data(),static_cast<size_t>(count));
+        }
+        else if(count == 0 || (errno != EINTR && errno != EAGAIN)) {
+            closeFd(fd);
+        }
+    }
+
+    void writePending() {
+        auto written = writeWithoutSigpipe(stdinFd,input.data() + inputOffset,input.size() - inputOffset);
+        if(written > 0) {
+            inputOffset += static_cast<size_t>(written);
+        }
+        else if(written < 0 && errno != EINTR && errno != EAGAIN) {
+            // The child stopped reading. The unwritten input stays queued so callers can tell.
+            closeFd(stdinFd);
+            return;
+        }
+        if(inputOffset == input.size()) {
+            input.clear();
+            inputOffset = 0;
+            if(closeStdinWhenWritten) {
+                closeFd(stdinFd);
+            }
+        }
+    }
+};
+
+/// Children whose ChildProcess was freed before they exited. They are reaped whenever another child
+/// is spawned, so they do not linger as zombies.
+std::mutex g_orphanMutex;
+std::vector<pid_t> g_orphans;
+
+ChildIO::~ChildIO() {
+    // Closing the pipes first lets a child blocked on them fail and exit.
+    closeFd(stdinFd);
+    closeFd(stdoutFd);
+    closeFd(stderrFd);
+    if(pid > 0 && !reap(false)) {
+        std::lock_guard<std::mutex> lock(g_orphanMutex);
+        g_orphans.push_back(pid);
+    }
+}
+
+void reapOrphans() {
+    std::lock_guard<std::mutex> lock(g_orphanMutex);
+    g_orphans.erase(std::remove_if(g_orphans.begin(),g_orphans.end(),[](pid_t pid) {
+        int status = 0;
+        pid_t result = -1;
+        do {
+            result = waitpid(pid,&status,WNOHANG);
+        } while(result < 0 && errno == EINTR);
+        return result != 0;
+    }),g_orphans.end());
+}
+
+/// Starts `spec.program` with posix_spawnp, searching PATH, and no shell in between.
+bool spawnChild(const SpawnSpec &spec,ChildIO &child,std::string &error) {
+    reapOrphans();
+    auto pipeLock = lockPipeCreation();
+    int inPipe[2] = {-1,-1};
+    int outPipe[2] = {-1,-1};
+    int errPipe[2] = {-1,-1};
+    auto closePipes = [&]() {
+        closeFd(inPipe[0]);
+        closeFd(inPipe[1]);
+        closeFd(outPipe[0]);
+        closeFd(outPipe[1]);
+        closeFd(errPipe[0]);
+        closeFd(errPipe[1]);
+    };
+    if((spec.pipeStdin && !makePipe(inPipe)) || !makePipe(outPipe) || (!spec.mergeStderr && !makePipe(errPipe))) {
+        error = errnoMessage("failed to create pipes for " + spec.program);
+        closePipes();
+        return false;
+    }
+
+    // The pipe ends are close-on-exec; dup2 gives the child inheritable copies on 0, 1 and 2.
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    if(spec.pipeStdin) {
+        posix_spawn_file_actions_adddup2(&actions,inPipe[0],STDIN_FILENO);
+    }
+    posix_spawn_file_actions_adddup2(&actions,outPipe[1],STDOUT_FILENO);
+    posix_spawn_file_actions_adddup2(&actions,spec.mergeStderr ? outPipe[1] : errPipe[1],STDERR_FILENO);
+    posix_spawnattr_t attributes;
+    posix_spawnattr_init(&attributes);
+#if defined(__APPLE__)
+    // Only the descriptors named in `actions` reach the child, whatever other threads have open.
+    posix_spawnattr_setflags(&attributes,POSIX_SPAWN_CLOEXEC_DEFAULT);
+    if(!spec.pipeStdin) {
+        posix_spawn_file_actions_addinherit_np(&actions,STDIN_FILENO);
+    }
 #endif
+
+    std::vector<char *> argv;
+    argv.reserve(spec.args.size() + 2);
+    argv.push_back(const_cast<char *>(spec.program.c_str()));
+    for(const auto &arg : spec.args) {
+        argv.push_back(const_cast<char *>(arg.c_str()));
+    }
+    argv.push_back(nullptr);
+
+    std::vector<char *> envp;
+    char **childEnvironment = environ;
+    if(!spec.environment.empty()) {
+        envp.reserve(spec.environment.size() + 1);
+        for(const auto &entry : spec.environment) {
+            envp.push_back(const_cast<char *>(entry.c_str()));
+        }
+        envp.push_back(nullptr);
+        childEnvironment = envp.data();
+    }
+
+    pid_t pid = -1;
+    int rc = posix_spawnp(&pid,spec.program.c_str(),&actions,&attributes,argv.data(),childEnvironment);
+    posix_spawnattr_destroy(&attributes);
+    posix_spawn_file_actions_destroy(&actions);
+    closeFd(inPipe[0]);
+    closeFd(outPipe[1]);
+    closeFd(errPipe[1]);
+    if(rc != 0) {
+        error = "failed to start " + spec.program + ": " + std::strerror(rc);
+        closePipes();
+        return false;
+    }
+
+    child.pid = pid;
+    child.stdinFd = inPipe[1];
+    child.stdoutFd = outPipe[0];
+    child.stderrFd = errPipe[0];
+    if(child.stdinFd >= 0) {
+        fcntl(child.stdinFd,F_SETFL,fcntl(child.stdinFd,F_GETFL) | O_NONBLOCK);
+#if defined(F_SETNOSIGPIPE)
+        fcntl(child.stdinFd,F_SETNOSIGPIPE,1);
 #endif
+    }
+    return true;
+}
 
+/// Runs to completion with stderr merged into stdout and stdin inherited, like the shell form.
+ProcessRunOutput runCaptured(const SpawnSpec &spec,std::string &error) {
+    ProcessRunOutput out;
+    ChildIO child;
+    if(!spawnChild(spec,child,error)) {
+        return out;
+    }
+    out.started = true;
+    child.finish();
+    out.exitCode = child.exitCode;
+    out.output = std::move(child.stdoutData);
+    out.errorOutput = std::move(child.stderrData);
     return out;
 }
 
-StarbytesObject makeProcessResult(const ProcessRunOutput &result) {
-    auto object = StarbytesObjectNew(StarbytesMakeClass("ProcessResult"));
-    StarbytesObjectAddProperty(object,(char *)"exitCode",makeInt(result.exitCode));
-    StarbytesObjectAddProperty(object,(char *)"output",StarbytesStrNewWithData(result.output.c_str()));
-    StarbytesObjectAddProperty(object,(char *)"success",makeBool(result.exitCode == 0));
-    return object;
+void destroyChild(void *data) {
+    delete static_cast<ChildIO *>(data);
 }
 
+ChildIO *requireChildSelf(StarbytesFuncArgs args) {
+    auto self = StarbytesFuncArgsGetArg(args);
+    auto *child = self ? static_cast<ChildIO *>(StarbytesObjectGetNativeData(self,destroyChild)) : nullptr;
+    if(!child) {
+        setNativeErrorIfEmpty(args,"ChildProcess receiver is invalid");
+    }
+    return child;
+}
+
+StarbytesObject takeBufferedOutput(std::string &buffer,size_t maxBytes) {
+    auto count = std::min(maxBytes,buffer.size());
+    auto chunk = StarbytesBytesNewWithData(buffer.data(),count);
+    buffer.erase(0,count);
+    return chunk;
+}
+
+struct PoolJob {
+    SpawnSpec spec;
+    std::string input;
+    StarbytesTask task = nullptr;
+};
+
+struct PoolCompletion {
+    StarbytesTask task = nullptr;
+    std::string error;
+    ProcessRunOutput result;
+};
+
+/// Hands finished pool jobs to the interpreter thread, which settles their tasks.
+using PoolCompletionQueue = starbytes::Runtime::stdlib::TaskCompletionQueue<PoolCompletion>;
+
+/// Declared before the pool registry so pools still running at exit can hand off completions.
+PoolCompletionQueue g_poolCompletions;
+
+/// Runs queued jobs on one supervisor thread, which keeps up to `maxConcurrent` children running
+/// and services all of their pipes with a single poll.
+class ProcessPoolState {
+public:
+    explicit ProcessPoolState(size_t limit):maxConcurrent(limit) {}
+
+    ~ProcessPoolState() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            closing = true;
+            killRunning = true;
+            queued.clear();
+        }
+        wake();
+        if(worker.joinable()) {
+            worker.join();
+        }
+        closeFd(wakePipe[0]);
+        closeFd(wakePipe[1]);
+    }
+
+    bool start(std::string &error) {
+        auto pipeLock = lockPipeCreation();
+        if(!makePipe(wakePipe)) {
+            error = errnoMessage("pool failed to create its wake pipe");
+            return false;
+        }
+        fcntl(wakePipe[0],F_SETFL,fcntl(wakePipe[0],F_GETFL) | O_NONBLOCK);
+        fcntl(wakePipe[1],F_SETFL,fcntl(wakePipe[1],F_GETFL) | O_NONBLOCK);
+        worker = std::thread([this]() {
+            run();
+        });
+        return true;
+    }
+
+    void submit(PoolJob job) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            queued.push_back(std::move(job));
+        }
+        wake();
+    }
+
+    size_t pending() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return queued.size() + runningCount;
+    }
+
+    /// Stops taking jobs, waits for running children, and returns the jobs that never started.
+    std::vector<PoolJob> close() {
+        std::vector<PoolJob> unstarted;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            closing = true;
+            std::move(queued.begin(),queued.end(),std::back_inserter(unstarted));
+            queued.clear();
+        }
+        wake();
+        if(worker.joinable()) {
+            worker.join();
+        }
+        return unstarted;
+    }
+
+private:
+    struct RunningJob {
+        ChildIO child;
+        StarbytesTask task = nullptr;
+    };
+
+    void wake() {
+        if(wakePipe[1] >= 0) {
+            char signal = 1;
+            (void)!write(wakePipe[1],&signal,1);
+        }
+    }
+
+    void drainWakePipe() {
+        char buffer[64];
+        while(read(wakePipe[0],buffer,sizeof(buffer)) > 0) {
+        }
+    }
+
+    void launch(PoolJob &job,std::vector<std::unique_ptr<RunningJob>> &running) {
+        auto entry = std::make_unique<RunningJob>();
+        entry->task = job.task;
+        std::string error;
+        if(!spawnChild(job.spec,entry->child,error)) {
+            PoolCompletion completion;
+            completion.task = job.task;
+            completion.error = error;
+            g_poolCompletions.complete(std::move(completion));
+            return;
+        }
+        entry->child.input = std::move(job.input);
+        entry->child.closeStdinWhenWritten = true;
+        if(entry->child.input.empty()) {
+            closeFd(entry->child.stdinFd);
+        }
+        running.push_back(std::move(entry));
+    }
+
+    void run() {
+        std::vector<std::unique_ptr<RunningJob>> running;
+        std::vector<PoolJob> startable;
+        std::vector<pollfd> fds;
+        for(;;) {
+            bool killAll = false;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                while(running.size() + startable.size() < maxConcurrent && !queued.empty() && !killRunning) {
+                    startable.push_back(std::move(queued.front()));
+                    queued.pop_front();
+                }
+                killAll = killRunning;
+                if(closing && running.empty() && startable.empty() && queued.empty()) {
+                    runningCount = 0;
+                    return;
+                }
+            }
+            if(killAll) {
+                for(auto &entry : running) {
+                    if(!entry->child.exited) {
+                        kill(entry->child.pid,SIGKILL);
+                    }
+                }
+            }
+            for(auto &job : startable) {
+                launch(job,running);
+            }
+            startable.clear();
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                runningCount = running.size();
+            }
+
+            fds.clear();
+            fds.push_back(pollfd{wakePipe[0],POLLIN,0});
+            bool awaitingExit = false;
+            for(auto &entry : running) {
+                entry->child.addPollFds(fds);
+                awaitingExit = awaitingExit || !entry->child.outputOpen();
+            }
+            if(poll(fds.data(),fds.size(),awaitingExit ? kReapPollMillis : -1) > 0) {
+                if(fds[0].revents != 0) {
+                    drainWakePipe();
+                }
+                for(size_t i = 1; i < fds.size(); ++i) {
+                    if(fds[i].revents == 0) {
+                        continue;
+                    }
+                    for(auto &entry : running) {
+                        entry->child.service(fds[i]);
+                    }
+                }
+            }
+
+            for(auto it = running.begin(); it != running.end();) {
+                auto &child = (*it)->child;
+                if(child.outputOpen() || !child.reap(false)) {
+                    ++it;
+                    continue;
+                }
+                PoolCompletion completion;
+                completion.task = (*it)->task;
+                completion.result.started = true;
+                completion.result.exitCode = child.exitCode;
+                completion.result.output = std::move(child.stdoutData);
+                completion.result.errorOutput = std::move(child.stderrData);
+                g_poolCompletions.complete(std::move(completion));
+                it = running.erase(it);
+            }
+        }
+    }
+
+    size_t maxConcurrent;
+    std::mutex mutex;
+    std::deque<PoolJob> queued;
+    size_t runningCount = 0;
+    bool closing = false;
+    bool killRunning = false;
+    int wakePipe[2] = {-1,-1};
+    std::thread worker;
+};
+
+std::unordered_map<StarbytesObject,std::unique_ptr<ProcessPoolState>> g_poolRegistry;
+
+ProcessPoolState *requirePoolSelf(StarbytesFuncArgs args) {
+    auto self = StarbytesFuncArgsGetArg(args);
+    auto it = g_poolRegistry.find(self);
+    if(it == g_poolRegistry.end()) {
+        setNativeErrorIfEmpty(args,"ProcessPool receiver is invalid");
+        return nullptr;
+    }
+    return it->second.get();
+}
+
+void settlePoolCompletion(PoolCompletion &completion) {
+    if(completion.result.started) {
+        auto result = makeProcessResult(completion.result);
+        StarbytesTaskResolve(completion.task,result);
+        StarbytesObjectRelease(result);
+    }
+    else {
+        StarbytesTaskReject(completion.task,completion.error.c_str());
+    }
+    StarbytesObjectRelease(completion.task);
+}
+
+int process_drivePools() {
+    return g_poolCompletions.drive(settlePoolCompletion);
+}
+#endif
+
 STARBYTES_FUNC(process_run) {
     skipOptionalModuleReceiver(args,1);
 
@@ -175,10 +829,22 @@ STARBYTES_FUNC(process_run) {
         return failNativeIfEmpty(args,"run requires a non-empty command string");
     }
 
+#if defined(_WIN32)
     auto result = runCommandCapture(command);
     if(!result.started) {
         return failNativeIfEmpty(args,errnoMessage("run failed to start process"));
     }
+#else
+    SpawnSpec spec;
+    spec.program = "/bin/sh";
+    spec.args = {"-c",command};
+    spec.mergeStderr = true;
+    std::string error;
+    auto result = runCaptured(spec,error);
+    if(!result.started) {
+        return failNativeIfEmpty(args,"run " + error);
+    }
+#endif
     return makeProcessResult(result);
 }
 
@@ -191,11 +857,23 @@ STARBYTES_FUNC(process_runArgs) {
         return failNativeIfEmpty(args,"runArgs requires a non-empty program string and Array<String> args");
     }
 
+#if defined(_WIN32)
     auto command = buildCommandFromArgs(program,argv);
     auto result = runCommandCapture(command);
     if(!result.started) {
         return failNativeIfEmpty(args,errnoMessage("runArgs failed to start process"));
     }
+#else
+    SpawnSpec spec;
+    spec.program = std::move(program);
+    spec.args = std::move(argv);
+    spec.mergeStderr = true;
+    std::string error;
+    auto result = runCaptured(spec,error);
+    if(!result.started) {
+        return failNativeIfEmpty(args,"runArgs " + error);
+    }
+#endif
     return makeProcessResult(result);
 }
 
@@ -210,6 +888,230 @@ STARBYTES_FUNC(process_shellQuote) {
     return StarbytesStrNewWithData(quoted.c_str());
 }
 
+STARBYTES_FUNC(process_spawn) {
+    skipOptionalModuleReceiver(args,3);
+
+    std::string program;
+    std::vector<std::string> argv;
+    EnvironmentOverrides overrides;
+    if(!readStringArg(args,program) || !readStringArrayArg(args,argv) || !readEnvironmentArg(args,overrides)) {
+        return nullptr;
+    }
+    if(program.empty()) {
+        return failNativeIfEmpty(args,"spawn requires a non-empty program string");
+    }
+
+#if defined(_WIN32)
+    return failNativeIfEmpty(args,"spawn is not supported on this platform");
+#else
+    SpawnSpec spec;
+    spec.program = std::move(program);
+    spec.args = std::move(argv);
+    if(!overrides.empty()) {
+        spec.environment = buildEnvironment(overrides);
+    }
+    spec.pipeStdin = true;
+
+    auto child = std::make_unique<ChildIO>();
+    std::string error;
+    if(!spawnChild(spec,*child,error)) {
+        return failNativeIfEmpty(args,"spawn " + error);
+    }
+    // The object owns the child: freeing it closes the pipes and reaps the process.
+    auto object = StarbytesObjectNew(StarbytesMakeClass("ChildProcess"));
+    StarbytesObjectSetNativeData(object,child.release(),destroyChild);
+    return object;
+#endif
+}
+
+STARBYTES_FUNC(process_pool) {
+    skipOptionalModuleReceiver(args,1);
+
+    int maxConcurrent = 0;
+    if(!readIntArg(args,maxConcurrent)) {
+        return nullptr;
+    }
+    if(maxConcurrent < 0 || maxConcurrent > kMaxPoolSize) {
+        return failNativeIfEmpty(args,"pool requires maxConcurrent between 0 and " + std::to_string(kMaxPoolSize));
+    }
+    if(maxConcurrent == 0) {
+        maxConcurrent = static_cast<int>(std::max(1u,std::thread::hardware_concurrency()));
+    }
+
+#if defined(_WIN32)
+    return failNativeIfEmpty(args,"pool is not supported on this platform");
+#else
+    auto pool = std::make_unique<ProcessPoolState>(static_cast<size_t>(maxConcurrent));
+    std::string error;
+    if(!pool->start(error)) {
+        return failNativeIfEmpty(args,error);
+    }
+    auto object = StarbytesObjectNew(StarbytesMakeClass("ProcessPool"));
+    g_poolRegistry[object] = std::move(pool);
+    return object;
+#endif
+}
+
+#if !defined(_WIN32)
+STARBYTES_FUNC(process_childPid) {
+    auto *child = requireChildSelf(args);
+    if(!child) {
+        return makeInt(-1);
+    }
+    return makeInt(static_cast<int>(child->pid));
+}
+
+STARBYTES_FUNC(process_childWrite) {
+    auto *child = requireChildSelf(args);
+    if(!child) {
+        return nullptr;
+    }
+    ByteView data;
+    if(!readByteView(StarbytesFuncArgsGetArg(args),data)) {
+        return failNativeIfEmpty(args,"expected Bytes argument");
+    }
+    if(child->stdinFd < 0) {
+        return failNativeIfEmpty(args,"write failed: stdin is closed");
+    }
+
+    // Output keeps being read while the input drains, so a child that answers as it reads
+    // cannot deadlock against this call.
+    child->input.assign(reinterpret_cast<const char *>(data.data),data.length);
+    child->inputOffset = 0;
+    while(child->wantsInput()) {
+        child->pump(-1);
+    }
+    if(!child->input.empty()) {
+        child->input.clear();
+        child->inputOffset = 0;
+        return failNativeIfEmpty(args,"write failed: the process closed its stdin");
+    }
+    return makeInt(static_cast<int>(data.length));
+}
+
+STARBYTES_FUNC(process_childCloseStdin) {
+    auto *child = requireChildSelf(args);
+    if(!child) {
+        return makeBool(false);
+    }
+    bool wasOpen = child->stdinFd >= 0;
+    closeFd(child->stdinFd);
+    return makeBool(wasOpen);
+}
+
+StarbytesObject readChildStream(StarbytesFuncArgs args,bool fromStderr) {
+    auto *child = requireChildSelf(args);
+    if(!child) {
+        return nullptr;
+    }
+    int maxBytes = 0;
+    if(!readIntArg(args,maxBytes) || maxBytes <= 0) {
+        return failNativeIfEmpty(args,"read requires a positive maxBytes");
+    }
+    auto &buffer = fromStderr ? child->stderrData : child->stdoutData;
+    const int &fd = fromStderr ? child->stderrFd : child->stdoutFd;
+    while(buffer.empty() && fd >= 0) {
+        child->pump(-1);
+    }
+    return takeBufferedOutput(buffer,static_cast<size_t>(maxBytes));
+}
+
+STARBYTES_FUNC(process_childReadStdout) {
+    return readChildStream(args,false);
+}
+
+STARBYTES_FUNC(process_childReadStderr) {
+    return readChildStream(args,true);
+}
+
+STARBYTES_FUNC(process_childWait) {
+    auto *child = requireChildSelf(args);
+    if(!child) {
+        return nullptr;
+    }
+    closeFd(child->stdinFd);
+    child->finish();
+
+    ProcessRunOutput result;
+    result.started = true;
+    result.exitCode = child->exitCode;
+    result.output = std::move(child->stdoutData);
+    result.errorOutput = std::move(child->stderrData);
+    child->stdoutData.clear();
+    child->stderrData.clear();
+    return makeProcessResult(result);
+}
+
+STARBYTES_FUNC(process_childKill) {
+    auto *child = requireChildSelf(args);
+    if(!child) {
+        return nullptr;
+    }
+    int signalNumber = 0;
+    if(!readIntArg(args,signalNumber)) {
+        return nullptr;
+    }
+    if(child->exited) {
+        return makeBool(false);
+    }
+    if(kill(child->pid,signalNumber) != 0) {
+        return failNativeIfEmpty(args,errnoMessage("kill failed"));
+    }
+    return makeBool(true);
+}
+
+STARBYTES_FUNC(process_poolSubmit) {
+    auto *pool = requirePoolSelf(args);
+    if(!pool) {
+        return nullptr;
+    }
+
+    auto task = StarbytesTaskNew();
+    PoolJob job;
+    EnvironmentOverrides overrides;
+    ByteView input;
+    if(!readStringArg(args,job.spec.program) || !readStringArrayArg(args,job.spec.args) || !readEnvironmentArg(args,overrides)
+       || !readByteView(StarbytesFuncArgsGetArg(args),input) || job.spec.program.empty()) {
+        StarbytesTaskReject(task,"submit requires (program:String,args:Array<String>,env:Dict,input:Bytes) with a non-empty program");
+        return task;
+    }
+    // The environment is copied here because the supervisor thread must not read environ while
+    // the interpreter may be changing it.
+    job.spec.environment = buildEnvironment(overrides);
+    job.spec.pipeStdin = true;
+    job.input.assign(reinterpret_cast<const char *>(input.data),input.length);
+
+    StarbytesObjectReference(task);
+    job.task = task;
+    g_poolCompletions.beginJob();
+    pool->submit(std::move(job));
+    return task;
+}
+
+STARBYTES_FUNC(process_poolPending) {
+    auto *pool = requirePoolSelf(args);
+    if(!pool) {
+        return makeInt(0);
+    }
+    return makeInt(static_cast<int>(pool->pending()));
+}
+
+STARBYTES_FUNC(process_poolClose) {
+    auto self = StarbytesFuncArgsGetArg(args);
+    auto it = g_poolRegistry.find(self);
+    if(it == g_poolRegistry.end()) {
+        return makeBool(false);
+    }
+    for(auto &job : it->second->close()) {
+        StarbytesTaskReject(job.task,"ProcessPool was closed");
+        StarbytesObjectRelease(job.task);
+        g_poolCompletions.abandonJob();
+    }
+    g_poolRegistry.erase(it);
+    return makeBool(true);
+}
+#endif
+
 void addFunc(StarbytesNativeModule *module,const char *name,unsigned argCount,StarbytesFuncCallback callback) {
     StarbytesFuncDesc desc;
     desc.name = CStringMake(name);
@@ -226,6 +1128,23 @@ STARBYTES_NATIVE_MOD_MAIN() {
     addFunc(module,"process_run",1,process_run);
     addFunc(module,"process_runArgs",2,process_runArgs);
     addFunc(module,"process_shellQuote",1,process_shellQuote);
+    addFunc(module,"process_spawn",3,process_spawn);
+    addFunc(module,"process_pool",1,process_pool);
+
+#if !defined(_WIN32)
+    addFunc(module,"Process_ChildProcess_pid",1,process_childPid);
+    addFunc(module,"Process_ChildProcess_write",2,process_childWrite);
+    addFunc(module,"Process_ChildProcess_closeStdin",1,process_childCloseStdin);
+    addFunc(module,"Process_ChildProcess_readStdout",2,process_childReadStdout);
+    addFunc(module,"Process_ChildProcess_readStderr",2,process_childReadStderr);
+    addFunc(module,"Process_ChildProcess_wait",1,process_childWait);
+    addFunc(module,"Process_ChildProcess_kill",2,process_childKill);
+    addFunc(module,"Process_ProcessPool_submit",5,process_poolSubmit);
+    addFunc(module,"Process_ProcessPool_pending",1,process_poolPending);
+    addFunc(module,"Process_ProcessPool_close",1,process_poolClose);
+
+    StarbytesRuntimeAddTaskDriver(process_drivePools);
+#endif
 
     return module;
 }
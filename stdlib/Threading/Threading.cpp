@@ -1,19 +1,34 @@
 #include <starbytes/interop.h>
 #include "starbytes/runtime/NativeModuleSupport.h"
+#include "starbytes/base/Digest.h"
 
+#include <algorithm>
 #include <chrono>
+#include <cmath>
 #include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
 #include <functional>
 #include <memory>
 #include <mutex>
 #include <string>
+#include <system_error>
 #include <thread>
-#include <unordered_map>
+#include <type_traits>
+#include <vector>
+
+#ifdef STARBYTES_HAS_ZLIB
+#include <zlib.h>
+#endif
 
 namespace {
 
+using starbytes::Runtime::stdlib::ByteView;
 using starbytes::Runtime::stdlib::failNativeIfEmpty;
+using starbytes::Runtime::stdlib::readByteView;
 using starbytes::Runtime::stdlib::setNativeErrorIfEmpty;
+using starbytes::Runtime::stdlib::systemErrorMessage;
 
 struct NativeArgsLayout {
     unsigned argc = 0;
@@ -21,10 +36,25 @@ struct NativeArgsLayout {
     StarbytesObject *argv = nullptr;
 };
 
+constexpr int kMaxPoolThreads = 256;
+/// parallelMap gives each thread at least this many elements; below it thread start-up costs
+/// more than the kernel saves.
+constexpr size_t kMinParallelChunk = 16 * 1024;
+constexpr size_t kChunkSize = 64 * 1024;
+constexpr size_t kMaxInflatedBytes = (size_t)2 * 1024 * 1024 * 1024;
+constexpr char kHexDigits[] = "0123456789abcdef";
+
 struct MutexState {
     std::mutex native;
     bool locked = false;
     std::thread::id owner;
+
+    ~MutexState() {
+        // A Mutex dropped while held must not destroy a locked std::mutex.
+        if(locked) {
+            native.unlock();
+        }
+    }
 };
 
 struct ConditionState {
@@ -45,10 +75,41 @@ struct EventState {
     bool manualReset = true;
 };
 
-std::unordered_map<StarbytesObject,std::unique_ptr<MutexState>> g_mutexRegistry;
-std::unordered_map<StarbytesObject,std::unique_ptr<ConditionState>> g_conditionRegistry;
-std::unordered_map<StarbytesObject,std::unique_ptr<SemaphoreState>> g_semaphoreRegistry;
-std::unordered_map<StarbytesObject,std::unique_ptr<EventState>> g_eventRegistry;
+template<typename State>
+void destroyState(void *data) {
+    delete static_cast<State *>(data);
+}
+
+/// Creates an object of a native class that owns `state`; the runtime frees it with the object.
+template<typename State>
+StarbytesObject makeStateObject(const char *className,std::unique_ptr<State> state) {
+    auto object = StarbytesObjectNew(StarbytesMakeClass(className));
+    StarbytesObjectSetNativeData(object,state.release(),destroyState<State>);
+    return object;
+}
+
+/// Returns the state of `object`, or nullptr when it is not an object of the State's class.
+template<typename State>
+State *findState(StarbytesObject object) {
+    if(!object) {
+        return nullptr;
+    }
+    return static_cast<State *>(StarbytesObjectGetNativeData(object,destroyState<State>));
+}
+
+template<typename State>
+State *requireSelf(StarbytesFuncArgs args,const char *className) {
+    auto self = StarbytesFuncArgsGetArg(args);
+    if(!self) {
+        setNativeErrorIfEmpty(args,std::string(className) + " receiver is missing");
+        return nullptr;
+    }
+    auto *state = findState<State>(self);
+    if(!state) {
+        setNativeErrorIfEmpty(args,std::string(className) + " receiver is invalid");
+    }
+    return state;
+}
 
 StarbytesObject makeBool(bool value) {
     // Runtime bool consumption currently interprets StarbytesBoolFalse as logical true.
@@ -73,6 +134,16 @@ bool readIntArg(StarbytesFuncArgs args,int &outValue) {
     return true;
 }
 
+bool readStringArg(StarbytesFuncArgs args,std::string &outValue) {
+    auto arg = StarbytesFuncArgsGetArg(args);
+    if(!arg || !StarbytesObjectTypecheck(arg,StarbytesStrType())) {
+        setNativeErrorIfEmpty(args,"expected String argument");
+        return false;
+    }
+    outValue = StarbytesStrGetBuffer(arg);
+    return true;
+}
+
 bool readBoolArg(StarbytesFuncArgs args,bool &outValue) {
     auto arg = StarbytesFuncArgsGetArg(args);
     if(!arg || !StarbytesObjectTypecheck(arg,StarbytesBoolType())) {
@@ -94,72 +165,688 @@ void skipOptionalModuleReceiver(StarbytesFuncArgs args,unsigned expectedUserArgs
     }
 }
 
-MutexState *requireMutexSelf(StarbytesFuncArgs args) {
-    auto self = StarbytesFuncArgsGetArg(args);
-    if(!self) {
-        setNativeErrorIfEmpty(args,"Mutex receiver is missing");
-        return nullptr;
+size_t hardwareThreads() {
+    return std::max(1u,std::thread::hardware_concurrency());
+}
+
+size_t numElementSize(StarbytesNumT type) {
+    switch(type) {
+        case NumTypeLong:
+            return sizeof(int64_t);
+        case NumTypeFloat:
+            return sizeof(float);
+        case NumTypeDouble:
+            return sizeof(double);
+        case NumTypeInt:
+        default:
+            return sizeof(int);
     }
-    auto it = g_mutexRegistry.find(self);
-    if(it == g_mutexRegistry.end()) {
-        setNativeErrorIfEmpty(args,"Mutex receiver is invalid");
-        return nullptr;
+}
+
+bool isRealType(StarbytesNumT type) {
+    return type == NumTypeFloat || type == NumTypeDouble;
+}
+
+/// Elements of a numeric Array in packed form. `elements` points into the Array itself when it
+/// is read in place, or into `storage` when it was copied for a worker thread.
+struct NumericArray {
+    StarbytesNumT type = NumTypeInt;
+    size_t count = 0;
+    const void *elements = nullptr;
+    std::vector<unsigned char> storage;
+};
+
+/// Reads an Array of numbers. Packed arrays are read in place unless `copy` is set; boxed arrays
+/// that happen to hold only numbers are always copied, widened to Double.
+bool readNumericArray(StarbytesObject arg,bool copy,NumericArray &out) {
+    if(!arg || !StarbytesObjectTypecheck(arg,StarbytesArrayType())) {
+        return false;
+    }
+    out.count = StarbytesArrayGetLength(arg);
+    out.storage.clear();
+    out.elements = nullptr;
+    if(out.count == 0) {
+        out.type = NumTypeInt;
+        return true;
     }
-    return it->second.get();
+
+    StarbytesNumT packedType = NumTypeInt;
+    if(auto *packed = StarbytesArrayGetNumericData(arg,&packedType)) {
+        out.type = packedType;
+        if(!copy) {
+            out.elements = packed;
+            return true;
+        }
+        auto *begin = static_cast<const unsigned char *>(packed);
+        out.storage.assign(begin,begin + out.count * numElementSize(packedType));
+        out.elements = out.storage.data();
+        return true;
+    }
+
+    out.type = NumTypeDouble;
+    out.storage.resize(out.count * sizeof(double));
+    auto *widened = reinterpret_cast<double *>(out.storage.data());
+    for(size_t i = 0; i < out.count; ++i) {
+        long double value = 0;
+        if(!StarbytesArrayTryGetNumeric(arg,(unsigned)i,NumTypeDouble,&value)) {
+            return false;
+        }
+        widened[i] = (double)value;
+    }
+    out.elements = out.storage.data();
+    return true;
 }
 
-ConditionState *requireConditionSelf(StarbytesFuncArgs args) {
-    auto self = StarbytesFuncArgsGetArg(args);
-    if(!self) {
-        setNativeErrorIfEmpty(args,"Condition receiver is missing");
-        return nullptr;
+enum class MapOp {
+    Add,
+    Sub,
+    Mul,
+    Div,
+    Min,
+    Max,
+    Pow,
+    Abs,
+    Neg,
+    Sqrt,
+    Square
+};
+
+bool mapOpFromName(const std::string &name,MapOp &outOp) {
+    static const std::pair<const char *,MapOp> kOps[] = {
+        {"add",MapOp::Add},{"sub",MapOp::Sub},{"mul",MapOp::Mul},{"div",MapOp::Div},
+        {"min",MapOp::Min},{"max",MapOp::Max},{"pow",MapOp::Pow},{"abs",MapOp::Abs},
+        {"neg",MapOp::Neg},{"sqrt",MapOp::Sqrt},{"square",MapOp::Square}
+    };
+    for(auto &entry : kOps) {
+        if(name == entry.first) {
+            outOp = entry.second;
+            return true;
+        }
     }
-    auto it = g_conditionRegistry.find(self);
-    if(it == g_conditionRegistry.end()) {
-        setNativeErrorIfEmpty(args,"Condition receiver is invalid");
-        return nullptr;
+    return false;
+}
+
+bool mapOpIsUnary(MapOp op) {
+    return op == MapOp::Abs || op == MapOp::Neg || op == MapOp::Sqrt || op == MapOp::Square;
+}
+
+/// One element-wise operation over a packed array. Float and Double arrays keep their type.
+/// Int and Long arrays stay integral, wrapping on overflow, unless the operation is div, pow or
+/// sqrt or the operand is real, in which case the result is Double.
+struct MapKernel {
+    MapOp op = MapOp::Add;
+    StarbytesNumT inputType = NumTypeInt;
+    StarbytesNumT outputType = NumTypeInt;
+    double realOperand = 0;
+    int64_t integerOperand = 0;
+};
+
+bool readMapKernel(StarbytesObject opArg,StarbytesObject operandArg,StarbytesNumT inputType,MapKernel &out,std::string &error) {
+    if(!opArg || !StarbytesObjectTypecheck(opArg,StarbytesStrType()) || !mapOpFromName(StarbytesStrGetBuffer(opArg),out.op)) {
+        error = "op must be one of add, sub, mul, div, min, max, pow, abs, neg, sqrt or square";
+        return false;
+    }
+    if(!operandArg || !StarbytesObjectTypecheck(operandArg,StarbytesNumType())) {
+        error = "operand must be a number";
+        return false;
+    }
+
+    auto operandType = StarbytesNumGetType(operandArg);
+    switch(operandType) {
+        case NumTypeInt:
+            out.integerOperand = StarbytesNumGetIntValue(operandArg);
+            out.realOperand = (double)out.integerOperand;
+            break;
+        case NumTypeLong:
+            out.integerOperand = StarbytesNumGetLongValue(operandArg);
+            out.realOperand = (double)out.integerOperand;
+            break;
+        case NumTypeFloat:
+            out.realOperand = StarbytesNumGetFloatValue(operandArg);
+            break;
+        case NumTypeDouble:
+        default:
+            out.realOperand = StarbytesNumGetDoubleValue(operandArg);
+            break;
+    }
+
+    out.inputType = inputType;
+    if(isRealType(inputType)) {
+        out.outputType = inputType;
+    }
+    else if(out.op == MapOp::Div || out.op == MapOp::Pow || out.op == MapOp::Sqrt
+            || (!mapOpIsUnary(out.op) && isRealType(operandType))) {
+        out.outputType = NumTypeDouble;
+    }
+    else if(inputType == NumTypeLong || (!mapOpIsUnary(out.op) && operandType == NumTypeLong)) {
+        out.outputType = NumTypeLong;
+    }
+    else {
+        out.outputType = NumTypeInt;
     }
-    return it->second.get();
+    return true;
 }
 
-SemaphoreState *requireSemaphoreSelf(StarbytesFuncArgs args) {
-    auto self = StarbytesFuncArgsGetArg(args);
-    if(!self) {
-        setNativeErrorIfEmpty(args,"Semaphore receiver is missing");
-        return nullptr;
+template<typename In,typename Out,typename Fn>
+void mapLoop(const In *in,Out *out,size_t begin,size_t end,Fn fn) {
+    for(size_t i = begin; i < end; ++i) {
+        out[i] = fn(in[i]);
     }
-    auto it = g_semaphoreRegistry.find(self);
-    if(it == g_semaphoreRegistry.end()) {
-        setNativeErrorIfEmpty(args,"Semaphore receiver is invalid");
-        return nullptr;
+}
+
+template<typename In,typename Out>
+void mapRange(const MapKernel &kernel,const In *in,Out *out,size_t begin,size_t end) {
+    if constexpr(std::is_integral_v<Out>) {
+        // Unsigned arithmetic gives two's-complement wrap-around without signed overflow.
+        using Wide = uint64_t;
+        const Wide c = static_cast<Wide>(kernel.integerOperand);
+        switch(kernel.op) {
+            case MapOp::Add:
+                mapLoop(in,out,begin,end,[c](In v) { return static_cast<Out>(static_cast<Wide>(v) + c); });
+                return;
+            case MapOp::Sub:
+                mapLoop(in,out,begin,end,[c](In v) { return static_cast<Out>(static_cast<Wide>(v) - c); });
+                return;
+            case MapOp::Mul:
+                mapLoop(in,out,begin,end,[c](In v) { return static_cast<Out>(static_cast<Wide>(v) * c); });
+                return;
+            case MapOp::Min: {
+                auto operand = kernel.integerOperand;
+                mapLoop(in,out,begin,end,[operand](In v) { return static_cast<Out>(std::min<int64_t>(v,operand)); });
+                return;
+            }
+            case MapOp::Max: {
+                auto operand = kernel.integerOperand;
+                mapLoop(in,out,begin,end,[operand](In v) { return static_cast<Out>(std::max<int64_t>(v,operand)); });
+                return;
+            }
+            case MapOp::Abs:
+                mapLoop(in,out,begin,end,[](In v) {
+                    auto wide = static_cast<Wide>(v);
+                    return static_cast<Out>(v < 0 ? Wide(0) - wide : wide);
+                });
+                return;
+            case MapOp::Neg:
+                mapLoop(in,out,begin,end,[](In v) { return static_cast<Out>(Wide(0) - static_cast<Wide>(v)); });
+                return;
+            case MapOp::Square:
+                mapLoop(in,out,begin,end,[](In v) { return static_cast<Out>(static_cast<Wide>(v) * static_cast<Wide>(v)); });
+                return;
+            default:
+                return;
+        }
+    }
+    else {
+        const double c = kernel.realOperand;
+        switch(kernel.op) {
+            case MapOp::Add:
+                mapLoop(in,out,begin,end,[c](In v) { return static_cast<Out>(v + c); });
+                return;
+            case MapOp::Sub:
+                mapLoop(in,out,begin,end,[c](In v) { return static_cast<Out>(v - c); });
+                return;
+            case MapOp::Mul:
+                mapLoop(in,out,begin,end,[c](In v) { return static_cast<Out>(v * c); });
+                return;
+            case MapOp::Div:
+                mapLoop(in,out,begin,end,[c](In v) { return static_cast<Out>(v / c); });
+                return;
+            case MapOp::Min:
+                mapLoop(in,out,begin,end,[c](In v) { return static_cast<Out>(std::min<double>(v,c)); });
+                return;
+            case MapOp::Max:
+                mapLoop(in,out,begin,end,[c](In v) { return static_cast<Out>(std::max<double>(v,c)); });
+                return;
+            case MapOp::Pow:
+                mapLoop(in,out,begin,end,[c](In v) { return static_cast<Out>(std::pow((double)v,c)); });
+                return;
+            case MapOp::Abs:
+                mapLoop(in,out,begin,end,[](In v) { return static_cast<Out>(std::fabs((double)v)); });
+                return;
+            case MapOp::Neg:
+                mapLoop(in,out,begin,end,[](In v) { return static_cast<Out>(-(double)v); });
+                return;
+            case MapOp::Sqrt:
+                mapLoop(in,out,begin,end,[](In v) { return static_cast<Out>(std::sqrt((double)v)); });
+                return;
+            case MapOp::Square:
+                mapLoop(in,out,begin,end,[](In v) { return static_cast<Out>((double)v * (double)v); });
+                return;
+        }
     }
-    return it->second.get();
 }
 
-EventState *requireEventSelf(StarbytesFuncArgs args) {
-    auto self = StarbytesFuncArgsGetArg(args);
-    if(!self) {
-        setNativeErrorIfEmpty(args,"Event receiver is missing");
-        return nullptr;
+template<typename In>
+void mapRangeFrom(const MapKernel &kernel,const In *in,void *out,size_t begin,size_t end) {
+    switch(kernel.outputType) {
+        case NumTypeLong:
+            mapRange(kernel,in,static_cast<int64_t *>(out),begin,end);
+            break;
+        case NumTypeFloat:
+            mapRange(kernel,in,static_cast<float *>(out),begin,end);
+            break;
+        case NumTypeDouble:
+            mapRange(kernel,in,static_cast<double *>(out),begin,end);
+            break;
+        case NumTypeInt:
+        default:
+            mapRange(kernel,in,static_cast<int *>(out),begin,end);
+            break;
     }
-    auto it = g_eventRegistry.find(self);
-    if(it == g_eventRegistry.end()) {
-        setNativeErrorIfEmpty(args,"Event receiver is invalid");
-        return nullptr;
+}
+
+/// Applies `kernel` to elements [begin,end). Touches only the two packed buffers, so it is safe
+/// to run on any thread.
+void runMapKernel(const MapKernel &kernel,const void *in,void *out,size_t begin,size_t end) {
+    switch(kernel.inputType) {
+        case NumTypeLong:
+            mapRangeFrom(kernel,static_cast<const int64_t *>(in),out,begin,end);
+            break;
+        case NumTypeFloat:
+            mapRangeFrom(kernel,static_cast<const float *>(in),out,begin,end);
+            break;
+        case NumTypeDouble:
+            mapRangeFrom(kernel,static_cast<const double *>(in),out,begin,end);
+            break;
+        case NumTypeInt:
+        default:
+            mapRangeFrom(kernel,static_cast<const int *>(in),out,begin,end);
+            break;
     }
-    return it->second.get();
 }
 
-MutexState *findMutexByObject(StarbytesObject object) {
-    auto it = g_mutexRegistry.find(object);
-    if(it == g_mutexRegistry.end()) {
-        return nullptr;
+template<typename In>
+double sumRange(const In *in,size_t count) {
+    // Four accumulators keep the adds independent so the loop is not bound by add latency.
+    double lanes[4] = {0,0,0,0};
+    size_t i = 0;
+    for(; i + 4 <= count; i += 4) {
+        lanes[0] += (double)in[i];
+        lanes[1] += (double)in[i + 1];
+        lanes[2] += (double)in[i + 2];
+        lanes[3] += (double)in[i + 3];
+    }
+    for(; i < count; ++i) {
+        lanes[0] += (double)in[i];
     }
-    return it->second.get();
+    return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+}
+
+double sumNumericArray(const NumericArray &values) {
+    switch(values.type) {
+        case NumTypeLong:
+            return sumRange(static_cast<const int64_t *>(values.elements),values.count);
+        case NumTypeFloat:
+            return sumRange(static_cast<const float *>(values.elements),values.count);
+        case NumTypeDouble:
+            return sumRange(static_cast<const double *>(values.elements),values.count);
+        case NumTypeInt:
+        default:
+            return sumRange(static_cast<const int *>(values.elements),values.count);
+    }
+}
+
+/// Splits [0,count) into one contiguous range per hardware thread and runs `body` on each. The
+/// calling thread takes the first range; inputs too small to split run inline.
+void parallelFor(size_t count,const std::function<void(size_t,size_t)> &body) {
+    size_t threads = std::min(hardwareThreads(),std::max<size_t>(1,count / kMinParallelChunk));
+    if(threads <= 1) {
+        body(0,count);
+        return;
+    }
+
+    size_t chunk = (count + threads - 1) / threads;
+    std::vector<std::thread> helpers;
+    helpers.reserve(threads - 1);
+    size_t begin = chunk;
+    for(; begin < count; begin += chunk) {
+        try {
+            helpers.emplace_back(body,begin,std::min(count,begin + chunk));
+        }
+        catch(const std::system_error &) {
+            break;
+        }
+    }
+    body(0,std::min(count,chunk));
+    // Ranges left over when the system would not start another thread run here.
+    for(; begin < count; begin += chunk) {
+        body(begin,std::min(count,begin + chunk));
+    }
+    for(auto &helper : helpers) {
+        helper.join();
+    }
+}
+
+std::string toHex(const unsigned char *data,size_t length) {
+    std::string hex;
+    hex.resize(length * 2);
+    for(size_t i = 0; i < length; ++i) {
+        hex[i * 2] = kHexDigits[data[i] >> 4];
+        hex[i * 2 + 1] = kHexDigits[data[i] & 0x0f];
+    }
+    return hex;
+}
+
+bool readWholeFile(const std::string &path,std::vector<unsigned char> &out,std::string &error) {
+    std::FILE *file = std::fopen(path.c_str(),"rb");
+    if(!file) {
+        error = systemErrorMessage("failed to open " + path,std::error_code(errno,std::generic_category()));
+        return false;
+    }
+    out.clear();
+    if(std::fseek(file,0,SEEK_END) == 0) {
+        long size = std::ftell(file);
+        if(size > 0) {
+            out.reserve((size_t)size);
+        }
+        std::rewind(file);
+    }
+    unsigned char chunk[kChunkSize];
+    size_t count = 0;
+    while((count = std::fread(chunk,1,sizeof(chunk),file)) > 0) {
+        out.insert(out.end(),chunk,chunk + count);
+    }
+    bool failed = std::ferror(file) != 0;
+    if(failed) {
+        error = systemErrorMessage("failed to read " + path,std::error_code(errno,std::generic_category()));
+    }
+    std::fclose(file);
+    return !failed;
+}
+
+#ifdef STARBYTES_HAS_ZLIB
+/// zlib-format deflate, matching Compression.deflate.
+bool deflateBuffer(const unsigned char *input,size_t length,int level,std::vector<unsigned char> &out) {
+    if(length > (size_t)UINT32_MAX) {
+        return false;
+    }
+    z_stream stream = {};
+    if(deflateInit(&stream,level) != Z_OK) {
+        return false;
+    }
+    out.resize((size_t)deflateBound(&stream,(uLong)length));
+    stream.next_in = const_cast<Bytef *>(input);
+    stream.avail_in = (uInt)length;
+    stream.next_out = out.data();
+    stream.avail_out = (uInt)out.size();
+    int ret = deflate(&stream,Z_FINISH);
+    out.resize(stream.total_out);
+    deflateEnd(&stream);
+    return ret == Z_STREAM_END;
+}
+
+/// zlib-format inflate, matching Compression.inflate.
+bool inflateBuffer(const unsigned char *input,size_t length,std::vector<unsigned char> &out) {
+    if(length == 0 || length > (size_t)UINT32_MAX) {
+        return false;
+    }
+    z_stream stream = {};
+    if(inflateInit(&stream) != Z_OK) {
+        return false;
+    }
+    out.clear();
+    stream.next_in = const_cast<Bytef *>(input);
+    stream.avail_in = (uInt)length;
+    int ret = Z_OK;
+    while(ret != Z_STREAM_END) {
+        size_t prior = out.size();
+        size_t grow = std::max(kChunkSize,prior);
+        if(prior + grow > kMaxInflatedBytes) {
+            break;
+        }
+        out.resize(prior + grow);
+        stream.next_out = out.data() + prior;
+        stream.avail_out = (uInt)grow;
+        ret = inflate(&stream,Z_NO_FLUSH);
+        out.resize(prior + (grow - stream.avail_out));
+        if(ret != Z_OK && ret != Z_STREAM_END) {
+            break;
+        }
+    }
+    inflateEnd(&stream);
+    return ret == Z_STREAM_END;
+}
+#endif
+
+/// What a finished job hands back to the interpreter thread. Only plain C++ data crosses threads;
+/// runtime values are built when the task is settled.
+struct JobOutcome {
+    enum class Kind {
+        Text,
+        Bytes,
+        Numbers,
+        Number
+    };
+
+    Kind kind = Kind::Text;
+    /// Rejects the task when set.
+    std::string error;
+    std::string text;
+    std::vector<unsigned char> bytes;
+    StarbytesNumT numberType = NumTypeInt;
+    size_t numberCount = 0;
+    double number = 0;
+};
+
+struct PoolJob {
+    std::function<void(JobOutcome &)> run;
+    StarbytesTask task = nullptr;
+    /// Bytes input the worker reads in place. Bytes are immutable, so only the reference count,
+    /// which the interpreter thread alone touches, needs this hold.
+    StarbytesObject retained = nullptr;
+};
+
+struct PoolCompletion {
+    StarbytesTask task = nullptr;
+    StarbytesObject retained = nullptr;
+    JobOutcome outcome;
+};
+
+/// Hands finished pool jobs to the interpreter thread, which settles their tasks.
+using PoolCompletionQueue = starbytes::Runtime::stdlib::TaskCompletionQueue<PoolCompletion>;
+
+/// Never destroyed, so workers of a pool the interpreter never frees can still finish at exit.
+PoolCompletionQueue &poolCompletions() {
+    static auto *queue = new PoolCompletionQueue();
+    return *queue;
+}
+
+void abandonPoolJobs(std::vector<PoolJob> jobs) {
+    for(auto &job : jobs) {
+        StarbytesTaskReject(job.task,"ThreadPool was closed");
+        StarbytesObjectRelease(job.task);
+        if(job.retained) {
+            StarbytesObjectRelease(job.retained);
+        }
+        poolCompletions().abandonJob();
+    }
+}
+
+/// Worker threads that run native jobs from a shared queue. Owned by its ThreadPool object.
+class ThreadPoolState {
+public:
+    ~ThreadPoolState() {
+        // Freed with its object on the interpreter thread, so unstarted tasks can be settled here.
+        abandonPoolJobs(close());
+    }
+
+    bool start(size_t threadCount,std::string &error) {
+        try {
+            for(size_t i = 0; i < threadCount; ++i) {
+                workers.emplace_back([this]() {
+                    run();
+                });
+            }
+        }
+        catch(const std::system_error &ex) {
+            close();
+            error = systemErrorMessage("threadPool failed to start its workers",ex.code());
+            return false;
+        }
+        return true;
+    }
+
+    bool submit(PoolJob &job) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if(closing) {
+                return false;
+            }
+            queued.push_back(std::move(job));
+        }
+        wake.notify_one();
+        return true;
+    }
+
+    size_t pending() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return queued.size() + running;
+    }
+
+    bool isClosed() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return closing;
+    }
+
+    /// Stops taking jobs, waits for running ones, and returns the jobs that never started.
+    std::vector<PoolJob> close() {
+        std::vector<PoolJob> unstarted;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            closing = true;
+            std::move(queued.begin(),queued.end(),std::back_inserter(unstarted));
+            queued.clear();
+        }
+        wake.notify_all();
+        for(auto &worker : workers) {
+            if(worker.joinable()) {
+                worker.join();
+            }
+        }
+        workers.clear();
+        return unstarted;
+    }
+
+private:
+    void run() {
+        for(;;) {
+            PoolJob job;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wake.wait(lock,[this]() { return closing || !queued.empty(); });
+                if(queued.empty()) {
+                    return;
+                }
+                job = std::move(queued.front());
+                queued.pop_front();
+                ++running;
+            }
+
+            PoolCompletion completion;
+            completion.task = job.task;
+            completion.retained = job.retained;
+            try {
+                job.run(completion.outcome);
+            }
+            catch(const std::exception &ex) {
+                completion.outcome.error = std::string("ThreadPool job failed: ") + ex.what();
+            }
+            job.run = nullptr;
+
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                --running;
+            }
+            poolCompletions().complete(std::move(completion));
+        }
+    }
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::deque<PoolJob> queued;
+    std::vector<std::thread> workers;
+    size_t running = 0;
+    bool closing = false;
+};
+
+StarbytesObject makeOutcomeValue(JobOutcome &outcome) {
+    switch(outcome.kind) {
+        case JobOutcome::Kind::Bytes:
+            return StarbytesBytesNewWithData(outcome.bytes.data(),outcome.bytes.size());
+        case JobOutcome::Kind::Numbers:
+            return StarbytesArrayNewNumeric(outcome.numberType,outcome.bytes.data(),(unsigned)outcome.numberCount);
+        case JobOutcome::Kind::Number:
+            return StarbytesNumNew(NumTypeDouble,outcome.number);
+        case JobOutcome::Kind::Text:
+        default:
+            return makeString(outcome.text);
+    }
+}
+
+void settlePoolCompletion(PoolCompletion &completion) {
+    auto &outcome = completion.outcome;
+    if(outcome.error.empty()) {
+        auto value = makeOutcomeValue(outcome);
+        StarbytesTaskResolve(completion.task,value);
+        StarbytesObjectRelease(value);
+    }
+    else {
+        StarbytesTaskReject(completion.task,outcome.error.c_str());
+    }
+    if(completion.retained) {
+        StarbytesObjectRelease(completion.retained);
+    }
+    StarbytesObjectRelease(completion.task);
+}
+
+int threading_drivePools() {
+    return poolCompletions().drive(settlePoolCompletion);
+}
+
+StarbytesTask rejectedTask(const std::string &message) {
+    auto task = StarbytesTaskNew();
+    StarbytesTaskReject(task,message.c_str());
+    return task;
+}
+
+/// Queues `run` on the pool behind the receiver and returns the task it will settle.
+StarbytesObject submitPoolJob(ThreadPoolState *pool,std::function<void(JobOutcome &)> run,StarbytesObject retained = nullptr) {
+    auto task = StarbytesTaskNew();
+    PoolJob job;
+    job.run = std::move(run);
+    job.task = task;
+    job.retained = retained;
+    StarbytesObjectReference(task);
+    if(retained) {
+        StarbytesObjectReference(retained);
+    }
+    poolCompletions().beginJob();
+    if(!pool->submit(job)) {
+        std::vector<PoolJob> refused;
+        refused.push_back(std::move(job));
+        abandonPoolJobs(std::move(refused));
+    }
+    return task;
+}
+
+/// Reads a Bytes or String job input. Bytes are retained and read in place by the worker; other
+/// inputs are copied into `copy`.
+bool readJobInput(StarbytesObject arg,std::shared_ptr<std::vector<unsigned char>> &copy,ByteView &view,StarbytesObject &retained) {
+    retained = nullptr;
+    if(!readByteView(arg,view)) {
+        return false;
+    }
+    if(StarbytesObjectTypecheck(arg,StarbytesBytesType())) {
+        retained = arg;
+        return true;
+    }
+    copy = std::make_shared<std::vector<unsigned char>>(view.data,view.data + view.length);
+    view.data = copy->data();
+    return true;
 }
 
 STARBYTES_FUNC(Threading_Mutex_lock) {
-    auto *state = requireMutexSelf(args);
+    auto *state = requireSelf<MutexState>(args,"Mutex");
     if(!state) {
         return nullptr;
     }
@@ -176,7 +863,7 @@ STARBYTES_FUNC(Threading_Mutex_lock) {
 }
 
 STARBYTES_FUNC(Threading_Mutex_tryLock) {
-    auto *state = requireMutexSelf(args);
+    auto *state = requireSelf<MutexState>(args,"Mutex");
     if(!state) {
         return makeBool(false);
     }
@@ -195,7 +882,7 @@ STARBYTES_FUNC(Threading_Mutex_tryLock) {
 }
 
 STARBYTES_FUNC(Threading_Mutex_unlock) {
-    auto *state = requireMutexSelf(args);
+    auto *state = requireSelf<MutexState>(args,"Mutex");
     if(!state) {
         return nullptr;
     }
@@ -212,7 +899,7 @@ STARBYTES_FUNC(Threading_Mutex_unlock) {
 }
 
 STARBYTES_FUNC(Threading_Condition_wait) {
-    auto *condState = requireConditionSelf(args);
+    auto *condState = requireSelf<ConditionState>(args,"Condition");
     if(!condState) {
         return nullptr;
     }
@@ -223,7 +910,7 @@ STARBYTES_FUNC(Threading_Condition_wait) {
         return failNativeIfEmpty(args,"wait requires a Mutex and timeoutMillis");
     }
 
-    auto *mutexState = findMutexByObject(mutexObj);
+    auto *mutexState = findState<MutexState>(mutexObj);
     if(!mutexState) {
         return failNativeIfEmpty(args,"wait requires a valid Mutex");
     }
@@ -254,7 +941,7 @@ STARBYTES_FUNC(Threading_Condition_wait) {
 }
 
 STARBYTES_FUNC(Threading_Condition_notifyOne) {
-    auto *condState = requireConditionSelf(args);
+    auto *condState = requireSelf<ConditionState>(args,"Condition");
     if(!condState) {
         return nullptr;
     }
@@ -263,7 +950,7 @@ STARBYTES_FUNC(Threading_Condition_notifyOne) {
 }
 
 STARBYTES_FUNC(Threading_Condition_notifyAll) {
-    auto *condState = requireConditionSelf(args);
+    auto *condState = requireSelf<ConditionState>(args,"Condition");
     if(!condState) {
         return nullptr;
     }
@@ -272,7 +959,7 @@ STARBYTES_FUNC(Threading_Condition_notifyAll) {
 }
 
 STARBYTES_FUNC(Threading_Semaphore_acquire) {
-    auto *state = requireSemaphoreSelf(args);
+    auto *state = requireSelf<SemaphoreState>(args,"Semaphore");
     if(!state) {
         return nullptr;
     }
@@ -296,7 +983,7 @@ STARBYTES_FUNC(Threading_Semaphore_acquire) {
 }
 
 STARBYTES_FUNC(Threading_Semaphore_release) {
-    auto *state = requireSemaphoreSelf(args);
+    auto *state = requireSelf<SemaphoreState>(args,"Semaphore");
     if(!state) {
         return nullptr;
     }
@@ -318,7 +1005,7 @@ STARBYTES_FUNC(Threading_Semaphore_release) {
 }
 
 STARBYTES_FUNC(Threading_Semaphore_currentCount) {
-    auto *state = requireSemaphoreSelf(args);
+    auto *state = requireSelf<SemaphoreState>(args,"Semaphore");
     if(!state) {
         return makeInt(0);
     }
@@ -328,7 +1015,7 @@ STARBYTES_FUNC(Threading_Semaphore_currentCount) {
 }
 
 STARBYTES_FUNC(Threading_Event_wait) {
-    auto *state = requireEventSelf(args);
+    auto *state = requireSelf<EventState>(args,"Event");
     if(!state) {
         return nullptr;
     }
@@ -355,7 +1042,7 @@ STARBYTES_FUNC(Threading_Event_wait) {
 }
 
 STARBYTES_FUNC(Threading_Event_set) {
-    auto *state = requireEventSelf(args);
+    auto *state = requireSelf<EventState>(args,"Event");
     if(!state) {
         return nullptr;
     }
@@ -375,7 +1062,7 @@ STARBYTES_FUNC(Threading_Event_set) {
 }
 
 STARBYTES_FUNC(Threading_Event_reset) {
-    auto *state = requireEventSelf(args);
+    auto *state = requireSelf<EventState>(args,"Event");
     if(!state) {
         return nullptr;
     }
@@ -386,7 +1073,7 @@ STARBYTES_FUNC(Threading_Event_reset) {
 }
 
 STARBYTES_FUNC(Threading_Event_isSet) {
-    auto *state = requireEventSelf(args);
+    auto *state = requireSelf<EventState>(args,"Event");
     if(!state) {
         return makeBool(false);
     }
@@ -398,17 +1085,13 @@ STARBYTES_FUNC(Threading_Event_isSet) {
 STARBYTES_FUNC(Threading_mutexCreate) {
     skipOptionalModuleReceiver(args,0);
 
-    auto object = StarbytesObjectNew(StarbytesMakeClass("Mutex"));
-    g_mutexRegistry[object] = std::make_unique<MutexState>();
-    return object;
+    return makeStateObject("Mutex",std::make_unique<MutexState>());
 }
 
 STARBYTES_FUNC(Threading_conditionCreate) {
     skipOptionalModuleReceiver(args,0);
 
-    auto object = StarbytesObjectNew(StarbytesMakeClass("Condition"));
-    g_conditionRegistry[object] = std::make_unique<ConditionState>();
-    return object;
+    return makeStateObject("Condition",std::make_unique<ConditionState>());
 }
 
 STARBYTES_FUNC(Threading_semaphoreCreate) {
@@ -423,12 +1106,10 @@ STARBYTES_FUNC(Threading_semaphoreCreate) {
         return failNativeIfEmpty(args,"semaphoreCreate requires 0 <= initial <= max and max > 0");
     }
 
-    auto object = StarbytesObjectNew(StarbytesMakeClass("Semaphore"));
     auto state = std::make_unique<SemaphoreState>();
     state->count = initial;
     state->maxCount = maxCount;
-    g_semaphoreRegistry[object] = std::move(state);
-    return object;
+    return makeStateObject("Semaphore",std::move(state));
 }
 
 STARBYTES_FUNC(Threading_eventCreate) {
@@ -440,12 +1121,10 @@ STARBYTES_FUNC(Threading_eventCreate) {
         return nullptr;
     }
 
-    auto object = StarbytesObjectNew(StarbytesMakeClass("Event"));
     auto state = std::make_unique<EventState>();
     state->signaled = initial;
     state->manualReset = manualReset;
-    g_eventRegistry[object] = std::move(state);
-    return object;
+    return makeStateObject("Event",std::move(state));
 }
 
 STARBYTES_FUNC(Threading_currentThreadId) {
@@ -459,11 +1138,7 @@ STARBYTES_FUNC(Threading_currentThreadId) {
 STARBYTES_FUNC(Threading_hardwareConcurrency) {
     skipOptionalModuleReceiver(args,0);
 
-    auto value = std::thread::hardware_concurrency();
-    if(value == 0) {
-        value = 1;
-    }
-    return makeInt((int)value);
+    return makeInt((int)hardwareThreads());
 }
 
 STARBYTES_FUNC(Threading_yieldNow) {
@@ -485,6 +1160,231 @@ STARBYTES_FUNC(Threading_sleepMillis) {
     return makeBool(true);
 }
 
+STARBYTES_FUNC(Threading_ThreadPool_hash) {
+    auto *pool = requireSelf<ThreadPoolState>(args,"ThreadPool");
+    if(!pool) {
+        return nullptr;
+    }
+
+    auto algorithmArg = StarbytesFuncArgsGetArg(args);
+    auto dataArg = StarbytesFuncArgsGetArg(args);
+    starbytes::DigestKind kind = starbytes::DigestKind::Sha256;
+    if(!algorithmArg || !StarbytesObjectTypecheck(algorithmArg,StarbytesStrType())
+       || !starbytes::digestKindFromName(StarbytesStrGetBuffer(algorithmArg),kind)) {
+        return rejectedTask("hash requires an algorithm of md5, sha1, sha256, sha512 or blake2b");
+    }
+    std::shared_ptr<std::vector<unsigned char>> copy;
+    ByteView input;
+    StarbytesObject retained = nullptr;
+    if(!readJobInput(dataArg,copy,input,retained)) {
+        return rejectedTask("hash requires Bytes data");
+    }
+
+    auto *data = input.data;
+    auto length = input.length;
+    return submitPoolJob(pool,[kind,copy,data,length](JobOutcome &outcome) {
+        starbytes::Digest digest(kind);
+        unsigned char out[starbytes::kMaxDigestLength];
+        if(!digest.valid() || !digest.update(data,length) || !digest.final(out)) {
+            outcome.error = "hash failed";
+            return;
+        }
+        outcome.text = toHex(out,starbytes::digestLength(kind));
+    },retained);
+}
+
+STARBYTES_FUNC(Threading_ThreadPool_deflate) {
+    auto *pool = requireSelf<ThreadPoolState>(args,"ThreadPool");
+    if(!pool) {
+        return nullptr;
+    }
+
+    auto dataArg = StarbytesFuncArgsGetArg(args);
+    auto levelArg = StarbytesFuncArgsGetArg(args);
+    std::shared_ptr<std::vector<unsigned char>> copy;
+    ByteView input;
+    StarbytesObject retained = nullptr;
+    if(!levelArg || !StarbytesObjectTypecheck(levelArg,StarbytesNumType()) || StarbytesNumGetType(levelArg) != NumTypeInt
+       || StarbytesNumGetIntValue(levelArg) < -1 || StarbytesNumGetIntValue(levelArg) > 9
+       || !readJobInput(dataArg,copy,input,retained)) {
+        return rejectedTask("deflate requires Bytes data and a level between -1 and 9");
+    }
+
+#ifdef STARBYTES_HAS_ZLIB
+    int level = StarbytesNumGetIntValue(levelArg);
+    auto *data = input.data;
+    auto length = input.length;
+    return submitPoolJob(pool,[level,copy,data,length](JobOutcome &outcome) {
+        outcome.kind = JobOutcome::Kind::Bytes;
+        if(!deflateBuffer(data,length,level,outcome.bytes)) {
+            outcome.error = "deflate failed";
+        }
+    },retained);
+#else
+    return rejectedTask("deflate is unavailable because the module was built without zlib");
+#endif
+}
+
+STARBYTES_FUNC(Threading_ThreadPool_inflate) {
+    auto *pool = requireSelf<ThreadPoolState>(args,"ThreadPool");
+    if(!pool) {
+        return nullptr;
+    }
+
+    std::shared_ptr<std::vector<unsigned char>> copy;
+    ByteView input;
+    StarbytesObject retained = nullptr;
+    if(!readJobInput(StarbytesFuncArgsGetArg(args),copy,input,retained)) {
+        return rejectedTask("inflate requires Bytes data");
+    }
+
+#ifdef STARBYTES_HAS_ZLIB
+    auto *data = input.data;
+    auto length = input.length;
+    return submitPoolJob(pool,[copy,data,length](JobOutcome &outcome) {
+        outcome.kind = JobOutcome::Kind::Bytes;
+        if(!inflateBuffer(data,length,outcome.bytes)) {
+            outcome.bytes.clear();
+            outcome.error = "inflate failed";
+        }
+    },retained);
+#else
+    return rejectedTask("inflate is unavailable because the module was built without zlib");
+#endif
+}
+
+STARBYTES_FUNC(Threading_ThreadPool_readFile) {
+    auto *pool = requireSelf<ThreadPoolState>(args,"ThreadPool");
+    if(!pool) {
+        return nullptr;
+    }
+
+    auto pathArg = StarbytesFuncArgsGetArg(args);
+    if(!pathArg || !StarbytesObjectTypecheck(pathArg,StarbytesStrType()) || StarbytesStrGetBuffer(pathArg)[0] == '\0') {
+        return rejectedTask("readFile requires a non-empty path");
+    }
+
+    std::string path = StarbytesStrGetBuffer(pathArg);
+    return submitPoolJob(pool,[path](JobOutcome &outcome) {
+        outcome.kind = JobOutcome::Kind::Bytes;
+        readWholeFile(path,outcome.bytes,outcome.error);
+    });
+}
+
+STARBYTES_FUNC(Threading_ThreadPool_map) {
+    auto *pool = requireSelf<ThreadPoolState>(args,"ThreadPool");
+    if(!pool) {
+        return nullptr;
+    }
+
+    auto valuesArg = StarbytesFuncArgsGetArg(args);
+    auto opArg = StarbytesFuncArgsGetArg(args);
+    auto operandArg = StarbytesFuncArgsGetArg(args);
+    auto input = std::make_shared<NumericArray>();
+    if(!readNumericArray(valuesArg,true,*input)) {
+        return rejectedTask("map requires an Array of numbers");
+    }
+    MapKernel kernel;
+    std::string error;
+    if(!readMapKernel(opArg,operandArg,input->type,kernel,error)) {
+        return rejectedTask("map: " + error);
+    }
+
+    return submitPoolJob(pool,[input,kernel](JobOutcome &outcome) {
+        outcome.kind = JobOutcome::Kind::Numbers;
+        outcome.numberType = kernel.outputType;
+        outcome.numberCount = input->count;
+        outcome.bytes.resize(input->count * numElementSize(kernel.outputType));
+        if(input->count > 0) {
+            runMapKernel(kernel,input->elements,outcome.bytes.data(),0,input->count);
+        }
+    });
+}
+
+STARBYTES_FUNC(Threading_ThreadPool_sum) {
+    auto *pool = requireSelf<ThreadPoolState>(args,"ThreadPool");
+    if(!pool) {
+        return nullptr;
+    }
+
+    auto input = std::make_shared<NumericArray>();
+    if(!readNumericArray(StarbytesFuncArgsGetArg(args),true,*input)) {
+        return rejectedTask("sum requires an Array of numbers");
+    }
+
+    return submitPoolJob(pool,[input](JobOutcome &outcome) {
+        outcome.kind = JobOutcome::Kind::Number;
+        outcome.number = input->count > 0 ? sumNumericArray(*input) : 0.0;
+    });
+}
+
+STARBYTES_FUNC(Threading_ThreadPool_pending) {
+    auto *pool = requireSelf<ThreadPoolState>(args,"ThreadPool");
+    if(!pool) {
+        return makeInt(0);
+    }
+    return makeInt((int)pool->pending());
+}
+
+STARBYTES_FUNC(Threading_ThreadPool_close) {
+    auto *pool = findState<ThreadPoolState>(StarbytesFuncArgsGetArg(args));
+    if(!pool || pool->isClosed()) {
+        return makeBool(false);
+    }
+    abandonPoolJobs(pool->close());
+    return makeBool(true);
+}
+
+STARBYTES_FUNC(Threading_threadPool) {
+    skipOptionalModuleReceiver(args,1);
+
+    int threads = 0;
+    if(!readIntArg(args,threads)) {
+        return nullptr;
+    }
+    if(threads < 0 || threads > kMaxPoolThreads) {
+        return failNativeIfEmpty(args,"threadPool requires threads between 0 and " + std::to_string(kMaxPoolThreads));
+    }
+    if(threads == 0) {
+        threads = (int)hardwareThreads();
+    }
+
+    auto pool = std::make_unique<ThreadPoolState>();
+    std::string error;
+    if(!pool->start((size_t)threads,error)) {
+        return failNativeIfEmpty(args,error);
+    }
+    return makeStateObject("ThreadPool",std::move(pool));
+}
+
+STARBYTES_FUNC(Threading_parallelMap) {
+    skipOptionalModuleReceiver(args,3);
+
+    auto valuesArg = StarbytesFuncArgsGetArg(args);
+    auto opArg = StarbytesFuncArgsGetArg(args);
+    auto operandArg = StarbytesFuncArgsGetArg(args);
+    // The interpreter waits in this call, so packed storage is read in place and the workers
+    // never see a runtime object.
+    NumericArray values;
+    if(!readNumericArray(valuesArg,false,values)) {
+        return failNativeIfEmpty(args,"parallelMap requires an Array of numbers");
+    }
+    MapKernel kernel;
+    std::string error;
+    if(!readMapKernel(opArg,operandArg,values.type,kernel,error)) {
+        return failNativeIfEmpty(args,"parallelMap: " + error);
+    }
+    if(values.count == 0) {
+        return StarbytesArrayNew();
+    }
+
+    std::vector<unsigned char> output(values.count * numElementSize(kernel.outputType));
+    parallelFor(values.count,[&](size_t begin,size_t end) {
+        runMapKernel(kernel,values.elements,output.data(),begin,end);
+    });
+    return StarbytesArrayNewNumeric(kernel.outputType,output.data(),(unsigned)values.count);
+}
+
 void addFunc(StarbytesNativeModule *module,const char *name,unsigned argCount,StarbytesFuncCallback callback) {
     StarbytesFuncDesc desc;
     desc.name = CStringMake(name);
@@ -525,5 +1425,18 @@ STARBYTES_NATIVE_MOD_MAIN() {
     addFunc(module,"Threading_yieldNow",0,Threading_yieldNow);
     addFunc(module,"Threading_sleepMillis",1,Threading_sleepMillis);
 
+    addFunc(module,"Threading_ThreadPool_hash",3,Threading_ThreadPool_hash);
+    addFunc(module,"Threading_ThreadPool_deflate",3,Threading_ThreadPool_deflate);
+    addFunc(module,"Threading_ThreadPool_inflate",2,Threading_ThreadPool_inflate);
+    addFunc(module,"Threading_ThreadPool_readFile",2,Threading_ThreadPool_readFile);
+    addFunc(module,"Threading_ThreadPool_map",4,Threading_ThreadPool_map);
+    addFunc(module,"Threading_ThreadPool_sum",2,Threading_ThreadPool_sum);
+    addFunc(module,"Threading_ThreadPool_pending",1,Threading_ThreadPool_pending);
+    addFunc(module,"Threading_ThreadPool_close",1,Threading_ThreadPool_close);
+    addFunc(module,"Threading_threadPool",1,Threading_threadPool);
+    addFunc(module,"Threading_parallelMap",3,Threading_parallelMap);
+
+    StarbytesRuntimeAddTaskDriver(threading_drivePools);
+
     return module;
 }
@@ -0,0 +1,128 @@
+#include "../tools/driver/scheduler/BuildScheduler.h"
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using starbytes::driver::scheduler::BuildScheduleStats;
+using starbytes::driver::scheduler::BuildTaskNode;
+using starbytes::driver::scheduler::WorkStealingScheduler;
+using starbytes::driver::scheduler::computeCriticalPathPriorities;
+
+int fail(const char *message) {
+    std::cerr << "BuildSchedulerTest failure: " << message << '\n';
+    return 1;
+}
+
+std::vector<BuildTaskNode> makeDiamondChain(size_t layers) {
+    // root -> (left,right) -> join -> (left,right) -> join ...
+    std::vector<BuildTaskNode> nodes(1);
+    size_t previous = 0;
+    for(size_t layer = 0; layer < layers; ++layer) {
+        BuildTaskNode left;
+        left.dependencies = {previous};
+        BuildTaskNode right;
+        right.dependencies = {previous};
+        nodes.push_back(left);
+        nodes.push_back(right);
+        BuildTaskNode join;
+        join.dependencies = {nodes.size() - 2, nodes.size() - 1};
+        nodes.push_back(join);
+        previous = nodes.size() - 1;
+    }
+    return nodes;
+}
+
+}
+
+int main() {
+    auto nodes = makeDiamondChain(64);
+
+    std::vector<uint64_t> costs(nodes.size(), 1);
+    costs[1] = 10;
+    auto priorities = computeCriticalPathPriorities(nodes, costs);
+    if(priorities[0] <= priorities[1] || priorities[1] <= priorities[2]) {
+        return fail("critical path priorities did not favour the expensive chain");
+    }
+
+    for(unsigned workers : {1u, 4u, 16u}) {
+        std::vector<std::atomic<int>> finished(nodes.size());
+        std::atomic<size_t> runCount{0};
+        std::atomic<bool> orderViolated{false};
+        WorkStealingScheduler scheduler(workers);
+        BuildScheduleStats stats;
+        bool ok = scheduler.run(nodes, [&](size_t index) {
+            for(auto dep : nodes[index].dependencies) {
+                if(finished[dep].load() == 0) {
+                    orderViolated = true;
+                }
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+            finished[index].store(1);
+            ++runCount;
+        }, stats);
+        if(!ok) {
+            return fail("scheduler rejected a valid graph");
+        }
+        if(orderViolated) {
+            return fail("task ran before one of its dependencies finished");
+        }
+        if(runCount != nodes.size()) {
+            return fail("not every task ran exactly once");
+        }
+        if(stats.workers.size() != workers) {
+            return fail("worker stats size mismatch");
+        }
+        uint64_t tasksRun = 0;
+        for(const auto &worker : stats.workers) {
+            tasksRun += worker.tasksRun;
+        }
+        if(tasksRun != nodes.size() || stats.wallNs == 0) {
+            return fail("worker stats were not populated");
+        }
+    }
+
+    std::vector<BuildTaskNode> cyclic(2);
+    cyclic[0].dependencies = {1};
+    cyclic[1].dependencies = {0};
+    WorkStealingScheduler scheduler(2);
+    BuildScheduleStats stats;
+    bool ran = false;
+    if(scheduler.run(cyclic, [&](size_t) { ran = true; }, stats) || ran) {
+        return fail("cyclic graph should be rejected without running tasks");
+    }
+
+    auto wide = makeDiamondChain(16);
+    std::atomic<size_t> startedAfterFailure{0};
+    std::atomic<bool> thrown{false};
+    bool rethrown = false;
+    try {
+        WorkStealingScheduler throwingScheduler(4);
+        throwingScheduler.run(wide, [&](size_t index) {
+            if(thrown) {
+                ++startedAfterFailure;
+            }
+            if(index == 4) {
+                thrown = true;
+                throw std::runtime_error("task failed");
+            }
+        }, stats);
+    }
+    catch(const std::runtime_error &) {
+        rethrown = true;
+    }
+    if(!rethrown) {
+        return fail("exception from a task was not rethrown by run");
+    }
+    if(startedAfterFailure > 3) {
+        return fail("tasks kept starting after one threw");
+    }
+
+    return 0;
+}
@@ -0,0 +1,195 @@
+#include "starbytes/compiler/BytecodeOptimizer.h"
+#include "starbytes/compiler/Gen.h"
+#include "starbytes/compiler/Parser.h"
+#include "starbytes/compiler/RTCode.h"
+#include "starbytes/runtime/RTEngine.h"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+namespace {
+
+int fail(const char *message) {
+    std::cerr << "BytecodeOptimizerTest failure: " << message << '\n';
+    return 1;
+}
+
+const char *kSource = R"starb(
+func kernel(n:Int) Int {
+    decl total:Int = 0
+    decl i:Int = 0
+    decl scale:Int = 2 * 3 + 2
+    while(i < n){
+        total = total + (i * scale) % 7 + (4 - 4)
+        i = i + 1
+    }
+    return total
+}
+
+print(kernel(1000))
+)starb";
+
+bool compileModule(const std::filesystem::path &modulePath,starbytes::BytecodeOptimizer &optimizer) {
+    using namespace starbytes;
+    std::ofstream out(modulePath,std::ios::out | std::ios::binary);
+    if(!out.is_open()) {
+        return false;
+    }
+    auto currentDir = std::filesystem::current_path();
+    Gen gen;
+    auto genContext = ModuleGenContext::Create("BytecodeOptimizer",out,currentDir);
+    genContext.bytecodeVersion = Runtime::RTBYTECODE_VERSION_V2;
+    genContext.optimizer = &optimizer;
+    gen.setContext(&genContext);
+
+    Parser parser(gen);
+    auto parseContext = ModuleParseContext::Create("BytecodeOptimizer");
+    std::istringstream in(kSource);
+    parser.parseFromStream(in,parseContext);
+    if(!parser.finish()) {
+        return false;
+    }
+    gen.finish();
+    return true;
+}
+
+bool runModule(const std::filesystem::path &modulePath,std::string &outputOut,uint64_t &dispatchesOut) {
+    auto interp = starbytes::Runtime::Interp::Create();
+    interp->setProfilingEnabled(true);
+    std::ifstream in(modulePath,std::ios::in | std::ios::binary);
+    if(!in.is_open()) {
+        return false;
+    }
+    std::ostringstream captured;
+    auto *savedBuf = std::cout.rdbuf(captured.rdbuf());
+    interp->exec(in);
+    std::cout.rdbuf(savedBuf);
+    outputOut = captured.str();
+    if(interp->hasRuntimeError()) {
+        std::cerr << interp->takeRuntimeError() << '\n';
+        return false;
+    }
+    dispatchesOut = interp->getProfileData().dispatchCount;
+    return true;
+}
+
+/// Optimizes `__v2tmp2 = lhs <op> rhs; return __v2tmp2` over Long temporaries and reports the
+/// constant the function ends up returning.
+bool foldLongBinary(int64_t lhs,int64_t rhs,starbytes::Runtime::RTTypedBinaryOp op,int64_t &returnedOut) {
+    using namespace starbytes::Runtime;
+    RTFuncTemplate templ;
+    static const char *kSlotNames[] = {"__v2tmp0","__v2tmp1","__v2tmp2"};
+    for(const char *name : kSlotNames) {
+        templ.localSlotNames.push_back(RTID{std::strlen(name),name});
+        templ.slotKinds.push_back(RTTYPED_NUM_LONG);
+    }
+    RTV2FunctionImage image;
+    image.i64Consts = {lhs,rhs};
+    RTV2Instruction instr;
+    instr.opcode = RTV2_OP_LOAD_I64_CONST;
+    instr.a = 0;
+    instr.b = 0;
+    image.instructions.push_back(instr);
+    instr.a = 1;
+    instr.b = 1;
+    image.instructions.push_back(instr);
+    instr = RTV2Instruction();
+    instr.opcode = RTV2_OP_BINARY;
+    instr.kind = RTTYPED_NUM_LONG;
+    instr.aux = op;
+    instr.a = 2;
+    instr.b = 0;
+    instr.c = 1;
+    image.instructions.push_back(instr);
+    instr = RTV2Instruction();
+    instr.opcode = RTV2_OP_RETURN;
+    instr.a = 2;
+    image.instructions.push_back(instr);
+
+    starbytes::BytecodeOptimizer optimizer(starbytes::BytecodeOptLevel::O2);
+    optimizer.optimize(image,templ);
+    if(image.instructions.size() != 2 || image.instructions[1].opcode != RTV2_OP_RETURN) {
+        return false;
+    }
+    const auto &load = image.instructions[0];
+    if(load.opcode != RTV2_OP_LOAD_I64_CONST || load.a != image.instructions[1].a || load.b >= image.i64Consts.size()) {
+        return false;
+    }
+    returnedOut = image.i64Consts[load.b];
+    return true;
+}
+
+}
+
+int main() {
+    using starbytes::BytecodeOptLevel;
+    using starbytes::BytecodeOptimizer;
+
+    // Long constants fold in 64-bit integer arithmetic; a detour through a 53-bit double mantissa
+    // would round these values.
+    int64_t folded = 0;
+    if(!foldLongBinary(9007199254740993LL,0,RTTYPED_BINARY_ADD,folded) || folded != 9007199254740993LL) {
+        return fail("9007199254740993L + 0L did not fold to itself");
+    }
+    if(!foldLongBinary(9007199254740993LL,2,RTTYPED_BINARY_ADD,folded) || folded != 9007199254740995LL) {
+        return fail("9007199254740993L + 2L did not fold exactly");
+    }
+    if(foldLongBinary(INT64_MAX,1,RTTYPED_BINARY_ADD,folded)) {
+        return fail("an overflowing Long addition should be left for the runtime");
+    }
+
+    const auto unoptimizedPath = std::filesystem::current_path() / "bytecode_optimizer_o0_test.stbxm";
+    const auto optimizedPath = std::filesystem::current_path() / "bytecode_optimizer_o2_test.stbxm";
+    auto cleanup = [&]() {
+        std::error_code ignored;
+        std::filesystem::remove(unoptimizedPath,ignored);
+        std::filesystem::remove(optimizedPath,ignored);
+    };
+
+    BytecodeOptimizer o0(BytecodeOptLevel::O0);
+    BytecodeOptimizer o2(BytecodeOptLevel::O2);
+    if(!compileModule(unoptimizedPath,o0) || !compileModule(optimizedPath,o2)) {
+        cleanup();
+        return fail("failed to compile the V2 module");
+    }
+
+    const auto &stats = o2.stats();
+    if(stats.functionsOptimized == 0 || stats.instructionsAfter >= stats.instructionsBefore) {
+        cleanup();
+        return fail("O2 did not shrink the lowered function");
+    }
+    for(const auto &pass : stats.passes) {
+        if(pass.runs == 0) {
+            cleanup();
+            return fail("an O2 pass was never run");
+        }
+    }
+    if(o0.stats().functionsOptimized != 0 || !o0.stats().passes.empty()) {
+        cleanup();
+        return fail("O0 should leave function images untouched");
+    }
+
+    std::string unoptimizedOutput;
+    std::string optimizedOutput;
+    uint64_t unoptimizedDispatches = 0;
+    uint64_t optimizedDispatches = 0;
+    if(!runModule(unoptimizedPath,unoptimizedOutput,unoptimizedDispatches)
+       || !runModule(optimizedPath,optimizedOutput,optimizedDispatches)) {
+        cleanup();
+        return fail("module execution failed");
+    }
+    cleanup();
+
+    if(unoptimizedOutput.find("2997") == std::string::npos || optimizedOutput != unoptimizedOutput) {
+        std::cerr << unoptimizedOutput << " / " << optimizedOutput << '\n';
+        return fail("optimized module produced different output");
+    }
+    if(optimizedDispatches >= unoptimizedDispatches) {
+        return fail("optimized module did not reduce interpreter dispatches");
+    }
+    return 0;
+}
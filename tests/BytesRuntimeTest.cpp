@@ -0,0 +1,103 @@
+#include "starbytes/interop.h"
+#include "starbytes/runtime/BytesSupport.h"
+
+#include <cstring>
+#include <iostream>
+#include <string>
+
+namespace {
+
+int fail(const char *message) {
+    std::cerr << "BytesRuntimeTest failure: " << message << '\n';
+    return 1;
+}
+
+std::string bytesText(StarbytesObject bytes) {
+    return std::string(reinterpret_cast<const char *>(StarbytesBytesGetData(bytes)),StarbytesBytesGetLength(bytes));
+}
+
+}
+
+int main() {
+    namespace bytes = starbytes::Runtime::bytes;
+
+    auto buffer = StarbytesBytesNewWithData("hello world",11);
+    if(!StarbytesObjectTypecheck(buffer,StarbytesBytesType()) || StarbytesBytesGetLength(buffer) != 11u) {
+        return fail("bytes construction mismatch");
+    }
+
+    auto view = StarbytesBytesSlice(buffer,6,5);
+    if(StarbytesBytesGetData(view) != StarbytesBytesGetData(buffer) + 6 || bytesText(view) != "world") {
+        return fail("slice should be a view into the parent buffer");
+    }
+    auto nested = StarbytesBytesSlice(view,1,10);
+    if(bytesText(nested) != "orld") {
+        return fail("nested slice should clamp to the view length");
+    }
+    StarbytesObjectRelease(buffer);
+    if(bytesText(nested) != "orld" || bytesText(view) != "world") {
+        return fail("views should keep the released parent storage alive");
+    }
+
+    auto copied = bytes::copy(view);
+    if(StarbytesBytesGetData(copied) == StarbytesBytesGetData(view)
+       || StarbytesBytesCompare(copied,view) != COMPARE_EQUAL) {
+        return fail("copy should detach storage and compare equal");
+    }
+
+    auto hex = bytes::toHex(view);
+    if(std::strcmp(StarbytesStrGetBuffer(hex),"776f726c64") != 0) {
+        return fail("toHex mismatch");
+    }
+
+    std::string error;
+    auto third = bytes::at(view,2,error);
+    if(!third || StarbytesNumGetIntValue(third) != 'r') {
+        return fail("at should return the byte value");
+    }
+    if(bytes::at(view,5,error) || error.empty()) {
+        return fail("out-of-range at should report an error");
+    }
+
+    auto ints = StarbytesArrayNew();
+    for(int value : {0,127,255}) {
+        auto num = StarbytesNumNew(NumTypeInt,value);
+        StarbytesArrayPush(ints,num);
+        StarbytesObjectRelease(num);
+    }
+    error.clear();
+    auto packed = bytes::fromArray(ints,error);
+    if(!packed || StarbytesBytesGetLength(packed) != 3u || StarbytesBytesGetData(packed)[2] != 255) {
+        return fail("fromArray should pack Int elements");
+    }
+    auto roundTrip = bytes::toArray(packed);
+    if(StarbytesArrayGetLength(roundTrip) != 3u || StarbytesNumGetIntValue(StarbytesArrayIndex(roundTrip,1)) != 127) {
+        return fail("toArray should unpack byte values");
+    }
+
+    auto outOfRange = StarbytesNumNew(NumTypeInt,256);
+    StarbytesArrayPush(ints,outOfRange);
+    StarbytesObjectRelease(outOfRange);
+    error.clear();
+    if(bytes::fromArray(ints,error) || error.empty()) {
+        return fail("fromArray should reject values outside the byte range");
+    }
+
+    auto filled = StarbytesBytesNew(16);
+    std::memcpy(StarbytesBytesGetData(filled),"abc",3);
+    StarbytesBytesTruncate(filled,3);
+    if(bytesText(filled) != "abc") {
+        return fail("truncate should shrink the published length");
+    }
+
+    StarbytesObjectRelease(view);
+    StarbytesObjectRelease(nested);
+    StarbytesObjectRelease(copied);
+    StarbytesObjectRelease(hex);
+    StarbytesObjectRelease(third);
+    StarbytesObjectRelease(ints);
+    StarbytesObjectRelease(packed);
+    StarbytesObjectRelease(roundTrip);
+    StarbytesObjectRelease(filled);
+    return 0;
+}
@@ -0,0 +1,140 @@
+#include "../tools/lsp/IncrementalAnalysis.h"
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+using starbytes::lsp::CompilerDiagnosticEntry;
+using starbytes::lsp::IncrementalDiagnostics;
+
+int fail(const char *message) {
+    std::cerr << "IncrementalAnalysisTest failure: " << message << '\n';
+    return 1;
+}
+
+bool sameRegion(const starbytes::Region &lhs, const starbytes::Region &rhs) {
+    return lhs.startLine == rhs.startLine && lhs.startCol == rhs.startCol && lhs.endLine == rhs.endLine &&
+           lhs.endCol == rhs.endCol;
+}
+
+bool sameDiagnostics(const std::vector<CompilerDiagnosticEntry> &lhs, const std::vector<CompilerDiagnosticEntry> &rhs) {
+    if(lhs.size() != rhs.size()) {
+        return false;
+    }
+    for(size_t i = 0; i < lhs.size(); ++i) {
+        if(!sameRegion(lhs[i].region, rhs[i].region) || lhs[i].message != rhs[i].message || lhs[i].id != rhs[i].id ||
+           lhs[i].code != rhs[i].code || lhs[i].severity != rhs[i].severity || lhs[i].phase != rhs[i].phase ||
+           lhs[i].relatedSpans.size() != rhs[i].relatedSpans.size() || lhs[i].fixits.size() != rhs[i].fixits.size()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::vector<CompilerDiagnosticEntry> fullAnalysis(const std::string &text) {
+    IncrementalDiagnostics fresh;
+    return fresh.analyze("file:///ws/main.starb", text, {}, {});
+}
+
+std::string replaceOnce(std::string text, const std::string &from, const std::string &to) {
+    auto pos = text.find(from);
+    if(pos != std::string::npos) {
+        text.replace(pos, from.size(), to);
+    }
+    return text;
+}
+
+}
+
+int main() {
+    const std::string uri = "file:///ws/main.starb";
+    const std::string original = R"starb(decl base:Int = 1
+
+func first(a:Int) Int {
+    return a + base
+}
+
+/// Doc comments stay with the declaration below them.
+func second(b:Int) Int {
+    decl label:String = "text"
+    return first(b)
+}
+
+func third() Int {
+    return later()
+}
+
+func fourth() Int {
+    return first(2)
+}
+
+func later() Int {
+    return 2
+}
+)starb";
+
+    {
+        auto segments = starbytes::lsp::splitTopLevelSegments(original);
+        if(segments.size() != 6 || segments[2].line != 5 ||
+           original.compare(segments[2].offset, 4, "\n///") != 0 || segments[1].bodyOffset != 23) {
+            return fail("top-level segments were not split at declaration boundaries");
+        }
+        if(starbytes::lsp::splitTopLevelSegments("func broken() {\n").size() != 1) {
+            return fail("unbalanced text was split into several segments");
+        }
+    }
+
+    IncrementalDiagnostics diagnostics;
+    auto baseline = diagnostics.analyze(uri, original, {}, {});
+    if(baseline.empty()) {
+        return fail("the forward reference in `third` was not reported");
+    }
+
+    // Body edits inside one function only re-check that function, and must agree with a full analysis,
+    // including the forward reference `fourth` gains to `later`.
+    std::vector<std::string> bodyEdits;
+    bodyEdits.push_back(replaceOnce(original, "return first(b)", "return first(label)"));
+    bodyEdits.push_back(replaceOnce(bodyEdits.back(), "decl label", "\n\n    decl label"));
+    bodyEdits.push_back(replaceOnce(bodyEdits.back(), "return first(2)", "return later()"));
+    bodyEdits.push_back(replaceOnce(bodyEdits.back(), "return a + base", "return a + base + 1"));
+    for(size_t i = 0; i < bodyEdits.size(); ++i) {
+        auto incremental = diagnostics.analyze(uri, bodyEdits[i], {}, {});
+        if(!sameDiagnostics(incremental, fullAnalysis(bodyEdits[i]))) {
+            return fail("incremental diagnostics differ from a full analysis");
+        }
+        if(diagnostics.stats().incrementalAnalyses != i + 1) {
+            return fail("a body-only edit re-analyzed the whole document");
+        }
+    }
+    if(sameDiagnostics(diagnostics.analyze(uri, bodyEdits.back(), {}, {}), baseline) ||
+       diagnostics.stats().unchangedAnalyses != 1) {
+        return fail("re-analyzing unchanged text did not reuse the previous result");
+    }
+
+    {
+        auto signatureEdit = replaceOnce(bodyEdits.back(), "func first(a:Int) Int", "func first(a:String) Int");
+        auto result = diagnostics.analyze(uri, signatureEdit, {}, {});
+        if(diagnostics.stats().fullAnalyses != 2 || !sameDiagnostics(result, fullAnalysis(signatureEdit))) {
+            return fail("a signature edit did not fall back to a full analysis");
+        }
+    }
+
+    {
+        auto syntaxError = replaceOnce(original, "return a + base", "return a + )");
+        diagnostics.analyze(uri, syntaxError, {}, {});
+        auto repaired = diagnostics.analyze(uri, original, {}, {});
+        if(diagnostics.stats().fullAnalyses != 4 || !sameDiagnostics(repaired, baseline)) {
+            return fail("a document with syntax errors was analyzed incrementally");
+        }
+    }
+
+    diagnostics.forget(uri);
+    diagnostics.analyze(uri, original, {}, {});
+    if(diagnostics.stats().fullAnalyses != 5) {
+        return fail("forgotten documents kept their incremental state");
+    }
+
+    return 0;
+}
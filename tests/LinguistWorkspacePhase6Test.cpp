@@ -161,6 +161,42 @@ int main(int argc, char *argv[]) {
         return fail("include-scope");
     }
 
+    auto parallelRun = runAndCapture(lintCommand + " --jobs 4");
+    if(!expect(parallelRun.exitCode == 0 && parallelRun.output == lintRun.output,
+               "parallel workspace lint should print the same output in the same order")) {
+        return fail("parallel-output");
+    }
+
+    auto cacheDir = root / "lint-cache";
+    auto cachedCommand = lintCommand + " --jobs 2 --cache-stats --cache-dir " + shellQuote(cacheDir.string());
+    auto coldRun = runAndCapture(cachedCommand);
+    if(!expect(coldRun.exitCode == 0 && coldRun.output.find("ling-cache: reused 0 of 4 file(s)") != std::string::npos,
+               "first cached run should analyze every file")) {
+        return fail("cache-cold");
+    }
+    if(!expect(coldRun.output.rfind(lintRun.output, 0) == 0, "cached run should print the uncached output")) {
+        return fail("cache-cold-output");
+    }
+    auto warmRun = runAndCapture(cachedCommand);
+    if(!expect(warmRun.output == coldRun.output.substr(0, lintRun.output.size()) + "ling-cache: reused 4 of 4 file(s)\n",
+               "second cached run should reuse every unchanged file")) {
+        return fail("cache-warm");
+    }
+
+    if(!writeFile(root / "main.starb", "decl main = 1   \n")) {
+        return fail("rewrite-main");
+    }
+    auto editedRun = runAndCapture(cachedCommand);
+    auto uncachedEditedRun = runAndCapture(lintCommand);
+    if(!expect(editedRun.output == uncachedEditedRun.output + "ling-cache: reused 3 of 4 file(s)\n",
+               "cached run should re-lint only the changed file")) {
+        return fail("cache-invalidate");
+    }
+    auto quietRun = runAndCapture(lintCommand + " --cache-dir " + shellQuote(cacheDir.string()));
+    if(!expect(quietRun.output == uncachedEditedRun.output, "cache summary should only print with --cache-stats")) {
+        return fail("cache-quiet");
+    }
+
     std::error_code cleanupEc;
     std::filesystem::remove_all(root, cleanupEc);
     return 0;
@@ -104,6 +104,32 @@ int main() {
         return fail("actions-non-empty");
     }
 
+    auto artifact = starbytes::linguistics::buildLinguisticsArtifact(session);
+    if(!expect(artifact && !artifact->hadError && !artifact->lexerHadError && !artifact->tokens.empty(),
+               "shared artifact should hold the tokens of a clean parse")) {
+        return fail("artifact-build");
+    }
+    if(!expect(artifact->acceptedStatements.size() == artifact->compiler.statements.size(),
+               "every statement of a clean parse should be accepted")) {
+        return fail("artifact-statements");
+    }
+    auto artifactFormat = formatter.format(*artifact, config);
+    if(!expect(artifactFormat.ok && artifactFormat.formattedText == formatResult.formattedText,
+               "formatting from the shared artifact should match formatting from the session")) {
+        return fail("artifact-format");
+    }
+    if(!expect(lint.run(artifact->view(), config).findings.size() == lintResult.findings.size() &&
+                   suggestions.run(artifact->view(), config).suggestions.size() == suggestionResult.suggestions.size(),
+               "lint and suggestions from the shared artifact should match the session results")) {
+        return fail("artifact-engines");
+    }
+    auto formattedArtifact = starbytes::linguistics::buildLinguisticsArtifact(idempotenceSession);
+    auto formattedAgain = formatter.format(*formattedArtifact, config);
+    if(!expect(formattedAgain.ok && formattedAgain.formattedText == formatResult.formattedText,
+               "already-formatted text should format to itself from its artifact")) {
+        return fail("artifact-format-idempotent");
+    }
+
     auto lintText = starbytes::linguistics::LinguisticsSerializer::toText(lintResult);
     auto suggestionText = starbytes::linguistics::LinguisticsSerializer::toText(suggestionResult);
     auto actionText = starbytes::linguistics::LinguisticsSerializer::toText(actionResult);
@@ -136,6 +136,31 @@ int main() {
         return fail("disabled-selector");
     }
 
+    if(!expect(lintResult.ruleTimings.empty(), "rule timings should only be collected when requested")) {
+        return fail("rule-timings-default");
+    }
+    starbytes::linguistics::LintRequest profiledRequest;
+    profiledRequest.profileRules = true;
+    auto profiledResult = lint.run(analysis.view(), config, profiledRequest);
+    if(!expect(profiledResult.findings.size() == lintResult.findings.size(),
+               "rule profiling should not change lint findings")) {
+        return fail("rule-timings-findings");
+    }
+    if(!expect(profiledResult.ruleTimings.size() == descriptors.size(),
+               "rule profiling should report every enabled rule")) {
+        return fail("rule-timings-count");
+    }
+    size_t timedFindings = 0;
+    for(size_t i = 0; i < descriptors.size(); ++i) {
+        if(!expect(profiledResult.ruleTimings[i].id == descriptors[i].id, "rule timings should follow the registry order")) {
+            return fail("rule-timings-order");
+        }
+        timedFindings += profiledResult.ruleTimings[i].findingCount;
+    }
+    if(!expect(timedFindings == profiledResult.findings.size(), "rule timings should account for every finding")) {
+        return fail("rule-timings-finding-count");
+    }
+
     auto cappedConfig = config;
     cappedConfig.lint.maxFindings = 2;
     auto cappedResult = lint.run(session, cappedConfig);
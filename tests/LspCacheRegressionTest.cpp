@@ -3,7 +3,9 @@
 #include <rapidjson/document.h>
 
 #include <filesystem>
+#include <fstream>
 #include <iostream>
+#include <set>
 #include <sstream>
 #include <string>
 #include <vector>
@@ -187,6 +189,89 @@ std::vector<std::string> readDiagnosticMessages(const rapidjson::Value &items) {
 
 }
 
+void writeFile(const std::filesystem::path &path, const std::string &text) {
+    std::filesystem::create_directories(path.parent_path());
+    std::ofstream out(path, std::ios::out | std::ios::binary | std::ios::trunc);
+    out << text;
+}
+
+/// Opens `mainPath` in a fresh server rooted at `root` and requests its diagnostics, which resolves
+/// the closed interface files it imports.
+bool diagnoseInWorkspace(const std::filesystem::path &root, const std::filesystem::path &mainPath, const std::string &text) {
+    std::stringstream input;
+    std::stringstream output;
+    const auto rootUri = "file://" + root.string();
+    const auto mainUri = "file://" + mainPath.string();
+    appendMessage(input, std::string(R"({"jsonrpc":"2.0","id":1,"method":"initialize","params":{"rootUri":")") +
+                         rootUri + R"(","workspaceFolders":[{"uri":")" + rootUri + R"(","name":"snapshots"}]}})");
+    appendMessage(input, R"({"jsonrpc":"2.0","method":"initialized","params":{}})");
+    appendMessage(input, std::string(R"({"jsonrpc":"2.0","method":"textDocument/didOpen","params":{"textDocument":{"uri":")") +
+                         mainUri + R"(","languageId":"starbytes","version":1,"text":")" + jsonEscape(text) + R"("}}})");
+    appendMessage(input, std::string(R"({"jsonrpc":"2.0","id":2,"method":"textDocument/diagnostic","params":{"textDocument":{"uri":")") +
+                         mainUri + R"("}}})");
+    appendMessage(input, R"({"jsonrpc":"2.0","id":3,"method":"shutdown","params":null})");
+    appendMessage(input, R"({"jsonrpc":"2.0","method":"exit"})");
+
+    starbytes::lsp::ServerOptions opts{input, output};
+    starbytes::lsp::Server server(opts);
+    server.run();
+
+    std::vector<rapidjson::Document> messages;
+    return parseLspOutputMessages(output.str(), messages) && findResponseById(messages, 2) != nullptr;
+}
+
+std::set<std::string> listSnapshots(const std::filesystem::path &dir) {
+    std::set<std::string> names;
+    std::error_code ec;
+    for(std::filesystem::directory_iterator it(dir, ec), end; !ec && it != end; it.increment(ec)) {
+        names.insert(it->path().filename().string());
+    }
+    return names;
+}
+
+/// A closed interface file's snapshot must be rebuilt when a module it imports changes, and the
+/// snapshot it replaces must not be left behind.
+bool checkSnapshotsFollowImports() {
+    auto root = std::filesystem::temp_directory_path() / "lsp-snapshot-imports";
+    std::error_code ec;
+    std::filesystem::remove_all(root, ec);
+    const auto mainPath = root / "main.starb";
+    const std::string mainText = "import Wrap\nWrap.wrapValue()\n";
+    const auto snapshotDir = root / ".starbytes" / ".cache" / "lsp_symbol_snapshots.v1";
+    writeFile(root / "Base" / "Base.starbint", "func baseValue() Int\n");
+    writeFile(root / "Wrap" / "Wrap.starbint", "import Base\nfunc wrapValue() Int\n");
+
+    if(!ensure(diagnoseInWorkspace(root, mainPath, mainText), "missing diagnostics for the snapshot workspace")) {
+        return false;
+    }
+    auto first = listSnapshots(snapshotDir);
+    if(!ensure(first.size() == 2, "expected one snapshot each for Wrap and Base")) {
+        return false;
+    }
+    if(!ensure(diagnoseInWorkspace(root, mainPath, mainText), "missing diagnostics for the unchanged workspace")) {
+        return false;
+    }
+    if(!ensure(listSnapshots(snapshotDir) == first, "unchanged interfaces should reuse their snapshots")) {
+        return false;
+    }
+
+    writeFile(root / "Base" / "Base.starbint", "func baseValue() Int\nfunc otherValue() Int\n");
+    if(!ensure(diagnoseInWorkspace(root, mainPath, mainText), "missing diagnostics after changing Base")) {
+        return false;
+    }
+    auto second = listSnapshots(snapshotDir);
+    if(!ensure(second.size() == 2, "superseded snapshots should be pruned")) {
+        return false;
+    }
+    for(const auto &name : second) {
+        if(!ensure(first.count(name) == 0, "a snapshot importing the changed module was reused")) {
+            return false;
+        }
+    }
+    std::filesystem::remove_all(root, ec);
+    return true;
+}
+
 int main(int argc, char *argv[]) {
     (void)argc;
     (void)argv;
@@ -232,6 +317,13 @@ int main(int argc, char *argv[]) {
                          uri + R"("}}})");
     appendMessage(input, std::string(R"({"jsonrpc":"2.0","id":104,"method":"textDocument/semanticTokens/full","params":{"textDocument":{"uri":")") +
                          uri + R"("}}})");
+    appendMessage(input, std::string(R"({"jsonrpc":"2.0","method":"textDocument/didChange","params":{"textDocument":{"uri":")") + uri +
+                         R"(","version":3},"contentChanges":[{"range":{"start":{"line":3,"character":2},"end":{"line":3,"character":14}},"text":")" +
+                         jsonEscape("decl c:Int = a + b\n  return c") + R"("}]}})");
+    appendMessage(input, std::string(R"({"jsonrpc":"2.0","id":106,"method":"textDocument/semanticTokens/full/delta","params":{"textDocument":{"uri":")") +
+                         uri + R"("},"previousResultId":"2"}})");
+    appendMessage(input, std::string(R"({"jsonrpc":"2.0","id":107,"method":"textDocument/semanticTokens/full","params":{"textDocument":{"uri":")") +
+                         uri + R"("}}})");
     appendMessage(input, std::string(R"({"jsonrpc":"2.0","method":"textDocument/didOpen","params":{"textDocument":{"uri":")") +
                          timeUri + R"(","languageId":"starbytes","version":1,"text":")" + jsonEscape(timeText) + R"("}}})");
     appendMessage(input, std::string(R"({"jsonrpc":"2.0","id":105,"method":"textDocument/semanticTokens/full","params":{"textDocument":{"uri":")") +
@@ -306,6 +398,47 @@ int main(int argc, char *argv[]) {
         return 1;
     }
 
+    // A body edit is sent back as one edit covering only the changed tokens, which must reproduce a full response.
+    if(!ensure((*validTokens)["result"].HasMember("resultId") && std::string((*validTokens)["result"]["resultId"].GetString()) == "2",
+               "delta test expects the post-edit semantic token result id to be 2")) {
+        return 1;
+    }
+    auto deltaTokens = findResponseById(messages, 106);
+    auto editedTokens = findResponseById(messages, 107);
+    if(!ensure(deltaTokens != nullptr && editedTokens != nullptr, "missing semantic token delta responses")) {
+        return 1;
+    }
+    const auto &deltaResult = (*deltaTokens)["result"];
+    if(!ensure(deltaResult.IsObject() && deltaResult.HasMember("edits") && deltaResult["edits"].IsArray() &&
+               deltaResult["edits"].Size() == 1, "body edit should produce a single semantic token edit")) {
+        return 1;
+    }
+    const auto &edit = deltaResult["edits"][0];
+    auto editStart = edit["start"].GetUint();
+    auto deleteCount = edit["deleteCount"].GetUint();
+    std::vector<unsigned> insertData;
+    for(const auto &item : edit["data"].GetArray()) {
+        insertData.push_back(item.GetUint());
+    }
+    if(!ensure(editStart > 0 && deleteCount + insertData.size() < validData.size(),
+               "semantic token delta should be limited to the edited declaration")) {
+        return 1;
+    }
+    auto patchedData = validData;
+    if(!ensure(editStart + deleteCount <= patchedData.size(), "semantic token delta is out of range")) {
+        return 1;
+    }
+    patchedData.erase(patchedData.begin() + editStart, patchedData.begin() + editStart + deleteCount);
+    patchedData.insert(patchedData.begin() + editStart, insertData.begin(), insertData.end());
+    auto editedData = readSemanticData(*editedTokens);
+    if(!ensure(patchedData == editedData, "applying the semantic token delta should match a full response")) {
+        return 1;
+    }
+    if(!ensure(hasSemanticToken(decodeSemanticData(editedData), 7, 0, 6, 0),
+               "tokens after the edited declaration should move down one line")) {
+        return 1;
+    }
+
     auto timeTokens = findResponseById(messages, 105);
     if(!ensure(timeTokens != nullptr, "missing stdlib semantic token response")) {
         return 1;
@@ -320,5 +453,9 @@ int main(int argc, char *argv[]) {
         return 1;
     }
 
+    if(!checkSnapshotsFollowImports()) {
+        return 1;
+    }
+
     return 0;
 }
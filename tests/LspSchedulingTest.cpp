@@ -0,0 +1,142 @@
+#include "../tools/lsp/AnalysisScheduler.h"
+#include "../tools/lsp/MessageQueue.h"
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using starbytes::lsp::AnalysisResult;
+using starbytes::lsp::AnalysisScheduler;
+using starbytes::lsp::AnalysisSnapshot;
+using starbytes::lsp::MessagePriority;
+using starbytes::lsp::MessageQueue;
+using starbytes::lsp::QueuedMessage;
+
+int fail(const char *message) {
+    std::cerr << "LspSchedulingTest failure: " << message << '\n';
+    return 1;
+}
+
+std::unique_ptr<rapidjson::Document> makeMessage(const std::string &method) {
+    auto doc = std::make_unique<rapidjson::Document>(rapidjson::kObjectType);
+    doc->AddMember("method", rapidjson::Value(method.c_str(), doc->GetAllocator()), doc->GetAllocator());
+    return doc;
+}
+
+std::string popMethod(MessageQueue &queue) {
+    QueuedMessage message;
+    if(!queue.pop(message)) {
+        return {};
+    }
+    return (*message.document)["method"].GetString();
+}
+
+AnalysisSnapshot makeSnapshot(const std::string &uri, int version) {
+    AnalysisSnapshot snapshot;
+    snapshot.uri = uri;
+    snapshot.version = version;
+    snapshot.text = std::make_shared<const std::string>("decl value = " + std::to_string(version) + "\n");
+    return snapshot;
+}
+
+}
+
+int main() {
+    {
+        MessageQueue queue;
+        auto push = [&](const std::string &method, bool isRequest) {
+            queue.push(makeMessage(method),
+                       starbytes::lsp::messagePriorityForMethod(method),
+                       starbytes::lsp::messageIsBarrier(method, isRequest));
+        };
+        push("textDocument/semanticTokens/full", true);
+        push("textDocument/completion", true);
+        push("textDocument/didChange", false);
+        push("workspace/symbol", true);
+        push("textDocument/hover", true);
+        queue.close();
+
+        std::vector<std::string> order;
+        for(std::string method = popMethod(queue); !method.empty(); method = popMethod(queue)) {
+            order.push_back(method);
+        }
+        const std::vector<std::string> expected = {
+            "textDocument/completion",
+            "textDocument/semanticTokens/full",
+            "textDocument/didChange",
+            "textDocument/hover",
+            "workspace/symbol"};
+        if(order != expected) {
+            return fail("requests were reordered across a document sync barrier");
+        }
+    }
+
+    {
+        std::mutex publishedMutex;
+        std::vector<int> published;
+        std::atomic<int> analyzed{0};
+        std::atomic<bool> releaseFirst{false};
+        AnalysisScheduler scheduler(
+            2,
+            std::chrono::milliseconds(20),
+            [&](const AnalysisSnapshot &snapshot, const AnalysisScheduler::IsStale &isStale, AnalysisResult &resultOut) {
+                ++analyzed;
+                if(snapshot.version == 1) {
+                    while(!releaseFirst.load()) {
+                        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                    }
+                }
+                resultOut.uri = snapshot.uri;
+                resultOut.version = snapshot.version;
+                return !isStale();
+            },
+            [&](const AnalysisResult &result) {
+                std::lock_guard<std::mutex> lock(publishedMutex);
+                published.push_back(result.version);
+            });
+
+        scheduler.schedule(makeSnapshot("file:///a.starb", 1), true);
+        while(analyzed.load() == 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        // Version 1 is running; these edits supersede it and coalesce into one pending snapshot.
+        for(int version = 2; version <= 6; ++version) {
+            scheduler.schedule(makeSnapshot("file:///a.starb", version), false);
+        }
+        releaseFirst.store(true);
+        scheduler.flush();
+
+        if(published != std::vector<int>{6}) {
+            return fail("stale or coalesced analysis results were published");
+        }
+        if(analyzed.load() != 2) {
+            return fail("debounced edits were not coalesced into a single analysis");
+        }
+        auto stats = scheduler.stats();
+        if(stats.coalesced != 4 || stats.completed != 1 || stats.dropped != 1) {
+            return fail("scheduler statistics do not match the coalesced run");
+        }
+        auto completed = scheduler.takeCompleted();
+        if(completed.size() != 1 || completed.front().version != 6) {
+            return fail("completed results were not handed back to the dispatch thread");
+        }
+
+        scheduler.schedule(makeSnapshot("file:///b.starb", 1), false);
+        bool publishedEmpty = false;
+        scheduler.cancel("file:///b.starb", [&] { publishedEmpty = true; });
+        scheduler.flush();
+        if(!publishedEmpty || published.size() != 1) {
+            return fail("cancelled document still published diagnostics");
+        }
+        scheduler.stop();
+    }
+
+    return 0;
+}
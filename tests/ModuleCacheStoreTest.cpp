@@ -0,0 +1,145 @@
+#include "../tools/driver/cache/ModuleCacheStore.h"
+
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+namespace {
+
+using starbytes::driver::cache::CacheRecordReader;
+using starbytes::driver::cache::CacheRecordWriter;
+using starbytes::driver::cache::ModuleCacheStore;
+
+constexpr uint32_t kTestTag = 0x54455354;
+
+int fail(const char *message) {
+    std::cerr << "ModuleCacheStoreTest failure: " << message << '\n';
+    return 1;
+}
+
+bool hasValue(const ModuleCacheStore &store, const std::string &key, const std::string &expected) {
+    auto value = store.find(key);
+    return value.has_value() && *value == expected;
+}
+
+}
+
+int main() {
+    auto root = std::filesystem::temp_directory_path() / "starbytes-module-cache-store-test";
+    std::error_code ec;
+    std::filesystem::remove_all(root, ec);
+    auto cachePath = root / "cache.bin";
+
+    CacheRecordWriter writer;
+    writer.writeU64(42);
+    writer.writeString("segment");
+    auto record = writer.take();
+    CacheRecordReader reader(record);
+    uint64_t number = 0;
+    std::string text;
+    if(!reader.readU64(number) || !reader.readString(text) || !reader.atEnd() || number != 42 || text != "segment") {
+        return fail("record round trip failed");
+    }
+
+    std::string warning;
+    std::string error;
+    {
+        ModuleCacheStore store;
+        store.open(cachePath, kTestTag, warning);
+        for(int i = 0; i < 200; ++i) {
+            store.put("key" + std::to_string(i), "value" + std::to_string(i));
+        }
+        if(!store.flush(error)) {
+            return fail(error.c_str());
+        }
+        if(store.indexedEntryCount() != 200 || store.logEntryCount() != 0) {
+            return fail("first flush should compact into the sorted index");
+        }
+    }
+
+    {
+        ModuleCacheStore store;
+        store.open(cachePath, kTestTag, warning);
+        if(!hasValue(store, "key0", "value0") || !hasValue(store, "key199", "value199") || store.find("missing")) {
+            return fail("indexed lookup returned wrong data");
+        }
+        store.put("key5", "changed");
+        store.erase("key6");
+        if(!store.flush(error)) {
+            return fail(error.c_str());
+        }
+        if(store.indexedEntryCount() != 200 || store.logEntryCount() != 2) {
+            return fail("small update should append to the log");
+        }
+    }
+
+    {
+        std::ofstream torn(cachePath, std::ios::out | std::ios::binary | std::ios::app);
+        torn.write("\x05\x00\x00", 3);
+    }
+
+    {
+        ModuleCacheStore store;
+        store.open(cachePath, kTestTag, warning);
+        if(!hasValue(store, "key5", "changed") || store.find("key6") || !hasValue(store, "key7", "value7")) {
+            return fail("log replay returned wrong data");
+        }
+        store.put("key8", "after-torn-write");
+        if(!store.flush(error)) {
+            return fail(error.c_str());
+        }
+        if(!hasValue(store, "key8", "after-torn-write")) {
+            return fail("append after a torn record was lost");
+        }
+        if(!store.flush(error, [](std::string_view key, std::string_view) { return key != "key9"; }, true)) {
+            return fail(error.c_str());
+        }
+        if(store.logEntryCount() != 0 || store.find("key9") || !hasValue(store, "key5", "changed")) {
+            return fail("forced compaction did not merge the log");
+        }
+        store.put("key10", "rejected");
+        store.put("key11", "accepted");
+        if(!store.flush(error, [](std::string_view key, std::string_view) { return key != "key10"; })) {
+            return fail(error.c_str());
+        }
+        if(store.logEntryCount() != 2 || store.find("key10") || !hasValue(store, "key11", "accepted")) {
+            return fail("appended flush should apply the keep filter");
+        }
+    }
+
+    {
+        ModuleCacheStore store;
+        store.open(cachePath, kTestTag + 1, warning);
+        if(warning.empty() || store.find("key0")) {
+            return fail("cache with a different format tag should be ignored");
+        }
+    }
+
+    {
+        auto blockedPath = root / "blocked.bin";
+        ModuleCacheStore store;
+        store.open(blockedPath, kTestTag, warning);
+        store.put("kept", "pending");
+        // A non-empty directory in the cache file's place makes every write fail.
+        std::filesystem::create_directories(blockedPath / "occupied", ec);
+        if(store.flush(error)) {
+            return fail("flush into a directory should fail");
+        }
+        if(!store.hasPendingWrites() || !hasValue(store, "kept", "pending")) {
+            return fail("failed flush dropped its pending entries");
+        }
+        std::filesystem::remove_all(blockedPath, ec);
+        if(!store.flush(error)) {
+            return fail(error.c_str());
+        }
+        ModuleCacheStore reopened;
+        reopened.open(blockedPath, kTestTag, warning);
+        if(!hasValue(reopened, "kept", "pending")) {
+            return fail("retried flush did not persist the pending entries");
+        }
+    }
+
+    std::filesystem::remove_all(root, ec);
+    return 0;
+}
@@ -0,0 +1,347 @@
+#include "../tools/driver/cache/SharedArtifactStore.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#ifndef _WIN32
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+using starbytes::driver::cache::SharedArtifact;
+using starbytes::driver::cache::SharedArtifactStore;
+using starbytes::driver::cache::SharedArtifactStoreOptions;
+
+int fail(const char *message) {
+    std::cerr << "SharedArtifactStoreTest failure: " << message << '\n';
+    return 1;
+}
+
+void writeFile(const std::filesystem::path &path, const std::string &bytes) {
+    std::filesystem::create_directories(path.parent_path());
+    std::ofstream out(path, std::ios::out | std::ios::binary | std::ios::trunc);
+    out << bytes;
+}
+
+std::string readFile(const std::filesystem::path &path) {
+    std::ifstream in(path, std::ios::in | std::ios::binary);
+    std::ostringstream buffer;
+    buffer << in.rdbuf();
+    return buffer.str();
+}
+
+/// Publishes through `remoteUrl` alone and fetches the entry back.
+int remoteRoundTrip(const std::string &remoteUrl,const std::filesystem::path &root,const std::string &actionKey) {
+    SharedArtifactStoreOptions options;
+    options.remoteUrl = remoteUrl;
+    SharedArtifactStore store(options);
+    auto workspace = root / "remote-workspace";
+    writeFile(workspace / "remote.segment",std::string(100000,'r') + "segment-tail");
+    if(!store.publish(actionKey,{{"segment",workspace / "remote.segment"}})) {
+        return fail("remote publish failed");
+    }
+    auto fetched = store.fetch(actionKey,workspace,"fetched");
+    if(!fetched || readFile(workspace / "fetched.segment") != readFile(workspace / "remote.segment")) {
+        return fail("remote fetch returned wrong contents");
+    }
+    return 0;
+}
+
+#ifndef _WIN32
+
+enum class ResponseFraming {
+    ContentLength,
+    Chunked,
+    Truncated
+};
+
+/// In-process stand-in for the HTTP store. GET responses use `framing`: `ContentLength` follows
+/// the body with stray bytes and keeps the connection open until the client hangs up, `Chunked`
+/// splits the body into small chunks with an extension and a trailer, and `Truncated` closes the
+/// connection before the advertised length arrives.
+class LoopbackObjectServer {
+    int listenFd = -1;
+    std::thread worker;
+    std::atomic<bool> stopping{false};
+public:
+    std::mutex objectsMutex;
+    std::map<std::string,std::string> objects;
+    std::atomic<ResponseFraming> framing{ResponseFraming::ContentLength};
+    int port = 0;
+
+    bool start() {
+        listenFd = socket(AF_INET,SOCK_STREAM,0);
+        if(listenFd < 0) {
+            return false;
+        }
+        sockaddr_in address;
+        std::memset(&address,0,sizeof(address));
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        socklen_t length = sizeof(address);
+        if(bind(listenFd,reinterpret_cast<sockaddr *>(&address),length) != 0 || listen(listenFd,8) != 0 ||
+           getsockname(listenFd,reinterpret_cast<sockaddr *>(&address),&length) != 0) {
+            return false;
+        }
+        port = ntohs(address.sin_port);
+        worker = std::thread([this]() {
+            while(!stopping.load()) {
+                int client = accept(listenFd,nullptr,nullptr);
+                if(client < 0) {
+                    continue;
+                }
+                serve(client);
+                ::close(client);
+            }
+        });
+        return true;
+    }
+
+    void stop() {
+        stopping.store(true);
+        // Wake the accept loop with one last connection.
+        int wake = socket(AF_INET,SOCK_STREAM,0);
+        sockaddr_in address;
+        std::memset(&address,0,sizeof(address));
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        address.sin_port = htons(static_cast<uint16_t>(port));
+        connect(wake,reinterpret_cast<sockaddr *>(&address),sizeof(address));
+        ::close(wake);
+        if(worker.joinable()) {
+            worker.join();
+        }
+        ::close(listenFd);
+    }
+
+private:
+    static void sendAll(int fd,const std::string &bytes) {
+        size_t sent = 0;
+        while(sent < bytes.size()) {
+            auto chunk = send(fd,bytes.data() + sent,bytes.size() - sent,MSG_NOSIGNAL);
+            if(chunk <= 0) {
+                return;
+            }
+            sent += static_cast<size_t>(chunk);
+        }
+    }
+
+    void serve(int client) {
+        timeval timeout{10,0};
+        setsockopt(client,SOL_SOCKET,SO_RCVTIMEO,&timeout,sizeof(timeout));
+        std::string request;
+        char buffer[16 * 1024];
+        size_t headerEnd = std::string::npos;
+        while((headerEnd = request.find("\r\n\r\n")) == std::string::npos) {
+            auto received = recv(client,buffer,sizeof(buffer),0);
+            if(received <= 0) {
+                return;
+            }
+            request.append(buffer,static_cast<size_t>(received));
+        }
+        std::istringstream head(request.substr(0,headerEnd));
+        std::string method;
+        std::string path;
+        head >> method >> path;
+        size_t contentLength = 0;
+        auto lengthPos = request.find("Content-Length: ");
+        if(lengthPos != std::string::npos && lengthPos < headerEnd) {
+            contentLength = std::stoul(request.substr(lengthPos + 16));
+        }
+        while(request.size() - (headerEnd + 4) < contentLength) {
+            auto received = recv(client,buffer,sizeof(buffer),0);
+            if(received <= 0) {
+                return;
+            }
+            request.append(buffer,static_cast<size_t>(received));
+        }
+
+        std::lock_guard<std::mutex> lock(objectsMutex);
+        if(method == "PUT") {
+            objects[path] = request.substr(headerEnd + 4,contentLength);
+            sendAll(client,"HTTP/1.1 201 Created\r\nContent-Length: 0\r\n\r\n");
+            return;
+        }
+        auto objectIt = objects.find(path);
+        if(objectIt == objects.end()) {
+            sendAll(client,"HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\n\r\n");
+            return;
+        }
+        const auto &body = objectIt->second;
+        switch(framing.load()) {
+            case ResponseFraming::ContentLength:
+                sendAll(client,"HTTP/1.1 200 OK\r\ncontent-length: " + std::to_string(body.size()) + "\r\n\r\n" + body + "stray");
+                while(recv(client,buffer,sizeof(buffer),0) > 0) {}
+                break;
+            case ResponseFraming::Chunked: {
+                std::string response = "HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n";
+                for(size_t offset = 0; offset < body.size(); offset += 7000) {
+                    auto piece = body.substr(offset,7000);
+                    std::ostringstream size;
+                    size << std::hex << piece.size();
+                    response += size.str() + (offset == 0 ? ";ext=1" : "") + "\r\n" + piece + "\r\n";
+                }
+                response += "0\r\nX-Trailer: done\r\n\r\n";
+                sendAll(client,response);
+                break;
+            }
+            case ResponseFraming::Truncated:
+                sendAll(client,"HTTP/1.1 200 OK\r\nContent-Length: " + std::to_string(body.size() + 10) + "\r\n\r\n" + body);
+                break;
+        }
+    }
+};
+
+int runLoopbackChecks(const std::filesystem::path &root) {
+    LoopbackObjectServer server;
+    if(!server.start()) {
+        return fail("loopback server failed to start");
+    }
+    auto remoteUrl = "http://127.0.0.1:" + std::to_string(server.port) + "/store";
+    int result = remoteRoundTrip(remoteUrl,root,"remote-action");
+
+    SharedArtifactStoreOptions options;
+    options.remoteUrl = remoteUrl;
+    SharedArtifactStore store(options);
+    auto workspace = root / "remote-workspace";
+    auto expected = readFile(workspace / "remote.segment");
+    if(result == 0) {
+        server.framing.store(ResponseFraming::Chunked);
+        if(!store.fetch("remote-action",workspace,"chunked") || readFile(workspace / "chunked.segment") != expected) {
+            result = fail("chunked response body was not decoded");
+        }
+    }
+    if(result == 0) {
+        server.framing.store(ResponseFraming::Truncated);
+        if(store.fetch("remote-action",workspace,"truncated")) {
+            result = fail("truncated response should not be accepted");
+        }
+    }
+    if(result == 0) {
+        server.framing.store(ResponseFraming::ContentLength);
+        std::lock_guard<std::mutex> lock(server.objectsMutex);
+        auto blobHash = SharedArtifactStore::hashBytes(expected);
+        server.objects["/store/cas/" + blobHash.substr(0,2) + "/" + blobHash] = "tampered";
+        auto manifest = std::string("STARBYTES_ARTIFACT_MANIFEST_V2\n../escape ") + blobHash + " 8\n";
+        server.objects["/store/ac/ev/evil-action"] = manifest;
+    }
+    if(result == 0 && store.fetch("remote-action",workspace,"tampered")) {
+        result = fail("blob that does not match its hash should not be accepted");
+    }
+    if(result == 0 && (store.fetch("evil-action",workspace,"evil") || std::filesystem::exists(root / "escape"))) {
+        result = fail("manifest with an unsafe role should be rejected");
+    }
+    server.stop();
+    return result;
+}
+
+#endif
+
+}
+
+int main(int argc,char **argv) {
+    auto root = std::filesystem::temp_directory_path() / "starbytes-shared-artifact-store-test";
+    std::error_code ec;
+    std::filesystem::remove_all(root, ec);
+
+    SharedArtifactStoreOptions options;
+    options.localRoot = root / "store";
+    SharedArtifactStore store(options);
+    if(!store.enabled()) {
+        return fail("store with a local root should be enabled");
+    }
+    if(SharedArtifactStore::hashBytes("abc") != "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad") {
+        return fail("content hash should be SHA-256");
+    }
+
+    auto workspaceA = root / "workspace-a";
+    writeFile(workspaceA / "mod.segment", "segment-bytes");
+    writeFile(workspaceA / "mod.starbsymtb", "symbol-bytes");
+    if(!store.publish("action-one", {{"segment", workspaceA / "mod.segment"}, {"starbsymtb", workspaceA / "mod.starbsymtb"}})) {
+        return fail("publish failed");
+    }
+    if(store.fetch("action-missing", root / "workspace-b", "mod")) {
+        return fail("unknown action key should miss");
+    }
+
+    auto workspaceB = root / "workspace-b";
+    std::filesystem::create_directories(workspaceB);
+    auto fetched = store.fetch("action-one", workspaceB, "other");
+    if(!fetched || fetched->size() != 2) {
+        return fail("published action should be fetched");
+    }
+    if(readFile(workspaceB / "other.segment") != "segment-bytes" || readFile(workspaceB / "other.starbsymtb") != "symbol-bytes") {
+        return fail("fetched artifacts have wrong contents");
+    }
+    if(std::filesystem::hard_link_count(workspaceB / "other.segment", ec) < 2) {
+        return fail("fetched artifacts should be hard links into the store");
+    }
+
+    auto stats = store.stats();
+    if(stats.hits != 1 || stats.misses != 1 || stats.published != 1) {
+        return fail("store statistics are wrong");
+    }
+
+    writeFile(workspaceA / "big.segment", std::string(4096, 'x'));
+    if(!store.publish("action-two", {{"segment", workspaceA / "big.segment"}})) {
+        return fail("second publish failed");
+    }
+    // Filesystem timestamps are coarse; age the first manifest explicitly so LRU order is deterministic.
+    std::filesystem::last_write_time(options.localRoot / "ac" / "ac" / "action-one",
+                                     std::filesystem::file_time_type::clock::now() - std::chrono::hours(1), ec);
+    options.maxBytes = 4096;
+    SharedArtifactStore cappedStore(options);
+    cappedStore.enforceSizeLimit();
+    if(cappedStore.stats().evicted != 1) {
+        return fail("oldest entry should be evicted above the size cap");
+    }
+    if(cappedStore.fetch("action-one", workspaceB, "again") || !cappedStore.fetch("action-two", workspaceB, "again")) {
+        return fail("eviction removed the wrong entry");
+    }
+
+    // A blob without a manifest may belong to a publish in progress until it outlives the grace period.
+    SharedArtifactStoreOptions orphanOptions;
+    orphanOptions.localRoot = root / "orphan-store";
+    orphanOptions.maxBytes = 16;
+    auto orphanBlob = orphanOptions.localRoot / "cas" / "or" / "orphan-blob";
+    writeFile(orphanBlob, std::string(64, 'o'));
+    SharedArtifactStore orphanStore(orphanOptions);
+    orphanStore.enforceSizeLimit();
+    if(!std::filesystem::exists(orphanBlob, ec)) {
+        return fail("a fresh blob without a manifest should survive the size sweep");
+    }
+    std::filesystem::last_write_time(orphanBlob, std::filesystem::file_time_type::clock::now() - std::chrono::hours(1), ec);
+    orphanStore.enforceSizeLimit();
+    if(std::filesystem::exists(orphanBlob, ec)) {
+        return fail("an old blob without a manifest should be removed above the size cap");
+    }
+
+#ifndef _WIN32
+    if(int result = runLoopbackChecks(root)) {
+        return result;
+    }
+#endif
+    // An external store (tools/driver/cache/artifact_store_server.py in the full suite) may be passed by URL.
+    if(argc > 1) {
+        if(int result = remoteRoundTrip(argv[1],root,"external-action")) {
+            return result;
+        }
+    }
+
+    std::filesystem::remove_all(root, ec);
+    return 0;
+}
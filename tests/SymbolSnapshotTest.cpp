@@ -0,0 +1,176 @@
+#include "starbytes/compiler/SymTable.h"
+
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+
+namespace {
+
+int fail(const char *message) {
+    std::cerr << "SymbolSnapshotTest failure: " << message << '\n';
+    return 1;
+}
+
+}
+
+int main() {
+    using namespace starbytes;
+    using Table = Semantics::SymbolTable;
+
+    Table table;
+    table.importModule("IO");
+    std::shared_ptr<ASTScope> namespaceScope(new ASTScope{"Net", ASTScope::Namespace, ASTScopeGlobal});
+    std::shared_ptr<ASTScope> functionScope(new ASTScope{"connect", ASTScope::Function, namespaceScope});
+
+    auto *scopeEntry = table.allocate<Table::Entry>();
+    scopeEntry->name = "Net";
+    scopeEntry->emittedName = "Net";
+    scopeEntry->type = Table::Entry::Scope;
+    scopeEntry->data = table.allocate<std::shared_ptr<ASTScope>>(namespaceScope);
+    table.addSymbolInScope(scopeEntry, ASTScopeGlobal);
+
+    auto *arrayOfString = ASTType::Create("Array", nullptr, false);
+    arrayOfString->addTypeParam(STRING_TYPE);
+    auto *optionalInt = ASTType::Create("Int", nullptr, false);
+    optionalInt->isOptional = true;
+
+    auto *function = table.allocate<Table::Function>();
+    function->name = "connect";
+    function->funcType = FUNCTION_TYPE;
+    function->returnType = optionalInt;
+    function->orderedParams = {{"host", STRING_TYPE}, {"args", arrayOfString}};
+    for(auto &param : function->orderedParams) {
+        function->paramMap.insert(param);
+    }
+    function->isDeprecated = true;
+    function->deprecationMessage = "use open";
+    auto *functionEntry = table.allocate<Table::Entry>();
+    functionEntry->name = "connect";
+    functionEntry->emittedName = "Net__connect";
+    functionEntry->type = Table::Entry::Function;
+    functionEntry->data = function;
+    functionEntry->interfacePos = Region{4, 12, 30, 12};
+    table.addSymbolInScope(functionEntry, namespaceScope);
+
+    auto *local = table.allocate<Table::Var>();
+    local->name = "socket";
+    local->type = INT_TYPE;
+    auto *localEntry = table.allocate<Table::Entry>();
+    localEntry->name = "socket";
+    localEntry->emittedName = "socket";
+    localEntry->type = Table::Entry::Var;
+    localEntry->data = local;
+    table.addSymbolInScope(localEntry, functionScope);
+
+    auto *field = table.allocate<Table::Var>();
+    field->name = "port";
+    field->type = INT_TYPE;
+    field->isReadonly = true;
+    auto *klass = table.allocate<Table::Class>();
+    klass->classType = ASTType::Create("Endpoint", nullptr, false);
+    Table::GenericParam generic;
+    generic.name = "T";
+    generic.variance = Table::GenericParam::Out;
+    generic.defaultType = ANY_TYPE;
+    klass->genericParams.push_back(generic);
+    klass->fields.push_back(field);
+    klass->instMethods.push_back(function);
+    auto *classEntry = table.allocate<Table::Entry>();
+    classEntry->name = "Endpoint";
+    classEntry->emittedName = "Net__Endpoint";
+    classEntry->type = Table::Entry::Class;
+    classEntry->data = klass;
+    table.addSymbolInScope(classEntry, namespaceScope);
+
+    std::ostringstream out;
+    table.serializePublic(out);
+    auto bytes = out.str();
+
+    auto imported = Table::importPublic(bytes.data(), bytes.size());
+    if(!imported) {
+        return fail("snapshot should import");
+    }
+
+    Semantics::STableContext context;
+    context.main = std::make_unique<Table>();
+    context.otherTables.push_back(imported);
+
+    auto *netEntry = context.findEntryByEmittedNoDiag("Net");
+    if(!netEntry || netEntry->type != Table::Entry::Scope) {
+        return fail("namespace entry missing after import");
+    }
+    auto importedNamespace = *static_cast<std::shared_ptr<ASTScope> *>(netEntry->data);
+    if(importedNamespace->name != "Net" || importedNamespace->parentScope != ASTScopeGlobal) {
+        return fail("namespace scope should be rebuilt under the global scope");
+    }
+
+    auto *connectEntry = context.findEntryByEmittedNoDiag("Net__connect");
+    if(!connectEntry || connectEntry->interfacePos.startLine != 12 || connectEntry->interfacePos.endCol != 30) {
+        return fail("function entry or its region was not restored");
+    }
+    auto *importedFunction = static_cast<Table::Function *>(connectEntry->data);
+    if(importedFunction->funcType != FUNCTION_TYPE || importedFunction->orderedParams.size() != 2 ||
+       importedFunction->orderedParams[0].second != STRING_TYPE) {
+        return fail("builtin types should map back to the shared builtin instances");
+    }
+    auto *argsType = importedFunction->paramMap["args"];
+    if(!argsType || argsType->getName().str() != "Array" || argsType->typeParams.size() != 1 ||
+       argsType->typeParams[0] != STRING_TYPE) {
+        return fail("generic parameter types were not restored");
+    }
+    if(!importedFunction->returnType || !importedFunction->returnType->isOptional ||
+       importedFunction->returnType == INT_TYPE) {
+        return fail("optional types must not collapse into the builtin instance");
+    }
+    if(!importedFunction->isDeprecated || importedFunction->deprecationMessage != "use open") {
+        return fail("deprecation data was not restored");
+    }
+
+    if(context.findEntryByEmittedNoDiag("socket")) {
+        return fail("function locals should not be part of the public snapshot");
+    }
+
+    auto *endpointEntry = context.findEntryByEmittedNoDiag("Net__Endpoint");
+    if(!endpointEntry || endpointEntry->type != Table::Entry::Class) {
+        return fail("class entry missing after import");
+    }
+    auto *importedClass = static_cast<Table::Class *>(endpointEntry->data);
+    if(importedClass->fields.size() != 1 || !importedClass->fields[0]->isReadonly ||
+       importedClass->instMethods.size() != 1 || importedClass->genericParams.size() != 1 ||
+       importedClass->genericParams[0].variance != Table::GenericParam::Out ||
+       importedClass->genericParams[0].defaultType != ANY_TYPE) {
+        return fail("class members were not restored");
+    }
+
+    std::ostringstream roundTrip;
+    imported->serializePublic(roundTrip);
+    if(roundTrip.str() != bytes) {
+        return fail("re-serializing an imported snapshot should be byte-identical");
+    }
+
+    if(Table::importPublic(bytes.data(), bytes.size() - 3)) {
+        return fail("truncated snapshot should be rejected");
+    }
+    auto corrupt = bytes;
+    corrupt[0] = 'X';
+    if(Table::importPublic(corrupt.data(), corrupt.size())) {
+        return fail("snapshot with a bad header should be rejected");
+    }
+
+    auto path = std::filesystem::temp_directory_path() / "starbytes-symbol-snapshot-test.starbsymtb";
+    {
+        std::ofstream file(path, std::ios::out | std::ios::binary | std::ios::trunc);
+        file << bytes;
+    }
+    auto mapped = Table::importPublicFile(path);
+    std::error_code ec;
+    std::filesystem::remove(path, ec);
+    if(!mapped) {
+        return fail("snapshot should import from a mapped file");
+    }
+
+    return 0;
+}
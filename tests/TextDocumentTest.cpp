@@ -0,0 +1,135 @@
+#include "../tools/lsp/TextDocument.h"
+
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <string>
+
+namespace {
+
+using starbytes::lsp::TextDocument;
+
+int fail(const char *message) {
+    std::cerr << "TextDocumentTest failure: " << message << '\n';
+    return 1;
+}
+
+size_t referenceOffset(const std::string &text, unsigned line, unsigned character) {
+    size_t offset = 0;
+    unsigned currentLine = 0;
+    while(offset < text.size() && currentLine < line) {
+        if(text[offset] == '\n') {
+            ++currentLine;
+        }
+        ++offset;
+    }
+    if(currentLine != line) {
+        return text.size();
+    }
+    unsigned currentChar = 0;
+    while(offset < text.size() && text[offset] != '\n' && currentChar < character) {
+        ++offset;
+        ++currentChar;
+    }
+    return offset;
+}
+
+void referencePosition(const std::string &text, size_t offset, unsigned &line, unsigned &character) {
+    line = 0;
+    character = 0;
+    for(size_t i = 0; i < std::min(offset, text.size()); ++i) {
+        if(text[i] == '\n') {
+            ++line;
+            character = 0;
+        } else {
+            ++character;
+        }
+    }
+}
+
+bool matchesReference(const TextDocument &document, const std::string &reference, std::mt19937 &rng) {
+    if(document.text() != reference || document.size() != reference.size() ||
+       document.hash() != TextDocument::hashOf(reference) ||
+       document.lineCount() != static_cast<size_t>(std::count(reference.begin(), reference.end(), '\n')) + 1) {
+        return false;
+    }
+    for(int probe = 0; probe < 8; ++probe) {
+        unsigned line = rng() % (document.lineCount() + 2);
+        unsigned character = rng() % 12;
+        if(document.offsetAt(line, character) != referenceOffset(reference, line, character)) {
+            return false;
+        }
+        size_t offset = rng() % (reference.size() + 3);
+        unsigned expectedLine = 0;
+        unsigned expectedCharacter = 0;
+        unsigned actualLine = 0;
+        unsigned actualCharacter = 0;
+        referencePosition(reference, offset, expectedLine, expectedCharacter);
+        document.positionAt(offset, actualLine, actualCharacter);
+        if(actualLine != expectedLine || actualCharacter != expectedCharacter) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}
+
+int main() {
+    std::mt19937 rng(1234);
+    const std::string alphabet = "abc xyz\n\n{}";
+    auto randomText = [&](size_t maxLength) {
+        std::string text(rng() % (maxLength + 1), ' ');
+        for(auto &c : text) {
+            c = alphabet[rng() % alphabet.size()];
+        }
+        return text;
+    };
+
+    {
+        TextDocument document;
+        if(document.size() != 0 || document.hash() != TextDocument::hashOf("") || document.offsetAt(3, 2) != 0) {
+            return fail("empty document is inconsistent");
+        }
+    }
+
+    {
+        std::string reference = randomText(400);
+        TextDocument document(reference);
+        for(int edit = 0; edit < 6000; ++edit) {
+            size_t start = rng() % (reference.size() + 1);
+            size_t end = std::min(reference.size(), start + rng() % 6);
+            auto replacement = (rng() % 3 == 0) ? std::string() : randomText(5);
+            document.replace(start, end, replacement);
+            reference.replace(start, end - start, replacement);
+            // Reading the text caches a snapshot; check that it is dropped by the next edit.
+            if(edit % 97 == 0 && !matchesReference(document, reference, rng)) {
+                return fail("document diverged from the reference after an edit");
+            }
+            if(document.hash() != TextDocument::hashOf(reference)) {
+                return fail("incremental hash diverged from a full rehash");
+            }
+        }
+        if(!matchesReference(document, reference, rng)) {
+            return fail("document diverged from the reference after many edits");
+        }
+        if(document.pieceCount() > 4097) {
+            return fail("piece count was not bounded");
+        }
+    }
+
+    {
+        TextDocument document("one\ntwo\n");
+        auto before = document.snapshot();
+        document.replace(document.offsetAt(1, 0), document.offsetAt(1, 3), "TWO");
+        if(*before != "one\ntwo\n" || document.text() != "one\nTWO\n") {
+            return fail("snapshots are not immutable across edits");
+        }
+        document.replace(100, 200, "!");
+        if(document.text() != "one\nTWO\n!") {
+            return fail("out-of-range edit bounds were not clamped");
+        }
+    }
+
+    return 0;
+}
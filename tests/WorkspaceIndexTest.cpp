@@ -0,0 +1,176 @@
+#include "../tools/lsp/WorkspaceIndex.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+using starbytes::lsp::IndexedOccurrence;
+using starbytes::lsp::IndexResolution;
+using starbytes::lsp::SymbolEntry;
+using starbytes::lsp::SymbolIdentity;
+using starbytes::lsp::WorkspaceIndex;
+
+int fail(const char *message) {
+    std::cerr << "WorkspaceIndexTest failure: " << message << '\n';
+    return 1;
+}
+
+SymbolEntry makeSymbol(const std::string &name, unsigned line, unsigned start) {
+    SymbolEntry symbol;
+    symbol.name = name;
+    symbol.kind = 12;
+    symbol.line = line;
+    symbol.start = start;
+    symbol.length = static_cast<unsigned>(name.size());
+    return symbol;
+}
+
+void writeU32(std::ofstream &out, uint32_t value) {
+    out.write(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+/// Writes an index with a valid header whose single file claims `symbolCount` symbols, or, when
+/// that is zero, one identifier with `occurrenceCount` occurrences.
+void writeCorruptIndex(const std::filesystem::path &path, uint32_t symbolCount, uint32_t occurrenceCount) {
+    std::ofstream out(path, std::ios::out | std::ios::binary | std::ios::trunc);
+    out.write("SBWIDX01", 8);
+    writeU32(out, 1);
+    writeU32(out, 4);
+    out.write("file", 4);
+    uint64_t textHash = 7;
+    out.write(reinterpret_cast<const char *>(&textHash), sizeof(textHash));
+    writeU32(out, symbolCount);
+    if(symbolCount == 0) {
+        writeU32(out, 1);
+        writeU32(out, 1);
+        out.write("x", 1);
+        writeU32(out, occurrenceCount);
+    }
+}
+
+}
+
+int main() {
+    const std::string helperText = "func computeTotal(a:Int) Int {\n    return a\n}\n";
+    const std::string mainText = "import Helper\ndecl total = computeTotal(1)\ndecl totals = total\n";
+
+    WorkspaceIndex index;
+    index.update("file:///ws/helper.starb", 1, helperText, {makeSymbol("computeTotal", 0, 5)});
+    index.update("file:///ws/main.starb", 2, mainText, {makeSymbol("total", 1, 5), makeSymbol("totals", 2, 5)});
+
+    {
+        auto matches = index.searchSymbols("TOTAL");
+        if(matches.size() != 3 || *matches[0].uri != "file:///ws/helper.starb" || matches[1].symbol->name != "total" ||
+           matches[2].symbol->name != "totals") {
+            return fail("trigram search did not return every case-insensitive substring match in order");
+        }
+        if(index.searchSymbols("ls").size() != 1 || index.searchSymbols("").size() != 3 ||
+           !index.searchSymbols("missing").empty()) {
+            return fail("short, empty, or unmatched queries returned the wrong symbols");
+        }
+    }
+
+    {
+        auto files = index.filesContaining("computeTotal");
+        if(files != std::vector<std::string>{"file:///ws/helper.starb", "file:///ws/main.starb"}) {
+            return fail("identifier postings did not list both files");
+        }
+        if(!index.filesContaining("tot").empty()) {
+            return fail("identifier postings matched a partial identifier");
+        }
+        const auto *occurrences = index.occurrences("file:///ws/main.starb", "total");
+        if(!occurrences || occurrences->size() != 2 || (*occurrences)[1].line != 2 || (*occurrences)[1].character != 14 ||
+           (*occurrences)[1].offset != mainText.find("= total") + 2) {
+            return fail("identifier occurrences have the wrong positions");
+        }
+    }
+
+    unsigned resolverCalls = 0;
+    auto resolveToHelper = [&](const IndexedOccurrence &, SymbolIdentity &identityOut) {
+        ++resolverCalls;
+        identityOut = SymbolIdentity{"file:///ws/helper.starb", 0, 5, 12, 12};
+        return true;
+    };
+
+    {
+        const auto &first = index.resolvedOccurrences("file:///ws/main.starb", "computeTotal", IndexResolution::References,
+                                                      resolveToHelper);
+        if(first.size() != 1 || !first.front().resolved || first.front().identity.uri != "file:///ws/helper.starb") {
+            return fail("resolved occurrences did not record the resolver result");
+        }
+        index.resolvedOccurrences("file:///ws/main.starb", "computeTotal", IndexResolution::References, resolveToHelper);
+        if(resolverCalls != 1) {
+            return fail("cached resolutions were recomputed");
+        }
+        index.resolvedOccurrences("file:///ws/main.starb", "computeTotal", IndexResolution::Rename, resolveToHelper);
+        if(resolverCalls != 2) {
+            return fail("rename resolutions shared the references cache");
+        }
+
+        // A body-only edit keeps the declarations, so other files keep their cached resolutions.
+        index.update("file:///ws/helper.starb", 3, "func computeTotal(a:Int) Int {\n    return a + 1\n}\n",
+                     {makeSymbol("computeTotal", 0, 5)});
+        index.resolvedOccurrences("file:///ws/main.starb", "computeTotal", IndexResolution::References, resolveToHelper);
+        if(resolverCalls != 2) {
+            return fail("a body-only edit invalidated resolutions in other files");
+        }
+
+        index.update("file:///ws/helper.starb", 4, "\nfunc computeTotal(a:Int) Int {\n    return a\n}\n",
+                     {makeSymbol("computeTotal", 1, 5)});
+        index.resolvedOccurrences("file:///ws/main.starb", "computeTotal", IndexResolution::References, resolveToHelper);
+        if(resolverCalls != 3) {
+            return fail("a declaration change did not invalidate dependent resolutions");
+        }
+    }
+
+    {
+        auto indexPath = std::filesystem::temp_directory_path() / "starbytes_workspace_index_test.v1";
+        std::filesystem::remove(indexPath);
+        index.setIndexPath(indexPath);
+        index.save();
+
+        WorkspaceIndex reloaded;
+        reloaded.setIndexPath(indexPath);
+        if(reloaded.adoptPersisted("file:///ws/main.starb", 99)) {
+            return fail("persisted entry was adopted for a different text hash");
+        }
+        if(!reloaded.adoptPersisted("file:///ws/helper.starb", 4)) {
+            return fail("persisted entry was not adopted for a matching text hash");
+        }
+        auto matches = reloaded.searchSymbols("compute");
+        if(matches.size() != 1 || matches.front().symbol->line != 1 ||
+           reloaded.filesContaining("computeTotal") != std::vector<std::string>{"file:///ws/helper.starb"}) {
+            return fail("persisted index did not round-trip");
+        }
+        reloaded.remove("file:///ws/helper.starb");
+        if(!reloaded.searchSymbols("compute").empty() || !reloaded.filesContaining("computeTotal").empty()) {
+            return fail("removed file left postings behind");
+        }
+        std::filesystem::remove(indexPath);
+    }
+
+    {
+        auto indexPath = std::filesystem::temp_directory_path() / "starbytes_workspace_index_corrupt_test.v1";
+        const uint32_t counts[][2] = {{0x7fffffffu, 0}, {0, 0x7fffffffu}, {3, 0}};
+        for(const auto &count : counts) {
+            writeCorruptIndex(indexPath, count[0], count[1]);
+            WorkspaceIndex corrupt;
+            corrupt.setIndexPath(indexPath);
+            if(corrupt.adoptPersisted("file", 7)) {
+                return fail("corrupt persisted index was adopted");
+            }
+            corrupt.update("file:///ws/helper.starb", 1, helperText, {makeSymbol("computeTotal", 0, 5)});
+            if(corrupt.searchSymbols("compute").size() != 1) {
+                return fail("index did not work after discarding a corrupt persisted file");
+            }
+        }
+        std::filesystem::remove(indexPath);
+    }
+
+    return 0;
+}
@@ -0,0 +1,56 @@
+#!/usr/bin/env python3
+"""Keep-alive HTTP/1.1 loopback server for the HTTP client suite tests.
+
+Prints the bound port on the first line of stdout, then serves until killed.
+GET /hello answers "hello", any request with a body echoes it back, and a
+`delay` query parameter (milliseconds) holds the response back.
+"""
+
+import sys
+import time
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+from urllib.parse import parse_qs, urlparse
+
+
+class LoopbackHandler(BaseHTTPRequestHandler):
+    protocol_version = "HTTP/1.1"
+
+    def _respond(self):
+        url = urlparse(self.path)
+        delay = parse_qs(url.query).get("delay", ["0"])[0]
+        if delay.isdigit():
+            time.sleep(int(delay) / 1000.0)
+
+        length = int(self.headers.get("Content-Length") or 0)
+        body = self.rfile.read(length) if length > 0 else b""
+        if not body:
+            body = b"hello" if url.path == "/hello" else f"{self.command} {url.path}".encode()
+
+        self.send_response(200)
+        self.send_header("Content-Type", "text/plain")
+        self.send_header("Content-Length", str(len(body)))
+        self.send_header("X-Echo-Method", self.command)
+        self.end_headers()
+        self.wfile.write(body)
+
+    do_GET = _respond
+    do_POST = _respond
+    do_PUT = _respond
+    do_DELETE = _respond
+
+    def log_message(self, format, *args):
+        pass
+
+
+def main():
+    server = ThreadingHTTPServer(("127.0.0.1", 0), LoopbackHandler)
+    print(server.server_address[1], flush=True)
+    try:
+        server.serve_forever()
+    except KeyboardInterrupt:
+        pass
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -495,6 +495,9 @@ assert_log_contains "cast-downcast-unsecure-check" "Optional or throwable values
 run_expect_success "stdlib-smoke-check" "$STARBYTES_BIN" check "$ROOT_DIR/tests/extreme/stdlib_smoke.starb"
 run_expect_success "stdlib-smoke-run" "$STARBYTES_BIN" run "$ROOT_DIR/tests/extreme/stdlib_smoke.starb"
 assert_log_contains "stdlib-smoke-run" "EXTREME-STDLIB-SMOKE-OK"
+assert_log_contains "stdlib-smoke-run" "FS-WALKER-ORDER-OK"
+assert_log_contains "stdlib-smoke-run" "FS-GLOB-BACKTRACK-OK"
+assert_log_contains "stdlib-smoke-run" "JSON-NULL-ELEMENT-CATCH"
 run_expect_failure "scoped-module-imports-flat-invalid-check" "$STARBYTES_BIN" check "$ROOT_DIR/tests/extreme/scoped_module_imports_flat_invalid.starb"
 assert_log_contains "scoped-module-imports-flat-invalid-check" 'Imported symbol `timezoneUTC` must be referenced with its module name'
 run_expect_success "scoped-module-imports-check" "$STARBYTES_BIN" check "$ROOT_DIR/tests/extreme/scoped_module_imports.starb"
@@ -509,6 +512,56 @@ assert_log_contains "secure-scope-hardening-invalid-check" 'Context: Type `Int`
 run_expect_success "cmdline-module-run" "$STARBYTES_BIN" run "$ROOT_DIR/tests/extreme/cmdline_module.starb" -- --verbose --config "./test.toml" --tag one --tag two positional
 assert_log_contains "cmdline-module-run" "CMDLINE-MODULE-OK"
 
+HTTP_PORT_FILE="$LOG_DIR/http-loopback-port.txt"
+python3 "$ROOT_DIR/tests/extreme/http_loopback_server.py" >"$HTTP_PORT_FILE" &
+HTTP_SERVER_PID=$!
+for _ in $(seq 1 50); do
+  [[ -s "$HTTP_PORT_FILE" ]] && break
+  sleep 0.1
+done
+HTTP_PORT="$(head -n 1 "$HTTP_PORT_FILE")"
+run_expect_success "http-client-check" "$STARBYTES_BIN" check "$ROOT_DIR/tests/extreme/http_client.starb"
+run_expect_success "http-client-run" "$STARBYTES_BIN" run "$ROOT_DIR/tests/extreme/http_client.starb" -- "$HTTP_PORT"
+assert_log_contains "http-client-run" "HTTP-CLIENT-OK"
+kill "$HTTP_SERVER_PID" >/dev/null 2>&1 || true
+wait "$HTTP_SERVER_PID" 2>/dev/null || true
+ARTIFACT_STORE_TEST_BIN="$BUILD_DIR/tests/shared-artifact-store-test"
+if [[ -x "$ARTIFACT_STORE_TEST_BIN" ]]; then
+  ARTIFACT_STORE_ROOT="$(mktemp -d)"
+  ARTIFACT_STORE_URL_FILE="$LOG_DIR/artifact-store-url.txt"
+  python3 "$ROOT_DIR/tools/driver/cache/artifact_store_server.py" "$ARTIFACT_STORE_ROOT" --port 0 >"$ARTIFACT_STORE_URL_FILE" &
+  ARTIFACT_STORE_PID=$!
+  for _ in $(seq 1 50); do
+    [[ -s "$ARTIFACT_STORE_URL_FILE" ]] && break
+    sleep 0.1
+  done
+  ARTIFACT_STORE_URL="$(head -n 1 "$ARTIFACT_STORE_URL_FILE" | sed 's/.* on //')"
+  run_expect_success "artifact-store-server-roundtrip" "$ARTIFACT_STORE_TEST_BIN" "$ARTIFACT_STORE_URL"
+  kill "$ARTIFACT_STORE_PID" >/dev/null 2>&1 || true
+  wait "$ARTIFACT_STORE_PID" 2>/dev/null || true
+  rm -rf "$ARTIFACT_STORE_ROOT"
+fi
+run_expect_success "net-listener-check" "$STARBYTES_BIN" check "$ROOT_DIR/tests/extreme/net_listener.starb"
+run_expect_success "net-listener-run" "$STARBYTES_BIN" run "$ROOT_DIR/tests/extreme/net_listener.starb"
+assert_log_contains "net-listener-run" "NET-LISTENER-OK"
+assert_log_contains "net-listener-run" "NET-READ-WHILE-PENDING-CATCH"
+run_expect_success "process-pool-check" "$STARBYTES_BIN" check "$ROOT_DIR/tests/extreme/process_pool.starb"
+run_expect_success "process-pool-run" "$STARBYTES_BIN" run "$ROOT_DIR/tests/extreme/process_pool.starb"
+assert_log_contains "process-pool-run" "got:hello"
+assert_log_contains "process-pool-run" "env:yes"
+assert_log_contains "process-pool-run" "PROC-POOL-MISSING-CATCH"
+assert_log_not_contains "process-pool-run" "PROC-DROPPED-SPAWN-CATCH"
+assert_log_contains "process-pool-run" "PROC-DROPPED-CHILDREN-OK"
+assert_log_contains "process-pool-run" "PROCESS-POOL-OK"
+
+run_expect_success "threading-pool-check" "$STARBYTES_BIN" check "$ROOT_DIR/tests/extreme/threading_pool.starb"
+run_expect_success "threading-pool-run" "$STARBYTES_BIN" run "$ROOT_DIR/tests/extreme/threading_pool.starb"
+assert_log_contains "threading-pool-run" "d0f4e24bc937a42d7c35a06e3ab0ece44df1870cf613a3b148867f67fce48159"
+assert_log_contains "threading-pool-run" "pool-payload-pool-payload"
+assert_log_contains "threading-pool-run" "TH-PMAP-BAD-OP-CATCH"
+assert_log_contains "threading-pool-run" "TH-POOL-MISSING-CATCH"
+assert_log_contains "threading-pool-run" "THREADING-POOL-OK"
+
 run_expect_success "module-app-check" "$STARBYTES_BIN" check "$ROOT_DIR/tests/extreme/modules/App"
 run_expect_success "module-app-run" "$STARBYTES_BIN" run "$ROOT_DIR/tests/extreme/modules/App"
 assert_log_contains "module-app-run" "APP-MODULE-OK"
@@ -0,0 +1,421 @@
+#include "ModuleCacheStore.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <system_error>
+#include <vector>
+
+namespace {
+
+constexpr char kMagic[8] = {'S','T','B','C','A','C','H','E'};
+constexpr uint32_t kByteOrderMark = 0x01020304u;
+constexpr uint32_t kTombstoneLength = 0xFFFFFFFFu;
+constexpr size_t kMinLogRecordsBeforeCompaction = 64;
+
+struct FileHeader {
+    char magic[8];
+    uint32_t formatVersion;
+    uint32_t formatTag;
+    uint32_t byteOrder;
+    uint32_t reserved;
+    uint64_t indexOffset;
+    uint64_t indexCount;
+};
+
+struct IndexEntry {
+    uint64_t keyOffset;
+    uint64_t valueOffset;
+    uint32_t keyLength;
+    uint32_t valueLength;
+};
+
+struct LogRecordHeader {
+    uint32_t keyLength;
+    uint32_t valueLength;
+};
+
+static_assert(sizeof(FileHeader) == 40,"unexpected cache header padding");
+static_assert(sizeof(IndexEntry) == 24,"unexpected cache index padding");
+static_assert(sizeof(LogRecordHeader) == 8,"unexpected cache log padding");
+
+template<typename T>
+bool readPod(const char *data,size_t size,uint64_t offset,T &out) {
+    if(offset > size || size - offset < sizeof(T)) {
+        return false;
+    }
+    std::memcpy(&out,data + offset,sizeof(T));
+    return true;
+}
+
+bool sliceInBounds(size_t size,uint64_t offset,uint64_t length) {
+    return offset <= size && length <= size - offset;
+}
+
+template<typename T>
+void writePod(std::ostream &out,const T &value) {
+    out.write(reinterpret_cast<const char *>(&value),sizeof(T));
+}
+
+}
+
+namespace starbytes::driver::cache {
+
+void CacheRecordWriter::writeU64(uint64_t value) {
+    bytes.append(reinterpret_cast<const char *>(&value),sizeof(value));
+}
+
+void CacheRecordWriter::writeString(std::string_view value) {
+    writeU64(value.size());
+    bytes.append(value.data(),value.size());
+}
+
+bool CacheRecordReader::readU64(uint64_t &value) {
+    if(bytes.size() - offset < sizeof(value)) {
+        return false;
+    }
+    std::memcpy(&value,bytes.data() + offset,sizeof(value));
+    offset += sizeof(value);
+    return true;
+}
+
+bool CacheRecordReader::readString(std::string &value) {
+    uint64_t length = 0;
+    if(!readU64(length) || bytes.size() - offset < length) {
+        return false;
+    }
+    value.assign(bytes.data() + offset,static_cast<size_t>(length));
+    offset += static_cast<size_t>(length);
+    return true;
+}
+
+ModuleCacheStore::~ModuleCacheStore() {
+    unmapFile();
+}
+
+bool ModuleCacheStore::mapFile(std::string &warning) {
+    if(mapped.open(path)) {
+        return true;
+    }
+    // A missing or empty file opens as an empty store; anything else failed to map.
+    std::error_code sizeErr;
+    auto size = std::filesystem::file_size(path,sizeErr);
+    if(sizeErr || size == 0) {
+        return true;
+    }
+    warning = "Failed to map module cache file: " + path.string();
+    return false;
+}
+
+void ModuleCacheStore::unmapFile() {
+    mapped.close();
+    logEntries.clear();
+}
+
+bool ModuleCacheStore::replayLog(std::string &warning) {
+    uint64_t offset = indexOffset + indexCount * sizeof(IndexEntry);
+    while(offset < mapped.size()) {
+        LogRecordHeader record;
+        if(!readPod(mapped.data(),mapped.size(),offset,record)) {
+            break;
+        }
+        uint64_t keyOffset = offset + sizeof(LogRecordHeader);
+        uint64_t valueLength = record.valueLength == kTombstoneLength ? 0 : record.valueLength;
+        if(!sliceInBounds(mapped.size(),keyOffset,record.keyLength)
+           || !sliceInBounds(mapped.size(),keyOffset + record.keyLength,valueLength)) {
+            break;
+        }
+        std::string key(mapped.data() + keyOffset,record.keyLength);
+        if(record.valueLength == kTombstoneLength) {
+            logEntries[key] = std::nullopt;
+        }
+        else {
+            logEntries[key] = std::string_view(mapped.data() + keyOffset + record.keyLength,record.valueLength);
+        }
+        ++logRecordCount;
+        offset = keyOffset + record.keyLength + valueLength;
+    }
+    validEnd = offset;
+    if(validEnd < mapped.size()) {
+        warning = "Discarding truncated tail of module cache file: " + path.string();
+    }
+    return true;
+}
+
+bool ModuleCacheStore::open(const std::filesystem::path &cachePath,uint32_t tag,std::string &warning) {
+    close();
+    path = cachePath;
+    formatTag = tag;
+
+    if(!mapFile(warning)) {
+        needsRewrite = true;
+        return true;
+    }
+    if(!mapped.isOpen()) {
+        return true;
+    }
+
+    FileHeader header;
+    if(!readPod(mapped.data(),mapped.size(),0,header)
+       || std::memcmp(header.magic,kMagic,sizeof(kMagic)) != 0
+       || header.formatVersion != kFormatVersion
+       || header.byteOrder != kByteOrderMark
+       || header.formatTag != formatTag
+       || header.indexOffset < sizeof(FileHeader)
+       || header.indexCount > (mapped.size() / sizeof(IndexEntry))
+       || !sliceInBounds(mapped.size(),header.indexOffset,header.indexCount * sizeof(IndexEntry))) {
+        warning = "Ignoring incompatible module cache file: " + path.string();
+        unmapFile();
+        needsRewrite = true;
+        return true;
+    }
+
+    indexOffset = header.indexOffset;
+    indexCount = header.indexCount;
+    return replayLog(warning);
+}
+
+void ModuleCacheStore::close() {
+    unmapFile();
+    indexOffset = 0;
+    indexCount = 0;
+    validEnd = 0;
+    logRecordCount = 0;
+    needsRewrite = false;
+    pendingEntries.clear();
+}
+
+std::optional<std::string_view> ModuleCacheStore::findIndexed(std::string_view key) const {
+    uint64_t lo = 0;
+    uint64_t hi = indexCount;
+    while(lo < hi) {
+        uint64_t mid = lo + (hi - lo) / 2;
+        IndexEntry entry;
+        if(!readPod(mapped.data(),mapped.size(),indexOffset + mid * sizeof(IndexEntry),entry)
+           || !sliceInBounds(mapped.size(),entry.keyOffset,entry.keyLength)) {
+            return std::nullopt;
+        }
+        std::string_view entryKey(mapped.data() + entry.keyOffset,entry.keyLength);
+        int cmp = entryKey.compare(key);
+        if(cmp == 0) {
+            if(!sliceInBounds(mapped.size(),entry.valueOffset,entry.valueLength)) {
+                return std::nullopt;
+            }
+            return std::string_view(mapped.data() + entry.valueOffset,entry.valueLength);
+        }
+        if(cmp < 0) {
+            lo = mid + 1;
+        }
+        else {
+            hi = mid;
+        }
+    }
+    return std::nullopt;
+}
+
+std::optional<std::string_view> ModuleCacheStore::find(std::string_view key) const {
+    std::string keyString(key);
+    auto pendingIt = pendingEntries.find(keyString);
+    if(pendingIt != pendingEntries.end()) {
+        if(!pendingIt->second.has_value()) {
+            return std::nullopt;
+        }
+        return std::string_view(*pendingIt->second);
+    }
+    auto logIt = logEntries.find(keyString);
+    if(logIt != logEntries.end()) {
+        return logIt->second;
+    }
+    if(!mapped.isOpen()) {
+        return std::nullopt;
+    }
+    return findIndexed(key);
+}
+
+void ModuleCacheStore::put(const std::string &key,std::string value) {
+    pendingEntries[key] = std::move(value);
+}
+
+void ModuleCacheStore::erase(const std::string &key) {
+    if(find(key).has_value()) {
+        pendingEntries[key] = std::nullopt;
+    }
+}
+
+bool ModuleCacheStore::appendPending(const std::function<bool(std::string_view,std::string_view)> &keep,std::string &error) {
+    unmapFile();
+    std::error_code sizeErr;
+    auto currentSize = std::filesystem::file_size(path,sizeErr);
+    if(!sizeErr && currentSize > validEnd) {
+        std::filesystem::resize_file(path,validEnd,sizeErr);
+        if(sizeErr) {
+            error = "Failed to truncate module cache file '" + path.string() + "': " + sizeErr.message();
+            return false;
+        }
+    }
+
+    std::ofstream out(path,std::ios::out | std::ios::binary | std::ios::app);
+    if(!out.is_open()) {
+        error = "Failed to write module cache file: " + path.string();
+        return false;
+    }
+    for(const auto &pending : pendingEntries) {
+        // A rejected value is logged as a tombstone, so it also hides any older value for the key.
+        bool kept = pending.second.has_value() && (!keep || keep(pending.first,*pending.second));
+        LogRecordHeader record;
+        record.keyLength = static_cast<uint32_t>(pending.first.size());
+        record.valueLength = kept ? static_cast<uint32_t>(pending.second->size()) : kTombstoneLength;
+        writePod(out,record);
+        out.write(pending.first.data(),static_cast<std::streamsize>(pending.first.size()));
+        if(kept) {
+            out.write(pending.second->data(),static_cast<std::streamsize>(pending.second->size()));
+        }
+    }
+    out.flush();
+    if(!out.good()) {
+        error = "Failed to write module cache file: " + path.string();
+        return false;
+    }
+    return true;
+}
+
+bool ModuleCacheStore::compact(const std::function<bool(std::string_view,std::string_view)> &keep,std::string &error) {
+    std::map<std::string,std::string> liveEntries;
+    for(uint64_t i = 0; mapped.isOpen() && i < indexCount; ++i) {
+        IndexEntry entry;
+        if(!readPod(mapped.data(),mapped.size(),indexOffset + i * sizeof(IndexEntry),entry)
+           || !sliceInBounds(mapped.size(),entry.keyOffset,entry.keyLength)
+           || !sliceInBounds(mapped.size(),entry.valueOffset,entry.valueLength)) {
+            continue;
+        }
+        liveEntries[std::string(mapped.data() + entry.keyOffset,entry.keyLength)] =
+            std::string(mapped.data() + entry.valueOffset,entry.valueLength);
+    }
+    for(const auto &logged : logEntries) {
+        if(logged.second.has_value()) {
+            liveEntries[logged.first] = std::string(*logged.second);
+        }
+        else {
+            liveEntries.erase(logged.first);
+        }
+    }
+    // Copied rather than moved so a failed compaction leaves the pending entries for a retry.
+    for(const auto &pending : pendingEntries) {
+        if(pending.second.has_value()) {
+            liveEntries[pending.first] = *pending.second;
+        }
+        else {
+            liveEntries.erase(pending.first);
+        }
+    }
+    unmapFile();
+
+    if(keep) {
+        for(auto it = liveEntries.begin(); it != liveEntries.end();) {
+            if(keep(it->first,it->second)) {
+                ++it;
+            }
+            else {
+                it = liveEntries.erase(it);
+            }
+        }
+    }
+
+    auto parent = path.parent_path();
+    if(!parent.empty()) {
+        std::error_code dirErr;
+        std::filesystem::create_directories(parent,dirErr);
+        if(dirErr) {
+            error = "Failed to create module cache directory '" + parent.string() + "': " + dirErr.message();
+            return false;
+        }
+    }
+
+    FileHeader header;
+    std::memcpy(header.magic,kMagic,sizeof(kMagic));
+    header.formatVersion = kFormatVersion;
+    header.formatTag = formatTag;
+    header.byteOrder = kByteOrderMark;
+    header.reserved = 0;
+    header.indexCount = liveEntries.size();
+    header.indexOffset = sizeof(FileHeader);
+    for(const auto &entry : liveEntries) {
+        header.indexOffset += entry.first.size() + entry.second.size();
+    }
+
+    auto tempPath = path;
+    tempPath += ".tmp";
+    {
+        std::ofstream out(tempPath,std::ios::out | std::ios::binary | std::ios::trunc);
+        if(!out.is_open()) {
+            error = "Failed to write module cache file: " + tempPath.string();
+            return false;
+        }
+        writePod(out,header);
+        std::vector<IndexEntry> index;
+        index.reserve(liveEntries.size());
+        uint64_t offset = sizeof(FileHeader);
+        for(const auto &entry : liveEntries) {
+            IndexEntry indexEntry;
+            indexEntry.keyOffset = offset;
+            indexEntry.keyLength = static_cast<uint32_t>(entry.first.size());
+            indexEntry.valueOffset = offset + entry.first.size();
+            indexEntry.valueLength = static_cast<uint32_t>(entry.second.size());
+            out.write(entry.first.data(),static_cast<std::streamsize>(entry.first.size()));
+            out.write(entry.second.data(),static_cast<std::streamsize>(entry.second.size()));
+            offset += entry.first.size() + entry.second.size();
+            index.push_back(indexEntry);
+        }
+        for(const auto &indexEntry : index) {
+            writePod(out,indexEntry);
+        }
+        out.flush();
+        if(!out.good()) {
+            error = "Failed to write module cache file: " + tempPath.string();
+            return false;
+        }
+    }
+
+    std::error_code renameErr;
+    std::filesystem::rename(tempPath,path,renameErr);
+    if(renameErr) {
+        std::error_code removeErr;
+        std::filesystem::remove(tempPath,removeErr);
+        error = "Failed to replace module cache file '" + path.string() + "': " + renameErr.message();
+        return false;
+    }
+    return true;
+}
+
+bool ModuleCacheStore::flush(std::string &error,
+                             const std::function<bool(std::string_view,std::string_view)> &keep,
+                             bool forceCompaction) {
+    if(pendingEntries.empty() && !forceCompaction && !needsRewrite) {
+        return true;
+    }
+
+    auto compactionThreshold = std::max<size_t>(kMinLogRecordsBeforeCompaction,static_cast<size_t>(indexCount / 4));
+    bool shouldCompact = forceCompaction
+        || needsRewrite
+        || !mapped.isOpen()
+        || logRecordCount + pendingEntries.size() > compactionThreshold;
+
+    bool ok = shouldCompact ? compact(keep,error) : appendPending(keep,error);
+    // Both writers unmap the file, so reopen either way; a failed write keeps its pending
+    // entries so the next flush retries them.
+    decltype(pendingEntries) unwritten;
+    if(!ok) {
+        unwritten = std::move(pendingEntries);
+    }
+    auto reopenPath = path;
+    auto reopenTag = formatTag;
+    std::string reopenWarning;
+    open(reopenPath,reopenTag,reopenWarning);
+    if(!ok) {
+        pendingEntries = std::move(unwritten);
+    }
+    return ok;
+}
+
+}
@@ -0,0 +1,93 @@
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "starbytes/base/MappedFile.h"
+
+#ifndef STARBYTES_DRIVER_CACHE_MODULECACHESTORE_H
+#define STARBYTES_DRIVER_CACHE_MODULECACHESTORE_H
+
+namespace starbytes::driver::cache {
+
+/// Little helpers for encoding cache values as flat byte strings.
+class CacheRecordWriter {
+    std::string bytes;
+public:
+    void writeU64(uint64_t value);
+    void writeString(std::string_view value);
+    std::string take() { return std::move(bytes); }
+};
+
+class CacheRecordReader {
+    std::string_view bytes;
+    size_t offset = 0;
+public:
+    explicit CacheRecordReader(std::string_view bytes):bytes(bytes){}
+    bool readU64(uint64_t &value);
+    bool readString(std::string &value);
+    bool atEnd() const { return offset == bytes.size(); }
+};
+
+/// Versioned binary key/value file used for the driver's module caches.
+///
+/// Layout: header | key/value data | sorted index | append log.
+/// The file is memory mapped and looked up by binary search over the index, so opening it
+/// does not parse the compacted section. Updates are appended to the log; once the log grows
+/// past a fraction of the index the file is compacted into a temp file and atomically renamed.
+class ModuleCacheStore {
+    std::filesystem::path path;
+    uint32_t formatTag = 0;
+
+    starbytes::MappedFile mapped;
+
+    uint64_t indexOffset = 0;
+    uint64_t indexCount = 0;
+    uint64_t validEnd = 0;
+    size_t logRecordCount = 0;
+    bool needsRewrite = false;
+
+    /// Log entries replayed on open; `std::nullopt` marks an erased key.
+    std::unordered_map<std::string,std::optional<std::string_view>> logEntries;
+    std::unordered_map<std::string,std::optional<std::string>> pendingEntries;
+
+    bool mapFile(std::string &warning);
+    void unmapFile();
+    bool replayLog(std::string &warning);
+    std::optional<std::string_view> findIndexed(std::string_view key) const;
+    bool appendPending(const std::function<bool(std::string_view,std::string_view)> &keep,std::string &error);
+    bool compact(const std::function<bool(std::string_view,std::string_view)> &keep,std::string &error);
+public:
+    static constexpr uint32_t kFormatVersion = 1;
+
+    ModuleCacheStore() = default;
+    ModuleCacheStore(const ModuleCacheStore &) = delete;
+    ModuleCacheStore &operator=(const ModuleCacheStore &) = delete;
+    ~ModuleCacheStore();
+
+    /// A missing file opens as an empty store. Incompatible or corrupt files are ignored with a warning.
+    bool open(const std::filesystem::path &cachePath,uint32_t formatTag,std::string &warning);
+    void close();
+
+    std::optional<std::string_view> find(std::string_view key) const;
+    void put(const std::string &key,std::string value);
+    void erase(const std::string &key);
+
+    bool hasPendingWrites() const { return !pendingEntries.empty(); }
+    size_t indexedEntryCount() const { return static_cast<size_t>(indexCount); }
+    size_t logEntryCount() const { return logRecordCount; }
+
+    /// Persists pending writes. `keep` filters the pending entries, and every entry when the flush
+    /// turns into a compaction. Views returned by `find` are invalidated.
+    bool flush(std::string &error,
+               const std::function<bool(std::string_view,std::string_view)> &keep = {},
+               bool forceCompaction = false);
+};
+
+}
+
+#endif
@@ -0,0 +1,700 @@
+#include "SharedArtifactStore.h"
+#include "starbytes/base/Digest.h"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <sstream>
+#include <system_error>
+#include <thread>
+#include <unordered_map>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#pragma comment(lib,"ws2_32.lib")
+#else
+#include <netdb.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/types.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+/// V2 names blobs by SHA-256; V1 manifests (64-bit FNV pairs) are treated as misses.
+constexpr const char *kManifestHeader = "STARBYTES_ARTIFACT_MANIFEST_V2";
+
+/// A publisher writes blobs before their manifest, so a young blob without one may be mid-publish.
+constexpr auto kOrphanBlobGracePeriod = std::chrono::minutes(10);
+
+std::string hex64(uint64_t value) {
+    std::ostringstream out;
+    out << std::hex;
+    out.width(16);
+    out.fill('0');
+    out << value;
+    return out.str();
+}
+
+std::string shardedObjectPath(const char *kind,const std::string &name) {
+    return std::string(kind) + "/" + name.substr(0,2) + "/" + name;
+}
+
+bool readFileBytes(const std::filesystem::path &path,std::string &bytes) {
+    std::ifstream in(path,std::ios::in | std::ios::binary);
+    if(!in.is_open()) {
+        return false;
+    }
+    std::ostringstream buffer;
+    buffer << in.rdbuf();
+    bytes = buffer.str();
+    return !in.bad();
+}
+
+std::filesystem::path uniqueTempPath(const std::filesystem::path &target) {
+    static std::atomic<uint64_t> counter{0};
+    auto stamp = std::chrono::steady_clock::now().time_since_epoch().count();
+    auto threadHash = std::hash<std::thread::id>{}(std::this_thread::get_id());
+    auto temp = target;
+    temp += ".tmp." + hex64(static_cast<uint64_t>(stamp) ^ threadHash) + "." + std::to_string(counter.fetch_add(1));
+    return temp;
+}
+
+/// Writes through a unique temp file and renames it into place so readers never see partial objects.
+bool writeFileAtomically(const std::filesystem::path &path,const std::string &bytes) {
+    std::error_code ec;
+    std::filesystem::create_directories(path.parent_path(),ec);
+    if(ec) {
+        return false;
+    }
+    auto temp = uniqueTempPath(path);
+    {
+        std::ofstream out(temp,std::ios::out | std::ios::binary | std::ios::trunc);
+        if(!out.is_open()) {
+            return false;
+        }
+        out.write(bytes.data(),static_cast<std::streamsize>(bytes.size()));
+        out.flush();
+        if(!out.good()) {
+            out.close();
+            std::filesystem::remove(temp,ec);
+            return false;
+        }
+    }
+    std::filesystem::rename(temp,path,ec);
+    if(ec) {
+        std::error_code removeErr;
+        std::filesystem::remove(temp,removeErr);
+        return false;
+    }
+    return true;
+}
+
+struct ManifestLine {
+    std::string role;
+    std::string blobHash;
+    uint64_t size = 0;
+};
+
+bool isBlobHash(const std::string &value) {
+    return value.size() == 64 && std::all_of(value.begin(),value.end(),[](char ch) {
+        return (ch >= '0' && ch <= '9') || (ch >= 'a' && ch <= 'f');
+    });
+}
+
+bool isArtifactRole(const std::string &value) {
+    return !value.empty() && std::all_of(value.begin(),value.end(),[](char ch) {
+        return std::isalnum(static_cast<unsigned char>(ch)) != 0 || ch == '_';
+    });
+}
+
+/// Manifests may come from a remote store, so roles and hashes are checked before they are used
+/// to build local paths.
+bool parseManifest(const std::string &bytes,std::vector<ManifestLine> &lines) {
+    std::istringstream in(bytes);
+    std::string header;
+    if(!std::getline(in,header) || header != kManifestHeader) {
+        return false;
+    }
+    ManifestLine line;
+    while(in >> line.role >> line.blobHash >> line.size) {
+        if(!isArtifactRole(line.role) || !isBlobHash(line.blobHash)) {
+            lines.clear();
+            return false;
+        }
+        lines.push_back(line);
+    }
+    return !lines.empty();
+}
+
+struct ParsedHttpUrl {
+    std::string host;
+    std::string port = "80";
+    std::string prefix;
+};
+
+bool parseHttpUrl(const std::string &url,ParsedHttpUrl &out) {
+    const std::string scheme = "http://";
+    if(url.compare(0,scheme.size(),scheme) != 0) {
+        return false;
+    }
+    auto rest = url.substr(scheme.size());
+    auto slash = rest.find('/');
+    auto authority = rest.substr(0,slash);
+    out.prefix = slash == std::string::npos ? "" : rest.substr(slash);
+    while(!out.prefix.empty() && out.prefix.back() == '/') {
+        out.prefix.pop_back();
+    }
+    auto colon = authority.rfind(':');
+    if(colon != std::string::npos) {
+        out.host = authority.substr(0,colon);
+        out.port = authority.substr(colon + 1);
+    }
+    else {
+        out.host = authority;
+    }
+    return !out.host.empty() && !out.port.empty();
+}
+
+#ifdef _WIN32
+using SocketHandle = SOCKET;
+constexpr SocketHandle kInvalidSocket = INVALID_SOCKET;
+void closeSocket(SocketHandle socketHandle) { closesocket(socketHandle); }
+bool ensureSocketsInitialized() {
+    static bool initialized = []() {
+        WSADATA data;
+        return WSAStartup(MAKEWORD(2,2),&data) == 0;
+    }();
+    return initialized;
+}
+#else
+using SocketHandle = int;
+constexpr SocketHandle kInvalidSocket = -1;
+void closeSocket(SocketHandle socketHandle) { ::close(socketHandle); }
+bool ensureSocketsInitialized() { return true; }
+#endif
+
+struct HttpResponseFrame {
+    bool headerParsed = false;
+    int status = 0;
+    size_t bodyStart = 0;
+    bool chunked = false;
+    bool hasContentLength = false;
+    uint64_t contentLength = 0;
+};
+
+bool equalsIgnoreCase(const std::string &lhs,const char *rhs) {
+    size_t length = std::strlen(rhs);
+    if(lhs.size() != length) {
+        return false;
+    }
+    for(size_t index = 0; index < length; ++index) {
+        if(std::tolower(static_cast<unsigned char>(lhs[index])) != std::tolower(static_cast<unsigned char>(rhs[index]))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::string trimHeaderValue(const std::string &value) {
+    auto begin = value.find_first_not_of(" \t");
+    if(begin == std::string::npos) {
+        return "";
+    }
+    auto end = value.find_last_not_of(" \t");
+    return value.substr(begin,end - begin + 1);
+}
+
+/// Parses the status line and framing headers once `response` holds them. Returns false only for
+/// malformed heads; an incomplete head leaves `frame.headerParsed` unset.
+bool parseResponseHead(const std::string &response,HttpResponseFrame &frame) {
+    auto headerEnd = response.find("\r\n\r\n");
+    if(headerEnd == std::string::npos) {
+        return true;
+    }
+    if(response.compare(0,5,"HTTP/") != 0) {
+        return false;
+    }
+    auto lineEnd = response.find("\r\n");
+    auto statusStart = response.find(' ');
+    if(statusStart == std::string::npos || statusStart > lineEnd) {
+        return false;
+    }
+    frame.status = std::atoi(response.c_str() + statusStart + 1);
+    while(lineEnd < headerEnd) {
+        auto lineStart = lineEnd + 2;
+        lineEnd = response.find("\r\n",lineStart);
+        auto colon = response.find(':',lineStart);
+        if(colon == std::string::npos || colon > lineEnd) {
+            continue;
+        }
+        auto name = response.substr(lineStart,colon - lineStart);
+        auto value = trimHeaderValue(response.substr(colon + 1,lineEnd - colon - 1));
+        if(equalsIgnoreCase(name,"Transfer-Encoding")) {
+            frame.chunked = value.size() >= 7 && equalsIgnoreCase(value.substr(value.size() - 7),"chunked");
+        }
+        else if(equalsIgnoreCase(name,"Content-Length")) {
+            if(value.empty() || value.find_first_not_of("0123456789") != std::string::npos || value.size() > 19) {
+                return false;
+            }
+            frame.hasContentLength = true;
+            frame.contentLength = std::stoull(value);
+        }
+    }
+    frame.bodyStart = headerEnd + 4;
+    frame.headerParsed = true;
+    return true;
+}
+
+bool endsWithBlankLine(const std::string &response,size_t bodyStart) {
+    return response.size() >= bodyStart + 5 && response.compare(response.size() - 4,4,"\r\n\r\n") == 0;
+}
+
+/// Decodes a chunked body starting at `offset`. Returns true once the terminating zero-size chunk
+/// and trailer section have arrived; malformed or incomplete input returns false.
+bool decodeChunkedBody(const std::string &response,size_t offset,std::string &body) {
+    body.clear();
+    while(true) {
+        auto lineEnd = response.find("\r\n",offset);
+        if(lineEnd == std::string::npos) {
+            return false;
+        }
+        auto sizeEnd = response.find_first_of(";\r",offset);
+        auto sizeText = trimHeaderValue(response.substr(offset,sizeEnd - offset));
+        if(sizeText.empty() || sizeText.size() > 15 || sizeText.find_first_not_of("0123456789abcdefABCDEF") != std::string::npos) {
+            return false;
+        }
+        auto chunkSize = static_cast<size_t>(std::stoull(sizeText,nullptr,16));
+        offset = lineEnd + 2;
+        if(chunkSize == 0) {
+            // Skip trailer fields up to the blank line that ends the message.
+            while(true) {
+                auto trailerEnd = response.find("\r\n",offset);
+                if(trailerEnd == std::string::npos) {
+                    return false;
+                }
+                if(trailerEnd == offset) {
+                    return true;
+                }
+                offset = trailerEnd + 2;
+            }
+        }
+        if(response.size() - offset < chunkSize + 2) {
+            return false;
+        }
+        if(response.compare(offset + chunkSize,2,"\r\n") != 0) {
+            return false;
+        }
+        body.append(response,offset,chunkSize);
+        offset += chunkSize + 2;
+    }
+}
+
+/// Minimal HTTP/1.1 client (plain http, `Connection: close`) for the remote object backend.
+/// Bodies are framed by `Content-Length` or chunked transfer encoding when the server sends them,
+/// and run to EOF otherwise; a connection that closes early fails the request.
+bool httpRequest(const ParsedHttpUrl &url,
+                 const std::string &method,
+                 const std::string &objectPath,
+                 const std::string *body,
+                 int &status,
+                 std::string &responseBody) {
+    if(!ensureSocketsInitialized()) {
+        return false;
+    }
+    addrinfo hints;
+    std::memset(&hints,0,sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo *addresses = nullptr;
+    if(getaddrinfo(url.host.c_str(),url.port.c_str(),&hints,&addresses) != 0 || !addresses) {
+        return false;
+    }
+    SocketHandle socketHandle = kInvalidSocket;
+    for(auto *address = addresses; address; address = address->ai_next) {
+        socketHandle = socket(address->ai_family,address->ai_socktype,address->ai_protocol);
+        if(socketHandle == kInvalidSocket) {
+            continue;
+        }
+        if(connect(socketHandle,address->ai_addr,static_cast<int>(address->ai_addrlen)) == 0) {
+            break;
+        }
+        closeSocket(socketHandle);
+        socketHandle = kInvalidSocket;
+    }
+    freeaddrinfo(addresses);
+    if(socketHandle == kInvalidSocket) {
+        return false;
+    }
+
+#ifdef _WIN32
+    DWORD timeoutMs = 30000;
+    setsockopt(socketHandle,SOL_SOCKET,SO_RCVTIMEO,reinterpret_cast<const char *>(&timeoutMs),sizeof(timeoutMs));
+#else
+    timeval timeout{30,0};
+    setsockopt(socketHandle,SOL_SOCKET,SO_RCVTIMEO,&timeout,sizeof(timeout));
+#endif
+
+    std::ostringstream request;
+    request << method << " " << url.prefix << "/" << objectPath << " HTTP/1.1\r\n"
+            << "Host: " << url.host << "\r\n"
+            << "Connection: close\r\n"
+            << "Content-Length: " << (body ? body->size() : 0) << "\r\n\r\n";
+    std::string payload = request.str();
+    if(body) {
+        payload += *body;
+    }
+    size_t sent = 0;
+    while(sent < payload.size()) {
+        auto chunk = send(socketHandle,payload.data() + sent,static_cast<int>(payload.size() - sent),0);
+        if(chunk <= 0) {
+            closeSocket(socketHandle);
+            return false;
+        }
+        sent += static_cast<size_t>(chunk);
+    }
+
+    std::string response;
+    HttpResponseFrame frame;
+    char buffer[64 * 1024];
+    bool complete = false;
+    while(!complete) {
+        auto received = recv(socketHandle,buffer,static_cast<int>(sizeof(buffer)),0);
+        if(received < 0) {
+            closeSocket(socketHandle);
+            return false;
+        }
+        if(received == 0) {
+            break;
+        }
+        response.append(buffer,static_cast<size_t>(received));
+        if(!frame.headerParsed && !parseResponseHead(response,frame)) {
+            closeSocket(socketHandle);
+            return false;
+        }
+        if(frame.headerParsed) {
+            // Every chunked message ends with an empty line, so only decode once one could be complete.
+            complete = frame.chunked ? endsWithBlankLine(response,frame.bodyStart) && decodeChunkedBody(response,frame.bodyStart,responseBody)
+                                     : frame.hasContentLength && response.size() - frame.bodyStart >= frame.contentLength;
+        }
+    }
+    closeSocket(socketHandle);
+
+    if(!frame.headerParsed) {
+        return false;
+    }
+    if(frame.chunked) {
+        // A connection closed before the terminating chunk is a truncated response.
+        if(!complete) {
+            return false;
+        }
+    }
+    else if(frame.hasContentLength) {
+        if(!complete) {
+            return false;
+        }
+        responseBody = response.substr(frame.bodyStart,frame.contentLength);
+    }
+    else {
+        responseBody = response.substr(frame.bodyStart);
+    }
+    status = frame.status;
+    return true;
+}
+
+}
+
+namespace starbytes::driver::cache {
+
+SharedArtifactStore::SharedArtifactStore(SharedArtifactStoreOptions options):options(std::move(options)){}
+
+std::string SharedArtifactStore::hashBytes(const std::string &bytes) {
+    Digest digest(DigestKind::Sha256);
+    unsigned char raw[kMaxDigestLength];
+    digest.update(reinterpret_cast<const unsigned char *>(bytes.data()),bytes.size());
+    digest.final(raw);
+    static const char *kHexDigits = "0123456789abcdef";
+    std::string hex;
+    hex.reserve(digestLength(DigestKind::Sha256) * 2);
+    for(size_t index = 0; index < digestLength(DigestKind::Sha256); ++index) {
+        hex.push_back(kHexDigits[raw[index] >> 4]);
+        hex.push_back(kHexDigits[raw[index] & 0x0f]);
+    }
+    return hex;
+}
+
+bool SharedArtifactStore::readLocalObject(const std::string &objectPath,std::string &bytes) const {
+    if(options.localRoot.empty()) {
+        return false;
+    }
+    return readFileBytes(options.localRoot / objectPath,bytes);
+}
+
+bool SharedArtifactStore::writeLocalObject(const std::string &objectPath,const std::string &bytes) const {
+    if(options.localRoot.empty()) {
+        return false;
+    }
+    return writeFileAtomically(options.localRoot / objectPath,bytes);
+}
+
+bool SharedArtifactStore::readRemoteObject(const std::string &objectPath,std::string &bytes) const {
+    ParsedHttpUrl url;
+    if(options.remoteUrl.empty() || !parseHttpUrl(options.remoteUrl,url)) {
+        return false;
+    }
+    int status = 0;
+    return httpRequest(url,"GET",objectPath,nullptr,status,bytes) && status == 200;
+}
+
+bool SharedArtifactStore::writeRemoteObject(const std::string &objectPath,const std::string &bytes) const {
+    ParsedHttpUrl url;
+    if(options.remoteUrl.empty() || !parseHttpUrl(options.remoteUrl,url)) {
+        return false;
+    }
+    int status = 0;
+    std::string responseBody;
+    return httpRequest(url,"PUT",objectPath,&bytes,status,responseBody) && status >= 200 && status < 300;
+}
+
+bool SharedArtifactStore::materializeBlob(const std::string &blobHash,const std::filesystem::path &dest) const {
+    auto objectPath = shardedObjectPath("cas",blobHash);
+    std::error_code ec;
+    std::filesystem::remove(dest,ec);
+
+    if(!options.localRoot.empty()) {
+        auto blobPath = options.localRoot / objectPath;
+        if(!std::filesystem::exists(blobPath,ec)) {
+            std::string bytes;
+            if(!readRemoteObject(objectPath,bytes) || hashBytes(bytes) != blobHash || !writeLocalObject(objectPath,bytes)) {
+                return false;
+            }
+        }
+        std::filesystem::create_hard_link(blobPath,dest,ec);
+        if(!ec) {
+            return true;
+        }
+        ec.clear();
+        return std::filesystem::copy_file(blobPath,dest,std::filesystem::copy_options::overwrite_existing,ec) && !ec;
+    }
+
+    std::string bytes;
+    if(!readRemoteObject(objectPath,bytes) || hashBytes(bytes) != blobHash) {
+        return false;
+    }
+    return writeFileAtomically(dest,bytes);
+}
+
+std::optional<std::vector<SharedArtifact>> SharedArtifactStore::fetch(const std::string &actionKey,
+                                                                      const std::filesystem::path &destDir,
+                                                                      const std::string &baseName) {
+    auto manifestPath = shardedObjectPath("ac",actionKey);
+    std::string manifestBytes;
+    bool fromLocal = readLocalObject(manifestPath,manifestBytes);
+    if(!fromLocal && !readRemoteObject(manifestPath,manifestBytes)) {
+        misses.fetch_add(1);
+        return std::nullopt;
+    }
+
+    std::vector<ManifestLine> lines;
+    if(!parseManifest(manifestBytes,lines)) {
+        misses.fetch_add(1);
+        return std::nullopt;
+    }
+
+    std::vector<SharedArtifact> artifacts;
+    artifacts.reserve(lines.size());
+    for(const auto &line : lines) {
+        auto dest = destDir / (baseName + "." + line.role);
+        if(!materializeBlob(line.blobHash,dest)) {
+            misses.fetch_add(1);
+            return std::nullopt;
+        }
+        artifacts.push_back({line.role,dest});
+    }
+
+    std::error_code ec;
+    if(fromLocal) {
+        std::filesystem::last_write_time(options.localRoot / manifestPath,std::filesystem::file_time_type::clock::now(),ec);
+    }
+    else if(!options.localRoot.empty()) {
+        writeLocalObject(manifestPath,manifestBytes);
+    }
+    hits.fetch_add(1);
+    return artifacts;
+}
+
+bool SharedArtifactStore::publish(const std::string &actionKey,const std::vector<SharedArtifact> &artifacts) {
+    std::ostringstream manifest;
+    manifest << kManifestHeader << "\n";
+    std::vector<std::filesystem::path> localBlobs;
+    for(const auto &artifact : artifacts) {
+        std::string bytes;
+        if(!readFileBytes(artifact.path,bytes)) {
+            return false;
+        }
+        auto blobHash = hashBytes(bytes);
+        auto objectPath = shardedObjectPath("cas",blobHash);
+        std::error_code ec;
+        if(!options.localRoot.empty()) {
+            auto blobPath = options.localRoot / objectPath;
+            if(!std::filesystem::exists(blobPath,ec) && !writeLocalObject(objectPath,bytes)) {
+                return false;
+            }
+            localBlobs.push_back(blobPath);
+            // Swap the freshly written workspace artifact for a link to the shared blob.
+            auto linkTemp = uniqueTempPath(artifact.path);
+            std::filesystem::create_hard_link(blobPath,linkTemp,ec);
+            if(!ec) {
+                std::filesystem::rename(linkTemp,artifact.path,ec);
+                if(ec) {
+                    std::error_code removeErr;
+                    std::filesystem::remove(linkTemp,removeErr);
+                }
+            }
+        }
+        if(!options.remoteUrl.empty() && !writeRemoteObject(objectPath,bytes)) {
+            return false;
+        }
+        manifest << artifact.role << " " << blobHash << " " << bytes.size() << "\n";
+    }
+
+    auto manifestPath = shardedObjectPath("ac",actionKey);
+    auto manifestBytes = manifest.str();
+    if(!options.localRoot.empty()) {
+        if(!writeLocalObject(manifestPath,manifestBytes)) {
+            return false;
+        }
+        // A concurrent size sweep may have dropped a reused blob before the manifest referenced it.
+        for(const auto &blobPath : localBlobs) {
+            std::error_code ec;
+            if(!std::filesystem::exists(blobPath,ec)) {
+                std::filesystem::remove(options.localRoot / manifestPath,ec);
+                return false;
+            }
+        }
+    }
+    if(!options.remoteUrl.empty() && !writeRemoteObject(manifestPath,manifestBytes)) {
+        return false;
+    }
+    published.fetch_add(1);
+    return true;
+}
+
+void SharedArtifactStore::enforceSizeLimit() {
+    if(options.localRoot.empty() || options.maxBytes == 0) {
+        return;
+    }
+
+    struct ManifestRecord {
+        std::filesystem::path path;
+        std::filesystem::file_time_type lastUse;
+        std::vector<std::string> blobs;
+    };
+    std::vector<ManifestRecord> manifests;
+    std::unordered_map<std::string,uint64_t> referenceCounts;
+    std::error_code ec;
+    auto acRoot = options.localRoot / "ac";
+    if(std::filesystem::is_directory(acRoot,ec)) {
+        for(const auto &entry : std::filesystem::recursive_directory_iterator(acRoot,ec)) {
+            if(!entry.is_regular_file(ec) || entry.path().filename().string().find(".tmp.") != std::string::npos) {
+                continue;
+            }
+            std::string bytes;
+            std::vector<ManifestLine> lines;
+            if(!readFileBytes(entry.path(),bytes) || !parseManifest(bytes,lines)) {
+                continue;
+            }
+            ManifestRecord record;
+            record.path = entry.path();
+            record.lastUse = entry.last_write_time(ec);
+            for(const auto &line : lines) {
+                record.blobs.push_back(line.blobHash);
+                referenceCounts[line.blobHash] += 1;
+            }
+            manifests.push_back(std::move(record));
+        }
+    }
+
+    struct BlobRecord {
+        std::filesystem::path path;
+        uint64_t size = 0;
+        std::filesystem::file_time_type lastWrite;
+    };
+    uint64_t totalBytes = 0;
+    std::unordered_map<std::string,BlobRecord> blobs;
+    auto casRoot = options.localRoot / "cas";
+    if(std::filesystem::is_directory(casRoot,ec)) {
+        for(const auto &entry : std::filesystem::recursive_directory_iterator(casRoot,ec)) {
+            if(!entry.is_regular_file(ec)) {
+                continue;
+            }
+            auto size = entry.file_size(ec);
+            blobs[entry.path().filename().string()] = {entry.path(),size,entry.last_write_time(ec)};
+            totalBytes += size;
+        }
+    }
+    if(totalBytes <= options.maxBytes) {
+        return;
+    }
+
+    auto removeBlob = [&](const std::string &blobHash) {
+        auto blobIt = blobs.find(blobHash);
+        if(blobIt == blobs.end()) {
+            return;
+        }
+        std::error_code removeErr;
+        if(std::filesystem::remove(blobIt->second.path,removeErr)) {
+            totalBytes -= std::min(totalBytes,blobIt->second.size);
+        }
+        blobs.erase(blobIt);
+    };
+
+    auto orphanCutoff = std::filesystem::file_time_type::clock::now() - kOrphanBlobGracePeriod;
+    std::vector<std::string> orphanBlobs;
+    for(const auto &blob : blobs) {
+        if(referenceCounts.find(blob.first) == referenceCounts.end() && blob.second.lastWrite < orphanCutoff) {
+            orphanBlobs.push_back(blob.first);
+        }
+    }
+    for(const auto &blobHash : orphanBlobs) {
+        removeBlob(blobHash);
+    }
+
+    std::sort(manifests.begin(),manifests.end(),[](const ManifestRecord &lhs,const ManifestRecord &rhs) {
+        return lhs.lastUse < rhs.lastUse;
+    });
+    for(const auto &manifest : manifests) {
+        if(totalBytes <= options.maxBytes) {
+            break;
+        }
+        std::error_code removeErr;
+        std::filesystem::remove(manifest.path,removeErr);
+        evicted.fetch_add(1);
+        for(const auto &blobHash : manifest.blobs) {
+            auto countIt = referenceCounts.find(blobHash);
+            if(countIt != referenceCounts.end() && --countIt->second == 0) {
+                removeBlob(blobHash);
+            }
+        }
+    }
+}
+
+SharedArtifactStoreStats SharedArtifactStore::stats() const {
+    SharedArtifactStoreStats out;
+    out.hits = hits.load();
+    out.misses = misses.load();
+    out.published = published.load();
+    out.evicted = evicted.load();
+    return out;
+}
+
+}
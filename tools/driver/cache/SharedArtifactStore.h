@@ -0,0 +1,73 @@
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <vector>
+
+#ifndef STARBYTES_DRIVER_CACHE_SHAREDARTIFACTSTORE_H
+#define STARBYTES_DRIVER_CACHE_SHAREDARTIFACTSTORE_H
+
+namespace starbytes::driver::cache {
+
+struct SharedArtifactStoreOptions {
+    std::filesystem::path localRoot;
+    std::string remoteUrl;
+    uint64_t maxBytes = 0;
+};
+
+/// One compiled output of a module; `role` is the file extension it is materialized with
+/// (`segment`, `starbsymtb`, `starbint`).
+struct SharedArtifact {
+    std::string role;
+    std::filesystem::path path;
+};
+
+struct SharedArtifactStoreStats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t published = 0;
+    uint64_t evicted = 0;
+};
+
+/// Content-addressed artifact store shared between workspaces.
+///
+/// Layout (identical for the local directory and the HTTP backend):
+///   ac/<k0k1>/<actionKey>   manifest: one `role blobHash size` line per artifact
+///   cas/<h0h1>/<blobHash>   artifact bytes, named by content hash
+/// Blobs are materialized into the workspace with hard links when the local store is on the
+/// same filesystem, and copied otherwise. Manifest mtimes record use for LRU eviction.
+class SharedArtifactStore {
+    SharedArtifactStoreOptions options;
+    std::atomic<uint64_t> hits{0};
+    std::atomic<uint64_t> misses{0};
+    std::atomic<uint64_t> published{0};
+    std::atomic<uint64_t> evicted{0};
+
+    bool readLocalObject(const std::string &objectPath,std::string &bytes) const;
+    bool writeLocalObject(const std::string &objectPath,const std::string &bytes) const;
+    bool readRemoteObject(const std::string &objectPath,std::string &bytes) const;
+    bool writeRemoteObject(const std::string &objectPath,const std::string &bytes) const;
+    bool materializeBlob(const std::string &blobHash,const std::filesystem::path &dest) const;
+public:
+    explicit SharedArtifactStore(SharedArtifactStoreOptions options);
+
+    bool enabled() const { return !options.localRoot.empty() || !options.remoteUrl.empty(); }
+
+    /// Materializes every artifact recorded for `actionKey` as `destDir/baseName.role`.
+    std::optional<std::vector<SharedArtifact>> fetch(const std::string &actionKey,
+                                                     const std::filesystem::path &destDir,
+                                                     const std::string &baseName);
+    bool publish(const std::string &actionKey,const std::vector<SharedArtifact> &artifacts);
+
+    /// Evicts least recently used entries from the local store until it fits `maxBytes`.
+    void enforceSizeLimit();
+
+    SharedArtifactStoreStats stats() const;
+
+    static std::string hashBytes(const std::string &bytes);
+};
+
+}
+
+#endif
@@ -0,0 +1,84 @@
+#!/usr/bin/env python3
+"""Local stand-in for the driver's HTTP artifact store (`--artifact-store-url`).
+
+Serves GET/HEAD/PUT for `ac/...` and `cas/...` objects out of a directory.
+"""
+from __future__ import annotations
+
+import argparse
+import os
+import tempfile
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+from pathlib import Path
+
+
+def make_handler(root: Path) -> type[BaseHTTPRequestHandler]:
+    class ArtifactStoreHandler(BaseHTTPRequestHandler):
+        protocol_version = "HTTP/1.1"
+
+        def resolve(self) -> Path | None:
+            parts = [part for part in self.path.split("?", 1)[0].split("/") if part]
+            if len(parts) < 2 or parts[0] not in ("ac", "cas") or any(part in (".", "..") for part in parts):
+                return None
+            return root.joinpath(*parts)
+
+        def reply(self, status: int, body: bytes = b"", send_body: bool = True) -> None:
+            self.send_response(status)
+            self.send_header("Content-Length", str(len(body)))
+            self.send_header("Connection", "close")
+            self.end_headers()
+            if send_body and body:
+                self.wfile.write(body)
+
+        def serve(self, send_body: bool) -> None:
+            path = self.resolve()
+            if path is None or not path.is_file():
+                self.reply(404, send_body=send_body)
+                return
+            self.reply(200, path.read_bytes(), send_body)
+
+        def do_GET(self) -> None:
+            self.serve(True)
+
+        def do_HEAD(self) -> None:
+            self.serve(False)
+
+        def do_PUT(self) -> None:
+            path = self.resolve()
+            if path is None:
+                self.reply(400)
+                return
+            length = int(self.headers.get("Content-Length", "0"))
+            body = self.rfile.read(length)
+            path.parent.mkdir(parents=True, exist_ok=True)
+            fd, temp = tempfile.mkstemp(dir=path.parent, prefix=path.name + ".tmp.")
+            with os.fdopen(fd, "wb") as handle:
+                handle.write(body)
+            os.replace(temp, path)
+            self.reply(201)
+
+        def log_message(self, format: str, *args: object) -> None:
+            pass
+
+    return ArtifactStoreHandler
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("root", type=Path, help="directory holding the store objects")
+    parser.add_argument("--host", default="127.0.0.1")
+    parser.add_argument("--port", type=int, default=8765)
+    args = parser.parse_args()
+
+    args.root.mkdir(parents=True, exist_ok=True)
+    server = ThreadingHTTPServer((args.host, args.port), make_handler(args.root.resolve()))
+    print(f"serving {args.root} on http://{args.host}:{server.server_address[1]}", flush=True)
+    try:
+        server.serve_forever()
+    except KeyboardInterrupt:
+        pass
+    return 0
+
+
+if __name__ == "__main__":
+    raise SystemExit(main())
@@ -1,13 +1,17 @@
 #include "starbytes/base/FileExt.def"
 #include "starbytes/base/CmdLine.h"
 #include "starbytes/compiler/AST.h"
+#include "starbytes/compiler/BytecodeOptimizer.h"
 #include "starbytes/compiler/Parser.h"
 #include "starbytes/compiler/Gen.h"
 #include "starbytes/compiler/RTCode.h"
 #include "starbytes/interop.h"
 #include "starbytes/runtime/RTEngine.h"
+#include "cache/ModuleCacheStore.h"
+#include "cache/SharedArtifactStore.h"
 #include "profile/CompileProfile.h"
 #include "profile/RuntimeProfile.h"
+#include "scheduler/BuildScheduler.h"
 
 #include <algorithm>
 #include <chrono>
@@ -22,13 +26,12 @@
 #include <set>
 #include <sstream>
 #include <string>
+#include <string_view>
 #include <system_error>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
-#include <future>
 #include <mutex>
-#include <condition_variable>
 #include <thread>
 
 #define STARBYTES_STRINGIFY_IMPL(x) #x
@@ -63,12 +66,16 @@ struct DriverOptions {
     starbytes::Runtime::RuntimeExecutionMode runtimeMode = starbytes::Runtime::RuntimeExecutionMode::Auto;
     uint16_t bytecodeVersion = starbytes::Runtime::RTBYTECODE_VERSION_V1;
     bool bytecodeVersionExplicit = false;
+    starbytes::BytecodeOptLevel optLevel = starbytes::BytecodeOptLevel::O1;
     bool logDiagnostics = true;
     bool autoLoadNative = true;
     bool infer64BitNumbers = false;
     std::vector<std::string> nativeModules;
     std::vector<std::string> nativeSearchDirs;
     unsigned jobs = 1;
+    std::string artifactStoreDir;
+    std::string artifactStoreUrl;
+    uint64_t artifactStoreMaxBytes = 0;
 };
 
 struct ParseResult {
@@ -130,8 +137,7 @@ struct ModuleAnalysisEntry {
 };
 
 struct ModuleAnalysisCache {
-    std::unordered_map<std::string, ModuleAnalysisEntry> entriesBySourcePath;
-    bool dirty = false;
+    starbytes::driver::cache::ModuleCacheStore store;
 };
 
 struct ModuleBuildCacheEntry {
@@ -142,11 +148,11 @@ struct ModuleBuildCacheEntry {
     std::string segmentPath;
     std::string symbolPath;
     std::string interfacePath;
+    uint64_t buildNs = 0;
 };
 
 struct ModuleBuildCache {
-    std::unordered_map<std::string, ModuleBuildCacheEntry> entriesByModuleKey;
-    bool dirty = false;
+    starbytes::driver::cache::ModuleCacheStore store;
 };
 
 struct ResolverContext {
@@ -155,9 +161,15 @@ struct ResolverContext {
 
 using CompileProfileData = starbytes::driver::profile::CompileProfileData;
 using RuntimeProfileReport = starbytes::driver::profile::RuntimeProfileReport;
+using BuildTaskNode = starbytes::driver::scheduler::BuildTaskNode;
+using BuildScheduleStats = starbytes::driver::scheduler::BuildScheduleStats;
+using WorkStealingScheduler = starbytes::driver::scheduler::WorkStealingScheduler;
 
 CompileProfileData *gActiveCompileProfile = nullptr;
 
+constexpr uint32_t kModuleAnalysisCacheTag = 0x414E4C31; // "ANL1"
+constexpr uint32_t kModuleBuildCacheTag = 0x424C4431; // "BLD1"
+
 std::string makeAbsolutePathString(const std::filesystem::path &path) {
     std::error_code ec;
     auto weak = std::filesystem::weakly_canonical(path, ec);
@@ -188,127 +200,52 @@ uint64_t hashString64(const std::string &value) {
     return fnv1a64(value.data(), value.size());
 }
 
-bool loadModuleAnalysisCache(const std::filesystem::path &cachePath,
-                             ModuleAnalysisCache &cache,
-                             std::string &warning) {
-    cache.entriesBySourcePath.clear();
-    cache.dirty = false;
-
-    std::ifstream in(cachePath, std::ios::in);
-    if(!in.is_open()) {
-        return true;
+std::string encodeModuleAnalysisEntry(const ModuleAnalysisEntry &entry) {
+    starbytes::driver::cache::CacheRecordWriter writer;
+    writer.writeU64(entry.contentHash);
+    writer.writeString(entry.compilerVersion);
+    writer.writeU64(entry.flagsHash);
+    writer.writeU64(entry.imports.size());
+    for(const auto &importName : entry.imports) {
+        writer.writeString(importName);
     }
+    return writer.take();
+}
 
-    std::string header;
-    if(!std::getline(in, header)) {
-        return true;
-    }
-    if(header != "STARBYTES_MODULE_ANALYSIS_CACHE_V1") {
-        warning = "Ignoring incompatible module analysis cache file: " + cachePath.string();
-        return true;
+bool decodeModuleAnalysisEntry(std::string_view bytes, ModuleAnalysisEntry &entry) {
+    starbytes::driver::cache::CacheRecordReader reader(bytes);
+    uint64_t importCount = 0;
+    if(!reader.readU64(entry.contentHash)
+       || !reader.readString(entry.compilerVersion)
+       || !reader.readU64(entry.flagsHash)
+       || !reader.readU64(importCount)) {
+        return false;
     }
-
-    while(in) {
-        std::string tag;
-        in >> tag;
-        if(!in) {
-            break;
-        }
-        if(tag != "ENTRY") {
-            std::string discard;
-            std::getline(in, discard);
-            continue;
-        }
-
-        std::string sourcePath;
-        std::string compilerVersion;
-        uint64_t contentHash = 0;
-        uint64_t flagsHash = 0;
-        size_t importCount = 0;
-
-        in >> std::quoted(sourcePath) >> contentHash >> std::quoted(compilerVersion) >> flagsHash >> importCount;
-        if(!in) {
-            warning = "Ignoring malformed module analysis cache file: " + cachePath.string();
-            cache.entriesBySourcePath.clear();
-            return true;
-        }
-
-        ModuleAnalysisEntry entry;
-        entry.contentHash = contentHash;
-        entry.compilerVersion = std::move(compilerVersion);
-        entry.flagsHash = flagsHash;
-        entry.imports.reserve(importCount);
-        for(size_t i = 0; i < importCount; ++i) {
-            std::string importName;
-            in >> std::quoted(importName);
-            if(!in) {
-                warning = "Ignoring malformed module analysis cache file: " + cachePath.string();
-                cache.entriesBySourcePath.clear();
-                return true;
-            }
-            entry.imports.push_back(std::move(importName));
+    entry.imports.clear();
+    for(uint64_t i = 0; i < importCount; ++i) {
+        std::string importName;
+        if(!reader.readString(importName)) {
+            return false;
         }
-        cache.entriesBySourcePath[sourcePath] = std::move(entry);
+        entry.imports.push_back(std::move(importName));
     }
-
-    return true;
+    return reader.atEnd();
 }
 
-void pruneStaleModuleAnalysisCacheEntries(ModuleAnalysisCache &cache){
-    std::vector<std::string> staleKeys;
-    staleKeys.reserve(cache.entriesBySourcePath.size());
-    for(const auto &entry : cache.entriesBySourcePath){
-        std::error_code ec;
-        auto sourcePath = std::filesystem::path(entry.first);
-        if(!std::filesystem::exists(sourcePath,ec) || ec ||
-           !std::filesystem::is_regular_file(sourcePath,ec) || ec) {
-            staleKeys.push_back(entry.first);
-        }
-    }
-    if(staleKeys.empty()){
-        return;
-    }
-    for(const auto &key : staleKeys){
-        cache.entriesBySourcePath.erase(key);
-    }
-    cache.dirty = true;
+bool loadModuleAnalysisCache(const std::filesystem::path &cachePath,
+                             ModuleAnalysisCache &cache,
+                             std::string &warning) {
+    return cache.store.open(cachePath, kModuleAnalysisCacheTag, warning);
 }
 
-bool saveModuleAnalysisCache(const std::filesystem::path &cachePath,
-                             const ModuleAnalysisCache &cache,
+bool saveModuleAnalysisCache(ModuleAnalysisCache &cache,
                              std::string &error) {
-    auto parent = cachePath.parent_path();
-    if(!parent.empty()) {
-        std::error_code dirErr;
-        std::filesystem::create_directories(parent, dirErr);
-        if(dirErr) {
-            error = "Failed to create module analysis cache directory '" + parent.string() + "': " + dirErr.message();
-            return false;
-        }
-    }
-
-    std::ofstream out(cachePath, std::ios::out | std::ios::trunc);
-    if(!out.is_open()) {
-        error = "Failed to write module analysis cache file: " + cachePath.string();
-        return false;
-    }
-
-    out << "STARBYTES_MODULE_ANALYSIS_CACHE_V1\n";
-    for(const auto &pair : cache.entriesBySourcePath) {
-        const auto &sourcePath = pair.first;
-        const auto &entry = pair.second;
-        out << "ENTRY "
-            << std::quoted(sourcePath) << " "
-            << entry.contentHash << " "
-            << std::quoted(entry.compilerVersion) << " "
-            << entry.flagsHash << " "
-            << entry.imports.size();
-        for(const auto &importName : entry.imports) {
-            out << " " << std::quoted(importName);
-        }
-        out << "\n";
-    }
-    return true;
+    // Entries for deleted sources are dropped whenever the store compacts.
+    return cache.store.flush(error, [](std::string_view sourcePath, std::string_view) {
+        std::error_code ec;
+        auto path = std::filesystem::path(std::string(sourcePath));
+        return std::filesystem::exists(path, ec) && !ec && std::filesystem::is_regular_file(path, ec) && !ec;
+    });
 }
 
 uint64_t combineHash64(uint64_t seed,uint64_t value){
@@ -353,114 +290,64 @@ std::unordered_map<std::string,uint64_t> computeModuleFingerprints(const ModuleG
     return fingerprints;
 }
 
-bool loadModuleBuildCache(const std::filesystem::path &cachePath,
-                          ModuleBuildCache &cache,
-                          std::string &warning){
-    cache.entriesByModuleKey.clear();
-    cache.dirty = false;
+std::string encodeModuleBuildCacheEntry(const ModuleBuildCacheEntry &entry){
+    starbytes::driver::cache::CacheRecordWriter writer;
+    writer.writeU64(entry.moduleHash);
+    writer.writeU64(entry.fingerprint);
+    writer.writeU64(entry.flagsHash);
+    writer.writeString(entry.compilerVersion);
+    writer.writeString(entry.segmentPath);
+    writer.writeString(entry.symbolPath);
+    writer.writeString(entry.interfacePath);
+    writer.writeU64(entry.buildNs);
+    return writer.take();
+}
 
-    std::ifstream in(cachePath,std::ios::in);
-    if(!in.is_open()){
-        return true;
-    }
+bool decodeModuleBuildCacheEntry(std::string_view bytes,ModuleBuildCacheEntry &entry){
+    starbytes::driver::cache::CacheRecordReader reader(bytes);
+    return reader.readU64(entry.moduleHash)
+        && reader.readU64(entry.fingerprint)
+        && reader.readU64(entry.flagsHash)
+        && reader.readString(entry.compilerVersion)
+        && reader.readString(entry.segmentPath)
+        && reader.readString(entry.symbolPath)
+        && reader.readString(entry.interfacePath)
+        && reader.readU64(entry.buildNs)
+        && reader.atEnd();
+}
 
-    std::string header;
-    if(!std::getline(in,header)){
-        return true;
-    }
-    if(header != "STARBYTES_MODULE_BUILD_CACHE_V1"){
-        warning = "Ignoring incompatible module build cache file: " + cachePath.string();
-        return true;
+std::optional<ModuleBuildCacheEntry> findModuleBuildCacheEntry(const ModuleBuildCache &cache,
+                                                               const std::string &moduleKey){
+    auto bytes = cache.store.find(moduleKey);
+    if(!bytes.has_value()){
+        return std::nullopt;
     }
-
-    while(in){
-        std::string tag;
-        in >> tag;
-        if(!in){
-            break;
-        }
-        if(tag != "ENTRY"){
-            std::string discard;
-            std::getline(in,discard);
-            continue;
-        }
-
-        std::string moduleKey;
-        ModuleBuildCacheEntry entry;
-        in >> std::quoted(moduleKey)
-           >> entry.moduleHash
-           >> entry.fingerprint
-           >> std::quoted(entry.compilerVersion)
-           >> entry.flagsHash
-           >> std::quoted(entry.segmentPath)
-           >> std::quoted(entry.symbolPath)
-           >> std::quoted(entry.interfacePath);
-        if(!in){
-            warning = "Ignoring malformed module build cache file: " + cachePath.string();
-            cache.entriesByModuleKey.clear();
-            return true;
-        }
-        cache.entriesByModuleKey[moduleKey] = std::move(entry);
+    ModuleBuildCacheEntry entry;
+    if(!decodeModuleBuildCacheEntry(*bytes,entry)){
+        return std::nullopt;
     }
-    return true;
+    return entry;
 }
 
-void pruneStaleModuleBuildCacheEntries(ModuleBuildCache &cache){
-    std::vector<std::string> staleKeys;
-    staleKeys.reserve(cache.entriesByModuleKey.size());
-    for(const auto &entry : cache.entriesByModuleKey){
-        std::error_code ec;
-        auto artifactPath = std::filesystem::path(entry.second.segmentPath);
-        if(entry.second.segmentPath.empty() ||
-           !std::filesystem::exists(artifactPath,ec) || ec ||
-           !std::filesystem::is_regular_file(artifactPath,ec) || ec){
-            staleKeys.push_back(entry.first);
-        }
-    }
-    if(staleKeys.empty()){
-        return;
-    }
-    for(const auto &key : staleKeys){
-        cache.entriesByModuleKey.erase(key);
-    }
-    cache.dirty = true;
+bool loadModuleBuildCache(const std::filesystem::path &cachePath,
+                          ModuleBuildCache &cache,
+                          std::string &warning){
+    return cache.store.open(cachePath,kModuleBuildCacheTag,warning);
 }
 
-bool saveModuleBuildCache(const std::filesystem::path &cachePath,
-                          const ModuleBuildCache &cache,
+bool saveModuleBuildCache(ModuleBuildCache &cache,
                           std::string &error){
-    auto parent = cachePath.parent_path();
-    if(!parent.empty()){
-        std::error_code dirErr;
-        std::filesystem::create_directories(parent,dirErr);
-        if(dirErr){
-            error = "Failed to create module build cache directory '" + parent.string() + "': " + dirErr.message();
+    // Entries whose segment artifact disappeared are dropped whenever the store compacts.
+    return cache.store.flush(error,[](std::string_view,std::string_view bytes){
+        ModuleBuildCacheEntry entry;
+        if(!decodeModuleBuildCacheEntry(bytes,entry) || entry.segmentPath.empty()){
             return false;
         }
-    }
-
-    std::ofstream out(cachePath,std::ios::out | std::ios::trunc);
-    if(!out.is_open()){
-        error = "Failed to write module build cache file: " + cachePath.string();
-        return false;
-    }
-
-    out << "STARBYTES_MODULE_BUILD_CACHE_V1\n";
-    for(const auto &pair : cache.entriesByModuleKey){
-        const auto &moduleKey = pair.first;
-        const auto &entry = pair.second;
-        out << "ENTRY "
-            << std::quoted(moduleKey) << " "
-            << entry.moduleHash << " "
-            << entry.fingerprint << " "
-            << std::quoted(entry.compilerVersion) << " "
-            << entry.flagsHash << " "
-            << std::quoted(entry.segmentPath) << " "
-            << std::quoted(entry.symbolPath) << " "
-            << std::quoted(entry.interfacePath)
-            << "\n";
-    }
-    return true;
+        std::error_code ec;
+        auto artifactPath = std::filesystem::path(entry.segmentPath);
+        return std::filesystem::exists(artifactPath,ec) && !ec
+            && std::filesystem::is_regular_file(artifactPath,ec) && !ec;
+    });
 }
 
 std::vector<std::filesystem::path> generatedOutputArtifacts(const std::filesystem::path &compiledModulePath) {
@@ -520,11 +407,14 @@ std::optional<std::vector<std::string>> resolveImportsFromCache(const ModuleAnal
                                                                 const std::string &compilerVersion,
                                                                 uint64_t flagsHash) {
     auto sourceKey = makeAbsolutePathString(source.filePath);
-    auto it = cache.entriesBySourcePath.find(sourceKey);
-    if(it == cache.entriesBySourcePath.end()) {
+    auto bytes = cache.store.find(sourceKey);
+    if(!bytes.has_value()) {
+        return std::nullopt;
+    }
+    ModuleAnalysisEntry entry;
+    if(!decodeModuleAnalysisEntry(*bytes, entry)) {
         return std::nullopt;
     }
-    const auto &entry = it->second;
     if(entry.contentHash != source.contentHash) {
         return std::nullopt;
     }
@@ -543,8 +433,11 @@ void updateImportCache(ModuleAnalysisCache &cache,
                        uint64_t flagsHash,
                        const std::vector<std::string> &imports) {
     auto sourceKey = makeAbsolutePathString(source.filePath);
-    auto &entry = cache.entriesBySourcePath[sourceKey];
-    if(entry.contentHash != source.contentHash ||
+    ModuleAnalysisEntry entry;
+    auto bytes = cache.store.find(sourceKey);
+    bool hasEntry = bytes.has_value() && decodeModuleAnalysisEntry(*bytes, entry);
+    if(!hasEntry ||
+       entry.contentHash != source.contentHash ||
        entry.compilerVersion != compilerVersion ||
        entry.flagsHash != flagsHash ||
        entry.imports != imports) {
@@ -552,7 +445,7 @@ void updateImportCache(ModuleAnalysisCache &cache,
         entry.compilerVersion = compilerVersion;
         entry.flagsHash = flagsHash;
         entry.imports = imports;
-        cache.dirty = true;
+        cache.store.put(sourceKey, encodeModuleAnalysisEntry(entry));
     }
 }
 
@@ -697,6 +590,7 @@ uint64_t computeModuleAnalysisFlagsHash(const DriverOptions &opts,
     key << "auto_native=" << (opts.autoLoadNative ? "1" : "0") << ";";
     key << "infer_64bit_numbers=" << (opts.infer64BitNumbers ? "1" : "0") << ";";
     key << "bytecode_version=" << opts.bytecodeVersion << ";";
+    key << "opt_level=" << starbytes::bytecodeOptLevelName(opts.optLevel) << ";";
     key << "native_dirs=";
     for(const auto &dir : opts.nativeSearchDirs) {
         key << makeAbsolutePathString(dir) << ";";
@@ -1294,6 +1188,65 @@ std::string artifactNameForModuleKey(const std::string &moduleKey){
     return out.str();
 }
 
+/// Path-independent counterpart of `computeModuleFingerprints` that keys the shared artifact store:
+/// sources contribute file names and the SHA-256 of their contents, dependencies their module names
+/// and fingerprints. A 64-bit hash would let two different sources share a store entry.
+std::unordered_map<std::string,std::string> computeModuleContentFingerprints(const ModuleGraph &graph){
+    using starbytes::driver::cache::SharedArtifactStore;
+    std::unordered_map<std::string,std::string> fingerprints;
+    fingerprints.reserve(graph.unitsByKey.size());
+    for(const auto &moduleKey : graph.buildOrder){
+        auto unitIt = graph.unitsByKey.find(moduleKey);
+        if(unitIt == graph.unitsByKey.end()){
+            continue;
+        }
+        std::ostringstream material;
+        for(const auto &source : unitIt->second.sources){
+            material << "source=" << source.filePath.filename().string() << ";";
+            material << "sha256=" << SharedArtifactStore::hashBytes(source.fileText) << ";";
+            material << "interface=" << (source.isInterfaceFile ? "1" : "0") << ";";
+        }
+        for(const auto &depKey : unitIt->second.dependencyKeys){
+            auto depIt = fingerprints.find(depKey);
+            if(depIt == fingerprints.end()){
+                continue;
+            }
+            material << "dep=" << moduleDisplayName(depKey) << ":" << depIt->second << ";";
+        }
+        fingerprints[moduleKey] = SharedArtifactStore::hashBytes(material.str());
+    }
+    return fingerprints;
+}
+
+std::string sharedArtifactActionKey(const std::string &contentFingerprint,
+                                    const std::string &compilerVersion,
+                                    const DriverOptions &opts,
+                                    bool generateInterface){
+    std::ostringstream key;
+    key << "content=" << contentFingerprint << ";";
+    key << "compiler=" << compilerVersion << ";";
+    key << "infer_64bit_numbers=" << (opts.infer64BitNumbers ? "1" : "0") << ";";
+    key << "bytecode_version=" << opts.bytecodeVersion << ";";
+    key << "opt_level=" << starbytes::bytecodeOptLevelName(opts.optLevel) << ";";
+    key << "interface=" << (generateInterface ? "1" : "0") << ";";
+    return starbytes::driver::cache::SharedArtifactStore::hashBytes(key.str());
+}
+
+bool isRegularFilePath(const std::filesystem::path &path){
+    std::error_code ec;
+    return !path.empty()
+        && std::filesystem::exists(path,ec) && !ec
+        && std::filesystem::is_regular_file(path,ec) && !ec;
+}
+
+/// Unlinks previous outputs so regenerated files never write through a hard link into the shared store.
+void removeModuleArtifacts(const std::filesystem::path &artifactDir,const std::string &moduleName){
+    std::error_code ec;
+    std::filesystem::remove(artifactDir / (moduleName + ".segment"),ec);
+    std::filesystem::remove(artifactDir / (moduleName + ".starbsymtb"),ec);
+    std::filesystem::remove(artifactDir / (moduleName + "." STARBYTES_INTERFACEFILE_EXT),ec);
+}
+
 struct ModuleCompileTaskResult {
     bool success = false;
     bool rebuilt = false;
@@ -1305,32 +1258,77 @@ struct ModuleCompileTaskResult {
     std::filesystem::path interfacePath;
     std::shared_ptr<starbytes::Semantics::SymbolTable> symbols;
     starbytes::Parser::ProfileData parserProfile;
+    starbytes::BytecodeOptimizerStats optimizerStats;
     uint64_t genFinishNs = 0;
+    uint64_t buildNs = 0;
 };
 
-class TaskLimiter {
-    std::mutex mutex;
-    std::condition_variable cv;
-    unsigned maxActive = 1;
-    unsigned active = 0;
-public:
-    explicit TaskLimiter(unsigned maxActive):maxActive(std::max(1u,maxActive)){}
+std::unordered_map<std::string,size_t> buildOrderIndexByKey(const ModuleGraph &graph){
+    std::unordered_map<std::string,size_t> indexByKey;
+    indexByKey.reserve(graph.buildOrder.size());
+    for(size_t i = 0;i < graph.buildOrder.size();++i){
+        indexByKey[graph.buildOrder[i]] = i;
+    }
+    return indexByKey;
+}
 
-    void acquire(){
-        std::unique_lock<std::mutex> lock(mutex);
-        cv.wait(lock,[&](){ return active < maxActive; });
-        ++active;
+std::vector<BuildTaskNode> buildModuleTaskNodes(const ModuleGraph &graph,
+                                                const std::unordered_map<std::string,size_t> &indexByKey,
+                                                const ModuleBuildCache *buildCache){
+    std::vector<BuildTaskNode> nodes(graph.buildOrder.size());
+    std::vector<uint64_t> costs(graph.buildOrder.size(),0);
+    uint64_t knownCostTotal = 0;
+    uint64_t knownCostCount = 0;
+    for(size_t i = 0;i < graph.buildOrder.size();++i){
+        const auto &moduleKey = graph.buildOrder[i];
+        auto unitIt = graph.unitsByKey.find(moduleKey);
+        if(unitIt != graph.unitsByKey.end()){
+            for(const auto &depKey : unitIt->second.dependencyKeys){
+                auto depIt = indexByKey.find(depKey);
+                if(depIt != indexByKey.end() && depIt->second != i){
+                    nodes[i].dependencies.push_back(depIt->second);
+                }
+            }
+        }
+        if(buildCache){
+            auto cached = findModuleBuildCacheEntry(*buildCache,moduleKey);
+            if(cached.has_value() && cached->buildNs > 0){
+                costs[i] = cached->buildNs;
+                knownCostTotal += costs[i];
+                knownCostCount += 1;
+            }
+        }
     }
 
-    void release(){
-        std::unique_lock<std::mutex> lock(mutex);
-        if(active > 0){
-            --active;
+    // Modules without a recorded build time are assumed to cost as much as the average known module.
+    uint64_t fallbackCost = knownCostCount > 0 ? std::max<uint64_t>(1,knownCostTotal / knownCostCount) : 1;
+    for(auto &cost : costs){
+        if(cost == 0){
+            cost = fallbackCost;
         }
-        lock.unlock();
-        cv.notify_one();
     }
-};
+    auto priorities = starbytes::driver::scheduler::computeCriticalPathPriorities(nodes,costs);
+    for(size_t i = 0;i < nodes.size();++i){
+        nodes[i].priority = priorities[i];
+    }
+    return nodes;
+}
+
+void recordSchedulerProfile(CompileProfileData &profile,const BuildScheduleStats &stats){
+    if(!profile.enabled){
+        return;
+    }
+    profile.schedulerWallNs = stats.wallNs;
+    profile.schedulerWorkers.clear();
+    profile.schedulerWorkers.reserve(stats.workers.size());
+    for(const auto &worker : stats.workers){
+        starbytes::driver::profile::CompileWorkerProfile workerProfile;
+        workerProfile.busyNs = worker.busyNs;
+        workerProfile.tasksRun = worker.tasksRun;
+        workerProfile.tasksStolen = worker.tasksStolen;
+        profile.schedulerWorkers.push_back(workerProfile);
+    }
+}
 
 ModuleCompileTaskResult compileModuleSymbolsOnly(const std::string &moduleKey,
                                                  const ModuleBuildUnit &unit,
@@ -1379,6 +1377,64 @@ ModuleCompileTaskResult compileModuleSymbolsOnly(const std::string &moduleKey,
     return result;
 }
 
+bool isInterfaceOnlyUnit(const ModuleBuildUnit &unit){
+    if(unit.sources.empty()){
+        return false;
+    }
+    for(const auto &source : unit.sources){
+        if(!source.isInterfaceFile){
+            return false;
+        }
+    }
+    return true;
+}
+
+/// Interface-only modules emit no code, so their cached `.starbsymtb` snapshot stands in for re-parsing them.
+bool loadModuleSymbolSnapshot(const std::string &moduleKey,
+                              const std::filesystem::path &symbolPath,
+                              ModuleCompileTaskResult &result){
+    auto symbols = starbytes::Semantics::SymbolTable::importPublicFile(symbolPath);
+    if(!symbols){
+        return false;
+    }
+    result = ModuleCompileTaskResult();
+    result.moduleKey = moduleKey;
+    result.symbols = std::move(symbols);
+    result.symbolPath = symbolPath;
+    result.success = true;
+    return true;
+}
+
+std::unordered_map<std::string,std::filesystem::path> collectCachedSymbolSnapshots(const ModuleGraph &graph,
+                                                                                  const ModuleBuildCache &buildCache,
+                                                                                  const std::unordered_map<std::string,uint64_t> &moduleFingerprints,
+                                                                                  const std::string &compilerVersion,
+                                                                                  uint64_t flagsHash){
+    std::unordered_map<std::string,std::filesystem::path> snapshots;
+    for(const auto &unitEntry : graph.unitsByKey){
+        const auto &unit = unitEntry.second;
+        if(!isInterfaceOnlyUnit(unit)){
+            continue;
+        }
+        auto cached = findModuleBuildCacheEntry(buildCache,unitEntry.first);
+        if(!cached.has_value() || cached->symbolPath.empty()){
+            continue;
+        }
+        auto moduleHash = computeModuleSourceHash(unit);
+        auto fpIt = moduleFingerprints.find(unitEntry.first);
+        auto moduleFingerprint = fpIt != moduleFingerprints.end() ? fpIt->second : moduleHash;
+        std::filesystem::path symbolPath(cached->symbolPath);
+        if(cached->moduleHash == moduleHash
+           && cached->fingerprint == moduleFingerprint
+           && cached->compilerVersion == compilerVersion
+           && cached->flagsHash == flagsHash
+           && isRegularFilePath(symbolPath)){
+            snapshots[unitEntry.first] = symbolPath;
+        }
+    }
+    return snapshots;
+}
+
 void accumulateModuleResultProfile(CompileProfileData &profile,
                                    const ModuleCompileTaskResult &result) {
     if(!profile.enabled) {
@@ -1394,6 +1450,19 @@ void accumulateModuleResultProfile(CompileProfileData &profile,
     profile.parserStatementCount += result.parserProfile.statementCount;
     profile.parserFileCount += result.parserProfile.fileCount;
     profile.genFinishNs += result.genFinishNs;
+    profile.optimizerFunctions += result.optimizerStats.functionsOptimized;
+    profile.optimizerInstructionsBefore += result.optimizerStats.instructionsBefore;
+    profile.optimizerInstructionsAfter += result.optimizerStats.instructionsAfter;
+    for(const auto &pass : result.optimizerStats.passes) {
+        auto existing = std::find_if(profile.optimizerPasses.begin(),profile.optimizerPasses.end(),
+                                     [&](const auto &entry) { return entry.name == pass.name; });
+        if(existing == profile.optimizerPasses.end()) {
+            existing = profile.optimizerPasses.insert(profile.optimizerPasses.end(),{pass.name});
+        }
+        existing->ns += pass.ns;
+        existing->runs += pass.runs;
+        existing->changes += pass.changes;
+    }
 }
 
 bool emitFailedModuleResults(const std::vector<std::string> &buildOrder,
@@ -1426,59 +1495,85 @@ void emitSuccessfulModuleDiagnostics(const std::vector<std::string> &buildOrder,
     }
 }
 
+bool collectDependencyTables(const ModuleBuildUnit &unit,
+                             const std::unordered_map<std::string,size_t> &indexByKey,
+                             const std::vector<ModuleCompileTaskResult> &resultsByIndex,
+                             std::unordered_map<std::string,std::shared_ptr<starbytes::Semantics::SymbolTable>> &depTables,
+                             std::string &error){
+    depTables.reserve(unit.dependencyKeys.size());
+    for(const auto &depKey : unit.dependencyKeys){
+        auto depIndexIt = indexByKey.find(depKey);
+        if(depIndexIt == indexByKey.end()){
+            error = "Internal driver error: missing dependency result `" + depKey + "`.";
+            return false;
+        }
+        const auto &depResult = resultsByIndex[depIndexIt->second];
+        if(!depResult.success || !depResult.symbols){
+            error = "Dependency build failed for `" + depKey + "`.";
+            return false;
+        }
+        depTables[depKey] = depResult.symbols;
+    }
+    return true;
+}
+
 bool checkModuleGraphSymbolsOnly(const ModuleGraph &graph,
                                  CompileProfileData &profile,
-                                 bool infer64BitNumbers) {
+                                 bool infer64BitNumbers,
+                                 unsigned jobs,
+                                 const ModuleBuildCache &buildCache,
+                                 const std::unordered_map<std::string,std::filesystem::path> &symbolSnapshots) {
     auto moduleBuildStart = std::chrono::steady_clock::now();
-    std::unordered_map<std::string,ModuleCompileTaskResult> moduleResults;
-    moduleResults.reserve(graph.unitsByKey.size());
-
-    for(const auto &moduleKey : graph.buildOrder) {
+    auto indexByKey = buildOrderIndexByKey(graph);
+    auto nodes = buildModuleTaskNodes(graph,indexByKey,&buildCache);
+    std::vector<ModuleCompileTaskResult> resultsByIndex(graph.buildOrder.size());
+
+    WorkStealingScheduler scheduler(std::min<unsigned>(jobs,static_cast<unsigned>(std::max<size_t>(1,nodes.size()))));
+    BuildScheduleStats scheduleStats;
+    bool scheduled = scheduler.run(nodes,[&](size_t index) {
+        const auto &moduleKey = graph.buildOrder[index];
         ModuleCompileTaskResult result;
         result.moduleKey = moduleKey;
 
         auto unitIt = graph.unitsByKey.find(moduleKey);
         if(unitIt == graph.unitsByKey.end()) {
             result.error = "Internal driver error: missing module build unit `" + moduleKey + "`.";
-            moduleResults[moduleKey] = result;
-            continue;
+            resultsByIndex[index] = std::move(result);
+            return;
         }
 
         const auto &unit = unitIt->second;
         std::unordered_map<std::string,std::shared_ptr<starbytes::Semantics::SymbolTable>> depTables;
-        depTables.reserve(unit.dependencyKeys.size());
-
-        bool missingDependency = false;
-        for(const auto &depKey : unit.dependencyKeys) {
-            auto depResultIt = moduleResults.find(depKey);
-            if(depResultIt == moduleResults.end()) {
-                result.error = "Internal driver error: missing dependency result `" + depKey + "`.";
-                missingDependency = true;
-                break;
-            }
-            if(!depResultIt->second.success || !depResultIt->second.symbols) {
-                result.error = "Dependency build failed for `" + depKey + "`.";
-                missingDependency = true;
-                break;
-            }
-            depTables[depKey] = depResultIt->second.symbols;
+        auto snapshotIt = symbolSnapshots.find(moduleKey);
+        if(snapshotIt != symbolSnapshots.end() && loadModuleSymbolSnapshot(moduleKey,snapshotIt->second,result)) {
+            resultsByIndex[index] = std::move(result);
+            return;
         }
-
-        if(!missingDependency) {
+        if(collectDependencyTables(unit,indexByKey,resultsByIndex,depTables,result.error)) {
             result = compileModuleSymbolsOnly(moduleKey,
                                               unit,
                                               depTables,
                                               profile.enabled,
                                               infer64BitNumbers);
         }
+        resultsByIndex[index] = std::move(result);
+    },scheduleStats);
+    if(!scheduled) {
+        std::cerr << "Internal driver error: module dependency graph could not be scheduled." << std::endl;
+        return false;
+    }
 
-        accumulateModuleResultProfile(profile,result);
-        moduleResults[moduleKey] = std::move(result);
+    std::unordered_map<std::string,ModuleCompileTaskResult> moduleResults;
+    moduleResults.reserve(graph.unitsByKey.size());
+    for(size_t i = 0; i < graph.buildOrder.size(); ++i) {
+        accumulateModuleResultProfile(profile,resultsByIndex[i]);
+        moduleResults[graph.buildOrder[i]] = std::move(resultsByIndex[i]);
     }
 
     if(profile.enabled) {
         auto moduleBuildEnd = std::chrono::steady_clock::now();
         profile.moduleBuildNs = std::chrono::duration_cast<std::chrono::nanoseconds>(moduleBuildEnd - moduleBuildStart).count();
+        recordSchedulerProfile(profile,scheduleStats);
     }
 
     if(emitFailedModuleResults(graph.buildOrder,moduleResults)) {
@@ -1496,6 +1591,7 @@ ModuleCompileTaskResult compileModuleToSegment(const std::string &moduleKey,
                                                bool profileEnabled,
                                                bool infer64BitNumbers,
                                                uint16_t bytecodeVersion,
+                                               starbytes::BytecodeOptLevel optLevel,
                                                bool generateInterface,
                                                const std::unordered_set<std::string> &interfaceAllowlist){
     ModuleCompileTaskResult result;
@@ -1509,6 +1605,7 @@ ModuleCompileTaskResult compileModuleToSegment(const std::string &moduleKey,
         return result;
     }
 
+    removeModuleArtifacts(artifactDir,moduleName);
     auto segmentPath = artifactDir / (moduleName + ".segment");
     std::ofstream moduleOut(segmentPath,std::ios::out | std::ios::binary);
     if(!moduleOut.is_open()){
@@ -1523,6 +1620,10 @@ ModuleCompileTaskResult compileModuleToSegment(const std::string &moduleKey,
     auto genContext = starbytes::ModuleGenContext::Create(moduleName,moduleOut,outputPathForGen);
     genContext.generateInterface = generateInterface;
     genContext.bytecodeVersion = bytecodeVersion;
+    starbytes::BytecodeOptimizer optimizer(optLevel);
+    if(bytecodeVersion == starbytes::Runtime::RTBYTECODE_VERSION_V2 && optLevel != starbytes::BytecodeOptLevel::O0){
+        genContext.optimizer = &optimizer;
+    }
     if(generateInterface){
         genContext.interfaceSourceAllowlist = interfaceAllowlist;
     }
@@ -1561,6 +1662,7 @@ ModuleCompileTaskResult compileModuleToSegment(const std::string &moduleKey,
     gen.finish();
     auto genFinishEnd = std::chrono::steady_clock::now();
     result.genFinishNs = std::chrono::duration_cast<std::chrono::nanoseconds>(genFinishEnd - genFinishStart).count();
+    result.optimizerStats = optimizer.stats();
     moduleOut.close();
 
     result.symbols = std::shared_ptr<starbytes::Semantics::SymbolTable>(parseContext.sTableContext.main.release());
@@ -1659,11 +1761,17 @@ void printHelp(std::ostream &out) {
     out << "      --bytecode-version <ver>\n";
     out << "                              Emit bytecode version v1 or v2.\n";
     out << "      --runtime-mode <mode>  Select runtime path: auto, v1, or v2.\n";
+    out << "  -O0, -O1, -O2              Bytecode V2 optimization level (default: -O1).\n";
     out << "      --no-diagnostics       Do not print diagnostics buffered by runtime handlers.\n";
     out << "  -n, --native <path>        Load a native module binary before runtime execution (repeatable).\n";
     out << "  -L, --native-dir <dir>     Add a search directory for auto native module resolution (repeatable).\n";
     out << "  -j, --jobs <count>         Parallel module build jobs (default: CPU count).\n";
     out << "      --no-native-auto       Disable automatic native module resolution from imports.\n";
+    out << "      --artifact-store <dir> Share compiled module artifacts through a local store directory.\n";
+    out << "      --artifact-store-url <url>\n";
+    out << "                              Share compiled module artifacts through an http:// store.\n";
+    out << "      --artifact-store-max-mb <n>\n";
+    out << "                              Evict least recently used local store entries above this size.\n";
     out << "      --infer-64bit-numbers  Infer numeric literals as Long/Double by default.\n";
     out << "      -- <args...>           Forward remaining arguments to script runtime (CmdLine module).\n";
 
@@ -1723,10 +1831,16 @@ ParseResult parseArgs(int argc, const char *argv[], DriverOptions &opts) {
     parser.addFlagOption("profile-runtime");
     parser.addValueOption("profile-runtime-out");
     parser.addValueOption("bytecode-version");
+    parser.addFlagOption("O0");
+    parser.addFlagOption("O1");
+    parser.addFlagOption("O2");
     parser.addValueOption("runtime-mode");
     parser.addFlagOption("no-diagnostics");
     parser.addFlagOption("no-native-auto");
     parser.addFlagOption("infer-64bit-numbers");
+    parser.addValueOption("artifact-store");
+    parser.addValueOption("artifact-store-url");
+    parser.addValueOption("artifact-store-max-mb");
 
     auto parsed = parser.parse(argc,argv);
     if(!parsed.ok) {
@@ -1813,6 +1927,21 @@ ParseResult parseArgs(int argc, const char *argv[], DriverOptions &opts) {
     else if(opts.runtimeMode == starbytes::Runtime::RuntimeExecutionMode::V2) {
         opts.bytecodeVersion = starbytes::Runtime::RTBYTECODE_VERSION_V2;
     }
+    const std::pair<const char *,starbytes::BytecodeOptLevel> optLevelFlags[] = {
+        {"O0",starbytes::BytecodeOptLevel::O0},
+        {"O1",starbytes::BytecodeOptLevel::O1},
+        {"O2",starbytes::BytecodeOptLevel::O2}
+    };
+    unsigned optLevelFlagCount = 0;
+    for(const auto &flag : optLevelFlags) {
+        if(parsed.hasFlag(flag.first)) {
+            opts.optLevel = flag.second;
+            ++optLevelFlagCount;
+        }
+    }
+    if(optLevelFlagCount > 1) {
+        return {false, 1, "Conflicting optimization levels: pass only one of -O0, -O1, or -O2."};
+    }
     opts.nativeModules.assign(parsed.values("native").begin(),parsed.values("native").end());
     opts.nativeSearchDirs.assign(parsed.values("native-dir").begin(),parsed.values("native-dir").end());
     const auto &jobsValues = parsed.values("jobs");
@@ -1833,6 +1962,27 @@ ParseResult parseArgs(int argc, const char *argv[], DriverOptions &opts) {
         opts.jobs = hw == 0 ? 1 : hw;
     }
 
+    const auto &artifactStoreValues = parsed.values("artifact-store");
+    if(!artifactStoreValues.empty()) {
+        opts.artifactStoreDir = artifactStoreValues.back();
+    }
+    const auto &artifactStoreUrlValues = parsed.values("artifact-store-url");
+    if(!artifactStoreUrlValues.empty()) {
+        opts.artifactStoreUrl = artifactStoreUrlValues.back();
+        if(opts.artifactStoreUrl.rfind("http://",0) != 0) {
+            return {false, 1, "Invalid --artifact-store-url value: expected an http:// URL."};
+        }
+    }
+    const auto &artifactStoreMaxValues = parsed.values("artifact-store-max-mb");
+    if(!artifactStoreMaxValues.empty()) {
+        try {
+            opts.artifactStoreMaxBytes = static_cast<uint64_t>(std::stoull(artifactStoreMaxValues.back())) * 1024ULL * 1024ULL;
+        }
+        catch(...) {
+            return {false, 1, "Invalid --artifact-store-max-mb value: expected unsigned integer."};
+        }
+    }
+
     bool forceRun = parsed.hasFlag("run");
     bool forceNoRun = parsed.hasFlag("no-run");
 
@@ -1962,6 +2112,7 @@ int main(int argc, const char *argv[]) {
     profile.command = commandToString(opts.command);
     profile.input = opts.scriptPath;
     profile.moduleName = opts.moduleName;
+    profile.optLevel = starbytes::bytecodeOptLevelName(opts.optLevel);
     runtimeProfile.enabled = opts.profileRuntime;
     runtimeProfile.command = commandToString(opts.command);
     runtimeProfile.input = opts.scriptPath;
@@ -2019,7 +2170,7 @@ int main(int argc, const char *argv[]) {
             analysisCacheRoot = outputParent;
         }
     }
-    auto analysisCachePath = analysisCacheRoot / ".cache" / "module_analysis_cache.v1";
+    auto analysisCachePath = analysisCacheRoot / ".cache" / "module_analysis_cache.bin";
     auto compilerVersion = compilerVersionString();
     auto analysisFlagsHash = computeModuleAnalysisFlagsHash(opts, resolverContext);
     ModuleAnalysisCache analysisCache;
@@ -2028,7 +2179,6 @@ int main(int argc, const char *argv[]) {
     if(!analysisCacheWarning.empty()) {
         std::cerr << "Warning: " << analysisCacheWarning << std::endl;
     }
-    pruneStaleModuleAnalysisCacheEntries(analysisCache);
 
     ModuleGraph graph;
     std::string graphError;
@@ -2049,9 +2199,9 @@ int main(int argc, const char *argv[]) {
         }
         return finishWith(1);
     }
-    if(analysisCache.dirty) {
+    if(analysisCache.store.hasPendingWrites()) {
         std::string cacheSaveError;
-        if(!saveModuleAnalysisCache(analysisCachePath, analysisCache, cacheSaveError)) {
+        if(!saveModuleAnalysisCache(analysisCache, cacheSaveError)) {
             std::cerr << "Warning: " << cacheSaveError << std::endl;
         }
     }
@@ -2078,8 +2228,18 @@ int main(int argc, const char *argv[]) {
         return finishWith(1);
     }
 
+    auto moduleBuildCachePath = analysisCacheRoot / ".cache" / "module_build_cache.bin";
+    ModuleBuildCache moduleBuildCache;
+    std::string buildCacheWarning;
+    loadModuleBuildCache(moduleBuildCachePath,moduleBuildCache,buildCacheWarning);
+    if(!buildCacheWarning.empty()){
+        std::cerr << "Warning: " << buildCacheWarning << std::endl;
+    }
+    auto moduleFingerprints = computeModuleFingerprints(graph);
+
     if(opts.command == DriverCommand::Check) {
-        auto ok = checkModuleGraphSymbolsOnly(graph,profile,opts.infer64BitNumbers);
+        auto symbolSnapshots = collectCachedSymbolSnapshots(graph,moduleBuildCache,moduleFingerprints,compilerVersion,analysisFlagsHash);
+        auto ok = checkModuleGraphSymbolsOnly(graph,profile,opts.infer64BitNumbers,opts.jobs,moduleBuildCache,symbolSnapshots);
         maybeLogRuntimeDiagnostics(opts);
         return finishWith(ok ? 0 : 1);
     }
@@ -2091,16 +2251,6 @@ int main(int argc, const char *argv[]) {
         std::cerr << outputDirError << std::endl;
         return finishWith(1);
     }
-    auto moduleBuildCachePath = analysisCacheRoot / ".cache" / "module_build_cache.v1";
-    ModuleBuildCache moduleBuildCache;
-    std::string buildCacheWarning;
-    loadModuleBuildCache(moduleBuildCachePath,moduleBuildCache,buildCacheWarning);
-    if(!buildCacheWarning.empty()){
-        std::cerr << "Warning: " << buildCacheWarning << std::endl;
-    }
-    pruneStaleModuleBuildCacheEntries(moduleBuildCache);
-
-    auto moduleFingerprints = computeModuleFingerprints(graph);
     std::unordered_map<std::string,bool> moduleNeedsRebuild;
     moduleNeedsRebuild.reserve(graph.unitsByKey.size());
     std::unordered_map<std::string,std::filesystem::path> cachedSegmentPaths;
@@ -2121,9 +2271,9 @@ int main(int argc, const char *argv[]) {
         auto moduleFingerprint = fpIt != moduleFingerprints.end() ? fpIt->second : moduleHash;
 
         bool rebuild = true;
-        auto cacheIt = moduleBuildCache.entriesByModuleKey.find(moduleKey);
-        if(cacheIt != moduleBuildCache.entriesByModuleKey.end()){
-            const auto &entry = cacheIt->second;
+        auto cachedEntry = findModuleBuildCacheEntry(moduleBuildCache,moduleKey);
+        if(cachedEntry.has_value()){
+            const auto &entry = *cachedEntry;
             std::error_code segErr;
             auto segmentPath = std::filesystem::path(entry.segmentPath);
             bool segmentOk = !entry.segmentPath.empty()
@@ -2164,155 +2314,216 @@ int main(int argc, const char *argv[]) {
         return finishWith(1);
     }
 
-    std::unordered_map<std::string,std::shared_future<ModuleCompileTaskResult>> futuresByModule;
-    futuresByModule.reserve(graph.unitsByKey.size());
+    starbytes::driver::cache::SharedArtifactStoreOptions artifactStoreOptions;
+    artifactStoreOptions.localRoot = opts.artifactStoreDir;
+    artifactStoreOptions.remoteUrl = opts.artifactStoreUrl;
+    artifactStoreOptions.maxBytes = opts.artifactStoreMaxBytes;
+    starbytes::driver::cache::SharedArtifactStore artifactStore(artifactStoreOptions);
+    std::unordered_map<std::string,std::string> moduleContentFingerprints;
+    if(artifactStore.enabled()){
+        moduleContentFingerprints = computeModuleContentFingerprints(graph);
+    }
+
+    auto moduleIndexByKey = buildOrderIndexByKey(graph);
+    auto moduleTaskNodes = buildModuleTaskNodes(graph,moduleIndexByKey,&moduleBuildCache);
+    std::vector<ModuleCompileTaskResult> resultsByIndex(graph.buildOrder.size());
     std::mutex moduleBuildCacheMutex;
-    TaskLimiter limiter(opts.jobs);
+    auto recordBuildCacheEntry = [&](const std::string &moduleKey,const ModuleBuildUnit &unit,const ModuleCompileTaskResult &built){
+        auto moduleHash = computeModuleSourceHash(unit);
+        auto fpIt = moduleFingerprints.find(moduleKey);
+        ModuleBuildCacheEntry entry;
+        entry.moduleHash = moduleHash;
+        entry.fingerprint = fpIt != moduleFingerprints.end() ? fpIt->second : moduleHash;
+        entry.flagsHash = analysisFlagsHash;
+        entry.compilerVersion = compilerVersion;
+        entry.buildNs = built.buildNs;
+        entry.segmentPath = makeAbsolutePathString(built.segmentPath);
+        if(!built.symbolPath.empty()){
+            entry.symbolPath = makeAbsolutePathString(built.symbolPath);
+        }
+        if(isRegularFilePath(built.interfacePath)){
+            entry.interfacePath = makeAbsolutePathString(built.interfacePath);
+        }
+        std::lock_guard<std::mutex> lock(moduleBuildCacheMutex);
+        moduleBuildCache.store.put(moduleKey,encodeModuleBuildCacheEntry(entry));
+    };
+    // Cost of the module's last real compile; loading or fetching it says nothing about that cost,
+    // and `buildModuleTaskNodes` ranks the critical path by it.
+    auto previousBuildNs = [&](const std::string &moduleKey) -> uint64_t {
+        std::lock_guard<std::mutex> lock(moduleBuildCacheMutex);
+        auto cached = findModuleBuildCacheEntry(moduleBuildCache,moduleKey);
+        return cached.has_value() ? cached->buildNs : 0;
+    };
+    WorkStealingScheduler scheduler(std::min<unsigned>(opts.jobs,static_cast<unsigned>(std::max<size_t>(1,moduleTaskNodes.size()))));
+    BuildScheduleStats scheduleStats;
     auto moduleBuildStart = std::chrono::steady_clock::now();
 
-    for(const auto &moduleKey : graph.buildOrder){
-        std::vector<std::pair<std::string,std::shared_future<ModuleCompileTaskResult>>> depFutures;
-        bool missingDependencyFuture = false;
-        std::string missingDependencyKey;
+    bool scheduled = scheduler.run(moduleTaskNodes,[&](size_t index){
+        const auto &moduleKey = graph.buildOrder[index];
+        auto taskStart = std::chrono::steady_clock::now();
+        auto elapsedNs = [&](){
+            return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - taskStart).count());
+        };
+        ModuleCompileTaskResult result;
+        result.moduleKey = moduleKey;
+
         auto unitIt = graph.unitsByKey.find(moduleKey);
-        if(unitIt != graph.unitsByKey.end()){
-            depFutures.reserve(unitIt->second.dependencyKeys.size());
-            for(const auto &depKey : unitIt->second.dependencyKeys){
-                auto depFutureIt = futuresByModule.find(depKey);
-                if(depFutureIt == futuresByModule.end()){
-                    missingDependencyFuture = true;
-                    missingDependencyKey = depKey;
-                    break;
-                }
-                depFutures.emplace_back(depKey,depFutureIt->second);
-            }
+        if(unitIt == graph.unitsByKey.end()){
+            result.error = "Internal driver error: missing module build unit `" + moduleKey + "`.";
+            resultsByIndex[index] = std::move(result);
+            return;
         }
+        const auto &unit = unitIt->second;
 
-        if(missingDependencyFuture){
-            futuresByModule[moduleKey] = std::async(std::launch::deferred,[moduleKey,missingDependencyKey]() -> ModuleCompileTaskResult {
-                ModuleCompileTaskResult result;
-                result.moduleKey = moduleKey;
-                result.error = "Internal driver error: missing dependency future `" + missingDependencyKey + "`.";
-                return result;
-            }).share();
-            continue;
+        std::unordered_map<std::string,std::shared_ptr<starbytes::Semantics::SymbolTable>> depTables;
+        if(!collectDependencyTables(unit,moduleIndexByKey,resultsByIndex,depTables,result.error)){
+            resultsByIndex[index] = std::move(result);
+            return;
         }
 
-        futuresByModule[moduleKey] = std::async(std::launch::async,[&,moduleKey,depFutures = std::move(depFutures)]() -> ModuleCompileTaskResult {
-            ModuleCompileTaskResult result;
-            result.moduleKey = moduleKey;
-
-            auto unitIt = graph.unitsByKey.find(moduleKey);
-            if(unitIt == graph.unitsByKey.end()){
-                result.error = "Internal driver error: missing module build unit `" + moduleKey + "`.";
-                return result;
+        bool rebuild = true;
+        auto rebuildIt = moduleNeedsRebuild.find(moduleKey);
+        if(rebuildIt != moduleNeedsRebuild.end()){
+            rebuild = rebuildIt->second;
+        }
+        if(!rebuild){
+            ModuleCompileTaskResult symbolOnly;
+            auto symIt = cachedSymbolPaths.find(moduleKey);
+            if(!isInterfaceOnlyUnit(unit) || symIt == cachedSymbolPaths.end()
+               || !loadModuleSymbolSnapshot(moduleKey,symIt->second,symbolOnly)){
+                symbolOnly = compileModuleSymbolsOnly(moduleKey,unit,depTables,profile.enabled,opts.infer64BitNumbers);
             }
-            const auto &unit = unitIt->second;
-
-            std::unordered_map<std::string,std::shared_ptr<starbytes::Semantics::SymbolTable>> depTables;
-            depTables.reserve(depFutures.size());
-            for(const auto &depFuture : depFutures){
-                auto depResult = depFuture.second.get();
-                if(!depResult.success){
-                    result.error = "Dependency build failed for `" + depFuture.first + "`.";
-                    return result;
-                }
-                depTables[depFuture.first] = depResult.symbols;
+            symbolOnly.segmentPath = cachedSegmentPaths[moduleKey];
+            if(symIt != cachedSymbolPaths.end()){
+                symbolOnly.symbolPath = symIt->second;
             }
-
-            limiter.acquire();
-            auto releaseGuard = std::shared_ptr<void>(nullptr,[&](void *){ limiter.release(); });
-
-            bool rebuild = true;
-            auto rebuildIt = moduleNeedsRebuild.find(moduleKey);
-            if(rebuildIt != moduleNeedsRebuild.end()){
-                rebuild = rebuildIt->second;
+            auto ifaceIt = cachedInterfacePaths.find(moduleKey);
+            if(ifaceIt != cachedInterfacePaths.end()){
+                symbolOnly.interfacePath = ifaceIt->second;
             }
-            if(!rebuild){
-                auto symbolOnly = compileModuleSymbolsOnly(moduleKey,unit,depTables,profile.enabled,opts.infer64BitNumbers);
-                symbolOnly.segmentPath = cachedSegmentPaths[moduleKey];
-                auto symIt = cachedSymbolPaths.find(moduleKey);
-                if(symIt != cachedSymbolPaths.end()){
-                    symbolOnly.symbolPath = symIt->second;
+            symbolOnly.buildNs = previousBuildNs(moduleKey);
+            resultsByIndex[index] = std::move(symbolOnly);
+            return;
+        }
+
+        auto moduleArtifactName = artifactNameForModuleKey(moduleKey);
+        bool shouldGenerateInterface = (moduleKey == graph.rootKey && graph.rootIsDirectory && !graph.rootHasMainSource);
+        std::unordered_set<std::string> interfaceAllowlist;
+        if(shouldGenerateInterface){
+            bool hasConcreteSources = false;
+            for(const auto &source : unit.sources){
+                if(!source.isInterfaceFile){
+                    hasConcreteSources = true;
+                    break;
                 }
-                auto ifaceIt = cachedInterfacePaths.find(moduleKey);
-                if(ifaceIt != cachedInterfacePaths.end()){
-                    symbolOnly.interfacePath = ifaceIt->second;
+            }
+            for(const auto &source : unit.sources){
+                if(hasConcreteSources && source.isInterfaceFile){
+                    continue;
                 }
-                return symbolOnly;
+                interfaceAllowlist.insert(makeAbsolutePathString(source.filePath));
             }
+        }
 
-            auto moduleArtifactName = artifactNameForModuleKey(moduleKey);
-            bool shouldGenerateInterface = (moduleKey == graph.rootKey && graph.rootIsDirectory && !graph.rootHasMainSource);
-            std::unordered_set<std::string> interfaceAllowlist;
-            if(shouldGenerateInterface){
-                bool hasConcreteSources = false;
-                for(const auto &source : unit.sources){
-                    if(!source.isInterfaceFile){
-                        hasConcreteSources = true;
-                        break;
+        std::string actionKey;
+        if(artifactStore.enabled()){
+            auto contentIt = moduleContentFingerprints.find(moduleKey);
+            if(contentIt != moduleContentFingerprints.end()){
+                actionKey = sharedArtifactActionKey(contentIt->second,compilerVersion,opts,shouldGenerateInterface);
+            }
+        }
+        if(!actionKey.empty()){
+            removeModuleArtifacts(moduleArtifactDir,moduleArtifactName);
+            auto fetched = artifactStore.fetch(actionKey,moduleArtifactDir,moduleArtifactName);
+            std::filesystem::path fetchedSegmentPath;
+            if(fetched.has_value()){
+                for(const auto &artifact : *fetched){
+                    if(artifact.role == "segment"){
+                        fetchedSegmentPath = artifact.path;
                     }
                 }
-                for(const auto &source : unit.sources){
-                    if(hasConcreteSources && source.isInterfaceFile){
-                        continue;
+            }
+            if(!fetchedSegmentPath.empty()){
+                auto restored = compileModuleSymbolsOnly(moduleKey,unit,depTables,profile.enabled,opts.infer64BitNumbers);
+                for(const auto &artifact : *fetched){
+                    if(artifact.role == "segment"){
+                        restored.segmentPath = artifact.path;
+                    }
+                    else if(artifact.role == "starbsymtb"){
+                        restored.symbolPath = artifact.path;
                     }
-                    interfaceAllowlist.insert(makeAbsolutePathString(source.filePath));
+                    else if(artifact.role == STARBYTES_INTERFACEFILE_EXT){
+                        restored.interfacePath = artifact.path;
+                    }
+                }
+                restored.buildNs = previousBuildNs(moduleKey);
+                if(restored.success){
+                    recordBuildCacheEntry(moduleKey,unit,restored);
                 }
+                resultsByIndex[index] = std::move(restored);
+                return;
             }
+        }
 
-            auto compiled = compileModuleToSegment(moduleKey,
-                                                   moduleArtifactName,
-                                                   unit,
-                                                   depTables,
-                                                   moduleArtifactDir,
-                                                   profile.enabled,
-                                                   opts.infer64BitNumbers,
-                                                   opts.bytecodeVersion,
-                                                   shouldGenerateInterface,
-                                                   interfaceAllowlist);
-            if(compiled.success){
-                auto moduleHash = computeModuleSourceHash(unit);
-                auto fpIt = moduleFingerprints.find(moduleKey);
-                auto moduleFingerprint = fpIt != moduleFingerprints.end() ? fpIt->second : moduleHash;
-                ModuleBuildCacheEntry entry;
-                entry.moduleHash = moduleHash;
-                entry.fingerprint = moduleFingerprint;
-                entry.flagsHash = analysisFlagsHash;
-                entry.compilerVersion = compilerVersion;
-                entry.segmentPath = makeAbsolutePathString(compiled.segmentPath);
-                entry.symbolPath = makeAbsolutePathString(compiled.symbolPath);
-                std::error_code ifaceErr;
-                if(!compiled.interfacePath.empty()
-                   && std::filesystem::exists(compiled.interfacePath,ifaceErr) && !ifaceErr
-                   && std::filesystem::is_regular_file(compiled.interfacePath,ifaceErr) && !ifaceErr){
-                    entry.interfacePath = makeAbsolutePathString(compiled.interfacePath);
+        auto compiled = compileModuleToSegment(moduleKey,
+                                               moduleArtifactName,
+                                               unit,
+                                               depTables,
+                                               moduleArtifactDir,
+                                               profile.enabled,
+                                               opts.infer64BitNumbers,
+                                               opts.bytecodeVersion,
+                                               opts.optLevel,
+                                               shouldGenerateInterface,
+                                               interfaceAllowlist);
+        compiled.buildNs = elapsedNs();
+        if(compiled.success){
+            if(!actionKey.empty()){
+                std::vector<starbytes::driver::cache::SharedArtifact> artifacts{{"segment",compiled.segmentPath}};
+                if(isRegularFilePath(compiled.symbolPath)){
+                    artifacts.push_back({"starbsymtb",compiled.symbolPath});
+                }
+                if(isRegularFilePath(compiled.interfacePath)){
+                    artifacts.push_back({STARBYTES_INTERFACEFILE_EXT,compiled.interfacePath});
                 }
-                {
+                if(!artifactStore.publish(actionKey,artifacts)){
                     std::lock_guard<std::mutex> lock(moduleBuildCacheMutex);
-                    moduleBuildCache.entriesByModuleKey[moduleKey] = std::move(entry);
-                    moduleBuildCache.dirty = true;
+                    std::cerr << "Warning: failed to publish module `" << moduleDisplayName(moduleKey)
+                              << "` to the shared artifact store." << std::endl;
                 }
             }
-            return compiled;
-        }).share();
+            recordBuildCacheEntry(moduleKey,unit,compiled);
+        }
+        resultsByIndex[index] = std::move(compiled);
+    },scheduleStats);
+    if(!scheduled){
+        std::cerr << "Internal driver error: module dependency graph could not be scheduled." << std::endl;
+        return finishWith(1);
+    }
+    if(artifactStore.enabled()){
+        artifactStore.enforceSizeLimit();
+        auto artifactStats = artifactStore.stats();
+        profile.sharedArtifactHits = artifactStats.hits;
+        profile.sharedArtifactMisses = artifactStats.misses;
+        profile.sharedArtifactEvictions = artifactStats.evicted;
     }
 
     std::unordered_map<std::string,ModuleCompileTaskResult> moduleResults;
     moduleResults.reserve(graph.unitsByKey.size());
     bool moduleBuildFailed = false;
-    for(const auto &moduleKey : graph.buildOrder){
-        auto result = futuresByModule[moduleKey].get();
-        moduleResults[moduleKey] = result;
+    for(size_t i = 0;i < graph.buildOrder.size();++i){
+        auto &result = resultsByIndex[i];
         accumulateModuleResultProfile(profile,result);
         if(!result.success){
             moduleBuildFailed = true;
         }
+        moduleResults[graph.buildOrder[i]] = std::move(result);
     }
 
     if(profile.enabled){
         auto moduleBuildEnd = std::chrono::steady_clock::now();
         profile.moduleBuildNs = std::chrono::duration_cast<std::chrono::nanoseconds>(moduleBuildEnd - moduleBuildStart).count();
+        recordSchedulerProfile(profile,scheduleStats);
     }
 
     if(moduleBuildFailed){
@@ -2323,9 +2534,9 @@ int main(int argc, const char *argv[]) {
 
     emitSuccessfulModuleDiagnostics(graph.buildOrder,moduleResults);
 
-    if(moduleBuildCache.dirty){
+    if(moduleBuildCache.store.hasPendingWrites()){
         std::string saveError;
-        if(!saveModuleBuildCache(moduleBuildCachePath,moduleBuildCache,saveError)){
+        if(!saveModuleBuildCache(moduleBuildCache,saveError)){
             std::cerr << "Warning: " << saveError << std::endl;
         }
     }
@@ -34,6 +34,9 @@ void printCompileProfile(std::ostream &out,const CompileProfileData &profile,boo
     out << "    \"parser_source_bytes\": " << profile.parserSourceBytes << ",\n";
     out << "    \"module_cache_hits\": " << profile.moduleCacheHits << ",\n";
     out << "    \"module_cache_misses\": " << profile.moduleCacheMisses << ",\n";
+    out << "    \"shared_artifact_hits\": " << profile.sharedArtifactHits << ",\n";
+    out << "    \"shared_artifact_misses\": " << profile.sharedArtifactMisses << ",\n";
+    out << "    \"shared_artifact_evictions\": " << profile.sharedArtifactEvictions << ",\n";
     out << "    \"runtime_quickened_sites\": " << profile.runtimeQuickenedSites << ",\n";
     out << "    \"runtime_quickened_executions\": " << profile.runtimeQuickenedExecutions << ",\n";
     out << "    \"runtime_quickened_specializations\": " << profile.runtimeQuickenedSpecializations << ",\n";
@@ -66,6 +69,39 @@ void printCompileProfile(std::ostream &out,const CompileProfileData &profile,boo
     out << "    \"module_link\": " << nsToMs(profile.moduleLinkNs) << ",\n";
     out << "    \"gen_finish\": " << nsToMs(profile.genFinishNs) << ",\n";
     out << "    \"runtime_exec\": " << nsToMs(profile.runtimeExecNs) << "\n";
+    out << "  },\n";
+    out << "  \"scheduler\": {\n";
+    out << "    \"wall_ms\": " << nsToMs(profile.schedulerWallNs) << ",\n";
+    out << "    \"workers\": [";
+    for(size_t i = 0; i < profile.schedulerWorkers.size(); ++i) {
+        const auto &worker = profile.schedulerWorkers[i];
+        double utilization = profile.schedulerWallNs == 0
+            ? 0.0
+            : static_cast<double>(worker.busyNs) / static_cast<double>(profile.schedulerWallNs);
+        out << (i == 0 ? "\n" : ",\n");
+        out << "      {\"id\": " << i
+            << ", \"tasks\": " << worker.tasksRun
+            << ", \"stolen\": " << worker.tasksStolen
+            << ", \"busy_ms\": " << nsToMs(worker.busyNs)
+            << ", \"utilization\": " << utilization << "}";
+    }
+    out << (profile.schedulerWorkers.empty() ? "]\n" : "\n    ]\n");
+    out << "  },\n";
+    out << "  \"optimizer\": {\n";
+    out << "    \"level\": \"" << profile.optLevel << "\",\n";
+    out << "    \"functions\": " << profile.optimizerFunctions << ",\n";
+    out << "    \"instructions_before\": " << profile.optimizerInstructionsBefore << ",\n";
+    out << "    \"instructions_after\": " << profile.optimizerInstructionsAfter << ",\n";
+    out << "    \"passes\": [";
+    for(size_t i = 0; i < profile.optimizerPasses.size(); ++i) {
+        const auto &pass = profile.optimizerPasses[i];
+        out << (i == 0 ? "\n" : ",\n");
+        out << "      {\"name\": \"" << pass.name << "\""
+            << ", \"runs\": " << pass.runs
+            << ", \"changes\": " << pass.changes
+            << ", \"ms\": " << nsToMs(pass.ns) << "}";
+    }
+    out << (profile.optimizerPasses.empty() ? "]\n" : "\n    ]\n");
     out << "  }\n";
     out << "}\n";
     out.unsetf(std::ios::floatfield);
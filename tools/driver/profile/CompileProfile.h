@@ -1,12 +1,26 @@
 #include <cstdint>
 #include <iosfwd>
 #include <string>
+#include <vector>
 
 #ifndef STARBYTES_DRIVER_PROFILE_COMPILEPROFILE_H
 #define STARBYTES_DRIVER_PROFILE_COMPILEPROFILE_H
 
 namespace starbytes::driver::profile {
 
+struct CompileWorkerProfile {
+    uint64_t busyNs = 0;
+    uint64_t tasksRun = 0;
+    uint64_t tasksStolen = 0;
+};
+
+struct CompileOptimizerPassProfile {
+    std::string name;
+    uint64_t ns = 0;
+    uint64_t runs = 0;
+    uint64_t changes = 0;
+};
+
 struct CompileProfileData {
     bool enabled = false;
     uint64_t totalNs = 0;
@@ -47,6 +61,16 @@ struct CompileProfileData {
     uint64_t sourceCount = 0;
     uint64_t moduleCacheHits = 0;
     uint64_t moduleCacheMisses = 0;
+    uint64_t sharedArtifactHits = 0;
+    uint64_t sharedArtifactMisses = 0;
+    uint64_t sharedArtifactEvictions = 0;
+    uint64_t schedulerWallNs = 0;
+    std::vector<CompileWorkerProfile> schedulerWorkers;
+    std::string optLevel;
+    uint64_t optimizerFunctions = 0;
+    uint64_t optimizerInstructionsBefore = 0;
+    uint64_t optimizerInstructionsAfter = 0;
+    std::vector<CompileOptimizerPassProfile> optimizerPasses;
     std::string command;
     std::string input;
     std::string moduleName;
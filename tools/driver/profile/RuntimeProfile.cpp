@@ -119,6 +119,7 @@ const char *objectKindName(StarbytesRuntimeObjectKind kind) {
         case StarbytesRuntimeObjectKindRegex: return "regex";
         case StarbytesRuntimeObjectKindTask: return "task";
         case StarbytesRuntimeObjectKindCustomClass: return "custom_class";
+        case StarbytesRuntimeObjectKindBytes: return "bytes";
         case StarbytesRuntimeObjectKindCount: return "count";
     }
     return "unknown";
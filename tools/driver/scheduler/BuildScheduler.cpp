@@ -0,0 +1,259 @@
+#include "BuildScheduler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace {
+
+using starbytes::driver::scheduler::BuildTaskNode;
+
+bool buildDependents(const std::vector<BuildTaskNode> &nodes,
+                     std::vector<std::vector<size_t>> &dependents) {
+    dependents.assign(nodes.size(),{});
+    for(size_t i = 0; i < nodes.size(); ++i) {
+        for(auto dep : nodes[i].dependencies) {
+            if(dep >= nodes.size() || dep == i) {
+                return false;
+            }
+            dependents[dep].push_back(i);
+        }
+    }
+    return true;
+}
+
+bool topologicalOrder(const std::vector<BuildTaskNode> &nodes,
+                      const std::vector<std::vector<size_t>> &dependents,
+                      std::vector<size_t> &order) {
+    std::vector<size_t> pending(nodes.size(),0);
+    order.clear();
+    order.reserve(nodes.size());
+    for(size_t i = 0; i < nodes.size(); ++i) {
+        pending[i] = nodes[i].dependencies.size();
+        if(pending[i] == 0) {
+            order.push_back(i);
+        }
+    }
+    for(size_t cursor = 0; cursor < order.size(); ++cursor) {
+        for(auto dependent : dependents[order[cursor]]) {
+            if(--pending[dependent] == 0) {
+                order.push_back(dependent);
+            }
+        }
+    }
+    return order.size() == nodes.size();
+}
+
+struct WorkerQueue {
+    std::mutex mutex;
+    std::deque<size_t> tasks;
+};
+
+}
+
+namespace starbytes::driver::scheduler {
+
+std::vector<uint64_t> computeCriticalPathPriorities(const std::vector<BuildTaskNode> &nodes,
+                                                   const std::vector<uint64_t> &costs) {
+    std::vector<uint64_t> priorities(nodes.size(),0);
+    std::vector<std::vector<size_t>> dependents;
+    std::vector<size_t> order;
+    if(!buildDependents(nodes,dependents) || !topologicalOrder(nodes,dependents,order)) {
+        return priorities;
+    }
+    for(auto it = order.rbegin(); it != order.rend(); ++it) {
+        auto index = *it;
+        uint64_t longestTail = 0;
+        for(auto dependent : dependents[index]) {
+            longestTail = std::max(longestTail,priorities[dependent]);
+        }
+        auto cost = index < costs.size() ? costs[index] : 0;
+        priorities[index] = cost + longestTail;
+    }
+    return priorities;
+}
+
+WorkStealingScheduler::WorkStealingScheduler(unsigned workerCount):workerCount(std::max(1u,workerCount)){}
+
+bool WorkStealingScheduler::run(const std::vector<BuildTaskNode> &nodes,
+                                const std::function<void(size_t)> &body,
+                                BuildScheduleStats &stats) {
+    stats.wallNs = 0;
+    stats.workers.assign(workerCount,{});
+
+    std::vector<std::vector<size_t>> dependents;
+    std::vector<size_t> order;
+    if(!buildDependents(nodes,dependents) || !topologicalOrder(nodes,dependents,order)) {
+        return false;
+    }
+    if(nodes.empty()) {
+        return true;
+    }
+
+    auto runStart = std::chrono::steady_clock::now();
+
+    std::unique_ptr<std::atomic<size_t>[]> pendingDeps(new std::atomic<size_t>[nodes.size()]);
+    std::vector<size_t> initiallyReady;
+    for(size_t i = 0; i < nodes.size(); ++i) {
+        pendingDeps[i].store(nodes[i].dependencies.size(),std::memory_order_relaxed);
+        if(nodes[i].dependencies.empty()) {
+            initiallyReady.push_back(i);
+        }
+    }
+
+    auto byPriorityAscending = [&](size_t lhs,size_t rhs) {
+        if(nodes[lhs].priority != nodes[rhs].priority) {
+            return nodes[lhs].priority < nodes[rhs].priority;
+        }
+        return lhs > rhs;
+    };
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues;
+    queues.reserve(workerCount);
+    for(unsigned i = 0; i < workerCount; ++i) {
+        queues.push_back(std::make_unique<WorkerQueue>());
+    }
+
+    // Deal the roots out highest-priority first so every worker's back holds its most urgent task.
+    std::sort(initiallyReady.begin(),initiallyReady.end(),[&](size_t lhs,size_t rhs) {
+        return byPriorityAscending(rhs,lhs);
+    });
+    for(size_t i = 0; i < initiallyReady.size(); ++i) {
+        queues[i % workerCount]->tasks.push_front(initiallyReady[i]);
+    }
+
+    std::mutex idleMutex;
+    std::condition_variable idleCv;
+    // Counts tasks sitting in a queue. It is raised before a task is published and lowered only
+    // after one is popped, so it never drops below the number of queued tasks.
+    size_t readyCount = initiallyReady.size();
+    size_t completedCount = 0;
+    std::exception_ptr failure;
+
+    auto popLocal = [&](unsigned workerId,size_t &task) {
+        auto &queue = *queues[workerId];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if(queue.tasks.empty()) {
+            return false;
+        }
+        task = queue.tasks.back();
+        queue.tasks.pop_back();
+        return true;
+    };
+
+    auto steal = [&](unsigned workerId,size_t &task) {
+        for(unsigned offset = 1; offset < workerCount; ++offset) {
+            auto &victim = *queues[(workerId + offset) % workerCount];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if(victim.tasks.empty()) {
+                continue;
+            }
+            task = victim.tasks.front();
+            victim.tasks.pop_front();
+            return true;
+        }
+        return false;
+    };
+
+    auto workerLoop = [&](unsigned workerId) {
+        auto &workerStats = stats.workers[workerId];
+        std::vector<size_t> newlyReady;
+        while(true) {
+            size_t task = 0;
+            bool stolen = false;
+            if(!popLocal(workerId,task)) {
+                stolen = steal(workerId,task);
+                if(!stolen) {
+                    std::unique_lock<std::mutex> lock(idleMutex);
+                    idleCv.wait(lock,[&]() { return readyCount > 0 || completedCount == nodes.size() || failure; });
+                    if(failure || (readyCount == 0 && completedCount == nodes.size())) {
+                        return;
+                    }
+                    continue;
+                }
+            }
+            {
+                std::lock_guard<std::mutex> lock(idleMutex);
+                --readyCount;
+                if(failure) {
+                    return;
+                }
+            }
+
+            auto taskStart = std::chrono::steady_clock::now();
+            try {
+                body(task);
+            }
+            catch(...) {
+                {
+                    std::lock_guard<std::mutex> lock(idleMutex);
+                    if(!failure) {
+                        failure = std::current_exception();
+                    }
+                }
+                idleCv.notify_all();
+                return;
+            }
+            auto taskEnd = std::chrono::steady_clock::now();
+            workerStats.busyNs += std::chrono::duration_cast<std::chrono::nanoseconds>(taskEnd - taskStart).count();
+            workerStats.tasksRun += 1;
+            if(stolen) {
+                workerStats.tasksStolen += 1;
+            }
+
+            newlyReady.clear();
+            for(auto dependent : dependents[task]) {
+                if(pendingDeps[dependent].fetch_sub(1,std::memory_order_acq_rel) == 1) {
+                    newlyReady.push_back(dependent);
+                }
+            }
+            bool finished = false;
+            {
+                std::lock_guard<std::mutex> lock(idleMutex);
+                readyCount += newlyReady.size();
+                ++completedCount;
+                finished = completedCount == nodes.size();
+            }
+            if(!newlyReady.empty()) {
+                std::sort(newlyReady.begin(),newlyReady.end(),byPriorityAscending);
+                auto &queue = *queues[workerId];
+                std::lock_guard<std::mutex> lock(queue.mutex);
+                for(auto ready : newlyReady) {
+                    queue.tasks.push_back(ready);
+                }
+            }
+
+            if(finished || newlyReady.size() > 1) {
+                idleCv.notify_all();
+            }
+            else if(newlyReady.size() == 1) {
+                idleCv.notify_one();
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(workerCount - 1);
+    for(unsigned workerId = 1; workerId < workerCount; ++workerId) {
+        threads.emplace_back(workerLoop,workerId);
+    }
+    workerLoop(0);
+    for(auto &thread : threads) {
+        thread.join();
+    }
+
+    auto runEnd = std::chrono::steady_clock::now();
+    stats.wallNs = std::chrono::duration_cast<std::chrono::nanoseconds>(runEnd - runStart).count();
+    if(failure) {
+        std::rethrow_exception(failure);
+    }
+    return true;
+}
+
+}
@@ -0,0 +1,51 @@
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#ifndef STARBYTES_DRIVER_SCHEDULER_BUILDSCHEDULER_H
+#define STARBYTES_DRIVER_SCHEDULER_BUILDSCHEDULER_H
+
+namespace starbytes::driver::scheduler {
+
+/// `dependencies` are indices of nodes that must finish first; higher `priority` runs first.
+struct BuildTaskNode {
+    std::vector<size_t> dependencies;
+    uint64_t priority = 0;
+};
+
+struct BuildWorkerStats {
+    uint64_t busyNs = 0;
+    uint64_t tasksRun = 0;
+    uint64_t tasksStolen = 0;
+};
+
+struct BuildScheduleStats {
+    uint64_t wallNs = 0;
+    std::vector<BuildWorkerStats> workers;
+};
+
+/// Priority of a node = its own cost + the most expensive chain of dependents after it.
+std::vector<uint64_t> computeCriticalPathPriorities(const std::vector<BuildTaskNode> &nodes,
+                                                   const std::vector<uint64_t> &costs);
+
+/// Fixed-size pool that runs a task DAG. Each worker owns a ready deque, finished tasks
+/// push newly ready dependents locally, and idle workers steal from the other deques.
+class WorkStealingScheduler {
+    unsigned workerCount;
+public:
+    explicit WorkStealingScheduler(unsigned workerCount);
+
+    unsigned getWorkerCount() const { return workerCount; }
+
+    /// Returns false without running anything if the graph has a bad index or a cycle.
+    /// If `body` throws, no further tasks start and the first exception is rethrown here
+    /// once every worker has stopped.
+    bool run(const std::vector<BuildTaskNode> &nodes,
+             const std::function<void(size_t)> &body,
+             BuildScheduleStats &stats);
+};
+
+}
+
+#endif
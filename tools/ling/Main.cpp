@@ -10,15 +10,22 @@
 #include "starbytes/linguistics/Types.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cctype>
+#include <condition_variable>
 #include <cstddef>
+#include <cstdint>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <regex>
 #include <sstream>
 #include <string>
 #include <system_error>
+#include <thread>
 #include <unordered_set>
 #include <vector>
 
@@ -51,6 +58,10 @@ struct LingOptions {
     bool modpathAware = false;
     LintMode lintMode = LintMode::Both;
     size_t maxFiles = 0;
+    size_t jobs = 1;
+    bool useCache = false;
+    bool cacheStats = false;
+    std::string cacheDir;
     std::vector<std::string> includeGlobs;
     std::vector<std::string> excludeGlobs;
     std::string inputPath;
@@ -75,8 +86,7 @@ struct FileAnalysisCache {
     starbytes::linguistics::LinguisticsSession session;
     bool loaded = false;
 
-    bool compilerAnalysisReady = false;
-    starbytes::linguistics::OwnedCompilerLintAnalysis compilerAnalysis;
+    starbytes::linguistics::SharedLinguisticsArtifact artifact;
 
     bool lintReady = false;
     starbytes::linguistics::LintResult lintResult;
@@ -94,6 +104,20 @@ struct FileAnalysisCache {
     starbytes::linguistics::FormatResult formatResult;
 };
 
+/// Everything one file contributes to the tool's output, buffered so parallel runs print in file order.
+struct FileRunOutput {
+    std::string out;
+    std::string err;
+    bool hadError = false;
+};
+
+struct LingEngines {
+    starbytes::linguistics::LintEngine lint;
+    starbytes::linguistics::SuggestionEngine suggestion;
+    starbytes::linguistics::CodeActionEngine codeAction;
+    starbytes::linguistics::FormatterEngine formatter;
+};
+
 void printUsage(std::ostream &out) {
     out << "Usage:\n";
     out << "  starbytes-ling --pretty-write <source." << STARBYTES_SRCFILE_EXT << "|dir>\n";
@@ -101,6 +125,7 @@ void printUsage(std::ostream &out) {
     out << "  starbytes-ling --suggest <source." << STARBYTES_SRCFILE_EXT << "|dir>\n";
     out << "  starbytes-ling --code-actions <source." << STARBYTES_SRCFILE_EXT << "|dir>\n";
     out << "  starbytes-ling --apply-safe-fixes [--dry-run] <source." << STARBYTES_SRCFILE_EXT << "|dir>\n";
+    out << "  starbytes-ling --lint --jobs <n> --cache <source." << STARBYTES_SRCFILE_EXT << "|dir>\n";
     out << "  starbytes-ling --help\n";
     out << "  starbytes-ling --version\n";
 }
@@ -123,6 +148,10 @@ void printHelp(std::ostream &out) {
     out << "      --include <glob>    Include glob (repeatable).\n";
     out << "      --exclude <glob>    Exclude glob (repeatable).\n";
     out << "      --max-files <n>     Cap discovered file count (0 = unlimited).\n";
+    out << "  -j, --jobs <n>          Analyze files on n threads (0 = one per hardware thread, default 1).\n";
+    out << "      --cache             Reuse results for unchanged files from .starbytes/.cache.\n";
+    out << "      --cache-dir <dir>   Keep the result cache in <dir> (implies --cache).\n";
+    out << "      --cache-stats       Print how many files the cache reused to stderr.\n";
 }
 
 void printVersion(std::ostream &out) {
@@ -151,6 +180,10 @@ ParseResult parseArgs(int argc, const char *argv[], LingOptions &opts) {
     parser.addMultiValueOption("include");
     parser.addMultiValueOption("exclude");
     parser.addValueOption("max-files");
+    parser.addValueOption("jobs", {"j"});
+    parser.addFlagOption("cache");
+    parser.addValueOption("cache-dir");
+    parser.addFlagOption("cache-stats");
 
     auto parsed = parser.parse(argc, argv);
     if(!parsed.ok) {
@@ -204,6 +237,25 @@ ParseResult parseArgs(int argc, const char *argv[], LingOptions &opts) {
         }
     }
 
+    if(auto jobs = parsed.firstValue("jobs"); jobs.has_value()) {
+        try {
+            opts.jobs = static_cast<size_t>(std::stoull(*jobs));
+        }
+        catch(...) {
+            return {false, 1, "Invalid value for --jobs."};
+        }
+        if(opts.jobs == 0) {
+            opts.jobs = std::max<size_t>(1, std::thread::hardware_concurrency());
+        }
+    }
+
+    opts.useCache = parsed.hasFlag("cache");
+    if(auto cacheDir = parsed.firstValue("cache-dir"); cacheDir.has_value()) {
+        opts.cacheDir = *cacheDir;
+        opts.useCache = true;
+    }
+    opts.cacheStats = parsed.hasFlag("cache-stats");
+
     if(parsed.positionals.empty()) {
         return {false, 1, "Missing input path."};
     }
@@ -518,23 +570,22 @@ bool loadFileAnalysis(FileAnalysisCache &cache, std::string &errorOut) {
     return true;
 }
 
-const starbytes::linguistics::OwnedCompilerLintAnalysis &ensureCompilerAnalysis(FileAnalysisCache &cache) {
-    if(!cache.compilerAnalysisReady) {
-        cache.compilerAnalysis = starbytes::linguistics::buildCompilerLintAnalysis(cache.session);
-        cache.compilerAnalysisReady = true;
+const starbytes::linguistics::LinguisticsArtifact &ensureArtifact(FileAnalysisCache &cache) {
+    if(!cache.artifact) {
+        cache.artifact = starbytes::linguistics::buildLinguisticsArtifact(cache.session);
     }
-    return cache.compilerAnalysis;
+    return *cache.artifact;
 }
 
 const std::vector<starbytes::DiagnosticRecord> &ensureSyntaxDiagnostics(FileAnalysisCache &cache) {
-    return ensureCompilerAnalysis(cache).syntaxDiagnostics;
+    return ensureArtifact(cache).compiler.syntaxDiagnostics;
 }
 
 const starbytes::linguistics::LintResult &ensureLintResult(FileAnalysisCache &cache,
                                                            const starbytes::linguistics::LinguisticsConfig &config,
                                                            starbytes::linguistics::LintEngine &engine) {
     if(!cache.lintReady) {
-        cache.lintResult = engine.run(ensureCompilerAnalysis(cache).view(), config);
+        cache.lintResult = engine.run(ensureArtifact(cache).view(), config);
         cache.lintReady = true;
     }
     return cache.lintResult;
@@ -547,7 +598,7 @@ const starbytes::linguistics::SuggestionResult &ensureSuggestionResult(
     if(!cache.suggestionsReady) {
         starbytes::linguistics::SuggestionRequest request;
         request.includeLowConfidence = false;
-        cache.suggestionResult = engine.run(ensureCompilerAnalysis(cache).view(), config, request);
+        cache.suggestionResult = engine.run(ensureArtifact(cache).view(), config, request);
         cache.suggestionsReady = true;
     }
     return cache.suggestionResult;
@@ -578,7 +629,7 @@ const starbytes::linguistics::FormatResult &ensureFormatResult(
     const starbytes::linguistics::LinguisticsConfig &config,
     starbytes::linguistics::FormatterEngine &engine) {
     if(!cache.formatReady) {
-        cache.formatResult = engine.format(cache.session, config);
+        cache.formatResult = engine.format(ensureArtifact(cache), config);
         cache.formatReady = true;
     }
     return cache.formatResult;
@@ -720,6 +771,282 @@ void printSyntaxDiagnostics(const std::vector<starbytes::DiagnosticRecord> &reco
     }
 }
 
+void runFileOperations(FileAnalysisCache &file,
+                       const LingOptions &opts,
+                       const starbytes::linguistics::LinguisticsConfig &config,
+                       LingEngines &engines,
+                       bool multiFile,
+                       FileRunOutput &result) {
+    std::ostringstream out;
+    std::ostringstream err;
+
+    auto printHeader = [&](const char *operationLabel) {
+        if(!multiFile) {
+            return;
+        }
+        out << "== [" << operationLabel << "] " << file.filePath.generic_string() << " ==\n";
+    };
+
+    if(opts.lint) {
+        printHeader("lint");
+        if(opts.lintMode != LintMode::SemanticOnly) {
+            const auto &syntaxDiagnostics = ensureSyntaxDiagnostics(file);
+            printSyntaxDiagnostics(syntaxDiagnostics, out);
+            if(ensureArtifact(file).compiler.syntaxHadError) {
+                result.hadError = true;
+            }
+        }
+        if(opts.lintMode != LintMode::SyntaxOnly) {
+            out << starbytes::linguistics::LinguisticsSerializer::toText(ensureLintResult(file, config, engines.lint))
+                << '\n';
+        }
+    }
+
+    if(opts.suggest) {
+        printHeader("suggest");
+        printSuggestions(ensureSuggestionResult(file, config, engines.suggestion), out);
+    }
+
+    if(opts.codeActions) {
+        printHeader("code-actions");
+        printActions(ensureCodeActionResult(file, false, config, engines.lint, engines.suggestion, engines.codeAction),
+                     out);
+    }
+
+    if(opts.prettyWrite) {
+        printHeader("pretty-write");
+        const auto &formatResult = ensureFormatResult(file, config, engines.formatter);
+        if(!formatResult.ok) {
+            err << "Failed to format source in --pretty-write mode: " << file.filePath.generic_string() << '\n';
+            result.hadError = true;
+        }
+        else {
+            out << formatResult.formattedText;
+            if(multiFile && !formatResult.formattedText.empty() && formatResult.formattedText.back() != '\n') {
+                out << '\n';
+            }
+            for(const auto &note : formatResult.notes) {
+                err << file.filePath.generic_string() << ": " << note << '\n';
+            }
+        }
+    }
+
+    if(opts.applySafeFixes) {
+        const auto &safeActions =
+            ensureCodeActionResult(file, true, config, engines.lint, engines.suggestion, engines.codeAction);
+
+        std::vector<starbytes::linguistics::TextEdit> edits;
+        edits.reserve(safeActions.actions.size());
+        for(const auto &action : safeActions.actions) {
+            edits.insert(edits.end(), action.edits.begin(), action.edits.end());
+        }
+
+        auto previewText = file.sourceText;
+        auto appliedCount = applyEditsDeterministically(previewText, edits);
+
+        if(opts.dryRun) {
+            printHeader("apply-safe-fixes dry-run");
+            out << "dry-run safe-fix edits: " << appliedCount << "\n";
+            out << previewText;
+            if(!previewText.empty() && previewText.back() != '\n') {
+                out << '\n';
+            }
+        }
+        else {
+            std::ofstream outFile(file.filePath, std::ios::out | std::ios::trunc);
+            if(!outFile.is_open()) {
+                err << "Failed to open file for --apply-safe-fixes: " << file.filePath.generic_string() << '\n';
+                result.hadError = true;
+            }
+            else {
+                outFile << previewText;
+                err << "Applied safe fixes: " << appliedCount << " (" << file.filePath.generic_string() << ")\n";
+            }
+        }
+    }
+
+    result.out = out.str();
+    result.err = err.str();
+}
+
+constexpr char kResultCacheMagic[8] = {'S', 'B', 'L', 'N', 'G', 'C', '1', '\0'};
+
+void writeU64(std::ostream &out, uint64_t value) {
+    for(unsigned shift = 0; shift < 64; shift += 8) {
+        out.put(static_cast<char>((value >> shift) & 0xffu));
+    }
+}
+
+bool readU64(std::istream &in, uint64_t &value) {
+    value = 0;
+    for(unsigned shift = 0; shift < 64; shift += 8) {
+        int byte = in.get();
+        if(byte == std::char_traits<char>::eof()) {
+            return false;
+        }
+        value |= static_cast<uint64_t>(static_cast<unsigned char>(byte)) << shift;
+    }
+    return true;
+}
+
+void writeString(std::ostream &out, const std::string &value) {
+    writeU64(out, value.size());
+    out.write(value.data(), static_cast<std::streamsize>(value.size()));
+}
+
+bool readString(std::istream &in, std::string &value) {
+    uint64_t size = 0;
+    if(!readU64(in, size) || size > (uint64_t(1) << 32)) {
+        return false;
+    }
+    value.resize(static_cast<size_t>(size));
+    return size == 0 || static_cast<bool>(in.read(value.data(), static_cast<std::streamsize>(size)));
+}
+
+/// Output of earlier runs, keyed by file path and valid while the file's source hash and size are unchanged.
+/// The whole cache is dropped when the tool version, configuration, or selected operations change.
+class LingResultCache {
+    struct Entry {
+        uint64_t sourceHash = 0;
+        uint64_t sourceSize = 0;
+        FileRunOutput output;
+    };
+
+    std::filesystem::path cachePath;
+    std::string fingerprint;
+    mutable std::mutex mutex;
+    std::map<std::string, Entry> entries;
+    size_t reusedCount = 0;
+    bool dirty = false;
+
+public:
+    LingResultCache(std::filesystem::path cachePathIn, std::string fingerprintIn)
+        : cachePath(std::move(cachePathIn)), fingerprint(std::move(fingerprintIn)) {}
+
+    void load() {
+        std::ifstream in(cachePath, std::ios::in | std::ios::binary);
+        if(!in.is_open()) {
+            return;
+        }
+        char magic[sizeof(kResultCacheMagic)] = {};
+        std::string storedFingerprint;
+        uint64_t entryCount = 0;
+        if(!in.read(magic, sizeof(magic)) || !std::equal(magic, magic + sizeof(magic), kResultCacheMagic) ||
+           !readString(in, storedFingerprint) || storedFingerprint != fingerprint || !readU64(in, entryCount)) {
+            return;
+        }
+        std::map<std::string, Entry> loaded;
+        for(uint64_t i = 0; i < entryCount; ++i) {
+            std::string path;
+            Entry entry;
+            uint64_t hadError = 0;
+            if(!readString(in, path) || !readU64(in, entry.sourceHash) || !readU64(in, entry.sourceSize) ||
+               !readString(in, entry.output.out) || !readString(in, entry.output.err) || !readU64(in, hadError)) {
+                return;
+            }
+            entry.output.hadError = hadError != 0;
+            loaded[path] = std::move(entry);
+        }
+        entries = std::move(loaded);
+    }
+
+    bool lookup(const FileAnalysisCache &file, FileRunOutput &outputOut) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = entries.find(file.filePath.generic_string());
+        if(it == entries.end() || it->second.sourceHash != file.session.getSourceHash() ||
+           it->second.sourceSize != file.sourceText.size()) {
+            return false;
+        }
+        outputOut = it->second.output;
+        ++reusedCount;
+        return true;
+    }
+
+    void store(const FileAnalysisCache &file, const FileRunOutput &output) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto &entry = entries[file.filePath.generic_string()];
+        entry.sourceHash = file.session.getSourceHash();
+        entry.sourceSize = file.sourceText.size();
+        entry.output = output;
+        dirty = true;
+    }
+
+    size_t reused() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return reusedCount;
+    }
+
+    bool save(std::string &errorOut) {
+        std::lock_guard<std::mutex> lock(mutex);
+        for(auto it = entries.begin(); it != entries.end();) {
+            std::error_code existsEc;
+            if(!std::filesystem::exists(it->first, existsEc) || existsEc) {
+                it = entries.erase(it);
+                dirty = true;
+            }
+            else {
+                ++it;
+            }
+        }
+        if(!dirty) {
+            return true;
+        }
+
+        std::error_code ec;
+        std::filesystem::create_directories(cachePath.parent_path(), ec);
+        auto tempPath = cachePath;
+        tempPath += ".tmp";
+        {
+            std::ofstream out(tempPath, std::ios::out | std::ios::binary | std::ios::trunc);
+            if(!out.is_open()) {
+                errorOut = "Failed to write result cache: " + tempPath.string();
+                return false;
+            }
+            out.write(kResultCacheMagic, sizeof(kResultCacheMagic));
+            writeString(out, fingerprint);
+            writeU64(out, entries.size());
+            for(const auto &entry : entries) {
+                writeString(out, entry.first);
+                writeU64(out, entry.second.sourceHash);
+                writeU64(out, entry.second.sourceSize);
+                writeString(out, entry.second.output.out);
+                writeString(out, entry.second.output.err);
+                writeU64(out, entry.second.output.hadError ? 1 : 0);
+            }
+            if(!out) {
+                errorOut = "Failed to write result cache: " + tempPath.string();
+                return false;
+            }
+        }
+        std::filesystem::rename(tempPath, cachePath, ec);
+        if(ec) {
+            errorOut = "Failed to replace result cache: " + cachePath.string();
+            return false;
+        }
+        dirty = false;
+        return true;
+    }
+};
+
+std::string resultCacheFingerprint(const LingOptions &opts,
+                                   const starbytes::linguistics::LinguisticsConfig &config,
+                                   bool multiFile) {
+    std::string out;
+#ifdef STARBYTES_VERSION
+    out += "version=" STARBYTES_STRINGIFY(STARBYTES_VERSION) ";";
+#endif
+    out += "lint=" + std::to_string(opts.lint ? 1 : 0) + ";";
+    out += "lintMode=" + std::to_string(static_cast<unsigned>(opts.lintMode)) + ";";
+    out += "suggest=" + std::to_string(opts.suggest ? 1 : 0) + ";";
+    out += "codeActions=" + std::to_string(opts.codeActions ? 1 : 0) + ";";
+    out += "prettyWrite=" + std::to_string(opts.prettyWrite ? 1 : 0) + ";";
+    out += "applySafeFixes=" + std::to_string(opts.applySafeFixes ? 1 : 0) + ";";
+    out += "dryRun=" + std::to_string(opts.dryRun ? 1 : 0) + ";";
+    out += "multiFile=" + std::to_string(multiFile ? 1 : 0) + ";";
+    out += config.fingerprint();
+    return out;
+}
+
 bool hasOperationOutput(const LingOptions &opts) {
     return opts.prettyWrite || opts.lint || opts.suggest || opts.codeActions || opts.applySafeFixes;
 }
@@ -765,10 +1092,6 @@ int main(int argc, const char *argv[]) {
     }
 
     auto config = starbytes::linguistics::LinguisticsConfig::defaults();
-    starbytes::linguistics::LintEngine lintEngine;
-    starbytes::linguistics::SuggestionEngine suggestionEngine;
-    starbytes::linguistics::CodeActionEngine codeActionEngine;
-    starbytes::linguistics::FormatterEngine formatterEngine;
 
     std::vector<FileAnalysisCache> fileCaches;
     fileCaches.reserve(discovery.files.size());
@@ -783,101 +1106,88 @@ int main(int argc, const char *argv[]) {
     bool multiFile = fileCaches.size() > 1 || inputWasDirectory;
     bool hadError = false;
 
-    for(auto &file : fileCaches) {
-        std::string loadError;
-        if(!loadFileAnalysis(file, loadError)) {
-            std::cerr << loadError << std::endl;
-            hadError = true;
-            continue;
+    std::unique_ptr<LingResultCache> resultCache;
+    // Writing safe fixes changes the sources, so those runs always analyze.
+    if(opts.useCache && !(opts.applySafeFixes && !opts.dryRun)) {
+        std::filesystem::path cacheRoot;
+        if(!opts.cacheDir.empty()) {
+            cacheRoot = opts.cacheDir;
         }
-
-        auto printHeader = [&](const char *operationLabel) {
-            if(!multiFile) {
-                return;
+        else {
+            auto baseRoot = inputWasDirectory ? inputPath : inputPath.parent_path();
+            if(baseRoot.empty()) {
+                baseRoot = std::filesystem::current_path();
             }
-            std::cout << "== [" << operationLabel << "] " << file.filePath.generic_string() << " ==\n";
-        };
-
-            if(opts.lint) {
-                printHeader("lint");
-                if(opts.lintMode != LintMode::SemanticOnly) {
-                    const auto &syntaxDiagnostics = ensureSyntaxDiagnostics(file);
-                    printSyntaxDiagnostics(syntaxDiagnostics, std::cout);
-                    if(ensureCompilerAnalysis(file).syntaxHadError) {
-                        hadError = true;
-                    }
-                }
-            if(opts.lintMode != LintMode::SyntaxOnly) {
-                std::cout << starbytes::linguistics::LinguisticsSerializer::toText(
-                                 ensureLintResult(file, config, lintEngine))
-                          << '\n';
-            }
-        }
-
-        if(opts.suggest) {
-            printHeader("suggest");
-            printSuggestions(ensureSuggestionResult(file, config, suggestionEngine), std::cout);
-        }
-
-        if(opts.codeActions) {
-            printHeader("code-actions");
-            printActions(ensureCodeActionResult(file, false, config, lintEngine, suggestionEngine, codeActionEngine),
-                         std::cout);
+            cacheRoot = baseRoot / ".starbytes" / ".cache";
         }
+        resultCache = std::make_unique<LingResultCache>(cacheRoot / "ling_results.v1",
+                                                        resultCacheFingerprint(opts, config, multiFile));
+        resultCache->load();
+    }
 
-        if(opts.prettyWrite) {
-            printHeader("pretty-write");
-            const auto &formatResult = ensureFormatResult(file, config, formatterEngine);
-            if(!formatResult.ok) {
-                std::cerr << "Failed to format source in --pretty-write mode: "
-                          << file.filePath.generic_string() << std::endl;
-                hadError = true;
+    std::vector<FileRunOutput> outputs(fileCaches.size());
+    std::vector<char> finished(fileCaches.size(), 0);
+    std::mutex outputMutex;
+    std::condition_variable outputReady;
+    std::atomic<size_t> nextFile{0};
+
+    auto worker = [&]() {
+        LingEngines engines;
+        for(size_t index = nextFile.fetch_add(1); index < fileCaches.size(); index = nextFile.fetch_add(1)) {
+            auto &file = fileCaches[index];
+            FileRunOutput output;
+            std::string loadError;
+            if(!loadFileAnalysis(file, loadError)) {
+                output.err = loadError + "\n";
+                output.hadError = true;
             }
-            else {
-                std::cout << formatResult.formattedText;
-                if(multiFile && !formatResult.formattedText.empty() && formatResult.formattedText.back() != '\n') {
-                    std::cout << '\n';
-                }
-                for(const auto &note : formatResult.notes) {
-                    std::cerr << file.filePath.generic_string() << ": " << note << std::endl;
+            else if(!resultCache || !resultCache->lookup(file, output)) {
+                runFileOperations(file, opts, config, engines, multiFile, output);
+                if(resultCache) {
+                    resultCache->store(file, output);
                 }
             }
+            // Drop the parsed module as soon as its output is rendered.
+            file = FileAnalysisCache{};
+            {
+                std::lock_guard<std::mutex> lock(outputMutex);
+                outputs[index] = std::move(output);
+                finished[index] = 1;
+            }
+            outputReady.notify_all();
         }
+    };
 
-        if(opts.applySafeFixes) {
-            const auto &safeActions =
-                ensureCodeActionResult(file, true, config, lintEngine, suggestionEngine, codeActionEngine);
-
-            std::vector<starbytes::linguistics::TextEdit> edits;
-            edits.reserve(safeActions.actions.size());
-            for(const auto &action : safeActions.actions) {
-                edits.insert(edits.end(), action.edits.begin(), action.edits.end());
-            }
+    std::vector<std::thread> workers;
+    size_t workerCount = std::max<size_t>(1, std::min(opts.jobs, fileCaches.size()));
+    workers.reserve(workerCount);
+    for(size_t i = 0; i < workerCount; ++i) {
+        workers.emplace_back(worker);
+    }
 
-            auto previewText = file.sourceText;
-            auto appliedCount = applyEditsDeterministically(previewText, edits);
+    for(size_t index = 0; index < outputs.size(); ++index) {
+        FileRunOutput output;
+        {
+            std::unique_lock<std::mutex> lock(outputMutex);
+            outputReady.wait(lock, [&] { return finished[index] != 0; });
+            output = std::move(outputs[index]);
+        }
+        std::cout << output.out << std::flush;
+        std::cerr << output.err << std::flush;
+        hadError = hadError || output.hadError;
+    }
+    for(auto &thread : workers) {
+        thread.join();
+    }
 
-            if(opts.dryRun) {
-                printHeader("apply-safe-fixes dry-run");
-                std::cout << "dry-run safe-fix edits: " << appliedCount << "\n";
-                std::cout << previewText;
-                if(!previewText.empty() && previewText.back() != '\n') {
-                    std::cout << '\n';
-                }
-            }
-            else {
-                std::ofstream outFile(file.filePath, std::ios::out | std::ios::trunc);
-                if(!outFile.is_open()) {
-                    std::cerr << "Failed to open file for --apply-safe-fixes: "
-                              << file.filePath.generic_string() << std::endl;
-                    hadError = true;
-                }
-                else {
-                    outFile << previewText;
-                    std::cerr << "Applied safe fixes: " << appliedCount
-                              << " (" << file.filePath.generic_string() << ")" << std::endl;
-                }
-            }
+    if(resultCache) {
+        std::string cacheError;
+        if(!resultCache->save(cacheError)) {
+            std::cerr << cacheError << std::endl;
+        }
+        if(opts.cacheStats) {
+            std::cerr << "ling-cache: reused " << resultCache->reused() << " of " << fileCaches.size() << " file(s)"
+                      << std::endl;
         }
     }
 
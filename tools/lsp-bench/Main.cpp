@@ -0,0 +1,1064 @@
+#include "../lsp/ServerMain.h"
+
+#include "starbytes/base/CmdLine.h"
+
+#include <rapidjson/document.h>
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+#define STARBYTES_STRINGIFY_IMPL(x) #x
+#define STARBYTES_STRINGIFY(x) STARBYTES_STRINGIFY_IMPL(x)
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+const char *kWorkspaceUriPlaceholder = "${WORKSPACE_URI}";
+const char *kDiagnosticsMethod = "textDocument/publishDiagnostics";
+
+struct ParseResult {
+    bool ok = false;
+    int exitCode = 1;
+    std::string error;
+};
+
+struct BenchOptions {
+    bool showHelp = false;
+    bool showVersion = false;
+    size_t files = 100;
+    size_t functionsPerFile = 20;
+    size_t bursts = 8;
+    size_t queries = 20;
+    uint64_t typingIntervalMs = 30;
+    uint64_t pauseMs = 400;
+    uint64_t timeoutMs = 30000;
+    std::string replayPath;
+    std::string recordPath;
+    std::string outputPath;
+    std::string baselinePath;
+    std::string workspaceDir;
+    bool keepWorkspace = false;
+    double failOnRegression = -1.0;
+};
+
+/// One message of a session script. `delayMs` is the pause before it is sent;
+/// an awaited step blocks until every request sent so far has been answered.
+struct ScriptStep {
+    uint64_t delayMs = 0;
+    bool await = false;
+    std::string message;
+};
+
+struct SessionScript {
+    size_t files = 0;
+    size_t functionsPerFile = 0;
+    std::vector<ScriptStep> steps;
+};
+
+struct MethodStats {
+    size_t count = 0;
+    size_t missing = 0;
+    double p50Ms = 0;
+    double p95Ms = 0;
+    double p99Ms = 0;
+    double maxMs = 0;
+    double meanMs = 0;
+};
+
+struct BenchReport {
+    size_t files = 0;
+    size_t functionsPerFile = 0;
+    size_t steps = 0;
+    std::string scriptSource;
+    double wallMs = 0;
+    uint64_t peakRssBytes = 0;
+    std::map<std::string, MethodStats> methods;
+};
+
+void printUsage(std::ostream &out) {
+    out << "Usage:\n";
+    out << "  starbytes-lsp-bench [--files <n>] [--functions-per-file <n>] [--output <report.json>]\n";
+    out << "  starbytes-lsp-bench --record <session.ndjson> [options]\n";
+    out << "  starbytes-lsp-bench --replay <session.ndjson> [--baseline <report.json>]\n";
+    out << "  starbytes-lsp-bench --help\n";
+    out << "  starbytes-lsp-bench --version\n";
+}
+
+void printHelp(std::ostream &out) {
+    out << "Starbytes LSP Latency Benchmark\n\n";
+    printUsage(out);
+    out << "\nOptions:\n";
+    out << "  -h, --help                   Show help.\n";
+    out << "  -V, --version                Show tool version.\n";
+    out << "      --files <n>              Modules in the generated workspace (default 100).\n";
+    out << "      --functions-per-file <n> Functions per generated module (default 20).\n";
+    out << "      --bursts <n>             Typing bursts in the generated session (default 8).\n";
+    out << "      --queries <n>            Query rounds after typing (default 20).\n";
+    out << "      --typing-interval-ms <n> Delay between typed characters (default 30).\n";
+    out << "      --pause-ms <n>           Delay between typing bursts (default 400).\n";
+    out << "      --timeout-ms <n>         Give up waiting for responses after n ms (default 30000).\n";
+    out << "      --record <file>          Write the generated session script before running it.\n";
+    out << "      --replay <file>          Run a recorded session script instead of generating one.\n";
+    out << "  -o, --output <file>          Write the report as JSON.\n";
+    out << "      --baseline <file>        Compare p95 latency and peak RSS with an earlier JSON report.\n";
+    out << "      --fail-on-regression <%> With --baseline, exit 1 if any p95 grows by more than <%>.\n";
+    out << "      --workspace-dir <dir>    Generate the workspace in <dir> and keep it.\n";
+    out << "      --keep-workspace         Keep the generated temporary workspace.\n";
+}
+
+void printVersion(std::ostream &out) {
+#ifdef STARBYTES_VERSION
+    out << "starbytes-lsp-bench " << STARBYTES_STRINGIFY(STARBYTES_VERSION) << '\n';
+#else
+    out << "starbytes-lsp-bench (version unknown)" << '\n';
+#endif
+}
+
+bool parseCount(const starbytes::cl::ParseResult &parsed, const std::string &name, uint64_t &out) {
+    auto value = parsed.firstValue(name);
+    if(!value.has_value()) {
+        return true;
+    }
+    try {
+        out = static_cast<uint64_t>(std::stoull(*value));
+    }
+    catch(...) {
+        return false;
+    }
+    return true;
+}
+
+ParseResult parseArgs(int argc, const char *argv[], BenchOptions &opts) {
+    starbytes::cl::Parser parser;
+    parser.addCommand("help");
+
+    parser.addFlagOption("help", {"h"});
+    parser.addFlagOption("version", {"V"});
+    parser.addValueOption("files");
+    parser.addValueOption("functions-per-file");
+    parser.addValueOption("bursts");
+    parser.addValueOption("queries");
+    parser.addValueOption("typing-interval-ms");
+    parser.addValueOption("pause-ms");
+    parser.addValueOption("timeout-ms");
+    parser.addValueOption("record");
+    parser.addValueOption("replay");
+    parser.addValueOption("output", {"o"});
+    parser.addValueOption("baseline");
+    parser.addValueOption("fail-on-regression");
+    parser.addValueOption("workspace-dir");
+    parser.addFlagOption("keep-workspace");
+
+    auto parsed = parser.parse(argc, argv);
+    if(!parsed.ok) {
+        return {false, parsed.exitCode, parsed.error};
+    }
+
+    opts.showHelp = parsed.command == "help" || parsed.hasFlag("help");
+    opts.showVersion = parsed.hasFlag("version");
+    if(opts.showHelp || opts.showVersion) {
+        return {true, 0, ""};
+    }
+    if(!parsed.positionals.empty()) {
+        return {false, 1, "Unexpected positional argument: " + parsed.positionals.front()};
+    }
+
+    struct CountOption {
+        const char *name;
+        uint64_t value;
+    };
+    CountOption counts[] = {
+        {"files", opts.files},
+        {"functions-per-file", opts.functionsPerFile},
+        {"bursts", opts.bursts},
+        {"queries", opts.queries},
+        {"typing-interval-ms", opts.typingIntervalMs},
+        {"pause-ms", opts.pauseMs},
+        {"timeout-ms", opts.timeoutMs},
+    };
+    for(auto &count : counts) {
+        if(!parseCount(parsed, count.name, count.value)) {
+            return {false, 1, std::string("Invalid value for --") + count.name + "."};
+        }
+    }
+    opts.files = static_cast<size_t>(counts[0].value);
+    opts.functionsPerFile = static_cast<size_t>(counts[1].value);
+    opts.bursts = static_cast<size_t>(counts[2].value);
+    opts.queries = static_cast<size_t>(counts[3].value);
+    opts.typingIntervalMs = counts[4].value;
+    opts.pauseMs = counts[5].value;
+    opts.timeoutMs = counts[6].value;
+    if(opts.files < 2 || opts.functionsPerFile == 0) {
+        return {false, 1, "--files must be at least 2 and --functions-per-file at least 1."};
+    }
+
+    opts.recordPath = parsed.firstValue("record").value_or("");
+    opts.replayPath = parsed.firstValue("replay").value_or("");
+    opts.outputPath = parsed.firstValue("output").value_or("");
+    opts.baselinePath = parsed.firstValue("baseline").value_or("");
+    opts.workspaceDir = parsed.firstValue("workspace-dir").value_or("");
+    opts.keepWorkspace = parsed.hasFlag("keep-workspace") || !opts.workspaceDir.empty();
+    if(!opts.recordPath.empty() && !opts.replayPath.empty()) {
+        return {false, 1, "--record and --replay are mutually exclusive."};
+    }
+    if(auto threshold = parsed.firstValue("fail-on-regression"); threshold.has_value()) {
+        try {
+            opts.failOnRegression = std::stod(*threshold);
+        }
+        catch(...) {
+            return {false, 1, "Invalid value for --fail-on-regression."};
+        }
+        if(opts.baselinePath.empty()) {
+            return {false, 1, "--fail-on-regression requires --baseline."};
+        }
+    }
+    return {true, 0, ""};
+}
+
+std::string jsonEscape(const std::string &value) {
+    std::string out;
+    out.reserve(value.size() + 16);
+    for(char ch : value) {
+        switch(ch) {
+            case '"':
+                out += "\\\"";
+                break;
+            case '\\':
+                out += "\\\\";
+                break;
+            case '\n':
+                out += "\\n";
+                break;
+            case '\r':
+                out += "\\r";
+                break;
+            case '\t':
+                out += "\\t";
+                break;
+            default:
+                out.push_back(ch);
+                break;
+        }
+    }
+    return out;
+}
+
+std::string replaceAll(std::string text, const std::string &from, const std::string &to) {
+    size_t pos = 0;
+    while((pos = text.find(from, pos)) != std::string::npos) {
+        text.replace(pos, from.size(), to);
+        pos += to.size();
+    }
+    return text;
+}
+
+std::string serializeValue(const rapidjson::Value &value) {
+    rapidjson::StringBuffer buffer;
+    rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+    value.Accept(writer);
+    return std::string(buffer.GetString(), buffer.GetSize());
+}
+
+std::string idKey(const rapidjson::Value &id) {
+    if(id.IsString()) {
+        return std::string("s:") + id.GetString();
+    }
+    if(id.IsInt64()) {
+        return std::to_string(id.GetInt64());
+    }
+    if(id.IsUint64()) {
+        return std::to_string(id.GetUint64());
+    }
+    return {};
+}
+
+// Workspace generation ---------------------------------------------------------
+
+std::string moduleName(size_t index) {
+    return "Mod" + std::to_string(index);
+}
+
+std::string functionName(size_t module, size_t function) {
+    return "mod" + std::to_string(module) + "_fn" + std::to_string(function);
+}
+
+std::string coreModuleText() {
+    return "/// Shared value used by every module.\n"
+           "func coreValue(x:Int) Int {\n"
+           "  return x + 1\n"
+           "}\n";
+}
+
+/// Each function occupies six lines: doc comment, signature, two body lines, closing brace and a blank line.
+std::vector<std::string> moduleLines(size_t module, size_t functionsPerFile) {
+    std::vector<std::string> lines{"import Core", ""};
+    for(size_t fn = 0; fn < functionsPerFile; ++fn) {
+        lines.push_back("/// Generated function " + std::to_string(fn) + " of " + moduleName(module) + ".");
+        lines.push_back("func " + functionName(module, fn) + "(a:Int) Int {");
+        lines.push_back("  decl local:Int = Core.coreValue(a)");
+        lines.push_back("  return local * 2");
+        lines.push_back("}");
+        lines.push_back("");
+    }
+    return lines;
+}
+
+std::string joinLines(const std::vector<std::string> &lines) {
+    std::string text;
+    for(const auto &line : lines) {
+        text += line;
+        text.push_back('\n');
+    }
+    return text;
+}
+
+bool writeWorkspace(const std::filesystem::path &root, size_t files, size_t functionsPerFile, std::string &error) {
+    std::error_code ec;
+    std::filesystem::create_directories(root / "Core", ec);
+    if(ec) {
+        error = "Failed to create workspace directory " + root.string() + ": " + ec.message();
+        return false;
+    }
+    auto writeFile = [&](const std::filesystem::path &path, const std::string &text) {
+        std::ofstream out(path, std::ios::out | std::ios::trunc | std::ios::binary);
+        if(!out.is_open()) {
+            error = "Failed to write " + path.string();
+            return false;
+        }
+        out << text;
+        return true;
+    };
+    if(!writeFile(root / "Core" / "main.starb", coreModuleText())) {
+        return false;
+    }
+    for(size_t module = 0; module < files; ++module) {
+        auto dir = root / moduleName(module);
+        std::filesystem::create_directories(dir, ec);
+        if(ec || !writeFile(dir / "main.starb", joinLines(moduleLines(module, functionsPerFile)))) {
+            if(error.empty()) {
+                error = "Failed to create " + dir.string();
+            }
+            return false;
+        }
+    }
+    return true;
+}
+
+std::filesystem::path createTempWorkspaceRoot() {
+    auto tempRoot = std::filesystem::temp_directory_path();
+    auto seed = static_cast<unsigned>(std::time(nullptr));
+    for(unsigned attempt = 0; attempt < 512; ++attempt) {
+        auto candidate = tempRoot / ("starbytes-lsp-bench-" + std::to_string(seed + attempt));
+        std::error_code ec;
+        if(std::filesystem::create_directory(candidate, ec) && !ec) {
+            return candidate;
+        }
+    }
+    return {};
+}
+
+// Session generation -----------------------------------------------------------
+
+class SessionBuilder {
+    SessionScript &script;
+    int nextId = 1;
+
+public:
+    explicit SessionBuilder(SessionScript &script) : script(script) {}
+
+    void notify(uint64_t delayMs, const std::string &method, const std::string &params) {
+        script.steps.push_back({delayMs, false, R"({"jsonrpc":"2.0","method":")" + method + R"(","params":)" + params + "}"});
+    }
+
+    void request(uint64_t delayMs, bool await, const std::string &method, const std::string &params) {
+        script.steps.push_back({delayMs, await,
+                                R"({"jsonrpc":"2.0","id":)" + std::to_string(nextId++) + R"(,"method":")" + method +
+                                    R"(","params":)" + params + "}"});
+    }
+};
+
+std::string moduleUri(size_t module) {
+    return std::string(kWorkspaceUriPlaceholder) + "/" + moduleName(module) + "/main.starb";
+}
+
+std::string positionParams(const std::string &uri, size_t line, size_t character, const std::string &extra = "") {
+    return R"({"textDocument":{"uri":")" + uri + R"("},"position":{"line":)" + std::to_string(line) +
+           R"(,"character":)" + std::to_string(character) + "}" + extra + "}";
+}
+
+std::string openParams(const std::string &uri, const std::string &text) {
+    return R"({"textDocument":{"uri":")" + uri + R"(","languageId":"starbytes","version":1,"text":")" +
+           jsonEscape(text) + R"("}})";
+}
+
+/// Open a few modules, type into one of them with completion after each identifier character,
+/// then query hover, definition, references, and rename on the symbol every module imports,
+/// along with semantic tokens for the edited module and workspace symbols.
+SessionScript generateSession(const BenchOptions &opts) {
+    SessionScript script;
+    script.files = opts.files;
+    script.functionsPerFile = opts.functionsPerFile;
+    SessionBuilder builder(script);
+
+    const std::string root = kWorkspaceUriPlaceholder;
+    builder.request(0, true, "initialize",
+                    R"({"processId":null,"rootUri":")" + root + R"(","workspaceFolders":[{"uri":")" + root +
+                        R"(","name":"lsp-bench"}],"capabilities":{}})");
+    builder.notify(0, "initialized", "{}");
+
+    const std::string coreUri = root + "/Core/main.starb";
+    builder.notify(0, "textDocument/didOpen", openParams(coreUri, coreModuleText()));
+    auto typed = moduleLines(0, opts.functionsPerFile);
+    builder.notify(0, "textDocument/didOpen", openParams(moduleUri(0), joinLines(typed)));
+    builder.notify(0, "textDocument/didOpen", openParams(moduleUri(1), joinLines(moduleLines(1, opts.functionsPerFile))));
+
+    int version = 1;
+    for(size_t burst = 0; burst < opts.bursts; ++burst) {
+        auto signature = "func " + functionName(0, burst % opts.functionsPerFile) + "(";
+        size_t line = 0;
+        while(line < typed.size() && typed[line].rfind(signature, 0) != 0) {
+            ++line;
+        }
+        ++line;
+        size_t character = typed[line].size();
+        const std::string insertion = "\n  decl typed" + std::to_string(burst) + ":Int = Core.coreValue(local)";
+        for(size_t i = 0; i < insertion.size(); ++i) {
+            char ch = insertion[i];
+            auto delay = i == 0 ? opts.pauseMs : opts.typingIntervalMs;
+            builder.notify(delay, "textDocument/didChange",
+                           R"({"textDocument":{"uri":")" + moduleUri(0) + R"(","version":)" + std::to_string(++version) +
+                               R"(},"contentChanges":[{"range":{"start":{"line":)" + std::to_string(line) +
+                               R"(,"character":)" + std::to_string(character) + R"(},"end":{"line":)" +
+                               std::to_string(line) + R"(,"character":)" + std::to_string(character) +
+                               R"(}},"text":")" + jsonEscape(std::string(1, ch)) + R"("}]})");
+            if(ch == '\n') {
+                ++line;
+                character = 0;
+                continue;
+            }
+            ++character;
+            if(std::isalnum(static_cast<unsigned char>(ch)) || ch == '_' || ch == '.') {
+                builder.request(0, false, "textDocument/completion", positionParams(moduleUri(0), line, character));
+            }
+        }
+        typed.insert(typed.begin() + static_cast<std::ptrdiff_t>(line), insertion.substr(1));
+    }
+
+    const std::string callLine = "  decl local:Int = Core.coreValue(a)";
+    const size_t coreValueColumn = callLine.find("coreValue") + 2;
+    for(size_t round = 0; round < opts.queries; ++round) {
+        size_t line = 2 + 6 * (round % opts.functionsPerFile) + 2;
+        auto uri = moduleUri(1);
+        auto delay = round == 0 ? opts.pauseMs : 0;
+        builder.request(delay, true, "textDocument/hover", positionParams(uri, line, coreValueColumn));
+        builder.request(0, true, "textDocument/definition", positionParams(uri, line, coreValueColumn));
+        builder.request(0, true, "textDocument/references",
+                        positionParams(uri, line, coreValueColumn, R"(,"context":{"includeDeclaration":true})"));
+        builder.request(0, true, "textDocument/prepareRename", positionParams(uri, line, coreValueColumn));
+        builder.request(0, true, "textDocument/rename",
+                        positionParams(uri, line, coreValueColumn, R"(,"newName":"coreValueRenamed")"));
+        builder.request(0, true, "textDocument/semanticTokens/full", R"({"textDocument":{"uri":")" + moduleUri(0) + R"("}})");
+        builder.request(0, true, "workspace/symbol", R"({"query":"fn)" + std::to_string(round % opts.functionsPerFile) + R"("})");
+    }
+
+    builder.request(0, true, "shutdown", "null");
+    builder.notify(0, "exit", "{}");
+    return script;
+}
+
+bool writeScript(const SessionScript &script, const std::string &path, std::string &error) {
+    std::ofstream out(path, std::ios::out | std::ios::trunc | std::ios::binary);
+    if(!out.is_open()) {
+        error = "Failed to write session script " + path;
+        return false;
+    }
+    out << R"({"starbytesLspBench":1,"workspace":{"files":)" << script.files << R"(,"functionsPerFile":)"
+        << script.functionsPerFile << "}}\n";
+    for(const auto &step : script.steps) {
+        out << R"({"delayMs":)" << step.delayMs << R"(,"await":)" << (step.await ? "true" : "false")
+            << R"(,"message":)" << step.message << "}\n";
+    }
+    return true;
+}
+
+bool readScript(const std::string &path, SessionScript &script, std::string &error) {
+    std::ifstream in(path, std::ios::in | std::ios::binary);
+    if(!in.is_open()) {
+        error = "Failed to read session script " + path;
+        return false;
+    }
+    std::string line;
+    size_t lineNumber = 0;
+    bool sawHeader = false;
+    while(std::getline(in, line)) {
+        ++lineNumber;
+        if(line.empty() || line == "\r") {
+            continue;
+        }
+        rapidjson::Document doc;
+        doc.Parse(line.c_str(), line.size());
+        if(doc.HasParseError() || !doc.IsObject()) {
+            error = path + ":" + std::to_string(lineNumber) + ": invalid JSON";
+            return false;
+        }
+        if(!sawHeader) {
+            sawHeader = true;
+            if(!doc.HasMember("workspace") || !doc["workspace"].IsObject()) {
+                error = path + ": first line must be the workspace header";
+                return false;
+            }
+            auto &workspace = doc["workspace"];
+            if(workspace.HasMember("files") && workspace["files"].IsUint64()) {
+                script.files = static_cast<size_t>(workspace["files"].GetUint64());
+            }
+            if(workspace.HasMember("functionsPerFile") && workspace["functionsPerFile"].IsUint64()) {
+                script.functionsPerFile = static_cast<size_t>(workspace["functionsPerFile"].GetUint64());
+            }
+            continue;
+        }
+        if(!doc.HasMember("message") || !doc["message"].IsObject()) {
+            error = path + ":" + std::to_string(lineNumber) + ": step has no message object";
+            return false;
+        }
+        ScriptStep step;
+        if(doc.HasMember("delayMs") && doc["delayMs"].IsUint64()) {
+            step.delayMs = doc["delayMs"].GetUint64();
+        }
+        step.await = doc.HasMember("await") && doc["await"].IsBool() && doc["await"].GetBool();
+        step.message = serializeValue(doc["message"]);
+        script.steps.push_back(std::move(step));
+    }
+    if(script.files < 2 || script.functionsPerFile == 0) {
+        error = path + ": workspace header needs files >= 2 and functionsPerFile >= 1";
+        return false;
+    }
+    return true;
+}
+
+// Server streams ----------------------------------------------------------------
+
+/// Input side of the server: blocks the reader thread until the bench pushes more bytes or closes it.
+class BlockingInputBuffer : public std::streambuf {
+    std::mutex mutex;
+    std::condition_variable ready;
+    std::string queued;
+    std::string current;
+    bool closed = false;
+
+protected:
+    int_type underflow() override {
+        if(gptr() < egptr()) {
+            return traits_type::to_int_type(*gptr());
+        }
+        std::unique_lock<std::mutex> lock(mutex);
+        ready.wait(lock, [&] { return !queued.empty() || closed; });
+        if(queued.empty()) {
+            return traits_type::eof();
+        }
+        current.swap(queued);
+        queued.clear();
+        setg(current.data(), current.data(), current.data() + current.size());
+        return traits_type::to_int_type(*gptr());
+    }
+
+public:
+    void push(const std::string &body) {
+        std::lock_guard<std::mutex> lock(mutex);
+        queued += "Content-Length: " + std::to_string(body.size()) + "\r\n\r\n";
+        queued += body;
+        ready.notify_one();
+    }
+
+    void close() {
+        std::lock_guard<std::mutex> lock(mutex);
+        closed = true;
+        ready.notify_one();
+    }
+};
+
+/// Tracks in-flight requests and document versions and turns server output into latency samples.
+class LatencyRecorder {
+    struct Pending {
+        std::string method;
+        Clock::time_point sentAt;
+    };
+
+    std::mutex mutex;
+    std::condition_variable answered;
+    std::map<std::string, Pending> pendingRequests;
+    std::map<std::string, Clock::time_point> documentVersions;
+    std::map<std::string, std::vector<double>> samples;
+    std::map<std::string, size_t> missing;
+
+    static std::string versionKey(const std::string &uri, int64_t version) {
+        return uri + "#" + std::to_string(version);
+    }
+
+    static double elapsedMs(Clock::time_point from, Clock::time_point to) {
+        return std::chrono::duration<double, std::milli>(to - from).count();
+    }
+
+public:
+    void sent(const rapidjson::Document &message, Clock::time_point at) {
+        std::string method = message.HasMember("method") && message["method"].IsString() ? message["method"].GetString() : "";
+        std::lock_guard<std::mutex> lock(mutex);
+        if(message.HasMember("id")) {
+            auto key = idKey(message["id"]);
+            if(!key.empty()) {
+                pendingRequests[key] = {method, at};
+            }
+            return;
+        }
+        if(method != "textDocument/didOpen" && method != "textDocument/didChange") {
+            return;
+        }
+        if(!message.HasMember("params") || !message["params"].IsObject()) {
+            return;
+        }
+        auto &params = message["params"];
+        if(!params.HasMember("textDocument") || !params["textDocument"].IsObject()) {
+            return;
+        }
+        auto &textDocument = params["textDocument"];
+        if(textDocument.HasMember("uri") && textDocument["uri"].IsString() && textDocument.HasMember("version") &&
+           textDocument["version"].IsInt64()) {
+            documentVersions[versionKey(textDocument["uri"].GetString(), textDocument["version"].GetInt64())] = at;
+        }
+    }
+
+    void received(const std::string &body, Clock::time_point at) {
+        rapidjson::Document message;
+        message.Parse(body.c_str(), body.size());
+        if(message.HasParseError() || !message.IsObject()) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        if(message.HasMember("method")) {
+            if(!message["method"].IsString() || std::string(message["method"].GetString()) != kDiagnosticsMethod ||
+               !message.HasMember("params") || !message["params"].IsObject()) {
+                return;
+            }
+            auto &params = message["params"];
+            if(!params.HasMember("uri") || !params["uri"].IsString() || !params.HasMember("version") ||
+               !params["version"].IsInt64()) {
+                return;
+            }
+            auto found = documentVersions.find(versionKey(params["uri"].GetString(), params["version"].GetInt64()));
+            if(found != documentVersions.end()) {
+                samples[kDiagnosticsMethod].push_back(elapsedMs(found->second, at));
+                documentVersions.erase(found);
+            }
+            return;
+        }
+        if(!message.HasMember("id")) {
+            return;
+        }
+        auto found = pendingRequests.find(idKey(message["id"]));
+        if(found == pendingRequests.end()) {
+            return;
+        }
+        samples[found->second.method].push_back(elapsedMs(found->second.sentAt, at));
+        pendingRequests.erase(found);
+        answered.notify_all();
+    }
+
+    bool waitForAll(std::chrono::milliseconds timeout) {
+        std::unique_lock<std::mutex> lock(mutex);
+        return answered.wait_for(lock, timeout, [&] { return pendingRequests.empty(); });
+    }
+
+    /// Requests still unanswered are counted as missing; superseded document versions are not,
+    /// since the server only publishes diagnostics for the latest version.
+    void finish(std::map<std::string, std::vector<double>> &samplesOut, std::map<std::string, size_t> &missingOut) {
+        std::lock_guard<std::mutex> lock(mutex);
+        for(const auto &pending : pendingRequests) {
+            ++missing[pending.second.method];
+        }
+        pendingRequests.clear();
+        samplesOut = std::move(samples);
+        missingOut = std::move(missing);
+    }
+};
+
+/// Output side of the server: splits the framed stream into messages when the server flushes.
+class CapturingOutputBuffer : public std::streambuf {
+    LatencyRecorder &recorder;
+    std::string pending;
+
+    void drainFrames(Clock::time_point at) {
+        while(true) {
+            auto headerEnd = pending.find("\r\n\r\n");
+            if(headerEnd == std::string::npos) {
+                return;
+            }
+            auto lengthPos = pending.find("Content-Length:");
+            if(lengthPos == std::string::npos || lengthPos > headerEnd) {
+                pending.erase(0, headerEnd + 4);
+                continue;
+            }
+            size_t length = static_cast<size_t>(std::strtoull(pending.c_str() + lengthPos + 15, nullptr, 10));
+            if(pending.size() < headerEnd + 4 + length) {
+                return;
+            }
+            recorder.received(pending.substr(headerEnd + 4, length), at);
+            pending.erase(0, headerEnd + 4 + length);
+        }
+    }
+
+protected:
+    int_type overflow(int_type ch) override {
+        if(!traits_type::eq_int_type(ch, traits_type::eof())) {
+            pending.push_back(traits_type::to_char_type(ch));
+        }
+        return traits_type::not_eof(ch);
+    }
+
+    std::streamsize xsputn(const char *data, std::streamsize count) override {
+        pending.append(data, static_cast<size_t>(count));
+        return count;
+    }
+
+    int sync() override {
+        drainFrames(Clock::now());
+        return 0;
+    }
+
+public:
+    explicit CapturingOutputBuffer(LatencyRecorder &recorder) : recorder(recorder) {}
+};
+
+// Reporting ---------------------------------------------------------------------
+
+uint64_t peakRssBytes() {
+#ifdef _WIN32
+    return 0;
+#else
+    struct rusage usage {};
+    if(getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+#ifdef __APPLE__
+    return static_cast<uint64_t>(usage.ru_maxrss);
+#else
+    return static_cast<uint64_t>(usage.ru_maxrss) * 1024;
+#endif
+#endif
+}
+
+/// Nearest-rank percentile over sorted samples.
+double percentile(const std::vector<double> &sorted, double pct) {
+    if(sorted.empty()) {
+        return 0;
+    }
+    auto rank = static_cast<size_t>(std::ceil(pct / 100.0 * static_cast<double>(sorted.size())));
+    return sorted[std::min(sorted.size(), std::max<size_t>(rank, 1)) - 1];
+}
+
+MethodStats summarize(std::vector<double> samples, size_t missing) {
+    MethodStats stats;
+    stats.count = samples.size();
+    stats.missing = missing;
+    if(samples.empty()) {
+        return stats;
+    }
+    std::sort(samples.begin(), samples.end());
+    stats.p50Ms = percentile(samples, 50);
+    stats.p95Ms = percentile(samples, 95);
+    stats.p99Ms = percentile(samples, 99);
+    stats.maxMs = samples.back();
+    double total = 0;
+    for(double sample : samples) {
+        total += sample;
+    }
+    stats.meanMs = total / static_cast<double>(samples.size());
+    return stats;
+}
+
+void printReport(const BenchReport &report, std::ostream &out) {
+    out << "workspace: " << report.files << " file(s) x " << report.functionsPerFile << " function(s), script: "
+        << report.scriptSource << " (" << report.steps << " message(s))\n";
+    out << std::left << std::setw(36) << "method" << std::right << std::setw(7) << "count" << std::setw(9) << "missing"
+        << std::setw(10) << "p50 ms" << std::setw(10) << "p95 ms" << std::setw(10) << "p99 ms" << std::setw(10)
+        << "max ms" << '\n';
+    out << std::fixed << std::setprecision(2);
+    for(const auto &entry : report.methods) {
+        const auto &stats = entry.second;
+        out << std::left << std::setw(36) << entry.first << std::right << std::setw(7) << stats.count << std::setw(9)
+            << stats.missing << std::setw(10) << stats.p50Ms << std::setw(10) << stats.p95Ms << std::setw(10)
+            << stats.p99Ms << std::setw(10) << stats.maxMs << '\n';
+    }
+    out << "wall: " << report.wallMs << " ms, peak RSS: " << std::setprecision(1)
+        << static_cast<double>(report.peakRssBytes) / (1024.0 * 1024.0) << " MiB\n";
+    out.unsetf(std::ios::floatfield);
+    out << std::setprecision(6);
+}
+
+std::string reportToJson(const BenchReport &report) {
+    rapidjson::Document doc(rapidjson::kObjectType);
+    auto &alloc = doc.GetAllocator();
+    doc.AddMember("tool", rapidjson::Value("starbytes-lsp-bench", alloc), alloc);
+#ifdef STARBYTES_VERSION
+    doc.AddMember("version", rapidjson::Value(STARBYTES_STRINGIFY(STARBYTES_VERSION), alloc), alloc);
+#endif
+    rapidjson::Value workspace(rapidjson::kObjectType);
+    workspace.AddMember("files", static_cast<uint64_t>(report.files), alloc);
+    workspace.AddMember("functionsPerFile", static_cast<uint64_t>(report.functionsPerFile), alloc);
+    doc.AddMember("workspace", workspace, alloc);
+    rapidjson::Value script(rapidjson::kObjectType);
+    script.AddMember("source", rapidjson::Value(report.scriptSource.c_str(), alloc), alloc);
+    script.AddMember("messages", static_cast<uint64_t>(report.steps), alloc);
+    doc.AddMember("script", script, alloc);
+    doc.AddMember("wallMs", report.wallMs, alloc);
+    doc.AddMember("peakRssBytes", report.peakRssBytes, alloc);
+    rapidjson::Value methods(rapidjson::kObjectType);
+    for(const auto &entry : report.methods) {
+        const auto &stats = entry.second;
+        rapidjson::Value method(rapidjson::kObjectType);
+        method.AddMember("count", static_cast<uint64_t>(stats.count), alloc);
+        method.AddMember("missing", static_cast<uint64_t>(stats.missing), alloc);
+        method.AddMember("p50Ms", stats.p50Ms, alloc);
+        method.AddMember("p95Ms", stats.p95Ms, alloc);
+        method.AddMember("p99Ms", stats.p99Ms, alloc);
+        method.AddMember("maxMs", stats.maxMs, alloc);
+        method.AddMember("meanMs", stats.meanMs, alloc);
+        rapidjson::Value name(entry.first.c_str(), alloc);
+        methods.AddMember(name, method, alloc);
+    }
+    doc.AddMember("methods", methods, alloc);
+    return serializeValue(doc);
+}
+
+bool readBaseline(const std::string &path, BenchReport &baseline, std::string &error) {
+    std::ifstream in(path, std::ios::in | std::ios::binary);
+    if(!in.is_open()) {
+        error = "Failed to read baseline " + path;
+        return false;
+    }
+    std::stringstream buffer;
+    buffer << in.rdbuf();
+    auto text = buffer.str();
+    rapidjson::Document doc;
+    doc.Parse(text.c_str(), text.size());
+    if(doc.HasParseError() || !doc.IsObject() || !doc.HasMember("methods") || !doc["methods"].IsObject()) {
+        error = path + " is not a starbytes-lsp-bench report";
+        return false;
+    }
+    if(doc.HasMember("peakRssBytes") && doc["peakRssBytes"].IsUint64()) {
+        baseline.peakRssBytes = doc["peakRssBytes"].GetUint64();
+    }
+    auto &methods = doc["methods"];
+    for(auto it = methods.MemberBegin(); it != methods.MemberEnd(); ++it) {
+        if(!it->value.IsObject() || !it->value.HasMember("p95Ms") || !it->value["p95Ms"].IsNumber()) {
+            continue;
+        }
+        baseline.methods[it->name.GetString()].p95Ms = it->value["p95Ms"].GetDouble();
+    }
+    return true;
+}
+
+/// Prints p95 changes per method and returns the largest relative growth in percent.
+double compareWithBaseline(const BenchReport &report, const BenchReport &baseline, std::ostream &out) {
+    double worst = 0;
+    out << "\nbaseline comparison (p95):\n" << std::fixed << std::setprecision(2);
+    for(const auto &entry : report.methods) {
+        auto found = baseline.methods.find(entry.first);
+        if(found == baseline.methods.end()) {
+            out << "  " << std::left << std::setw(36) << entry.first << std::right << " new\n";
+            continue;
+        }
+        double before = found->second.p95Ms;
+        double after = entry.second.p95Ms;
+        double change = before > 0 ? (after - before) / before * 100.0 : 0;
+        worst = std::max(worst, change);
+        out << "  " << std::left << std::setw(36) << entry.first << std::right << std::setw(10) << before << " -> "
+            << std::setw(10) << after << " ms  " << std::showpos << change << std::noshowpos << "%\n";
+    }
+    if(baseline.peakRssBytes > 0 && report.peakRssBytes > 0) {
+        double change = (static_cast<double>(report.peakRssBytes) - static_cast<double>(baseline.peakRssBytes)) /
+                        static_cast<double>(baseline.peakRssBytes) * 100.0;
+        out << "  " << std::left << std::setw(36) << "peak RSS" << std::right << std::showpos << change << std::noshowpos
+            << "%\n";
+    }
+    out.unsetf(std::ios::floatfield);
+    out << std::setprecision(6);
+    return worst;
+}
+
+/// Runs the script against an in-process server and collects per-method latency.
+BenchReport runSession(const SessionScript &script, const std::string &workspaceUri, const BenchOptions &opts) {
+    LatencyRecorder recorder;
+    BlockingInputBuffer inputBuffer;
+    CapturingOutputBuffer outputBuffer(recorder);
+    std::istream in(&inputBuffer);
+    std::ostream out(&outputBuffer);
+    starbytes::lsp::ServerOptions serverOptions{in, out};
+
+    auto started = Clock::now();
+    {
+        starbytes::lsp::Server server(serverOptions);
+        std::thread serverThread([&] { server.run(); });
+        const auto timeout = std::chrono::milliseconds(opts.timeoutMs);
+        for(const auto &step : script.steps) {
+            if(step.delayMs > 0) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(step.delayMs));
+            }
+            auto body = replaceAll(step.message, kWorkspaceUriPlaceholder, workspaceUri);
+            rapidjson::Document message;
+            message.Parse(body.c_str(), body.size());
+            if(message.HasParseError() || !message.IsObject()) {
+                continue;
+            }
+            recorder.sent(message, Clock::now());
+            inputBuffer.push(body);
+            if(step.await && !recorder.waitForAll(timeout)) {
+                std::cerr << "starbytes-lsp-bench: timed out waiting for responses" << std::endl;
+            }
+        }
+        recorder.waitForAll(timeout);
+        inputBuffer.close();
+        serverThread.join();
+    }
+
+    BenchReport report;
+    report.wallMs = std::chrono::duration<double, std::milli>(Clock::now() - started).count();
+    report.peakRssBytes = peakRssBytes();
+    report.files = script.files;
+    report.functionsPerFile = script.functionsPerFile;
+    report.steps = script.steps.size();
+
+    std::map<std::string, std::vector<double>> samples;
+    std::map<std::string, size_t> missing;
+    recorder.finish(samples, missing);
+    for(auto &entry : samples) {
+        report.methods[entry.first] = summarize(std::move(entry.second), missing[entry.first]);
+    }
+    for(const auto &entry : missing) {
+        if(!report.methods.count(entry.first)) {
+            report.methods[entry.first] = summarize({}, entry.second);
+        }
+    }
+    return report;
+}
+
+std::string pathToFileUri(const std::filesystem::path &path) {
+    auto generic = path.generic_string();
+    if(!generic.empty() && generic.front() != '/') {
+        generic.insert(generic.begin(), '/');
+    }
+    return "file://" + generic;
+}
+
+} // namespace
+
+int main(int argc, const char *argv[]) {
+    BenchOptions opts;
+    auto parsed = parseArgs(argc, argv, opts);
+    if(!parsed.ok) {
+        if(!parsed.error.empty()) {
+            std::cerr << parsed.error << std::endl;
+        }
+        printUsage(std::cerr);
+        return parsed.exitCode;
+    }
+    if(opts.showVersion) {
+        printVersion(std::cout);
+        return 0;
+    }
+    if(opts.showHelp) {
+        printHelp(std::cout);
+        return 0;
+    }
+
+    std::string error;
+    SessionScript script;
+    std::string scriptSource = "generated";
+    if(!opts.replayPath.empty()) {
+        if(!readScript(opts.replayPath, script, error)) {
+            std::cerr << error << std::endl;
+            return 1;
+        }
+        scriptSource = opts.replayPath;
+    }
+    else {
+        script = generateSession(opts);
+        if(!opts.recordPath.empty() && !writeScript(script, opts.recordPath, error)) {
+            std::cerr << error << std::endl;
+            return 1;
+        }
+    }
+
+    BenchReport baseline;
+    if(!opts.baselinePath.empty() && !readBaseline(opts.baselinePath, baseline, error)) {
+        std::cerr << error << std::endl;
+        return 1;
+    }
+
+    std::filesystem::path workspaceRoot = opts.workspaceDir.empty() ? createTempWorkspaceRoot()
+                                                                   : std::filesystem::path(opts.workspaceDir);
+    if(workspaceRoot.empty()) {
+        std::cerr << "Failed to create a temporary workspace." << std::endl;
+        return 1;
+    }
+    std::error_code ec;
+    workspaceRoot = std::filesystem::absolute(workspaceRoot, ec);
+    if(!writeWorkspace(workspaceRoot, script.files, script.functionsPerFile, error)) {
+        std::cerr << error << std::endl;
+        return 1;
+    }
+
+    auto report = runSession(script, pathToFileUri(workspaceRoot), opts);
+    report.scriptSource = scriptSource;
+    printReport(report, std::cout);
+
+    int exitCode = 0;
+    if(!opts.outputPath.empty()) {
+        std::ofstream out(opts.outputPath, std::ios::out | std::ios::trunc | std::ios::binary);
+        if(!out.is_open()) {
+            std::cerr << "Failed to write report " << opts.outputPath << std::endl;
+            exitCode = 1;
+        }
+        else {
+            out << reportToJson(report) << '\n';
+        }
+    }
+    if(!opts.baselinePath.empty()) {
+        double worst = compareWithBaseline(report, baseline, std::cout);
+        if(opts.failOnRegression >= 0 && worst > opts.failOnRegression) {
+            std::cerr << "p95 regression of " << worst << "% exceeds " << opts.failOnRegression << "%" << std::endl;
+            exitCode = 1;
+        }
+    }
+
+    if(opts.keepWorkspace) {
+        std::cout << "workspace kept at " << workspaceRoot.string() << '\n';
+    }
+    else {
+        std::filesystem::remove_all(workspaceRoot, ec);
+    }
+    return exitCode;
+}
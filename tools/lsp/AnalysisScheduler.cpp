@@ -0,0 +1,199 @@
+#include "AnalysisScheduler.h"
+
+#include <algorithm>
+
+namespace starbytes::lsp {
+
+AnalysisScheduler::AnalysisScheduler(unsigned workerCount,
+                                     std::chrono::milliseconds debounce,
+                                     AnalyzeFn analyze,
+                                     PublishFn publish)
+    : analyze(std::move(analyze)), publish(std::move(publish)), debounce(debounce) {
+  workerCount = std::max(1u, workerCount);
+  workers.reserve(workerCount);
+  for (unsigned i = 0; i < workerCount; ++i) {
+    workers.emplace_back([this] { workerLoop(); });
+  }
+}
+
+AnalysisScheduler::~AnalysisScheduler() { stop(); }
+
+unsigned AnalysisScheduler::defaultWorkerCount() {
+  unsigned hardware = std::thread::hardware_concurrency();
+  if (hardware <= 1) {
+    return 1;
+  }
+  // Keep one core for the dispatch thread so interactive requests are never starved.
+  return std::min(4u, hardware - 1);
+}
+
+bool AnalysisScheduler::hasOutstandingWork() const {
+  for (const auto &entry : uris) {
+    if (entry.second.hasPending || entry.second.running) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void AnalysisScheduler::schedule(AnalysisSnapshot snapshot, bool immediate) {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (stopping) {
+      return;
+    }
+    auto &state = uris[snapshot.uri];
+    ++state.generation;
+    ++statistics.scheduled;
+    if (state.hasPending) {
+      ++statistics.coalesced;
+    }
+    if (state.runningStale) {
+      state.runningStale->store(true);
+    }
+    state.pending = std::move(snapshot);
+    state.hasPending = true;
+    auto now = std::chrono::steady_clock::now();
+    state.deadline = immediate ? now : now + debounce;
+  }
+  wake.notify_all();
+}
+
+void AnalysisScheduler::cancel(const std::string &uri, const std::function<void()> &publishEmpty) {
+  std::lock_guard<std::mutex> lock(mutex);
+  auto it = uris.find(uri);
+  if (it != uris.end()) {
+    auto &state = it->second;
+    ++state.generation;
+    if (state.hasPending) {
+      ++statistics.dropped;
+    }
+    state.hasPending = false;
+    state.pending = {};
+    if (state.runningStale) {
+      state.runningStale->store(true);
+    }
+    if (!state.running) {
+      uris.erase(it);
+    }
+  }
+  if (publishEmpty) {
+    publishEmpty();
+  }
+}
+
+void AnalysisScheduler::flush() {
+  std::unique_lock<std::mutex> lock(mutex);
+  auto now = std::chrono::steady_clock::now();
+  for (auto &entry : uris) {
+    if (entry.second.hasPending) {
+      entry.second.deadline = now;
+    }
+  }
+  wake.notify_all();
+  idle.wait(lock, [&] { return stopping || !hasOutstandingWork(); });
+}
+
+void AnalysisScheduler::stop() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (stopping && workers.empty()) {
+      return;
+    }
+    stopping = true;
+    for (auto &entry : uris) {
+      if (entry.second.runningStale) {
+        entry.second.runningStale->store(true);
+      }
+    }
+  }
+  wake.notify_all();
+  idle.notify_all();
+  for (auto &worker : workers) {
+    if (worker.joinable()) {
+      worker.join();
+    }
+  }
+  workers.clear();
+}
+
+std::vector<AnalysisResult> AnalysisScheduler::takeCompleted() {
+  std::lock_guard<std::mutex> lock(mutex);
+  std::vector<AnalysisResult> out;
+  out.swap(completed);
+  return out;
+}
+
+AnalysisSchedulerStats AnalysisScheduler::stats() {
+  std::lock_guard<std::mutex> lock(mutex);
+  return statistics;
+}
+
+void AnalysisScheduler::workerLoop() {
+  std::unique_lock<std::mutex> lock(mutex);
+  while (!stopping) {
+    auto now = std::chrono::steady_clock::now();
+    std::string readyUri;
+    bool hasWaiting = false;
+    auto nextDeadline = std::chrono::steady_clock::time_point::max();
+    for (auto &entry : uris) {
+      auto &state = entry.second;
+      if (!state.hasPending || state.running) {
+        continue;
+      }
+      if (state.deadline <= now) {
+        if (readyUri.empty() || state.deadline < uris[readyUri].deadline) {
+          readyUri = entry.first;
+        }
+      } else {
+        hasWaiting = true;
+        nextDeadline = std::min(nextDeadline, state.deadline);
+      }
+    }
+
+    if (readyUri.empty()) {
+      if (hasWaiting) {
+        wake.wait_until(lock, nextDeadline);
+      } else {
+        wake.wait(lock);
+      }
+      continue;
+    }
+
+    auto &state = uris[readyUri];
+    auto snapshot = std::move(state.pending);
+    state.pending = {};
+    state.hasPending = false;
+    state.running = true;
+    auto generation = state.generation;
+    auto stale = std::make_shared<std::atomic<bool>>(false);
+    state.runningStale = stale;
+    lock.unlock();
+
+    AnalysisResult result;
+    bool ok = analyze(snapshot, [&stale] { return stale->load(); }, result);
+
+    lock.lock();
+    auto it = uris.find(readyUri);
+    bool current = it != uris.end() && it->second.generation == generation && !stale->load();
+    if (ok && current) {
+      publish(result);
+      completed.push_back(std::move(result));
+      ++statistics.completed;
+    } else {
+      ++statistics.dropped;
+    }
+    if (it != uris.end()) {
+      it->second.running = false;
+      it->second.runningStale.reset();
+      if (!it->second.hasPending) {
+        uris.erase(it);
+      }
+    }
+    // Another worker may be waiting for this uri to finish before it can start the newer snapshot.
+    wake.notify_all();
+    idle.notify_all();
+  }
+}
+
+}
@@ -0,0 +1,121 @@
+#ifndef STARBYTES_LSP_ANALYSISSCHEDULER_H
+#define STARBYTES_LSP_ANALYSISSCHEDULER_H
+
+#include "DocumentAnalysis.h"
+#include "starbytes/linguistics/Analysis.h"
+#include "starbytes/linguistics/Config.h"
+#include "starbytes/linguistics/LintEngine.h"
+#include "starbytes/linguistics/SuggestionEngine.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace starbytes {
+
+namespace Semantics {
+struct SymbolTable;
+}
+
+namespace lsp {
+
+/// Everything a worker needs to analyse one document version without touching server state.
+struct AnalysisSnapshot {
+  std::string uri;
+  int version = 0;
+  uint64_t textHash = 0;
+  /// Shared with the document until its next edit; never copied per queued snapshot.
+  std::shared_ptr<const std::string> text;
+  std::vector<std::string> imports;
+  std::unordered_map<std::string, std::shared_ptr<Semantics::SymbolTable>> dependencyTables;
+  starbytes::linguistics::LinguisticsConfig config;
+};
+
+struct AnalysisResult {
+  std::string uri;
+  int version = 0;
+  uint64_t textHash = 0;
+  std::vector<CompilerDiagnosticEntry> diagnostics;
+  std::vector<starbytes::linguistics::LintFinding> lintFindings;
+  std::vector<starbytes::linguistics::LintRuleTiming> lintRuleTimings;
+  std::vector<starbytes::linguistics::Suggestion> suggestions;
+  /// The parse lint and suggestions ran on, kept so later formatting of the same version reuses it.
+  starbytes::linguistics::SharedLinguisticsArtifact linguisticsArtifact;
+  uint64_t compileNs = 0;
+  uint64_t parseNs = 0;
+  uint64_t lintNs = 0;
+  uint64_t suggestNs = 0;
+};
+
+struct AnalysisSchedulerStats {
+  uint64_t scheduled = 0;
+  uint64_t coalesced = 0;
+  uint64_t completed = 0;
+  uint64_t dropped = 0;
+};
+
+/// Runs document analysis on a small worker pool.
+/// Each uri has at most one pending snapshot (newer edits replace it) and one running job; a newer
+/// snapshot marks the running job stale, and stale results are dropped instead of published.
+class AnalysisScheduler {
+public:
+  using IsStale = std::function<bool()>;
+  using AnalyzeFn = std::function<bool(const AnalysisSnapshot &, const IsStale &, AnalysisResult &)>;
+  using PublishFn = std::function<void(const AnalysisResult &)>;
+
+private:
+  struct UriState {
+    uint64_t generation = 0;
+    bool hasPending = false;
+    AnalysisSnapshot pending;
+    std::chrono::steady_clock::time_point deadline;
+    bool running = false;
+    std::shared_ptr<std::atomic<bool>> runningStale;
+  };
+
+  AnalyzeFn analyze;
+  PublishFn publish;
+  std::chrono::milliseconds debounce;
+  std::mutex mutex;
+  std::condition_variable wake;
+  std::condition_variable idle;
+  std::unordered_map<std::string, UriState> uris;
+  std::vector<AnalysisResult> completed;
+  std::vector<std::thread> workers;
+  AnalysisSchedulerStats statistics;
+  bool stopping = false;
+
+  void workerLoop();
+  bool hasOutstandingWork() const;
+
+public:
+  AnalysisScheduler(unsigned workerCount, std::chrono::milliseconds debounce, AnalyzeFn analyze, PublishFn publish);
+  ~AnalysisScheduler();
+
+  static unsigned defaultWorkerCount();
+
+  /// Queues `snapshot`, replacing any pending one for the same uri. `immediate` skips the debounce window.
+  void schedule(AnalysisSnapshot snapshot, bool immediate);
+  /// Drops pending and running work for `uri`; `publishEmpty` runs under the scheduler lock so it cannot race a worker publish.
+  void cancel(const std::string &uri, const std::function<void()> &publishEmpty = nullptr);
+  /// Runs all pending work without waiting for the debounce window and blocks until workers are idle.
+  void flush();
+  void stop();
+
+  std::vector<AnalysisResult> takeCompleted();
+  AnalysisSchedulerStats stats();
+};
+
+}
+
+}
+
+#endif
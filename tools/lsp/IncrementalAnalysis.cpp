@@ -0,0 +1,569 @@
+#include "IncrementalAnalysis.h"
+
+#include "starbytes/compiler/AST.h"
+#include "starbytes/compiler/Parser.h"
+#include "starbytes/compiler/SymTable.h"
+
+#include <algorithm>
+#include <cctype>
+#include <sstream>
+#include <tuple>
+#include <utility>
+
+namespace starbytes::lsp {
+
+namespace {
+
+class StatementCapturingConsumer final : public ASTStreamConsumer {
+public:
+  std::vector<std::pair<ASTStmt *, bool>> statements;
+  bool acceptsSymbolTableContext() override { return false; }
+  bool acceptsRawStatements() override { return true; }
+  void consumeRawStmt(ASTStmt *stmt, bool semanticAccepted) override { statements.emplace_back(stmt, semanticAccepted); }
+  void consumeDecl(ASTDecl *stmt) override { (void)stmt; }
+  void consumeStmt(ASTStmt *stmt) override { (void)stmt; }
+};
+
+std::string diagnosticPhaseName(Diagnostic::Phase phase) {
+  switch (phase) {
+    case Diagnostic::Phase::Parser:
+      return "parser";
+    case Diagnostic::Phase::Semantic:
+      return "semantic";
+    case Diagnostic::Phase::Runtime:
+      return "runtime";
+    case Diagnostic::Phase::Lsp:
+      return "lsp";
+    case Diagnostic::Phase::Unknown:
+    default:
+      return "unknown";
+  }
+}
+
+/// Parses `text` as module `uri` with the same imports the full document analysis uses.
+struct ModuleParse {
+  std::vector<CompilerDiagnosticEntry> diagnostics;
+  std::vector<std::pair<ASTStmt *, bool>> statements;
+  std::unique_ptr<Semantics::SymbolTable> mainTable;
+  bool syntaxClean = true;
+};
+
+ModuleParse parseModule(const std::string &uri,
+                        const std::string &text,
+                        const std::vector<std::string> &imports,
+                        const IncrementalDiagnostics::DependencyTables &dependencyTables,
+                        const std::shared_ptr<Semantics::SymbolTable> &precedingDeclarations) {
+  ModuleParse result;
+  std::ostringstream sink;
+  auto diagnostics = DiagnosticHandler::createDefault(sink);
+  diagnostics->setOutputMode(DiagnosticHandler::OutputMode::Lsp);
+  diagnostics->setDefaultSourceName(uri);
+  auto *handler = diagnostics.get();
+
+  StatementCapturingConsumer consumer;
+  Parser parser(consumer, std::move(diagnostics));
+  auto parseContext = ModuleParseContext::Create(uri);
+  parseContext.name = uri;
+  for (const auto &importName : imports) {
+    auto depIt = dependencyTables.find(importName);
+    if (depIt == dependencyTables.end() || !depIt->second) {
+      continue;
+    }
+    parseContext.sTableContext.importTables.push_back(depIt->second);
+    if (auto overlay = depIt->second->createImportNamespaceOverlay(importName)) {
+      parseContext.sTableContext.otherTables.push_back(std::move(overlay));
+    }
+  }
+  if (precedingDeclarations) {
+    // The import declarations live in other segments, so register the modules they would have added.
+    for (const auto &importName : imports) {
+      parseContext.sTableContext.main->importModule(importName);
+    }
+    parseContext.sTableContext.otherTables.push_back(precedingDeclarations);
+  }
+  std::istringstream in(text);
+  parser.parseFromStream(in, parseContext);
+  result.statements = std::move(consumer.statements);
+  result.mainTable = std::move(parseContext.sTableContext.main);
+
+  if (!handler) {
+    return result;
+  }
+  auto buffered = handler->collectLspRecords();
+  result.diagnostics.reserve(buffered.size());
+  for (const auto &diag : buffered) {
+    CompilerDiagnosticEntry mapped;
+    if (diag.location.has_value()) {
+      mapped.region = *diag.location;
+    }
+    mapped.severity = diag.isError() ? 1 : 2;
+    mapped.message = diag.message;
+    mapped.id = diag.id;
+    mapped.code = diag.code;
+    mapped.phase = diagnosticPhaseName(diag.phase);
+    mapped.source = "starbytes-compiler";
+    mapped.producerSource = diag.sourceName;
+    mapped.relatedSpans = diag.relatedSpans;
+    mapped.notes = diag.notes;
+    mapped.fixits = diag.fixits;
+    if (diag.phase != Diagnostic::Phase::Semantic) {
+      result.syntaxClean = false;
+    }
+    result.diagnostics.push_back(std::move(mapped));
+  }
+  handler->clear();
+  return result;
+}
+
+std::string locatedDiagnosticId(const CompilerDiagnosticEntry &entry) {
+  std::ostringstream out;
+  out << entry.code << "@";
+  if (!entry.producerSource.empty()) {
+    out << entry.producerSource << ":";
+  }
+  out << entry.region.startLine << ":" << entry.region.startCol;
+  return out.str();
+}
+
+void shiftRegion(Region &region, long long delta) {
+  region.startLine = static_cast<unsigned>(static_cast<long long>(region.startLine) + delta);
+  region.endLine = static_cast<unsigned>(static_cast<long long>(region.endLine) + delta);
+}
+
+/// Moves a diagnostic by `delta` lines, keeping a position-derived id in step with its new location.
+void shiftDiagnostic(CompilerDiagnosticEntry &entry, long long delta) {
+  if (delta == 0) {
+    return;
+  }
+  bool derivedId = entry.id == locatedDiagnosticId(entry);
+  shiftRegion(entry.region, delta);
+  for (auto &related : entry.relatedSpans) {
+    shiftRegion(related.span, delta);
+  }
+  for (auto &fixit : entry.fixits) {
+    shiftRegion(fixit.span, delta);
+  }
+  if (derivedId) {
+    entry.id = locatedDiagnosticId(entry);
+  }
+}
+
+/// Whether every line the diagnostic mentions falls within one-based lines [firstLine, lastLine].
+bool diagnosticWithinLines(const CompilerDiagnosticEntry &entry, unsigned firstLine, unsigned lastLine) {
+  auto within = [&](const Region &region) {
+    return region.startLine >= firstLine && region.startLine <= lastLine && region.endLine >= region.startLine &&
+           region.endLine <= lastLine;
+  };
+  if (!within(entry.region)) {
+    return false;
+  }
+  for (const auto &related : entry.relatedSpans) {
+    if (!within(related.span)) {
+      return false;
+    }
+  }
+  for (const auto &fixit : entry.fixits) {
+    if (!within(fixit.span)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/// Same order `DiagnosticHandler` sorts located records in.
+bool diagnosticLess(const CompilerDiagnosticEntry &lhs, const CompilerDiagnosticEntry &rhs) {
+  return std::tie(lhs.producerSource, lhs.region.startLine, lhs.region.startCol, lhs.region.endLine, lhs.region.endCol,
+                  lhs.severity, lhs.code, lhs.message, lhs.id) <
+         std::tie(rhs.producerSource, rhs.region.startLine, rhs.region.startCol, rhs.region.endLine, rhs.region.endCol,
+                  rhs.severity, rhs.code, rhs.message, rhs.id);
+}
+
+void appendDeclaredNames(ASTDecl *decl, std::vector<std::string> &namesOut) {
+  if (!decl) {
+    return;
+  }
+  switch (decl->type) {
+    case VAR_DECL: {
+      for (auto &spec : static_cast<ASTVarDecl *>(decl)->specs) {
+        if (spec.id) {
+          namesOut.push_back(spec.id->val);
+        }
+      }
+      break;
+    }
+    case FUNC_DECL: {
+      auto *funcDecl = static_cast<ASTFuncDecl *>(decl);
+      if (funcDecl->funcId) {
+        namesOut.push_back(funcDecl->funcId->val);
+      }
+      break;
+    }
+    case CLASS_DECL: {
+      auto *classDecl = static_cast<ASTClassDecl *>(decl);
+      if (classDecl->id) {
+        namesOut.push_back(classDecl->id->val);
+      }
+      break;
+    }
+    case INTERFACE_DECL: {
+      auto *interfaceDecl = static_cast<ASTInterfaceDecl *>(decl);
+      if (interfaceDecl->id) {
+        namesOut.push_back(interfaceDecl->id->val);
+      }
+      break;
+    }
+    case TYPE_ALIAS_DECL: {
+      auto *aliasDecl = static_cast<ASTTypeAliasDecl *>(decl);
+      if (aliasDecl->id) {
+        namesOut.push_back(aliasDecl->id->val);
+      }
+      break;
+    }
+    case SECURE_DECL:
+      appendDeclaredNames(static_cast<ASTSecureDecl *>(decl)->guardedDecl, namesOut);
+      break;
+    default:
+      break;
+  }
+}
+
+/// A function header declares its return type when anything other than whitespace follows the parameter list.
+bool headerDeclaresReturnType(const std::string &header) {
+  auto close = header.rfind(')');
+  if (close == std::string::npos) {
+    return false;
+  }
+  for (size_t i = close + 1; i < header.size(); ++i) {
+    if (!std::isspace(static_cast<unsigned char>(header[i]))) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool mentionsIdentifier(const std::string &text, const std::string &name) {
+  auto isIdentifierChar = [](char c) { return std::isalnum(static_cast<unsigned char>(c)) != 0 || c == '_'; };
+  for (auto pos = text.find(name); pos != std::string::npos; pos = text.find(name, pos + 1)) {
+    bool startsWord = pos == 0 || !isIdentifierChar(text[pos - 1]);
+    bool endsWord = pos + name.size() >= text.size() || !isIdentifierChar(text[pos + name.size()]);
+    if (startsWord && endsWord) {
+      return true;
+    }
+  }
+  return false;
+}
+
+std::string segmentHeader(const std::string &text, const TopLevelSegment &segment) {
+  if (segment.bodyOffset == std::string::npos) {
+    return {};
+  }
+  return text.substr(segment.offset, segment.bodyOffset);
+}
+
+unsigned countNewlines(const std::string &text) {
+  return static_cast<unsigned>(std::count(text.begin(), text.end(), '\n'));
+}
+
+}
+
+std::vector<TopLevelSegment> splitTopLevelSegments(const std::string &text) {
+  std::vector<TopLevelSegment> segments;
+  if (text.empty()) {
+    return segments;
+  }
+
+  TopLevelSegment current;
+  int depth = 0;
+  bool inString = false;
+  bool inLineComment = false;
+  bool inBlockComment = false;
+  bool segmentHasCode = false;
+  char lineFirst = '\0';
+  unsigned line = 0;
+
+  for (size_t i = 0; i < text.size(); ++i) {
+    char c = text[i];
+    if (c == '\n') {
+      ++line;
+      inLineComment = false;
+      if (lineFirst != '\0' && lineFirst != '@') {
+        segmentHasCode = true;
+      }
+      lineFirst = '\0';
+      if (depth == 0 && !inString && !inBlockComment && segmentHasCode) {
+        current.length = i + 1 - current.offset;
+        segments.push_back(current);
+        current = {};
+        current.offset = i + 1;
+        current.line = line;
+        segmentHasCode = false;
+      }
+      continue;
+    }
+    if (inLineComment) {
+      continue;
+    }
+    if (inBlockComment) {
+      if (c == '*' && i + 1 < text.size() && text[i + 1] == '/') {
+        inBlockComment = false;
+        ++i;
+      }
+      continue;
+    }
+    if (inString) {
+      if (c == '"') {
+        inString = false;
+      }
+      continue;
+    }
+    if (c == '/' && i + 1 < text.size() && (text[i + 1] == '/' || text[i + 1] == '*')) {
+      inLineComment = text[i + 1] == '/';
+      inBlockComment = !inLineComment;
+      ++i;
+      continue;
+    }
+    if (std::isspace(static_cast<unsigned char>(c))) {
+      continue;
+    }
+    if (lineFirst == '\0') {
+      lineFirst = c;
+    }
+    switch (c) {
+      case '"':
+        inString = true;
+        break;
+      case '(':
+      case '[':
+        ++depth;
+        break;
+      case '{':
+        if (depth == 0 && current.bodyOffset == std::string::npos) {
+          current.bodyOffset = i - current.offset;
+        }
+        ++depth;
+        break;
+      case ')':
+      case ']':
+      case '}':
+        if (--depth < 0) {
+          TopLevelSegment whole;
+          whole.length = text.size();
+          whole.bodyOffset = std::string::npos;
+          return {whole};
+        }
+        break;
+      default:
+        break;
+    }
+  }
+
+  if (depth != 0) {
+    TopLevelSegment whole;
+    whole.length = text.size();
+    return {whole};
+  }
+  if (current.offset < text.size()) {
+    current.length = text.size() - current.offset;
+    segments.push_back(current);
+  }
+  return segments;
+}
+
+std::unique_ptr<IncrementalDiagnostics::DocumentRecord> IncrementalDiagnostics::take(const std::string &uri) {
+  std::lock_guard<std::mutex> lock(mutex);
+  auto it = documents.find(uri);
+  if (it == documents.end()) {
+    return nullptr;
+  }
+  auto record = std::move(it->second);
+  documents.erase(it);
+  return record;
+}
+
+void IncrementalDiagnostics::put(const std::string &uri, std::unique_ptr<DocumentRecord> record) {
+  std::lock_guard<std::mutex> lock(mutex);
+  documents[uri] = std::move(record);
+}
+
+std::vector<CompilerDiagnosticEntry> IncrementalDiagnostics::analyze(const std::string &uri,
+                                                                     const std::string &text,
+                                                                     const std::vector<std::string> &imports,
+                                                                     const DependencyTables &dependencyTables) {
+  auto segments = splitTopLevelSegments(text);
+  auto previous = take(uri);
+
+  auto assemble = [](const DocumentRecord &record) {
+    std::vector<CompilerDiagnosticEntry> out;
+    for (const auto &segment : record.segments) {
+      for (auto entry : segment.diagnostics) {
+        shiftDiagnostic(entry, segment.line);
+        out.push_back(std::move(entry));
+      }
+    }
+    std::stable_sort(out.begin(), out.end(), diagnosticLess);
+    return out;
+  };
+
+  // Find the single segment an edit touched; every other segment must be byte-identical.
+  size_t changed = segments.size();
+  bool reusable = previous && previous->incremental && previous->imports == imports &&
+                  previous->dependencyTables == dependencyTables && previous->segments.size() == segments.size();
+  for (size_t i = 0; reusable && i < segments.size(); ++i) {
+    const auto &old = previous->segments[i];
+    if (old.text.size() == segments[i].length && text.compare(segments[i].offset, segments[i].length, old.text) == 0) {
+      continue;
+    }
+    reusable = changed == segments.size();
+    changed = i;
+  }
+
+  if (reusable && changed == segments.size()) {
+    auto out = assemble(*previous);
+    put(uri, std::move(previous));
+    std::lock_guard<std::mutex> lock(mutex);
+    ++statistics.unchangedAnalyses;
+    return out;
+  }
+
+  if (reusable) {
+    auto &old = previous->segments[changed];
+    const auto &segment = segments[changed];
+    auto header = segmentHeader(text, segment);
+    bool signatureKept = old.reusableFunction && !header.empty() &&
+                         old.text.compare(0, header.size(), header) == 0 && old.text.size() > header.size() &&
+                         old.text[header.size()] == '{';
+    if (signatureKept) {
+      // Only the declarations before this one were visible to it in the full analysis.
+      auto preceding = std::make_shared<Semantics::SymbolTable>();
+      for (size_t i = 0; i < changed; ++i) {
+        if (!previous->segments[i].declared) {
+          continue;
+        }
+        for (const auto &name : previous->segments[i].declaredNames) {
+          if (const auto *entries = previous->moduleTable->findEntriesInExactScope(name, ASTScopeGlobal)) {
+            for (auto *entry : *entries) {
+              preceding->addSymbolInScope(entry, ASTScopeGlobal);
+            }
+          }
+        }
+      }
+
+      auto segmentText = text.substr(segment.offset, segment.length);
+      auto parsed = parseModule(uri, segmentText, imports, dependencyTables, preceding);
+      unsigned lineCount = countNewlines(segmentText);
+      bool accepted = parsed.syntaxClean && parsed.statements.size() == 1 &&
+                      parsed.statements.front().first->type == FUNC_DECL;
+      bool declared = accepted && parsed.statements.front().second;
+      for (const auto &entry : parsed.diagnostics) {
+        accepted = accepted && diagnosticWithinLines(entry, 1, lineCount + 1);
+      }
+      if (accepted && declared != old.declared) {
+        // Whether the function is declared changes what other segments resolve, so none of them may use it.
+        for (size_t i = 0; accepted && i < previous->segments.size(); ++i) {
+          if (i == changed) {
+            continue;
+          }
+          for (const auto &name : old.declaredNames) {
+            accepted = accepted && !mentionsIdentifier(previous->segments[i].text, name);
+          }
+        }
+      }
+      if (accepted) {
+        long long lineDelta = static_cast<long long>(lineCount) - static_cast<long long>(old.lineCount);
+        old.text = std::move(segmentText);
+        old.lineCount = lineCount;
+        old.declared = declared;
+        old.diagnostics = std::move(parsed.diagnostics);
+        for (size_t i = changed + 1; i < previous->segments.size(); ++i) {
+          previous->segments[i].line = static_cast<unsigned>(static_cast<long long>(previous->segments[i].line) + lineDelta);
+        }
+        auto out = assemble(*previous);
+        put(uri, std::move(previous));
+        std::lock_guard<std::mutex> lock(mutex);
+        ++statistics.incrementalAnalyses;
+        return out;
+      }
+    }
+  }
+
+  auto parsed = parseModule(uri, text, imports, dependencyTables, nullptr);
+  auto record = std::make_unique<DocumentRecord>();
+  record->imports = imports;
+  record->dependencyTables = dependencyTables;
+  record->moduleTable = std::shared_ptr<Semantics::SymbolTable>(parsed.mainTable.release());
+  record->incremental = parsed.syntaxClean && !segments.empty();
+  record->segments.resize(segments.size());
+  for (size_t i = 0; i < segments.size(); ++i) {
+    auto &segmentRecord = record->segments[i];
+    segmentRecord.text = text.substr(segments[i].offset, segments[i].length);
+    segmentRecord.line = segments[i].line;
+    segmentRecord.lineCount = countNewlines(segmentRecord.text);
+  }
+
+  auto segmentForLine = [&](unsigned oneBasedLine) -> SegmentRecord * {
+    if (oneBasedLine == 0 || record->segments.empty()) {
+      return nullptr;
+    }
+    auto it = std::upper_bound(record->segments.begin(), record->segments.end(), oneBasedLine - 1,
+                               [](unsigned line, const SegmentRecord &segment) { return line < segment.line; });
+    if (it == record->segments.begin()) {
+      return nullptr;
+    }
+    --it;
+    return oneBasedLine - 1 <= it->line + it->lineCount ? &*it : nullptr;
+  };
+
+  std::vector<unsigned> statementCounts(segments.size(), 0);
+  std::vector<std::pair<ASTStmt *, bool>> soleStatements(segments.size(), {nullptr, false});
+  for (const auto &statement : parsed.statements) {
+    auto *segmentRecord = segmentForLine(statement.first->codeRegion.startLine);
+    if (!segmentRecord) {
+      record->incremental = false;
+      continue;
+    }
+    size_t index = static_cast<size_t>(segmentRecord - record->segments.data());
+    ++statementCounts[index];
+    soleStatements[index] = statement;
+    if (statement.first->type == SCOPE_DECL) {
+      // Namespace members are not reachable through top-level names, so they cannot be re-exposed.
+      record->incremental = false;
+    }
+    if (statement.first->type & DECL) {
+      appendDeclaredNames(static_cast<ASTDecl *>(statement.first), segmentRecord->declaredNames);
+    }
+  }
+  for (size_t i = 0; i < segments.size(); ++i) {
+    const auto &sole = soleStatements[i];
+    record->segments[i].reusableFunction = statementCounts[i] == 1 && sole.first->type == FUNC_DECL && sole.second &&
+                                           headerDeclaresReturnType(segmentHeader(text, segments[i]));
+  }
+
+  for (const auto &entry : parsed.diagnostics) {
+    auto *segmentRecord = segmentForLine(entry.region.startLine);
+    if (!segmentRecord ||
+        !diagnosticWithinLines(entry, segmentRecord->line + 1, segmentRecord->line + segmentRecord->lineCount + 1)) {
+      record->incremental = false;
+      continue;
+    }
+    auto relative = entry;
+    shiftDiagnostic(relative, -static_cast<long long>(segmentRecord->line));
+    segmentRecord->diagnostics.push_back(std::move(relative));
+  }
+
+  put(uri, std::move(record));
+  std::lock_guard<std::mutex> lock(mutex);
+  ++statistics.fullAnalyses;
+  return std::move(parsed.diagnostics);
+}
+
+void IncrementalDiagnostics::forget(const std::string &uri) {
+  std::lock_guard<std::mutex> lock(mutex);
+  documents.erase(uri);
+}
+
+IncrementalDiagnosticsStats IncrementalDiagnostics::stats() const {
+  std::lock_guard<std::mutex> lock(mutex);
+  return statistics;
+}
+
+}
@@ -0,0 +1,98 @@
+#ifndef STARBYTES_LSP_INCREMENTALANALYSIS_H
+#define STARBYTES_LSP_INCREMENTALANALYSIS_H
+
+#include "DocumentAnalysis.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace starbytes {
+
+namespace Semantics {
+struct SymbolTable;
+}
+
+namespace lsp {
+
+/// A run of whole lines holding one top-level declaration, plus any attribute and comment lines before it.
+struct TopLevelSegment {
+  size_t offset = 0;
+  size_t length = 0;
+  /// Zero-based line of the segment's first byte.
+  unsigned line = 0;
+  /// Bytes before the first top-level `{`; `npos` when the segment has no braced body.
+  size_t bodyOffset = std::string::npos;
+};
+
+/// Splits `text` at line ends that close a top-level statement, skipping strings and comments.
+/// Falls back to a single segment when brackets do not balance.
+std::vector<TopLevelSegment> splitTopLevelSegments(const std::string &text);
+
+struct IncrementalDiagnosticsStats {
+  uint64_t fullAnalyses = 0;
+  uint64_t incrementalAnalyses = 0;
+  uint64_t unchangedAnalyses = 0;
+};
+
+/// Compiler diagnostics for open documents, re-analyzing only the declaration an edit touched.
+/// Each document keeps the module symbol table and per-segment diagnostics of its last full analysis.
+/// When an edit stays inside the body of one function whose signature (everything before its body,
+/// including an explicit return type) is unchanged, only that function is parsed and checked, against
+/// the declarations that precede it; every other segment's diagnostics are reused and shifted. A body that
+/// stops (or starts) checking is still handled incrementally when no other segment mentions the function.
+/// Anything else, including syntax errors anywhere in the document, takes the full analysis path.
+class IncrementalDiagnostics final {
+public:
+  using DependencyTables = std::unordered_map<std::string, std::shared_ptr<Semantics::SymbolTable>>;
+
+private:
+  struct SegmentRecord {
+    std::string text;
+    unsigned line = 0;
+    unsigned lineCount = 0;
+    /// Set when the segment is exactly one function that passed semantic checks with a declared return type.
+    bool reusableFunction = false;
+    /// Cleared while an incremental re-check rejects the function, which a full analysis would leave undeclared.
+    bool declared = true;
+    std::vector<std::string> declaredNames;
+    /// Line numbers are relative to the segment's first line.
+    std::vector<CompilerDiagnosticEntry> diagnostics;
+  };
+
+  struct DocumentRecord {
+    std::vector<std::string> imports;
+    DependencyTables dependencyTables;
+    std::shared_ptr<Semantics::SymbolTable> moduleTable;
+    std::vector<SegmentRecord> segments;
+    /// Cleared by syntax errors, unlocated or cross-segment diagnostics, and namespace scopes.
+    bool incremental = false;
+  };
+
+  mutable std::mutex mutex;
+  std::unordered_map<std::string, std::unique_ptr<DocumentRecord>> documents;
+  IncrementalDiagnosticsStats statistics;
+
+  std::unique_ptr<DocumentRecord> take(const std::string &uri);
+  void put(const std::string &uri, std::unique_ptr<DocumentRecord> record);
+
+public:
+  /// Thread-safe. A call that overlaps another for the same uri runs a full analysis instead of waiting.
+  std::vector<CompilerDiagnosticEntry> analyze(const std::string &uri,
+                                               const std::string &text,
+                                               const std::vector<std::string> &imports,
+                                               const DependencyTables &dependencyTables);
+  void forget(const std::string &uri);
+
+  IncrementalDiagnosticsStats stats() const;
+};
+
+}
+
+}
+
+#endif
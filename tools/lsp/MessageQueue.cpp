@@ -0,0 +1,120 @@
+#include "MessageQueue.h"
+
+namespace starbytes::lsp {
+
+namespace {
+
+constexpr size_t MAX_SPARE_BODIES = 8;
+constexpr size_t MAX_SPARE_BODY_CAPACITY = 1 << 20;
+
+}
+
+MessagePriority messagePriorityForMethod(const std::string &method) {
+  if (method == "textDocument/completion" || method == "completionItem/resolve" || method == "textDocument/hover" ||
+      method == "textDocument/signatureHelp" || method == "textDocument/documentHighlight" ||
+      method == "textDocument/definition" || method == "textDocument/declaration" ||
+      method == "textDocument/typeDefinition" || method == "textDocument/implementation" ||
+      method == "textDocument/prepareRename") {
+    return MessagePriority::Interactive;
+  }
+  if (method == "workspace/symbol" || method == "workspace/diagnostic" || method == "textDocument/diagnostic" ||
+      method == "textDocument/references" || method == "textDocument/rename" ||
+      method == "textDocument/semanticTokens" || method == "textDocument/semanticTokens/full" ||
+      method == "textDocument/semanticTokens/full/delta" || method == "textDocument/semanticTokens/edits" ||
+      method == "textDocument/semanticTokens/range" || method == "textDocument/foldingRange" ||
+      method == "textDocument/documentSymbol" || method == "textDocument/codeAction" ||
+      method == "textDocument/formatting" || method == "textDocument/rangeFormatting") {
+    return MessagePriority::Background;
+  }
+  return MessagePriority::Normal;
+}
+
+bool messageIsBarrier(const std::string &method, bool isRequest) {
+  if (!isRequest) {
+    return true;
+  }
+  return method == "initialize" || method == "shutdown";
+}
+
+void MessageQueue::push(std::unique_ptr<rapidjson::Document> document, MessagePriority priority, bool barrier,
+                        std::vector<char> body) {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    QueuedMessage message;
+    message.sequence = nextSequence++;
+    message.priority = priority;
+    message.barrier = barrier;
+    message.body = std::move(body);
+    message.document = std::move(document);
+    pending.push_back(std::move(message));
+  }
+  ready.notify_one();
+}
+
+void MessageQueue::close() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    closed = true;
+  }
+  ready.notify_all();
+}
+
+bool MessageQueue::pop(QueuedMessage &messageOut) {
+  return popUntil(messageOut, std::chrono::steady_clock::time_point::max()) == PopResult::Message;
+}
+
+MessageQueue::PopResult MessageQueue::popUntil(QueuedMessage &messageOut, std::chrono::steady_clock::time_point deadline) {
+  std::unique_lock<std::mutex> lock(mutex);
+  auto hasWork = [&] { return !pending.empty() || closed; };
+  if (deadline == std::chrono::steady_clock::time_point::max()) {
+    ready.wait(lock, hasWork);
+  } else if (!ready.wait_until(lock, deadline, hasWork)) {
+    return PopResult::TimedOut;
+  }
+  if (pending.empty()) {
+    return PopResult::Closed;
+  }
+  takeNext(messageOut);
+  return PopResult::Message;
+}
+
+void MessageQueue::takeNext(QueuedMessage &messageOut) {
+  size_t best = 0;
+  for (size_t i = 0; i < pending.size(); ++i) {
+    if (pending[i].barrier) {
+      break;
+    }
+    if (pending[i].priority < pending[best].priority) {
+      best = i;
+    }
+  }
+  messageOut = std::move(pending[best]);
+  pending.erase(pending.begin() + static_cast<std::ptrdiff_t>(best));
+}
+
+std::vector<char> MessageQueue::takeBody() {
+  std::lock_guard<std::mutex> lock(mutex);
+  if (spareBodies.empty()) {
+    return {};
+  }
+  auto body = std::move(spareBodies.back());
+  spareBodies.pop_back();
+  return body;
+}
+
+void MessageQueue::recycleBody(std::vector<char> body) {
+  if (body.capacity() == 0 || body.capacity() > MAX_SPARE_BODY_CAPACITY) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(mutex);
+  if (spareBodies.size() < MAX_SPARE_BODIES) {
+    spareBodies.push_back(std::move(body));
+  }
+}
+
+size_t MessageQueue::size() {
+  std::lock_guard<std::mutex> lock(mutex);
+  return pending.size();
+}
+
+}
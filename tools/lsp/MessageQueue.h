@@ -0,0 +1,65 @@
+#ifndef STARBYTES_LSP_MESSAGEQUEUE_H
+#define STARBYTES_LSP_MESSAGEQUEUE_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <rapidjson/document.h>
+
+namespace starbytes::lsp {
+
+enum class MessagePriority : int {
+  Interactive = 0,
+  Normal = 1,
+  Background = 2
+};
+
+struct QueuedMessage {
+  uint64_t sequence = 0;
+  MessagePriority priority = MessagePriority::Normal;
+  bool barrier = false;
+  /// The raw message text; a document parsed in situ points into it, so it is declared first to outlive it.
+  std::vector<char> body;
+  std::unique_ptr<rapidjson::Document> document;
+};
+
+MessagePriority messagePriorityForMethod(const std::string &method);
+/// Document sync notifications and lifecycle requests must observe every message that arrived before them.
+bool messageIsBarrier(const std::string &method, bool isRequest);
+
+/// Hand-off between the reader thread and the dispatch thread.
+/// Requests are popped by priority, but never ahead of a barrier that arrived before them.
+class MessageQueue {
+  std::mutex mutex;
+  std::condition_variable ready;
+  std::deque<QueuedMessage> pending;
+  std::vector<std::vector<char>> spareBodies;
+  uint64_t nextSequence = 0;
+  bool closed = false;
+
+  void takeNext(QueuedMessage &messageOut);
+
+public:
+  enum class PopResult { Message, TimedOut, Closed };
+
+  void push(std::unique_ptr<rapidjson::Document> document, MessagePriority priority, bool barrier,
+            std::vector<char> body = {});
+  /// Message buffers are recycled once dispatched, so the reader rarely allocates one.
+  std::vector<char> takeBody();
+  void recycleBody(std::vector<char> body);
+  void close();
+  bool pop(QueuedMessage &messageOut);
+  /// Like `pop`, but gives up at `deadline`; `time_point::max()` waits indefinitely.
+  PopResult popUntil(QueuedMessage &messageOut, std::chrono::steady_clock::time_point deadline);
+  size_t size();
+};
+
+}
+
+#endif
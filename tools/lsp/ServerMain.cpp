@@ -23,6 +23,7 @@
 #include <sstream>
 #include <string>
 #include <regex>
+#include <thread>
 #include <utility>
 
 #include <rapidjson/stringbuffer.h>
@@ -91,22 +92,6 @@ bool envTruthy(const char *value) {
   return !(text.empty() || text == "0" || text == "false" || text == "off" || text == "no");
 }
 
-std::string diagnosticPhaseToStringLocal(Diagnostic::Phase phase) {
-  switch (phase) {
-    case Diagnostic::Phase::Parser:
-      return "parser";
-    case Diagnostic::Phase::Semantic:
-      return "semantic";
-    case Diagnostic::Phase::Runtime:
-      return "runtime";
-    case Diagnostic::Phase::Lsp:
-      return "lsp";
-    case Diagnostic::Phase::Unknown:
-    default:
-      return "unknown";
-  }
-}
-
 std::vector<std::string> splitCommaList(const std::string &text) {
   std::vector<std::string> out;
   std::string current;
@@ -862,6 +847,54 @@ void appendDeprecatedTagArray(rapidjson::Value &object,
   object.AddMember("tags", tags, alloc);
 }
 
+void writeJsonString(JsonWriter &writer, const std::string &value) {
+  writer.String(value.c_str(), static_cast<rapidjson::SizeType>(value.size()));
+}
+
+void writeDeprecatedTags(JsonWriter &writer, int tagValue) {
+  writer.Key("tags");
+  writer.StartArray();
+  writer.Int(tagValue);
+  writer.EndArray();
+}
+
+void writeRangeJson(JsonWriter &writer, unsigned startLine, unsigned startChar, unsigned endLine, unsigned endChar) {
+  writer.StartObject();
+  writer.Key("start");
+  writer.StartObject();
+  writer.Key("line");
+  writer.Uint(startLine);
+  writer.Key("character");
+  writer.Uint(startChar);
+  writer.EndObject();
+  writer.Key("end");
+  writer.StartObject();
+  writer.Key("line");
+  writer.Uint(endLine);
+  writer.Key("character");
+  writer.Uint(endChar);
+  writer.EndObject();
+  writer.EndObject();
+}
+
+void writeLocationJson(JsonWriter &writer, const std::string &uri, unsigned startLine, unsigned startChar,
+                       unsigned endLine, unsigned endChar) {
+  writer.StartObject();
+  writer.Key("uri");
+  writeJsonString(writer, uri);
+  writer.Key("range");
+  writeRangeJson(writer, startLine, startChar, endLine, endChar);
+  writer.EndObject();
+}
+
+void writeSemanticTokenData(JsonWriter &writer, const std::vector<unsigned> &encoded, size_t begin, size_t end) {
+  writer.StartArray();
+  for (size_t i = begin; i < end; ++i) {
+    writer.Uint(encoded[i]);
+  }
+  writer.EndArray();
+}
+
 rapidjson::Value buildRangeFromRegion(const Region &region, rapidjson::Document::AllocatorType &alloc) {
   rapidjson::Value range(rapidjson::kObjectType);
   rapidjson::Value start(rapidjson::kObjectType);
@@ -1173,13 +1206,66 @@ std::string idToKey(const rapidjson::Value &id) {
   return "unknown";
 }
 
+unsigned envUnsigned(const char *value, unsigned fallback) {
+  if (value == nullptr || *value == '\0') {
+    return fallback;
+  }
+  char *end = nullptr;
+  auto parsed = std::strtoul(value, &end, 10);
+  if (end == value || *end != '\0') {
+    return fallback;
+  }
+  return static_cast<unsigned>(parsed);
+}
+
+bool semanticTokenLess(const SemanticTokenEntry &lhs, const SemanticTokenEntry &rhs) {
+  if (lhs.line != rhs.line) {
+    return lhs.line < rhs.line;
+  }
+  if (lhs.start != rhs.start) {
+    return lhs.start < rhs.start;
+  }
+  if (lhs.length != rhs.length) {
+    return lhs.length < rhs.length;
+  }
+  return lhs.type < rhs.type;
+}
+
+// Only function bodies can change without affecting how identifiers elsewhere in the module resolve.
+bool segmentHeaderDeclaresFunction(const std::string &text, const TopLevelSegment &segment) {
+  if (segment.bodyOffset == std::string::npos) {
+    return false;
+  }
+  std::istringstream in(text.substr(segment.offset, segment.bodyOffset));
+  std::string line;
+  while (std::getline(in, line)) {
+    auto begin = line.find_first_not_of(" \t\r");
+    if (begin == std::string::npos || line[begin] == '@' || line.compare(begin, 2, "//") == 0) {
+      continue;
+    }
+    return line.compare(begin, 5, "func ") == 0;
+  }
+  return false;
+}
 
 } // namespace
 
 Server::Server(starbytes::lsp::ServerOptions &options) : in(options.in), out(options.os) {
   linguisticsProfilingEnabled = envTruthy(std::getenv("STARBYTES_LSP_PROFILE"));
+  auto workerCount = envUnsigned(std::getenv("STARBYTES_LSP_WORKERS"), AnalysisScheduler::defaultWorkerCount());
+  analysisDebounce = std::chrono::milliseconds(envUnsigned(std::getenv("STARBYTES_LSP_DIAGNOSTICS_DEBOUNCE_MS"), 150));
+  // didChange is debounced on the dispatch thread before a snapshot is built, so the pool runs jobs as soon as they arrive.
+  analysisScheduler = std::make_unique<AnalysisScheduler>(
+      workerCount,
+      std::chrono::milliseconds(0),
+      [this](const AnalysisSnapshot &snapshot, const AnalysisScheduler::IsStale &isStale, AnalysisResult &resultOut) {
+        return runDocumentAnalysis(snapshot, isStale, resultOut);
+      },
+      [this](const AnalysisResult &result) { publishAnalysisResult(result); });
 }
 
+Server::~Server() { analysisScheduler->stop(); }
+
 void Server::maybeLogLspProfileSample(const char *label, uint64_t elapsedNs, size_t itemCount) {
   if(!linguisticsProfilingEnabled || !label) {
     return;
@@ -1190,6 +1276,13 @@ void Server::maybeLogLspProfileSample(const char *label, uint64_t elapsedNs, siz
             << "\n";
 }
 
+void Server::recordLintRuleTimings(const std::vector<starbytes::linguistics::LintRuleTiming> &timings) {
+  for(const auto &timing : timings) {
+    lspProfileLintRuleNs[timing.id] += timing.elapsedNs;
+    maybeLogLspProfileSample(("lint.rule." + timing.id).c_str(), timing.elapsedNs, timing.findingCount);
+  }
+}
+
 void Server::maybeLogLspProfileSummary() {
   if(!linguisticsProfilingEnabled) {
     return;
@@ -1216,6 +1309,8 @@ void Server::maybeLogLspProfileSummary() {
       (cachedSafeActions + cachedAllActions) * sizeof(starbytes::linguistics::CodeAction);
 
   std::cerr << "[starbytes-lsp-profile] summary"
+            << " parse_ns=" << lspProfileParseNs
+            << " parses=" << lspProfileParseCount
             << " lint_ns=" << lspProfileLintNs
             << " suggest_ns=" << lspProfileSuggestionNs
             << " actions_ns=" << lspProfileActionNs
@@ -1228,8 +1323,11 @@ void Server::maybeLogLspProfileSummary() {
             << " cached_safe_actions=" << cachedSafeActions
             << " cached_all_actions=" << cachedAllActions
             << " cached_formatted_docs=" << cachedFormattedDocs
-            << " cache_estimated_bytes=" << estimatedCacheBytes
-            << "\n";
+            << " cache_estimated_bytes=" << estimatedCacheBytes;
+  for(const auto &entry : lspProfileLintRuleNs) {
+    std::cerr << " lint_rule." << entry.first << "_ns=" << entry.second;
+  }
+  std::cerr << "\n";
 }
 
 std::string Server::trim(const std::string &inValue) {
@@ -1254,12 +1352,8 @@ bool Server::isIdentifierStart(char c) {
 }
 
 uint64_t Server::hashText(const std::string &text) {
-  uint64_t hash = 1469598103934665603ULL;
-  for (unsigned char c : text) {
-    hash ^= static_cast<uint64_t>(c);
-    hash *= 1099511628211ULL;
-  }
-  return hash;
+  // Must agree with the incremental hash that open documents maintain.
+  return TextDocument::hashOf(text);
 }
 
 bool Server::parseUriToPath(const std::string &uri, std::string &pathOut) {
@@ -1455,7 +1549,7 @@ void Server::appendOccurrences(const std::string &text,
   }
 }
 
-bool Server::readMessage(std::string &body) {
+bool Server::readMessage(std::vector<char> &body) {
   std::string headerLine;
   size_t contentLength = 0;
   bool sawHeader = false;
@@ -1492,55 +1586,61 @@ bool Server::readMessage(std::string &body) {
     return true;
   }
 
-  body.resize(contentLength);
+  // One spare byte for the terminator that in-situ parsing needs.
+  body.resize(contentLength + 1);
   in.read(body.data(), static_cast<std::streamsize>(contentLength));
+  body[contentLength] = '\0';
   return static_cast<size_t>(in.gcount()) == contentLength;
 }
 
-void Server::writeMessage(rapidjson::Document &doc) {
-  rapidjson::StringBuffer buffer;
-  rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
-  doc.Accept(writer);
-  out << "Content-Length: " << buffer.GetSize() << "\r\n\r\n" << buffer.GetString() << std::flush;
+void Server::writeMessage(const std::function<void(JsonWriter &)> &writeBody) {
+  std::lock_guard<std::mutex> lock(outputMutex);
+  outputBuffer.Clear();
+  JsonWriter writer(outputBuffer);
+  writer.StartObject();
+  writer.Key("jsonrpc");
+  writer.String("2.0");
+  writeBody(writer);
+  writer.EndObject();
+  out << "Content-Length: " << outputBuffer.GetSize() << "\r\n\r\n";
+  out.write(outputBuffer.GetString(), static_cast<std::streamsize>(outputBuffer.GetSize()));
+  out << std::flush;
 }
 
 void Server::writeResult(const rapidjson::Value &id, rapidjson::Value &result) {
-  rapidjson::Document response(rapidjson::kObjectType);
-  auto &alloc = response.GetAllocator();
-  response.AddMember("jsonrpc", rapidjson::Value("2.0", alloc), alloc);
-  rapidjson::Value idCopy;
-  idCopy.CopyFrom(id, alloc);
-  response.AddMember("id", idCopy, alloc);
-  rapidjson::Value resultCopy;
-  resultCopy.CopyFrom(result, alloc);
-  response.AddMember("result", resultCopy, alloc);
-  writeMessage(response);
+  writeStreamedResult(id, [&](JsonWriter &writer) { result.Accept(writer); });
 }
 
-void Server::writeError(const rapidjson::Value &id, int code, const char *message) {
-  rapidjson::Document response(rapidjson::kObjectType);
-  auto &alloc = response.GetAllocator();
-  response.AddMember("jsonrpc", rapidjson::Value("2.0", alloc), alloc);
-  rapidjson::Value idCopy;
-  idCopy.CopyFrom(id, alloc);
-  response.AddMember("id", idCopy, alloc);
+void Server::writeStreamedResult(const rapidjson::Value &id, const std::function<void(JsonWriter &)> &writeResultBody) {
+  writeMessage([&](JsonWriter &writer) {
+    writer.Key("id");
+    id.Accept(writer);
+    writer.Key("result");
+    writeResultBody(writer);
+  });
+}
 
-  rapidjson::Value errorObj(rapidjson::kObjectType);
-  errorObj.AddMember("code", code, alloc);
-  errorObj.AddMember("message", rapidjson::Value(message, alloc), alloc);
-  response.AddMember("error", errorObj, alloc);
-  writeMessage(response);
+void Server::writeError(const rapidjson::Value &id, int code, const char *message) {
+  writeMessage([&](JsonWriter &writer) {
+    writer.Key("id");
+    id.Accept(writer);
+    writer.Key("error");
+    writer.StartObject();
+    writer.Key("code");
+    writer.Int(code);
+    writer.Key("message");
+    writer.String(message);
+    writer.EndObject();
+  });
 }
 
 void Server::writeNotification(const char *method, rapidjson::Value &params) {
-  rapidjson::Document payload(rapidjson::kObjectType);
-  auto &alloc = payload.GetAllocator();
-  payload.AddMember("jsonrpc", rapidjson::Value("2.0", alloc), alloc);
-  payload.AddMember("method", rapidjson::Value(method, alloc), alloc);
-  rapidjson::Value paramsCopy;
-  paramsCopy.CopyFrom(params, alloc);
-  payload.AddMember("params", paramsCopy, alloc);
-  writeMessage(payload);
+  writeMessage([&](JsonWriter &writer) {
+    writer.Key("method");
+    writer.String(method);
+    writer.Key("params");
+    params.Accept(writer);
+  });
 }
 
 void Server::loadWorkspaceDocuments() {
@@ -1593,22 +1693,22 @@ void Server::loadWorkspaceDocuments() {
         continue;
       }
 
-      auto text = buffer.str();
       DocumentState state;
-      state.text = text;
+      state.content.assign(buffer.str());
       state.version = 0;
       state.isOpen = false;
-      state.textHash = hashText(text);
+      state.textHash = state.content.hash();
       documents[uri] = std::move(state);
     }
   }
+  workspaceIndexSeeded = false;
 }
 
 bool Server::getBuiltinsDocument(std::string &uriOut, std::string &textOut) {
   for (const auto &doc : documents) {
     if (isBuiltinsInterfaceUri(doc.first)) {
       uriOut = doc.first;
-      textOut = doc.second.text;
+      textOut = doc.second.text();
       return !textOut.empty();
     }
   }
@@ -1658,7 +1758,7 @@ bool Server::getBuiltinsDocument(std::string &uriOut, std::string &textOut) {
 bool Server::getDocumentTextByUri(const std::string &uri, std::string &textOut) {
   auto it = documents.find(uri);
   if (it != documents.end()) {
-    textOut = it->second.text;
+    textOut = it->second.text();
     return true;
   }
 
@@ -1676,11 +1776,12 @@ bool Server::getDocumentTextByUri(const std::string &uri, std::string &textOut)
   buffer << file.rdbuf();
   textOut = buffer.str();
   DocumentState state;
-  state.text = textOut;
+  state.content.assign(textOut);
   state.version = 0;
   state.isOpen = false;
-  state.textHash = hashText(textOut);
+  state.textHash = state.content.hash();
   documents[uri] = std::move(state);
+  workspaceIndexDirtyUris.insert(uri);
   return true;
 }
 
@@ -1693,6 +1794,8 @@ void Server::configureSymbolCache() {
     }
   }
   symbolCache.setCachePath(cacheRoot / ".cache" / "lsp_symbols_cache.v1");
+  symbolSnapshotDir = cacheRoot / ".cache" / "lsp_symbol_snapshots.v1";
+  workspaceIndex.setIndexPath(cacheRoot / ".cache" / "lsp_workspace_index.v1");
 }
 
 void Server::refreshAnalysisState(DocumentState &state) {
@@ -1716,7 +1819,7 @@ std::shared_ptr<SemanticResolvedDocument> Server::buildSemanticResolvedDocumentF
     return nullptr;
   }
 
-  auto imports = extractImportsForHover(state.text);
+  auto imports = extractImportsForHover(state.text());
   std::unordered_map<std::string, std::shared_ptr<Semantics::SymbolTable>> depTables;
   for (const auto &importName : imports) {
     std::string depUri;
@@ -1728,9 +1831,8 @@ std::shared_ptr<SemanticResolvedDocument> Server::buildSemanticResolvedDocumentF
     if (depIt == documents.end()) {
       continue;
     }
-    auto depDocument = buildSemanticResolvedDocumentForUri(depUri, depIt->second, activeUris);
-    if (depDocument && depDocument->mainTable) {
-      depTables[importName] = depDocument->mainTable;
+    if (auto depTable = dependencySymbolTableForUri(depUri, depIt->second, activeUris)) {
+      depTables[importName] = std::move(depTable);
     }
   }
 
@@ -1742,7 +1844,7 @@ std::shared_ptr<SemanticResolvedDocument> Server::buildSemanticResolvedDocumentF
   Parser parser(consumer, std::move(diagnostics));
   auto parseContext = ModuleParseContext::Create(uri);
   appendImportedSymbolTablesForHover(parseContext.sTableContext, imports, depTables);
-  std::istringstream in(state.text);
+  std::istringstream in(state.text());
   parser.parseFromStream(in, parseContext);
   parser.finish();
 
@@ -1760,6 +1862,104 @@ std::shared_ptr<SemanticResolvedDocument> Server::buildSemanticResolvedDocumentF
   return resolvedDocument;
 }
 
+uint64_t Server::importClosureHash(const std::string &uri, const std::string &text) {
+  std::string key;
+  std::unordered_set<std::string> visited{uri};
+  std::vector<std::pair<std::string, std::string>> pending{{uri, text}};
+  while (!pending.empty()) {
+    auto module = std::move(pending.back());
+    pending.pop_back();
+    for (const auto &importName : extractImportsForHover(module.second)) {
+      key += importName;
+      key.push_back('\n');
+      std::string depUri;
+      std::string depText;
+      if (findModuleDocumentByName(importName, module.first, depUri, depText)) {
+        key += depUri;
+        key.push_back('\n');
+        key += std::to_string(hashText(depText));
+        if (visited.insert(depUri).second) {
+          pending.emplace_back(std::move(depUri), std::move(depText));
+        }
+      }
+      key.push_back('\n');
+    }
+  }
+  return hashText(key);
+}
+
+std::shared_ptr<Semantics::SymbolTable> Server::dependencySymbolTableForUri(const std::string &uri,
+                                                                            DocumentState &state,
+                                                                            std::unordered_set<std::string> &activeUris) {
+  refreshAnalysisState(state);
+  // Closed interface files (stdlib, third-party modules) are imported far more often than they change,
+  // so only their symbol table is kept, as a snapshot keyed by their content and that of every module
+  // they import.
+  std::string path;
+  bool snapshotEligible = !state.isOpen && !symbolSnapshotDir.empty() && parseUriToPath(uri, path) &&
+                          std::filesystem::path(path).extension() == ".starbint";
+  if (!snapshotEligible) {
+    if (!state.analysis.semanticResolvedReady) {
+      buildSemanticResolvedDocumentForUri(uri, state, activeUris);
+    }
+    auto &document = state.analysis.semanticResolvedDocument;
+    return document ? document->mainTable : nullptr;
+  }
+  auto importHash = importClosureHash(uri, state.text());
+  if (state.analysis.symbolSnapshot && state.analysis.symbolSnapshotImportHash == importHash) {
+    return state.analysis.symbolSnapshot;
+  }
+  // An import changed since this table was resolved.
+  state.analysis.symbolSnapshot = nullptr;
+  state.analysis.semanticResolvedReady = false;
+  state.analysis.semanticResolvedDocument = nullptr;
+
+  std::ostringstream prefix;
+  prefix << std::hex << hashText(uri) << "-";
+  std::ostringstream name;
+  name << prefix.str() << std::hex << state.textHash << "-" << importHash << ".starbsymtb";
+  auto snapshotPath = symbolSnapshotDir / name.str();
+  if (auto table = Semantics::SymbolTable::importPublicFile(snapshotPath)) {
+    state.analysis.symbolSnapshot = table;
+    state.analysis.symbolSnapshotImportHash = importHash;
+    return table;
+  }
+
+  auto document = buildSemanticResolvedDocumentForUri(uri, state, activeUris);
+  if (!document || !document->mainTable) {
+    return nullptr;
+  }
+  state.analysis.symbolSnapshot = document->mainTable;
+  state.analysis.symbolSnapshotImportHash = importHash;
+  std::error_code ec;
+  std::filesystem::create_directories(symbolSnapshotDir, ec);
+  auto tempPath = snapshotPath;
+  tempPath += ".tmp";
+  {
+    std::ofstream out(tempPath, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (out.is_open()) {
+      document->mainTable->serializePublic(out);
+    }
+  }
+  std::filesystem::rename(tempPath, snapshotPath, ec);
+  if (ec) {
+    std::filesystem::remove(tempPath, ec);
+    return document->mainTable;
+  }
+  // Only the newest snapshot of a file is ever read again.
+  std::vector<std::filesystem::path> superseded;
+  for (std::filesystem::directory_iterator it(symbolSnapshotDir, ec), end; !ec && it != end; it.increment(ec)) {
+    auto entryName = it->path().filename().string();
+    if (entryName != name.str() && entryName.compare(0, prefix.str().size(), prefix.str()) == 0) {
+      superseded.push_back(it->path());
+    }
+  }
+  for (const auto &stale : superseded) {
+    std::filesystem::remove(stale, ec);
+  }
+  return document->mainTable;
+}
+
 const SemanticResolvedDocument *Server::getSemanticResolvedDocumentForUri(const std::string &uri, DocumentState &state) {
   refreshAnalysisState(state);
   if (!state.analysis.semanticResolvedReady) {
@@ -1779,14 +1979,11 @@ const std::vector<CompilerDiagnosticEntry> &Server::getCompilerDiagnosticsForDoc
   return state.analysis.diagnostics;
 }
 
-std::vector<CompilerDiagnosticEntry> Server::buildCompilerDiagnosticsFromSemanticContext(const std::string &uri,
-                                                                                         DocumentState &state) {
-  std::vector<CompilerDiagnosticEntry> diagnosticsOut;
-  auto imports = extractImportsForHover(state.text);
+std::unordered_map<std::string, std::shared_ptr<Semantics::SymbolTable>> Server::dependencyTablesForImports(
+    const std::string &uri,
+    const std::vector<std::string> &imports,
+    std::unordered_set<std::string> &activeUris) {
   std::unordered_map<std::string, std::shared_ptr<Semantics::SymbolTable>> depTables;
-  std::unordered_set<std::string> activeUris;
-  activeUris.insert(uri);
-
   for (const auto &importName : imports) {
     std::string depUri;
     std::string depText;
@@ -1797,75 +1994,72 @@ std::vector<CompilerDiagnosticEntry> Server::buildCompilerDiagnosticsFromSemanti
     if (depIt == documents.end()) {
       continue;
     }
-    auto depDocument = buildSemanticResolvedDocumentForUri(depUri, depIt->second, activeUris);
-    if (depDocument && depDocument->mainTable) {
-      depTables[importName] = depDocument->mainTable;
+    if (auto depTable = dependencySymbolTableForUri(depUri, depIt->second, activeUris)) {
+      depTables[importName] = std::move(depTable);
     }
   }
+  return depTables;
+}
 
-  std::ostringstream sink;
-  auto diagnostics = DiagnosticHandler::createDefault(sink);
-  diagnostics->setOutputMode(DiagnosticHandler::OutputMode::Lsp);
-  diagnostics->setDefaultSourceName(uri);
-  auto *handler = diagnostics.get();
-
-  SemanticNoopConsumer consumer;
-  Parser parser(consumer, std::move(diagnostics));
-  auto parseContext = ModuleParseContext::Create(uri);
-  parseContext.name = uri;
-  appendImportedSymbolTablesForHover(parseContext.sTableContext, imports, depTables);
-  std::istringstream in(state.text);
-  parser.parseFromStream(in, parseContext);
-
-  if (!handler) {
-    return diagnosticsOut;
-  }
+std::vector<CompilerDiagnosticEntry> Server::buildCompilerDiagnosticsFromSemanticContext(const std::string &uri,
+                                                                                         DocumentState &state) {
+  auto imports = extractImportsForHover(state.text());
+  std::unordered_set<std::string> activeUris;
+  activeUris.insert(uri);
+  auto depTables = dependencyTablesForImports(uri, imports, activeUris);
+  return incrementalDiagnostics.analyze(uri, state.text(), imports, depTables);
+}
 
-  auto buffered = handler->collectLspRecords();
-  diagnosticsOut.reserve(buffered.size());
-  for (const auto &diag : buffered) {
-    CompilerDiagnosticEntry mapped;
-    if (diag.location.has_value()) {
-      mapped.region = *diag.location;
+uint64_t Server::semanticTokenContextHash(const std::string &uri, const std::vector<std::string> &imports) {
+  std::string key;
+  for (const auto &importName : imports) {
+    key += importName;
+    key.push_back('\n');
+    std::string moduleUri;
+    std::string moduleText;
+    if (findModuleDocumentByName(importName, uri, moduleUri, moduleText)) {
+      key += std::to_string(hashText(moduleText));
     }
-    mapped.severity = diag.isError() ? 1 : 2;
-    mapped.message = diag.message;
-    mapped.id = diag.id;
-    mapped.code = diag.code;
-    mapped.phase = diagnosticPhaseToStringLocal(diag.phase);
-    mapped.source = "starbytes-compiler";
-    mapped.producerSource = diag.sourceName;
-    mapped.relatedSpans = diag.relatedSpans;
-    mapped.notes = diag.notes;
-    mapped.fixits = diag.fixits;
-    diagnosticsOut.push_back(std::move(mapped));
+    key.push_back('\n');
   }
-  handler->clear();
-  return diagnosticsOut;
+  if (getBuiltinsApiIndex()) {
+    key += builtinsIndexCache.uri;
+    key += std::to_string(builtinsIndexCache.textHash);
+  }
+  return hashText(key);
 }
 
-std::vector<SemanticTokenEntry> Server::buildSemanticTokensFromSemanticCache(const std::string &uri, DocumentState &state) {
-  const auto *parsedDocument = getSemanticResolvedDocumentForUri(uri, state);
-  if (!parsedDocument || !parsedDocument->mainTable) {
-    return collectSemanticTokenEntries(state.text, 0, 0, false);
-  }
+void Server::classifySemanticTokenSegment(const std::string &uri,
+                                          DocumentState &state,
+                                          const SemanticResolvedDocument &parsedDocument,
+                                          const BuiltinApiIndex &builtinsIndex,
+                                          const TopLevelSegment &segment,
+                                          SemanticTokenSegment &segmentOut) {
+  const auto &text = state.text();
+  segmentOut.text = text.substr(segment.offset, segment.length);
+  segmentOut.line = segment.line;
+  segmentOut.infersReceiver = false;
+  segmentOut.tokens.clear();
 
-  BuiltinApiIndex builtinsIndex;
-  if (const auto *cachedBuiltins = getBuiltinsApiIndex()) {
-    builtinsIndex = *cachedBuiltins;
+  std::vector<size_t> lineStarts{segment.offset};
+  for (size_t i = 0; i < segmentOut.text.size(); ++i) {
+    if (segmentOut.text[i] == '\n') {
+      lineStarts.push_back(segment.offset + i + 1);
+    }
   }
 
   std::ostringstream sink;
   auto diagnostics = DiagnosticHandler::createDefault(sink);
   Syntax::Lexer lexer(*diagnostics);
   std::vector<Syntax::Tok> tokenStream;
-  std::istringstream input(state.text);
+  std::istringstream input(segmentOut.text);
   lexer.tokenizeFromIStream(input, tokenStream);
 
-  std::vector<SemanticTokenEntry> tokens;
+  auto &tokens = segmentOut.tokens;
   tokens.reserve(tokenStream.size());
   for (const auto &token : tokenStream) {
-    unsigned line = token.srcPos.line > 0 ? token.srcPos.line - 1 : 0;
+    unsigned relativeLine = token.srcPos.line > 0 ? token.srcPos.line - 1 : 0;
+    unsigned line = segment.line + relativeLine;
     unsigned start = token.srcPos.startCol;
     unsigned length = token.srcPos.endCol > token.srcPos.startCol ? token.srcPos.endCol - token.srcPos.startCol
                                                                   : static_cast<unsigned>(token.content.size());
@@ -1874,7 +2068,7 @@ std::vector<SemanticTokenEntry> Server::buildSemanticTokensFromSemanticCache(con
     }
 
     if (token.type == Syntax::Tok::Keyword || token.type == Syntax::Tok::BooleanLiteral) {
-      tokens.push_back({line, start, length, TOKEN_TYPE_KEYWORD});
+      tokens.push_back({relativeLine, start, length, TOKEN_TYPE_KEYWORD});
       continue;
     }
 
@@ -1884,18 +2078,18 @@ std::vector<SemanticTokenEntry> Server::buildSemanticTokensFromSemanticCache(con
 
     unsigned semanticType = TOKEN_TYPE_VARIABLE;
     bool resolved = false;
-    auto tokenOffset = offsetFromPosition(state.text, line, start);
+    auto tokenOffset = relativeLine < lineStarts.size() ? lineStarts[relativeLine] + start : text.size();
 
-    if (std::find(parsedDocument->imports.begin(), parsedDocument->imports.end(), token.content) != parsedDocument->imports.end()) {
+    if (std::find(parsedDocument.imports.begin(), parsedDocument.imports.end(), token.content) != parsedDocument.imports.end()) {
       semanticType = TOKEN_TYPE_NAMESPACE;
       resolved = true;
     }
 
     if (!resolved) {
       std::string memberReceiver;
-      if (extractReceiverBeforeOffset(state.text, tokenOffset, memberReceiver) &&
-          std::find(parsedDocument->imports.begin(), parsedDocument->imports.end(), memberReceiver) !=
-              parsedDocument->imports.end()) {
+      if (extractReceiverBeforeOffset(text, tokenOffset, memberReceiver) &&
+          std::find(parsedDocument.imports.begin(), parsedDocument.imports.end(), memberReceiver) !=
+              parsedDocument.imports.end()) {
         std::string moduleUri;
         std::string moduleText;
         if (findModuleDocumentByName(memberReceiver, uri, moduleUri, moduleText)) {
@@ -1919,15 +2113,16 @@ std::vector<SemanticTokenEntry> Server::buildSemanticTokensFromSemanticCache(con
       if (length > 1) {
         lookupCharacter += 1;
       }
-      if (resolveHoverSymbol(uri, state.text, line, lookupCharacter, token.content, tokenOffset, resolvedUri, resolvedSymbol)) {
+      if (resolveHoverSymbol(uri, text, line, lookupCharacter, token.content, tokenOffset, resolvedUri, resolvedSymbol)) {
         semanticType = semanticTokenTypeFromSymbolKindForLsp(resolvedSymbol.kind);
         resolved = true;
       }
     }
 
     std::string memberReceiver;
-    if (!resolved && extractReceiverBeforeOffset(state.text, tokenOffset, memberReceiver) && !builtinsIndex.membersByType.empty()) {
-      auto inferredType = inferBuiltinTypeForReceiver(state.text, memberReceiver, line, builtinsIndex);
+    if (!resolved && extractReceiverBeforeOffset(text, tokenOffset, memberReceiver) && !builtinsIndex.membersByType.empty()) {
+      segmentOut.infersReceiver = true;
+      auto inferredType = inferBuiltinTypeForReceiver(text, memberReceiver, line, builtinsIndex);
       if (inferredType.has_value()) {
         auto typeMembers = builtinsIndex.membersByType.find(*inferredType);
         if (typeMembers != builtinsIndex.membersByType.end()) {
@@ -1947,21 +2142,75 @@ std::vector<SemanticTokenEntry> Server::buildSemanticTokensFromSemanticCache(con
       }
     }
 
-    tokens.push_back({line, start, length, semanticType});
+    tokens.push_back({relativeLine, start, length, semanticType});
   }
 
-  std::sort(tokens.begin(), tokens.end(), [](const SemanticTokenEntry &lhs, const SemanticTokenEntry &rhs) {
-    if (lhs.line != rhs.line) {
-      return lhs.line < rhs.line;
+  std::sort(tokens.begin(), tokens.end(), semanticTokenLess);
+}
+
+std::vector<SemanticTokenEntry> Server::buildSemanticTokensFromSemanticCache(const std::string &uri, DocumentState &state) {
+  auto &cache = state.semanticSegments;
+  const auto *parsedDocument = getSemanticResolvedDocumentForUri(uri, state);
+  if (!parsedDocument || !parsedDocument->mainTable) {
+    cache = {};
+    return collectSemanticTokenEntries(state.text(), 0, 0, false);
+  }
+
+  BuiltinApiIndex builtinsIndex;
+  if (const auto *cachedBuiltins = getBuiltinsApiIndex()) {
+    builtinsIndex = *cachedBuiltins;
+  }
+
+  const auto &text = state.text();
+  auto segments = splitTopLevelSegments(text);
+  auto contextHash = semanticTokenContextHash(uri, parsedDocument->imports);
+
+  // Segments outside the changed run keep their tokens when every changed segment is a function whose
+  // signature is intact, so the edit cannot change how names in other declarations resolve.
+  auto &previous = cache.segments;
+  size_t prefix = 0;
+  size_t suffix = 0;
+  bool reuse = cache.valid && cache.contextHash == contextHash && previous.size() == segments.size();
+  if (reuse) {
+    auto sameText = [&](size_t index) {
+      return text.compare(segments[index].offset, segments[index].length, previous[index].text) == 0;
+    };
+    while (prefix < segments.size() && sameText(prefix)) {
+      ++prefix;
     }
-    if (lhs.start != rhs.start) {
-      return lhs.start < rhs.start;
+    while (suffix < segments.size() - prefix && sameText(segments.size() - 1 - suffix)) {
+      ++suffix;
     }
-    if (lhs.length != rhs.length) {
-      return lhs.length < rhs.length;
+    for (size_t i = prefix; reuse && i < segments.size() - suffix; ++i) {
+      const auto &segment = segments[i];
+      const auto &old = previous[i];
+      reuse = segmentHeaderDeclaresFunction(text, segment) && old.text.size() >= segment.bodyOffset &&
+              text.compare(segment.offset, segment.bodyOffset, old.text, 0, segment.bodyOffset) == 0;
     }
-    return lhs.type < rhs.type;
-  });
+  }
+
+  std::vector<SemanticTokenSegment> next(segments.size());
+  for (size_t i = 0; i < segments.size(); ++i) {
+    bool unchanged = i < prefix || i >= segments.size() - suffix;
+    // Receiver types are inferred from the latest textual declaration above the token, which may be in the edited run.
+    if (reuse && unchanged && !(i >= prefix && previous[i].infersReceiver)) {
+      next[i] = std::move(previous[i]);
+      next[i].line = segments[i].line;
+      continue;
+    }
+    classifySemanticTokenSegment(uri, state, *parsedDocument, builtinsIndex, segments[i], next[i]);
+  }
+  cache.valid = true;
+  cache.contextHash = contextHash;
+  cache.segments = std::move(next);
+
+  std::vector<SemanticTokenEntry> tokens;
+  for (const auto &segment : cache.segments) {
+    for (auto token : segment.tokens) {
+      token.line += segment.line;
+      tokens.push_back(token);
+    }
+  }
   return tokens;
 }
 
@@ -1975,14 +2224,33 @@ const std::vector<SemanticTokenEntry> &Server::getSemanticTokensForDocument(cons
   return state.analysis.semanticTokens;
 }
 
+const starbytes::linguistics::LinguisticsArtifact &Server::getLinguisticsArtifactForDocument(const std::string &uri,
+                                                                                            DocumentState &state) {
+  refreshAnalysisState(state);
+  if (!state.analysis.linguisticsArtifact) {
+    auto start = std::chrono::steady_clock::now();
+    starbytes::linguistics::LinguisticsSession session(uri, state.text());
+    state.analysis.linguisticsArtifact = starbytes::linguistics::buildLinguisticsArtifact(session);
+    auto elapsed = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+    lspProfileParseNs += elapsed;
+    ++lspProfileParseCount;
+    maybeLogLspProfileSample("parse", elapsed, state.analysis.linguisticsArtifact->compiler.statements.size());
+  }
+  return *state.analysis.linguisticsArtifact;
+}
+
 const std::vector<starbytes::linguistics::LintFinding> &Server::getLintFindingsForDocument(const std::string &uri,
                                                                                             DocumentState &state) {
   refreshAnalysisState(state);
   if (!state.analysis.lintReady) {
+    const auto &artifact = getLinguisticsArtifactForDocument(uri, state);
     auto start = std::chrono::steady_clock::now();
-    starbytes::linguistics::LinguisticsSession session(uri, state.text);
-    auto lintResult = lintEngine.run(session, linguisticsConfig);
+    starbytes::linguistics::LintRequest lintRequest;
+    lintRequest.profileRules = linguisticsProfilingEnabled;
+    auto lintResult = lintEngine.run(artifact.view(), linguisticsConfig, lintRequest);
     state.analysis.lintFindings = std::move(lintResult.findings);
+    recordLintRuleTimings(lintResult.ruleTimings);
     state.analysis.lintReady = true;
     auto elapsed = static_cast<uint64_t>(
         std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
@@ -1996,11 +2264,11 @@ const std::vector<starbytes::linguistics::Suggestion> &Server::getSuggestionsFor
                                                                                           DocumentState &state) {
   refreshAnalysisState(state);
   if (!state.analysis.suggestionsReady) {
+    const auto &artifact = getLinguisticsArtifactForDocument(uri, state);
     auto start = std::chrono::steady_clock::now();
-    starbytes::linguistics::LinguisticsSession session(uri, state.text);
     starbytes::linguistics::SuggestionRequest request;
     request.includeLowConfidence = false;
-    auto suggestionResult = suggestionEngine.run(session, linguisticsConfig, request);
+    auto suggestionResult = suggestionEngine.run(artifact.view(), linguisticsConfig, request);
     state.analysis.suggestions = std::move(suggestionResult.suggestions);
     state.analysis.suggestionsReady = true;
     auto elapsed = static_cast<uint64_t>(
@@ -2043,10 +2311,10 @@ bool Server::getFormattedTextForDocument(const std::string &uri, DocumentState &
   refreshAnalysisState(state);
 
   if(!state.analysis.formatReady) {
+    const auto &artifact = getLinguisticsArtifactForDocument(uri, state);
     auto start = std::chrono::steady_clock::now();
-    starbytes::linguistics::LinguisticsSession session(uri, state.text);
     starbytes::linguistics::FormatRequest request;
-    auto formatResult = formatterEngine.format(session, linguisticsConfig, request);
+    auto formatResult = formatterEngine.format(artifact, linguisticsConfig, request);
     state.analysis.formatOk = formatResult.ok;
     state.analysis.formattedText = std::move(formatResult.formattedText);
     state.analysis.formatReady = true;
@@ -2100,6 +2368,35 @@ std::vector<SymbolEntry> Server::collectSymbolsForUri(const std::string &uri, co
 
 void Server::invalidateSymbolCacheForUri(const std::string &uri) {
   symbolCache.invalidate(uri);
+  workspaceIndexDirtyUris.insert(uri);
+}
+
+void Server::refreshWorkspaceIndex() {
+  if (!workspaceIndexSeeded) {
+    for (const auto &indexedUri : workspaceIndex.uris()) {
+      if (documents.find(indexedUri) == documents.end()) {
+        workspaceIndex.remove(indexedUri);
+      }
+    }
+    for (const auto &doc : documents) {
+      workspaceIndexDirtyUris.insert(doc.first);
+    }
+    workspaceIndexSeeded = true;
+  }
+
+  for (const auto &dirtyUri : workspaceIndexDirtyUris) {
+    auto it = documents.find(dirtyUri);
+    if (it == documents.end()) {
+      workspaceIndex.remove(dirtyUri);
+      continue;
+    }
+    const auto &state = it->second;
+    if (workspaceIndex.isCurrent(dirtyUri, state.textHash) || workspaceIndex.adoptPersisted(dirtyUri, state.textHash)) {
+      continue;
+    }
+    workspaceIndex.update(dirtyUri, state.textHash, state.text(), collectSymbolsForUri(dirtyUri, state.text()));
+  }
+  workspaceIndexDirtyUris.clear();
 }
 
 bool Server::findModuleDocumentByName(const std::string &moduleName,
@@ -2140,7 +2437,7 @@ bool Server::findModuleDocumentByName(const std::string &moduleName,
 
   int bestScore = 0;
   for (const auto &doc : documents) {
-    considerDocument(doc.first, doc.second.text, bestScore);
+    considerDocument(doc.first, doc.second.text(), bestScore);
   }
   if (bestScore >= 6) {
     return true;
@@ -3527,7 +3824,7 @@ bool Server::resolveSemanticTypeTarget(const std::string &anchorUri,
       if (doc.first == anchorUri) {
         continue;
       }
-      if (findTypeInDocument(doc.first, doc.second.text, symbolName, containerHint, false)) {
+      if (findTypeInDocument(doc.first, doc.second.text(), symbolName, containerHint, false)) {
         return true;
       }
     }
@@ -3561,7 +3858,7 @@ bool Server::resolveSemanticTypeTarget(const std::string &anchorUri,
       if (doc.first == anchorUri) {
         continue;
       }
-      if (findTypeInDocument(doc.first, doc.second.text, localName, immediateContainer, false)) {
+      if (findTypeInDocument(doc.first, doc.second.text(), localName, immediateContainer, false)) {
         return true;
       }
     }
@@ -3580,7 +3877,7 @@ bool Server::resolveSemanticTypeTarget(const std::string &anchorUri,
     if (doc.first == anchorUri) {
       continue;
     }
-    if (findTypeInDocument(doc.first, doc.second.text, normalizedTypeName, std::string(), true)) {
+    if (findTypeInDocument(doc.first, doc.second.text(), normalizedTypeName, std::string(), true)) {
       return true;
     }
   }
@@ -3668,15 +3965,19 @@ bool Server::symbolIsRenameOwned(const std::string &resolvedUri,
 
 void Server::setDocumentTextByUri(const std::string &uri, const std::string &text, int version, bool isOpen) {
   DocumentState state;
-  state.text = text;
+  state.content.assign(text);
   state.version = version;
   state.isOpen = isOpen;
-  state.textHash = hashText(text);
+  state.textHash = state.content.hash();
   documents[uri] = std::move(state);
-  semanticSnapshots.erase(uri);
+  documentTextChanged(uri);
+}
+
+void Server::documentTextChanged(const std::string &uri) {
   invalidateSymbolCacheForUri(uri);
   if (isBuiltinsInterfaceUri(uri) || (builtinsIndexCache.valid && builtinsIndexCache.uri == uri)) {
     builtinsIndexCache.valid = false;
+    workspaceIndex.invalidateResolutions();
   }
 }
 
@@ -3692,26 +3993,21 @@ void Server::removeOpenDocumentByUri(const std::string &uri) {
     if (file.is_open()) {
       std::ostringstream buffer;
       buffer << file.rdbuf();
-      it->second.text = buffer.str();
+      it->second.content.assign(buffer.str());
       it->second.version = 0;
       it->second.isOpen = false;
-      it->second.textHash = hashText(it->second.text);
+      it->second.textHash = it->second.content.hash();
       it->second.analysis = {};
+      it->second.semanticSegments = {};
       semanticSnapshots.erase(uri);
-      invalidateSymbolCacheForUri(uri);
-      if (isBuiltinsInterfaceUri(uri) || (builtinsIndexCache.valid && builtinsIndexCache.uri == uri)) {
-        builtinsIndexCache.valid = false;
-      }
+      documentTextChanged(uri);
       return;
     }
   }
 
   documents.erase(it);
   semanticSnapshots.erase(uri);
-  invalidateSymbolCacheForUri(uri);
-  if (isBuiltinsInterfaceUri(uri) || (builtinsIndexCache.valid && builtinsIndexCache.uri == uri)) {
-    builtinsIndexCache.valid = false;
-  }
+  documentTextChanged(uri);
 }
 
 void Server::appendLinguisticsDiagnosticsJson(const std::string &uri,
@@ -3738,7 +4034,8 @@ void Server::appendLinguisticsDiagnosticsJson(const std::string &uri,
   }
   else {
     starbytes::linguistics::LinguisticsSession session(uri, text);
-    auto lintResult = lintEngine.run(session, linguisticsConfig);
+    auto artifact = starbytes::linguistics::buildLinguisticsArtifact(session);
+    auto lintResult = lintEngine.run(artifact->view(), linguisticsConfig);
     for(const auto &finding : lintResult.findings) {
       rapidjson::Value diag(rapidjson::kObjectType);
       appendLintDiagnosticJson(diag, finding, uri, alloc);
@@ -3747,7 +4044,7 @@ void Server::appendLinguisticsDiagnosticsJson(const std::string &uri,
 
     starbytes::linguistics::SuggestionRequest suggestionRequest;
     suggestionRequest.includeLowConfidence = false;
-    auto suggestionResult = suggestionEngine.run(session, linguisticsConfig, suggestionRequest);
+    auto suggestionResult = suggestionEngine.run(artifact->view(), linguisticsConfig, suggestionRequest);
     for(const auto &suggestion : suggestionResult.suggestions) {
       rapidjson::Value diag(rapidjson::kObjectType);
       appendSuggestionDiagnosticJson(diag, suggestion, alloc);
@@ -3761,50 +4058,168 @@ void Server::appendLinguisticsDiagnosticsJson(const std::string &uri,
   maybeLogLspProfileSample("diagnostics.append", elapsed, diagnostics.Size());
 }
 
-void Server::publishDiagnostics(const std::string &uri) {
+void Server::scheduleDocumentAnalysis(const std::string &uri) {
+  pendingAnalysisDeadlines.erase(uri);
+  auto docIt = documents.find(uri);
+  if (docIt == documents.end()) {
+    return;
+  }
+  auto &state = docIt->second;
+  AnalysisSnapshot snapshot;
+  snapshot.uri = uri;
+  snapshot.version = state.version;
+  snapshot.textHash = state.textHash;
+  snapshot.text = state.content.snapshot();
+  snapshot.imports = extractImportsForHover(*snapshot.text);
+  // Dependency tables are resolved here because they live in the shared document cache; workers only read them.
+  std::unordered_set<std::string> activeUris;
+  activeUris.insert(uri);
+  snapshot.dependencyTables = dependencyTablesForImports(uri, snapshot.imports, activeUris);
+  snapshot.config = linguisticsConfig;
+  analysisScheduler->schedule(std::move(snapshot), true);
+}
+
+void Server::schedulePendingAnalyses(bool force) {
+  auto now = std::chrono::steady_clock::now();
+  std::vector<std::string> due;
+  for (const auto &pending : pendingAnalysisDeadlines) {
+    if (force || pending.second <= now) {
+      due.push_back(pending.first);
+    }
+  }
+  for (const auto &uri : due) {
+    scheduleDocumentAnalysis(uri);
+  }
+}
+
+bool Server::runDocumentAnalysis(const AnalysisSnapshot &snapshot,
+                                 const AnalysisScheduler::IsStale &isStale,
+                                 AnalysisResult &resultOut) const {
+  resultOut.uri = snapshot.uri;
+  resultOut.version = snapshot.version;
+  resultOut.textHash = snapshot.textHash;
+
+  auto start = std::chrono::steady_clock::now();
+  resultOut.diagnostics =
+      incrementalDiagnostics.analyze(snapshot.uri, *snapshot.text, snapshot.imports, snapshot.dependencyTables);
+  auto compiled = std::chrono::steady_clock::now();
+  resultOut.compileNs =
+      static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(compiled - start).count());
+  if (isStale()) {
+    return false;
+  }
+
+  starbytes::linguistics::LinguisticsSession session(snapshot.uri, *snapshot.text);
+  resultOut.linguisticsArtifact = starbytes::linguistics::buildLinguisticsArtifact(session);
+  auto parsed = std::chrono::steady_clock::now();
+  resultOut.parseNs = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(parsed - compiled).count());
+  if (isStale()) {
+    return false;
+  }
+
+  starbytes::linguistics::LintRequest lintRequest;
+  lintRequest.profileRules = linguisticsProfilingEnabled;
+  auto lintResult = lintEngine.run(resultOut.linguisticsArtifact->view(), snapshot.config, lintRequest);
+  resultOut.lintFindings = std::move(lintResult.findings);
+  resultOut.lintRuleTimings = std::move(lintResult.ruleTimings);
+  auto linted = std::chrono::steady_clock::now();
+  resultOut.lintNs = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(linted - parsed).count());
+  if (isStale()) {
+    return false;
+  }
+
+  starbytes::linguistics::SuggestionRequest suggestionRequest;
+  suggestionRequest.includeLowConfidence = false;
+  auto suggestionResult =
+      suggestionEngine.run(resultOut.linguisticsArtifact->view(), snapshot.config, suggestionRequest);
+  resultOut.suggestions = std::move(suggestionResult.suggestions);
+  resultOut.suggestNs = static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - linted).count());
+  return !isStale();
+}
+
+void Server::publishAnalysisResult(const AnalysisResult &result) {
   rapidjson::Document paramsDoc(rapidjson::kObjectType);
   auto &alloc = paramsDoc.GetAllocator();
 
-  paramsDoc.AddMember("uri", rapidjson::Value(uri.c_str(), alloc), alloc);
+  paramsDoc.AddMember("uri", rapidjson::Value(result.uri.c_str(), alloc), alloc);
+  paramsDoc.AddMember("version", result.version, alloc);
   rapidjson::Value diagnostics(rapidjson::kArrayType);
-
-  std::string text;
-  if (getDocumentTextByUri(uri, text)) {
-    auto docIt = documents.find(uri);
-    if (docIt != documents.end()) {
-      const auto &compilerDiagnostics = getCompilerDiagnosticsForDocument(uri, docIt->second);
-      for (const auto &entry : compilerDiagnostics) {
-        rapidjson::Value diag(rapidjson::kObjectType);
-        appendCompilerDiagnosticJson(diag, entry, uri, alloc);
-        diagnostics.PushBack(diag, alloc);
-      }
-      appendLinguisticsDiagnosticsJson(uri, docIt->second.text, diagnostics, alloc);
-    }
-    else {
-      appendLinguisticsDiagnosticsJson(uri, text, diagnostics, alloc);
-    }
+  for (const auto &entry : result.diagnostics) {
+    rapidjson::Value diag(rapidjson::kObjectType);
+    appendCompilerDiagnosticJson(diag, entry, result.uri, alloc);
+    diagnostics.PushBack(diag, alloc);
+  }
+  for (const auto &finding : result.lintFindings) {
+    rapidjson::Value diag(rapidjson::kObjectType);
+    appendLintDiagnosticJson(diag, finding, result.uri, alloc);
+    diagnostics.PushBack(diag, alloc);
+  }
+  for (const auto &suggestion : result.suggestions) {
+    rapidjson::Value diag(rapidjson::kObjectType);
+    appendSuggestionDiagnosticJson(diag, suggestion, alloc);
+    diagnostics.PushBack(diag, alloc);
   }
 
   paramsDoc.AddMember("diagnostics", diagnostics, alloc);
   writeNotification("textDocument/publishDiagnostics", paramsDoc);
 }
 
-void Server::maybeApplyIncrementalChange(std::string &text, const rapidjson::Value &change) {
+void Server::installCompletedAnalysis() {
+  for (auto &result : analysisScheduler->takeCompleted()) {
+    lspProfileDiagnosticsNs += result.compileNs + result.parseNs + result.lintNs + result.suggestNs;
+    lspProfileParseNs += result.parseNs;
+    ++lspProfileParseCount;
+    lspProfileLintNs += result.lintNs;
+    lspProfileSuggestionNs += result.suggestNs;
+    maybeLogLspProfileSample("analysis.compile", result.compileNs, result.diagnostics.size());
+    maybeLogLspProfileSample("analysis.parse", result.parseNs, 1);
+    maybeLogLspProfileSample("analysis.lint", result.lintNs, result.lintFindings.size());
+    recordLintRuleTimings(result.lintRuleTimings);
+
+    auto docIt = documents.find(result.uri);
+    if (docIt == documents.end()) {
+      continue;
+    }
+    auto &state = docIt->second;
+    if (state.version != result.version || state.textHash != result.textHash) {
+      continue;
+    }
+    refreshAnalysisState(state);
+    if (!state.analysis.diagnosticsReady) {
+      state.analysis.diagnostics = std::move(result.diagnostics);
+      state.analysis.diagnosticsReady = true;
+    }
+    if (!state.analysis.lintReady) {
+      state.analysis.lintFindings = std::move(result.lintFindings);
+      state.analysis.lintReady = true;
+    }
+    if (!state.analysis.suggestionsReady) {
+      state.analysis.suggestions = std::move(result.suggestions);
+      state.analysis.suggestionsReady = true;
+    }
+    if (!state.analysis.linguisticsArtifact) {
+      state.analysis.linguisticsArtifact = std::move(result.linguisticsArtifact);
+    }
+  }
+}
+
+void Server::maybeApplyIncrementalChange(TextDocument &document, const rapidjson::Value &change) {
   if (!change.IsObject() || !change.HasMember("text") || !change["text"].IsString()) {
     return;
   }
 
-  auto replacementText = std::string(change["text"].GetString());
+  auto replacementText = std::string(change["text"].GetString(), change["text"].GetStringLength());
 
   if (!change.HasMember("range") || !change["range"].IsObject()) {
-    text = replacementText;
+    document.assign(std::move(replacementText));
     return;
   }
 
   auto &range = change["range"];
   if (!range.HasMember("start") || !range.HasMember("end") || !range["start"].IsObject() ||
       !range["end"].IsObject()) {
-    text = replacementText;
+    document.assign(std::move(replacementText));
     return;
   }
 
@@ -3813,18 +4228,13 @@ void Server::maybeApplyIncrementalChange(std::string &text, const rapidjson::Val
   if (!start.HasMember("line") || !start.HasMember("character") || !end.HasMember("line") ||
       !end.HasMember("character") || !start["line"].IsUint() || !start["character"].IsUint() ||
       !end["line"].IsUint() || !end["character"].IsUint()) {
-    text = replacementText;
+    document.assign(std::move(replacementText));
     return;
   }
 
-  size_t startOffset = offsetFromPosition(text, start["line"].GetUint(), start["character"].GetUint());
-  size_t endOffset = offsetFromPosition(text, end["line"].GetUint(), end["character"].GetUint());
-  if (startOffset > endOffset) {
-    std::swap(startOffset, endOffset);
-  }
-  startOffset = std::min(startOffset, text.size());
-  endOffset = std::min(endOffset, text.size());
-  text.replace(startOffset, endOffset - startOffset, replacementText);
+  size_t startOffset = document.offsetAt(start["line"].GetUint(), start["character"].GetUint());
+  size_t endOffset = document.offsetAt(end["line"].GetUint(), end["character"].GetUint());
+  document.replace(startOffset, endOffset, replacementText);
 }
 
 void Server::handleInitialize(rapidjson::Document &request) {
@@ -3953,8 +4363,12 @@ void Server::handleShutdown(rapidjson::Document &request) {
     return;
   }
   shutdownRequested = true;
+  schedulePendingAnalyses(true);
+  analysisScheduler->flush();
+  installCompletedAnalysis();
   maybeLogLspProfileSummary();
   symbolCache.save();
+  workspaceIndex.save();
   rapidjson::Document payloadDoc(rapidjson::kObjectType);
   rapidjson::Value result;
   result.SetNull();
@@ -3969,9 +4383,15 @@ void Server::handleCancelRequest(rapidjson::Document &request) {
   if (!params.HasMember("id")) {
     return;
   }
+  std::lock_guard<std::mutex> lock(canceledRequestMutex);
   canceledRequestIds.insert(idToKey(params["id"]));
 }
 
+bool Server::isRequestCancelled(const rapidjson::Value &id) {
+  std::lock_guard<std::mutex> lock(canceledRequestMutex);
+  return canceledRequestIds.find(idToKey(id)) != canceledRequestIds.end();
+}
+
 void Server::handleSetTrace(rapidjson::Document &request) {
   if (!request.HasMember("params") || !request["params"].IsObject()) {
     return;
@@ -4015,7 +4435,7 @@ void Server::handleDidOpen(rapidjson::Document &request) {
   }
   auto uri = std::string(textDoc["uri"].GetString());
   setDocumentTextByUri(uri, textDoc["text"].GetString(), version, true);
-  publishDiagnostics(uri);
+  scheduleDocumentAnalysis(uri);
 }
 
 void Server::handleDidChange(rapidjson::Document &request) {
@@ -4035,21 +4455,27 @@ void Server::handleDidChange(rapidjson::Document &request) {
   }
 
   auto uri = std::string(textDoc["uri"].GetString());
-  std::string text;
-  if (!getDocumentTextByUri(uri, text)) {
-    text.clear();
+  if (documents.find(uri) == documents.end()) {
+    std::string diskText;
+    getDocumentTextByUri(uri, diskText);
   }
 
+  // Edits go straight into the document's piece table; nothing here is proportional to the file size.
+  auto &state = documents[uri];
   for (auto &change : changes.GetArray()) {
-    maybeApplyIncrementalChange(text, change);
+    maybeApplyIncrementalChange(state.content, change);
   }
 
   int version = 0;
   if (textDoc.HasMember("version") && textDoc["version"].IsInt()) {
     version = textDoc["version"].GetInt();
   }
-  setDocumentTextByUri(uri, text, version, true);
-  publishDiagnostics(uri);
+  state.version = version;
+  state.isOpen = true;
+  state.textHash = state.content.hash();
+  state.analysis = {};
+  documentTextChanged(uri);
+  pendingAnalysisDeadlines[uri] = std::chrono::steady_clock::now() + analysisDebounce;
 }
 
 void Server::handleDidSave(rapidjson::Document &request) {
@@ -4068,7 +4494,7 @@ void Server::handleDidSave(rapidjson::Document &request) {
     int version = (it != documents.end()) ? it->second.version : 0;
     setDocumentTextByUri(uri, params["text"].GetString(), version, true);
   }
-  publishDiagnostics(uri);
+  scheduleDocumentAnalysis(uri);
 }
 
 void Server::handleDidClose(rapidjson::Document &request) {
@@ -4083,13 +4509,15 @@ void Server::handleDidClose(rapidjson::Document &request) {
 
   auto uri = std::string(params["textDocument"]["uri"].GetString());
   removeOpenDocumentByUri(uri);
+  pendingAnalysisDeadlines.erase(uri);
 
   rapidjson::Document paramsDoc(rapidjson::kObjectType);
   auto &alloc = paramsDoc.GetAllocator();
   paramsDoc.AddMember("uri", rapidjson::Value(uri.c_str(), alloc), alloc);
   rapidjson::Value diagnostics(rapidjson::kArrayType);
   paramsDoc.AddMember("diagnostics", diagnostics, alloc);
-  writeNotification("textDocument/publishDiagnostics", paramsDoc);
+  analysisScheduler->cancel(uri, [&] { writeNotification("textDocument/publishDiagnostics", paramsDoc); });
+  incrementalDiagnostics.forget(uri);
 }
 
 void Server::handleCompletion(rapidjson::Document &request) {
@@ -4425,7 +4853,7 @@ void Server::handleCompletion(rapidjson::Document &request) {
 
             if (!receiverContainer.empty()) {
               for (const auto &doc : documents) {
-                auto symbols = collectSymbolsForUri(doc.first, doc.second.text);
+                auto symbols = collectSymbolsForUri(doc.first, doc.second.text());
                 for (const auto &symbol : symbols) {
                   if (!symbol.isMember || symbol.containerName != receiverContainer) {
                     continue;
@@ -4687,7 +5115,7 @@ void Server::handleCompletion(rapidjson::Document &request) {
   }
 
   for (const auto &doc : documents) {
-    auto symbols = collectSymbolsForUri(doc.first, doc.second.text);
+    auto symbols = collectSymbolsForUri(doc.first, doc.second.text());
     for (const auto &symbol : symbols) {
       if (memberContext) {
         if (!symbol.isMember) {
@@ -4713,41 +5141,60 @@ void Server::handleCompletion(rapidjson::Document &request) {
     }
   }
 
-  rapidjson::Document payloadDoc(rapidjson::kObjectType);
-  auto &alloc = payloadDoc.GetAllocator();
-  rapidjson::Value items(rapidjson::kArrayType);
-  for (const auto &entry : entries) {
-    rapidjson::Value item(rapidjson::kObjectType);
-    item.AddMember("label", rapidjson::Value(entry.label.c_str(), alloc), alloc);
-    item.AddMember("kind", entry.kind, alloc);
-    item.AddMember("detail", rapidjson::Value(entry.detail.c_str(), alloc), alloc);
-    item.AddMember("insertText", rapidjson::Value(entry.label.c_str(), alloc), alloc);
-    if (entry.hasResolvedSymbol && entry.resolvedSymbol.isDeprecated) {
-      appendDeprecatedTagArray(item, LSP_COMPLETION_ITEM_TAG_DEPRECATED, alloc);
-    }
-    if (entry.hasResolvedSymbol) {
-      rapidjson::Value data(rapidjson::kObjectType);
-      data.AddMember("uri", rapidjson::Value(entry.resolvedUri.c_str(), alloc), alloc);
-      data.AddMember("symbolLine", entry.resolvedSymbol.line, alloc);
-      data.AddMember("symbolStart", entry.resolvedSymbol.start, alloc);
-      data.AddMember("symbolLength", entry.resolvedSymbol.length, alloc);
-      data.AddMember("symbolKind", entry.resolvedSymbol.kind, alloc);
-      data.AddMember("detail", rapidjson::Value(entry.resolvedSymbol.detail.c_str(), alloc), alloc);
-      data.AddMember("signature", rapidjson::Value(entry.resolvedSymbol.signature.c_str(), alloc), alloc);
-      data.AddMember("documentation", rapidjson::Value(entry.resolvedSymbol.documentation.c_str(), alloc), alloc);
-      data.AddMember("containerName", rapidjson::Value(entry.resolvedSymbol.containerName.c_str(), alloc), alloc);
-      data.AddMember("isMember", entry.resolvedSymbol.isMember, alloc);
-      data.AddMember("isDeprecated", entry.resolvedSymbol.isDeprecated, alloc);
-      data.AddMember("deprecationMessage", rapidjson::Value(entry.resolvedSymbol.deprecationMessage.c_str(), alloc), alloc);
-      item.AddMember("data", data, alloc);
-    }
-    items.PushBack(item, alloc);
-  }
-
-  rapidjson::Value result(rapidjson::kObjectType);
-  result.AddMember("isIncomplete", false, alloc);
-  result.AddMember("items", items, alloc);
-  writeResult(request["id"], result);
+  writeStreamedResult(request["id"], [&](JsonWriter &writer) {
+    writer.StartObject();
+    writer.Key("isIncomplete");
+    writer.Bool(false);
+    writer.Key("items");
+    writer.StartArray();
+    for (const auto &entry : entries) {
+      writer.StartObject();
+      writer.Key("label");
+      writeJsonString(writer, entry.label);
+      writer.Key("kind");
+      writer.Int(entry.kind);
+      writer.Key("detail");
+      writeJsonString(writer, entry.detail);
+      writer.Key("insertText");
+      writeJsonString(writer, entry.label);
+      if (entry.hasResolvedSymbol && entry.resolvedSymbol.isDeprecated) {
+        writeDeprecatedTags(writer, LSP_COMPLETION_ITEM_TAG_DEPRECATED);
+      }
+      if (entry.hasResolvedSymbol) {
+        const auto &symbol = entry.resolvedSymbol;
+        writer.Key("data");
+        writer.StartObject();
+        writer.Key("uri");
+        writeJsonString(writer, entry.resolvedUri);
+        writer.Key("symbolLine");
+        writer.Uint(symbol.line);
+        writer.Key("symbolStart");
+        writer.Uint(symbol.start);
+        writer.Key("symbolLength");
+        writer.Uint(symbol.length);
+        writer.Key("symbolKind");
+        writer.Int(symbol.kind);
+        writer.Key("detail");
+        writeJsonString(writer, symbol.detail);
+        writer.Key("signature");
+        writeJsonString(writer, symbol.signature);
+        writer.Key("documentation");
+        writeJsonString(writer, symbol.documentation);
+        writer.Key("containerName");
+        writeJsonString(writer, symbol.containerName);
+        writer.Key("isMember");
+        writer.Bool(symbol.isMember);
+        writer.Key("isDeprecated");
+        writer.Bool(symbol.isDeprecated);
+        writer.Key("deprecationMessage");
+        writeJsonString(writer, symbol.deprecationMessage);
+        writer.EndObject();
+      }
+      writer.EndObject();
+    }
+    writer.EndArray();
+    writer.EndObject();
+  });
 }
 
 void Server::handleCompletionResolve(rapidjson::Document &request) {
@@ -4839,7 +5286,7 @@ void Server::handleCompletionResolve(rapidjson::Document &request) {
     }
     if(!resolvedSymbol.has_value()) {
       for (const auto &doc : documents) {
-        auto symbols = collectSymbolsForUri(doc.first, doc.second.text);
+        auto symbols = collectSymbolsForUri(doc.first, doc.second.text());
         auto it = std::find_if(symbols.begin(), symbols.end(), [&](const SymbolEntry &symbol) {
           return symbol.name == label;
         });
@@ -5000,7 +5447,7 @@ void Server::handleHover(rapidjson::Document &request) {
 
   if (!bestSymbol.has_value()) {
     for (const auto &doc : documents) {
-      scanDefinitions(doc.first, doc.second.text);
+      scanDefinitions(doc.first, doc.second.text());
     }
   }
 
@@ -5198,7 +5645,7 @@ void Server::handleDefinition(rapidjson::Document &request) {
   }
 
   for (const auto &doc : documents) {
-    auto symbols = collectSymbolsForUri(doc.first, doc.second.text);
+    auto symbols = collectSymbolsForUri(doc.first, doc.second.text());
     for (const auto &symbol : symbols) {
       if (symbol.name != word) {
         continue;
@@ -5297,7 +5744,7 @@ void Server::handleDeclaration(rapidjson::Document &request) {
   }
 
   for (const auto &doc : documents) {
-    auto symbols = collectSymbolsForUri(doc.first, doc.second.text);
+    auto symbols = collectSymbolsForUri(doc.first, doc.second.text());
     for (const auto &symbol : symbols) {
       if (symbol.name != word) {
         continue;
@@ -5569,7 +6016,7 @@ void Server::handleImplementation(rapidjson::Document &request) {
   };
 
   for (const auto &doc : documents) {
-    auto symbols = collectSymbolsForUri(doc.first, doc.second.text);
+    auto symbols = collectSymbolsForUri(doc.first, doc.second.text());
     for (const auto &symbol : symbols) {
       if (targetSymbol.kind == SYMBOL_KIND_CLASS || targetSymbol.kind == SYMBOL_KIND_INTERFACE) {
         if (symbol.isMember) {
@@ -5648,9 +6095,14 @@ void Server::handleReferences(rapidjson::Document &request) {
     return;
   }
 
-  rapidjson::Document payloadDoc(rapidjson::kObjectType);
-  auto &alloc = payloadDoc.GetAllocator();
-  rapidjson::Value refs(rapidjson::kArrayType);
+  struct ReferenceLocation {
+    std::string uri;
+    unsigned startLine = 0;
+    unsigned startChar = 0;
+    unsigned endLine = 0;
+    unsigned endChar = 0;
+  };
+  std::vector<ReferenceLocation> refs;
   std::set<std::string> seen;
 
   auto appendReferenceLocation = [&](const std::string &refUri, unsigned startLine, unsigned startChar, unsigned endLine,
@@ -5659,20 +6111,17 @@ void Server::handleReferences(rapidjson::Document &request) {
     if (!seen.insert(key).second) {
       return;
     }
-    rapidjson::Value location(rapidjson::kObjectType);
-    location.AddMember("uri", rapidjson::Value(refUri.c_str(), alloc), alloc);
-
-    rapidjson::Value range(rapidjson::kObjectType);
-    rapidjson::Value rangeStart(rapidjson::kObjectType);
-    rapidjson::Value rangeEnd(rapidjson::kObjectType);
-    rangeStart.AddMember("line", startLine, alloc);
-    rangeStart.AddMember("character", startChar, alloc);
-    rangeEnd.AddMember("line", endLine, alloc);
-    rangeEnd.AddMember("character", endChar, alloc);
-    range.AddMember("start", rangeStart, alloc);
-    range.AddMember("end", rangeEnd, alloc);
-    location.AddMember("range", range, alloc);
-    refs.PushBack(location, alloc);
+    refs.push_back({refUri, startLine, startChar, endLine, endChar});
+  };
+  // Workspace-wide results can be large, so locations are streamed rather than built as a DOM.
+  auto writeReferences = [&] {
+    writeStreamedResult(request["id"], [&](JsonWriter &writer) {
+      writer.StartArray();
+      for (const auto &ref : refs) {
+        writeLocationJson(writer, ref.uri, ref.startLine, ref.startChar, ref.endLine, ref.endChar);
+      }
+      writer.EndArray();
+    });
   };
 
   BuiltinApiIndex builtinsIndex;
@@ -5721,25 +6170,29 @@ void Server::handleReferences(rapidjson::Document &request) {
     }
   }
 
+  // Only files that contain `word` as an identifier can reference it; the index also caches each
+  // occurrence's resolution until some file's declarations change.
+  refreshWorkspaceIndex();
+  auto candidateUris = workspaceIndex.filesContaining(word);
+  auto wordLength = static_cast<unsigned>(word.size());
+
   if (targetResolved) {
-    for (const auto &doc : documents) {
-      std::vector<size_t> occurrences;
-      appendOccurrences(doc.second.text, word, occurrences);
-      for (size_t offset : occurrences) {
-        unsigned startLine = 0;
-        unsigned startChar = 0;
-        unsigned endLine = 0;
-        unsigned endChar = 0;
-        positionFromOffset(doc.second.text, offset, startLine, startChar);
-        positionFromOffset(doc.second.text, offset + word.size(), endLine, endChar);
+    for (const auto &candidateUri : candidateUris) {
+      auto docIt = documents.find(candidateUri);
+      if (docIt == documents.end()) {
+        continue;
+      }
+      const auto &candidateText = docIt->second.text();
 
+      auto resolveOccurrence = [&](const IndexedOccurrence &occurrence, SymbolIdentity &identityOut) {
         SymbolEntry occurrenceSymbol;
         std::string occurrenceUri;
         bool occurrenceResolved = false;
 
         std::string occurrenceReceiver;
-        if (extractReceiverBeforeOffset(doc.second.text, offset, occurrenceReceiver) && !builtinsIndex.membersByType.empty()) {
-          auto inferredType = inferBuiltinTypeForReceiver(doc.second.text, occurrenceReceiver, startLine, builtinsIndex);
+        if (extractReceiverBeforeOffset(candidateText, occurrence.offset, occurrenceReceiver) &&
+            !builtinsIndex.membersByType.empty()) {
+          auto inferredType = inferBuiltinTypeForReceiver(candidateText, occurrenceReceiver, occurrence.line, builtinsIndex);
           if (inferredType.has_value()) {
             auto typeMembers = builtinsIndex.membersByType.find(*inferredType);
             if (typeMembers != builtinsIndex.membersByType.end()) {
@@ -5753,8 +6206,14 @@ void Server::handleReferences(rapidjson::Document &request) {
           }
         }
 
-        if (!occurrenceResolved &&
-            resolveHoverSymbol(doc.first, doc.second.text, startLine, startChar, word, offset, occurrenceUri, occurrenceSymbol)) {
+        if (!occurrenceResolved && resolveHoverSymbol(candidateUri,
+                                                      candidateText,
+                                                      occurrence.line,
+                                                      occurrence.character,
+                                                      word,
+                                                      occurrence.offset,
+                                                      occurrenceUri,
+                                                      occurrenceSymbol)) {
           occurrenceResolved = true;
         }
 
@@ -5768,56 +6227,65 @@ void Server::handleReferences(rapidjson::Document &request) {
         }
 
         if (!occurrenceResolved) {
+          return false;
+        }
+        identityOut = SymbolIdentity{occurrenceUri, occurrenceSymbol.line, occurrenceSymbol.start,
+                                     occurrenceSymbol.length, occurrenceSymbol.kind};
+        return true;
+      };
+
+      for (const auto &entry :
+           workspaceIndex.resolvedOccurrences(candidateUri, word, IndexResolution::References, resolveOccurrence)) {
+        if (!entry.resolved) {
           continue;
         }
-        if (occurrenceUri != targetUri || occurrenceSymbol.line != targetSymbol.line ||
-            occurrenceSymbol.start != targetSymbol.start || occurrenceSymbol.length != targetSymbol.length) {
+        if (entry.identity.uri != targetUri || entry.identity.line != targetSymbol.line ||
+            entry.identity.start != targetSymbol.start || entry.identity.length != targetSymbol.length) {
           continue;
         }
-        if (!includeDeclaration && doc.first == targetUri && startLine == targetSymbol.line &&
+        auto startLine = entry.occurrence.line;
+        auto startChar = entry.occurrence.character;
+        if (!includeDeclaration && candidateUri == targetUri && startLine == targetSymbol.line &&
             startChar == targetSymbol.start) {
           continue;
         }
-        appendReferenceLocation(doc.first, startLine, startChar, endLine, endChar);
+        appendReferenceLocation(candidateUri, startLine, startChar, startLine, startChar + wordLength);
       }
     }
 
-    writeResult(request["id"], refs);
+    writeReferences();
     return;
   }
 
-  for (const auto &doc : documents) {
-    std::vector<size_t> occurrences;
-    appendOccurrences(doc.second.text, word, occurrences);
+  for (const auto &candidateUri : candidateUris) {
+    const auto *occurrences = workspaceIndex.occurrences(candidateUri, word);
+    auto docIt = documents.find(candidateUri);
+    if (!occurrences || docIt == documents.end()) {
+      continue;
+    }
 
-    std::set<size_t> declarationOffsets;
+    std::set<std::pair<unsigned, unsigned>> declarationPositions;
     if (!includeDeclaration) {
-      auto symbols = collectSymbolsForUri(doc.first, doc.second.text);
+      auto symbols = collectSymbolsForUri(candidateUri, docIt->second.text());
       for (const auto &symbol : symbols) {
         if (symbol.name != word) {
           continue;
         }
-        declarationOffsets.insert(offsetFromPosition(doc.second.text, symbol.line, symbol.start));
+        declarationPositions.insert({symbol.line, symbol.start});
       }
     }
 
-    for (size_t offset : occurrences) {
-      if (!includeDeclaration && declarationOffsets.find(offset) != declarationOffsets.end()) {
+    for (const auto &occurrence : *occurrences) {
+      if (!includeDeclaration &&
+          declarationPositions.find({occurrence.line, occurrence.character}) != declarationPositions.end()) {
         continue;
       }
-
-      unsigned startLine = 0;
-      unsigned startChar = 0;
-      unsigned endLine = 0;
-      unsigned endChar = 0;
-      positionFromOffset(doc.second.text, offset, startLine, startChar);
-      positionFromOffset(doc.second.text, offset + word.size(), endLine, endChar);
-
-      appendReferenceLocation(doc.first, startLine, startChar, endLine, endChar);
+      appendReferenceLocation(candidateUri, occurrence.line, occurrence.character, occurrence.line,
+                              occurrence.character + wordLength);
     }
   }
 
-  writeResult(request["id"], refs);
+  writeReferences();
 }
 
 void Server::handleDocumentSymbol(rapidjson::Document &request) {
@@ -5893,48 +6361,29 @@ void Server::handleWorkspaceSymbol(rapidjson::Document &request) {
   if (request["params"].HasMember("query") && request["params"]["query"].IsString()) {
     query = request["params"]["query"].GetString();
   }
-  auto loweredQuery = toLower(query);
 
-  rapidjson::Document payloadDoc(rapidjson::kObjectType);
-  auto &alloc = payloadDoc.GetAllocator();
-  rapidjson::Value result(rapidjson::kArrayType);
-
-  for (const auto &doc : documents) {
-    auto symbols = collectSymbolsForUri(doc.first, doc.second.text);
-    for (const auto &symbol : symbols) {
-      auto loweredName = toLower(symbol.name);
-      if (!loweredQuery.empty() && loweredName.find(loweredQuery) == std::string::npos) {
-        continue;
-      }
-
-      rapidjson::Value symbolInfo(rapidjson::kObjectType);
-      symbolInfo.AddMember("name", rapidjson::Value(symbol.name.c_str(), alloc), alloc);
-      symbolInfo.AddMember("kind", symbol.kind, alloc);
-
-      rapidjson::Value location(rapidjson::kObjectType);
-      location.AddMember("uri", rapidjson::Value(doc.first.c_str(), alloc), alloc);
-
-      rapidjson::Value range(rapidjson::kObjectType);
-      rapidjson::Value start(rapidjson::kObjectType);
-      rapidjson::Value end(rapidjson::kObjectType);
-      start.AddMember("line", symbol.line, alloc);
-      start.AddMember("character", symbol.start, alloc);
-      end.AddMember("line", symbol.line, alloc);
-      end.AddMember("character", symbol.start + symbol.length, alloc);
-      range.AddMember("start", start, alloc);
-      range.AddMember("end", end, alloc);
-      location.AddMember("range", range, alloc);
-
-      symbolInfo.AddMember("location", location, alloc);
-      symbolInfo.AddMember("containerName", rapidjson::Value("", alloc), alloc);
+  refreshWorkspaceIndex();
+  auto matches = workspaceIndex.searchSymbols(query);
+  writeStreamedResult(request["id"], [&](JsonWriter &writer) {
+    writer.StartArray();
+    for (const auto &match : matches) {
+      const auto &symbol = *match.symbol;
+      writer.StartObject();
+      writer.Key("name");
+      writeJsonString(writer, symbol.name);
+      writer.Key("kind");
+      writer.Int(symbol.kind);
+      writer.Key("location");
+      writeLocationJson(writer, *match.uri, symbol.line, symbol.start, symbol.line, symbol.start + symbol.length);
+      writer.Key("containerName");
+      writer.String("");
       if (symbol.isDeprecated) {
-        appendDeprecatedTagArray(symbolInfo, LSP_SYMBOL_TAG_DEPRECATED, alloc);
+        writeDeprecatedTags(writer, LSP_SYMBOL_TAG_DEPRECATED);
       }
-      result.PushBack(symbolInfo, alloc);
+      writer.EndObject();
     }
-  }
-
-  writeResult(request["id"], result);
+    writer.EndArray();
+  });
 }
 
 void Server::handlePrepareRename(rapidjson::Document &request) {
@@ -6097,37 +6546,47 @@ void Server::handleRename(rapidjson::Document &request) {
 
   rapidjson::Value changes(rapidjson::kObjectType);
 
-  for (const auto &doc : documents) {
-    std::vector<size_t> offsets;
-    appendOccurrences(doc.second.text, oldName, offsets);
-    if (offsets.empty()) {
+  refreshWorkspaceIndex();
+  for (const auto &candidateUri : workspaceIndex.filesContaining(oldName)) {
+    auto docIt = documents.find(candidateUri);
+    if (docIt == documents.end()) {
       continue;
     }
+    const auto &candidateText = docIt->second.text();
 
-    rapidjson::Value edits(rapidjson::kArrayType);
-    for (size_t occurrence : offsets) {
-      unsigned sLine = 0;
-      unsigned sChar = 0;
-      unsigned eLine = 0;
-      unsigned eChar = 0;
-      positionFromOffset(doc.second.text, occurrence, sLine, sChar);
-      positionFromOffset(doc.second.text, occurrence + oldName.size(), eLine, eChar);
-
+    auto resolveOccurrence = [&](const IndexedOccurrence &occurrence, SymbolIdentity &identityOut) {
       std::string occurrenceResolvedUri;
       SymbolEntry occurrenceResolvedSymbol;
-      if (!resolveSemanticSymbolAtPosition(doc.first,
-                                           doc.second.text,
-                                           sLine,
-                                           sChar,
+      if (!resolveSemanticSymbolAtPosition(candidateUri,
+                                           candidateText,
+                                           occurrence.line,
+                                           occurrence.character,
                                            builtinsIndex,
                                            occurrenceResolvedUri,
                                            occurrenceResolvedSymbol)) {
-        continue;
+        return false;
       }
+      identityOut = SymbolIdentity{occurrenceResolvedUri, occurrenceResolvedSymbol.line, occurrenceResolvedSymbol.start,
+                                   occurrenceResolvedSymbol.length, occurrenceResolvedSymbol.kind};
+      return true;
+    };
 
-      if (!symbolIdentityMatches(occurrenceResolvedUri, occurrenceResolvedSymbol, targetUri, targetSymbol)) {
+    rapidjson::Value edits(rapidjson::kArrayType);
+    for (const auto &entry :
+         workspaceIndex.resolvedOccurrences(candidateUri, oldName, IndexResolution::Rename, resolveOccurrence)) {
+      if (!entry.resolved) {
         continue;
       }
+      if (entry.identity.uri != targetUri || entry.identity.line != targetSymbol.line ||
+          entry.identity.start != targetSymbol.start || entry.identity.length != targetSymbol.length ||
+          entry.identity.kind != targetSymbol.kind) {
+        continue;
+      }
+
+      unsigned sLine = entry.occurrence.line;
+      unsigned sChar = entry.occurrence.character;
+      unsigned eLine = sLine;
+      unsigned eChar = sChar + static_cast<unsigned>(oldName.size());
 
       rapidjson::Value edit(rapidjson::kObjectType);
       rapidjson::Value range(rapidjson::kObjectType);
@@ -6145,7 +6604,7 @@ void Server::handleRename(rapidjson::Document &request) {
     }
 
     if (!edits.Empty()) {
-      changes.AddMember(rapidjson::Value(doc.first.c_str(), alloc), edits, alloc);
+      changes.AddMember(rapidjson::Value(candidateUri.c_str(), alloc), edits, alloc);
     }
   }
 
@@ -6249,7 +6708,7 @@ void Server::handleSignatureHelp(rapidjson::Document &request) {
     if (found) {
       break;
     }
-    if (findFunctionSignatureInText(doc.second.text, functionName, signatureName, signatureParams, signatureReturn)) {
+    if (findFunctionSignatureInText(doc.second.text(), functionName, signatureName, signatureParams, signatureReturn)) {
       found = true;
     }
   }
@@ -6683,11 +7142,12 @@ void Server::handleCodeAction(rapidjson::Document &request) {
   }
   else {
     starbytes::linguistics::LinguisticsSession session(uri, text);
-    auto lintResult = lintEngine.run(session, linguisticsConfig);
+    auto artifact = starbytes::linguistics::buildLinguisticsArtifact(session);
+    auto lintResult = lintEngine.run(artifact->view(), linguisticsConfig);
     lintFindings = lintResult.findings;
     starbytes::linguistics::SuggestionRequest suggestionRequest;
     suggestionRequest.includeLowConfidence = false;
-    auto suggestionResult = suggestionEngine.run(session, linguisticsConfig, suggestionRequest);
+    auto suggestionResult = suggestionEngine.run(artifact->view(), linguisticsConfig, suggestionRequest);
     starbytes::linguistics::CodeActionRequest actionRequest;
     actionRequest.safeOnly = linguisticsConfig.actions.preferSafeActions;
     auto actionsResult = codeActionEngine.build(lintResult.findings, suggestionResult.suggestions, linguisticsConfig, actionRequest);
@@ -6783,21 +7243,16 @@ void Server::handleSemanticTokens(rapidjson::Document &request) {
     encoded = encodeSemanticTokens(entries);
   }
 
-  rapidjson::Document payloadDoc(rapidjson::kObjectType);
-  auto &alloc = payloadDoc.GetAllocator();
-
-  rapidjson::Value data(rapidjson::kArrayType);
-  for (auto item : encoded) {
-    data.PushBack(item, alloc);
-  }
-
   auto resultId = std::to_string(semanticResultCounter++);
-  semanticSnapshots[uri] = {encoded, resultId};
-
-  rapidjson::Value result(rapidjson::kObjectType);
-  result.AddMember("data", data, alloc);
-  result.AddMember("resultId", rapidjson::Value(resultId.c_str(), alloc), alloc);
-  writeResult(request["id"], result);
+  writeStreamedResult(request["id"], [&](JsonWriter &writer) {
+    writer.StartObject();
+    writer.Key("data");
+    writeSemanticTokenData(writer, encoded, 0, encoded.size());
+    writer.Key("resultId");
+    writeJsonString(writer, resultId);
+    writer.EndObject();
+  });
+  semanticSnapshots[uri] = {std::move(encoded), resultId};
 }
 
 void Server::handleSemanticTokensRange(rapidjson::Document &request) {
@@ -6833,15 +7288,12 @@ void Server::handleSemanticTokensRange(rapidjson::Document &request) {
     encoded = encodeSemanticTokens(entries);
   }
 
-  rapidjson::Document payloadDoc(rapidjson::kObjectType);
-  auto &alloc = payloadDoc.GetAllocator();
-  rapidjson::Value result(rapidjson::kObjectType);
-  rapidjson::Value data(rapidjson::kArrayType);
-  for (auto item : encoded) {
-    data.PushBack(item, alloc);
-  }
-  result.AddMember("data", data, alloc);
-  writeResult(request["id"], result);
+  writeStreamedResult(request["id"], [&](JsonWriter &writer) {
+    writer.StartObject();
+    writer.Key("data");
+    writeSemanticTokenData(writer, encoded, 0, encoded.size());
+    writer.EndObject();
+  });
 }
 
 void Server::handleSemanticTokensDelta(rapidjson::Document &request) {
@@ -6878,32 +7330,55 @@ void Server::handleSemanticTokensDelta(rapidjson::Document &request) {
   auto oldIt = semanticSnapshots.find(uri);
   if (oldIt != semanticSnapshots.end() && oldIt->second.resultId == previousResultId) {
     hasPrevious = true;
-    oldData = oldIt->second.data;
+    oldData = std::move(oldIt->second.data);
   }
 
   auto newResultId = std::to_string(semanticResultCounter++);
-  semanticSnapshots[uri] = {encoded, newResultId};
-
-  rapidjson::Document payloadDoc(rapidjson::kObjectType);
-  auto &alloc = payloadDoc.GetAllocator();
-  rapidjson::Value result(rapidjson::kObjectType);
-  rapidjson::Value edits(rapidjson::kArrayType);
-
-  if (!hasPrevious || oldData != encoded) {
-    rapidjson::Value edit(rapidjson::kObjectType);
-    edit.AddMember("start", 0, alloc);
-    edit.AddMember("deleteCount", static_cast<unsigned>(oldData.size()), alloc);
-    rapidjson::Value data(rapidjson::kArrayType);
-    for (auto item : encoded) {
-      data.PushBack(item, alloc);
-    }
-    edit.AddMember("data", data, alloc);
-    edits.PushBack(edit, alloc);
-  }
-
-  result.AddMember("edits", edits, alloc);
-  result.AddMember("resultId", rapidjson::Value(newResultId.c_str(), alloc), alloc);
-  writeResult(request["id"], result);
+  bool hasEdit = !hasPrevious || oldData != encoded;
+  size_t prefix = 0;
+  size_t suffix = 0;
+  // Replace only the tokens between the longest common prefix and suffix. Tokens are line-relative, so an
+  // edit inside one declaration leaves the encoding of everything before and after it unchanged.
+  if (hasEdit && hasPrevious) {
+    const size_t width = 5;
+    auto tokensEqual = [&](size_t oldIndex, size_t newIndex) {
+      return std::equal(oldData.begin() + oldIndex * width,
+                        oldData.begin() + (oldIndex + 1) * width,
+                        encoded.begin() + newIndex * width);
+    };
+    size_t oldCount = oldData.size() / width;
+    size_t newCount = encoded.size() / width;
+    while (prefix < oldCount && prefix < newCount && tokensEqual(prefix, prefix)) {
+      ++prefix;
+    }
+    while (suffix < oldCount - prefix && suffix < newCount - prefix &&
+           tokensEqual(oldCount - 1 - suffix, newCount - 1 - suffix)) {
+      ++suffix;
+    }
+    prefix *= width;
+    suffix *= width;
+  }
+
+  writeStreamedResult(request["id"], [&](JsonWriter &writer) {
+    writer.StartObject();
+    writer.Key("edits");
+    writer.StartArray();
+    if (hasEdit) {
+      writer.StartObject();
+      writer.Key("start");
+      writer.Uint(static_cast<unsigned>(prefix));
+      writer.Key("deleteCount");
+      writer.Uint(static_cast<unsigned>(oldData.size() - prefix - suffix));
+      writer.Key("data");
+      writeSemanticTokenData(writer, encoded, prefix, encoded.size() - suffix);
+      writer.EndObject();
+    }
+    writer.EndArray();
+    writer.Key("resultId");
+    writeJsonString(writer, newResultId);
+    writer.EndObject();
+  });
+  semanticSnapshots[uri] = {std::move(encoded), newResultId};
 }
 
 void Server::processRequest(rapidjson::Document &request) {
@@ -6914,7 +7389,7 @@ void Server::processRequest(rapidjson::Document &request) {
     return;
   }
 
-  if (canceledRequestIds.find(idToKey(request["id"])) != canceledRequestIds.end()) {
+  if (isRequestCancelled(request["id"])) {
     writeError(request["id"], LSP_REQUEST_CANCELLED, "Request cancelled");
     return;
   }
@@ -7061,7 +7536,7 @@ void Server::processRequest(rapidjson::Document &request) {
     auto docIt = documents.find(uri);
     if (docIt != documents.end()) {
       compilerDiagnostics = getCompilerDiagnosticsForDocument(uri, docIt->second);
-      text = docIt->second.text;
+      text = docIt->second.text();
     }
 
     rapidjson::Document payloadDoc(rapidjson::kObjectType);
@@ -7087,6 +7562,10 @@ void Server::processRequest(rapidjson::Document &request) {
     rapidjson::Value result(rapidjson::kObjectType);
     rapidjson::Value items(rapidjson::kArrayType);
     for (auto &doc : documents) {
+      if (isRequestCancelled(request["id"])) {
+        writeError(request["id"], LSP_REQUEST_CANCELLED, "Request cancelled");
+        return;
+      }
       auto compilerDiagnostics = getCompilerDiagnosticsForDocument(doc.first, doc.second);
       rapidjson::Value report(rapidjson::kObjectType);
       report.AddMember("uri", rapidjson::Value(doc.first.c_str(), alloc), alloc);
@@ -7097,7 +7576,7 @@ void Server::processRequest(rapidjson::Document &request) {
         appendCompilerDiagnosticJson(diag, entry, doc.first, alloc);
         diags.PushBack(diag, alloc);
       }
-      appendLinguisticsDiagnosticsJson(doc.first, doc.second.text, diags, alloc);
+      appendLinguisticsDiagnosticsJson(doc.first, doc.second.text(), diags, alloc);
       report.AddMember("items", diags, alloc);
       report.AddMember("resultId", rapidjson::Value("0", alloc), alloc);
       items.PushBack(report, alloc);
@@ -7172,32 +7651,76 @@ void Server::processNotification(rapidjson::Document &request) {
   }
 }
 
-void Server::run() {
-  while (serverOn) {
-    std::string body;
-    if (!readMessage(body)) {
-      break;
-    }
+void Server::readerLoop() {
+  auto body = messageQueue.takeBody();
+  while (readMessage(body)) {
     if (body.empty()) {
       continue;
     }
 
-    rapidjson::Document request;
-    request.Parse(body.c_str(), body.size());
-    if (request.HasParseError() || !request.IsObject()) {
+    // Parsed in place: strings in the document point into `body`, which travels with it through the queue.
+    auto request = std::make_unique<rapidjson::Document>();
+    request->ParseInsitu(body.data());
+    if (request->HasParseError() || !request->IsObject()) {
       rapidjson::Value nullId;
       nullId.SetNull();
       writeError(nullId, JSONRPC_PARSE_ERROR, "Invalid JSON payload");
       continue;
     }
 
+    bool isRequest = request->HasMember("id");
+    std::string method;
+    if (request->HasMember("method") && (*request)["method"].IsString()) {
+      method = (*request)["method"].GetString();
+    }
+    // Cancellation is applied on arrival so it can still reach a request waiting in the queue.
+    if (!isRequest && method == "$/cancelRequest") {
+      handleCancelRequest(*request);
+      continue;
+    }
+    bool isExit = !isRequest && method == "exit";
+    messageQueue.push(std::move(request), messagePriorityForMethod(method), messageIsBarrier(method, isRequest),
+                      std::move(body));
+    if (isExit) {
+      break;
+    }
+    body = messageQueue.takeBody();
+  }
+  messageQueue.close();
+}
+
+void Server::run() {
+  std::thread reader([this] { readerLoop(); });
+  QueuedMessage message;
+  while (serverOn) {
+    auto nextDeadline = std::chrono::steady_clock::time_point::max();
+    for (const auto &pending : pendingAnalysisDeadlines) {
+      nextDeadline = std::min(nextDeadline, pending.second);
+    }
+    auto popped = messageQueue.popUntil(message, nextDeadline);
+    if (popped == MessageQueue::PopResult::Closed) {
+      break;
+    }
+    schedulePendingAnalyses(false);
+    if (popped == MessageQueue::PopResult::TimedOut) {
+      continue;
+    }
+    installCompletedAnalysis();
+    auto &request = *message.document;
     if (request.HasMember("id")) {
       processRequest(request);
+      std::lock_guard<std::mutex> lock(canceledRequestMutex);
+      canceledRequestIds.erase(idToKey(request["id"]));
     } else {
       processNotification(request);
     }
+    message.document.reset();
+    messageQueue.recycleBody(std::move(message.body));
   }
+  analysisScheduler->stop();
+  reader.join();
   symbolCache.save();
+  workspaceIndex.save();
 }
 
 } // namespace starbytes::lsp
@@ -1,15 +1,27 @@
 #include <istream>
 #include <ostream>
+#include <chrono>
 #include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_set>
 #include <unordered_map>
 #include <vector>
 
 #include <rapidjson/document.h>
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
 
+#include "AnalysisScheduler.h"
 #include "DocumentAnalysis.h"
+#include "IncrementalAnalysis.h"
+#include "MessageQueue.h"
 #include "SymbolCache.h"
+#include "TextDocument.h"
+#include "WorkspaceIndex.h"
 #include "starbytes/linguistics/CodeActionEngine.h"
 #include "starbytes/linguistics/Config.h"
 #include "starbytes/linguistics/FormatterEngine.h"
@@ -32,6 +44,8 @@ namespace lsp {
 
 struct SemanticResolvedDocument;
 
+using JsonWriter = rapidjson::Writer<rapidjson::StringBuffer>;
+
 struct ServerOptions {
   std::istream &in;
   std::ostream &os;
@@ -56,16 +70,41 @@ class Server {
     bool formatReady = false;
     bool formatOk = false;
     std::string formattedText;
+    /// One parse per version, shared by lint, suggestions, and formatting.
+    starbytes::linguistics::SharedLinguisticsArtifact linguisticsArtifact;
     bool semanticResolvedReady = false;
     std::shared_ptr<SemanticResolvedDocument> semanticResolvedDocument;
+    std::shared_ptr<Semantics::SymbolTable> symbolSnapshot;
+    /// importClosureHash the snapshot was resolved against.
+    uint64_t symbolSnapshotImportHash = 0;
   };
 
-  struct DocumentState {
+  struct SemanticTokenSegment {
     std::string text;
+    unsigned line = 0;
+    /// Set when a member token was typed from a receiver declared earlier in the document text.
+    bool infersReceiver = false;
+    /// Line numbers are relative to the segment's first line.
+    std::vector<SemanticTokenEntry> tokens;
+  };
+
+  struct SemanticTokenSegments {
+    bool valid = false;
+    /// Covers imports, imported module texts, and the builtins interface.
+    uint64_t contextHash = 0;
+    std::vector<SemanticTokenSegment> segments;
+  };
+
+  struct DocumentState {
+    TextDocument content;
     int version = 0;
     bool isOpen = false;
     uint64_t textHash = 0;
     DocumentAnalysisCache analysis;
+    // Survives edits, unlike `analysis`, so semantic tokens of untouched declarations can be reused.
+    SemanticTokenSegments semanticSegments;
+
+    const std::string &text() const { return content.text(); }
   };
 
   struct BuiltinsIndexCache {
@@ -93,8 +132,22 @@ class Server {
   std::vector<std::string> workspaceRoots;
   std::unordered_map<std::string, DocumentState> documents;
   std::unordered_map<std::string, SemanticSnapshot> semanticSnapshots;
+  std::mutex canceledRequestMutex;
   std::unordered_set<std::string> canceledRequestIds;
+  std::mutex outputMutex;
+  // Guarded by outputMutex; reused so each response is serialized without a fresh buffer.
+  rapidjson::StringBuffer outputBuffer;
+  MessageQueue messageQueue;
+  // didChange analyses wait here until the debounce window closes, so a burst of edits builds one snapshot.
+  std::unordered_map<std::string, std::chrono::steady_clock::time_point> pendingAnalysisDeadlines;
+  std::chrono::milliseconds analysisDebounce{150};
+  // Internally synchronized; analysis workers update it from the const runDocumentAnalysis.
+  mutable IncrementalDiagnostics incrementalDiagnostics;
   SymbolCache symbolCache;
+  WorkspaceIndex workspaceIndex;
+  std::unordered_set<std::string> workspaceIndexDirtyUris;
+  bool workspaceIndexSeeded = false;
+  std::filesystem::path symbolSnapshotDir;
   BuiltinsIndexCache builtinsIndexCache;
   starbytes::linguistics::LinguisticsConfig linguisticsConfig = starbytes::linguistics::LinguisticsConfig::defaults();
   starbytes::linguistics::FormatterEngine formatterEngine;
@@ -102,6 +155,8 @@ class Server {
   starbytes::linguistics::SuggestionEngine suggestionEngine;
   starbytes::linguistics::CodeActionEngine codeActionEngine;
   bool linguisticsProfilingEnabled = false;
+  uint64_t lspProfileParseNs = 0;
+  uint64_t lspProfileParseCount = 0;
   uint64_t lspProfileLintNs = 0;
   uint64_t lspProfileSuggestionNs = 0;
   uint64_t lspProfileActionNs = 0;
@@ -109,10 +164,15 @@ class Server {
   uint64_t lspProfileDiagnosticsNs = 0;
   uint64_t lspProfileCodeActionNs = 0;
   uint64_t lspProfileFormattingNs = 0;
+  std::map<std::string, uint64_t> lspProfileLintRuleNs;
+  // Declared last so workers are joined before the engines and caches they read are destroyed.
+  std::unique_ptr<AnalysisScheduler> analysisScheduler;
 
-  bool readMessage(std::string &body);
-  void writeMessage(rapidjson::Document &doc);
+  bool readMessage(std::vector<char> &body);
+  void writeMessage(const std::function<void(JsonWriter &)> &writeBody);
   void writeResult(const rapidjson::Value &id, rapidjson::Value &result);
+  /// Streams the result straight into the response, for payloads too large to build as a DOM first.
+  void writeStreamedResult(const rapidjson::Value &id, const std::function<void(JsonWriter &)> &writeResultBody);
   void writeError(const rapidjson::Value &id, int code, const char *message);
   void writeNotification(const char *method, rapidjson::Value &params);
 
@@ -142,18 +202,33 @@ class Server {
   bool getDocumentTextByUri(const std::string &uri, std::string &textOut);
   void setDocumentTextByUri(const std::string &uri, const std::string &text, int version, bool isOpen);
   void removeOpenDocumentByUri(const std::string &uri);
-  void publishDiagnostics(const std::string &uri);
+  void documentTextChanged(const std::string &uri);
+  void readerLoop();
+  bool isRequestCancelled(const rapidjson::Value &id);
+  std::unordered_map<std::string, std::shared_ptr<Semantics::SymbolTable>> dependencyTablesForImports(
+      const std::string &uri,
+      const std::vector<std::string> &imports,
+      std::unordered_set<std::string> &activeUris);
+  void scheduleDocumentAnalysis(const std::string &uri);
+  void schedulePendingAnalyses(bool force);
+  bool runDocumentAnalysis(const AnalysisSnapshot &snapshot,
+                           const AnalysisScheduler::IsStale &isStale,
+                           AnalysisResult &resultOut) const;
+  void publishAnalysisResult(const AnalysisResult &result);
+  void installCompletedAnalysis();
   void appendLinguisticsDiagnosticsJson(const std::string &uri,
                                         const std::string &text,
                                         rapidjson::Value &diagnostics,
                                         rapidjson::Document::AllocatorType &alloc);
-  void maybeApplyIncrementalChange(std::string &text, const rapidjson::Value &change);
+  void maybeApplyIncrementalChange(TextDocument &document, const rapidjson::Value &change);
   void configureSymbolCache();
   const std::vector<CompilerDiagnosticEntry> &getCompilerDiagnosticsForDocument(const std::string &uri,
                                                                                 DocumentState &state);
   std::vector<CompilerDiagnosticEntry> buildCompilerDiagnosticsFromSemanticContext(const std::string &uri,
                                                                                    DocumentState &state);
   const std::vector<SemanticTokenEntry> &getSemanticTokensForDocument(const std::string &uri, DocumentState &state);
+  const starbytes::linguistics::LinguisticsArtifact &getLinguisticsArtifactForDocument(const std::string &uri,
+                                                                                     DocumentState &state);
   const std::vector<starbytes::linguistics::LintFinding> &getLintFindingsForDocument(const std::string &uri,
                                                                                       DocumentState &state);
   const std::vector<starbytes::linguistics::Suggestion> &getSuggestionsForDocument(const std::string &uri,
@@ -164,16 +239,30 @@ class Server {
   bool getFormattedTextForDocument(const std::string &uri, DocumentState &state, std::string &formattedTextOut);
   void maybeLogLspProfileSample(const char *label, uint64_t elapsedNs, size_t itemCount = 0);
   void maybeLogLspProfileSummary();
+  void recordLintRuleTimings(const std::vector<starbytes::linguistics::LintRuleTiming> &timings);
   const BuiltinApiIndex *getBuiltinsApiIndex();
   std::vector<SymbolEntry> collectSymbolsForUri(const std::string &uri, const std::string &text);
   void invalidateSymbolCacheForUri(const std::string &uri);
+  void refreshWorkspaceIndex();
   void refreshAnalysisState(DocumentState &state);
   const SemanticResolvedDocument *getSemanticResolvedDocumentForUri(const std::string &uri, DocumentState &state);
   std::shared_ptr<SemanticResolvedDocument> buildSemanticResolvedDocumentForUri(
       const std::string &uri,
       DocumentState &state,
       std::unordered_set<std::string> &activeUris);
+  /// Hashes the texts of the modules `text` imports, directly or transitively.
+  uint64_t importClosureHash(const std::string &uri, const std::string &text);
+  std::shared_ptr<Semantics::SymbolTable> dependencySymbolTableForUri(const std::string &uri,
+                                                                     DocumentState &state,
+                                                                     std::unordered_set<std::string> &activeUris);
   std::vector<SemanticTokenEntry> buildSemanticTokensFromSemanticCache(const std::string &uri, DocumentState &state);
+  uint64_t semanticTokenContextHash(const std::string &uri, const std::vector<std::string> &imports);
+  void classifySemanticTokenSegment(const std::string &uri,
+                                    DocumentState &state,
+                                    const SemanticResolvedDocument &parsedDocument,
+                                    const BuiltinApiIndex &builtinsIndex,
+                                    const TopLevelSegment &segment,
+                                    SemanticTokenSegment &segmentOut);
   bool findModuleDocumentByName(const std::string &moduleName,
                                 const std::string &anchorUri,
                                 std::string &uriOut,
@@ -256,6 +345,7 @@ class Server {
   void processNotification(rapidjson::Document &request);
 public:
   explicit Server(starbytes::lsp::ServerOptions &options);
+  ~Server();
   void run();
 };
 
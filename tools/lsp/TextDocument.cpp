@@ -0,0 +1,398 @@
+#include "TextDocument.h"
+
+#include <algorithm>
+
+namespace starbytes::lsp {
+
+namespace {
+
+constexpr uint64_t kHashModulus = (1ULL << 61) - 1;
+constexpr uint64_t kHashBase = 0x1F3D5B79A3C1ULL;
+constexpr size_t kCheckpointStride = 64;
+/// Past this many pieces the next edit folds the document back into one piece (amortized O(n / kMaxPieces)).
+constexpr size_t kMaxPieces = 4096;
+
+uint64_t reduceHash(uint64_t value) {
+  value = (value & kHashModulus) + (value >> 61);
+  return value >= kHashModulus ? value - kHashModulus : value;
+}
+
+uint64_t mulHash(uint64_t left, uint64_t right) {
+#if defined(__SIZEOF_INT128__)
+  auto product = static_cast<unsigned __int128>(left) * right;
+  return reduceHash(reduceHash(static_cast<uint64_t>(product & kHashModulus)) + static_cast<uint64_t>(product >> 61));
+#else
+  uint64_t leftHigh = left >> 32;
+  uint64_t leftLow = left & 0xFFFFFFFFULL;
+  uint64_t rightHigh = right >> 32;
+  uint64_t rightLow = right & 0xFFFFFFFFULL;
+  uint64_t middle = leftHigh * rightLow + leftLow * rightHigh;
+  uint64_t high = reduceHash((leftHigh * rightHigh) << 3);
+  uint64_t mid = reduceHash((middle >> 29) + ((middle & ((1ULL << 29) - 1)) << 32));
+  return reduceHash(reduceHash(high + mid) + reduceHash(leftLow * rightLow));
+#endif
+}
+
+uint64_t addHash(uint64_t left, uint64_t right) {
+  return reduceHash(left + right);
+}
+
+uint64_t extendHash(uint64_t hash, char c) {
+  return addHash(mulHash(hash, kHashBase), static_cast<uint64_t>(static_cast<unsigned char>(c)) + 1);
+}
+
+uint64_t powHash(size_t exponent) {
+  uint64_t result = 1;
+  uint64_t base = kHashBase;
+  while (exponent > 0) {
+    if (exponent & 1) {
+      result = mulHash(result, base);
+    }
+    base = mulHash(base, base);
+    exponent >>= 1;
+  }
+  return result;
+}
+
+void indexAppend(std::vector<size_t> &newlines,
+                 std::vector<uint64_t> &checkpoints,
+                 uint64_t &prefixHash,
+                 const std::string &text,
+                 size_t from) {
+  for (size_t i = from; i < text.size(); ++i) {
+    if (text[i] == '\n') {
+      newlines.push_back(i);
+    }
+    prefixHash = extendHash(prefixHash, text[i]);
+    if ((i + 1) % kCheckpointStride == 0) {
+      checkpoints.push_back(prefixHash);
+    }
+  }
+}
+
+}
+
+TextDocument::TextDocument() { rebase(std::make_shared<const std::string>()); }
+
+TextDocument::TextDocument(std::string text) { assign(std::move(text)); }
+
+uint64_t TextDocument::hashOf(const std::string &text) {
+  uint64_t hash = 0;
+  for (char c : text) {
+    hash = extendHash(hash, c);
+  }
+  return hash;
+}
+
+const std::string &TextDocument::bufferText(uint8_t buffer) const { return buffer == 0 ? *original : added; }
+
+const TextDocument::BufferIndex &TextDocument::bufferIndex(uint8_t buffer) const {
+  return buffer == 0 ? originalIndex : addedIndex;
+}
+
+uint64_t TextDocument::prefixHash(uint8_t buffer, size_t end) const {
+  const auto &text = bufferText(buffer);
+  size_t checkpoint = end / kCheckpointStride;
+  uint64_t hash = bufferIndex(buffer).checkpoints[checkpoint];
+  for (size_t i = checkpoint * kCheckpointStride; i < end; ++i) {
+    hash = extendHash(hash, text[i]);
+  }
+  return hash;
+}
+
+uint64_t TextDocument::rangeHash(uint8_t buffer, size_t start, size_t end) const {
+  auto shifted = mulHash(prefixHash(buffer, start), powHash(end - start));
+  return reduceHash(prefixHash(buffer, end) + kHashModulus - shifted);
+}
+
+size_t TextDocument::newlinesBefore(uint8_t buffer, size_t end) const {
+  const auto &newlines = bufferIndex(buffer).newlines;
+  return static_cast<size_t>(std::lower_bound(newlines.begin(), newlines.end(), end) - newlines.begin());
+}
+
+void TextDocument::setPiece(uint32_t node, uint8_t buffer, size_t start, size_t length) {
+  auto &piece = nodes[node];
+  piece.buffer = buffer;
+  piece.start = start;
+  piece.length = length;
+  piece.newlines = newlinesBefore(buffer, start + length) - newlinesBefore(buffer, start);
+  piece.hash = rangeHash(buffer, start, start + length);
+  piece.power = powHash(length);
+}
+
+uint32_t TextDocument::allocateNode(uint8_t buffer, size_t start, size_t length) {
+  uint32_t node = 0;
+  if (!freeNodes.empty()) {
+    node = freeNodes.back();
+    freeNodes.pop_back();
+    nodes[node] = Node{};
+  } else {
+    node = static_cast<uint32_t>(nodes.size());
+    nodes.emplace_back();
+  }
+  randomState ^= randomState << 13;
+  randomState ^= randomState >> 17;
+  randomState ^= randomState << 5;
+  nodes[node].priority = randomState;
+  setPiece(node, buffer, start, length);
+  pull(node);
+  return node;
+}
+
+void TextDocument::pull(uint32_t node) {
+  auto &piece = nodes[node];
+  uint64_t hash = 0;
+  uint64_t power = 1;
+  piece.totalLength = piece.length;
+  piece.totalNewlines = piece.newlines;
+  if (piece.left) {
+    const auto &left = nodes[piece.left];
+    piece.totalLength += left.totalLength;
+    piece.totalNewlines += left.totalNewlines;
+    hash = left.totalHash;
+    power = left.totalPower;
+  }
+  hash = addHash(mulHash(hash, piece.power), piece.hash);
+  power = mulHash(power, piece.power);
+  if (piece.right) {
+    const auto &right = nodes[piece.right];
+    piece.totalLength += right.totalLength;
+    piece.totalNewlines += right.totalNewlines;
+    hash = addHash(mulHash(hash, right.totalPower), right.totalHash);
+    power = mulHash(power, right.totalPower);
+  }
+  piece.totalHash = hash;
+  piece.totalPower = power;
+}
+
+void TextDocument::split(uint32_t node, size_t offset, uint32_t &leftOut, uint32_t &rightOut) {
+  if (!node) {
+    leftOut = rightOut = 0;
+    return;
+  }
+  // Indices only: allocating a node below may reallocate `nodes`.
+  uint32_t left = nodes[node].left;
+  uint32_t right = nodes[node].right;
+  size_t leftLength = left ? nodes[left].totalLength : 0;
+  if (offset <= leftLength) {
+    uint32_t splitLeft = 0;
+    uint32_t splitRight = 0;
+    split(left, offset, splitLeft, splitRight);
+    nodes[node].left = splitRight;
+    pull(node);
+    leftOut = splitLeft;
+    rightOut = node;
+    return;
+  }
+
+  size_t pieceEnd = leftLength + nodes[node].length;
+  if (offset >= pieceEnd) {
+    uint32_t splitLeft = 0;
+    uint32_t splitRight = 0;
+    split(right, offset - pieceEnd, splitLeft, splitRight);
+    nodes[node].right = splitLeft;
+    pull(node);
+    leftOut = node;
+    rightOut = splitRight;
+    return;
+  }
+
+  auto buffer = nodes[node].buffer;
+  auto start = nodes[node].start;
+  auto length = nodes[node].length;
+  size_t cut = offset - leftLength;
+  uint32_t tail = allocateNode(buffer, start + cut, length - cut);
+  setPiece(node, buffer, start, cut);
+  nodes[node].right = 0;
+  pull(node);
+  leftOut = node;
+  rightOut = merge(tail, right);
+}
+
+uint32_t TextDocument::merge(uint32_t left, uint32_t right) {
+  if (!left) {
+    return right;
+  }
+  if (!right) {
+    return left;
+  }
+  if (nodes[left].priority > nodes[right].priority) {
+    auto merged = merge(nodes[left].right, right);
+    nodes[left].right = merged;
+    pull(left);
+    return left;
+  }
+  auto merged = merge(left, nodes[right].left);
+  nodes[right].left = merged;
+  pull(right);
+  return right;
+}
+
+void TextDocument::release(uint32_t node) {
+  std::vector<uint32_t> pending;
+  if (node) {
+    pending.push_back(node);
+  }
+  while (!pending.empty()) {
+    auto current = pending.back();
+    pending.pop_back();
+    if (nodes[current].left) {
+      pending.push_back(nodes[current].left);
+    }
+    if (nodes[current].right) {
+      pending.push_back(nodes[current].right);
+    }
+    freeNodes.push_back(current);
+  }
+}
+
+size_t TextDocument::liveNodeCount() const { return nodes.size() - 1 - freeNodes.size(); }
+
+void TextDocument::rebase(std::shared_ptr<const std::string> text) {
+  original = std::move(text);
+  originalIndex = BufferIndex{};
+  originalIndex.checkpoints.push_back(0);
+  indexAppend(originalIndex.newlines, originalIndex.checkpoints, originalIndex.prefixHash, *original, 0);
+  added.clear();
+  addedIndex = BufferIndex{};
+  addedIndex.checkpoints.push_back(0);
+  nodes.assign(1, Node{});
+  freeNodes.clear();
+  root = original->empty() ? 0 : allocateNode(0, 0, original->size());
+  cachedText = original;
+}
+
+void TextDocument::assign(std::string text) { rebase(std::make_shared<const std::string>(std::move(text))); }
+
+void TextDocument::replace(size_t start, size_t end, const std::string &replacement) {
+  if (start > end) {
+    std::swap(start, end);
+  }
+  auto total = size();
+  start = std::min(start, total);
+  end = std::min(end, total);
+  if (start == end && replacement.empty()) {
+    return;
+  }
+
+  uint32_t before = 0;
+  uint32_t rest = 0;
+  uint32_t removed = 0;
+  uint32_t after = 0;
+  split(root, start, before, rest);
+  split(rest, end - start, removed, after);
+  release(removed);
+
+  uint32_t inserted = 0;
+  if (!replacement.empty()) {
+    auto addedStart = added.size();
+    added.append(replacement);
+    indexAppend(addedIndex.newlines, addedIndex.checkpoints, addedIndex.prefixHash, added, addedStart);
+    inserted = allocateNode(1, addedStart, replacement.size());
+  }
+  root = merge(merge(before, inserted), after);
+  cachedText.reset();
+
+  if (liveNodeCount() > kMaxPieces) {
+    rebase(snapshot());
+  }
+}
+
+size_t TextDocument::size() const { return root ? nodes[root].totalLength : 0; }
+
+size_t TextDocument::lineCount() const { return (root ? nodes[root].totalNewlines : 0) + 1; }
+
+size_t TextDocument::pieceCount() const { return liveNodeCount(); }
+
+uint64_t TextDocument::hash() const { return root ? nodes[root].totalHash : 0; }
+
+size_t TextDocument::newlineOffset(size_t ordinal) const {
+  size_t base = 0;
+  uint32_t node = root;
+  while (node) {
+    const auto &piece = nodes[node];
+    size_t leftNewlines = piece.left ? nodes[piece.left].totalNewlines : 0;
+    size_t leftLength = piece.left ? nodes[piece.left].totalLength : 0;
+    if (ordinal < leftNewlines) {
+      node = piece.left;
+      continue;
+    }
+    ordinal -= leftNewlines;
+    if (ordinal < piece.newlines) {
+      const auto &newlines = bufferIndex(piece.buffer).newlines;
+      auto first = newlinesBefore(piece.buffer, piece.start);
+      return base + leftLength + (newlines[first + ordinal] - piece.start);
+    }
+    ordinal -= piece.newlines;
+    base += leftLength + piece.length;
+    node = piece.right;
+  }
+  return size();
+}
+
+size_t TextDocument::offsetAt(unsigned line, unsigned character) const {
+  auto total = size();
+  size_t totalNewlines = root ? nodes[root].totalNewlines : 0;
+  size_t lineStart = 0;
+  if (line > 0) {
+    if (line > totalNewlines) {
+      return total;
+    }
+    lineStart = newlineOffset(line - 1) + 1;
+  }
+  size_t lineEnd = line < totalNewlines ? newlineOffset(line) : total;
+  return std::min(lineStart + character, lineEnd);
+}
+
+void TextDocument::positionAt(size_t offset, unsigned &lineOut, unsigned &characterOut) const {
+  auto capped = std::min(offset, size());
+  size_t newlines = 0;
+  size_t remaining = capped;
+  uint32_t node = root;
+  while (node) {
+    const auto &piece = nodes[node];
+    size_t leftLength = piece.left ? nodes[piece.left].totalLength : 0;
+    if (remaining < leftLength) {
+      node = piece.left;
+      continue;
+    }
+    newlines += piece.left ? nodes[piece.left].totalNewlines : 0;
+    remaining -= leftLength;
+    if (remaining <= piece.length) {
+      newlines += newlinesBefore(piece.buffer, piece.start + remaining) - newlinesBefore(piece.buffer, piece.start);
+      break;
+    }
+    newlines += piece.newlines;
+    remaining -= piece.length;
+    node = piece.right;
+  }
+
+  size_t lineStart = newlines == 0 ? 0 : newlineOffset(newlines - 1) + 1;
+  lineOut = static_cast<unsigned>(newlines);
+  characterOut = static_cast<unsigned>(capped - lineStart);
+}
+
+std::shared_ptr<const std::string> TextDocument::snapshot() const {
+  if (cachedText) {
+    return cachedText;
+  }
+  std::string text;
+  text.reserve(size());
+  std::vector<uint32_t> pending;
+  uint32_t node = root;
+  while (node || !pending.empty()) {
+    while (node) {
+      pending.push_back(node);
+      node = nodes[node].left;
+    }
+    node = pending.back();
+    pending.pop_back();
+    const auto &piece = nodes[node];
+    text.append(bufferText(piece.buffer), piece.start, piece.length);
+    node = piece.right;
+  }
+  cachedText = std::make_shared<const std::string>(std::move(text));
+  return cachedText;
+}
+
+}
@@ -0,0 +1,93 @@
+#ifndef STARBYTES_LSP_TEXTDOCUMENT_H
+#define STARBYTES_LSP_TEXTDOCUMENT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace starbytes::lsp {
+
+/// Editable document text stored as a piece table.
+/// Pieces live in a treap that tracks length, newline count, and a polynomial hash per subtree, so edits,
+/// line/offset conversion, and the content hash are all O(log n). The flat text is only materialized on
+/// demand and shared as an immutable snapshot until the next edit.
+class TextDocument final {
+  struct BufferIndex {
+    std::vector<size_t> newlines;
+    /// Prefix hash at every `kCheckpointStride` bytes; a range hash rescans at most one stride.
+    std::vector<uint64_t> checkpoints;
+    uint64_t prefixHash = 0;
+  };
+
+  struct Node {
+    uint8_t buffer = 0;
+    size_t start = 0;
+    size_t length = 0;
+    size_t newlines = 0;
+    uint64_t hash = 0;
+    uint64_t power = 1;
+    uint32_t priority = 0;
+    uint32_t left = 0;
+    uint32_t right = 0;
+    size_t totalLength = 0;
+    size_t totalNewlines = 0;
+    uint64_t totalHash = 0;
+    uint64_t totalPower = 1;
+  };
+
+  std::shared_ptr<const std::string> original;
+  std::string added;
+  BufferIndex originalIndex;
+  BufferIndex addedIndex;
+  std::vector<Node> nodes;
+  std::vector<uint32_t> freeNodes;
+  uint32_t root = 0;
+  uint32_t randomState = 0x9E3779B9u;
+  mutable std::shared_ptr<const std::string> cachedText;
+
+  const std::string &bufferText(uint8_t buffer) const;
+  const BufferIndex &bufferIndex(uint8_t buffer) const;
+  uint64_t prefixHash(uint8_t buffer, size_t end) const;
+  uint64_t rangeHash(uint8_t buffer, size_t start, size_t end) const;
+  size_t newlinesBefore(uint8_t buffer, size_t end) const;
+
+  uint32_t allocateNode(uint8_t buffer, size_t start, size_t length);
+  void setPiece(uint32_t node, uint8_t buffer, size_t start, size_t length);
+  void pull(uint32_t node);
+  void split(uint32_t node, size_t offset, uint32_t &leftOut, uint32_t &rightOut);
+  uint32_t merge(uint32_t left, uint32_t right);
+  void release(uint32_t node);
+  size_t liveNodeCount() const;
+  void rebase(std::shared_ptr<const std::string> text);
+  /// Offset of the newline with zero-based index `ordinal`; `size()` when there are fewer newlines.
+  size_t newlineOffset(size_t ordinal) const;
+
+public:
+  TextDocument();
+  explicit TextDocument(std::string text);
+
+  static uint64_t hashOf(const std::string &text);
+
+  void assign(std::string text);
+  /// Replaces bytes [start, end); reversed bounds are swapped, then both are clamped to the document size.
+  void replace(size_t start, size_t end, const std::string &replacement);
+
+  size_t size() const;
+  size_t lineCount() const;
+  size_t pieceCount() const;
+  uint64_t hash() const;
+
+  /// Same clamping rules as `Server::offsetFromPosition`.
+  size_t offsetAt(unsigned line, unsigned character) const;
+  /// Same rules as `Server::positionFromOffset`; offsets past the end are clamped.
+  void positionAt(size_t offset, unsigned &lineOut, unsigned &characterOut) const;
+
+  std::shared_ptr<const std::string> snapshot() const;
+  const std::string &text() const { return *snapshot(); }
+};
+
+}
+
+#endif
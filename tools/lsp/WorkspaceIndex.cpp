@@ -0,0 +1,523 @@
+#include "WorkspaceIndex.h"
+
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+
+namespace starbytes::lsp {
+
+namespace {
+
+constexpr char kIndexMagic[8] = {'S', 'B', 'W', 'I', 'D', 'X', '0', '1'};
+
+bool isIdentifierChar(char c) {
+  return std::isalnum(static_cast<unsigned char>(c)) != 0 || c == '_';
+}
+
+std::string toLowerCopy(const std::string &in) {
+  std::string out = in;
+  for (auto &c : out) {
+    c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+  }
+  return out;
+}
+
+uint32_t trigramKey(const std::string &text, size_t pos) {
+  return (static_cast<uint32_t>(static_cast<unsigned char>(text[pos])) << 16) |
+         (static_cast<uint32_t>(static_cast<unsigned char>(text[pos + 1])) << 8) |
+         static_cast<uint32_t>(static_cast<unsigned char>(text[pos + 2]));
+}
+
+void hashBytes(uint64_t &hash, const void *data, size_t size) {
+  const auto *bytes = static_cast<const unsigned char *>(data);
+  for (size_t i = 0; i < size; ++i) {
+    hash ^= bytes[i];
+    hash *= 1099511628211ULL;
+  }
+}
+
+void hashString(uint64_t &hash, const std::string &value) {
+  uint64_t size = value.size();
+  hashBytes(hash, &size, sizeof(size));
+  hashBytes(hash, value.data(), value.size());
+}
+
+/// Hash of everything occurrence resolution can observe about a file's declarations.
+uint64_t declarationHashOf(const std::vector<SymbolEntry> &symbols) {
+  uint64_t hash = 1469598103934665603ULL;
+  for (const auto &symbol : symbols) {
+    hashString(hash, symbol.name);
+    hashString(hash, symbol.detail);
+    hashString(hash, symbol.containerName);
+    uint32_t fields[5] = {static_cast<uint32_t>(symbol.kind), symbol.isMember ? 1u : 0u, symbol.line, symbol.start,
+                          symbol.length};
+    hashBytes(hash, fields, sizeof(fields));
+  }
+  return hash;
+}
+
+void writeU32(std::ostream &out, uint32_t value) {
+  out.write(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+void writeU64(std::ostream &out, uint64_t value) {
+  out.write(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+void writeString(std::ostream &out, const std::string &value) {
+  writeU32(out, static_cast<uint32_t>(value.size()));
+  out.write(value.data(), static_cast<std::streamsize>(value.size()));
+}
+
+bool readU32(std::istream &in, uint32_t &value) {
+  return static_cast<bool>(in.read(reinterpret_cast<char *>(&value), sizeof(value)));
+}
+
+bool readU64(std::istream &in, uint64_t &value) {
+  return static_cast<bool>(in.read(reinterpret_cast<char *>(&value), sizeof(value)));
+}
+
+/// Reads a record or byte count, rejecting any that could not fit in the rest of the file so a
+/// corrupt header cannot drive a huge allocation.
+bool readCount(std::istream &in, uint64_t fileSize, uint32_t &count) {
+  if (!readU32(in, count)) {
+    return false;
+  }
+  auto offset = in.tellg();
+  return offset >= 0 && count <= fileSize - static_cast<uint64_t>(offset);
+}
+
+bool readString(std::istream &in, uint64_t fileSize, std::string &value) {
+  uint32_t size = 0;
+  if (!readCount(in, fileSize, size)) {
+    return false;
+  }
+  value.resize(size);
+  return size == 0 || static_cast<bool>(in.read(&value[0], size));
+}
+
+}
+
+std::unordered_map<std::string, std::vector<IndexedOccurrence>> WorkspaceIndex::scanIdentifiers(const std::string &text) {
+  std::unordered_map<std::string, std::vector<IndexedOccurrence>> identifiers;
+  uint32_t line = 0;
+  uint32_t character = 0;
+  size_t pos = 0;
+  while (pos < text.size()) {
+    if (!isIdentifierChar(text[pos])) {
+      if (text[pos] == '\n') {
+        ++line;
+        character = 0;
+      } else {
+        ++character;
+      }
+      ++pos;
+      continue;
+    }
+    size_t end = pos;
+    while (end < text.size() && isIdentifierChar(text[end])) {
+      ++end;
+    }
+    identifiers[text.substr(pos, end - pos)].push_back(
+        IndexedOccurrence{static_cast<uint32_t>(pos), line, character});
+    character += static_cast<uint32_t>(end - pos);
+    pos = end;
+  }
+  return identifiers;
+}
+
+void WorkspaceIndex::setIndexPath(const std::filesystem::path &path) {
+  if (indexPath == path) {
+    return;
+  }
+  indexPath = path;
+  persisted.clear();
+  loaded = false;
+  dirty = !files.empty();
+}
+
+void WorkspaceIndex::loadIfNeeded() {
+  if (loaded) {
+    return;
+  }
+  loaded = true;
+  persisted.clear();
+  if (indexPath.empty()) {
+    return;
+  }
+
+  std::ifstream in(indexPath, std::ios::in | std::ios::binary | std::ios::ate);
+  if (!in.is_open()) {
+    return;
+  }
+  auto endOffset = in.tellg();
+  if (endOffset < 0 || !in.seekg(0)) {
+    return;
+  }
+  auto fileSize = static_cast<uint64_t>(endOffset);
+
+  char magic[sizeof(kIndexMagic)] = {};
+  uint32_t fileCount = 0;
+  if (!in.read(magic, sizeof(magic)) || !std::equal(magic, magic + sizeof(magic), kIndexMagic) ||
+      !readCount(in, fileSize, fileCount)) {
+    return;
+  }
+
+  // Vectors grow as records are read; counts are only trusted once they fit the file.
+  auto fail = [&] { persisted.clear(); };
+  for (uint32_t fileIndex = 0; fileIndex < fileCount; ++fileIndex) {
+    std::string uri;
+    PersistedEntry entry;
+    uint32_t symbolCount = 0;
+    if (!readString(in, fileSize, uri) || !readU64(in, entry.textHash) || !readCount(in, fileSize, symbolCount)) {
+      return fail();
+    }
+    for (uint32_t i = 0; i < symbolCount; ++i) {
+      SymbolEntry symbol;
+      uint32_t kind = 0;
+      uint32_t flags = 0;
+      if (!readString(in, fileSize, symbol.name) || !readU32(in, kind) || !readString(in, fileSize, symbol.detail) ||
+          !readString(in, fileSize, symbol.signature) || !readString(in, fileSize, symbol.documentation) ||
+          !readString(in, fileSize, symbol.containerName) || !readU32(in, flags) ||
+          !readString(in, fileSize, symbol.deprecationMessage) || !readU32(in, symbol.line) ||
+          !readU32(in, symbol.start) || !readU32(in, symbol.length)) {
+        return fail();
+      }
+      symbol.kind = static_cast<int>(kind);
+      symbol.isMember = (flags & 1u) != 0;
+      symbol.isDeprecated = (flags & 2u) != 0;
+      entry.symbols.push_back(std::move(symbol));
+    }
+
+    uint32_t identifierCount = 0;
+    if (!readCount(in, fileSize, identifierCount)) {
+      return fail();
+    }
+    for (uint32_t i = 0; i < identifierCount; ++i) {
+      std::string name;
+      uint32_t occurrenceCount = 0;
+      if (!readString(in, fileSize, name) || !readCount(in, fileSize, occurrenceCount)) {
+        return fail();
+      }
+      auto &occurrences = entry.identifiers[name];
+      for (uint32_t j = 0; j < occurrenceCount; ++j) {
+        IndexedOccurrence occurrence;
+        if (!readU32(in, occurrence.offset) || !readU32(in, occurrence.line) || !readU32(in, occurrence.character)) {
+          return fail();
+        }
+        occurrences.push_back(occurrence);
+      }
+    }
+    persisted[uri] = std::move(entry);
+  }
+}
+
+bool WorkspaceIndex::isCurrent(const std::string &uri, uint64_t textHash) const {
+  auto id = fileIdsByUri.find(uri);
+  return id != fileIdsByUri.end() && files.at(id->second).textHash == textHash;
+}
+
+bool WorkspaceIndex::adoptPersisted(const std::string &uri, uint64_t textHash) {
+  loadIfNeeded();
+  auto it = persisted.find(uri);
+  if (it == persisted.end()) {
+    return false;
+  }
+  auto entry = std::move(it->second);
+  persisted.erase(it);
+  if (entry.textHash != textHash) {
+    return false;
+  }
+  install(uri, textHash, std::move(entry.symbols), std::move(entry.identifiers));
+  ++statistics.filesAdopted;
+  return true;
+}
+
+void WorkspaceIndex::update(const std::string &uri,
+                            uint64_t textHash,
+                            const std::string &text,
+                            std::vector<SymbolEntry> symbols) {
+  loadIfNeeded();
+  persisted.erase(uri);
+  install(uri, textHash, std::move(symbols), scanIdentifiers(text));
+  ++statistics.filesIndexed;
+}
+
+void WorkspaceIndex::install(const std::string &uri,
+                             uint64_t textHash,
+                             std::vector<SymbolEntry> symbols,
+                             std::unordered_map<std::string, std::vector<IndexedOccurrence>> identifiers) {
+  auto declarationHash = declarationHashOf(symbols);
+  uint32_t fileId = 0;
+  auto existingId = fileIdsByUri.find(uri);
+  if (existingId != fileIdsByUri.end()) {
+    fileId = existingId->second;
+    auto &previous = files[fileId];
+    if (previous.declarationHash != declarationHash) {
+      ++resolutionEpoch;
+    }
+    unpost(fileId, previous);
+  } else {
+    fileId = nextFileId++;
+    fileIdsByUri[uri] = fileId;
+    ++resolutionEpoch;
+  }
+
+  FileEntry entry;
+  entry.uri = uri;
+  entry.textHash = textHash;
+  entry.declarationHash = declarationHash;
+  entry.symbols = std::move(symbols);
+  entry.identifiers = std::move(identifiers);
+  entry.resolvedEpoch = resolutionEpoch;
+
+  entry.loweredNames.reserve(entry.symbols.size());
+  std::vector<uint32_t> trigrams;
+  for (uint32_t symbolIndex = 0; symbolIndex < entry.symbols.size(); ++symbolIndex) {
+    entry.loweredNames.push_back(toLowerCopy(entry.symbols[symbolIndex].name));
+    const auto &lowered = entry.loweredNames.back();
+    trigrams.clear();
+    for (size_t pos = 0; pos + 3 <= lowered.size(); ++pos) {
+      trigrams.push_back(trigramKey(lowered, pos));
+    }
+    std::sort(trigrams.begin(), trigrams.end());
+    trigrams.erase(std::unique(trigrams.begin(), trigrams.end()), trigrams.end());
+    for (auto trigram : trigrams) {
+      symbolsByTrigram[trigram].push_back(SymbolRef{fileId, symbolIndex});
+    }
+  }
+  for (const auto &identifier : entry.identifiers) {
+    filesByIdentifier[identifier.first].insert(fileId);
+  }
+
+  files[fileId] = std::move(entry);
+  dirty = true;
+}
+
+void WorkspaceIndex::unpost(uint32_t fileId, const FileEntry &entry) {
+  for (const auto &lowered : entry.loweredNames) {
+    for (size_t pos = 0; pos + 3 <= lowered.size(); ++pos) {
+      auto posting = symbolsByTrigram.find(trigramKey(lowered, pos));
+      if (posting == symbolsByTrigram.end()) {
+        continue;
+      }
+      auto &refs = posting->second;
+      refs.erase(std::remove_if(refs.begin(), refs.end(), [&](const SymbolRef &ref) { return ref.fileId == fileId; }),
+                 refs.end());
+      if (refs.empty()) {
+        symbolsByTrigram.erase(posting);
+      }
+    }
+  }
+  for (const auto &identifier : entry.identifiers) {
+    auto posting = filesByIdentifier.find(identifier.first);
+    if (posting == filesByIdentifier.end()) {
+      continue;
+    }
+    posting->second.erase(fileId);
+    if (posting->second.empty()) {
+      filesByIdentifier.erase(posting);
+    }
+  }
+}
+
+void WorkspaceIndex::remove(const std::string &uri) {
+  auto id = fileIdsByUri.find(uri);
+  if (id == fileIdsByUri.end()) {
+    return;
+  }
+  auto fileId = id->second;
+  unpost(fileId, files[fileId]);
+  files.erase(fileId);
+  fileIdsByUri.erase(id);
+  ++resolutionEpoch;
+  dirty = true;
+}
+
+std::vector<std::string> WorkspaceIndex::uris() const {
+  std::vector<std::string> out;
+  out.reserve(fileIdsByUri.size());
+  for (const auto &entry : fileIdsByUri) {
+    out.push_back(entry.first);
+  }
+  std::sort(out.begin(), out.end());
+  return out;
+}
+
+std::vector<WorkspaceSymbolMatch> WorkspaceIndex::searchSymbols(const std::string &query) const {
+  auto lowered = toLowerCopy(query);
+  std::vector<std::pair<const FileEntry *, uint32_t>> hits;
+
+  if (lowered.size() < 3) {
+    for (const auto &file : files) {
+      for (uint32_t symbolIndex = 0; symbolIndex < file.second.loweredNames.size(); ++symbolIndex) {
+        if (lowered.empty() || file.second.loweredNames[symbolIndex].find(lowered) != std::string::npos) {
+          hits.emplace_back(&file.second, symbolIndex);
+        }
+      }
+    }
+  } else {
+    const std::vector<SymbolRef> *candidates = nullptr;
+    for (size_t pos = 0; pos + 3 <= lowered.size(); ++pos) {
+      auto posting = symbolsByTrigram.find(trigramKey(lowered, pos));
+      if (posting == symbolsByTrigram.end()) {
+        return {};
+      }
+      if (!candidates || posting->second.size() < candidates->size()) {
+        candidates = &posting->second;
+      }
+    }
+    for (const auto &ref : *candidates) {
+      const auto &file = files.at(ref.fileId);
+      if (file.loweredNames[ref.symbolIndex].find(lowered) != std::string::npos) {
+        hits.emplace_back(&file, ref.symbolIndex);
+      }
+    }
+  }
+
+  std::sort(hits.begin(), hits.end(), [](const auto &left, const auto &right) {
+    if (left.first != right.first) {
+      return left.first->uri < right.first->uri;
+    }
+    return left.second < right.second;
+  });
+
+  std::vector<WorkspaceSymbolMatch> out;
+  out.reserve(hits.size());
+  for (const auto &hit : hits) {
+    out.push_back(WorkspaceSymbolMatch{&hit.first->uri, &hit.first->symbols[hit.second]});
+  }
+  return out;
+}
+
+std::vector<std::string> WorkspaceIndex::filesContaining(const std::string &identifier) const {
+  std::vector<std::string> out;
+  auto posting = filesByIdentifier.find(identifier);
+  if (posting == filesByIdentifier.end()) {
+    return out;
+  }
+  out.reserve(posting->second.size());
+  for (auto fileId : posting->second) {
+    out.push_back(files.at(fileId).uri);
+  }
+  std::sort(out.begin(), out.end());
+  return out;
+}
+
+const std::vector<IndexedOccurrence> *WorkspaceIndex::occurrences(const std::string &uri,
+                                                                  const std::string &identifier) const {
+  auto id = fileIdsByUri.find(uri);
+  if (id == fileIdsByUri.end()) {
+    return nullptr;
+  }
+  const auto &identifiers = files.at(id->second).identifiers;
+  auto it = identifiers.find(identifier);
+  return it == identifiers.end() ? nullptr : &it->second;
+}
+
+const std::vector<ResolvedOccurrence> &WorkspaceIndex::resolvedOccurrences(const std::string &uri,
+                                                                          const std::string &identifier,
+                                                                          IndexResolution mode,
+                                                                          const Resolver &resolve) {
+  static const std::vector<ResolvedOccurrence> empty;
+  auto id = fileIdsByUri.find(uri);
+  if (id == fileIdsByUri.end()) {
+    return empty;
+  }
+  auto &file = files[id->second];
+  auto occurrencesIt = file.identifiers.find(identifier);
+  if (occurrencesIt == file.identifiers.end()) {
+    return empty;
+  }
+
+  if (file.resolvedEpoch != resolutionEpoch) {
+    for (auto &cache : file.resolved) {
+      cache.clear();
+    }
+    file.resolvedEpoch = resolutionEpoch;
+  }
+
+  auto &cache = file.resolved[static_cast<size_t>(mode)];
+  auto cached = cache.find(identifier);
+  if (cached != cache.end()) {
+    return cached->second;
+  }
+
+  std::vector<ResolvedOccurrence> resolved;
+  resolved.reserve(occurrencesIt->second.size());
+  for (const auto &occurrence : occurrencesIt->second) {
+    ResolvedOccurrence entry;
+    entry.occurrence = occurrence;
+    entry.resolved = resolve(occurrence, entry.identity);
+    ++statistics.resolverCalls;
+    resolved.push_back(std::move(entry));
+  }
+  return cache[identifier] = std::move(resolved);
+}
+
+void WorkspaceIndex::invalidateResolutions() {
+  ++resolutionEpoch;
+}
+
+void WorkspaceIndex::save() {
+  if (!dirty || indexPath.empty()) {
+    return;
+  }
+
+  std::error_code ec;
+  std::filesystem::create_directories(indexPath.parent_path(), ec);
+  auto tempPath = indexPath;
+  tempPath += ".tmp";
+  {
+    std::ofstream out(tempPath, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+      return;
+    }
+    out.write(kIndexMagic, sizeof(kIndexMagic));
+    writeU32(out, static_cast<uint32_t>(files.size()));
+    for (const auto &file : files) {
+      const auto &entry = file.second;
+      writeString(out, entry.uri);
+      writeU64(out, entry.textHash);
+      writeU32(out, static_cast<uint32_t>(entry.symbols.size()));
+      for (const auto &symbol : entry.symbols) {
+        writeString(out, symbol.name);
+        writeU32(out, static_cast<uint32_t>(symbol.kind));
+        writeString(out, symbol.detail);
+        writeString(out, symbol.signature);
+        writeString(out, symbol.documentation);
+        writeString(out, symbol.containerName);
+        writeU32(out, (symbol.isMember ? 1u : 0u) | (symbol.isDeprecated ? 2u : 0u));
+        writeString(out, symbol.deprecationMessage);
+        writeU32(out, symbol.line);
+        writeU32(out, symbol.start);
+        writeU32(out, symbol.length);
+      }
+      writeU32(out, static_cast<uint32_t>(entry.identifiers.size()));
+      for (const auto &identifier : entry.identifiers) {
+        writeString(out, identifier.first);
+        writeU32(out, static_cast<uint32_t>(identifier.second.size()));
+        for (const auto &occurrence : identifier.second) {
+          writeU32(out, occurrence.offset);
+          writeU32(out, occurrence.line);
+          writeU32(out, occurrence.character);
+        }
+      }
+    }
+    if (!out) {
+      return;
+    }
+  }
+  std::filesystem::rename(tempPath, indexPath, ec);
+  if (!ec) {
+    dirty = false;
+  }
+}
+
+WorkspaceIndexStats WorkspaceIndex::stats() const {
+  auto out = statistics;
+  out.resolutionEpoch = resolutionEpoch;
+  return out;
+}
+
+}
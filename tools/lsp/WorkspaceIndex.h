@@ -0,0 +1,136 @@
+#ifndef STARBYTES_LSP_WORKSPACEINDEX_H
+#define STARBYTES_LSP_WORKSPACEINDEX_H
+
+#include "SymbolTypes.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace starbytes::lsp {
+
+/// One maximal identifier run in a document.
+struct IndexedOccurrence {
+  uint32_t offset = 0;
+  uint32_t line = 0;
+  uint32_t character = 0;
+};
+
+/// Where an occurrence resolves to; compared the same way the handlers compare resolved symbols.
+struct SymbolIdentity {
+  std::string uri;
+  unsigned line = 0;
+  unsigned start = 0;
+  unsigned length = 0;
+  int kind = 0;
+};
+
+struct ResolvedOccurrence {
+  IndexedOccurrence occurrence;
+  bool resolved = false;
+  SymbolIdentity identity;
+};
+
+/// References and rename resolve occurrences differently, so their results are cached separately.
+enum class IndexResolution : uint8_t {
+  References = 0,
+  Rename = 1
+};
+
+struct WorkspaceSymbolMatch {
+  const std::string *uri = nullptr;
+  const SymbolEntry *symbol = nullptr;
+};
+
+struct WorkspaceIndexStats {
+  uint64_t filesIndexed = 0;
+  uint64_t filesAdopted = 0;
+  uint64_t resolutionEpoch = 0;
+  uint64_t resolverCalls = 0;
+};
+
+/// Workspace-wide symbol and identifier index for the language server.
+/// Declarations are searchable through a trigram index, every identifier run is posted per file, and
+/// resolved occurrences are cached until any file's declarations change. Files are reindexed only when
+/// their text hash changes; the declaration and identifier postings persist across sessions.
+class WorkspaceIndex final {
+public:
+  using Resolver = std::function<bool(const IndexedOccurrence &, SymbolIdentity &)>;
+
+private:
+  struct SymbolRef {
+    uint32_t fileId = 0;
+    uint32_t symbolIndex = 0;
+  };
+
+  struct FileEntry {
+    std::string uri;
+    uint64_t textHash = 0;
+    uint64_t declarationHash = 0;
+    std::vector<SymbolEntry> symbols;
+    std::vector<std::string> loweredNames;
+    std::unordered_map<std::string, std::vector<IndexedOccurrence>> identifiers;
+    uint64_t resolvedEpoch = 0;
+    std::unordered_map<std::string, std::vector<ResolvedOccurrence>> resolved[2];
+  };
+
+  struct PersistedEntry {
+    uint64_t textHash = 0;
+    std::vector<SymbolEntry> symbols;
+    std::unordered_map<std::string, std::vector<IndexedOccurrence>> identifiers;
+  };
+
+  std::filesystem::path indexPath;
+  bool loaded = false;
+  bool dirty = false;
+  uint32_t nextFileId = 1;
+  uint64_t resolutionEpoch = 1;
+  std::unordered_map<std::string, uint32_t> fileIdsByUri;
+  std::unordered_map<uint32_t, FileEntry> files;
+  std::unordered_map<std::string, std::unordered_set<uint32_t>> filesByIdentifier;
+  std::unordered_map<uint32_t, std::vector<SymbolRef>> symbolsByTrigram;
+  std::unordered_map<std::string, PersistedEntry> persisted;
+  WorkspaceIndexStats statistics;
+
+  void loadIfNeeded();
+  void install(const std::string &uri,
+               uint64_t textHash,
+               std::vector<SymbolEntry> symbols,
+               std::unordered_map<std::string, std::vector<IndexedOccurrence>> identifiers);
+  void unpost(uint32_t fileId, const FileEntry &entry);
+
+public:
+  static std::unordered_map<std::string, std::vector<IndexedOccurrence>> scanIdentifiers(const std::string &text);
+
+  void setIndexPath(const std::filesystem::path &path);
+  bool isCurrent(const std::string &uri, uint64_t textHash) const;
+  /// Installs the persisted entry for `uri` when it was saved for the same text hash.
+  bool adoptPersisted(const std::string &uri, uint64_t textHash);
+  void update(const std::string &uri, uint64_t textHash, const std::string &text, std::vector<SymbolEntry> symbols);
+  void remove(const std::string &uri);
+  std::vector<std::string> uris() const;
+
+  /// Case-insensitive substring match over declaration names, ordered by uri then declaration order.
+  std::vector<WorkspaceSymbolMatch> searchSymbols(const std::string &query) const;
+  /// Files containing `identifier` as a whole identifier, sorted by uri.
+  std::vector<std::string> filesContaining(const std::string &identifier) const;
+  const std::vector<IndexedOccurrence> *occurrences(const std::string &uri, const std::string &identifier) const;
+  /// Occurrences of `identifier` in `uri` with their resolved identities; `resolve` only runs on a cache miss.
+  const std::vector<ResolvedOccurrence> &resolvedOccurrences(const std::string &uri,
+                                                              const std::string &identifier,
+                                                              IndexResolution mode,
+                                                              const Resolver &resolve);
+  /// Drops every cached resolution, e.g. when the builtins interface changes.
+  void invalidateResolutions();
+  void save();
+
+  WorkspaceIndexStats stats() const;
+};
+
+}
+
+#endif